@@ -54,6 +54,8 @@ bool CCmdLineParser::parse(int argc,
                            bool& multivariateByFields,
                            std::string& multipleBucketspans,
                            bool& perPartitionNormalization,
+                           std::size_t& backgroundThreads,
+                           std::string& modelSpillDir,
                            TStrVec& clauseTokens) {
     try {
         boost::program_options::options_description desc(DESCRIPTION);
@@ -121,6 +123,10 @@ bool CCmdLineParser::parse(int argc,
                         "Optional comma-separated list of additional bucketspans - must be direct multiples of the main bucketspan")
             ("perPartitionNormalization",
                         "Optional flag to enable per partition normalization")
+            ("backgroundThreads", boost::program_options::value<std::size_t>(),
+                        "Optional number of background threads to use to test for seasonality and to help generate model plots - default is 0, which does all this work on the main thread")
+            ("modelSpillDir", boost::program_options::value<std::string>(),
+                        "Optional local directory to which the state of hibernating models can be paged out")
         ;
         // clang-format on
 
@@ -240,6 +246,12 @@ bool CCmdLineParser::parse(int argc,
         if (vm.count("perPartitionNormalization") > 0) {
             perPartitionNormalization = true;
         }
+        if (vm.count("backgroundThreads") > 0) {
+            backgroundThreads = vm["backgroundThreads"].as<std::size_t>();
+        }
+        if (vm.count("modelSpillDir") > 0) {
+            modelSpillDir = vm["modelSpillDir"].as<std::string>();
+        }
 
         boost::program_options::collect_unrecognized(
             parsed.options, boost::program_options::include_positional)
@@ -66,6 +66,8 @@ public:
                       bool& multivariateByFields,
                       std::string& multipleBucketspans,
                       bool& perPartitionNormalization,
+                      std::size_t& backgroundThreads,
+                      std::string& modelSpillDir,
                       TStrVec& clauseTokens);
 
 private:
@@ -18,6 +18,7 @@
 #include <core/CJsonOutputStreamWrapper.h>
 #include <core/CLogger.h>
 #include <core/CProcessPriority.h>
+#include <core/CStaticThreadPool.h>
 #include <core/CStatistics.h>
 #include <core/CoreTypes.h>
 
@@ -25,6 +26,7 @@
 
 #include <model/CAnomalyDetectorModelConfig.h>
 #include <model/CLimits.h>
+#include <model/CModelSpillStore.h>
 #include <model/ModelTypes.h>
 
 #include <api/CAnomalyJob.h>
@@ -90,6 +92,8 @@ int main(int argc, char** argv) {
     bool multivariateByFields(false);
     std::string multipleBucketspans;
     bool perPartitionNormalization(false);
+    std::size_t backgroundThreads(0);
+    std::string modelSpillDir;
     TStrVec clauseTokens;
     if (ml::autodetect::CCmdLineParser::parse(
             argc, argv, limitConfigFile, modelConfigFile, fieldConfigFile,
@@ -100,7 +104,7 @@ int main(int argc, char** argv) {
             isOutputFileNamedPipe, restoreFileName, isRestoreFileNamedPipe,
             persistFileName, isPersistFileNamedPipe, maxAnomalyRecords, memoryUsage,
             bucketResultsDelay, multivariateByFields, multipleBucketspans,
-            perPartitionNormalization, clauseTokens) == false) {
+            perPartitionNormalization, backgroundThreads, modelSpillDir, clauseTokens) == false) {
         return EXIT_FAILURE;
     }
 
@@ -129,6 +133,8 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
 
+    ml::core::CStaticThreadPool::startDefault(backgroundThreads);
+
     if (jobId.empty()) {
         LOG_FATAL(<< "No job ID specified");
         return EXIT_FAILURE;
@@ -166,6 +172,20 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
 
+    if (!modelSpillDir.empty()) {
+        // Resident model state is bounded by a fraction of the memory limit.
+        std::size_t residentMemoryLimit{static_cast<std::size_t>(
+            ml::model::CModelSpillStore::DEFAULT_RESIDENT_MEMORY_FRACTION *
+            static_cast<double>(limits.memoryLimitMB() * 1024 * 1024))};
+        auto modelSpillStore = std::make_shared<ml::model::CModelSpillStore>(
+            modelSpillDir, residentMemoryLimit);
+        if (modelSpillStore->isOpen() == false) {
+            LOG_FATAL(<< "Could not spill model state to '" << modelSpillDir << "'");
+            return EXIT_FAILURE;
+        }
+        modelConfig.modelSpillStore(modelSpillStore);
+    }
+
     using TDataSearcherUPtr = std::unique_ptr<ml::core::CDataSearcher>;
     const TDataSearcherUPtr restoreSearcher{[isRestoreFileNamedPipe, &ioMgr]() -> TDataSearcherUPtr {
         if (ioMgr.restoreStream()) {
@@ -264,6 +284,9 @@ int main(int argc, char** argv) {
                                    *inputParser, *firstProcessor);
     bool ioLoopSucceeded(skeleton.ioLoop());
 
+    // Finish any outstanding background work before the models go away.
+    ml::core::CStaticThreadPool::stopDefault();
+
     // Unfortunately we cannot rely on destruction to finalise the output writer
     // as it must be finalised before the skeleton is destroyed, and C++
     // destruction order means the skeleton will be destroyed before the output
@@ -110,6 +110,7 @@ public:
         std::function<void(const CModelSnapshotJsonWriter::SModelSnapshotReport&)>;
     using TAnomalyDetectorPtr = std::shared_ptr<model::CAnomalyDetector>;
     using TAnomalyDetectorPtrVec = std::vector<TAnomalyDetectorPtr>;
+    using TAnomalyDetectorCPtrVec = std::vector<const model::CAnomalyDetector*>;
     using TKeyVec = std::vector<model::CSearchKey>;
     using TKeyAnomalyDetectorPtrUMap =
         boost::unordered_map<model::CSearchKey::TStrKeyPr, TAnomalyDetectorPtr, model::CStrKeyPrHash, model::CStrKeyPrEqual>;
@@ -328,11 +329,14 @@ private:
     //! The range includes the start but does not include the end.
     void outputResultsWithinRange(bool isInterim, core_t::TTime start, core_t::TTime end);
 
-    //! Generate the model plot for the models of the specified detector in the
-    //! specified time range.
+    //! Generate the model plot for the models of the specified detectors in
+    //! the specified time range.
+    //!
+    //! The detectors' models are independent so their plots are generated
+    //! in parallel and then added in the order of \p detectors.
     void generateModelPlot(core_t::TTime startTime,
                            core_t::TTime endTime,
-                           const model::CAnomalyDetector& detector);
+                           const TAnomalyDetectorCPtrVec& detectors);
 
     //! Write the pre-generated model plot to the output stream of the user's
     //! choosing: either file or streamed to the API
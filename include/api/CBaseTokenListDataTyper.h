@@ -6,16 +6,15 @@
 #ifndef INCLUDED_ml_api_CBaseTokenListDataTyper_h
 #define INCLUDED_ml_api_CBaseTokenListDataTyper_h
 
-#include <core/BoostMultiIndex.h>
-
 #include <api/CCsvInputParser.h>
 #include <api/CDataTyper.h>
 #include <api/CTokenListType.h>
 #include <api/ImportExport.h>
 
+#include <boost/container/flat_map.hpp>
+
 #include <iosfwd>
 #include <list>
-#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -45,6 +44,12 @@ class CTokenListReverseSearchCreatorIntf;
 //! a match.  (This means that a threshold of 1 implies all messages are
 //! different, even if they're identical!)
 //!
+//! Tokens are mapped to IDs by an open addressing hash table with linear
+//! probing whose slots store the token's hash and ID, so looking up a
+//! token which has been seen before doesn't allocate and usually only
+//! needs one string comparison. The distinct token IDs of each string
+//! are stored in a flat map which is reused for successive strings.
+//!
 //! This class is not thread safe.  For efficiency, each instance should
 //! only be used within a single thread.  Any multi-threaded access must
 //! be serialised with an external lock.
@@ -76,7 +81,7 @@ public:
     using TSizeSizePrVec = std::vector<TSizeSizePr>;
 
     //! Used for storing distinct token IDs
-    using TSizeSizeMap = std::map<size_t, size_t>;
+    using TSizeSizeFMap = boost::container::flat_map<size_t, size_t>;
 
     //! Used for stream output of token IDs translated back to the original
     //! tokens
@@ -140,14 +145,14 @@ protected:
     virtual void tokeniseString(const TStrStrUMap& fields,
                                 const std::string& str,
                                 TSizeSizePrVec& tokenIds,
-                                TSizeSizeMap& tokenUniqueIds,
+                                TSizeSizeFMap& tokenUniqueIds,
                                 size_t& totalWeight) = 0;
 
     //! Take a string token, convert it to a numeric ID and a weighting and
     //! add these to the provided data structures.
     virtual void tokenToIdAndWeight(const std::string& token,
                                     TSizeSizePrVec& tokenIds,
-                                    TSizeSizeMap& tokenUniqueIds,
+                                    TSizeSizeFMap& tokenUniqueIds,
                                     size_t& totalWeight) = 0;
 
     //! Compute similarity between two vectors
@@ -167,7 +172,7 @@ protected:
                       const std::string& str,
                       size_t rawStringLen,
                       const TSizeSizePrVec& tokenIds,
-                      const TSizeSizeMap& tokenUniqueIds,
+                      const TSizeSizeFMap& tokenUniqueIds,
                       double similarity,
                       TSizeSizePrListItr& iter);
 
@@ -186,7 +191,7 @@ protected:
     size_t idForToken(const std::string& token);
 
 private:
-    //! Value type for the TTokenMIndex below
+    //! Value type for the token lookup below
     class CTokenInfoItem {
     public:
         CTokenInfoItem(const std::string& str, size_t index);
@@ -231,17 +236,23 @@ private:
     //! not expensive because CTokenListType is movable)
     using TTokenListTypeVec = std::vector<CTokenListType>;
 
-    //! Tag for the token index
-    struct SToken {};
+    //! Used to look up tokens' IDs
+    using TTokenInfoItemVec = std::vector<CTokenInfoItem>;
+
+    //! A slot of the index from tokens to their IDs
+    struct STokenIndexSlot {
+        //! The hash of the token
+        size_t s_Hash;
+
+        //! The token's ID or EMPTY_SLOT if the slot is empty
+        size_t s_Id;
+    };
 
-    using TTokenMIndex = boost::multi_index::multi_index_container<
-        CTokenInfoItem,
-        boost::multi_index::indexed_by<boost::multi_index::random_access<>,
-                                       boost::multi_index::hashed_unique<boost::multi_index::tag<SToken>, BOOST_MULTI_INDEX_CONST_TYPE_CONST_MEM_FUN(CTokenInfoItem, std::string, str)>>>;
+    using TTokenIndexSlotVec = std::vector<STokenIndexSlot>;
 
 private:
     //! Used by deferred persistence functions
-    static void acceptPersistInserter(const TTokenMIndex& tokenIdLookup,
+    static void acceptPersistInserter(const TTokenInfoItemVec& tokenIdLookup,
                                       const TTokenListTypeVec& types,
                                       core::CStatePersistInserter& inserter);
 
@@ -252,9 +263,20 @@ private:
     //! \p totalWeight.  Any previous content of these variables is wiped.
     bool addPretokenisedTokens(const std::string& tokensCsv,
                                TSizeSizePrVec& tokenIds,
-                               TSizeSizeMap& tokenUniqueIds,
+                               TSizeSizeFMap& tokenUniqueIds,
                                size_t& totalWeight);
 
+    //! Get the index slot containing \p token, whose hash is \p hash, or
+    //! the empty slot where it should be inserted if it isn't present.
+    size_t tokenIndexSlot(const std::string& token, size_t hash) const;
+
+    //! Resize the token index for the current number of tokens and
+    //! reinsert them.
+    void rebuildTokenIndex();
+
+    //! Hash \p token for the token index.
+    static size_t tokenHash(const std::string& token);
+
 private:
     //! Reference to the object we'll use to create reverse searches
     const TTokenListReverseSearchCreatorIntfCPtr m_ReverseSearchCreator;
@@ -277,8 +299,11 @@ private:
     //! match count
     TSizeSizePrList m_TypesByCount;
 
-    //! Used for looking up tokens to a unique ID
-    TTokenMIndex m_TokenIdLookup;
+    //! The tokens indexed by their unique ID
+    TTokenInfoItemVec m_TokenIdLookup;
+
+    //! Open addressing hash table from tokens to their unique ID
+    TTokenIndexSlotVec m_TokenIndex;
 
     //! Vector to use to build up sequences of token IDs.  This is a member
     //! to save repeated reallocations for different strings.
@@ -286,7 +311,7 @@ private:
 
     //! Set to use to build up unique token IDs.  This is a member to save
     //! repeated reallocations for different strings.
-    TSizeSizeMap m_WorkTokenUniqueIds;
+    TSizeSizeFMap m_WorkTokenUniqueIds;
 
     //! Used to parse pre-tokenised input supplied as CSV.
     CCsvInputParser::CCsvLineParser m_CsvLineParser;
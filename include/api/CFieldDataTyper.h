@@ -193,6 +193,10 @@ private:
     //! The categorization filter
     core::CRegexFilter m_CategorizationFilter;
 
+    //! Buffer for the filtered categorization field value, which is
+    //! reused to avoid allocating for every record.
+    std::string m_FilteredFieldValue;
+
     //! Pointer to periodic persister that works in the background.  May be
     //! nullptr if this object is not responsible for starting periodic
     //! persistence.
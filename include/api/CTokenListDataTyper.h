@@ -65,13 +65,13 @@ protected:
     virtual void tokeniseString(const TStrStrUMap& fields,
                                 const std::string& str,
                                 TSizeSizePrVec& tokenIds,
-                                TSizeSizeMap& tokenUniqueIds,
+                                TSizeSizeFMap& tokenUniqueIds,
                                 size_t& totalWeight) {
         tokenIds.clear();
         tokenUniqueIds.clear();
         totalWeight = 0;
 
-        std::string temp;
+        m_WorkToken.clear();
 
         // TODO - make more efficient
         std::string::size_type nonHexPos(std::string::npos);
@@ -81,22 +81,22 @@ protected:
             // Basically tokenise into [a-zA-Z0-9]+ strings, possibly
             // allowing underscores, dots and dashes in the middle
             if (::isalnum(static_cast<unsigned char>(curChar)) ||
-                (!temp.empty() && ((ALLOW_UNDERSCORE && curChar == '_') ||
-                                   (ALLOW_DOT && curChar == '.') ||
-                                   (ALLOW_DASH && curChar == '-')))) {
-                temp += curChar;
+                (!m_WorkToken.empty() && ((ALLOW_UNDERSCORE && curChar == '_') ||
+                                          (ALLOW_DOT && curChar == '.') ||
+                                          (ALLOW_DASH && curChar == '-')))) {
+                m_WorkToken += curChar;
                 if (IGNORE_HEX) {
                     // Count dots and dashes as numeric
                     if (!::isxdigit(static_cast<unsigned char>(curChar)) &&
                         curChar != '.' && curChar != '-') {
-                        nonHexPos = temp.length() - 1;
+                        nonHexPos = m_WorkToken.length() - 1;
                     }
                 }
             } else {
-                if (!temp.empty()) {
-                    this->considerToken(fields, nonHexPos, temp, tokenIds,
+                if (!m_WorkToken.empty()) {
+                    this->considerToken(fields, nonHexPos, m_WorkToken, tokenIds,
                                         tokenUniqueIds, totalWeight);
-                    temp.clear();
+                    m_WorkToken.clear();
                 }
 
                 if (IGNORE_HEX) {
@@ -105,8 +105,9 @@ protected:
             }
         }
 
-        if (!temp.empty()) {
-            this->considerToken(fields, nonHexPos, temp, tokenIds, tokenUniqueIds, totalWeight);
+        if (!m_WorkToken.empty()) {
+            this->considerToken(fields, nonHexPos, m_WorkToken, tokenIds,
+                                tokenUniqueIds, totalWeight);
         }
 
         LOG_TRACE(<< str << " tokenised to " << tokenIds.size() << " tokens with total weight "
@@ -117,7 +118,7 @@ protected:
     //! add these to the provided data structures.
     virtual void tokenToIdAndWeight(const std::string& token,
                                     TSizeSizePrVec& tokenIds,
-                                    TSizeSizeMap& tokenUniqueIds,
+                                    TSizeSizeFMap& tokenUniqueIds,
                                     size_t& totalWeight) {
         TSizeSizePr idWithWeight(this->idForToken(token), 1);
 
@@ -185,7 +186,7 @@ private:
                        std::string::size_type nonHexPos,
                        std::string& token,
                        TSizeSizePrVec& tokenIds,
-                       TSizeSizeMap& tokenUniqueIds,
+                       TSizeSizeFMap& tokenUniqueIds,
                        size_t& totalWeight) {
         if (IGNORE_LEADING_DIGIT && ::isdigit(static_cast<unsigned char>(token[0]))) {
             return;
@@ -237,6 +238,10 @@ private:
 
     //! Function used to increase weighting for dictionary words
     DICTIONARY_WEIGHT_FUNC m_DictionaryWeightFunc;
+
+    //! Used to build up each token.  This is a member to save repeated
+    //! reallocations for different strings.
+    std::string m_WorkToken;
 };
 }
 }
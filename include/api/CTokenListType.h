@@ -8,7 +8,8 @@
 
 #include <api/ImportExport.h>
 
-#include <map>
+#include <boost/container/flat_map.hpp>
+
 #include <string>
 #include <utility>
 #include <vector>
@@ -47,9 +48,9 @@ public:
     using TSizeSizePrVecCItr = TSizeSizePrVec::const_iterator;
 
     //! Used for storing distinct token IDs mapped to weightings
-    using TSizeSizeMap = std::map<size_t, size_t>;
-    using TSizeSizeMapItr = TSizeSizeMap::iterator;
-    using TSizeSizeMapCItr = TSizeSizeMap::const_iterator;
+    using TSizeSizeFMap = boost::container::flat_map<size_t, size_t>;
+    using TSizeSizeFMapItr = TSizeSizeFMap::iterator;
+    using TSizeSizeFMapCItr = TSizeSizeFMap::const_iterator;
 
 public:
     //! Create a new type
@@ -58,7 +59,7 @@ public:
                    size_t rawStringLen,
                    const TSizeSizePrVec& baseTokenIds,
                    size_t baseWeight,
-                   const TSizeSizeMap& uniqueTokenIds);
+                   const TSizeSizeFMap& uniqueTokenIds);
 
     //! Constructor used when restoring from XML
     CTokenListType(core::CStateRestoreTraverser& traverser);
@@ -69,7 +70,7 @@ public:
                    const std::string& str,
                    size_t rawStringLen,
                    const TSizeSizePrVec& tokenIds,
-                   const TSizeSizeMap& uniqueTokenIds,
+                   const TSizeSizeFMap& uniqueTokenIds,
                    double similarity);
 
     //! Accessors
@@ -88,14 +89,14 @@ public:
 
     //! What is the weight of tokens in a given map that are missing from
     //! this type's common unique tokens?
-    size_t missingCommonTokenWeight(const TSizeSizeMap& uniqueTokenIds) const;
+    size_t missingCommonTokenWeight(const TSizeSizeFMap& uniqueTokenIds) const;
 
     //! Is the weight of tokens in a given map that are missing from this
     //! type's common unique tokens equal to zero?  It is possible to test:
     //!     if (type.missingCommonTokenWeight(uniqueTokenIds) == 0)
     //! instead of calling this method.  However, this method is much faster
     //! as it can return false as soon as a mismatch occurs.
-    bool isMissingCommonTokenWeightZero(const TSizeSizeMap& uniqueTokenIds) const;
+    bool isMissingCommonTokenWeightZero(const TSizeSizeFMap& uniqueTokenIds) const;
 
     //! Does the supplied token vector contain all our common tokens in the
     //! same order as our base token vector?
@@ -0,0 +1,154 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_ml_core_CAhoCorasickAutomaton_h
+#define INCLUDED_ml_core_CAhoCorasickAutomaton_h
+
+#include <core/ImportExport.h>
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+namespace ml {
+namespace core {
+
+//! \brief A flat Aho-Corasick automaton for testing membership of a
+//! string in a set of optionally anchored patterns.
+//!
+//! DESCRIPTION:\n
+//! Each pattern can be anchored at the start of the key, at its end,
+//! at both or at neither. This covers, respectively, prefix, suffix,
+//! full and contains matching. A key matches if any pattern matches it.
+//! The automaton is built once from the full set of patterns; updating
+//! it requires rebuilding it.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! Anchors are handled by extending the alphabet with two symbols which
+//! mark the start and end of the key. A start anchored pattern is stored
+//! prefixed by the start symbol, an end anchored pattern is suffixed by
+//! the end symbol, and the key is scanned as if it were surrounded by the
+//! two. Since each symbol only appears once in the scanned text anchored
+//! patterns can only match at the relevant position. This means that a
+//! single pass over the key, which takes time linear in its length
+//! regardless of the number of patterns, tests all pattern types.
+//!
+//! For spatial locality, the trie is packed in two vectors in breadth
+//! first order: one of nodes and one of their outgoing edges. Each node
+//! stores its failure link and whether it, or any node reachable by
+//! following its failure links, terminates a pattern.
+//! Symbols are mapped to classes, one for each symbol which appears in
+//! a pattern and one for all the rest, and the shallowest states, which
+//! are visited most often, store the transition for every class in a
+//! dense table. The size of this table is bounded so that it doesn't
+//! dominate the automaton's memory when there are many patterns.
+class CORE_EXPORT CAhoCorasickAutomaton {
+public:
+    using TStrVec = std::vector<std::string>;
+
+    //! The positions in the key at which a pattern is required to match.
+    enum EAnchor {
+        E_Unanchored = 0x0,
+        E_AnchoredStart = 0x1,
+        E_AnchoredEnd = 0x2,
+        E_AnchoredStartAndEnd = E_AnchoredStart | E_AnchoredEnd
+    };
+
+public:
+    //! Default constructor.
+    CAhoCorasickAutomaton();
+
+    //! Builds the automaton from lists of patterns, one for each of
+    //! the anchor types. Duplicate patterns are allowed.
+    //!
+    //! \param[in] fullPatterns Patterns which must match the whole key.
+    //! \param[in] prefixPatterns Patterns which must match the key start.
+    //! \param[in] suffixPatterns Patterns which must match the key end.
+    //! \param[in] containsPatterns Patterns which can match anywhere.
+    //! Returns true if the automaton was built successfully.
+    bool build(const TStrVec& fullPatterns,
+               const TStrVec& prefixPatterns,
+               const TStrVec& suffixPatterns,
+               const TStrVec& containsPatterns);
+
+    //! Returns true if any pattern matches \p key.
+    bool matches(const std::string& key) const;
+
+    //! Clears the automaton.
+    void clear();
+
+    //! Get the number of states in the automaton.
+    std::size_t numberStates() const;
+
+    //! Get the memory used by this object.
+    std::size_t memoryUsage() const;
+
+private:
+    using TUInt16Vec = std::vector<uint16_t>;
+    using TUInt32Vec = std::vector<uint32_t>;
+
+    //! A state of the packed automaton.
+    struct SNode {
+        //! See CMemory.
+        static bool dynamicSizeAlwaysZero() { return true; }
+
+        //! The index of the first outgoing edge in m_Edges.
+        uint32_t s_FirstEdge;
+        //! The number of outgoing edges.
+        uint32_t s_NumberEdges;
+        //! The index of the state for the longest proper suffix of
+        //! this state's string which is also a state.
+        uint32_t s_Fail;
+        //! The index of the state's row in the dense transition table
+        //! if it has one.
+        uint32_t s_DenseRow;
+        //! True if any pattern ends at this state.
+        bool s_Match;
+    };
+
+    //! A transition of the packed automaton.
+    struct SEdge {
+        //! See CMemory.
+        static bool dynamicSizeAlwaysZero() { return true; }
+
+        bool operator<(uint16_t rhs) const { return s_Class < rhs; }
+
+        uint16_t s_Class;
+        uint32_t s_Target;
+    };
+
+    using TNodeVec = std::vector<SNode>;
+    using TEdgeVec = std::vector<SEdge>;
+
+private:
+    //! Get the state reached from \p state by consuming a symbol in
+    //! \p symbolClass following failure links as necessary.
+    uint32_t transition(uint32_t state, uint16_t symbolClass) const;
+
+    //! Get the child of \p state labelled \p symbolClass if there is one.
+    uint32_t child(uint32_t state, uint16_t symbolClass) const;
+
+private:
+    //! The class of each symbol.
+    TUInt16Vec m_Classes;
+
+    //! The number of distinct symbol classes.
+    std::size_t m_NumberClasses;
+
+    //! The states in breadth first order; the root is the first state.
+    TNodeVec m_Nodes;
+
+    //! The outgoing edges of each state sorted by symbol class.
+    TEdgeVec m_Edges;
+
+    //! The rows of the dense transition table.
+    TUInt32Vec m_Dense;
+};
+}
+}
+
+#endif // INCLUDED_ml_core_CAhoCorasickAutomaton_h
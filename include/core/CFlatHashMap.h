@@ -0,0 +1,479 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_ml_core_CFlatHashMap_h
+#define INCLUDED_ml_core_CFlatHashMap_h
+
+#include <core/CMemory.h>
+#include <core/CMemoryUsage.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <stdint.h>
+
+namespace ml {
+namespace core {
+
+//! \brief An open addressing hash map which stores its entries in a
+//! single contiguous array.
+//!
+//! DESCRIPTION:\n
+//! A drop in replacement for the subset of the boost::unordered_map
+//! interface used for short lived, frequently updated maps, such as the
+//! per bucket counts in the data gatherers.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! Entries are stored in a power of two sized array and collisions are
+//! resolved by linear probing. In the style of swiss tables, there is a
+//! parallel array of control bytes which holds seven bits of each entry's
+//! hash, or marks the slot as empty or erased, so probing scans a compact
+//! byte array and the key is only compared when the hash bits match. This
+//! avoids the node allocation and pointer chasing of chained maps.
+//!
+//! clear() resets the entries but retains the arrays, so a map which is
+//! refilled with a similar number of entries, for example each bucket,
+//! doesn't allocate. As a result the memory usage is that of the largest
+//! number of entries the map has held since it was constructed, reserved
+//! or swapped.
+//!
+//! Erase leaves a tombstone, so iterators to other entries remain valid
+//! and erasing while iterating visits every entry exactly once. Inserting
+//! can invalidate all iterators.
+//!
+//! The value type is std::pair<KEY, VALUE> rather than std::pair<const
+//! KEY, VALUE>, so entries can be reset in place. Callers must not modify
+//! the key of an entry through an iterator.
+template<typename KEY, typename VALUE, typename HASH = boost::hash<KEY>, typename EQUAL = std::equal_to<KEY>>
+class CFlatHashMap {
+public:
+    using key_type = KEY;
+    using mapped_type = VALUE;
+    using value_type = std::pair<KEY, VALUE>;
+    using size_type = std::size_t;
+    using hasher = HASH;
+    using key_equal = EQUAL;
+
+private:
+    using TUInt8Vec = std::vector<uint8_t>;
+    using TValueVec = std::vector<value_type>;
+
+    //! \name Control Bytes
+    //! Full slots hold the low seven bits of the entry's hash.
+    //@{
+    static const uint8_t EMPTY = 0x80;
+    static const uint8_t ERASED = 0xfe;
+    //@}
+
+    //! The minimum non-zero number of slots.
+    static const std::size_t MINIMUM_CAPACITY = 8;
+
+    //! \brief Iterates over the full slots.
+    template<typename VALUE_TYPE>
+    class CIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename std::remove_const<VALUE_TYPE>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = VALUE_TYPE*;
+        using reference = VALUE_TYPE&;
+
+    public:
+        CIterator() : m_Control(nullptr), m_End(nullptr), m_Slot(nullptr) {}
+        CIterator(const uint8_t* control, const uint8_t* end, VALUE_TYPE* slot)
+            : m_Control(control), m_End(end), m_Slot(slot) {
+            this->skipUnused();
+        }
+
+        //! Conversion from an iterator to a const_iterator.
+        template<typename OTHER>
+        CIterator(const CIterator<OTHER>& other)
+            : m_Control(other.m_Control), m_End(other.m_End), m_Slot(other.m_Slot) {}
+
+        reference operator*() const { return *m_Slot; }
+        pointer operator->() const { return m_Slot; }
+
+        CIterator& operator++() {
+            ++m_Control;
+            ++m_Slot;
+            this->skipUnused();
+            return *this;
+        }
+        CIterator operator++(int) {
+            CIterator result{*this};
+            ++(*this);
+            return result;
+        }
+
+        template<typename OTHER>
+        bool operator==(const CIterator<OTHER>& rhs) const {
+            return m_Control == rhs.m_Control;
+        }
+        template<typename OTHER>
+        bool operator!=(const CIterator<OTHER>& rhs) const {
+            return m_Control != rhs.m_Control;
+        }
+
+    private:
+        void skipUnused() {
+            while (m_Control != m_End && isFull(*m_Control) == false) {
+                ++m_Control;
+                ++m_Slot;
+            }
+        }
+
+    private:
+        const uint8_t* m_Control;
+        const uint8_t* m_End;
+        VALUE_TYPE* m_Slot;
+
+        template<typename>
+        friend class CIterator;
+        friend class CFlatHashMap;
+    };
+
+public:
+    using iterator = CIterator<value_type>;
+    using const_iterator = CIterator<const value_type>;
+    using TIteratorBoolPr = std::pair<iterator, bool>;
+
+public:
+    //! Create a map with space for at least \p n entries.
+    explicit CFlatHashMap(std::size_t n = 0,
+                          const HASH& hash = HASH(),
+                          const EQUAL& equal = EQUAL())
+        : m_Hash(hash), m_Equal(equal), m_Size(0), m_Erased(0) {
+        this->reserve(n);
+    }
+
+    CFlatHashMap(const CFlatHashMap& other) = default;
+    CFlatHashMap(CFlatHashMap&& other)
+        : m_Hash(other.m_Hash), m_Equal(other.m_Equal), m_Size(0), m_Erased(0) {
+        this->swap(other);
+    }
+
+    CFlatHashMap& operator=(const CFlatHashMap& other) = default;
+    CFlatHashMap& operator=(CFlatHashMap&& other) {
+        CFlatHashMap tmp{std::move(other)};
+        this->swap(tmp);
+        return *this;
+    }
+
+    iterator begin() {
+        return iterator(m_Control.data(), m_Control.data() + m_Control.size(),
+                        m_Slots.data());
+    }
+    iterator end() {
+        return iterator(m_Control.data() + m_Control.size(),
+                        m_Control.data() + m_Control.size(),
+                        m_Slots.data() + m_Slots.size());
+    }
+    const_iterator begin() const {
+        return const_iterator(m_Control.data(), m_Control.data() + m_Control.size(),
+                              m_Slots.data());
+    }
+    const_iterator end() const {
+        return const_iterator(m_Control.data() + m_Control.size(),
+                              m_Control.data() + m_Control.size(),
+                              m_Slots.data() + m_Slots.size());
+    }
+    const_iterator cbegin() const { return this->begin(); }
+    const_iterator cend() const { return this->end(); }
+
+    //! Get the number of entries.
+    std::size_t size() const { return m_Size; }
+
+    //! Check if there are no entries.
+    bool empty() const { return m_Size == 0; }
+
+    //! Get the number of slots.
+    std::size_t capacity() const { return m_Slots.size(); }
+
+    //! Remove all the entries retaining the memory for the slots.
+    void clear() {
+        if (m_Size + m_Erased > 0) {
+            for (std::size_t i = 0u; i < m_Control.size(); ++i) {
+                if (m_Control[i] != EMPTY) {
+                    m_Control[i] = EMPTY;
+                    m_Slots[i] = value_type();
+                }
+            }
+            m_Size = 0;
+            m_Erased = 0;
+        }
+    }
+
+    //! Ensure there is space for \p n entries without rehashing.
+    void reserve(std::size_t n) {
+        std::size_t capacity{capacityFor(n)};
+        if (capacity > m_Slots.size()) {
+            this->rehash(capacity);
+        }
+    }
+
+    //! Find the entry for \p key.
+    iterator find(const KEY& key) {
+        std::size_t slot{this->slotOf(key)};
+        return slot == m_Slots.size() ? this->end() : this->iteratorAt(slot);
+    }
+
+    //! Find the entry for \p key.
+    const_iterator find(const KEY& key) const {
+        std::size_t slot{this->slotOf(key)};
+        return slot == m_Slots.size() ? this->end() : this->iteratorAt(slot);
+    }
+
+    //! Get the number of entries with key \p key.
+    std::size_t count(const KEY& key) const {
+        return this->slotOf(key) == m_Slots.size() ? 0 : 1;
+    }
+
+    //! Get the value for \p key inserting a default value if it is missing.
+    VALUE& operator[](const KEY& key) {
+        return this->emplace(key, VALUE()).first->second;
+    }
+
+    //! Insert \p value if there is no entry for \p key.
+    //!
+    //! \return The entry for \p key and true if it was inserted.
+    template<typename V>
+    TIteratorBoolPr emplace(const KEY& key, V&& value) {
+        if (8 * (m_Size + m_Erased + 1) > 7 * m_Slots.size()) {
+            // Purge the erased slots if they are the majority else grow.
+            this->rehash(std::max(m_Erased > m_Size ? m_Slots.size() : 2 * m_Slots.size(),
+                                  capacityFor(m_Size + 1)));
+        }
+        uint64_t hash{this->hash(key)};
+        uint8_t tag{static_cast<uint8_t>(hash & 0x7f)};
+        std::size_t mask{m_Slots.size() - 1};
+        std::size_t insert{m_Slots.size()};
+        for (std::size_t i = this->home(hash);; i = (i + 1) & mask) {
+            uint8_t control{m_Control[i]};
+            if (control == EMPTY) {
+                if (insert == m_Slots.size()) {
+                    insert = i;
+                } else {
+                    --m_Erased;
+                }
+                break;
+            }
+            if (control == tag && m_Equal(m_Slots[i].first, key)) {
+                return {this->iteratorAt(i), false};
+            }
+            if (control == ERASED && insert == m_Slots.size()) {
+                insert = i;
+            }
+        }
+        m_Control[insert] = tag;
+        m_Slots[insert].first = key;
+        m_Slots[insert].second = std::forward<V>(value);
+        ++m_Size;
+        return {this->iteratorAt(insert), true};
+    }
+
+    //! Insert \p value if there is no entry for its key.
+    TIteratorBoolPr insert(const value_type& value) {
+        return this->emplace(value.first, value.second);
+    }
+
+    //! Insert the values in [\p begin, \p end).
+    template<typename ITR>
+    void insert(ITR begin, ITR end) {
+        for (/**/; begin != end; ++begin) {
+            this->insert(*begin);
+        }
+    }
+
+    //! Erase the entry at \p i.
+    //!
+    //! \return An iterator to the next entry.
+    iterator erase(const_iterator i) {
+        std::size_t slot{static_cast<std::size_t>(i.m_Control - m_Control.data())};
+        std::size_t next{(slot + 1) & (m_Slots.size() - 1)};
+        // If the next slot is empty no probe sequence passes through this
+        // one so it can be marked empty rather than erased.
+        if (m_Control[next] == EMPTY) {
+            m_Control[slot] = EMPTY;
+        } else {
+            m_Control[slot] = ERASED;
+            ++m_Erased;
+        }
+        m_Slots[slot] = value_type();
+        --m_Size;
+        return this->iteratorAt(slot);
+    }
+
+    //! Erase the entry for \p key if there is one.
+    //!
+    //! \return The number of entries erased.
+    std::size_t erase(const KEY& key) {
+        std::size_t slot{this->slotOf(key)};
+        if (slot == m_Slots.size()) {
+            return 0;
+        }
+        this->erase(this->iteratorAt(slot));
+        return 1;
+    }
+
+    //! Swap the contents of this and \p other.
+    void swap(CFlatHashMap& other) {
+        using std::swap;
+        swap(m_Hash, other.m_Hash);
+        swap(m_Equal, other.m_Equal);
+        m_Control.swap(other.m_Control);
+        m_Slots.swap(other.m_Slots);
+        swap(m_Size, other.m_Size);
+        swap(m_Erased, other.m_Erased);
+    }
+
+    //! Check if this and \p other contain the same entries.
+    bool operator==(const CFlatHashMap& other) const {
+        if (m_Size != other.m_Size) {
+            return false;
+        }
+        for (const auto& entry : *this) {
+            auto i = other.find(entry.first);
+            if (i == other.end() || !(i->second == entry.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const CFlatHashMap& other) const {
+        return !(*this == other);
+    }
+
+    //! Debug the memory used by this object.
+    void debugMemoryUsage(CMemoryUsage::TMemoryUsagePtr mem) const {
+        mem->setName("CFlatHashMap");
+        CMemoryDebug::dynamicSize("m_Control", m_Control, mem);
+        CMemoryDebug::dynamicSize("m_Slots", m_Slots, mem);
+    }
+
+    //! Get the memory used by this object.
+    std::size_t memoryUsage() const {
+        return CMemory::dynamicSize(m_Control) + CMemory::dynamicSize(m_Slots);
+    }
+
+private:
+    static bool isFull(uint8_t control) { return (control & 0x80) == 0; }
+
+    //! Get the number of slots needed to hold \p n entries at a load
+    //! factor of at most 7/8.
+    static std::size_t capacityFor(std::size_t n) {
+        if (n == 0) {
+            return 0;
+        }
+        std::size_t result{MINIMUM_CAPACITY};
+        while (8 * n > 7 * result) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    //! Get the well mixed hash of \p key.
+    uint64_t hash(const KEY& key) const {
+        return static_cast<uint64_t>(m_Hash(key)) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    //! Get the first slot to probe for \p hash.
+    std::size_t home(uint64_t hash) const {
+        return static_cast<std::size_t>(hash >> 32) & (m_Slots.size() - 1);
+    }
+
+    //! Get the slot of \p key or the number of slots if it is missing.
+    std::size_t slotOf(const KEY& key) const {
+        if (m_Size == 0) {
+            return m_Slots.size();
+        }
+        uint64_t hash{this->hash(key)};
+        uint8_t tag{static_cast<uint8_t>(hash & 0x7f)};
+        std::size_t mask{m_Slots.size() - 1};
+        for (std::size_t i = this->home(hash);; i = (i + 1) & mask) {
+            uint8_t control{m_Control[i]};
+            if (control == EMPTY) {
+                return m_Slots.size();
+            }
+            if (control == tag && m_Equal(m_Slots[i].first, key)) {
+                return i;
+            }
+        }
+    }
+
+    iterator iteratorAt(std::size_t slot) {
+        return iterator(m_Control.data() + slot, m_Control.data() + m_Control.size(),
+                        m_Slots.data() + slot);
+    }
+    const_iterator iteratorAt(std::size_t slot) const {
+        return const_iterator(m_Control.data() + slot,
+                              m_Control.data() + m_Control.size(),
+                              m_Slots.data() + slot);
+    }
+
+    //! Move the entries into \p capacity slots dropping erased slots.
+    void rehash(std::size_t capacity) {
+        TUInt8Vec control(capacity, EMPTY);
+        TValueVec slots(capacity);
+        std::size_t mask{capacity - 1};
+        for (std::size_t i = 0u; i < m_Slots.size(); ++i) {
+            if (isFull(m_Control[i])) {
+                uint64_t hash{this->hash(m_Slots[i].first)};
+                std::size_t j{static_cast<std::size_t>(hash >> 32) & mask};
+                while (control[j] != EMPTY) {
+                    j = (j + 1) & mask;
+                }
+                control[j] = m_Control[i];
+                slots[j] = std::move(m_Slots[i]);
+            }
+        }
+        m_Control.swap(control);
+        m_Slots.swap(slots);
+        m_Erased = 0;
+    }
+
+private:
+    //! The key hash function.
+    HASH m_Hash;
+
+    //! The key equality function.
+    EQUAL m_Equal;
+
+    //! The control byte for each slot.
+    TUInt8Vec m_Control;
+
+    //! The entries.
+    TValueVec m_Slots;
+
+    //! The number of entries.
+    std::size_t m_Size;
+
+    //! The number of erased slots.
+    std::size_t m_Erased;
+};
+
+template<typename KEY, typename VALUE, typename HASH, typename EQUAL>
+const uint8_t CFlatHashMap<KEY, VALUE, HASH, EQUAL>::EMPTY;
+template<typename KEY, typename VALUE, typename HASH, typename EQUAL>
+const uint8_t CFlatHashMap<KEY, VALUE, HASH, EQUAL>::ERASED;
+template<typename KEY, typename VALUE, typename HASH, typename EQUAL>
+const std::size_t CFlatHashMap<KEY, VALUE, HASH, EQUAL>::MINIMUM_CAPACITY;
+
+template<typename KEY, typename VALUE, typename HASH, typename EQUAL>
+void swap(CFlatHashMap<KEY, VALUE, HASH, EQUAL>& lhs,
+          CFlatHashMap<KEY, VALUE, HASH, EQUAL>& rhs) {
+    lhs.swap(rhs);
+}
+}
+}
+
+#endif // INCLUDED_ml_core_CFlatHashMap_h
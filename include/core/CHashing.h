@@ -358,6 +358,23 @@ public:
     //! and check alignment.
     static uint64_t safeMurmurHash64(const void* key, int length, uint64_t seed);
 
+    //! wyhash: fast 64-bit hash.
+    //!
+    //! This is adapted from Wang Yi's wyhash (which is in the public
+    //! domain). It consumes up to 48 bytes per iteration in three
+    //! independent lanes and mixes using the full 128 bit product of
+    //! two 64 bit integers, so it is considerably faster than MurmurHash2
+    //! for the field values we typically see, which are between a few
+    //! and a few hundred bytes long.
+    //!
+    //! Blocks are read with memcpy and converted from little endian so
+    //! this is both alignment safe and endian neutral, i.e. it gives the
+    //! same value for a given key and seed on every platform. However,
+    //! existing persisted hashes, for example those in the normalizer
+    //! cues, are computed with safeMurmurHash64 and must stay that way
+    //! to be compatible with previously persisted state.
+    static uint64_t wyHash64(const void* key, int length, uint64_t seed);
+
     //! Wrapper for murmur hash to use with basic types.
     //!
     //! \warning This is slower than boost::hash for the types I tested
@@ -436,6 +453,34 @@ public:
         uint64_t m_Seed;
     };
 
+    //! Wrapper for wyhash to use with std::string.
+    //!
+    //! \note This is the fastest string hash we have and should be
+    //! preferred for in-memory hash maps keyed by string.
+    class CORE_EXPORT CWyHashString : public std::unary_function<std::string, std::size_t> {
+    public:
+        //! See CMemory.
+        static bool dynamicSizeAlwaysZero() { return true; }
+        using TStrCRef = boost::reference_wrapper<const std::string>;
+
+    public:
+        CWyHashString(std::size_t seed = 0x5bd1e995) : m_Seed(seed) {}
+
+        std::size_t operator()(const std::string& key) const;
+        std::size_t operator()(TStrCRef key) const {
+            return this->operator()(key.get());
+        }
+        std::size_t operator()(const CStoredStringPtr& key) const {
+            if (key) {
+                return this->operator()(*key);
+            }
+            return m_Seed;
+        }
+
+    private:
+        std::size_t m_Seed;
+    };
+
     //! 32 bit hash combine modeled on boost::hash_combine.
     static uint32_t hashCombine(uint32_t seed, uint32_t h);
 
@@ -479,6 +524,11 @@ inline std::size_t CHashing::CMurmurHash2String::operator()(const std::string& k
 inline uint64_t CHashing::CSafeMurmurHash2String64::operator()(const std::string& key) const {
     return CHashing::safeMurmurHash64(key.data(), static_cast<int>(key.size()), m_Seed);
 }
+
+inline std::size_t CHashing::CWyHashString::operator()(const std::string& key) const {
+    return static_cast<std::size_t>(
+        CHashing::wyHash64(key.data(), static_cast<int>(key.size()), m_Seed));
+}
 }
 }
 
@@ -0,0 +1,86 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_ml_core_CMemoryMappedFile_h
+#define INCLUDED_ml_core_CMemoryMappedFile_h
+
+#include <core/CNonCopyable.h>
+#include <core/ImportExport.h>
+#include <core/WindowsSafe.h>
+
+#include <string>
+
+namespace ml {
+namespace core {
+
+//! \brief
+//! A growable read/write memory mapping of a scratch file.
+//!
+//! DESCRIPTION:\n
+//! Creates a new file, maps the whole of it into the address space and
+//! allows the mapping to grow. The file only exists to back the mapping
+//! and is deleted when it is closed.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! On Unix the file is extended by writing its last byte rather than by
+//! truncating it, because ftruncate is not allowed by the system call
+//! filter.
+//!
+//! Growing the mapping may move it, so any pointers into the mapping
+//! are invalidated by resize.
+//!
+class CORE_EXPORT CMemoryMappedFile : private CNonCopyable {
+public:
+    CMemoryMappedFile();
+    ~CMemoryMappedFile();
+
+    //! Create the file \p fileName, which must not already exist, and
+    //! map \p size bytes of it.
+    bool open(const std::string& fileName, std::size_t size);
+
+    //! Grow the file and its mapping to \p size bytes. The contents of
+    //! the mapping are preserved.
+    bool resize(std::size_t size);
+
+    //! Unmap and delete the file.
+    void close();
+
+    //! Check if the file is mapped.
+    bool isOpen() const;
+
+    //! Get the size of the mapping in bytes.
+    std::size_t size() const;
+
+    //! Get the start of the mapping.
+    char* data();
+
+    //! Get the start of the mapping.
+    const char* data() const;
+
+private:
+    //! The name of the file.
+    std::string m_FileName;
+
+#ifdef Windows
+    //! The file handle.
+    HANDLE m_File;
+
+    //! The file mapping handle.
+    HANDLE m_Mapping;
+#else
+    //! The file descriptor.
+    int m_Fd;
+#endif
+
+    //! The start of the mapping.
+    char* m_Data;
+
+    //! The size of the mapping.
+    std::size_t m_Size;
+};
+}
+}
+
+#endif // INCLUDED_ml_core_CMemoryMappedFile_h
@@ -0,0 +1,123 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_ml_core_CParallel_h
+#define INCLUDED_ml_core_CParallel_h
+
+#include <core/CNonInstantiatable.h>
+#include <core/CStaticThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+
+namespace ml {
+namespace core {
+
+//! \brief
+//! Utilities for running independent tasks on multiple threads.
+//!
+//! DESCRIPTION:\n
+//! forEach applies a function to each element of a random access range
+//! using up to a specified number of threads. The calling thread does
+//! its share of the work and the other threads are the workers of the
+//! default CStaticThreadPool. If the default pool isn't running everything
+//! runs on the calling thread, so work is only done in parallel when
+//! background threads have been requested.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! Elements are handed out one at a time from a shared counter so uneven
+//! work balances out. This is only intended for work which takes much
+//! longer than scheduling a task, such as processing all the models of
+//! a detector.
+//!
+//! The calling thread keeps taking elements until the range is used up
+//! and then only waits for elements which workers have already started.
+//! So if the pool is busy with other tasks, for example periodicity tests,
+//! forEach doesn't wait for them: it just runs with fewer threads. Workers
+//! which start after the range is used up return immediately.
+//!
+//! The function must be safe to call concurrently for different elements
+//! and must not throw.
+class CParallel : private CNonInstantiatable {
+public:
+    //! Get the number of threads to use by default. This is the calling
+    //! thread plus the workers of the default thread pool if it is running.
+    static std::size_t defaultThreads() {
+        return CStaticThreadPool::defaultNumberThreads() + 1;
+    }
+
+    //! Call \p f on each element of [\p begin, \p end) using up to
+    //! \p threads threads.
+    template<typename ITR, typename F>
+    static void forEach(std::size_t threads, ITR begin, ITR end, F f) {
+        std::size_t n{static_cast<std::size_t>(std::distance(begin, end))};
+        threads = std::min(threads, n);
+        if (threads <= 1 || CStaticThreadPool::defaultRunning() == false) {
+            std::for_each(begin, end, f);
+            return;
+        }
+
+        // The workers may only start after the calling thread has used up
+        // the range, for example if the pool is busy with earlier tasks, so
+        // any state they touch before they've claimed an element must be
+        // shared. A worker only uses the range and f once it has claimed an
+        // element, and we wait until every claimed element is done, so the
+        // calling thread never waits for a worker which didn't start in time.
+        auto state = std::make_shared<SState>(n);
+        F* f_ = &f;
+        auto work = [state, begin, f_]() {
+            for (std::size_t i = state->s_Next++; i < state->s_N; i = state->s_Next++) {
+                (*f_)(*(begin + i));
+                state->done();
+            }
+        };
+
+        for (std::size_t i = 1u; i < threads; ++i) {
+            CStaticThreadPool::async(work);
+        }
+        work();
+        state->wait();
+    }
+
+private:
+    //! \brief The state shared by the threads running forEach.
+    struct SState {
+        explicit SState(std::size_t n) : s_N{n}, s_Next{0}, s_Done{0} {}
+
+        //! Record that an element has been processed.
+        void done() {
+            std::unique_lock<std::mutex> lock{s_Mutex};
+            if (++s_Done == s_N) {
+                s_Condition.notify_all();
+            }
+        }
+
+        //! Wait until every element has been processed.
+        void wait() {
+            std::unique_lock<std::mutex> lock{s_Mutex};
+            s_Condition.wait(lock, [this] { return s_Done == s_N; });
+        }
+
+        //! The number of elements.
+        const std::size_t s_N;
+        //! The next element to claim.
+        std::atomic<std::size_t> s_Next;
+        //! Protects s_Done.
+        std::mutex s_Mutex;
+        //! Signalled when the last element has been processed.
+        std::condition_variable s_Condition;
+        //! The number of elements which have been processed.
+        std::size_t s_Done;
+    };
+};
+}
+}
+
+#endif // INCLUDED_ml_core_CParallel_h
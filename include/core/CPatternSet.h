@@ -7,7 +7,7 @@
 #ifndef INCLUDED_ml_model_CPatternSet_h
 #define INCLUDED_ml_model_CPatternSet_h
 
-#include <core/CFlatPrefixTree.h>
+#include <core/CAhoCorasickAutomaton.h>
 #include <core/ImportExport.h>
 
 #include <string>
@@ -29,17 +29,18 @@ namespace core {
 //!
 //! IMPLEMENTATION DECISIONS:\n
 //! Upon building the set, patterns are categorised in the aforementioned 4
-//! categories. They are then stored in a corresponding prefix tree that allows
-//! efficient lookups. In particular a key is contained in the set if:
+//! categories. They are then all compiled into a single Aho-Corasick automaton
+//! where full, prefix and suffix patterns are anchored at the appropriate ends
+//! of the key. This means a lookup takes time linear in the length of the key
+//! independent of the number of patterns in the set. In particular a key is
+//! contained in the set if:
 //!   - its start matches a prefix pattern
 //!   - its end matched a suffix pattern
 //!   - it matches fully against a full pattern
-//!   - the start of any of its substrings ending at its end matches a contains pattern
+//!   - any of its substrings matches a contains pattern
 class CORE_EXPORT CPatternSet {
 public:
     using TStrVec = std::vector<std::string>;
-    using TStrVecCItr = TStrVec::const_iterator;
-    using TStrCItr = std::string::const_iterator;
 
 public:
     //! Default constructor.
@@ -54,22 +55,12 @@ public:
     //! Clears the set.
     void clear();
 
-private:
-    void sortAndPruneDuplicates(TStrVec& keys);
+    //! Get the memory used by this object.
+    std::size_t memoryUsage() const;
 
 private:
-    //! The prefix tree containing full patterns (no wildcard).
-    CFlatPrefixTree m_FullMatchPatterns;
-
-    //! The prefix tree containing prefix patterns.
-    CFlatPrefixTree m_PrefixPatterns;
-
-    //! The prefix tree containing suffix patterns
-    //! (note that the suffixes are stored reverted).
-    CFlatPrefixTree m_SuffixPatterns;
-
-    //! The prefix tree containing the contains patterns.
-    CFlatPrefixTree m_ContainsPatterns;
+    //! The automaton containing all the patterns.
+    CAhoCorasickAutomaton m_Patterns;
 };
 }
 }
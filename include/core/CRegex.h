@@ -39,6 +39,10 @@ public:
     bool matches(const std::string&) const;
 
     //! Find the position within a string at which this regex first matches
+    //!
+    //! \note When a start position is supplied the characters before it are
+    //! treated as context, so anchors and word boundaries only match where they would
+    //! have matched had the search started at the beginning of the string.
     bool search(size_t startPos, const std::string& str, size_t& position, size_t& length) const;
     bool search(size_t startPos, const std::string& str, size_t& position) const;
     bool search(const std::string& str, size_t& position, size_t& length) const;
@@ -25,6 +25,18 @@ namespace core {
 //! will iteratively apply each regex to the string until no
 //! match can be found and it will remove all matched substrings.
 //!
+//! IMPLEMENTATION DECISIONS:\n
+//! Most of the regular expressions in a typical filter don't match
+//! most strings, and a failed search still visits every position in
+//! the string. Since the regular expressions are fixed, we extract
+//! at configuration time a literal which any match of each must
+//! contain and only search with a regular expression if the string
+//! contains its literal, which is much cheaper to check. The check is
+//! made against the string as it is when each regular expression is
+//! applied, since deleting earlier matches can create occurrences of
+//! a literal, so the result is exactly the same as searching with all
+//! the regular expressions.
+//!
 class CORE_EXPORT CRegexFilter {
 public:
     using TRegexVec = std::vector<CRegex>;
@@ -39,12 +51,28 @@ public:
     //! Applies the filter to \p target.
     std::string apply(const std::string& target) const;
 
+    //! Applies the filter to \p target writing the filtered string
+    //! to \p result.
+    //!
+    //! \note This allows the caller to reuse \p result's buffer.
+    void apply(const std::string& target, std::string& result) const;
+
     //! Returns true if the filter is empty.
     bool empty() const;
 
+    //! Get a literal which every match of \p regex must contain, or
+    //! the empty string if none is found.
+    //!
+    //! \note This is conservative: it gives up on constructs, such as
+    //! mode modifiers, which could change what a literal matches.
+    static std::string requiredLiteral(const std::string& regex);
+
 private:
     //! The regular expressions comprising the filter.
     TRegexVec m_Regex;
+
+    //! A literal contained in every match of each regular expression.
+    TStrVec m_RequiredLiterals;
 };
 }
 }
@@ -0,0 +1,122 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_ml_core_CStaticThreadPool_h
+#define INCLUDED_ml_core_CStaticThreadPool_h
+
+#include <core/CNonCopyable.h>
+#include <core/ImportExport.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ml {
+namespace core {
+
+//! \brief
+//! A fixed size pool of threads which run tasks in the background.
+//!
+//! DESCRIPTION:\n
+//! Tasks are queued and run in the order they were scheduled by the
+//! first free worker. Destroying the pool runs any tasks which are
+//! still queued and then joins the workers.
+//!
+//! There is a single process wide default pool which is off unless
+//! it is explicitly started. async uses the default pool if it is
+//! running and otherwise runs the task immediately on the calling
+//! thread, so code written against it behaves exactly as before when
+//! background threads aren't requested.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! The threads are created once and reused: this is intended for many
+//! small tasks which are generated continuously as data are processed.
+//! CParallel also uses the default pool to split up larger pieces of
+//! work. Tasks must not throw.
+//!
+//! The default pool must be started and stopped from the main thread
+//! when no tasks are being scheduled.
+class CORE_EXPORT CStaticThreadPool : private CNonCopyable {
+public:
+    using TTask = std::function<void()>;
+
+public:
+    explicit CStaticThreadPool(std::size_t threads);
+    ~CStaticThreadPool();
+
+    //! Get the number of worker threads.
+    std::size_t numberThreads() const;
+
+    //! Queue \p task to run on the next free worker.
+    void schedule(TTask task);
+
+    //! \name Default Pool
+    //@{
+    //! Start the default pool with \p threads workers. Zero threads
+    //! stops it.
+    static void startDefault(std::size_t threads);
+
+    //! Run any queued tasks and stop the default pool.
+    static void stopDefault();
+
+    //! Check if the default pool is running.
+    static bool defaultRunning();
+
+    //! Get the number of workers in the default pool, which is zero if
+    //! it isn't running.
+    static std::size_t defaultNumberThreads();
+
+    //! Run \p f on the default pool if it is running or immediately
+    //! otherwise and get a future for its result.
+    template<typename F>
+    static std::shared_future<typename std::result_of<F()>::type> async(F f) {
+        using TResult = typename std::result_of<F()>::type;
+        auto task = std::make_shared<std::packaged_task<TResult()>>(std::move(f));
+        std::shared_future<TResult> result{task->get_future().share()};
+        if (ms_Default != nullptr) {
+            ms_Default->schedule([task]() { (*task)(); });
+        } else {
+            (*task)();
+        }
+        return result;
+    }
+    //@}
+
+private:
+    using TTaskDeque = std::deque<TTask>;
+    using TThreadVec = std::vector<std::thread>;
+    using TStaticThreadPoolUPtr = std::unique_ptr<CStaticThreadPool>;
+
+private:
+    //! The worker loop.
+    void worker();
+
+private:
+    //! The process wide default pool.
+    static TStaticThreadPoolUPtr ms_Default;
+
+private:
+    //! Protects the task queue and the done flag.
+    std::mutex m_Mutex;
+    //! Signalled when a task is queued or the pool is stopping.
+    std::condition_variable m_Condition;
+    //! The queued tasks.
+    TTaskDeque m_Tasks;
+    //! Set when the pool is stopping.
+    bool m_Done;
+    //! The worker threads.
+    TThreadVec m_Workers;
+};
+}
+}
+
+#endif // INCLUDED_ml_core_CStaticThreadPool_h
@@ -83,6 +83,42 @@ enum EStatTypes {
     //! The number of times partial memory estimates have been carried out
     E_NumberMemoryUsageEstimates,
 
+    //! The total time in milliseconds spent generating model plots
+    E_ModelPlotTime,
+
+    //! The number of tests for seasonal components which have been run
+    E_NumberPeriodicityTests,
+
+    //! The total time in microseconds spent testing for seasonal components
+    E_PeriodicityTestTime,
+
+    //! The number of decomposition predictions served from the cache
+    E_NumberPredictionCacheHits,
+
+    //! The number of decomposition predictions which were recomputed
+    E_NumberPredictionCacheMisses,
+
+    //! The number of influence probabilities served from the cache
+    E_NumberInfluenceProbabilityCacheHits,
+
+    //! The number of influence probabilities which were computed
+    E_NumberInfluenceProbabilityCacheMisses,
+
+    //! The number of person models which started hibernating
+    E_NumberModelHibernations,
+
+    //! The number of hibernating person models which were restored
+    E_NumberModelWakes,
+
+    //! The time in microseconds spent restoring hibernating person models
+    E_ModelWakeTime,
+
+    //! The number of hibernating model states paged out to disk
+    E_NumberModelPageOuts,
+
+    //! The number of hibernating model states read back from disk
+    E_NumberModelPageIns,
+
     // Add any new values here
 
     //! This MUST be last
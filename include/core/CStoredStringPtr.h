@@ -32,6 +32,26 @@ namespace core {
 //! stored string pointers that are not managed by a string store.
 //!
 class CORE_EXPORT CStoredStringPtr {
+public:
+    //! \brief A reference to a stored string which doesn't keep it alive.
+    //!
+    //! DESCRIPTION:\n
+    //! This can be used to check whether a string whose address has been
+    //! cached still exists, and so whether the address still identifies it.
+    class CORE_EXPORT CWeakPtr {
+    public:
+        //! NULL constructor.
+        CWeakPtr() noexcept;
+        explicit CWeakPtr(const CStoredStringPtr& ptr) noexcept;
+
+        //! Has the string been freed?
+        bool expired() const noexcept;
+
+    private:
+        //! The wrapped weak_ptr.
+        std::weak_ptr<const std::string> m_String;
+    };
+
 public:
     //! NULL constructor.
     CStoredStringPtr() noexcept;
@@ -14,6 +14,9 @@
 
 #include <functional>
 #include <string>
+#include <vector>
+
+#include <stdint.h>
 
 namespace ml {
 namespace core {
@@ -40,6 +43,13 @@ namespace core {
 //!
 //! All checks are case-insensitive.
 //!
+//! The word list never changes once loaded, so it is compiled into a
+//! perfect hash: each word is hashed once to a bucket, and each
+//! bucket stores a seed which maps its words to distinct slots in a
+//! flat table. A lookup is therefore one hash of the word, a couple of
+//! table reads and a single string comparison, and never allocates.
+//! The words themselves are stored lower case in one contiguous string.
+//!
 //! TODO - extend this to cope with different dictionaries for
 //! different languages.
 //!
@@ -147,6 +157,36 @@ private:
         bool operator()(const std::string& lhs, const std::string& rhs) const;
     };
 
+    //! A slot of the perfect hash table.
+    struct SEntry {
+        //! See CMemory.
+        static bool dynamicSizeAlwaysZero() { return true; }
+
+        //! The offset of the word in m_Words.
+        uint32_t s_Offset;
+        //! The length of the word; zero for an empty slot.
+        uint32_t s_Length;
+        //! The word's part of speech.
+        EPartOfSpeech s_PartOfSpeech;
+    };
+
+    using TEntryVec = std::vector<SEntry>;
+    using TUInt32Vec = std::vector<uint32_t>;
+
+    //! Used to load and deduplicate the dictionary words. The key
+    //! is hashed and compared ignoring case.
+    using TStrUMap =
+        boost::unordered_map<std::string, EPartOfSpeech, CStrHashIgnoreCase, CStrEqualIgnoreCase>;
+
+private:
+    //! Compile \p words into a perfect hash table with \p numberSlots
+    //! slots, which must be a power of two. Returns false if no suitable
+    //! seeds could be found.
+    bool compile(const TStrUMap& words, std::size_t numberSlots);
+
+    //! Get the table slot for a word with hash \p hash.
+    std::size_t slot(uint64_t hash) const;
+
 private:
     //! Name of the file to load that contains the dictionary words.
     static const char* const DICTIONARY_FILE;
@@ -162,15 +202,14 @@ private:
     //! its way into every thread).
     static volatile CWordDictionary* ms_Instance;
 
-    //! Stores the dictionary words - using a multi-index even though
-    //! there's only one index, because of its flexible key extractors.
-    //! The key is the string, but hashed and compared ignoring case.
-    using TStrUMap =
-        boost::unordered_map<std::string, EPartOfSpeech, CStrHashIgnoreCase, CStrEqualIgnoreCase>;
-    using TStrUMapCItr = TStrUMap::const_iterator;
+    //! The lower case dictionary words concatenated.
+    std::string m_Words;
+
+    //! The seed used to assign each bucket's words to slots.
+    TUInt32Vec m_Seeds;
 
-    //! Our dictionary of words
-    TStrUMap m_DictionaryWords;
+    //! The perfect hash table.
+    TEntryVec m_Entries;
 };
 }
 }
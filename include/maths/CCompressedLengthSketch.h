@@ -0,0 +1,107 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_ml_maths_CCompressedLengthSketch_h
+#define INCLUDED_ml_maths_CCompressedLengthSketch_h
+
+#include <maths/ImportExport.h>
+
+#include <bitset>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ml {
+namespace maths {
+
+//! \brief A streaming proxy for the deflate compressed length of a set
+//! of strings.
+//!
+//! DESCRIPTION:\n
+//! Deflate encodes its input as a mixture of literals and back references
+//! to earlier repeats of three or more bytes. This estimates the number
+//! of literals by counting the distinct four byte windows in the strings
+//! added so far with linear counting on a fixed size bit set: the k'th
+//! bit to be set adds \f$B / (B - k)\f$ to the estimate, which is the
+//! expected number of distinct windows needed to set it. A literal then
+//! costs roughly the entropy of the observed alphabet and every other
+//! byte a fraction of a bit. The constants were fitted by least squares
+//! on log length against zlib at its default level applied to the sorted
+//! concatenation of random identifiers, words, URLs and host names. The
+//! relative error is typically less than 20% for up to a few thousand
+//! strings.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! Because the increment for the k'th bit doesn't depend on which bit it
+//! is, the estimate depends only on the set of strings added and not on
+//! their order. Each add is linear in the string length, independent of
+//! the number of strings added so far, and the state is a fixed size.
+//! Callers should only add each distinct string once.
+//!
+//! A sketch with the default size uses 512 bytes for its bits. Callers
+//! which keep many sketches, such as one per series and influencer value,
+//! should use sizeFor to choose the size from the total length of the
+//! strings and recreate the sketch when that grows: the number of distinct
+//! windows is at most the number of bytes, so a sketch of a few short
+//! strings needs far fewer bits.
+class MATHS_EXPORT CCompressedLengthSketch {
+public:
+    //! The default number of bits in the sketch.
+    static const std::size_t DEFAULT_SIZE;
+
+public:
+    explicit CCompressedLengthSketch(std::size_t size = DEFAULT_SIZE);
+
+    //! Get the number of bits needed to sketch strings whose total length
+    //! is \p bytes. This is a power of two no larger than DEFAULT_SIZE.
+    static std::size_t sizeFor(std::size_t bytes);
+
+    //! Get the number of bits in the sketch.
+    std::size_t size() const;
+
+    //! Get the total length of the strings added.
+    std::size_t bytes() const;
+
+    //! Add \p value to the set of strings sketched.
+    void add(const std::string& value);
+
+    //! Get the estimated compressed length in bytes.
+    double length() const;
+
+    //! Get a checksum for this object.
+    uint64_t checksum(uint64_t seed = 0) const;
+
+    //! Get the memory used by this object.
+    std::size_t memoryUsage() const;
+
+private:
+    using TUInt64Vec = std::vector<uint64_t>;
+    using TByteBitSet = std::bitset<256>;
+
+private:
+    //! The bits set by the hashed windows.
+    TUInt64Vec m_Windows;
+
+    //! The number of set bits in m_Windows.
+    std::size_t m_Occupied;
+
+    //! The estimated number of distinct windows.
+    double m_Literals;
+
+    //! The byte values seen.
+    TByteBitSet m_Alphabet;
+
+    //! The total number of bytes added.
+    std::size_t m_Bytes;
+
+    //! The number of strings added.
+    std::size_t m_Strings;
+};
+}
+}
+
+#endif // INCLUDED_ml_maths_CCompressedLengthSketch_h
@@ -15,6 +15,7 @@
 
 #include <boost/unordered_map.hpp>
 
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -49,6 +50,13 @@ namespace maths {
 //! components are the projected normalised residuals, finding the
 //! most correlated variables amounts to a collection neighbourhood
 //! searches around each point.
+//!
+//! In incremental mode the neighbourhood searches for the projection
+//! which has just been completed are spread over the captures of the
+//! next projection, rather than all being performed in the capture
+//! which completes it. Once the "most correlated" collection is full
+//! this amortises the cost of the search over buckets at the expense
+//! of adding new correlated pairs one projection later.
 class MATHS_EXPORT CKMostCorrelated {
 public:
     //! The number of projections of the data to maintain
@@ -68,7 +76,10 @@ public:
         boost::unordered_map<std::size_t, TVectorPackedBitVectorPr>;
 
 public:
-    CKMostCorrelated(std::size_t k, double decayRate, bool initialize = true);
+    CKMostCorrelated(std::size_t k,
+                     double decayRate,
+                     bool initialize = true,
+                     bool incremental = false);
 
     //! Create from part of a state document.
     bool acceptRestoreTraverser(core::CStateRestoreTraverser& traverser);
@@ -199,6 +210,74 @@ protected:
     };
 
     using TCorrelationVec = std::vector<SCorrelation>;
+    using TMaxCorrelationAccumulator = CBasicStatistics::COrderStatisticsHeap<SCorrelation>;
+
+    //! \brief An index of the projected variables which supports
+    //! nearest neighbour and range queries.
+    class CPointIndex;
+    using TPointIndexCPtr = std::shared_ptr<const CPointIndex>;
+
+    //! \brief The state of a search for new correlated pairs.
+    //!
+    //! DESCRIPTION:\n
+    //! The search visits the nearest neighbours of a sample of seed
+    //! variables, to bound the distance to the least correlated pair
+    //! it will keep, and then searches around every variable for pairs
+    //! closer than this bound. Each of these is a step of the search
+    //! so they can be spread over a number of calls.
+    //!
+    //! IMPLEMENTATION DECISIONS:\n
+    //! The index is immutable once it has been built so it is shared
+    //! between copies. It is not persisted but is rebuilt from the
+    //! projections the first time it is needed after restoring.
+    struct MATHS_EXPORT SSearch {
+        SSearch();
+
+        //! Create from part of a state document.
+        bool acceptRestoreTraverser(core::CStateRestoreTraverser& traverser);
+
+        //! Persist state by passing to the supplied inserter.
+        void acceptPersistInserter(core::CStatePersistInserter& inserter) const;
+
+        //! Check if a search has been started.
+        bool active() const;
+
+        //! Get the total number of steps in the search.
+        std::size_t steps() const;
+
+        //! Reset to an inactive search.
+        void clear();
+
+        //! Get the checksum of this object.
+        uint64_t checksum(uint64_t seed) const;
+
+        //! Debug the memory used by this object.
+        void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
+
+        //! Get the memory used by this object.
+        std::size_t memoryUsage() const;
+
+        //! The projected variables being searched. This is only used
+        //! in incremental mode.
+        TSizeVectorPackedBitVectorPrUMap s_Projected;
+        //! The variables being searched. These are in increasing order
+        //! for the incremental search so they can be restored.
+        TSizeVec s_Variables;
+        //! The positions in s_Variables of the seed variables.
+        TSizeVec s_Seeds;
+        //! The next step to perform.
+        std::size_t s_Next;
+        //! The number of nearest neighbours of each seed to visit.
+        std::size_t s_Neighbours;
+        //! The maximum count of any variable's projected values.
+        double s_MaximumCount;
+        //! The maximum number of pairs to find.
+        std::size_t s_Size;
+        //! The most correlated pairs found so far.
+        TMaxCorrelationAccumulator s_MostCorrelated;
+        //! The index of s_Variables' projections.
+        TPointIndexCPtr s_Index;
+    };
 
 protected:
     //! Get the most correlated variables based on the current
@@ -208,6 +287,29 @@ protected:
     //! Generate the next projection and reinitialize related state.
     void nextProjection();
 
+    //! Start a search of \p projected for pairs not already in the
+    //! "most correlated" collection.
+    //!
+    //! \param[in] sorted If true the variables are visited in increasing
+    //! order, which the persisted incremental search needs, otherwise in
+    //! the iteration order of \p projected as the batch search always has.
+    void startSearch(const TSizeVectorPackedBitVectorPrUMap& projected,
+                     bool sorted,
+                     SSearch& search) const;
+
+    //! Perform the steps of \p search of \p projected before \p end.
+    void continueSearch(const TSizeVectorPackedBitVectorPrUMap& projected,
+                        std::size_t end,
+                        SSearch& search) const;
+
+    //! Complete the incremental search and add the pairs it found to the
+    //! "most correlated" collection.
+    void finishSearch();
+
+    //! Add the pairs \p add, which are in order of decreasing correlation,
+    //! to the "most correlated" collection.
+    void addMostCorrelated(const TCorrelationVec& add);
+
     //! Get the projections.
     const TVectorVec& projections() const;
 
@@ -227,6 +329,10 @@ private:
     //! The rate at which to forget about historical correlations.
     double m_DecayRate;
 
+    //! If true then spread the search for correlated pairs over the
+    //! captures of the next projection.
+    bool m_Incremental;
+
     //! The random number generator.
     mutable CPRNG::CXorShift1024Mult m_Rng;
 
@@ -247,6 +353,9 @@ private:
 
     //! The 2 * m_Size most correlated variables.
     TCorrelationVec m_MostCorrelated;
+
+    //! The search in progress in incremental mode.
+    SSearch m_Search;
 };
 }
 }
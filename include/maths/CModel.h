@@ -18,6 +18,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 
 namespace ml {
 namespace core {
@@ -42,6 +43,11 @@ using TForecastPushDatapointFunc = std::function<void(SErrorBar)>;
 
 //! \brief Model parameters.
 class MATHS_EXPORT CModelParams {
+public:
+    //! Held by a model while it is testing for change (see
+    //! changeDetectorToken for details).
+    using TChangeDetectorTokenPtr = std::shared_ptr<const bool>;
+
 public:
     CModelParams(core_t::TTime bucketLength,
                  double learnRate,
@@ -80,6 +86,32 @@ public:
     //! Get the probability that the bucket will be empty for the model.
     double probabilityBucketEmpty() const;
 
+    //! Set the maximum number of models sharing these parameters which
+    //! may test for change at any one time.
+    void maximumNumberActiveChangeDetectors(std::size_t number);
+
+    //! Get the maximum number of models sharing these parameters which
+    //! may test for change at any one time.
+    std::size_t maximumNumberActiveChangeDetectors() const;
+
+    //! Get the number of models sharing these parameters which are
+    //! currently testing for change.
+    std::size_t numberActiveChangeDetectors() const;
+
+    //! Get a token a model must hold for as long as it tests for change.
+    //!
+    //! This returns null if the maximum number of models sharing these
+    //! parameters are already testing for change, unless \p force is
+    //! true, for example because the test is being restored.
+    //!
+    //! \note A model stops counting towards the active change detectors
+    //! when it and any copies of its token are destroyed. Copies made for
+    //! persistence don't hold a token.
+    TChangeDetectorTokenPtr changeDetectorToken(bool force = false) const;
+
+private:
+    using TChangeDetectorTokenPtrPtr = std::shared_ptr<TChangeDetectorTokenPtr>;
+
 private:
     //! The data bucketing length.
     core_t::TTime m_BucketLength;
@@ -95,6 +127,12 @@ private:
     core_t::TTime m_MaximumTimeToTestForChange;
     //! The probability that a bucket will be empty for the model.
     double m_ProbabilityBucketEmpty;
+    //! The maximum number of models which may test for change at once.
+    std::size_t m_MaximumNumberActiveChangeDetectors;
+    //! The token copied to each model testing for change. This is shared
+    //! by all copies of these parameters and its use count, less this
+    //! reference, is the number of models testing for change.
+    TChangeDetectorTokenPtrPtr m_ChangeDetectorToken;
 };
 
 //! \brief The extra parameters needed by CModel::addSamples.
@@ -178,6 +216,8 @@ public:
 
     //! Add whether a value's bucket is empty.
     CModelProbabilityParams& addBucketEmpty(const TBool2Vec& empty);
+    //! Set whether the values' bucket is empty.
+    CModelProbabilityParams& bucketEmpty(const TBool2Vec1Vec& empty);
     //! Get whether the values' bucket is empty.
     const TBool2Vec1Vec& bucketEmpty() const;
 
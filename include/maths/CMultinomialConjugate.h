@@ -13,6 +13,8 @@
 #include <maths/CPrior.h>
 #include <maths/ImportExport.h>
 
+#include <memory>
+
 namespace ml {
 namespace core {
 class CStatePersistInserter;
@@ -345,10 +347,20 @@ public:
                         const TEqualWithTolerance& equal) const;
     //@}
 
+private:
+    class CLessLikelyCategories;
+    using TLessLikelyCategoriesCPtr = std::shared_ptr<const CLessLikelyCategories>;
+
 private:
     //! Read parameters from \p traverser.
     bool acceptRestoreTraverser(core::CStateRestoreTraverser& traverser);
 
+    //! Get the expected category probabilities in sorted order with
+    //! the probabilities of less likely categories.
+    //!
+    //! \note This is cached until the concentrations change.
+    const CLessLikelyCategories& lessLikelyCategories() const;
+
     //! Shrinks vectors so that we don't use more memory than we need.
     //! Typically vector implements a doubling policy when growing the
     //! buffer, which means that the buffers can end up twice as large
@@ -373,6 +385,10 @@ private:
     //! categories than we were permitted this is not equal to the
     //! sum of the concentration parameters.
     double m_TotalConcentration;
+
+    //! A cache of the sorted expected category probabilities. This is
+    //! immutable once created so it is shared between copies.
+    mutable TLessLikelyCategoriesCPtr m_LessLikelyCategories;
 };
 }
 }
@@ -143,6 +143,8 @@ public:
     using TDoubleSizePrVec = std::vector<TDoubleSizePr>;
     using TDouble1Vec = core::CSmallVector<double, 1>;
     using TDouble1VecVec = std::vector<TDouble1Vec>;
+    using TDoubleVec = std::vector<double>;
+    using TDoubleVecVec = std::vector<TDoubleVec>;
     using TOptionalDouble = boost::optional<double>;
 
 public:
@@ -206,6 +208,21 @@ public:
     //! for that feature.
     double classProbability(std::size_t label, const TDouble1VecVec& x) const;
 
+    //! Get the probabilities of the class labeled \p label for each of
+    //! a collection of points.
+    //!
+    //! This is equivalent to, but much cheaper than, calling classProbability
+    //! for each point because the class conditional densities' maximum
+    //! values are only computed once per feature.
+    //!
+    //! \param[in] label The label of the class of interest.
+    //! \param[in] x The feature values stored feature major, i.e. x[i][j]
+    //! is the i'th feature of the j'th point.
+    //! \param[out] result Filled in with the probability of each point.
+    //! \note \p x size should be equal to the number of features. A feature
+    //! which is missing for every point is indicated by an empty vector.
+    void classProbability(std::size_t label, const TDoubleVecVec& x, TDoubleVec& result) const;
+
     //! Get the probabilities of all the classes for \p x.
     //!
     //! \param[in] x The feature values.
@@ -57,6 +57,46 @@ public:
     //! Lift the overloads of print into scope.
     using CPrior::print;
 
+    //! \brief The log marginal likelihood of a single point with unit weight.
+    //!
+    //! DESCRIPTION:\n
+    //! This computes the terms which don't depend on the point once, so it
+    //! is much cheaper than jointLogMarginalLikelihood for evaluating many
+    //! points against an unchanged prior. The results are identical. It is
+    //! invalidated by any change to the prior it was constructed from.
+    class MATHS_EXPORT CPointLogMarginalLikelihood {
+    public:
+        explicit CPointLogMarginalLikelihood(const CNormalMeanPrecConjugate& prior);
+
+        //! Compute the log marginal likelihood of \p x.
+        maths_t::EFloatingPointErrorStatus operator()(double x, double& result) const;
+
+    private:
+        //! Compute the log marginal likelihood at \p x ignoring the
+        //! integer offset.
+        bool logMarginalLikelihood(double x, double& result) const;
+
+    private:
+        //! True if the prior is for integer data.
+        bool m_Integer;
+        //! True if the prior is non-informative.
+        bool m_NonInformative;
+        //! The prior mean.
+        double m_Mean;
+        //! The prior precision.
+        double m_Precision;
+        //! The prior precision plus one.
+        double m_ImpliedPrecision;
+        //! The prior shape plus one half.
+        double m_ImpliedShape;
+        //! The prior rate.
+        double m_Rate;
+        //! The terms which are independent of the point.
+        double m_Constant;
+        //! The status of the computation of the constant terms.
+        maths_t::EFloatingPointErrorStatus m_ErrorStatus;
+    };
+
 public:
     //! \name Life-Cycle
     //@{
@@ -133,6 +133,9 @@ public:
     //! Get the start of the week.
     core_t::TTime startOfWeek() const;
 
+    //! Get a checksum for this object.
+    uint64_t checksum(uint64_t seed = 0) const;
+
 private:
     //! True if we should test for diurnal periodicity.
     bool m_TestForDiurnal;
@@ -140,6 +140,17 @@ public:
     UNIFORM_SAMPLE(std::ptrdiff_t)
     UNIFORM_SAMPLE(double)
 #undef UNIFORM_SAMPLE
+
+    //! Get \p n uniform samples from [\p a, \p b) using \p rng.
+    //!
+    //! \note This draws the random bits in blocks and converts them
+    //! to doubles in a loop which vectorises, so is much faster than
+    //! the overloads for the other generators when \p n is large.
+    static void uniformSample(CPRNG::CXorOShiro128PlusX4& rng,
+                              double a,
+                              double b,
+                              std::size_t n,
+                              TDoubleVec& result);
     //@}
 
     //! Get a normal sample with mean and variance \p mean and
@@ -174,6 +185,19 @@ public:
                              std::size_t n,
                              TDoubleVec& result);
 
+    //! Get \p n normal samples with mean and variance \p mean and
+    //! \p variance, respectively, using \p rng.
+    //!
+    //! \note This uses a 128 layer ziggurat which reads the random
+    //! bits it needs from blocks filled by \p rng. It is the fastest
+    //! way to generate a large number of normal samples, but produces
+    //! different values to the overloads for the other generators.
+    static void normalSample(CPRNG::CXorOShiro128PlusX4& rng,
+                             double mean,
+                             double variance,
+                             std::size_t n,
+                             TDoubleVec& result);
+
     //! Get \p n samples of a \f$\chi^2\f$ random variable with \p f
     //! degrees of freedom.
     static void chiSquaredSample(double f, std::size_t n, TDoubleVec& result);
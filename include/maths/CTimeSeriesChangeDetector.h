@@ -150,12 +150,31 @@ private:
     //! function as a function of time.
     TRegression m_LogInvDecisionFunctionTrend;
 
+    //! The time series trend model shared by the change models.
+    TDecompositionPtr m_TrendModel;
+
     //! The change models.
     TChangeModelPtr5Vec m_ChangeModels;
 };
 
 namespace time_series_change_detector_detail {
 
+//! \brief The trend model predictions of a collection of samples and
+//! their residuals.
+//!
+//! DESCRIPTION:\n
+//! These are computed once per update by the change detector and shared
+//! by all change models, which describe their change as a delta to the
+//! residual, rather than each model evaluating the trend model itself.
+struct MATHS_EXPORT SBaseline {
+    using TDouble1Vec = core::CSmallVector<double, 1>;
+
+    //! The mean trend model predictions.
+    TDouble1Vec s_Predictions;
+    //! The samples detrended using the trend model.
+    TDouble1Vec s_Residuals;
+};
+
 //! \brief Helper interface for change detection. Implementations of
 //! this are used to model specific types of changes which can occur.
 class MATHS_EXPORT CUnivariateChangeModel : private core::CNonCopyable {
@@ -188,9 +207,11 @@ public:
     //! Get a description of the change.
     virtual TOptionalChangeDescription change() const = 0;
 
-    //! Update the change model with \p samples.
+    //! Update the change model with \p samples whose trend model
+    //! predictions and residuals are \p baseline.
     virtual void addSamples(const std::size_t count,
                             const TTimeDoublePr1Vec& samples,
+                            const SBaseline& baseline,
                             TDoubleWeightsAry1Vec weights) = 0;
 
     //! Debug the memory used by this object.
@@ -270,6 +291,7 @@ public:
     //! Get the log likelihood of \p samples.
     virtual void addSamples(const std::size_t count,
                             const TTimeDoublePr1Vec& samples,
+                            const SBaseline& baseline,
                             TDoubleWeightsAry1Vec weights);
 
     //! Get the static size of this object.
@@ -305,6 +327,7 @@ public:
     //! Update with \p samples.
     virtual void addSamples(const std::size_t count,
                             const TTimeDoublePr1Vec& samples,
+                            const SBaseline& baseline,
                             TDoubleWeightsAry1Vec weights);
 
     //! Get the static size of this object.
@@ -353,6 +376,7 @@ public:
     //! Update with \p samples.
     virtual void addSamples(const std::size_t count,
                             const TTimeDoublePr1Vec& samples,
+                            const SBaseline& baseline,
                             TDoubleWeightsAry1Vec weights);
 
     //! Get the static size of this object.
@@ -402,6 +426,7 @@ public:
     //! Update with \p samples.
     virtual void addSamples(const std::size_t count,
                             const TTimeDoublePr1Vec& samples,
+                            const SBaseline& baseline,
                             TDoubleWeightsAry1Vec weights);
 
     //! Get the static size of this object.
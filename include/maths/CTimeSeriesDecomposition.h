@@ -7,12 +7,18 @@
 #ifndef INCLUDED_ml_maths_CTimeSeriesDecomposition_h
 #define INCLUDED_ml_maths_CTimeSeriesDecomposition_h
 
+#include <core/CSmallVector.h>
+
 #include <maths/CTimeSeriesDecompositionDetail.h>
 #include <maths/CTimeSeriesDecompositionInterface.h>
 #include <maths/Constants.h>
 #include <maths/ImportExport.h>
 
+#include <boost/array.hpp>
+
 #include <memory>
+#include <utility>
+#include <vector>
 
 class CTimeSeriesDecompositionTest;
 
@@ -193,11 +199,96 @@ public:
 
 private:
     using TMediatorPtr = std::shared_ptr<CMediator>;
+    using TSeasonalComponentCPtrDoubleDoublePrPr =
+        std::pair<const CSeasonalComponent*, maths_t::TDoubleDoublePr>;
+    using TSeasonalComponentCPtrDoubleDoublePrPr2Vec =
+        core::CSmallVector<TSeasonalComponentCPtrDoubleDoublePrPr, 2>;
+    using TDoubleDoublePr1Vec = core::CSmallVector<maths_t::TDoubleDoublePr, 1>;
+
+    //! \brief The predictions of all the components at one time.
+    struct MATHS_EXPORT SPredictions {
+        //! Get the memory used by this object.
+        std::size_t memoryUsage() const;
+
+        //! The time, including any shift, of the predictions.
+        core_t::TTime s_Time = 0;
+        //! The confidence interval of the predictions or -1 if unused.
+        double s_Confidence = -1.0;
+        //! True if the trend prediction has been computed.
+        bool s_HasTrend = false;
+        //! The trend prediction.
+        maths_t::TDoubleDoublePr s_Trend;
+        //! The initialized seasonal components which are in window
+        //! and their predictions in component order.
+        TSeasonalComponentCPtrDoubleDoublePrPr2Vec s_Seasonal;
+        //! The predictions of the initialized calendar components
+        //! which are in window in component order.
+        TDoubleDoublePr1Vec s_Calendar;
+    };
+
+    //! \brief A memo of the component predictions at the times most
+    //! recently queried.
+    //!
+    //! DESCRIPTION:\n
+    //! The same series is typically queried many times for the same time
+    //! and confidence in each bucket, for example when sampling, computing
+    //! probabilities and generating model plots. Each query evaluates every
+    //! component's splines and, for confidence intervals, normal quantiles.
+    //! This holds the predictions of all components for a few recent times
+    //! so any combination of components can be summed without recomputing
+    //! them. It must be cleared whenever the components change.
+    //!
+    //! IMPLEMENTATION DECISIONS:\n
+    //! There is one of these for every series which has been queried so
+    //! it is kept small. Two entries suffice for the usual alternation of
+    //! the value and its confidence interval at a bucket's time, and the
+    //! predictions are stored inline for up to two seasonal and one
+    //! calendar component so typical series make no heap allocations.
+    //! Hits and misses are counted in CStatistics.
+    class MATHS_EXPORT CPredictionCache {
+    public:
+        //! The number of times for which predictions are held.
+        static const std::size_t SIZE = 2;
+
+    public:
+        //! Discard all predictions.
+        void clear();
+
+        //! Get the predictions for \p time and \p confidence if there
+        //! are any.
+        SPredictions* find(core_t::TTime time, double confidence);
+
+        //! Get the least recently filled entry to overwrite.
+        SPredictions& next();
+
+        //! Debug the memory used by this object.
+        void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
+
+        //! Get the memory used by this object.
+        std::size_t memoryUsage() const;
+
+    private:
+        using TPredictionsAry = boost::array<SPredictions, SIZE>;
+
+    private:
+        //! The predictions.
+        TPredictionsAry m_Predictions;
+        //! The next entry to overwrite.
+        std::size_t m_Next = 0;
+    };
+    using TPredictionCachePtr = std::unique_ptr<CPredictionCache>;
 
 private:
     //! Set up the communication mediator.
     void initializeMediator();
 
+    //! Get the predictions of all components at \p time, which
+    //! includes any time shift.
+    SPredictions& predictions(core_t::TTime time, double confidence) const;
+
+    //! Discard any memoized predictions.
+    void clearPredictions();
+
     //! Create from part of a state document.
     bool acceptRestoreTraverser(const SDistributionRestoreParams& params,
                                 core::CStateRestoreTraverser& traverser);
@@ -207,9 +298,6 @@ private:
     template<typename F>
     maths_t::TDoubleDoublePr smooth(const F& f, core_t::TTime time, int components) const;
 
-    //! Check if \p component has been selected.
-    bool selected(core_t::TTime time, int components, const CSeasonalComponent& component) const;
-
     //! Check if \p components match \p component.
     bool matches(int components, const CSeasonalComponent& component) const;
 
@@ -240,6 +328,13 @@ private:
 
     //! The state for modeling the components of the decomposition.
     CComponents m_Components;
+
+    //! Set while the components are being updated so predictions
+    //! are always recomputed.
+    bool m_UpdatingComponents;
+
+    //! A memo of recent predictions (this is created on first use).
+    mutable TPredictionCachePtr m_PredictionCache;
 };
 }
 }
@@ -25,6 +25,7 @@
 
 #include <cstddef>
 #include <functional>
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -241,6 +242,42 @@ public:
         using TTimeAry = boost::array<core_t::TTime, 2>;
         using TExpandingWindowPtr = std::unique_ptr<CExpandingWindow>;
         using TExpandingWindowPtrAry = boost::array<TExpandingWindowPtr, 2>;
+        using TExpandingWindowCPtr = std::shared_ptr<const CExpandingWindow>;
+        using TResultFuture = std::shared_future<CPeriodicityHypothesisTestsResult>;
+
+        //! \brief A test which has been handed to the background thread pool.
+        //!
+        //! DESCRIPTION:\n
+        //! This holds everything needed to rerun the test, so it can be
+        //! persisted and resubmitted on restore. It isn't modified once
+        //! it is submitted, so it is shared between copies of the test.
+        struct MATHS_EXPORT SPendingTest {
+            //! Get a checksum for this object.
+            uint64_t checksum(uint64_t seed = 0) const;
+
+            //! Debug the memory used by this object.
+            void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
+
+            //! Get the memory used by this object.
+            std::size_t memoryUsage() const;
+
+            //! The test type.
+            ETest s_Test;
+            //! The test configuration.
+            CPeriodicityHypothesisTestsConfig s_Config;
+            //! The start time of the values.
+            core_t::TTime s_Start;
+            //! The bucket length of the values.
+            core_t::TTime s_BucketLength;
+            //! The window values minus the decomposition's prediction.
+            TFloatMeanAccumulatorVec s_Values;
+            //! A snapshot of the window when the test was scheduled.
+            TExpandingWindowCPtr s_Window;
+            //! The test result.
+            TResultFuture s_Result;
+        };
+        using TPendingTestPtr = std::shared_ptr<SPendingTest>;
+        using TPendingTestPtrVec = std::vector<TPendingTestPtr>;
 
     private:
         //! The bucket lengths to use to test for short period components.
@@ -253,6 +290,20 @@ public:
         //! Handle \p symbol.
         void apply(std::size_t symbol, const SMessage& message);
 
+        //! Forward the results of any tests which were running in the
+        //! background in the order they were scheduled.
+        void applyPendingTests(const SAddValue& message);
+
+        //! Run \p test on the background thread pool.
+        void submit(const TPendingTestPtr& test) const;
+
+        //! Restore a pending test reading state from \p traverser.
+        bool restorePendingTest(core::CStateRestoreTraverser& traverser);
+
+        //! Persist \p test passing information to \p inserter.
+        void persistPendingTest(const SPendingTest& test,
+                                core::CStatePersistInserter& inserter) const;
+
         //! Check if we should run the periodicity test on \p window.
         bool shouldTest(ETest test, core_t::TTime time) const;
 
@@ -275,6 +326,9 @@ public:
 
         //! Expanding windows on the "recent" time series values.
         TExpandingWindowPtrAry m_Windows;
+
+        //! Tests running in the background in the order they were scheduled.
+        TPendingTestPtrVec m_PendingTests;
     };
 
     //! \brief Tests for cyclic calendar components explaining large prediction
@@ -294,6 +294,10 @@ private:
     //! Used to test for changes in the time series.
     TChangeDetectorPtr m_ChangeDetector;
 
+    //! Held while testing for change to limit the number of models
+    //! which test for change at once.
+    CModelParams::TChangeDetectorTokenPtr m_ChangeDetectorToken;
+
     //! A sliding window of the recent samples (used to reinitialize the
     //! residual model when a new trend component is detected).
     TTimeDoublePrCBuf m_SlidingWindow;
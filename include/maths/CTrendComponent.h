@@ -190,6 +190,7 @@ private:
         TDouble3Vec forecast(core_t::TTime time, double prediction, double confidence);
 
     private:
+        using TSizeVec = std::vector<std::size_t>;
         using TTimeVec = std::vector<core_t::TTime>;
 
     private:
@@ -207,6 +208,16 @@ private:
         TDoubleVec m_ProbabilitiesOfChange;
         //! Place holder for sampling.
         TDoubleVec m_Uniform01;
+        //! Place holder for the roll outs' features.
+        TDoubleVecVec m_Features;
+        //! Place holder for the roll outs' probabilities of change.
+        TDoubleVec m_Probabilities;
+        //! Place holder for the roll outs which change level.
+        TSizeVec m_Changes;
+        //! Place holder for the level change steps.
+        TDoubleVec m_Steps;
+        //! Place holder for selecting the forecast quantiles.
+        TDoubleVec m_Quantiles;
     };
 
 private:
@@ -158,6 +158,10 @@ public:
         //! Get the likelihood that \p point is from this cluster.
         double logLikelihoodFromCluster(maths_t::EClusterWeightCalc calc, double point) const;
 
+        //! Check if the cluster is buffering points, in which case it
+        //! can't be split or merged.
+        bool buffering() const;
+
         //! Get \p numberSamples from this cluster.
         void sample(std::size_t numberSamples, double smallest, double largest, TDoubleVec& samples) const;
 
@@ -205,6 +209,10 @@ public:
         //! Get the memory used by this cluster.
         std::size_t memoryUsage() const;
 
+    private:
+        using TOptionalPointLogMarginalLikelihood =
+            boost::optional<CNormalMeanPrecConjugate::CPointLogMarginalLikelihood>;
+
     private:
         CCluster(std::size_t index,
                  const CNormalMeanPrecConjugate& prior,
@@ -219,6 +227,10 @@ public:
 
         //! The data representing the internal structure of this cluster.
         CNaturalBreaksClassifier m_Structure;
+
+        //! The log likelihood of a point for m_Prior, which is created on
+        //! demand and reset whenever m_Prior changes.
+        mutable TOptionalPointLogMarginalLikelihood m_LogLikelihood;
     };
 
     using TClusterVec = std::vector<CCluster>;
@@ -377,6 +389,33 @@ private:
     using TMinAccumulator = CBasicStatistics::COrderStatisticsStack<double, 1>;
     using TMaxAccumulator =
         CBasicStatistics::COrderStatisticsStack<double, 1, std::greater<double>>;
+    using TOptionalDouble = boost::optional<double>;
+    using TOptionalDoubleDoublePr = boost::optional<TDoubleDoublePr>;
+
+    //! \brief The parameters of the split and merge tests.
+    //!
+    //! DESCRIPTION:\n
+    //! These depend on all the clusters, but only change when a point is
+    //! added or a cluster is split or merged. They are computed on demand
+    //! and at most once for all the tests made after adding a point.
+    class CSplitMergeParameters {
+    public:
+        explicit CSplitMergeParameters(const CXMeansOnline1d& clusterer);
+
+        //! Get the Winsorisation interval.
+        const TDoubleDoublePr& winsorisationInterval();
+
+        //! Get the minimum split count.
+        double minimumSplitCount();
+
+    private:
+        //! The clusterer.
+        const CXMeansOnline1d* m_Clusterer;
+        //! The Winsorisation interval.
+        TOptionalDoubleDoublePr m_WinsorisationInterval;
+        //! The minimum split count.
+        TOptionalDouble m_MinimumSplitCount;
+    };
 
 private:
     //! The minimum Kullback-Leibler divergence at which we'll
@@ -410,10 +449,12 @@ private:
     double minimumSplitCount() const;
 
     //! Split \p cluster if we find a good split.
-    bool maybeSplit(TClusterVecItr cluster);
+    bool maybeSplit(TClusterVecItr cluster, CSplitMergeParameters& parameters);
 
     //! Merge \p cluster and \p adjacentCluster if they are close enough.
-    bool maybeMerge(TClusterVecItr cluster, TClusterVecItr adjacentCluster);
+    bool maybeMerge(TClusterVecItr cluster,
+                    TClusterVecItr adjacentCluster,
+                    CSplitMergeParameters& parameters);
 
     //! Remove any clusters which are effectively dead.
     bool prune();
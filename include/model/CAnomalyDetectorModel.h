@@ -17,6 +17,7 @@
 
 #include <model/CMemoryUsageEstimator.h>
 #include <model/CModelParams.h>
+#include <model/CModelSpillStore.h>
 #include <model/CPartitioningFields.h>
 #include <model/ImportExport.h>
 #include <model/ModelTypes.h>
@@ -43,6 +44,7 @@ class CStateRestoreTraverser;
 
 namespace maths {
 class CMultivariatePrior;
+struct SModelRestoreParams;
 }
 
 namespace model {
@@ -377,6 +379,18 @@ public:
     //! sufficiently long period, based on the prior decay rates.
     void prune();
 
+    //! Prune the models of \p people and \p attributes, which must
+    //! be sorted.
+    virtual void prunePeopleAndAttributes(const TSizeVec& people, const TSizeVec& attributes);
+
+    //! Get the start of the last bucket in which the person identified
+    //! by \p pid had data or TIME_UNSET if they aren't active.
+    virtual core_t::TTime personLastBucketTime(std::size_t pid) const;
+
+    //! Get the start of the last bucket in which the attribute identified
+    //! by \p cid had data or TIME_UNSET if it isn't active.
+    virtual core_t::TTime attributeLastBucketTime(std::size_t cid) const;
+
     //! Calculate the maximum permitted prune window for this model
     std::size_t defaultPruneWindow() const;
 
@@ -500,7 +514,25 @@ protected:
     using TFeatureSizeSize1VecUMapPrVec = std::vector<TFeatureSizeSize1VecUMapPr>;
 
     //! \brief The feature models.
+    //!
+    //! DESCRIPTION:\n
+    //! The models of people who haven't had data for some time can be
+    //! hibernated: their state is persisted, compressed and the model
+    //! freed. A hibernating model has a null entry in s_Models and is
+    //! restored by wake. This is transparent to persistence, which
+    //! writes the same state whether or not a model is hibernating.
+    //! If there is a model spill store the compressed state is held
+    //! by it and can be paged out to disk. The handles of this state
+    //! are shared with copies made for persistence so the state stays
+    //! in the store until they have been persisted.
     struct MODEL_EXPORT SFeatureModels {
+        using TByteVec = std::vector<unsigned char>;
+        using TByteVecVec = std::vector<TByteVec>;
+        using TModelRestoreParamsPtr = std::shared_ptr<const maths::SModelRestoreParams>;
+        using TModelSpillStorePtr = std::shared_ptr<CModelSpillStore>;
+        using TSpillHandlePtr = std::shared_ptr<const CModelSpillStore::CHandle>;
+        using TSpillHandlePtrVec = std::vector<TSpillHandlePtr>;
+
         SFeatureModels(model_t::EFeature feature, TMathsModelSPtr newModel);
         SFeatureModels(const SFeatureModels&) = delete;
         SFeatureModels& operator=(const SFeatureModels&) = delete;
@@ -513,6 +545,22 @@ protected:
         //! Persist the models passing state to \p inserter.
         void acceptPersistInserter(core::CStatePersistInserter& inserter) const;
 
+        //! Check if the model of \p pid is hibernating.
+        bool isHibernating(std::size_t pid) const;
+        //! Compress the state of the model of \p pid and free the model.
+        bool hibernate(const SModelParams& params, std::size_t pid);
+        //! Restore the model of \p pid from its compressed state.
+        bool wake(std::size_t pid);
+        //! Discard any compressed state for the model of \p pid.
+        void clearHibernating(std::size_t pid);
+        //! Get the number of hibernating models.
+        std::size_t numberHibernating() const;
+        //! Get the compressed state of the model of \p pid.
+        TByteVec hibernatingState(std::size_t pid) const;
+        //! Get a copy of the model of \p pid restored from its compressed
+        //! state.
+        TMathsModelUPtr restoreHibernating(std::size_t pid) const;
+
         //! Debug the memory used by this model.
         void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
         //! Get the memory used by this model.
@@ -524,6 +572,15 @@ protected:
         TMathsModelSPtr s_NewModel;
         //! The person models.
         TMathsModelUPtrVec s_Models;
+        //! The compressed state of the hibernating person models.
+        TByteVecVec s_HibernatingModels;
+        //! The parameters used to restore the hibernating models.
+        TModelRestoreParamsPtr s_RestoreParams;
+        //! The store which holds the compressed state of the hibernating
+        //! person models, if any.
+        TModelSpillStorePtr s_SpillStore;
+        //! The handles of the compressed state held by the spill store.
+        TSpillHandlePtrVec s_SpilledModels;
     };
     using TFeatureModelsVec = std::vector<SFeatureModels>;
 
@@ -33,6 +33,7 @@ class CInterimBucketCorrector;
 class CSearchKey;
 class CModelAutoConfigurer;
 class CModelFactory;
+class CModelSpillStore;
 
 //! \brief Responsible for configuring anomaly detection models.
 //!
@@ -72,6 +73,7 @@ public:
     using TInterimBucketCorrectorPtr = std::shared_ptr<CInterimBucketCorrector>;
     using TModelFactoryPtr = std::shared_ptr<CModelFactory>;
     using TModelFactoryCPtr = std::shared_ptr<const CModelFactory>;
+    using TModelSpillStorePtr = std::shared_ptr<CModelSpillStore>;
     using TFactoryTypeFactoryPtrMap = std::map<EFactoryType, TModelFactoryPtr>;
     using TFactoryTypeFactoryPtrMapItr = TFactoryTypeFactoryPtrMap::iterator;
     using TFactoryTypeFactoryPtrMapCItr = TFactoryTypeFactoryPtrMap::const_iterator;
@@ -162,6 +164,20 @@ public:
     //! The default maximum time to test for a change point in a time series.
     static const core_t::TTime DEFAULT_MAXIMUM_TIME_TO_TEST_FOR_CHANGE;
 
+    //! The default maximum number of time series of each feature of a
+    //! detector which can test for a change point at any one time. This
+    //! bounds the memory and CPU used when a change affects many series.
+    static const std::size_t DEFAULT_MAXIMUM_NUMBER_ACTIVE_CHANGE_DETECTORS;
+
+    //! The default number of buckets without data after which a person's
+    //! models are hibernated. Hibernation is off by default and is only
+    //! supported by individual, i.e. not "over", models.
+    static const std::size_t DEFAULT_MODEL_HIBERNATION_AGE;
+
+    //! The number of buckets without data after which a person's models
+    //! are hibernated if model state is spilled and no age is configured.
+    static const std::size_t DEFAULT_SPILLED_MODEL_HIBERNATION_AGE;
+
     //! The maximum number of times we'll update a model in a bucketing
     //! interval. This only applies to our metric statistics, which are
     //! computed on a fixed number of measurements rather than a fixed
@@ -283,6 +299,8 @@ public:
     //! Set whether multivariate analysis of correlated 'by' fields should
     //! be performed.
     void multivariateByFields(bool enabled);
+    //! Set the way the info_content functions estimate compressed length.
+    void infoContentEstimator(model_t::EInfoContentEstimator estimator);
     //! Set the model factories.
     void factories(const TFactoryTypeFactoryPtrMap& factories);
     //! Set the style and parameter value for raw score aggregation.
@@ -379,6 +397,9 @@ public:
     //! Should multivariate analysis of correlated 'by' fields be performed?
     bool multivariateByFields() const;
 
+    //! Get the way the info_content functions estimate compressed length.
+    model_t::EInfoContentEstimator infoContentEstimator() const;
+
     //! Set the central confidence interval for the model debug plot
     //! to \p percentage.
     //!
@@ -436,6 +457,10 @@ public:
     //! Sets the reference to the scheduled events vector
     void scheduledEvents(TStrDetectionRulePrVecCRef scheduledEvents);
 
+    //! Set the store to which the state of hibernating models is spilled.
+    //! This enables hibernation if it isn't already enabled.
+    void modelSpillStore(const TModelSpillStorePtr& store);
+
     //! Process the stanza properties corresponding \p stanzaName.
     //!
     //! \param[in] propertyTree The properties of the stanza called
@@ -460,6 +485,9 @@ private:
     //! Should multivariate analysis of correlated 'by' fields be performed?
     bool m_MultivariateByFields;
 
+    //! The way the info_content functions estimate compressed length.
+    model_t::EInfoContentEstimator m_InfoContentEstimator;
+
     //! The single interim bucket correction calculator.
     TInterimBucketCorrectorPtr m_InterimBucketCorrector;
 
@@ -8,6 +8,7 @@
 #define INCLUDED_ml_model_CBucketGatherer_h
 
 #include <core/CCompressedDictionary.h>
+#include <core/CFlatHashMap.h>
 #include <core/CHashing.h>
 #include <core/CLogger.h>
 #include <core/CMemory.h>
@@ -16,12 +17,12 @@
 
 #include <model/CBucketQueue.h>
 #include <model/CEventData.h>
+#include <model/CFeatureData.h>
 #include <model/CModelParams.h>
 #include <model/FunctionTypes.h>
 #include <model/ImportExport.h>
 #include <model/ModelTypes.h>
 
-#include <boost/any.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 #include <boost/unordered_map.hpp>
@@ -76,7 +77,7 @@ public:
     using TWordSizeUMap = TDictionary::CWordUMap<std::size_t>::Type;
     using TWordSizeUMapItr = TWordSizeUMap::iterator;
     using TWordSizeUMapCItr = TWordSizeUMap::const_iterator;
-    using TSizeSizePrUInt64UMap = boost::unordered_map<TSizeSizePr, uint64_t>;
+    using TSizeSizePrUInt64UMap = core::CFlatHashMap<TSizeSizePr, uint64_t>;
     using TSizeSizePrUInt64UMapItr = TSizeSizePrUInt64UMap::iterator;
     using TSizeSizePrUInt64UMapCItr = TSizeSizePrUInt64UMap::const_iterator;
     using TSizeSizePrUInt64UMapQueue = CBucketQueue<TSizeSizePrUInt64UMap>;
@@ -100,7 +101,7 @@ public:
                 static_cast<uint64_t>(key.first.second));
             return core::CHashing::hashCombine(seed, s_Hasher(*key.second));
         }
-        core::CHashing::CMurmurHash2String s_Hasher;
+        core::CHashing::CWyHashString s_Hasher;
     };
 
     //! \brief Checks two ((size_t, size_t), string*) pairs for equality.
@@ -112,7 +113,7 @@ public:
     };
 
     using TSizeSizePrStoredStringPtrPrUInt64UMap =
-        boost::unordered_map<TSizeSizePrStoredStringPtrPr, uint64_t, SSizeSizePrStoredStringPtrPrHash, SSizeSizePrStoredStringPtrPrEqual>;
+        core::CFlatHashMap<TSizeSizePrStoredStringPtrPr, uint64_t, SSizeSizePrStoredStringPtrPrHash, SSizeSizePrStoredStringPtrPrEqual>;
     using TSizeSizePrStoredStringPtrPrUInt64UMapCItr =
         TSizeSizePrStoredStringPtrPrUInt64UMap::const_iterator;
     using TSizeSizePrStoredStringPtrPrUInt64UMapItr =
@@ -126,8 +127,30 @@ public:
     using TTimeSizeSizePrStoredStringPtrPrUInt64UMapVecMap =
         std::map<core_t::TTime, TSizeSizePrStoredStringPtrPrUInt64UMapVec>;
     using TSearchKeyCRef = boost::reference_wrapper<const CSearchKey>;
-    using TFeatureAnyPr = std::pair<model_t::EFeature, boost::any>;
-    using TFeatureAnyPrVec = std::vector<TFeatureAnyPr>;
+    using TSizeEventRateFeatureDataPr = std::pair<std::size_t, SEventRateFeatureData>;
+    using TSizeEventRateFeatureDataPrVec = std::vector<TSizeEventRateFeatureDataPr>;
+    using TFeatureSizeEventRateFeatureDataPrVecPr =
+        std::pair<model_t::EFeature, TSizeEventRateFeatureDataPrVec>;
+    using TFeatureSizeEventRateFeatureDataPrVecPrVec =
+        std::vector<TFeatureSizeEventRateFeatureDataPrVecPr>;
+    using TSizeSizePrEventRateFeatureDataPr = std::pair<TSizeSizePr, SEventRateFeatureData>;
+    using TSizeSizePrEventRateFeatureDataPrVec = std::vector<TSizeSizePrEventRateFeatureDataPr>;
+    using TFeatureSizeSizePrEventRateFeatureDataPrVecPr =
+        std::pair<model_t::EFeature, TSizeSizePrEventRateFeatureDataPrVec>;
+    using TFeatureSizeSizePrEventRateFeatureDataPrVecPrVec =
+        std::vector<TFeatureSizeSizePrEventRateFeatureDataPrVecPr>;
+    using TSizeMetricFeatureDataPr = std::pair<std::size_t, SMetricFeatureData>;
+    using TSizeMetricFeatureDataPrVec = std::vector<TSizeMetricFeatureDataPr>;
+    using TFeatureSizeMetricFeatureDataPrVecPr =
+        std::pair<model_t::EFeature, TSizeMetricFeatureDataPrVec>;
+    using TFeatureSizeMetricFeatureDataPrVecPrVec =
+        std::vector<TFeatureSizeMetricFeatureDataPrVecPr>;
+    using TSizeSizePrMetricFeatureDataPr = std::pair<TSizeSizePr, SMetricFeatureData>;
+    using TSizeSizePrMetricFeatureDataPrVec = std::vector<TSizeSizePrMetricFeatureDataPr>;
+    using TFeatureSizeSizePrMetricFeatureDataPrVecPr =
+        std::pair<model_t::EFeature, TSizeSizePrMetricFeatureDataPrVec>;
+    using TFeatureSizeSizePrMetricFeatureDataPrVecPrVec =
+        std::vector<TFeatureSizeSizePrMetricFeatureDataPrVecPr>;
     using TMetricCategoryVec = std::vector<model_t::EMetricCategory>;
     using TTimeVec = std::vector<core_t::TTime>;
     using TTimeVecCItr = TTimeVec::const_iterator;
@@ -374,14 +397,33 @@ public:
         }
     }
 
+    //! \name Features
+    //@{
     //! Get the raw data for all features for the bucketing time interval
     //! containing \p time.
     //!
+    //! There is one overload per feature data type. Gatherers implement
+    //! the overloads for the data they produce and the default versions
+    //! fail, so the data type is checked statically on the fast path.
+    //!
     //! \param[in] time The time of interest.
-    //! \param[out] result Filled in with the feature data at \p time.
-    virtual void featureData(core_t::TTime time,
+    //! \param[in,out] result Filled in with the feature data at \p time.
+    //! The entries already in \p result are reused, so passing the same
+    //! collection for each bucket avoids reallocating it.
+    //! \return False if this gatherer doesn't produce the requested type.
+    virtual bool featureData(core_t::TTime time,
+                             core_t::TTime bucketLength,
+                             TFeatureSizeEventRateFeatureDataPrVecPrVec& result) const;
+    virtual bool featureData(core_t::TTime time,
                              core_t::TTime bucketLength,
-                             TFeatureAnyPrVec& result) const = 0;
+                             TFeatureSizeSizePrEventRateFeatureDataPrVecPrVec& result) const;
+    virtual bool featureData(core_t::TTime time,
+                             core_t::TTime bucketLength,
+                             TFeatureSizeMetricFeatureDataPrVecPrVec& result) const;
+    virtual bool featureData(core_t::TTime time,
+                             core_t::TTime bucketLength,
+                             TFeatureSizeSizePrMetricFeatureDataPrVecPrVec& result) const;
+    //@}
 
     //! Get a reference to the owning data gatherer.
     const CDataGatherer& dataGatherer() const;
@@ -429,6 +471,28 @@ private:
     //! Roll time forwards to \p time and update depending on \p skipUpdates
     void hiddenTimeNow(core_t::TTime time, bool skipUpdates);
 
+protected:
+    //! Get the feature data entry \p n of \p result for \p feature.
+    //!
+    //! This reuses the storage of any existing entry so extracting the
+    //! features for a bucket doesn't allocate once \p result has grown
+    //! to its working size.
+    //!
+    //! \param[in,out] n The number of entries of \p result in use, which
+    //! is incremented.
+    template<typename T>
+    static T& nextFeatureData(model_t::EFeature feature,
+                              std::size_t& n,
+                              std::vector<std::pair<model_t::EFeature, T>>& result) {
+        if (n == result.size()) {
+            result.emplace_back(feature, T());
+        } else {
+            result[n].first = feature;
+            result[n].second.clear();
+        }
+        return result[n++].second;
+    }
+
 protected:
     //! Reference to the owning data gatherer
     CDataGatherer& m_DataGatherer;
@@ -441,7 +505,7 @@ private:
     core_t::TTime m_BucketStart;
 
     //! The non-zero (person, attribute) pair counts in the current
-    //! bucketing interval.
+    //! bucketing interval. The maps are recycled as buckets roll over.
     TSizeSizePrUInt64UMapQueue m_PersonAttributeCounts;
 
     //! The counts for longer bucketing intervals.
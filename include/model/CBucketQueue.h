@@ -17,6 +17,7 @@
 #include <boost/circular_buffer.hpp>
 
 #include <string>
+#include <utility>
 
 namespace ml {
 namespace model {
@@ -100,6 +101,26 @@ public:
         this->push(item);
     }
 
+    //! Pushes an item to the queue for \p time which reuses the memory
+    //! of the earliest item, which is evicted by the push. The earliest
+    //! item's contents are reset by calling \p reset on it.
+    //!
+    //! \param[in] time The time to which the item corresponds.
+    //! \param[in] reset Clears the item, ideally retaining its memory.
+    template<typename F>
+    void pushRecycled(core_t::TTime time, F reset) {
+        if (time <= m_LatestBucketEnd) {
+            LOG_ERROR(<< "Push was called with early time = " << time
+                      << ", latest bucket end time = " << m_LatestBucketEnd);
+            return;
+        }
+        m_LatestBucketEnd += m_BucketLength;
+        T item{std::move(m_Queue.back())};
+        reset(item);
+        m_Queue.push_front(std::move(item));
+        LOG_TRACE(<< "Queue after push -> " << core::CContainerPrinter::print(*this));
+    }
+
     //! Pushes an item to the queue. This is only intended to be used
     //! internally and from clients that perform restoration of the queue.
     void push(const T& item) {
@@ -21,7 +21,6 @@
 #include <model/ImportExport.h>
 #include <model/ModelTypes.h>
 
-#include <boost/any.hpp>
 #include <boost/optional.hpp>
 #include <boost/unordered_map.hpp>
 
@@ -111,7 +110,7 @@ public:
     using TSizeSizePr = std::pair<std::size_t, std::size_t>;
     using TSizeSizePrUInt64Pr = std::pair<TSizeSizePr, uint64_t>;
     using TSizeSizePrUInt64PrVec = std::vector<TSizeSizePrUInt64Pr>;
-    using TSizeSizePrUInt64UMap = boost::unordered_map<TSizeSizePr, uint64_t>;
+    using TSizeSizePrUInt64UMap = CBucketGatherer::TSizeSizePrUInt64UMap;
     using TSizeSizePrUInt64UMapQueue = CBucketQueue<TSizeSizePrUInt64UMap>;
     using TSizeSizePrStoredStringPtrPrUInt64UMap = CBucketGatherer::TSizeSizePrStoredStringPtrPrUInt64UMap;
     using TSizeSizePrStoredStringPtrPrUInt64UMapVec =
@@ -121,8 +120,6 @@ public:
     using TSearchKeyCRef = boost::reference_wrapper<const CSearchKey>;
     using TBucketGathererPtr = std::unique_ptr<CBucketGatherer>;
     using TBucketGathererPtrVec = std::vector<TBucketGathererPtr>;
-    using TFeatureAnyPr = std::pair<model_t::EFeature, boost::any>;
-    using TFeatureAnyPrVec = std::vector<TFeatureAnyPr>;
     using TMetricCategoryVec = std::vector<model_t::EMetricCategory>;
     using TSampleCountsPtr = std::unique_ptr<CSampleCounts>;
     using TTimeVec = std::vector<core_t::TTime>;
@@ -331,45 +328,15 @@ public:
     //! containing \p time.
     //!
     //! \param[in] time The time of interest.
-    //! \param[out] result Filled in with the feature data at \p time.
+    //! \param[in,out] result Filled in with the feature data at \p time.
+    //! Existing entries are reused, so callers which pass the same
+    //! collection for each bucket avoid reallocating it.
     //! \tparam T The type of the feature data.
     template<typename T>
     bool featureData(core_t::TTime time,
                      core_t::TTime bucketLength,
                      std::vector<std::pair<model_t::EFeature, T>>& result) const {
-        TFeatureAnyPrVec rawFeatureData;
-        this->chooseBucketGatherer(time).featureData(time, bucketLength, rawFeatureData);
-
-        bool succeeded = true;
-
-        result.clear();
-        result.reserve(rawFeatureData.size());
-        for (std::size_t i = 0u; i < rawFeatureData.size(); ++i) {
-            TFeatureAnyPr& feature = rawFeatureData[i];
-
-            // Check the typeid before attempting the cast so we
-            // don't use throw to handle failure, which is slow.
-            if (feature.second.type() != typeid(T)) {
-                LOG_ERROR(<< "Bad type for feature = " << model_t::print(feature.first)
-                          << ", expected " << typeid(T).name() << " got "
-                          << feature.second.type().name());
-                succeeded = false;
-                continue;
-            }
-
-            // We emulate move semantics here to avoid the expensive
-            // copy if T is large (as we expect it might be sometimes).
-            // We have to adopt the using std::swap idiom (contravening
-            // coding guidelines) because T can be a built in type.
-            // Unfortunately, this implementation requires T to be
-            // default constructible.
-            using std::swap;
-            result.push_back(std::pair<model_t::EFeature, T>(feature.first, T()));
-            T& tmp = boost::any_cast<T&>(feature.second);
-            swap(result.back().second, tmp);
-        }
-
-        return succeeded;
+        return this->chooseBucketGatherer(time).featureData(time, bucketLength, result);
     }
     //@}
 
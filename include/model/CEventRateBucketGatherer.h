@@ -12,14 +12,16 @@
 #include <core/CStoredStringPtr.h>
 #include <core/CoreTypes.h>
 
+#include <maths/CBasicStatistics.h>
 #include <maths/CChecksum.h>
+#include <maths/CCompressedLengthSketch.h>
 
 #include <model/CDataGatherer.h>
 #include <model/CFeatureData.h>
 #include <model/ImportExport.h>
 #include <model/ModelTypes.h>
 
-#include <boost/any.hpp>
+#include <boost/optional.hpp>
 #include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
 
@@ -50,16 +52,26 @@ public:
     using TStrCRefDouble1VecDoublePrPr = SEventRateFeatureData::TStrCRefDouble1VecDoublePrPr;
     using TStrCRefDouble1VecDoublePrPrVec = SEventRateFeatureData::TStrCRefDouble1VecDoublePrPrVec;
     using TStoredStringPtrVec = CBucketGatherer::TStoredStringPtrVec;
+    using TSketch = maths::CCompressedLengthSketch;
+    using TOptionalSketch = boost::optional<TSketch>;
+    using TStoredStringPtrSketchUMap = boost::unordered_map<core::CStoredStringPtr, TSketch>;
+    using TStoredStringPtrSketchUMapVec = std::vector<TStoredStringPtrSketchUMap>;
 
 public:
-    //! Add a string into the collection
-    void insert(const std::string& value, const TStoredStringPtrVec& influences);
+    //! Add a string into the collection.
+    //!
+    //! If \p sketch is true this also maintains compressed length sketches
+    //! of the unique strings for the streaming info_content estimator.
+    void insert(const std::string& value, const TStoredStringPtrVec& influences, bool sketch = false);
 
     //! Fill in a FeatureData structure with the influence strings and counts
     void populateDistinctCountFeatureData(SEventRateFeatureData& featureData) const;
 
     //! Fill in a FeatureData structure with the influence info_content
-    void populateInfoContentFeatureData(SEventRateFeatureData& featureData) const;
+    //! computed using \p estimator.
+    void populateInfoContentFeatureData(SEventRateFeatureData& featureData,
+                                        model_t::EInfoContentEstimator estimator =
+                                            model_t::E_InfoContentDeflate) const;
 
     //! Persist state by passing information \p inserter.
     void acceptPersistInserter(core::CStatePersistInserter& inserter) const;
@@ -79,10 +91,26 @@ public:
     //! Print the unique strings for debug.
     std::string print() const;
 
+private:
+    //! Fill in \p featureData using the compressed length sketches.
+    void populateSketchInfoContentFeatureData(SEventRateFeatureData& featureData) const;
+
 private:
     TDictionary1 m_Dictionary1;
     TWordStringUMap m_UniqueStrings;
     TStoredStringPtrWordSetUMapVec m_InfluencerUniqueStrings;
+
+    //! The sketch of the unique strings, if the streaming info_content
+    //! estimator is in use.
+    //!
+    //! \note These aren't persisted: they are a function of the unique
+    //! strings and are recreated if necessary. Each sketch is sized for
+    //! the total length of its strings, so it costs up to twice that in
+    //! bits and at most 512 bytes.
+    TOptionalSketch m_Sketch;
+
+    //! The sketches of the unique strings for each influencer value.
+    TStoredStringPtrSketchUMapVec m_InfluencerSketches;
 };
 
 //! \brief Event rate data gathering class.
@@ -94,7 +122,13 @@ private:
 //! \sa CDataGatherer.
 class MODEL_EXPORT CEventRateBucketGatherer : public CBucketGatherer {
 public:
-    using TCategoryAnyMap = std::map<model_t::EEventRateCategory, boost::any>;
+    using TSizeUSet = boost::unordered_set<std::size_t>;
+    using TSizeUSetVec = std::vector<TSizeUSet>;
+    using TMeanAccumulator = maths::CBasicStatistics::SSampleMean<double>::TAccumulator;
+    using TSizeSizePrMeanAccumulatorUMap = boost::unordered_map<TSizeSizePr, TMeanAccumulator>;
+    using TSizeSizePrMeanAccumulatorUMapQueue = CBucketQueue<TSizeSizePrMeanAccumulatorUMap>;
+    using TSizeSizePrStrDataUMap = boost::unordered_map<TSizeSizePr, CUniqueStringFeatureData>;
+    using TSizeSizePrStrDataUMapQueue = CBucketQueue<TSizeSizePrStrDataUMap>;
     using TStrCRef = SEventRateFeatureData::TStrCRef;
     using TDouble1Vec = SEventRateFeatureData::TDouble1Vec;
     using TDouble1VecDoublePr = SEventRateFeatureData::TDouble1VecDoublePr;
@@ -106,6 +140,26 @@ public:
     using TSizeSizePrFeatureDataPr = std::pair<TSizeSizePr, SEventRateFeatureData>;
     using TSizeSizePrFeatureDataPrVec = std::vector<TSizeSizePrFeatureDataPr>;
 
+    //! \brief The state gathered for the features which need more than
+    //! the (person, attribute) bucket counts.
+    //!
+    //! Each member is only initialized if one of the features being
+    //! gathered uses it.
+    struct MODEL_EXPORT SCategoryData {
+        //! Get the memory used by this object in a tree structure.
+        void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
+
+        //! Get the memory used by this object.
+        std::size_t memoryUsage() const;
+
+        //! The distinct people who have hit each attribute.
+        boost::optional<TSizeUSetVec> s_AttributePeople;
+        //! The unique string values by (person, attribute) and bucket.
+        boost::optional<TSizeSizePrStrDataUMapQueue> s_UniqueValues;
+        //! The mean time of day or week by (person, attribute) and bucket.
+        boost::optional<TSizeSizePrMeanAccumulatorUMapQueue> s_DiurnalTimes;
+    };
+
 public:
     //! \name Life-cycle
     //@{
@@ -264,152 +318,146 @@ public:
 
     //! \name Features
     //@{
-    //! Get the raw data for all features for the bucketing time interval
-    //! containing \p time.
+    using CBucketGatherer::featureData;
+
+    //! Get the raw data for all individual features for the bucketing
+    //! time interval containing \p time.
+    //!
+    //! \param[in] time The time of interest.
+    //! \param[in,out] result Filled in with the feature data at \p time.
+    //! Existing entries are reused.
+    virtual bool featureData(core_t::TTime time,
+                             core_t::TTime bucketLength,
+                             TFeatureSizeEventRateFeatureDataPrVecPrVec& result) const;
+
+    //! Get the raw data for all population features for the bucketing
+    //! time interval containing \p time.
     //!
     //! \param[in] time The time of interest.
-    //! \param[out] result Filled in with the feature data at \p time.
-    virtual void featureData(core_t::TTime time,
+    //! \param[in,out] result Filled in with the feature data at \p time.
+    //! Existing entries are reused.
+    virtual bool featureData(core_t::TTime time,
                              core_t::TTime bucketLength,
-                             TFeatureAnyPrVec& result) const;
+                             TFeatureSizeSizePrEventRateFeatureDataPrVecPrVec& result) const;
     //@}
 
 private:
     //! No-op.
     virtual void sample(core_t::TTime time);
 
-    //! Append the counts by person for the bucketing interval containing
+    //! Get the counts by (person, attribute) for the bucketing interval
+    //! containing \p time sorted by (person, attribute).
+    //!
+    //! This is computed once per call to featureData and shared by all
+    //! the count features.
+    const TSizeSizePrUInt64PrVec& sortedBucketCounts(core_t::TTime time) const;
+
+    //! Fill in the counts by person for the bucketing interval containing
     //! \p time.
     //!
     //! \param[in] time The time of interest.
-    //! \param[in,out] result Append (person identifier, count) for each
-    //! person. The collection is sorted by person.
-    void personCounts(model_t::EFeature feature, core_t::TTime time, TFeatureAnyPrVec& result) const;
+    //! \param[out] result Filled in with (person identifier, count) for
+    //! each person. The collection is sorted by person.
+    void personCounts(core_t::TTime time, TSizeFeatureDataPrVec& result) const;
 
-    //! Append the non-zero counts by person for bucketing interval
+    //! Fill in the non-zero counts by person for bucketing interval
     //! containing \p time.
     //!
     //! \param[in] time The time of interest.
-    //! \param[in,out] result Append (person identifier, count) for each
-    //! person present in the bucketing interval containing \p time. The
-    //! collection is sorted by person.
-    void nonZeroPersonCounts(model_t::EFeature feature,
-                             core_t::TTime time,
-                             TFeatureAnyPrVec& result) const;
+    //! \param[out] result Filled in with (person identifier, count) for
+    //! each person present in the bucketing interval containing \p time.
+    //! The collection is sorted by person.
+    void nonZeroPersonCounts(core_t::TTime time, TSizeFeatureDataPrVec& result) const;
 
-    //! Append an indicator function for people present in the bucketing
+    //! Fill in an indicator function for people present in the bucketing
     //! interval containing \p time.
     //!
     //! \param[in] time The time of interest.
-    //! \param[in,out] result Append (person identifier, 1) for each person
-    //! present in the bucketing interval containing \p time. The collection
-    //! is sorted by person identifier.
-    void personIndicator(model_t::EFeature feature, core_t::TTime time, TFeatureAnyPrVec& result) const;
+    //! \param[out] result Filled in with (person identifier, 1) for each
+    //! person present in the bucketing interval containing \p time. The
+    //! collection is sorted by person identifier.
+    void personIndicator(core_t::TTime time, TSizeFeatureDataPrVec& result) const;
 
-    //! Append the mean arrival times for people present in the current
-    //! bucketing interval.
-    //!
-    //! \param[in] time The time of interest.
-    //! \param[in,out] result Append (person identifier, mean arrival time)
-    //! for each person present in the bucketing interval containing \p time.
-    //! The collection is sorted by person identifier.
-    void personArrivalTimes(model_t::EFeature feature,
-                            core_t::TTime time,
-                            TFeatureAnyPrVec& result) const;
-
-    //! Append the non-zero counts for each attribute by person for the
+    //! Fill in the non-zero counts for each attribute by person for the
     //! bucketing interval containing \p time.
     //!
     //! \param[in] time The time of interest.
-    //! \param[in,out] result Append the non-zero attribute counts by
+    //! \param[out] result Filled in with the non-zero attribute counts by
     //! person. The first element of the key is person and the second
     //! attribute. The collection is sorted lexicographically by key.
     //! \note We expect the pairs present to be sparse on the full outer
     //! product space of attribute and person so use a sparse encoding.
-    void nonZeroAttributeCounts(model_t::EFeature feature,
-                                core_t::TTime time,
-                                TFeatureAnyPrVec& result) const;
+    void nonZeroAttributeCounts(core_t::TTime time, TSizeSizePrFeatureDataPrVec& result) const;
 
-    //! Append the number of unique people hitting each attribute.
+    //! Fill in the number of unique people hitting each attribute.
     //!
-    //! \param[in,out] result Append the count of people per attribute.
-    //! The person identifier is dummied to zero so that the result
-    //! type matches other population features.
-    void peoplePerAttribute(model_t::EFeature feature, TFeatureAnyPrVec& result) const;
+    //! \param[out] result Filled in with the count of people per attribute.
+    //! The person identifier is dummied to zero so that the result type
+    //! matches other population features.
+    void peoplePerAttribute(TSizeSizePrFeatureDataPrVec& result) const;
 
-    //! Append an indicator function for (person, attribute) pairs
+    //! Fill in an indicator function for (person, attribute) pairs
     //! present in the bucketing interval containing \p time.
     //!
     //! \param[in] time The time of interest.
-    //! \param[in,out] result Append one for each (person, attribute)
+    //! \param[out] result Filled in with one for each (person, attribute)
     //! pair present in the bucketing interval containing \p time. The
     //! first element of the key is person and the second attribute. The
     //! collection is sorted lexicographically by key.
     //! \note We expect the pairs present to be sparse on the full outer
     //! product space of attribute and person so use a sparse encoding.
-    void attributeIndicator(model_t::EFeature feature,
-                            core_t::TTime time,
-                            TFeatureAnyPrVec& result) const;
+    void attributeIndicator(core_t::TTime time, TSizeSizePrFeatureDataPrVec& result) const;
 
-    //! Append the number of unique values for each person
-    //! in the bucketing interval containing \p time.
+    //! Fill in the number of unique values for each person in the
+    //! bucketing interval containing \p time.
     //!
     //! \param[in] time The time of interest.
     //! \param[out] result Filled in with the unique value counts
     //! by person
-    void bucketUniqueValuesPerPerson(model_t::EFeature feature,
-                                     core_t::TTime time,
-                                     TFeatureAnyPrVec& result) const;
+    void bucketUniqueValuesPerPerson(core_t::TTime time, TSizeFeatureDataPrVec& result) const;
 
-    //! Append the number of unique values for each person and attribute
+    //! Fill in the number of unique values for each person and attribute
     //! in the bucketing interval containing \p time.
     //!
     //! \param[in] time The time of interest.
     //! \param[out] result Filled in with the unique value counts
     //! by person and attribute
-    void bucketUniqueValuesPerPersonAttribute(model_t::EFeature feature,
-                                              core_t::TTime time,
-                                              TFeatureAnyPrVec& result) const;
+    void bucketUniqueValuesPerPersonAttribute(core_t::TTime time,
+                                              TSizeSizePrFeatureDataPrVec& result) const;
 
-    //! Append the compressed length of the unique attributes each person
+    //! Fill in the compressed length of the unique attributes each person
     //! hits in the bucketing interval containing \p time.
     //!
     //! \param[in] time The time of interest.
     //! \param[out] result Filled in with the compressed length of the
     //! unique values by person and attribute
-    void bucketCompressedLengthPerPerson(model_t::EFeature feature,
-                                         core_t::TTime time,
-                                         TFeatureAnyPrVec& result) const;
+    void bucketCompressedLengthPerPerson(core_t::TTime time, TSizeFeatureDataPrVec& result) const;
 
-    //! Append the compressed length of the unique attributes each person
+    //! Fill in the compressed length of the unique attributes each person
     //! hits in the bucketing interval containing \p time.
     //!
     //! \param[in] time The time of interest.
     //! \param[out] result Filled in with the compressed length of the
     //! unique values by person and attribute
-    void bucketCompressedLengthPerPersonAttribute(model_t::EFeature feature,
-                                                  core_t::TTime time,
-                                                  TFeatureAnyPrVec& result) const;
+    void bucketCompressedLengthPerPersonAttribute(core_t::TTime time,
+                                                  TSizeSizePrFeatureDataPrVec& result) const;
 
-    //! Append the time-of-day/week values for each person in the
+    //! Fill in the time-of-day/week values for each person in the
     //! bucketing interval \p time.
     //!
     //! \param[in] time The time of interest.
     //! \param[out] result Filled in with the arrival time values
     //! by person.
-    void bucketMeanTimesPerPerson(model_t::EFeature feature,
-                                  core_t::TTime time,
-                                  TFeatureAnyPrVec& result) const;
+    void bucketMeanTimesPerPerson(core_t::TTime time, TSizeFeatureDataPrVec& result) const;
 
-    //! Append the time-of-day/week values of each attribute and person
+    //! Fill in the time-of-day/week values of each attribute and person
     //! in the bucketing interval \p time.
     //!
     //! \param[in] time The time of interest.
     //! \param[out] result Filled in with the arrival time values
     //! by attribute and person
-    void bucketMeanTimesPerPersonAttribute(model_t::EFeature feature,
-                                           core_t::TTime time,
-                                           TFeatureAnyPrVec& result) const;
+    void bucketMeanTimesPerPersonAttribute(core_t::TTime time,
+                                           TSizeSizePrFeatureDataPrVec& result) const;
 
     //! Resize the necessary data structures so they can accommodate
     //! the person and attribute identified by \p pid and \p cid,
@@ -491,7 +539,19 @@ private:
     std::size_t m_BeginSummaryFields;
 
     //! The data features we are gathering.
-    TCategoryAnyMap m_FeatureData;
+    SCategoryData m_FeatureData;
+
+    //! True if we maintain compressed length sketches of the unique strings
+    //! for the streaming info_content estimator.
+    bool m_SketchInfoContent;
+
+    //! A buffer for the sorted bucket counts which is reused between
+    //! buckets to avoid reallocating it.
+    mutable TSizeSizePrUInt64PrVec m_SortedBucketCounts;
+
+    //! True if m_SortedBucketCounts holds the counts for the bucket
+    //! currently being extracted.
+    mutable bool m_SortedBucketCountsValid;
 };
 }
 }
@@ -245,6 +245,9 @@ public:
     //! prior decay rates and the number of batches into which we
     //! are partitioning time.
     virtual void prune(std::size_t maximumAge);
+
+    //! Prune the data for \p people and \p attributes.
+    virtual void prunePeopleAndAttributes(const TSizeVec& people, const TSizeVec& attributes);
     //@}
 
     //! \name Probability
@@ -154,6 +154,10 @@ struct MODEL_EXPORT SNode {
     //! Efficient swap
     void swap(SNode& other);
 
+    //! Reset to the state of a default constructed node, but keep the
+    //! memory of the children and influences for reuse.
+    void clear();
+
     //! Persist the node state by passing information to \p inserter.
     void acceptPersistInserter1(core::CStatePersistInserter& inserter,
                                 TNodePtrSizeUMap& nodePointers) const;
@@ -219,6 +223,70 @@ struct MODEL_EXPORT SNode {
 MODEL_EXPORT
 void swap(SNode& node1, SNode& node2);
 
+//! \brief Storage for nodes whose memory is reused rather than freed.
+//!
+//! DESCRIPTION:\n
+//! This behaves like a deque of nodes which only supports adding nodes,
+//! removing nodes from the end and clearing. Removed nodes are reset,
+//! keeping the memory of their containers, and are reused by the next
+//! nodes added. So once the results have been built for a few buckets
+//! building them again doesn't need to allocate the nodes. References
+//! to nodes are stable until they are removed.
+class MODEL_EXPORT CNodeStore {
+public:
+    using TNodeDeque = std::deque<SNode>;
+    using iterator = TNodeDeque::iterator;
+    using const_iterator = TNodeDeque::const_iterator;
+    using const_reverse_iterator = TNodeDeque::const_reverse_iterator;
+
+public:
+    CNodeStore();
+
+    //! \name Iterators
+    //@{
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+    //@}
+
+    //! Check if there are no nodes.
+    bool empty() const;
+
+    //! Get the number of nodes.
+    std::size_t size() const;
+
+    //! Get the number of nodes which have been allocated.
+    std::size_t capacity() const;
+
+    //! Get the \p i'th node.
+    SNode& operator[](std::size_t i);
+
+    //! Get the first node.
+    const SNode& front() const;
+
+    //! Get the last node.
+    const SNode& back() const;
+
+    //! Add a default node.
+    SNode& add();
+
+    //! Remove the nodes from \p first to the end.
+    void erase(iterator first);
+
+    //! Remove all the nodes.
+    void clear();
+
+private:
+    //! The nodes, including those which have been removed.
+    TNodeDeque m_Nodes;
+
+    //! The number of nodes which haven't been removed.
+    std::size_t m_Size;
+};
+
 } // hierarchical_results_detail::
 
 class CHierarchicalResultsVisitor;
@@ -264,11 +332,12 @@ public:
     using TNode = hierarchical_results_detail::SNode;
     using TNodePtrSizeUMap = hierarchical_results_detail::SNode::TNodePtrSizeUMap;
     using TSizeNodePtrUMap = hierarchical_results_detail::SNode::TSizeNodePtrUMap;
-    using TNodeDeque = std::deque<TNode>;
-    using TStoredStringPtrStoredStringPtrPrNodeMap =
-        std::map<TStoredStringPtrStoredStringPtrPr, TNode, maths::COrderings::SLexicographicalCompare>;
-    using TStoredStringPtrNodeMap =
-        std::map<TStoredStringPtr, TNode, maths::COrderings::SLess>;
+    using TNodeStore = hierarchical_results_detail::CNodeStore;
+    using TNodePtr = TNode*;
+    using TStoredStringPtrStoredStringPtrPrNodePtrMap =
+        std::map<TStoredStringPtrStoredStringPtrPr, TNodePtr, maths::COrderings::SLexicographicalCompare>;
+    using TStoredStringPtrNodePtrMap =
+        std::map<TStoredStringPtr, TNodePtr, maths::COrderings::SLess>;
 
 public:
     CHierarchicalResults();
@@ -378,6 +447,10 @@ public:
     //! Sets the result to be interm
     void setInterim();
 
+    //! Remove all the results, keeping the memory of the nodes so it
+    //! can be reused by the next bucket's results.
+    void clear();
+
     //! Get type of result
     model_t::CResultType resultType() const;
 
@@ -408,18 +481,23 @@ private:
 
 private:
     //! Storage for the nodes.
-    TNodeDeque m_Nodes;
+    TNodeStore m_Nodes;
 
-    //! Storage for the pivot nodes.
-    TStoredStringPtrStoredStringPtrPrNodeMap m_PivotNodes;
+    //! Storage for the pivot and pivot root nodes.
+    TNodeStore m_PivotNodeStore;
 
-    //! Pivot root nodes.
-    TStoredStringPtrNodeMap m_PivotRootNodes;
+    //! The pivot nodes.
+    TStoredStringPtrStoredStringPtrPrNodePtrMap m_PivotNodes;
+
+    //! The pivot root nodes.
+    TStoredStringPtrNodePtrMap m_PivotRootNodes;
 
     //! Is the result final or interim?
     //! This field is transient - does not get persisted because interim results
     //! never get persisted.
     model_t::CResultType m_ResultType;
+
+    friend class ::CHierarchicalResultsTest;
 };
 
 //! \brief Interface for visiting the results.
@@ -8,12 +8,20 @@
 #define INCLUDED_ml_model_CHierarchicalResultsLevelSet_h
 
 #include <core/CCompressedDictionary.h>
+#include <core/CFlatHashMap.h>
+#include <core/CStoredStringPtr.h>
 
 #include <maths/CChecksum.h>
 #include <maths/COrderings.h>
 
 #include <model/CHierarchicalResults.h>
 
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
 #include <stdint.h>
 
 namespace ml {
@@ -38,6 +46,19 @@ namespace model {
 //! a make function return T by value and taking the strings identifying
 //! the level. T must have a clear function and propagateForwardByTime
 //! functions.
+//!
+//! The sets are sorted by the hash of the strings identifying each element,
+//! which is also what is persisted. Computing this for every node every
+//! bucket means concatenating and hashing strings, so the position of each
+//! element is also cached against the addresses of the node's strings. The
+//! node's strings come from the string store, so equal addresses imply equal
+//! strings while the string is alive. The cache holds weak references to the
+//! strings, so it doesn't stop the string store pruning them, and a string
+//! whose address is reused gets a new identifier. The cache is keyed by small
+//! integer identifiers for the strings in flat hash maps and age drops the
+//! entries for strings which have been freed. A cached position is checked
+//! against the element's hash before it is used, so the sets can be modified
+//! without invalidating it.
 template<typename T>
 class CHierarchicalResultsLevelSet : public CHierarchicalResultsVisitor {
 protected:
@@ -50,6 +71,31 @@ protected:
     using TWordTypePrVecItr = typename TWordTypePrVec::iterator;
     using TWordTypePrVecCItr = typename TWordTypePrVec::const_iterator;
 
+private:
+    using TUInt32Vec = std::vector<uint32_t>;
+
+    //! \brief The identifier of a string and a weak reference used to
+    //! check the string hasn't been freed.
+    struct SId {
+        uint32_t s_Id = 0;
+        core::CStoredStringPtr::CWeakPtr s_String;
+    };
+    using TStrCPtrIdUMap = core::CFlatHashMap<const std::string*, SId>;
+
+    //! The identifiers of the strings which identify an element.
+    using TUInt32Array = std::array<uint32_t, 5>;
+
+    //! \brief Hashes string identifiers.
+    struct SUInt32ArrayHash {
+        std::size_t operator()(const TUInt32Array& ids) const {
+            return boost::hash_range(ids.begin(), ids.end());
+        }
+    };
+
+    using TWordSizePr = std::pair<TWord, std::size_t>;
+    using TUInt32ArrayWordSizePrUMap =
+        core::CFlatHashMap<TUInt32Array, TWordSizePr, SUInt32ArrayHash>;
+
 protected:
     explicit CHierarchicalResultsLevelSet(const T& bucketElement)
         : m_BucketElement(bucketElement) {}
@@ -138,6 +184,13 @@ protected:
         m_PartitionSet.clear();
         m_PersonSet.clear();
         m_LeafSet.clear();
+        m_Ids.clear();
+        m_ExpiredIds.clear();
+        m_InfluencerBucketPositions.clear();
+        m_InfluencerPositions.clear();
+        m_PartitionPositions.clear();
+        m_PersonPositions.clear();
+        m_LeafPositions.clear();
     }
 
     //! Sort all the sets.
@@ -150,6 +203,9 @@ protected:
     }
 
     //! Age the level set elements.
+    //!
+    //! This also drops the cached positions of elements identified by
+    //! strings which have been freed.
     template<typename F>
     void age(F doAge) {
         doAge(m_BucketElement);
@@ -158,6 +214,7 @@ protected:
         age(m_PartitionSet, doAge);
         age(m_PersonSet, doAge);
         age(m_LeafSet, doAge);
+        this->pruneIds();
     }
 
     //! Get and possibly add a normalizer for \p node.
@@ -172,62 +229,65 @@ protected:
             return;
         }
 
+        const auto& spec = node.s_Spec;
+
         if (pivot && this->isRoot(node)) {
-            TWord word = ms_Dictionary.word(*node.s_Spec.s_PersonFieldName);
-            TWordTypePrVecItr i = element(m_InfluencerBucketSet, word);
-            if (i == m_InfluencerBucketSet.end() || i->first != word) {
-                i = m_InfluencerBucketSet.insert(
-                    i, TWordTypePr(word, factory.make(*node.s_Spec.s_PersonFieldName)));
-            }
-            result.push_back(&i->second);
+            result.push_back(&element(
+                m_InfluencerBucketSet, m_InfluencerBucketPositions,
+                {{this->id(spec.s_PersonFieldName), 0, 0, 0, 0}},
+                [&spec]() { return ms_Dictionary.word(*spec.s_PersonFieldName); },
+                [&]() { return factory.make(*spec.s_PersonFieldName); }));
             return;
         }
         if (pivot && !this->isRoot(node)) {
-            TWord word = ms_Dictionary.word(*node.s_Spec.s_PersonFieldName);
-            TWordTypePrVecItr i = element(m_InfluencerSet, word);
-            if (i == m_InfluencerSet.end() || i->first != word) {
-                i = m_InfluencerSet.insert(
-                    i, TWordTypePr(word, factory.make(*node.s_Spec.s_PersonFieldName)));
-            }
-            result.push_back(&i->second);
+            result.push_back(&element(
+                m_InfluencerSet, m_InfluencerPositions,
+                {{this->id(spec.s_PersonFieldName), 0, 0, 0, 0}},
+                [&spec]() { return ms_Dictionary.word(*spec.s_PersonFieldName); },
+                [&]() { return factory.make(*spec.s_PersonFieldName); }));
             return;
         }
 
-        std::string partitionKey = distinctLeavesPerPartition
-                                       ? *node.s_Spec.s_PartitionFieldName +
-                                             *node.s_Spec.s_PartitionFieldValue
-                                       : *node.s_Spec.s_PartitionFieldName;
+        // The partition key is only needed if the element isn't cached.
+        auto partitionKey = [&spec, distinctLeavesPerPartition]() {
+            return distinctLeavesPerPartition
+                       ? *spec.s_PartitionFieldName + *spec.s_PartitionFieldValue
+                       : *spec.s_PartitionFieldName;
+        };
+        uint32_t partitionName{this->id(spec.s_PartitionFieldName)};
+        uint32_t partitionValue{
+            distinctLeavesPerPartition ? this->id(spec.s_PartitionFieldValue) : 0};
 
         if (this->isLeaf(node)) {
-            TWord word = ms_Dictionary.word(partitionKey, *node.s_Spec.s_PersonFieldName,
-                                            *node.s_Spec.s_FunctionName,
-                                            *node.s_Spec.s_ValueFieldName);
-            TWordTypePrVecItr i = element(m_LeafSet, word);
-            if (i == m_LeafSet.end() || i->first != word) {
-                i = m_LeafSet.insert(
-                    i, TWordTypePr(word, factory.make(partitionKey, *node.s_Spec.s_PersonFieldName,
-                                                      *node.s_Spec.s_FunctionName,
-                                                      *node.s_Spec.s_ValueFieldName)));
-            }
-            result.push_back(&i->second);
+            result.push_back(&element(
+                m_LeafSet, m_LeafPositions,
+                {{partitionName, partitionValue, this->id(spec.s_PersonFieldName),
+                  this->id(spec.s_FunctionName), this->id(spec.s_ValueFieldName)}},
+                [&]() {
+                    return ms_Dictionary.word(partitionKey(), *spec.s_PersonFieldName,
+                                              *spec.s_FunctionName,
+                                              *spec.s_ValueFieldName);
+                },
+                [&]() {
+                    return factory.make(partitionKey(), *spec.s_PersonFieldName,
+                                        *spec.s_FunctionName, *spec.s_ValueFieldName);
+                }));
         }
         if (this->isPerson(node)) {
-            TWord word = ms_Dictionary.word(partitionKey, *node.s_Spec.s_PersonFieldName);
-            TWordTypePrVecItr i = element(m_PersonSet, word);
-            if (i == m_PersonSet.end() || i->first != word) {
-                i = m_PersonSet.insert(
-                    i, TWordTypePr(word, factory.make(partitionKey, *node.s_Spec.s_PersonFieldName)));
-            }
-            result.push_back(&i->second);
+            result.push_back(&element(
+                m_PersonSet, m_PersonPositions,
+                {{partitionName, partitionValue, this->id(spec.s_PersonFieldName), 0, 0}},
+                [&]() {
+                    return ms_Dictionary.word(partitionKey(), *spec.s_PersonFieldName);
+                },
+                [&]() { return factory.make(partitionKey(), *spec.s_PersonFieldName); }));
         }
         if (this->isPartition(node)) {
-            TWord word = ms_Dictionary.word(partitionKey);
-
-            TWordTypePrVecItr i = element(m_PartitionSet, word);
-            if (i == m_PartitionSet.end() || i->first != word) {
-                i = m_PartitionSet.insert(i, TWordTypePr(word, factory.make(partitionKey)));
-            }
-            result.push_back(&i->second);
+            result.push_back(&element(
+                m_PartitionSet, m_PartitionPositions,
+                {{partitionName, partitionValue, 0, 0, 0}},
+                [&]() { return ms_Dictionary.word(partitionKey()); },
+                [&]() { return factory.make(partitionKey()); }));
         }
         if (this->isRoot(node)) {
             result.push_back(&m_BucketElement);
@@ -265,6 +325,102 @@ private:
                                 maths::COrderings::SFirstLess());
     }
 
+    //! Get the element of \p set identified by \p ids, adding it if
+    //! necessary.
+    //!
+    //! \param[in] word Computes the key of the element in \p set.
+    //! \param[in] make Makes the element if it is missing.
+    template<typename WORD, typename MAKE>
+    static T& element(TWordTypePrVec& set,
+                      TUInt32ArrayWordSizePrUMap& positions,
+                      const TUInt32Array& ids,
+                      WORD word,
+                      MAKE make) {
+        auto position = positions.find(ids);
+        if (position != positions.end()) {
+            const TWordSizePr& cached = position->second;
+            if (cached.second < set.size() && set[cached.second].first == cached.first) {
+                return set[cached.second].second;
+            }
+        }
+        TWord word_ = word();
+        TWordTypePrVecItr i = element(set, word_);
+        if (i == set.end() || i->first != word_) {
+            i = set.insert(i, TWordTypePr(word_, make()));
+        }
+        positions[ids] = TWordSizePr(word_, static_cast<std::size_t>(i - set.begin()));
+        return i->second;
+    }
+
+    //! Get the identifier of the string \p name.
+    uint32_t id(const core::CStoredStringPtr& name) {
+        if (name == nullptr) {
+            return 0;
+        }
+        SId& id = m_Ids[name.get()];
+        if (id.s_Id == 0 || id.s_String.expired()) {
+            // This is either a new string or the string this address used
+            // to identify has been freed and the address reused.
+            if (id.s_Id != 0) {
+                m_ExpiredIds.push_back(id.s_Id);
+            }
+            id.s_Id = ++m_LastId;
+            id.s_String = core::CStoredStringPtr::CWeakPtr(name);
+        }
+        return id.s_Id;
+    }
+
+    //! Drop the identifiers of strings which have been freed and the
+    //! cached positions which use them.
+    void pruneIds() {
+        for (auto i = m_Ids.begin(); i != m_Ids.end(); /**/) {
+            if (i->second.s_String.expired()) {
+                m_ExpiredIds.push_back(i->second.s_Id);
+                i = m_Ids.erase(i);
+            } else {
+                ++i;
+            }
+        }
+        if (m_ExpiredIds.empty()) {
+            return;
+        }
+        std::sort(m_ExpiredIds.begin(), m_ExpiredIds.end());
+        compact(m_Ids);
+        pruneIds(m_ExpiredIds, m_InfluencerBucketPositions);
+        pruneIds(m_ExpiredIds, m_InfluencerPositions);
+        pruneIds(m_ExpiredIds, m_PartitionPositions);
+        pruneIds(m_ExpiredIds, m_PersonPositions);
+        pruneIds(m_ExpiredIds, m_LeafPositions);
+        m_ExpiredIds.clear();
+    }
+
+    //! Erase the entries of \p positions which use any of the sorted
+    //! identifiers \p expired.
+    static void pruneIds(const TUInt32Vec& expired, TUInt32ArrayWordSizePrUMap& positions) {
+        for (auto i = positions.begin(); i != positions.end(); /**/) {
+            if (std::any_of(i->first.begin(), i->first.end(), [&expired](uint32_t id) {
+                    return id != 0 &&
+                           std::binary_search(expired.begin(), expired.end(), id);
+                })) {
+                i = positions.erase(i);
+            } else {
+                ++i;
+            }
+        }
+        compact(positions);
+    }
+
+    //! Release the memory of \p map if it is much larger than its size
+    //! requires.
+    template<typename MAP>
+    static void compact(MAP& map) {
+        if (8 * map.size() < map.capacity()) {
+            MAP compacted(map.size());
+            compacted.insert(map.begin(), map.end());
+            map.swap(compacted);
+        }
+    }
+
     //! Sort \p set on its key.
     static void sort(TWordTypePrVec& set) {
         std::sort(set.begin(), set.end(), maths::COrderings::SFirstLess());
@@ -303,6 +459,27 @@ private:
     //! The container for leaves comprising distinct named
     //! (partition, person) field name pairs.
     TWordTypePrVec m_LeafSet;
+
+    //! The identifiers of the strings which have been seen.
+    TStrCPtrIdUMap m_Ids;
+
+    //! The last identifier assigned to a string.
+    uint32_t m_LastId = 0;
+
+    //! The identifiers of strings which have been freed since the cached
+    //! positions were last pruned.
+    TUInt32Vec m_ExpiredIds;
+
+    //! \name Cached Positions
+    //! The hash and position of the elements of each set keyed by the
+    //! identifiers of the strings which identify them.
+    //@{
+    TUInt32ArrayWordSizePrUMap m_InfluencerBucketPositions;
+    TUInt32ArrayWordSizePrUMap m_InfluencerPositions;
+    TUInt32ArrayWordSizePrUMap m_PartitionPositions;
+    TUInt32ArrayWordSizePrUMap m_PersonPositions;
+    TUInt32ArrayWordSizePrUMap m_LeafPositions;
+    //@}
 };
 
 template<typename T>
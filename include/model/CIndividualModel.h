@@ -136,6 +136,12 @@ public:
     //! Prune any person models which haven't been updated for a
     //! specified period.
     virtual void prune(std::size_t maximumAge);
+
+    //! Prune the models of \p people.
+    virtual void prunePeopleAndAttributes(const TSizeVec& people, const TSizeVec& attributes);
+
+    //! Get the start of the last bucket in which \p pid had data.
+    virtual core_t::TTime personLastBucketTime(std::size_t pid) const;
     //@}
 
     //! \name Probability
@@ -174,6 +180,7 @@ protected:
         std::vector<TStrCRefDouble1VecDouble1VecPrPrVec>;
     using TStrCRefDouble1VecDouble1VecPrPrVecVecVec =
         std::vector<TStrCRefDouble1VecDouble1VecPrPrVecVec>;
+    using TFeatureModelsPtrVec = std::vector<SFeatureModels*>;
 
 protected:
     //! Persist state by passing information to the supplied inserter.
@@ -200,6 +207,13 @@ protected:
     //! Update the correlation models.
     void refreshCorrelationModels(std::size_t resourceLimit, CResourceMonitor& resourceMonitor);
 
+    //! Hibernate the models of people who haven't had data for at least
+    //! the model hibernation age at \p time.
+    //!
+    //! \note This only checks people every quarter of the hibernation age
+    //! so models can stay awake for up to 25% longer than the age.
+    void hibernateInactiveModels(core_t::TTime time);
+
     //! Clear out large state objects for people that are pruned.
     virtual void clearPrunedResources(const TSizeVec& people, const TSizeVec& attributes) = 0;
 
@@ -243,9 +257,21 @@ protected:
     double probabilityBucketEmpty(model_t::EFeature feature, std::size_t pid) const;
 
     //! Get a read only model corresponding to \p feature of the person \p pid.
+    //!
+    //! \note This is null if the model is hibernating.
     const maths::CModel* model(model_t::EFeature feature, std::size_t pid) const;
 
+    //! Get a read only model corresponding to \p feature of the person \p pid.
+    //!
+    //! If the model is hibernating a copy is restored into \p restored and
+    //! the model itself is left hibernating.
+    const maths::CModel* model(model_t::EFeature feature,
+                               std::size_t pid,
+                               TMathsModelUPtr& restored) const;
+
     //! Get a writable model corresponding to \p feature of the person \p pid.
+    //!
+    //! \note This wakes the model if it is hibernating.
     maths::CModel* model(model_t::EFeature feature, std::size_t pid);
 
     //! Sample the correlate models.
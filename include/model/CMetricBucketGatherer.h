@@ -210,17 +210,37 @@ public:
 
     //! \name Features
     //@{
-    //! Get the raw data for all features for the bucketing time interval
-    //! containing \p time.
+    using CBucketGatherer::featureData;
+
+    //! Get the raw data for all individual features for the bucketing
+    //! time interval containing \p time.
+    //!
+    //! \param[in] time The time of interest.
+    //! \param[in,out] result Filled in with the feature data at \p time.
+    //! Existing entries are reused.
+    virtual bool featureData(core_t::TTime time,
+                             core_t::TTime bucketLength,
+                             TFeatureSizeMetricFeatureDataPrVecPrVec& result) const;
+
+    //! Get the raw data for all population features for the bucketing
+    //! time interval containing \p time.
     //!
     //! \param[in] time The time of interest.
-    //! \param[out] result Filled in with the feature data at \p time.
-    virtual void featureData(core_t::TTime time,
+    //! \param[in,out] result Filled in with the feature data at \p time.
+    //! Existing entries are reused.
+    virtual bool featureData(core_t::TTime time,
                              core_t::TTime bucketLength,
-                             TFeatureAnyPrVec& result) const;
+                             TFeatureSizeSizePrMetricFeatureDataPrVecPrVec& result) const;
     //@}
 
 private:
+    //! Implements featureData for both the individual and population
+    //! feature data types.
+    template<typename T>
+    bool featureDataImpl(core_t::TTime time,
+                         core_t::TTime bucketLength,
+                         std::vector<std::pair<model_t::EFeature, T>>& result) const;
+
     //! Create samples if possible for the bucket pointed out by \p time.
     virtual void sample(core_t::TTime time);
 
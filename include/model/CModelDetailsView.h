@@ -61,14 +61,31 @@ public:
                    CModelPlotData& modelPlotData) const;
 
     //! Get the feature prior for the specified by field \p byFieldId.
+    //!
+    //! \note This never wakes a hibernating model. Instead, the result is
+    //! a copy restored from its state which is only valid until the next
+    //! call.
     virtual const maths::CModel* model(model_t::EFeature feature,
                                        std::size_t byFieldId) const = 0;
 
 private:
-    //! Add the model plot data for all by field values which match \p terms.
+    using TSizeVec = std::vector<std::size_t>;
+    using TBoolVec = std::vector<bool>;
+
+private:
+    //! Get the identifiers of the by fields which match \p terms.
+    //!
+    //! \param[in] terms The by field values of interest.
+    //! \param[out] ids Filled in with the matching by field identifiers.
+    //! \param[out] selected Filled in with a flag per by field identifier
+    //! which is true if its current bucket values should be added. These
+    //! are the matching by fields and the missing by field.
+    void byFieldIds(const TStrSet& terms, TSizeVec& ids, TBoolVec& selected) const;
+
+    //! Add the current bucket values for the \p selected by fields.
     void addCurrentBucketValues(core_t::TTime time,
                                 model_t::EFeature feature,
-                                const TStrSet& terms,
+                                const TBoolVec& selected,
                                 CModelPlotData& modelPlotData) const;
 
     //! Get the model plot data for the specified by field value.
@@ -86,9 +103,6 @@ private:
                                       std::size_t byFieldId,
                                       core_t::TTime time) const = 0;
 
-    //! Returns true if the terms are empty or they contain the key.
-    static bool contains(const TStrSet& terms, const std::string& key);
-
     //! Check if the model has a by field.
     bool hasByField() const;
     //! Get the maximum by field identifier.
@@ -122,6 +136,9 @@ private:
 private:
     //! The model.
     const CEventRateModel* m_Model;
+
+    //! A copy of the last model requested if it is hibernating.
+    mutable CAnomalyDetectorModel::TMathsModelUPtr m_Restored;
 };
 
 //! \brief A view into the details of a CEventRatePopulationModel object.
@@ -164,6 +181,9 @@ private:
 private:
     //! The model.
     const CMetricModel* m_Model;
+
+    //! A copy of the last model requested if it is hibernating.
+    mutable CAnomalyDetectorModel::TMathsModelUPtr m_Restored;
 };
 
 //! \brief A view into the details of a CMetricPopulationModel object.
@@ -294,6 +294,10 @@ public:
     //! calculations.
     void excludeFrequent(model_t::EExcludeFrequent excludeFrequent);
 
+    //! Set the way the info_content functions estimate the compressed
+    //! length of the distinct values in a bucket.
+    void infoContentEstimator(model_t::EInfoContentEstimator estimator);
+
     //! Set the detection rules for a detector.
     void detectionRules(TDetectionRuleVecCRef detectionRules);
     //@}
@@ -343,6 +347,17 @@ public:
     //! Set the periods and the number of points we'll use to model
     //! of the seasonal components in the data.
     void componentSize(std::size_t componentSize);
+
+    //! Set the number of buckets without data after which a person's
+    //! models are hibernated.
+    void modelHibernationAge(std::size_t age);
+
+    //! Set the maximum number of time series of each feature which can
+    //! test for a change point at any one time.
+    void maximumNumberActiveChangeDetectors(std::size_t number);
+
+    //! Set the store to which the state of hibernating models is spilled.
+    void modelSpillStore(const SModelParams::TModelSpillStorePtr& store);
     //@}
 
     //! Update the bucket length, for ModelAutoConfig's benefit
@@ -19,6 +19,7 @@
 #include <boost/ref.hpp>
 
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,8 @@ struct SDistributionRestoreParams;
 struct STimeSeriesDecompositionRestoreParams;
 }
 namespace model {
+class CModelSpillStore;
+
 //! \brief Wraps up model global parameters.
 //!
 //! DESCIRIPTION:\n
@@ -45,6 +48,7 @@ struct MODEL_EXPORT SModelParams {
     using TStrDetectionRulePrVec = std::vector<TStrDetectionRulePr>;
     using TStrDetectionRulePrVecCRef = boost::reference_wrapper<const TStrDetectionRulePrVec>;
     using TTimeVec = std::vector<core_t::TTime>;
+    using TModelSpillStorePtr = std::shared_ptr<CModelSpillStore>;
 
     explicit SModelParams(core_t::TTime bucketLength);
 
@@ -102,9 +106,28 @@ struct MODEL_EXPORT SModelParams {
     //! The maximum time to test for a change point in a time series.
     core_t::TTime s_MaximumTimeToTestForChange;
 
+    //! The maximum number of time series of each feature which can test
+    //! for a change point at any one time.
+    std::size_t s_MaximumNumberActiveChangeDetectors;
+
+    //! The number of buckets without data after which a person's models
+    //! are compressed and freed until the person is next seen. Zero means
+    //! models are never hibernated.
+    //!
+    //! \note This only applies to individual models. Population models
+    //! share attribute models between people and don't hibernate.
+    std::size_t s_ModelHibernationAge;
+
+    //! The store to which the state of hibernating models is spilled,
+    //! if any.
+    TModelSpillStorePtr s_ModelSpillStore;
+
     //! Controls whether to exclude heavy hitters.
     model_t::EExcludeFrequent s_ExcludeFrequent;
 
+    //! The way the info_content functions estimate compressed length.
+    model_t::EInfoContentEstimator s_InfoContentEstimator;
+
     //! The frequency at which to exclude a person.
     double s_ExcludePersonFrequency;
 
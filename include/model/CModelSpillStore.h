@@ -0,0 +1,206 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_ml_model_CModelSpillStore_h
+#define INCLUDED_ml_model_CModelSpillStore_h
+
+#include <core/CFastMutex.h>
+#include <core/CMemoryMappedFile.h>
+#include <core/CMemoryUsage.h>
+#include <core/CNonCopyable.h>
+
+#include <model/ImportExport.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ml {
+namespace model {
+
+//! \brief A disk backed store for the compressed state of hibernating
+//! models.
+//!
+//! DESCRIPTION:\n
+//! Holds the compressed state of hibernating person models. The most
+//! recently added states are kept in memory up to a limit and the rest
+//! are paged out, least recently added first, to a memory mapped scratch
+//! file in a local directory. A state which has been paged out is read
+//! straight from the mapping.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! The scratch file is divided into fixed size slabs and each state
+//! occupies a contiguous run of slabs. Runs of free slabs are indexed
+//! by their first slab, allocated first fit and merged when they are
+//! freed. The file doubles in size when there isn't a large enough run.
+//!
+//! States are owned by handles, so a state is freed when the model to
+//! which it belongs is woken or destroyed. The memory of resident states
+//! is reported by their handles so it is accounted to the models which
+//! own them.
+//!
+//! If the scratch file can't be created all states are kept in memory.
+//!
+//! The store is shared by all the detectors of a job, whose models may be
+//! woken concurrently, for example to plot them. All access is therefore
+//! serialized by a single mutex. States are read and written as a whole
+//! so the time the lock is held is short compared to (de)serializing them.
+class MODEL_EXPORT CModelSpillStore : private core::CNonCopyable {
+public:
+    using TByteVec = std::vector<unsigned char>;
+
+    //! \brief Owns a state in the store and frees it on destruction.
+    class MODEL_EXPORT CHandle {
+    public:
+        CHandle() = default;
+        CHandle(CModelSpillStore& store, std::size_t key);
+        ~CHandle();
+        CHandle(CHandle&& other);
+        CHandle& operator=(CHandle&& other);
+        CHandle(const CHandle&) = delete;
+        CHandle& operator=(const CHandle&) = delete;
+
+        //! Check if this owns a state.
+        bool valid() const;
+
+        //! Read the state into \p result.
+        bool read(TByteVec& result) const;
+
+        //! Free the state.
+        void reset();
+
+        //! Get the memory used by the state if it is resident.
+        std::size_t memoryUsage() const;
+
+    private:
+        //! The store which holds the state.
+        CModelSpillStore* m_Store = nullptr;
+        //! The key of the state in the store.
+        std::size_t m_Key = 0;
+    };
+
+public:
+    //! The size of a slab of the scratch file in bytes.
+    static const std::size_t SLAB_SIZE;
+
+    //! The initial number of slabs in the scratch file.
+    static const std::size_t INITIAL_NUMBER_SLABS;
+
+    //! The default fraction of the model memory limit which may be used
+    //! by resident states.
+    static const double DEFAULT_RESIDENT_MEMORY_FRACTION;
+
+public:
+    //! \param[in] directory The directory in which to create the scratch
+    //! file.
+    //! \param[in] residentMemoryLimit The maximum memory in bytes to use
+    //! for states which haven't been paged out.
+    CModelSpillStore(const std::string& directory, std::size_t residentMemoryLimit);
+
+    //! Check if the scratch file was created.
+    bool isOpen() const;
+
+    //! Add \p state to the store.
+    CHandle add(TByteVec state);
+
+    //! Set the maximum memory in bytes to use for resident states.
+    void residentMemoryLimit(std::size_t limit);
+
+    //! Get the number of resident states.
+    std::size_t numberResident() const;
+
+    //! Get the number of states which have been paged out.
+    std::size_t numberPagedOut() const;
+
+    //! Get the number of slabs in the scratch file.
+    std::size_t numberSlabs() const;
+
+    //! Debug the memory used by this object.
+    void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
+
+    //! Get the memory used by this object.
+    std::size_t memoryUsage() const;
+
+private:
+    using TSizeList = std::list<std::size_t>;
+    using TSizeListItr = TSizeList::iterator;
+
+    //! \brief A state in the store.
+    struct SState {
+        //! The state if it is resident.
+        TByteVec s_State;
+        //! The position of the state in the resident list if it is
+        //! resident.
+        TSizeListItr s_Resident;
+        //! The first slab of the state if it has been paged out.
+        std::size_t s_Slab = 0;
+        //! The length of the state in bytes.
+        std::size_t s_Length = 0;
+        //! True if the state has been paged out.
+        bool s_PagedOut = false;
+    };
+
+    using TSizeStateUMap = boost::unordered_map<std::size_t, SState>;
+    using TSizeSizeMap = std::map<std::size_t, std::size_t>;
+
+private:
+    //! Read the state identified by \p key into \p result.
+    bool read(std::size_t key, TByteVec& result) const;
+
+    //! Free the state identified by \p key.
+    void remove(std::size_t key);
+
+    //! Get the memory used by the state identified by \p key if it is
+    //! resident.
+    std::size_t residentMemoryUsage(std::size_t key) const;
+
+    //! Page out the least recently added states until resident states
+    //! use less than the limit.
+    void pageOut();
+
+    //! Allocate a run of \p n slabs writing the first to \p slab.
+    bool allocate(std::size_t n, std::size_t& slab);
+
+    //! Free the run of \p n slabs starting at \p slab.
+    void free(std::size_t slab, std::size_t n);
+
+    //! Get the number of slabs needed for \p length bytes.
+    static std::size_t slabs(std::size_t length);
+
+private:
+    //! Serializes access to the store.
+    mutable core::CFastMutex m_Mutex;
+
+    //! The scratch file.
+    core::CMemoryMappedFile m_File;
+
+    //! The maximum memory to use for resident states.
+    std::size_t m_ResidentMemoryLimit;
+
+    //! The memory used by resident states.
+    std::size_t m_ResidentMemory;
+
+    //! The key of the next state to be added.
+    std::size_t m_NextKey;
+
+    //! The states indexed by their key.
+    TSizeStateUMap m_States;
+
+    //! The keys of the resident states in the order they were added.
+    TSizeList m_Resident;
+
+    //! The number of free slabs in each run indexed by the first slab
+    //! of the run.
+    TSizeSizeMap m_FreeSlabs;
+};
+}
+}
+
+#endif // INCLUDED_ml_model_CModelSpillStore_h
@@ -108,7 +108,7 @@ public:
                 static_cast<uint64_t>(s_Hasher(*target.first)),
                 static_cast<uint64_t>(s_Hasher(*target.second))));
         }
-        core::CHashing::CMurmurHash2String s_Hasher;
+        core::CHashing::CWyHashString s_Hasher;
     };
 
     //! \brief Compares two string pointer pairs.
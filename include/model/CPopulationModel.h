@@ -154,6 +154,12 @@ public:
     virtual void sample(core_t::TTime startTime,
                         core_t::TTime endTime,
                         CResourceMonitor& resourceMonitor) = 0;
+
+    //! Get the start of the last bucket in which \p pid had data.
+    virtual core_t::TTime personLastBucketTime(std::size_t pid) const;
+
+    //! Get the start of the last bucket in which \p cid had data.
+    virtual core_t::TTime attributeLastBucketTime(std::size_t cid) const;
     //@}
 
     //! Get the checksum of this model.
@@ -14,6 +14,10 @@
 #include <boost/unordered_map.hpp>
 
 #include <functional>
+#include <map>
+#include <vector>
+
+#include <stdint.h>
 
 class CResourceMonitorTest;
 class CResourceLimitTest;
@@ -30,6 +34,19 @@ class CResourcePruner;
 //!
 //! DESCRIPTION:\n
 //! Assess memory used by models and decide on further memory allocations.
+//!
+//! The people and attributes of every registered model are indexed by
+//! the last time they had data. When the memory usage exceeds the prune
+//! threshold the least recently seen people and attributes, across all
+//! models, are pruned until it is back below the threshold.
+//!
+//! The index is bucketed by time and is updated lazily: seeing a person
+//! or attribute again just adds a new entry and the old one is left to
+//! go stale. An entry is valid only while it matches the last bucket
+//! time its model holds, so entries made stale by the models pruning,
+//! recycling or shifting their people and attributes, or by the model
+//! being unregistered, are dropped when they are reached or when the
+//! index is compacted, which it is whenever a fifth of it is stale.
 class MODEL_EXPORT CResourceMonitor {
 public:
     struct MODEL_EXPORT SResults {
@@ -48,8 +65,14 @@ public:
     using TMemoryUsageReporterFunc = std::function<void(const CResourceMonitor::SResults&)>;
     using TTimeSizeMap = std::map<core_t::TTime, std::size_t>;
 
+    //! The types of series indexed by the last time they had data.
+    enum EEntity { E_Person, E_Attribute };
+
     //! The minimum time between prunes
     static const core_t::TTime MINIMUM_PRUNE_FREQUENCY;
+    //! The minimum number of entries in the index of when people and
+    //! attributes last had data before it is compacted
+    static const std::size_t MINIMUM_LAST_SEEN_TO_COMPACT;
     //! Default memory limit for resource monitor
     static const std::size_t DEFAULT_MEMORY_LIMIT_MB;
     //! The initial byte limit margin to use if none is supplied
@@ -119,6 +142,10 @@ public:
     //! Prune models where necessary
     bool pruneIfRequired(core_t::TTime endTime);
 
+    //! Record that the person or attribute \p id of \p model had data
+    //! in the bucket starting at \p time.
+    void seen(const CAnomalyDetectorModel& model, EEntity entity, std::size_t id, core_t::TTime time);
+
     //! Accounts for any extra memory to the one
     //! reported by the components.
     //! Used in conjunction  with clearExtraMemory()
@@ -137,11 +164,59 @@ public:
     //! by calling this pnce per bucket processed.
     void decreaseMargin(core_t::TTime elapsedTime);
 
+private:
+    using TModelCPtr = const CAnomalyDetectorModel*;
+    using TModelCPtrVec = std::vector<TModelCPtr>;
+    using TModelCPtrSizeUMap = boost::unordered_map<TModelCPtr, std::size_t>;
+
+    //! \brief Identifies the people or the attributes of a registered
+    //! model which last had data in a bucket.
+    struct SLastSeenKey {
+        bool operator<(const SLastSeenKey& rhs) const;
+
+        //! The start of the bucket.
+        core_t::TTime s_Time;
+        //! The index of the model in the registered models.
+        std::size_t s_Model;
+        //! The type of entity, i.e. person or attribute.
+        EEntity s_Entity;
+    };
+
+    //! The identifiers are kept small since there is one for every
+    //! person and attribute of every model.
+    using TUInt32Vec = std::vector<uint32_t>;
+    using TLastSeenKeyUInt32VecMap = std::map<SLastSeenKey, TUInt32Vec>;
+
 private:
     //! Updates the memory limit fields and the prune threshold
     //! to the given value.
     void updateMemoryLimitsAndPruneThreshold(std::size_t limitMBs);
 
+    //! Index the people and attributes of \p detector's model.
+    void indexLastSeen(CAnomalyDetector& detector);
+
+    //! Stop indexing the people and attributes of \p model.
+    void forgetLastSeen(TModelCPtr model);
+
+    //! Check if \p key is the last time the person or attribute \p id
+    //! had data, i.e. if the entry is still valid.
+    bool isLastSeen(const SLastSeenKey& key, uint32_t id) const;
+
+    //! Remove all the stale entries from the index.
+    void compactLastSeen();
+
+    //! Recompute the memory used by the index.
+    void refreshLastSeenMemory();
+
+    //! Get the memory used by an entry of the index comprising \p ids.
+    static std::size_t lastSeenMemory(const TUInt32Vec& ids);
+
+    //! Prune the least recently seen people and attributes until the
+    //! memory usage is below \p target.
+    //!
+    //! \return The number of people and attributes pruned.
+    std::size_t pruneLeastRecentlySeen(core_t::TTime endTime, std::size_t target);
+
     //! Update the given model and recalculate the total usage
     void memUsage(CAnomalyDetector* detector);
 
@@ -209,17 +284,29 @@ private:
     //! towards for the sweet spot
     std::size_t m_PruneThreshold;
 
-    //! The last time we did a full prune of all the models
+    //! The last time we pruned the models
     core_t::TTime m_LastPruneTime;
 
-    //! Number of buckets to go back when pruning
-    std::size_t m_PruneWindow;
+    //! The models whose people and attributes are indexed. Models
+    //! which have been unregistered are null.
+    TModelCPtrVec m_LastSeenModels;
+
+    //! The index of each registered model in m_LastSeenModels
+    TModelCPtrSizeUMap m_LastSeenModelIndices;
+
+    //! The people and attributes of all models keyed by the start of
+    //! the last bucket in which they had data
+    TLastSeenKeyUInt32VecMap m_LastSeen;
+
+    //! The number of entries in the index
+    std::size_t m_NumberLastSeen;
 
-    //! The largest that the prune window can grow to - determined from the models
-    std::size_t m_PruneWindowMaximum;
+    //! The number of entries in the index when it was last compacted
+    std::size_t m_NumberLastSeenAfterCompaction;
 
-    //! The smallest that the prune window can shrink to - 4 weeks
-    std::size_t m_PruneWindowMinimum;
+    //! The memory used by the index, which is maintained incrementally
+    //! as entries are added and removed
+    std::size_t m_LastSeenMemory;
 
     //! Don't do any sort of memory checking if this is set
     bool m_NoLimit;
@@ -38,6 +38,10 @@ public:
     //! Push to the underlying queue
     void push(const CHierarchicalResults& item);
 
+    //! Push empty results for \p time to the underlying queue reusing
+    //! the memory of the results which are evicted.
+    void pushRecycled(core_t::TTime time);
+
     //! Get a result from the queue
     const CHierarchicalResults& get(core_t::TTime time) const;
 
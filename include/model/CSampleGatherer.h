@@ -69,7 +69,7 @@ public:
     using TStatBucketQueue = CBucketQueue<TMetricPartialStatistic>;
     using TStoredStringPtrVec = std::vector<core::CStoredStringPtr>;
     using TStoredStringPtrStatUMap =
-        boost::unordered_map<core::CStoredStringPtr, STATISTIC, core::CHashing::CMurmurHash2String>;
+        boost::unordered_map<core::CStoredStringPtr, STATISTIC, core::CHashing::CWyHashString>;
     using TStoredStringPtrStatUMapBucketQueue = CBucketQueue<TStoredStringPtrStatUMap>;
     using TStoredStringPtrStatUMapBucketQueueVec =
         std::vector<TStoredStringPtrStatUMapBucketQueue>;
@@ -7,6 +7,7 @@
 #define INCLUDED_ml_model_CStringStore_h
 
 #include <core/CFastMutex.h>
+#include <core/CHashing.h>
 #include <core/CMemory.h>
 #include <core/CNonCopyable.h>
 #include <core/CStoredStringPtr.h>
@@ -15,9 +16,10 @@
 
 #include <boost/unordered_set.hpp>
 
-#include <atomic>
+#include <array>
 #include <functional>
 #include <string>
+#include <vector>
 
 class CResourceMonitorTest;
 class CStringStoreTest;
@@ -47,13 +49,20 @@ namespace model {
 //! A singleton class: there should only be one collection strings for
 //! person names/attributes, and a separate collection for influencer
 //! strings.
-//! Write access is locked for the benefit of future threading.
+//!
+//! The strings are split between a fixed number of shards, each with its
+//! own lock, by their hash. Threads only contend if they access strings
+//! in the same shard at the same time and, since each access only holds
+//! the lock for a single hash set lookup, this is short lived. Unlike a
+//! readers/writer scheme this never needs to fall back to creating a
+//! private copy of a string, so every string is stored exactly once and
+//! accounted for in the memory usage.
 //!
 class MODEL_EXPORT CStringStore : private core::CNonCopyable {
 public:
     struct MODEL_EXPORT SHashStoredStringPtr {
         std::size_t operator()(const core::CStoredStringPtr& key) const {
-            boost::hash<std::string> hasher;
+            core::CHashing::CWyHashString hasher;
             return hasher(*key);
         }
     };
@@ -100,37 +109,51 @@ private:
         boost::unordered_set<core::CStoredStringPtr, SHashStoredStringPtr, SStoredStringPtrEqual>;
     using TStrVec = std::vector<std::string>;
 
+    //! \brief A subset of the strings which are locked together.
+    struct SShard {
+        SShard() : s_StoredStringsMemUse(0) {}
+
+        //! Set to keep the person/attribute string pointers.
+        TStoredStringPtrUSet s_Strings;
+
+        //! A list of the strings to remove.
+        TStrVec s_Removed;
+
+        //! Running count of memory usage by stored strings.  Avoids the
+        //! need to recalculate repeatedly.
+        std::size_t s_StoredStringsMemUse;
+
+        //! Locking primitive.
+        mutable core::CFastMutex s_Mutex;
+    };
+
+    //! The number of bits of the hash used to choose a string's shard.
+    static const std::size_t SHARD_BITS = 5;
+
+    //! The number of shards.
+    static const std::size_t NUMBER_SHARDS = 1 << SHARD_BITS;
+
+    using TShardArray = std::array<SShard, NUMBER_SHARDS>;
+
 private:
     //! Constructor of a Singleton is private.
     CStringStore();
 
+    //! Get the shard containing strings with hash \p hash.
+    SShard& shard(std::size_t hash);
+
+    //! Get the number of strings in the store.
+    std::size_t size() const;
+
     //! Bludgeoning device to delete all objects in store.
     void clearEverythingTestOnly();
 
 private:
-    //! Fence for reading operations (in which case we "leak" a string
-    //! if we try to write at the same time). See get for details.
-    std::atomic_int m_Reading;
-
-    //! Fence for writing operations (in which case we "leak" a string
-    //! if we try to read at the same time). See get for details.
-    std::atomic_int m_Writing;
-
     //! The empty string is often used so we store it outside the set.
     core::CStoredStringPtr m_EmptyString;
 
-    //! Set to keep the person/attribute string pointers
-    TStoredStringPtrUSet m_Strings;
-
-    //! A list of the strings to remove.
-    TStrVec m_Removed;
-
-    //! Running count of memory usage by stored strings.  Avoids the need to
-    //! recalculate repeatedly.
-    std::size_t m_StoredStringsMemUse;
-
-    //! Locking primitive
-    mutable core::CFastMutex m_Mutex;
+    //! The shards of the store.
+    TShardArray m_Shards;
 
     friend class ::CResourceMonitorTest;
     friend class ::CStringStoreTest;
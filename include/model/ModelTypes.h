@@ -775,6 +775,13 @@ enum EExcludeFrequent {
     E_XF_Both = 3
 };
 
+//! An enumeration of the ways the info_content functions can estimate the
+//! compressed length of the distinct values in a bucket
+//!   -# E_InfoContentDeflate: compress the sorted values with zlib
+//!   -# E_InfoContentSketch: use a streaming sketch which is updated as each
+//!      new value arrives, see maths::CCompressedLengthSketch
+enum EInfoContentEstimator { E_InfoContentDeflate = 0, E_InfoContentSketch = 1 };
+
 //! An enumeration of the ResourceMonitor memory status -
 //! Start in the OK state. Moves into soft limit if aggressive pruning
 //! has taken place to avoid hitting the memory limit,
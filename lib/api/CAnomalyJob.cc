@@ -11,6 +11,7 @@
 #include <core/CJsonStatePersistInserter.h>
 #include <core/CJsonStateRestoreTraverser.h>
 #include <core/CLogger.h>
+#include <core/CParallel.h>
 #include <core/CScopedRapidJsonPoolAllocator.h>
 #include <core/CStateCompressor.h>
 #include <core/CStateDecompressor.h>
@@ -45,6 +46,8 @@
 #include <boost/property_tree/ptree.hpp>
 
 #include <fstream>
+#include <iterator>
+#include <numeric>
 #include <sstream>
 #include <string>
 
@@ -573,6 +576,8 @@ void CAnomalyJob::outputResults(core_t::TTime bucketStartTime) {
     using TKeyAnomalyDetectorPtrUMapCItrVec = std::vector<TKeyAnomalyDetectorPtrUMapCItr>;
 
     static uint64_t cumulativeTime = 0;
+    static uint64_t lastPeriodicityTests = 0;
+    static uint64_t lastPeriodicityTestTime = 0;
 
     core::CStopWatch timer(true);
 
@@ -582,7 +587,7 @@ void CAnomalyJob::outputResults(core_t::TTime bucketStartTime) {
         m_ModelPlotQueue.reset(bucketStartTime - m_ModelPlotQueue.bucketLength());
     }
 
-    m_ResultsQueue.push(model::CHierarchicalResults(), bucketStartTime);
+    m_ResultsQueue.pushRecycled(bucketStartTime);
     model::CHierarchicalResults& results = m_ResultsQueue.get(bucketStartTime);
     m_ModelPlotQueue.push(TModelPlotDataVec(), bucketStartTime);
 
@@ -595,6 +600,8 @@ void CAnomalyJob::outputResults(core_t::TTime bucketStartTime) {
     std::sort(iterators.begin(), iterators.end(),
               core::CFunctional::SDereference<maths::COrderings::SFirstLess>());
 
+    TAnomalyDetectorCPtrVec detectors;
+    detectors.reserve(iterators.size());
     for (std::size_t i = 0u; i < iterators.size(); ++i) {
         model::CAnomalyDetector* detector(iterators[i]->second.get());
         if (detector == nullptr) {
@@ -604,10 +611,11 @@ void CAnomalyJob::outputResults(core_t::TTime bucketStartTime) {
         }
         detector->buildResults(bucketStartTime, bucketStartTime + bucketLength, results);
         detector->releaseMemory(bucketStartTime - m_ModelConfig.samplingAgeCutoff());
-
-        this->generateModelPlot(bucketStartTime, bucketStartTime + bucketLength, *detector);
+        detectors.push_back(detector);
     }
 
+    this->generateModelPlot(bucketStartTime, bucketStartTime + bucketLength, detectors);
+
     if (!results.empty()) {
         results.buildHierarchy();
 
@@ -639,6 +647,19 @@ void CAnomalyJob::outputResults(core_t::TTime bucketStartTime) {
         cumulativeTime += timer.stop();
     }
 
+    // The periodicity test statistics are cumulative: log what ran for
+    // this bucket, which includes tests run on background threads.
+    uint64_t periodicityTests = core::CStatistics::stat(stat_t::E_NumberPeriodicityTests).value();
+    uint64_t periodicityTestTime = core::CStatistics::stat(stat_t::E_PeriodicityTestTime).value();
+    if (periodicityTests != lastPeriodicityTests) {
+        LOG_DEBUG(<< "Ran " << periodicityTests - lastPeriodicityTests
+                  << " periodicity tests taking "
+                  << periodicityTestTime - lastPeriodicityTestTime
+                  << "us up to bucket " << bucketStartTime);
+        lastPeriodicityTests = periodicityTests;
+        lastPeriodicityTestTime = periodicityTestTime;
+    }
+
     m_Limits.resourceMonitor().pruneIfRequired(bucketStartTime);
     model::CStringStore::tidyUpNotThreadSafe();
 }
@@ -1312,13 +1333,37 @@ void CAnomalyJob::outputResultsWithinRange(bool isInterim, core_t::TTime start,
 
 void CAnomalyJob::generateModelPlot(core_t::TTime startTime,
                                     core_t::TTime endTime,
-                                    const model::CAnomalyDetector& detector) {
+                                    const TAnomalyDetectorCPtrVec& detectors) {
+    using TSizeVec = std::vector<std::size_t>;
+    using TModelPlotDataVecVec = std::vector<TModelPlotDataVec>;
+
     double modelPlotBoundsPercentile(m_ModelConfig.modelPlotBoundsPercentile());
     if (modelPlotBoundsPercentile > 0.0) {
         LOG_TRACE(<< "Generating model debug data at " << startTime);
-        detector.generateModelPlot(
-            startTime, endTime, m_ModelConfig.modelPlotBoundsPercentile(),
-            m_ModelConfig.modelPlotTerms(), m_ModelPlotQueue.get(startTime));
+
+        core::CStopWatch timer(true);
+
+        const auto& terms = m_ModelConfig.modelPlotTerms();
+        TModelPlotDataVecVec modelPlots(detectors.size());
+        TSizeVec indices(detectors.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        // This only uses more than one thread if background threads were
+        // requested.
+        core::CParallel::forEach(
+            core::CParallel::defaultThreads(), indices.begin(), indices.end(),
+            [&](std::size_t i) {
+                detectors[i]->generateModelPlot(startTime, endTime, modelPlotBoundsPercentile,
+                                                terms, modelPlots[i]);
+            });
+
+        TModelPlotDataVec& result = m_ModelPlotQueue.get(startTime);
+        for (auto& modelPlot : modelPlots) {
+            std::move(modelPlot.begin(), modelPlot.end(), std::back_inserter(result));
+        }
+
+        uint64_t time{timer.stop()};
+        core::CStatistics::stat(stat_t::E_ModelPlotTime).increment(time);
+        LOG_TRACE(<< "Generated model debug data in " << time << "ms");
     }
 }
 
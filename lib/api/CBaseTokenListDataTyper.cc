@@ -5,6 +5,7 @@
  */
 #include <api/CBaseTokenListDataTyper.h>
 
+#include <core/CHashing.h>
 #include <core/CLogger.h>
 #include <core/CStatePersistInserter.h>
 #include <core/CStateRestoreTraverser.h>
@@ -35,6 +36,11 @@ const std::string TYPE_TAG("c");
 const std::string TIME_ATTRIBUTE("time");
 
 const std::string EMPTY_STRING;
+
+//! Marks an empty slot of the token index.
+const size_t EMPTY_SLOT(std::numeric_limits<size_t>::max());
+//! The minimum size of the token index.
+const size_t MIN_TOKEN_INDEX_SIZE(256);
 }
 
 CBaseTokenListDataTyper::CBaseTokenListDataTyper(const TTokenListReverseSearchCreatorIntfCPtr& reverseSearchCreator,
@@ -44,6 +50,7 @@ CBaseTokenListDataTyper::CBaseTokenListDataTyper(const TTokenListReverseSearchCr
       m_LowerThreshold(std::min(0.99, std::max(0.01, threshold))),
       // Upper threshold is half way between the lower threshold and 1
       m_UpperThreshold((1.0 + m_LowerThreshold) / 2.0), m_HasChanged(false) {
+    this->rebuildTokenIndex();
 }
 
 void CBaseTokenListDataTyper::dumpStats() const {
@@ -168,7 +175,7 @@ int CBaseTokenListDataTyper::computeType(bool isDryRun,
     for (const auto& workTokenId : m_WorkTokenIds) {
         // We get away with casting away constness ONLY because the type count
         // is not used in any of the multi-index keys
-        const_cast<CTokenInfoItem&>(m_TokenIdLookup[workTokenId.first]).incTypeCount();
+        m_TokenIdLookup[workTokenId.first].incTypeCount();
     }
 
     // Type is vector index plus one
@@ -342,6 +349,7 @@ bool CBaseTokenListDataTyper::acceptRestoreTraverser(core::CStateRestoreTraverse
     m_Types.clear();
     m_TypesByCount.clear();
     m_TokenIdLookup.clear();
+    this->rebuildTokenIndex();
     m_WorkTokenIds.clear();
     m_WorkTokenUniqueIds.clear();
     m_HasChanged = false;
@@ -349,8 +357,7 @@ bool CBaseTokenListDataTyper::acceptRestoreTraverser(core::CStateRestoreTraverse
     do {
         const std::string& name = traverser.name();
         if (name == TOKEN_TAG) {
-            size_t nextIndex(m_TokenIdLookup.size());
-            m_TokenIdLookup.push_back(CTokenInfoItem(traverser.value(), nextIndex));
+            this->idForToken(traverser.value());
         } else if (name == TOKEN_TYPE_COUNT_TAG) {
             if (m_TokenIdLookup.empty()) {
                 LOG_ERROR(<< "Token type count precedes token string in "
@@ -364,9 +371,7 @@ bool CBaseTokenListDataTyper::acceptRestoreTraverser(core::CStateRestoreTraverse
                 return false;
             }
 
-            // We get away with casting away constness ONLY because the type
-            // count is not used in any of the multi-index keys
-            const_cast<CTokenInfoItem&>(m_TokenIdLookup.back()).typeCount(typeCount);
+            m_TokenIdLookup.back().typeCount(typeCount);
         } else if (name == TYPE_TAG) {
             CTokenListType type(traverser);
             TSizeSizePr countAndIndex(type.numMatches(), m_Types.size());
@@ -386,7 +391,7 @@ void CBaseTokenListDataTyper::acceptPersistInserter(core::CStatePersistInserter&
     CBaseTokenListDataTyper::acceptPersistInserter(m_TokenIdLookup, m_Types, inserter);
 }
 
-void CBaseTokenListDataTyper::acceptPersistInserter(const TTokenMIndex& tokenIdLookup,
+void CBaseTokenListDataTyper::acceptPersistInserter(const TTokenInfoItemVec& tokenIdLookup,
                                                     const TTokenListTypeVec& types,
                                                     core::CStatePersistInserter& inserter) {
     for (const CTokenInfoItem& item : tokenIdLookup) {
@@ -409,7 +414,7 @@ void CBaseTokenListDataTyper::addTypeMatch(bool isDryRun,
                                            const std::string& str,
                                            size_t rawStringLen,
                                            const TSizeSizePrVec& tokenIds,
-                                           const TSizeSizeMap& tokenUniqueIds,
+                                           const TSizeSizeFMap& tokenUniqueIds,
                                            double similarity,
                                            TSizeSizePrListItr& iter) {
     if (m_Types[iter->second].addString(isDryRun, str, rawStringLen, tokenIds,
@@ -473,19 +478,28 @@ size_t CBaseTokenListDataTyper::maxMatchingWeight(size_t weight, double threshol
 }
 
 size_t CBaseTokenListDataTyper::idForToken(const std::string& token) {
-    auto iter = boost::multi_index::get<SToken>(m_TokenIdLookup).find(token);
-    if (iter != boost::multi_index::get<SToken>(m_TokenIdLookup).end()) {
-        return iter->index();
+    size_t hash(tokenHash(token));
+    STokenIndexSlot& slot(m_TokenIndex[this->tokenIndexSlot(token, hash)]);
+    if (slot.s_Id != EMPTY_SLOT) {
+        return slot.s_Id;
     }
 
     size_t nextIndex(m_TokenIdLookup.size());
-    m_TokenIdLookup.push_back(CTokenInfoItem(token, nextIndex));
+    m_TokenIdLookup.emplace_back(token, nextIndex);
+    slot.s_Hash = hash;
+    slot.s_Id = nextIndex;
+
+    // Keep the index at most half full so probe sequences are short.
+    if (2 * m_TokenIdLookup.size() > m_TokenIndex.size()) {
+        this->rebuildTokenIndex();
+    }
+
     return nextIndex;
 }
 
 bool CBaseTokenListDataTyper::addPretokenisedTokens(const std::string& tokensCsv,
                                                     TSizeSizePrVec& tokenIds,
-                                                    TSizeSizeMap& tokenUniqueIds,
+                                                    TSizeSizeFMap& tokenUniqueIds,
                                                     size_t& totalWeight) {
     tokenIds.clear();
     tokenUniqueIds.clear();
@@ -504,6 +518,37 @@ bool CBaseTokenListDataTyper::addPretokenisedTokens(const std::string& tokensCsv
     return true;
 }
 
+size_t CBaseTokenListDataTyper::tokenIndexSlot(const std::string& token, size_t hash) const {
+    // The index size is a power of two.
+    size_t mask(m_TokenIndex.size() - 1);
+    for (size_t i = hash & mask; /**/; i = (i + 1) & mask) {
+        const STokenIndexSlot& slot(m_TokenIndex[i]);
+        if (slot.s_Id == EMPTY_SLOT ||
+            (slot.s_Hash == hash && m_TokenIdLookup[slot.s_Id].str() == token)) {
+            return i;
+        }
+    }
+}
+
+void CBaseTokenListDataTyper::rebuildTokenIndex() {
+    size_t size(MIN_TOKEN_INDEX_SIZE);
+    while (size < 4 * m_TokenIdLookup.size()) {
+        size *= 2;
+    }
+    m_TokenIndex.assign(size, STokenIndexSlot{0, EMPTY_SLOT});
+    for (const auto& item : m_TokenIdLookup) {
+        size_t hash(tokenHash(item.str()));
+        STokenIndexSlot& slot(m_TokenIndex[this->tokenIndexSlot(item.str(), hash)]);
+        slot.s_Hash = hash;
+        slot.s_Id = item.index();
+    }
+}
+
+size_t CBaseTokenListDataTyper::tokenHash(const std::string& token) {
+    return static_cast<size_t>(core::CHashing::wyHash64(
+        token.data(), static_cast<int>(token.length()), 0));
+}
+
 CBaseTokenListDataTyper::CTokenInfoItem::CTokenInfoItem(const std::string& str, size_t index)
     : m_Str(str), m_Index(index), m_TypeCount(0) {
 }
@@ -54,7 +54,8 @@ CFieldDataTyper::CFieldDataTyper(const std::string& jobId,
       m_MaxMatchingLength(0), m_JsonOutputWriter(jsonOutputWriter),
       m_ExamplesCollector(limits.maxExamples()),
       m_CategorizationFieldName(config.categorizationFieldName()),
-      m_CategorizationFilter(), m_PeriodicPersister(periodicPersister) {
+      m_CategorizationFilter(), m_FilteredFieldValue(),
+      m_PeriodicPersister(periodicPersister) {
     this->createTyper(m_CategorizationFieldName);
 
     LOG_DEBUG(<< "Configuring categorization filtering");
@@ -151,8 +152,8 @@ int CFieldDataTyper::computeType(const TStrStrUMap& dataRowFields) {
         type = m_DataTyper->computeType(false, dataRowFields, fieldValue,
                                         fieldValue.length());
     } else {
-        std::string filtered = m_CategorizationFilter.apply(fieldValue);
-        type = m_DataTyper->computeType(false, dataRowFields, filtered,
+        m_CategorizationFilter.apply(fieldValue, m_FilteredFieldValue);
+        type = m_DataTyper->computeType(false, dataRowFields, m_FilteredFieldValue,
                                         fieldValue.length());
     }
     if (type < 1) {
@@ -47,7 +47,7 @@ CTokenListType::CTokenListType(bool isDryRun,
                                size_t rawStringLen,
                                const TSizeSizePrVec& baseTokenIds,
                                size_t baseWeight,
-                               const TSizeSizeMap& uniqueTokenIds)
+                               const TSizeSizeFMap& uniqueTokenIds)
     : m_BaseString(baseString), m_BaseTokenIds(baseTokenIds),
       m_BaseWeight(baseWeight), m_MaxStringLen(rawStringLen),
       m_OutOfOrderCommonTokenIndex(baseTokenIds.size()),
@@ -56,7 +56,7 @@ CTokenListType::CTokenListType(bool isDryRun,
       m_CommonUniqueTokenIds(uniqueTokenIds.begin(), uniqueTokenIds.end()),
       m_CommonUniqueTokenWeight(0), m_OrigUniqueTokenWeight(0),
       m_NumMatches(isDryRun ? 0 : 1) {
-    for (TSizeSizeMapCItr iter = uniqueTokenIds.begin();
+    for (TSizeSizeFMapCItr iter = uniqueTokenIds.begin();
          iter != uniqueTokenIds.end(); ++iter) {
         m_CommonUniqueTokenWeight += iter->second;
     }
@@ -160,7 +160,7 @@ bool CTokenListType::addString(bool isDryRun,
                                const std::string& /* str */,
                                size_t rawStringLen,
                                const TSizeSizePrVec& tokenIds,
-                               const TSizeSizeMap& uniqueTokenIds,
+                               const TSizeSizeFMap& uniqueTokenIds,
                                double /* similarity */) {
     bool changed(false);
 
@@ -168,7 +168,7 @@ bool CTokenListType::addString(bool isDryRun,
     // with the same weight in the new string, and adjust the common weight
     // accordingly
     TSizeSizePrVecItr commonIter = m_CommonUniqueTokenIds.begin();
-    TSizeSizeMapCItr newIter = uniqueTokenIds.begin();
+    TSizeSizeFMapCItr newIter = uniqueTokenIds.begin();
     while (commonIter != m_CommonUniqueTokenIds.end()) {
         if (newIter == uniqueTokenIds.end() || commonIter->first < newIter->first) {
             m_CommonUniqueTokenWeight -= commonIter->second;
@@ -271,11 +271,11 @@ size_t CTokenListType::maxMatchingStringLen() const {
     return (m_MaxStringLen * 11) / 10;
 }
 
-size_t CTokenListType::missingCommonTokenWeight(const TSizeSizeMap& uniqueTokenIds) const {
+size_t CTokenListType::missingCommonTokenWeight(const TSizeSizeFMap& uniqueTokenIds) const {
     size_t presentWeight(0);
 
     TSizeSizePrVecCItr commonIter = m_CommonUniqueTokenIds.begin();
-    TSizeSizeMapCItr testIter = uniqueTokenIds.begin();
+    TSizeSizeFMapCItr testIter = uniqueTokenIds.begin();
     while (commonIter != m_CommonUniqueTokenIds.end() &&
            testIter != uniqueTokenIds.end()) {
         if (commonIter->first == testIter->first) {
@@ -300,14 +300,14 @@ size_t CTokenListType::missingCommonTokenWeight(const TSizeSizeMap& uniqueTokenI
     return m_CommonUniqueTokenWeight - presentWeight;
 }
 
-bool CTokenListType::isMissingCommonTokenWeightZero(const TSizeSizeMap& uniqueTokenIds) const {
+bool CTokenListType::isMissingCommonTokenWeightZero(const TSizeSizeFMap& uniqueTokenIds) const {
     // This method could be implemented as:
     // return this->missingCommonTokenWeight(uniqueTokenIds) == 0;
     //
     // However, it's much faster to return false as soon as a mismatch occurs
 
     TSizeSizePrVecCItr commonIter = m_CommonUniqueTokenIds.begin();
-    TSizeSizeMapCItr testIter = uniqueTokenIds.begin();
+    TSizeSizeFMapCItr testIter = uniqueTokenIds.begin();
     while (commonIter != m_CommonUniqueTokenIds.end() &&
            testIter != uniqueTokenIds.end()) {
         if (commonIter->first < testIter->first) {
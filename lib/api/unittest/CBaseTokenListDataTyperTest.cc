@@ -6,6 +6,9 @@
 #include "CBaseTokenListDataTyperTest.h"
 
 #include <api/CBaseTokenListDataTyper.h>
+#include <api/CTokenListDataTyper.h>
+
+#include <boost/lexical_cast.hpp>
 
 CppUnit::Test* CBaseTokenListDataTyperTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CBaseTokenListDataTyperTest");
@@ -16,6 +19,9 @@ CppUnit::Test* CBaseTokenListDataTyperTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CBaseTokenListDataTyperTest>(
         "CBaseTokenListDataTyperTest::testMaxMatchingWeights",
         &CBaseTokenListDataTyperTest::testMaxMatchingWeights));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CBaseTokenListDataTyperTest>(
+        "CBaseTokenListDataTyperTest::testIdForToken",
+        &CBaseTokenListDataTyperTest::testIdForToken));
 
     return suiteOfTests;
 }
@@ -69,3 +75,24 @@ void CBaseTokenListDataTyperTest::testMaxMatchingWeights() {
     CPPUNIT_ASSERT_EQUAL(
         size_t(14), ml::api::CBaseTokenListDataTyper::maxMatchingWeight(10, 0.7));
 }
+
+void CBaseTokenListDataTyperTest::testIdForToken() {
+    // Check tokens get consecutive IDs in order of first appearance and
+    // keep them as the token index grows.
+
+    ml::api::CTokenListDataTyper<> typer(
+        ml::api::CBaseTokenListDataTyper::TTokenListReverseSearchCreatorIntfCPtr(),
+        0.7, "whatever");
+    ml::api::CBaseTokenListDataTyper& base(typer);
+
+    std::vector<std::string> tokens;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        tokens.push_back("token" + boost::lexical_cast<std::string>(i));
+        CPPUNIT_ASSERT_EQUAL(i, base.idForToken(tokens.back()));
+    }
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, base.idForToken(tokens[i]));
+        CPPUNIT_ASSERT_EQUAL(tokens[i], base.m_TokenIdLookup[i].str());
+    }
+    CPPUNIT_ASSERT_EQUAL(tokens.size(), base.m_TokenIdLookup.size());
+}
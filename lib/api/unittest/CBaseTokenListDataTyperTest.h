@@ -12,6 +12,7 @@ class CBaseTokenListDataTyperTest : public CppUnit::TestFixture {
 public:
     void testMinMatchingWeights();
     void testMaxMatchingWeights();
+    void testIdForToken();
 
     static CppUnit::Test* suite();
 };
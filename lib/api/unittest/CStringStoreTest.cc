@@ -8,6 +8,7 @@
 #include "CMockDataAdder.h"
 #include "CMockSearcher.h"
 
+#include <core/CHashing.h>
 #include <core/CJsonOutputStreamWrapper.h>
 #include <core/CLogger.h>
 
@@ -22,6 +23,7 @@
 #include <api/CJsonOutputWriter.h>
 
 #include <sstream>
+#include <vector>
 
 using namespace ml;
 
@@ -89,7 +91,7 @@ core_t::TTime playData(core_t::TTime start,
 //! Helper class to look up a string in core::CStoredStringPtr set
 struct SLookup {
     std::size_t operator()(const std::string& key) const {
-        boost::hash<std::string> hasher;
+        core::CHashing::CWyHashString hasher;
         return hasher(key);
     }
 
@@ -98,18 +100,34 @@ struct SLookup {
     }
 };
 
+template<typename SHARDS>
+bool exists(const SHARDS& shards, const std::string& string) {
+    for (const auto& shard : shards) {
+        if (shard.s_Strings.find(string, ::SLookup(), ::SLookup()) !=
+            shard.s_Strings.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename SHARDS>
+std::vector<core::CStoredStringPtr> strings(const SHARDS& shards) {
+    std::vector<core::CStoredStringPtr> result;
+    for (const auto& shard : shards) {
+        result.insert(result.end(), shard.s_Strings.begin(), shard.s_Strings.end());
+    }
+    return result;
+}
+
 } // namespace
 
 bool CStringStoreTest::nameExists(const std::string& string) {
-    model::CStringStore::TStoredStringPtrUSet names =
-        model::CStringStore::names().m_Strings;
-    return names.find(string, ::SLookup(), ::SLookup()) != names.end();
+    return exists(model::CStringStore::names().m_Shards, string);
 }
 
 bool CStringStoreTest::influencerExists(const std::string& string) {
-    model::CStringStore::TStoredStringPtrUSet names =
-        model::CStringStore::influencers().m_Strings;
-    return names.find(string, ::SLookup(), ::SLookup()) != names.end();
+    return exists(model::CStringStore::influencers().m_Shards, string);
 }
 
 void CStringStoreTest::testPersonStringPruning() {
@@ -142,9 +160,9 @@ void CStringStoreTest::testPersonStringPruning() {
         model::CStringStore::names().clearEverythingTestOnly();
 
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::names().m_Strings.size());
+                             model::CStringStore::names().size());
 
         LOG_TRACE(<< "Setting up job");
 
@@ -164,7 +182,7 @@ void CStringStoreTest::testPersonStringPruning() {
 
         // No influencers in this configuration
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
 
         // "", "count", "max", "notes", "composer", "instrument", "Elgar", "Holst", "Delius", "flute", "tuba"
         CPPUNIT_ASSERT(this->nameExists("count"));
@@ -194,9 +212,9 @@ void CStringStoreTest::testPersonStringPruning() {
         model::CStringStore::names().clearEverythingTestOnly();
 
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::names().m_Strings.size());
+                             model::CStringStore::names().size());
 
         std::ostringstream outputStrm;
         ml::core::CJsonOutputStreamWrapper wrappedOutputStream(outputStrm);
@@ -209,7 +227,7 @@ void CStringStoreTest::testPersonStringPruning() {
 
         // No influencers in this configuration
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
 
         // "", "count", "max", "notes", "composer", "instrument", "Elgar", "Holst", "Delius", "flute", "tuba"
         CPPUNIT_ASSERT(this->nameExists("count"));
@@ -236,9 +254,9 @@ void CStringStoreTest::testPersonStringPruning() {
         model::CStringStore::names().clearEverythingTestOnly();
 
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::names().m_Strings.size());
+                             model::CStringStore::names().size());
 
         std::ostringstream outputStrm;
         ml::core::CJsonOutputStreamWrapper wrappedOutputStream(outputStrm);
@@ -251,7 +269,7 @@ void CStringStoreTest::testPersonStringPruning() {
 
         // No influencers in this configuration
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
 
         // While the 3 composers from the second partition should have been culled in the prune,
         // their names still exist in the first partition, so will still be in the string store
@@ -279,9 +297,9 @@ void CStringStoreTest::testPersonStringPruning() {
         model::CStringStore::names().clearEverythingTestOnly();
 
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::names().m_Strings.size());
+                             model::CStringStore::names().size());
 
         std::ostringstream outputStrm;
         ml::core::CJsonOutputStreamWrapper wrappedOutputStream(outputStrm);
@@ -294,7 +312,7 @@ void CStringStoreTest::testPersonStringPruning() {
 
         // No influencers in this configuration
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
 
         // One composer should have been culled!
         CPPUNIT_ASSERT(this->nameExists("count"));
@@ -340,9 +358,9 @@ void CStringStoreTest::testAttributeStringPruning() {
         model::CStringStore::names().clearEverythingTestOnly();
 
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::names().m_Strings.size());
+                             model::CStringStore::names().size());
 
         LOG_TRACE(<< "Setting up job");
         std::ostringstream outputStrm;
@@ -360,10 +378,11 @@ void CStringStoreTest::testAttributeStringPruning() {
 
         // No influencers in this configuration
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
 
         // "", "count", "distinct_count", "notes", "composer", "instrument", "Elgar", "Holst", "Delius", "flute", "tuba"
-        LOG_DEBUG(<< core::CContainerPrinter::print(model::CStringStore::names().m_Strings));
+        LOG_DEBUG(<< core::CContainerPrinter::print(
+                      strings(model::CStringStore::names().m_Shards)));
         CPPUNIT_ASSERT(this->nameExists("count"));
         CPPUNIT_ASSERT(this->nameExists("distinct_count"));
         CPPUNIT_ASSERT(this->nameExists("notes"));
@@ -389,9 +408,9 @@ void CStringStoreTest::testAttributeStringPruning() {
         model::CStringStore::names().clearEverythingTestOnly();
 
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::names().m_Strings.size());
+                             model::CStringStore::names().size());
 
         std::ostringstream outputStrm;
         ml::core::CJsonOutputStreamWrapper wrappedOutputStream(outputStrm);
@@ -405,7 +424,7 @@ void CStringStoreTest::testAttributeStringPruning() {
 
         // No influencers in this configuration
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
 
         // "", "count", "distinct_count", "notes", "composer", "instrument", "Elgar", "Holst", "Delius", "flute", "tuba"
         CPPUNIT_ASSERT(this->nameExists("count"));
@@ -432,9 +451,9 @@ void CStringStoreTest::testAttributeStringPruning() {
         model::CStringStore::names().clearEverythingTestOnly();
 
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::names().m_Strings.size());
+                             model::CStringStore::names().size());
 
         std::ostringstream outputStrm;
         ml::core::CJsonOutputStreamWrapper wrappedOutputStream(outputStrm);
@@ -448,7 +467,7 @@ void CStringStoreTest::testAttributeStringPruning() {
 
         // No influencers in this configuration
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
 
         // While the 3 composers from the second partition should have been culled in the prune,
         // their names still exist in the first partition, so will still be in the string store
@@ -476,9 +495,9 @@ void CStringStoreTest::testAttributeStringPruning() {
         model::CStringStore::names().clearEverythingTestOnly();
 
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::names().m_Strings.size());
+                             model::CStringStore::names().size());
 
         std::ostringstream outputStrm;
         ml::core::CJsonOutputStreamWrapper wrappedOutputStream(outputStrm);
@@ -492,7 +511,7 @@ void CStringStoreTest::testAttributeStringPruning() {
 
         // No influencers in this configuration
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
 
         // One composer should have been culled!
         CPPUNIT_ASSERT(this->nameExists("count"));
@@ -536,9 +555,9 @@ void CStringStoreTest::testInfluencerStringPruning() {
         model::CStringStore::names().clearEverythingTestOnly();
 
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::influencers().m_Strings.size());
+                             model::CStringStore::influencers().size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             model::CStringStore::names().m_Strings.size());
+                             model::CStringStore::names().size());
 
         LOG_TRACE(<< "Setting up job");
         std::ostringstream outputStrm;
@@ -551,9 +570,10 @@ void CStringStoreTest::testInfluencerStringPruning() {
         LOG_DEBUG(<< "Running 20 buckets");
         time = playData(time, BUCKET_SPAN, 20, 7, 5, 99, job);
 
-        LOG_TRACE(<< core::CContainerPrinter::print(model::CStringStore::names().m_Strings));
         LOG_TRACE(<< core::CContainerPrinter::print(
-                      model::CStringStore::influencers().m_Strings));
+                      strings(model::CStringStore::names().m_Shards)));
+        LOG_TRACE(<< core::CContainerPrinter::print(
+                      strings(model::CStringStore::influencers().m_Shards)));
 
         CPPUNIT_ASSERT(this->influencerExists("Delius"));
         CPPUNIT_ASSERT(this->influencerExists("Walton"));
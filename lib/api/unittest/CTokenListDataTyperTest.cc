@@ -63,6 +63,9 @@ CppUnit::Test* CTokenListDataTyperTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CTokenListDataTyperTest>(
         "CTokenListDataTyperTest::testPreTokenisedPerformance",
         &CTokenListDataTyperTest::testPreTokenisedPerformance));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTokenListDataTyperTest>(
+        "CTokenListDataTyperTest::testTokenisationPerformance",
+        &CTokenListDataTyperTest::testTokenisationPerformance));
 
     return suiteOfTests;
 }
@@ -472,3 +475,33 @@ void CTokenListDataTyperTest::testPreTokenisedPerformance() {
 
     CPPUNIT_ASSERT(preTokenisationTime <= inlineTokenisationTime);
 }
+
+void CTokenListDataTyperTest::testTokenisationPerformance() {
+    // Categorise a mix of messages whose tokens have mostly been seen
+    // before, which is the common case once a job is running.
+
+    static const size_t TEST_SIZE(100000);
+
+    const std::string messages[]{
+        "Vpxa: [49EC0B90 verbose 'VpxaHalCnxHostagent' opID=WFU-ddeadb59] [WaitForUpdatesDone] Received callback",
+        "Vpxa: [49EC0B90 verbose 'Default' opID=WFU-ddeadb59] [VpxaHalVmHostagent] 11: GuestInfo changed 'guest.disk",
+        " org.apache.coyote.http11.Http11BaseProtocol destroy",
+        "INFO  [co.elastic.settlement.synchronization.PaymentFlowProcessorImpl] Process payment flow "
+        "for tradeId=80894728 and backOfficeId=9354474",
+        "AUDIT  ; tomcat-http--39; ee763e95747c0b11d6b90f9bc8b54aaa77; REQ4e42023e0a0429a020000c6f0002aa33; "
+        "applnx811.elastic.co; ; Request Complete: /mlgw/mlb/ofaccounts/brokerageAccountHistory "
+        "[T=414ms,CUSTPREF-INS_PERSON_WEB_ACCT_PREFERENCES=298,MAUI-PSL04XD=108]"};
+    const std::size_t numberMessages(sizeof(messages) / sizeof(messages[0]));
+
+    TTokenListDataTyperKeepsFields typer(NO_REVERSE_SEARCH_CREATOR, 0.7, "whatever");
+
+    ml::core::CStopWatch stopWatch(true);
+    for (size_t count = 0; count < TEST_SIZE; ++count) {
+        const std::string& message = messages[count % numberMessages];
+        CPPUNIT_ASSERT_EQUAL(int(count % numberMessages) + 1,
+                             typer.computeType(false, message, message.length()));
+    }
+    uint64_t time(stopWatch.stop());
+
+    LOG_DEBUG(<< "Tokenisation test took " << time << "ms");
+}
@@ -23,6 +23,7 @@ public:
     void testLongReverseSearch();
     void testPreTokenised();
     void testPreTokenisedPerformance();
+    void testTokenisationPerformance();
 
     void setUp();
     void tearDown();
@@ -0,0 +1,246 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include <core/CAhoCorasickAutomaton.h>
+
+#include <core/CLogger.h>
+#include <core/CMemory.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace ml {
+namespace core {
+
+namespace {
+const uint32_t ROOT = 0;
+const uint32_t NO_CHILD = std::numeric_limits<uint32_t>::max();
+const uint32_t NO_ROW = std::numeric_limits<uint32_t>::max();
+const uint16_t START_SYMBOL = 256;
+const uint16_t END_SYMBOL = 257;
+const std::size_t NUMBER_SYMBOLS = 258;
+//! The maximum number of entries in the dense transition table
+//! beyond those for the root.
+const std::size_t MAX_DENSE_ENTRIES = 65536;
+
+//! \brief A trie node used while building the automaton.
+struct SBuildNode {
+    using TSymbolStatePr = std::pair<uint16_t, uint32_t>;
+    using TSymbolStatePrVec = std::vector<TSymbolStatePr>;
+
+    SBuildNode() : s_Match(false) {}
+
+    TSymbolStatePrVec s_Children;
+    bool s_Match;
+};
+
+using TBuildNodeVec = std::vector<SBuildNode>;
+
+uint16_t symbol(char c) {
+    return static_cast<uint16_t>(static_cast<unsigned char>(c));
+}
+
+//! Get the child of \p state labelled \p symbol in \p trie creating
+//! it if it doesn't exist.
+uint32_t extend(uint32_t state, uint16_t symbol, TBuildNodeVec& trie) {
+    SBuildNode::TSymbolStatePrVec& children = trie[state].s_Children;
+    auto i = std::lower_bound(children.begin(), children.end(),
+                              SBuildNode::TSymbolStatePr(symbol, 0));
+    if (i != children.end() && i->first == symbol) {
+        return i->second;
+    }
+    uint32_t result = static_cast<uint32_t>(trie.size());
+    children.insert(i, SBuildNode::TSymbolStatePr(symbol, result));
+    // Note that this invalidates children.
+    trie.emplace_back();
+    return result;
+}
+
+//! Add \p patterns with \p anchor to \p trie.
+void addPatterns(const CAhoCorasickAutomaton::TStrVec& patterns, int anchor, TBuildNodeVec& trie) {
+    for (const auto& pattern : patterns) {
+        uint32_t state = ROOT;
+        if (anchor & CAhoCorasickAutomaton::E_AnchoredStart) {
+            state = extend(state, START_SYMBOL, trie);
+        }
+        for (char c : pattern) {
+            state = extend(state, symbol(c), trie);
+        }
+        if (anchor & CAhoCorasickAutomaton::E_AnchoredEnd) {
+            state = extend(state, END_SYMBOL, trie);
+        }
+        trie[state].s_Match = true;
+    }
+}
+}
+
+CAhoCorasickAutomaton::CAhoCorasickAutomaton()
+    : m_Classes(), m_NumberClasses(0), m_Nodes(), m_Edges(), m_Dense() {
+}
+
+bool CAhoCorasickAutomaton::build(const TStrVec& fullPatterns,
+                                  const TStrVec& prefixPatterns,
+                                  const TStrVec& suffixPatterns,
+                                  const TStrVec& containsPatterns) {
+    this->clear();
+
+    TBuildNodeVec trie(1);
+    addPatterns(fullPatterns, E_AnchoredStartAndEnd, trie);
+    addPatterns(prefixPatterns, E_AnchoredStart, trie);
+    addPatterns(suffixPatterns, E_AnchoredEnd, trie);
+    addPatterns(containsPatterns, E_Unanchored, trie);
+
+    if (trie.size() >= NO_CHILD) {
+        LOG_ERROR(<< "Aho-Corasick automaton has " << trie.size()
+                  << " states, which exceeds the maximum of " << NO_CHILD);
+        return false;
+    }
+
+    // Pack the trie in breadth first order. Since children are visited
+    // in symbol order each state's edges end up sorted and the edges of
+    // successive states are contiguous.
+
+    TUInt32Vec order;
+    order.reserve(trie.size());
+    order.push_back(ROOT);
+    TUInt32Vec index(trie.size(), NO_CHILD);
+    index[ROOT] = 0;
+    m_Classes.assign(NUMBER_SYMBOLS, 0);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        for (const auto& child : trie[order[i]].s_Children) {
+            index[child.second] = static_cast<uint32_t>(order.size());
+            order.push_back(child.second);
+            m_Classes[child.first] = 1;
+        }
+    }
+
+    // Class zero comprises all symbols which don't appear in any pattern.
+    // The other classes are assigned in symbol order so the edges remain
+    // sorted.
+    m_NumberClasses = 1;
+    for (auto& symbolClass : m_Classes) {
+        if (symbolClass > 0) {
+            symbolClass = static_cast<uint16_t>(m_NumberClasses++);
+        }
+    }
+
+    m_Nodes.reserve(trie.size());
+    m_Edges.reserve(trie.size() - 1);
+    for (auto state : order) {
+        const SBuildNode& node = trie[state];
+        m_Nodes.push_back({static_cast<uint32_t>(m_Edges.size()),
+                           static_cast<uint32_t>(node.s_Children.size()),
+                           ROOT, NO_ROW, node.s_Match});
+        for (const auto& child : node.s_Children) {
+            m_Edges.push_back({m_Classes[child.first], index[child.second]});
+        }
+    }
+
+    m_Dense.assign(m_NumberClasses, ROOT);
+    for (uint32_t i = 0; i < m_Nodes[ROOT].s_NumberEdges; ++i) {
+        const SEdge& edge = m_Edges[m_Nodes[ROOT].s_FirstEdge + i];
+        m_Dense[edge.s_Class] = edge.s_Target;
+    }
+    m_Nodes[ROOT].s_DenseRow = 0;
+
+    // Compute the failure links. The failure link of any state is at a
+    // lower depth so, visiting states in breadth first order, all links
+    // needed to compute the current state's link are already available.
+    // This also means a state's match flag can be updated from the flag
+    // of its failure link.
+
+    for (uint32_t state = 0; state < m_Nodes.size(); ++state) {
+        const SNode& node = m_Nodes[state];
+        for (uint32_t i = 0; i < node.s_NumberEdges; ++i) {
+            const SEdge& edge = m_Edges[node.s_FirstEdge + i];
+            SNode& target = m_Nodes[edge.s_Target];
+            target.s_Fail = state == ROOT
+                                ? ROOT
+                                : this->transition(node.s_Fail, edge.s_Class);
+            target.s_Match = target.s_Match || m_Nodes[target.s_Fail].s_Match;
+        }
+    }
+
+    // Fill in the dense rows for the shallowest states. Again, the states
+    // needed to compute each row's transitions are filled in first.
+
+    std::size_t numberRows = std::min(MAX_DENSE_ENTRIES / m_NumberClasses,
+                                      m_Nodes.size() - 1);
+    m_Dense.reserve((numberRows + 1) * m_NumberClasses);
+    for (uint32_t state = 1; state <= numberRows; ++state) {
+        uint32_t row = static_cast<uint32_t>(m_Dense.size());
+        for (std::size_t i = 0; i < m_NumberClasses; ++i) {
+            m_Dense.push_back(this->transition(state, static_cast<uint16_t>(i)));
+        }
+        m_Nodes[state].s_DenseRow = row;
+    }
+
+    LOG_TRACE(<< "Built Aho-Corasick automaton with " << m_Nodes.size()
+              << " states and " << m_NumberClasses << " symbol classes");
+
+    return true;
+}
+
+bool CAhoCorasickAutomaton::matches(const std::string& key) const {
+    if (m_Nodes.empty()) {
+        return false;
+    }
+
+    uint32_t state = this->transition(ROOT, m_Classes[START_SYMBOL]);
+    if (m_Nodes[state].s_Match) {
+        return true;
+    }
+    for (char c : key) {
+        state = this->transition(state, m_Classes[symbol(c)]);
+        if (m_Nodes[state].s_Match) {
+            return true;
+        }
+    }
+    state = this->transition(state, m_Classes[END_SYMBOL]);
+    return m_Nodes[state].s_Match;
+}
+
+void CAhoCorasickAutomaton::clear() {
+    m_Classes.clear();
+    m_NumberClasses = 0;
+    m_Nodes.clear();
+    m_Edges.clear();
+    m_Dense.clear();
+}
+
+std::size_t CAhoCorasickAutomaton::numberStates() const {
+    return m_Nodes.size();
+}
+
+std::size_t CAhoCorasickAutomaton::memoryUsage() const {
+    return CMemory::dynamicSize(m_Classes) + CMemory::dynamicSize(m_Nodes) +
+           CMemory::dynamicSize(m_Edges) + CMemory::dynamicSize(m_Dense);
+}
+
+uint32_t CAhoCorasickAutomaton::transition(uint32_t state, uint16_t symbolClass) const {
+    for (;;) {
+        const SNode& node = m_Nodes[state];
+        if (node.s_DenseRow != NO_ROW) {
+            return m_Dense[node.s_DenseRow + symbolClass];
+        }
+        uint32_t next = this->child(state, symbolClass);
+        if (next != NO_CHILD) {
+            return next;
+        }
+        state = node.s_Fail;
+    }
+}
+
+uint32_t CAhoCorasickAutomaton::child(uint32_t state, uint16_t symbolClass) const {
+    const SNode& node = m_Nodes[state];
+    auto begin = m_Edges.begin() + node.s_FirstEdge;
+    auto end = begin + node.s_NumberEdges;
+    auto i = std::lower_bound(begin, end, symbolClass);
+    return i != end && i->s_Class == symbolClass ? i->s_Target : NO_CHILD;
+}
+}
+}
@@ -12,18 +12,77 @@
 
 #include <boost/bind.hpp>
 #include <boost/config.hpp>
+#include <boost/endian/conversion.hpp>
 #include <boost/random/uniform_int_distribution.hpp>
 #include <boost/ref.hpp>
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
 namespace ml {
 namespace core {
 
 namespace {
 
 using TUniform32 = boost::random::uniform_int_distribution<uint32_t>;
+
+// The wyhash mixing constants.
+const uint64_t WY_P0 = 0xa0761d6478bd642full;
+const uint64_t WY_P1 = 0xe7037ed1a0b428dbull;
+const uint64_t WY_P2 = 0x8ebc6af09c88c6e3ull;
+const uint64_t WY_P3 = 0x589965cc75374cc3ull;
+
+//! Compute the 128 bit product of \p a and \p b and fold it to 64 bits.
+inline uint64_t wyMix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high;
+    uint64_t low = _umul128(a, b, &high);
+    return low ^ high;
+#else
+    uint64_t aHigh = a >> 32;
+    uint64_t aLow = a & 0xffffffff;
+    uint64_t bHigh = b >> 32;
+    uint64_t bLow = b & 0xffffffff;
+    uint64_t middle1 = aHigh * bLow;
+    uint64_t middle2 = aLow * bHigh;
+    uint64_t low = aLow * bLow;
+    uint64_t high = aHigh * bHigh;
+    uint64_t sum = low + (middle1 << 32);
+    high += sum < low ? 1 : 0;
+    low = sum + (middle2 << 32);
+    high += low < sum ? 1 : 0;
+    high += (middle1 >> 32) + (middle2 >> 32);
+    return low ^ high;
+#endif
+}
+
+//! Read 8 bytes from \p data as a little endian integer.
+inline uint64_t wyRead64(const unsigned char* data) {
+    uint64_t result;
+    std::memcpy(&result, data, sizeof(result));
+    return boost::endian::little_to_native(result);
+}
+
+//! Read 4 bytes from \p data as a little endian integer.
+inline uint64_t wyRead32(const unsigned char* data) {
+    uint32_t result;
+    std::memcpy(&result, data, sizeof(result));
+    return boost::endian::little_to_native(result);
+}
+
+//! Read between 1 and 3 bytes from \p data.
+inline uint64_t wyRead3(const unsigned char* data, std::size_t length) {
+    return (static_cast<uint64_t>(data[0]) << 16) |
+           (static_cast<uint64_t>(data[length >> 1]) << 8) | data[length - 1];
+}
 }
 
 const uint64_t CHashing::CUniversalHash::BIG_PRIME = 4294967291ull;
@@ -510,6 +569,56 @@ uint64_t CHashing::safeMurmurHash64(const void* key, int length, uint64_t seed)
     return h;
 }
 
+uint64_t CHashing::wyHash64(const void* key, int length, uint64_t seed) {
+    const unsigned char* data = static_cast<const unsigned char*>(key);
+    std::size_t remainder = static_cast<std::size_t>(length);
+
+    seed ^= WY_P0;
+
+    uint64_t a;
+    uint64_t b;
+    if (remainder <= 16) {
+        if (remainder >= 4) {
+            // Read two possibly overlapping pairs of 4 byte blocks which
+            // between them cover the whole key.
+            std::size_t offset = (remainder >> 3) << 2;
+            a = (wyRead32(data) << 32) | wyRead32(data + offset);
+            b = (wyRead32(data + remainder - 4) << 32) |
+                wyRead32(data + remainder - 4 - offset);
+        } else if (remainder > 0) {
+            a = wyRead3(data, remainder);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        if (remainder > 48) {
+            // Use three independent lanes so the multiplications can be
+            // pipelined.
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do {
+                seed = wyMix(wyRead64(data) ^ WY_P1, wyRead64(data + 8) ^ seed);
+                seed1 = wyMix(wyRead64(data + 16) ^ WY_P2, wyRead64(data + 24) ^ seed1);
+                seed2 = wyMix(wyRead64(data + 32) ^ WY_P3, wyRead64(data + 40) ^ seed2);
+                data += 48;
+                remainder -= 48;
+            } while (remainder > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (remainder > 16) {
+            seed = wyMix(wyRead64(data) ^ WY_P1, wyRead64(data + 8) ^ seed);
+            data += 16;
+            remainder -= 16;
+        }
+        // The last 16 bytes of the key, which may overlap the last block.
+        a = wyRead64(data + remainder - 16);
+        b = wyRead64(data + remainder - 8);
+    }
+
+    return wyMix(WY_P1 ^ static_cast<uint64_t>(length), wyMix(a ^ WY_P1, b ^ seed));
+}
+
 uint32_t CHashing::hashCombine(uint32_t seed, uint32_t h) {
     static const uint32_t C = 0x9e3779b9;
     seed ^= h + C + (seed << 6) + (seed >> 2);
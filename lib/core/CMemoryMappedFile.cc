@@ -0,0 +1,116 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include <core/CMemoryMappedFile.h>
+
+#include <core/CLogger.h>
+#include <core/COsFileFuncs.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ml {
+namespace core {
+
+CMemoryMappedFile::CMemoryMappedFile() : m_Fd(-1), m_Data(nullptr), m_Size(0) {
+}
+
+CMemoryMappedFile::~CMemoryMappedFile() {
+    this->close();
+}
+
+bool CMemoryMappedFile::open(const std::string& fileName, std::size_t size) {
+    if (this->isOpen()) {
+        LOG_ERROR(<< "Can't open " << fileName << ": " << m_FileName << " is already open");
+        return false;
+    }
+
+    m_Fd = COsFileFuncs::open(fileName.c_str(),
+                              COsFileFuncs::CREAT | COsFileFuncs::EXCL | COsFileFuncs::RDWR,
+                              S_IRUSR | S_IWUSR);
+    if (m_Fd == -1) {
+        LOG_ERROR(<< "Unable to create " << fileName << ": " << ::strerror(errno));
+        return false;
+    }
+    m_FileName = fileName;
+
+    if (this->resize(size) == false) {
+        this->close();
+        return false;
+    }
+
+    return true;
+}
+
+bool CMemoryMappedFile::resize(std::size_t size) {
+    if (m_Fd == -1) {
+        LOG_ERROR(<< "Can't resize a file which isn't open");
+        return false;
+    }
+    if (size <= m_Size) {
+        return true;
+    }
+
+    // Extend the file by writing its last byte.
+    if (COsFileFuncs::lseek(m_Fd, static_cast<COsFileFuncs::TOffset>(size - 1), SEEK_SET) == -1 ||
+        COsFileFuncs::write(m_Fd, "", 1) != 1) {
+        LOG_ERROR(<< "Unable to extend " << m_FileName << " to " << size
+                  << " bytes: " << ::strerror(errno));
+        return false;
+    }
+
+    void* data{::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_Fd, 0)};
+    if (data == MAP_FAILED) {
+        LOG_ERROR(<< "Unable to map " << size << " bytes of " << m_FileName
+                  << ": " << ::strerror(errno));
+        return false;
+    }
+
+    if (m_Data != nullptr) {
+        ::munmap(m_Data, m_Size);
+    }
+    m_Data = static_cast<char*>(data);
+    m_Size = size;
+
+    return true;
+}
+
+void CMemoryMappedFile::close() {
+    if (m_Data != nullptr) {
+        ::munmap(m_Data, m_Size);
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+    if (m_Fd != -1) {
+        COsFileFuncs::close(m_Fd);
+        m_Fd = -1;
+        if (::unlink(m_FileName.c_str()) == -1) {
+            LOG_WARN(<< "Unable to delete " << m_FileName << ": " << ::strerror(errno));
+        }
+        m_FileName.clear();
+    }
+}
+
+bool CMemoryMappedFile::isOpen() const {
+    return m_Data != nullptr;
+}
+
+std::size_t CMemoryMappedFile::size() const {
+    return m_Size;
+}
+
+char* CMemoryMappedFile::data() {
+    return m_Data;
+}
+
+const char* CMemoryMappedFile::data() const {
+    return m_Data;
+}
+}
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include <core/CMemoryMappedFile.h>
+
+#include <core/CLogger.h>
+#include <core/CWindowsError.h>
+
+namespace ml {
+namespace core {
+
+CMemoryMappedFile::CMemoryMappedFile()
+    : m_File(INVALID_HANDLE_VALUE), m_Mapping(nullptr), m_Data(nullptr), m_Size(0) {
+}
+
+CMemoryMappedFile::~CMemoryMappedFile() {
+    this->close();
+}
+
+bool CMemoryMappedFile::open(const std::string& fileName, std::size_t size) {
+    if (this->isOpen()) {
+        LOG_ERROR(<< "Can't open " << fileName << ": " << m_FileName << " is already open");
+        return false;
+    }
+
+    // The file is deleted by the operating system when the handle is closed.
+    m_File = CreateFile(fileName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                        CREATE_NEW, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+                        nullptr);
+    if (m_File == INVALID_HANDLE_VALUE) {
+        LOG_ERROR(<< "Unable to create " << fileName << ": " << CWindowsError());
+        return false;
+    }
+    m_FileName = fileName;
+
+    if (this->resize(size) == false) {
+        this->close();
+        return false;
+    }
+
+    return true;
+}
+
+bool CMemoryMappedFile::resize(std::size_t size) {
+    if (m_File == INVALID_HANDLE_VALUE) {
+        LOG_ERROR(<< "Can't resize a file which isn't open");
+        return false;
+    }
+    if (size <= m_Size) {
+        return true;
+    }
+
+    // Creating a mapping larger than the file extends the file.
+    ULARGE_INTEGER mappingSize;
+    mappingSize.QuadPart = size;
+    HANDLE mapping{CreateFileMapping(m_File, nullptr, PAGE_READWRITE, mappingSize.HighPart,
+                                     mappingSize.LowPart, nullptr)};
+    if (mapping == nullptr) {
+        LOG_ERROR(<< "Unable to extend " << m_FileName << " to " << size
+                  << " bytes: " << CWindowsError());
+        return false;
+    }
+
+    void* data{MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size)};
+    if (data == nullptr) {
+        LOG_ERROR(<< "Unable to map " << size << " bytes of " << m_FileName
+                  << ": " << CWindowsError());
+        CloseHandle(mapping);
+        return false;
+    }
+
+    if (m_Data != nullptr) {
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+    }
+    m_Mapping = mapping;
+    m_Data = static_cast<char*>(data);
+    m_Size = size;
+
+    return true;
+}
+
+void CMemoryMappedFile::close() {
+    if (m_Data != nullptr) {
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+    if (m_File != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_File);
+        m_File = INVALID_HANDLE_VALUE;
+        m_FileName.clear();
+    }
+}
+
+bool CMemoryMappedFile::isOpen() const {
+    return m_Data != nullptr;
+}
+
+std::size_t CMemoryMappedFile::size() const {
+    return m_Size;
+}
+
+char* CMemoryMappedFile::data() {
+    return m_Data;
+}
+
+const char* CMemoryMappedFile::data() const {
+    return m_Data;
+}
+}
+}
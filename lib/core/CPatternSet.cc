@@ -6,14 +6,11 @@
 
 #include <core/CPatternSet.h>
 
-#include <core/CContainerPrinter.h>
 #include <core/CLogger.h>
 
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
 
-#include <algorithm>
-
 namespace ml {
 namespace core {
 
@@ -21,9 +18,7 @@ namespace {
 const char WILDCARD = '*';
 }
 
-CPatternSet::CPatternSet()
-    : m_FullMatchPatterns(), m_PrefixPatterns(), m_SuffixPatterns(),
-      m_ContainsPatterns() {
+CPatternSet::CPatternSet() : m_Patterns() {
 }
 
 bool CPatternSet::initFromJson(const std::string& json) {
@@ -61,8 +56,7 @@ bool CPatternSet::initFromJson(const std::string& json) {
                 std::string middle = pattern.substr(1, length - 2);
                 containsPatterns.push_back(middle);
             } else if (length > 1) {
-                std::string suffix = pattern.substr(1);
-                suffixPatterns.push_back(std::string(suffix.rbegin(), suffix.rend()));
+                suffixPatterns.push_back(pattern.substr(1));
             }
         } else if (length > 1 && pattern[length - 1] == WILDCARD) {
             prefixPatterns.push_back(pattern.substr(0, length - 1));
@@ -71,44 +65,19 @@ bool CPatternSet::initFromJson(const std::string& json) {
         }
     }
 
-    this->sortAndPruneDuplicates(fullPatterns);
-    this->sortAndPruneDuplicates(prefixPatterns);
-    this->sortAndPruneDuplicates(suffixPatterns);
-    this->sortAndPruneDuplicates(containsPatterns);
-    return m_FullMatchPatterns.build(fullPatterns) &&
-           m_PrefixPatterns.build(prefixPatterns) &&
-           m_SuffixPatterns.build(suffixPatterns) &&
-           m_ContainsPatterns.build(containsPatterns);
-}
-
-void CPatternSet::sortAndPruneDuplicates(TStrVec& keys) {
-    std::sort(keys.begin(), keys.end());
-    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return m_Patterns.build(fullPatterns, prefixPatterns, suffixPatterns, containsPatterns);
 }
 
 bool CPatternSet::contains(const std::string& key) const {
-    if (m_PrefixPatterns.matchesStart(key)) {
-        return true;
-    }
-    if (m_SuffixPatterns.matchesStart(key.rbegin(), key.rend())) {
-        return true;
-    }
-    if (m_FullMatchPatterns.matchesFully(key)) {
-        return true;
-    }
-    for (TStrCItr keyItr = key.begin(); keyItr != key.end(); ++keyItr) {
-        if (m_ContainsPatterns.matchesStart(keyItr, key.end())) {
-            return true;
-        }
-    }
-    return false;
+    return m_Patterns.matches(key);
 }
 
 void CPatternSet::clear() {
-    m_FullMatchPatterns.clear();
-    m_PrefixPatterns.clear();
-    m_SuffixPatterns.clear();
-    m_ContainsPatterns.clear();
+    m_Patterns.clear();
+}
+
+std::size_t CPatternSet::memoryUsage() const {
+    return m_Patterns.memoryUsage();
 }
 }
 }
@@ -195,9 +195,13 @@ bool CRegex::search(size_t startPos, const std::string& str, size_t& position, s
     }
 
     try {
+        // When starting part way through the string the preceding character
+        // is still context for assertions such as ^ and \b.
         boost::smatch matches;
         if (boost::regex_search(str.begin() + startPos, str.begin() + str.length(),
-                                matches, m_Regex) == false) {
+                                matches, m_Regex,
+                                startPos > 0 ? boost::match_prev_avail
+                                             : boost::match_default) == false) {
             return false;
         }
 
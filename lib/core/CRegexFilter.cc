@@ -7,14 +7,79 @@
 
 #include <core/CLogger.h>
 
+#include <ctype.h>
+
 namespace ml {
 namespace core {
 
-CRegexFilter::CRegexFilter() : m_Regex() {
+namespace {
+
+//! Get the position after the bracket expression starting at \p i
+//! of \p regex or std::string::npos if it isn't terminated.
+std::size_t skipBracketExpression(const std::string& regex, std::size_t i) {
+    // A ']' immediately after the opening bracket, or after a negating
+    // '^', is a literal.
+    std::size_t j = i + 1;
+    if (j < regex.length() && regex[j] == '^') {
+        ++j;
+    }
+    if (j < regex.length() && regex[j] == ']') {
+        ++j;
+    }
+    for (/**/; j < regex.length(); ++j) {
+        if (regex[j] == ']') {
+            return j + 1;
+        }
+        if (regex[j] == '\\') {
+            ++j;
+        } else if (regex.compare(j, 2, "[:") == 0) {
+            j = regex.find(":]", j + 2);
+            if (j == std::string::npos) {
+                break;
+            }
+            ++j;
+        }
+    }
+    return std::string::npos;
+}
+
+//! Get the position after the group starting at \p i of \p regex or
+//! std::string::npos if it isn't terminated.
+std::size_t skipGroup(const std::string& regex, std::size_t i) {
+    std::size_t depth = 0;
+    for (std::size_t j = i; j < regex.length(); /**/) {
+        switch (regex[j]) {
+        case '\\':
+            j += 2;
+            break;
+        case '[':
+            j = skipBracketExpression(regex, j);
+            break;
+        case '(':
+            ++depth;
+            ++j;
+            break;
+        case ')':
+            if (--depth == 0) {
+                return j + 1;
+            }
+            ++j;
+            break;
+        default:
+            ++j;
+            break;
+        }
+    }
+    return std::string::npos;
+}
+}
+
+CRegexFilter::CRegexFilter() : m_Regex(), m_RequiredLiterals() {
 }
 
 bool CRegexFilter::configure(const TStrVec& regularExpressions) {
     m_Regex.clear();
+    m_RequiredLiterals.clear();
     m_Regex.resize(regularExpressions.size());
     for (std::size_t i = 0; i < regularExpressions.size(); ++i) {
         if (m_Regex[i].init(regularExpressions[i]) == false) {
@@ -24,28 +89,165 @@ bool CRegexFilter::configure(const TStrVec& regularExpressions) {
         }
     }
 
+    m_RequiredLiterals.reserve(regularExpressions.size());
+    for (const auto& regex : regularExpressions) {
+        m_RequiredLiterals.push_back(requiredLiteral(regex));
+        LOG_TRACE(<< "Required literal for '" << regex << "' is '"
+                  << m_RequiredLiterals.back() << "'");
+    }
+
     return true;
 }
 
 std::string CRegexFilter::apply(const std::string& target) const {
-    if (m_Regex.empty()) {
-        return target;
-    }
+    std::string result;
+    this->apply(target, result);
+    return result;
+}
+
+void CRegexFilter::apply(const std::string& target, std::string& result) const {
+    result = target;
 
-    std::string result(target);
     std::size_t position = 0;
     std::size_t length = 0;
     for (std::size_t i = 0; i < m_Regex.size(); ++i) {
         const CRegex& currentRegex = m_Regex[i];
-        while (currentRegex.search(result, position, length)) {
-            result.erase(position, length);
+        const std::string& literal = m_RequiredLiterals[i];
+        std::size_t start = 0;
+        while (result.find(literal, start) != std::string::npos &&
+               currentRegex.search(start, result, position, length)) {
+            if (length == 0) {
+                // Skip empty matches or we'd never terminate.
+                start = position + 1;
+            } else {
+                result.erase(position, length);
+                start = 0;
+            }
         }
     }
-    return result;
 }
 
 bool CRegexFilter::empty() const {
     return m_Regex.empty();
 }
+
+std::string CRegexFilter::requiredLiteral(const std::string& regex) {
+    // We look for the longest run of consecutive atoms which are literal
+    // characters and must occur exactly once, ending a run at anything
+    // else. Groups are skipped entirely, so alternation in a group can't
+    // affect the result, but top level alternation means no literal is
+    // required.
+
+    std::string result;
+    std::string run;
+    auto endRun = [&result, &run]() {
+        if (run.length() > result.length()) {
+            result.swap(run);
+        }
+        run.clear();
+    };
+
+    for (std::size_t i = 0; i < regex.length(); /**/) {
+        char literal = regex[i];
+        bool isLiteral = false;
+        std::size_t next = i + 1;
+        switch (regex[i]) {
+        case '\\':
+            if (next == regex.length()) {
+                return std::string();
+            }
+            literal = regex[next++];
+            if (::isalnum(static_cast<unsigned char>(literal)) != 0) {
+                if (std::string("dDwWsSbB").find(literal) == std::string::npos) {
+                    // Other escapes may comprise several characters or, like
+                    // \Q, change the meaning of those which follow.
+                    return std::string();
+                }
+            } else if (std::string("<>`'").find(literal) == std::string::npos) {
+                // These are word and buffer boundary assertions.
+                isLiteral = true;
+            }
+            break;
+        case '[':
+            next = skipBracketExpression(regex, i);
+            break;
+        case '(':
+            if (regex.compare(i, 2, "(?") == 0 && regex.compare(i, 3, "(?:") != 0) {
+                // Modifiers, lookaround, named groups, etc.
+                return std::string();
+            }
+            next = skipGroup(regex, i);
+            break;
+        case '.':
+        case '^':
+        case '$':
+            break;
+        case '|':
+        case ')':
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            return std::string();
+        default:
+            isLiteral = true;
+            break;
+        }
+        if (next == std::string::npos) {
+            return std::string();
+        }
+
+        bool optional = false;
+        bool repeated = false;
+        if (next < regex.length()) {
+            switch (regex[next]) {
+            case '*':
+            case '?':
+                optional = true;
+                ++next;
+                break;
+            case '+':
+                repeated = true;
+                ++next;
+                break;
+            case '{':
+                if (next + 1 == regex.length() ||
+                    ::isdigit(static_cast<unsigned char>(regex[next + 1])) == 0) {
+                    return std::string();
+                }
+                optional = regex[next + 1] == '0';
+                repeated = !optional;
+                next = regex.find('}', next);
+                if (next == std::string::npos) {
+                    return std::string();
+                }
+                ++next;
+                break;
+            default:
+                break;
+            }
+            if ((optional || repeated) && next < regex.length() &&
+                (regex[next] == '?' || regex[next] == '+')) {
+                // Lazy or possessive quantifier.
+                ++next;
+            }
+        }
+
+        if (isLiteral && !optional) {
+            run += literal;
+            if (repeated) {
+                // The last repetition is adjacent to whatever follows.
+                endRun();
+                run += literal;
+            }
+        } else {
+            endRun();
+        }
+        i = next;
+    }
+    endRun();
+
+    return result;
+}
 }
 }
@@ -0,0 +1,85 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include <core/CStaticThreadPool.h>
+
+#include <core/CLogger.h>
+
+#include <algorithm>
+
+namespace ml {
+namespace core {
+
+CStaticThreadPool::CStaticThreadPool(std::size_t threads) : m_Done{false} {
+    threads = std::max(threads, std::size_t(1));
+    m_Workers.reserve(threads);
+    for (std::size_t i = 0u; i < threads; ++i) {
+        m_Workers.emplace_back([this]() { this->worker(); });
+    }
+}
+
+CStaticThreadPool::~CStaticThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock{m_Mutex};
+        m_Done = true;
+    }
+    m_Condition.notify_all();
+    for (auto& worker : m_Workers) {
+        worker.join();
+    }
+}
+
+std::size_t CStaticThreadPool::numberThreads() const {
+    return m_Workers.size();
+}
+
+void CStaticThreadPool::schedule(TTask task) {
+    {
+        std::unique_lock<std::mutex> lock{m_Mutex};
+        m_Tasks.push_back(std::move(task));
+    }
+    m_Condition.notify_one();
+}
+
+void CStaticThreadPool::startDefault(std::size_t threads) {
+    stopDefault();
+    if (threads > 0) {
+        LOG_DEBUG(<< "Starting default thread pool with " << threads << " threads");
+        ms_Default = std::make_unique<CStaticThreadPool>(threads);
+    }
+}
+
+void CStaticThreadPool::stopDefault() {
+    ms_Default.reset();
+}
+
+bool CStaticThreadPool::defaultRunning() {
+    return ms_Default != nullptr;
+}
+
+std::size_t CStaticThreadPool::defaultNumberThreads() {
+    return ms_Default != nullptr ? ms_Default->numberThreads() : 0;
+}
+
+void CStaticThreadPool::worker() {
+    for (;;) {
+        TTask task;
+        {
+            std::unique_lock<std::mutex> lock{m_Mutex};
+            m_Condition.wait(lock, [this]() { return m_Done || !m_Tasks.empty(); });
+            if (m_Tasks.empty()) {
+                // We only get here once we're done and the queue is drained.
+                return;
+            }
+            task = std::move(m_Tasks.front());
+            m_Tasks.pop_front();
+        }
+        task();
+    }
+}
+
+CStaticThreadPool::TStaticThreadPoolUPtr CStaticThreadPool::ms_Default;
+}
+}
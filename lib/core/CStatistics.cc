@@ -190,6 +190,54 @@ std::ostream& operator<<(std::ostream& o, const CStatistics& /*stats*/) {
                  "The number of old people or attributes pruned from the models",
                  CStatistics::stat(stat_t::E_NumberPrunedItems).value());
 
+    addStringInt(writer, "E_ModelPlotTime",
+                 "The total time in milliseconds spent generating model plots",
+                 CStatistics::stat(stat_t::E_ModelPlotTime).value());
+
+    addStringInt(writer, "E_NumberPeriodicityTests",
+                 "The number of tests for seasonal components which have been run",
+                 CStatistics::stat(stat_t::E_NumberPeriodicityTests).value());
+
+    addStringInt(writer, "E_PeriodicityTestTime",
+                 "The total time in microseconds spent testing for seasonal components",
+                 CStatistics::stat(stat_t::E_PeriodicityTestTime).value());
+
+    addStringInt(writer, "E_NumberPredictionCacheHits",
+                 "The number of decomposition predictions served from the cache",
+                 CStatistics::stat(stat_t::E_NumberPredictionCacheHits).value());
+
+    addStringInt(writer, "E_NumberPredictionCacheMisses",
+                 "The number of decomposition predictions which were recomputed",
+                 CStatistics::stat(stat_t::E_NumberPredictionCacheMisses).value());
+
+    addStringInt(writer, "E_NumberInfluenceProbabilityCacheHits",
+                 "The number of influence probabilities served from the cache",
+                 CStatistics::stat(stat_t::E_NumberInfluenceProbabilityCacheHits).value());
+
+    addStringInt(writer, "E_NumberInfluenceProbabilityCacheMisses",
+                 "The number of influence probabilities which were computed",
+                 CStatistics::stat(stat_t::E_NumberInfluenceProbabilityCacheMisses).value());
+
+    addStringInt(writer, "E_NumberModelHibernations",
+                 "The number of person models which started hibernating",
+                 CStatistics::stat(stat_t::E_NumberModelHibernations).value());
+
+    addStringInt(writer, "E_NumberModelWakes",
+                 "The number of hibernating person models which were restored",
+                 CStatistics::stat(stat_t::E_NumberModelWakes).value());
+
+    addStringInt(writer, "E_ModelWakeTime",
+                 "The time in microseconds spent restoring hibernating person models",
+                 CStatistics::stat(stat_t::E_ModelWakeTime).value());
+
+    addStringInt(writer, "E_NumberModelPageOuts",
+                 "The number of hibernating model states paged out to disk",
+                 CStatistics::stat(stat_t::E_NumberModelPageOuts).value());
+
+    addStringInt(writer, "E_NumberModelPageIns",
+                 "The number of hibernating model states read back from disk",
+                 CStatistics::stat(stat_t::E_NumberModelPageIns).value());
+
     writer.EndArray();
     writeStream.Flush();
 
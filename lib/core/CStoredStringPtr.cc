@@ -14,6 +14,17 @@
 namespace ml {
 namespace core {
 
+CStoredStringPtr::CWeakPtr::CWeakPtr() noexcept : m_String{} {
+}
+
+CStoredStringPtr::CWeakPtr::CWeakPtr(const CStoredStringPtr& ptr) noexcept
+    : m_String{ptr.m_String} {
+}
+
+bool CStoredStringPtr::CWeakPtr::expired() const noexcept {
+    return m_String.expired();
+}
+
 CStoredStringPtr::CStoredStringPtr() noexcept : m_String{} {
 }
 
@@ -11,7 +11,9 @@
 #include <core/CStrCaseCmp.h>
 #include <core/CStringUtils.h>
 
+#include <algorithm>
 #include <fstream>
+#include <numeric>
 
 #include <ctype.h>
 
@@ -21,6 +23,56 @@ namespace core {
 namespace {
 
 const char PART_OF_SPEECH_SEPARATOR('@');
+//! The average number of words hashed to each bucket of seeds.
+const std::size_t WORDS_PER_BUCKET(4);
+//! The largest seed to try when placing a bucket's words.
+const uint32_t MAX_SEED(1 << 20);
+//! The maximum number of times to grow the table if compiling fails.
+const std::size_t MAX_COMPILE_ATTEMPTS(5);
+
+//! Convert an ASCII letter to lower case.
+char toLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+//! The MurmurHash3 64 bit finaliser.
+uint64_t mix(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+//! Hash \p str ignoring case.
+uint64_t hashIgnoreCase(const std::string& str) {
+    // FNV-1a, which is cheap for short strings, with a final mix so the
+    // low bits are good enough to take modulo the table size.
+    uint64_t hash(0xcbf29ce484222325ULL);
+    for (char c : str) {
+        hash ^= static_cast<unsigned char>(toLower(c));
+        hash *= 0x100000001b3ULL;
+    }
+    return mix(hash);
+}
+
+//! Get the slot of a word with hash \p hash for \p seed.
+std::size_t slotFor(uint64_t hash, uint32_t seed, std::size_t numberSlots) {
+    return static_cast<std::size_t>(mix(hash ^ (seed * 0x9e3779b97f4a7c15ULL))) &
+           (numberSlots - 1);
+}
+
+//! Check if \p lhs, of the same length as \p rhs, equals \p rhs
+//! ignoring case.
+bool equalIgnoreCase(const char* lhs, const std::string& rhs) {
+    for (char c : rhs) {
+        if (*lhs++ != toLower(c)) {
+            return false;
+        }
+    }
+    return true;
+}
 
 CWordDictionary::EPartOfSpeech partOfSpeechFromCode(char partOfSpeechCode) {
     // These codes are taken from the readme file that comes with Moby
@@ -88,15 +140,21 @@ const CWordDictionary& CWordDictionary::instance() {
 }
 
 bool CWordDictionary::isInDictionary(const std::string& str) const {
-    return m_DictionaryWords.find(str) != m_DictionaryWords.end();
+    return this->partOfSpeech(str) != E_NotInDictionary;
 }
 
 CWordDictionary::EPartOfSpeech CWordDictionary::partOfSpeech(const std::string& str) const {
-    TStrUMapCItr iter = m_DictionaryWords.find(str);
-    if (iter == m_DictionaryWords.end()) {
+    if (m_Entries.empty()) {
+        return E_NotInDictionary;
+    }
+    // Empty slots have zero length and E_NotInDictionary so need no
+    // special handling.
+    const SEntry& entry(m_Entries[this->slot(hashIgnoreCase(str))]);
+    if (entry.s_Length != str.length() ||
+        equalIgnoreCase(m_Words.data() + entry.s_Offset, str) == false) {
         return E_NotInDictionary;
     }
-    return iter->second;
+    return entry.s_PartOfSpeech;
 }
 
 CWordDictionary::CWordDictionary() {
@@ -108,6 +166,7 @@ CWordDictionary::CWordDictionary() {
     if (ifs.is_open()) {
         LOG_DEBUG(<< "Populating word dictionary from file " << fileToLoad);
 
+        TStrUMap words;
         std::string word;
         while (std::getline(ifs, word)) {
             CStringUtils::trimWhitespace(word);
@@ -135,10 +194,28 @@ CWordDictionary::CWordDictionary() {
                 continue;
             }
             word.erase(sepPos);
-            m_DictionaryWords[word] = partOfSpeech;
+            words[word] = partOfSpeech;
+        }
+
+        // The table sizes are powers of two so slots and buckets can be
+        // computed by masking rather than division.
+        std::size_t numberSlots(1);
+        while (4 * numberSlots < 5 * words.size()) {
+            numberSlots *= 2;
+        }
+        std::size_t attempt(0);
+        while (this->compile(words, numberSlots) == false) {
+            if (++attempt == MAX_COMPILE_ATTEMPTS) {
+                LOG_ERROR(<< "Failed to compile word dictionary");
+                m_Words.clear();
+                m_Seeds.clear();
+                m_Entries.clear();
+                return;
+            }
+            numberSlots *= 2;
         }
 
-        LOG_DEBUG(<< "Populated word dictionary with " << m_DictionaryWords.size() << " words");
+        LOG_DEBUG(<< "Populated word dictionary with " << words.size() << " words");
     } else {
         LOG_ERROR(<< "Failed to open dictionary file " << fileToLoad);
     }
@@ -148,6 +225,80 @@ CWordDictionary::~CWordDictionary() {
     ms_Instance = nullptr;
 }
 
+bool CWordDictionary::compile(const TStrUMap& words, std::size_t numberSlots) {
+    using TUInt64StrUMapCItrPr = std::pair<uint64_t, TStrUMap::const_iterator>;
+    using TUInt64StrUMapCItrPrVec = std::vector<TUInt64StrUMapCItrPr>;
+    using TUInt64StrUMapCItrPrVecVec = std::vector<TUInt64StrUMapCItrPrVec>;
+    using TSizeVec = std::vector<std::size_t>;
+
+    std::size_t numberBuckets(1);
+    while (numberBuckets * WORDS_PER_BUCKET < words.size()) {
+        numberBuckets *= 2;
+    }
+    TUInt64StrUMapCItrPrVecVec buckets(numberBuckets);
+    for (auto i = words.begin(); i != words.end(); ++i) {
+        uint64_t hash(hashIgnoreCase(i->first));
+        buckets[hash & (numberBuckets - 1)].emplace_back(hash, i);
+    }
+
+    // Place the largest buckets first while there are most free slots.
+    TSizeVec order(numberBuckets);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&buckets](std::size_t lhs, std::size_t rhs) {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    m_Seeds.assign(numberBuckets, 0);
+    std::vector<bool> used(numberSlots, false);
+    TSizeVec slots;
+    for (auto bucket : order) {
+        bool placed(false);
+        for (uint32_t seed = 0; placed == false && seed < MAX_SEED; ++seed) {
+            slots.clear();
+            placed = true;
+            for (const auto& word : buckets[bucket]) {
+                std::size_t slot(slotFor(word.first, seed, numberSlots));
+                if (used[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                    placed = false;
+                    break;
+                }
+                slots.push_back(slot);
+            }
+            if (placed) {
+                m_Seeds[bucket] = seed;
+            }
+        }
+        if (placed == false) {
+            LOG_DEBUG(<< "Failed to place " << buckets[bucket].size()
+                      << " words in " << numberSlots << " slots");
+            return false;
+        }
+        for (auto slot : slots) {
+            used[slot] = true;
+        }
+    }
+
+    m_Words.clear();
+    m_Entries.assign(numberSlots, SEntry{0, 0, E_NotInDictionary});
+    for (std::size_t bucket = 0; bucket < numberBuckets; ++bucket) {
+        for (const auto& word : buckets[bucket]) {
+            SEntry& entry(m_Entries[slotFor(word.first, m_Seeds[bucket], numberSlots)]);
+            entry.s_Offset = static_cast<uint32_t>(m_Words.length());
+            entry.s_Length = static_cast<uint32_t>(word.second->first.length());
+            entry.s_PartOfSpeech = word.second->second;
+            for (char c : word.second->first) {
+                m_Words += toLower(c);
+            }
+        }
+    }
+
+    return true;
+}
+
+std::size_t CWordDictionary::slot(uint64_t hash) const {
+    return slotFor(hash, m_Seeds[hash & (m_Seeds.size() - 1)], m_Entries.size());
+}
+
 size_t CWordDictionary::CStrHashIgnoreCase::operator()(const std::string& str) const {
     size_t hash(0);
 
@@ -0,0 +1,207 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include "CAhoCorasickAutomatonTest.h"
+
+#include <core/CAhoCorasickAutomaton.h>
+#include <core/CLogger.h>
+
+#include <test/CRandomNumbers.h>
+
+using namespace ml;
+using namespace core;
+
+using TStrVec = CAhoCorasickAutomaton::TStrVec;
+
+namespace {
+bool bruteForceMatches(const TStrVec& fullPatterns,
+                       const TStrVec& prefixPatterns,
+                       const TStrVec& suffixPatterns,
+                       const TStrVec& containsPatterns,
+                       const std::string& key) {
+    for (const auto& pattern : fullPatterns) {
+        if (key == pattern) {
+            return true;
+        }
+    }
+    for (const auto& pattern : prefixPatterns) {
+        if (key.compare(0, pattern.length(), pattern) == 0) {
+            return true;
+        }
+    }
+    for (const auto& pattern : suffixPatterns) {
+        if (key.length() >= pattern.length() &&
+            key.compare(key.length() - pattern.length(), pattern.length(), pattern) == 0) {
+            return true;
+        }
+    }
+    for (const auto& pattern : containsPatterns) {
+        if (key.find(pattern) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+CppUnit::Test* CAhoCorasickAutomatonTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CAhoCorasickAutomatonTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickAutomatonTest>(
+        "CAhoCorasickAutomatonTest::testEmpty", &CAhoCorasickAutomatonTest::testEmpty));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickAutomatonTest>(
+        "CAhoCorasickAutomatonTest::testFullPatterns",
+        &CAhoCorasickAutomatonTest::testFullPatterns));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickAutomatonTest>(
+        "CAhoCorasickAutomatonTest::testPrefixPatterns",
+        &CAhoCorasickAutomatonTest::testPrefixPatterns));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickAutomatonTest>(
+        "CAhoCorasickAutomatonTest::testSuffixPatterns",
+        &CAhoCorasickAutomatonTest::testSuffixPatterns));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickAutomatonTest>(
+        "CAhoCorasickAutomatonTest::testContainsPatterns",
+        &CAhoCorasickAutomatonTest::testContainsPatterns));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickAutomatonTest>(
+        "CAhoCorasickAutomatonTest::testOverlappingPatterns",
+        &CAhoCorasickAutomatonTest::testOverlappingPatterns));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickAutomatonTest>(
+        "CAhoCorasickAutomatonTest::testNonAsciiCharacters",
+        &CAhoCorasickAutomatonTest::testNonAsciiCharacters));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickAutomatonTest>(
+        "CAhoCorasickAutomatonTest::testRandom", &CAhoCorasickAutomatonTest::testRandom));
+
+    return suiteOfTests;
+}
+
+void CAhoCorasickAutomatonTest::testEmpty() {
+    CAhoCorasickAutomaton automaton;
+    CPPUNIT_ASSERT(automaton.matches("") == false);
+    CPPUNIT_ASSERT(automaton.matches("foo") == false);
+
+    CPPUNIT_ASSERT(automaton.build(TStrVec(), TStrVec(), TStrVec(), TStrVec()));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), automaton.numberStates());
+    CPPUNIT_ASSERT(automaton.matches("") == false);
+    CPPUNIT_ASSERT(automaton.matches("foo") == false);
+
+    CPPUNIT_ASSERT(automaton.build({"foo"}, TStrVec(), TStrVec(), TStrVec()));
+    CPPUNIT_ASSERT(automaton.matches("foo"));
+    automaton.clear();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), automaton.numberStates());
+    CPPUNIT_ASSERT(automaton.matches("foo") == false);
+}
+
+void CAhoCorasickAutomatonTest::testFullPatterns() {
+    CAhoCorasickAutomaton automaton;
+    CPPUNIT_ASSERT(automaton.build({"foo", "foobar", "bar", "bar"}, TStrVec(),
+                                   TStrVec(), TStrVec()));
+
+    CPPUNIT_ASSERT(automaton.matches("foo"));
+    CPPUNIT_ASSERT(automaton.matches("foobar"));
+    CPPUNIT_ASSERT(automaton.matches("bar"));
+    CPPUNIT_ASSERT(automaton.matches("") == false);
+    CPPUNIT_ASSERT(automaton.matches("fo") == false);
+    CPPUNIT_ASSERT(automaton.matches("foob") == false);
+    CPPUNIT_ASSERT(automaton.matches("_foo") == false);
+    CPPUNIT_ASSERT(automaton.matches("foo_") == false);
+    CPPUNIT_ASSERT(automaton.matches("barfoo") == false);
+}
+
+void CAhoCorasickAutomatonTest::testPrefixPatterns() {
+    CAhoCorasickAutomaton automaton;
+    CPPUNIT_ASSERT(automaton.build(TStrVec(), {"abc", "foo"}, TStrVec(), TStrVec()));
+
+    CPPUNIT_ASSERT(automaton.matches("abc"));
+    CPPUNIT_ASSERT(automaton.matches("abcd"));
+    CPPUNIT_ASSERT(automaton.matches("foo_abc"));
+    CPPUNIT_ASSERT(automaton.matches("ab") == false);
+    CPPUNIT_ASSERT(automaton.matches("zabc") == false);
+    CPPUNIT_ASSERT(automaton.matches("_foo") == false);
+}
+
+void CAhoCorasickAutomatonTest::testSuffixPatterns() {
+    CAhoCorasickAutomaton automaton;
+    CPPUNIT_ASSERT(automaton.build(TStrVec(), TStrVec(), {"xyz", "foo"}, TStrVec()));
+
+    CPPUNIT_ASSERT(automaton.matches("xyz"));
+    CPPUNIT_ASSERT(automaton.matches("aaaaxyz"));
+    CPPUNIT_ASSERT(automaton.matches("xyz_foo"));
+    CPPUNIT_ASSERT(automaton.matches("xyza") == false);
+    CPPUNIT_ASSERT(automaton.matches("yz") == false);
+    CPPUNIT_ASSERT(automaton.matches("foo_") == false);
+}
+
+void CAhoCorasickAutomatonTest::testContainsPatterns() {
+    CAhoCorasickAutomaton automaton;
+    CPPUNIT_ASSERT(automaton.build(TStrVec(), TStrVec(), TStrVec(), {"foo", "456"}));
+
+    CPPUNIT_ASSERT(automaton.matches("foo"));
+    CPPUNIT_ASSERT(automaton.matches("_foo_"));
+    CPPUNIT_ASSERT(automaton.matches("ffoo"));
+    CPPUNIT_ASSERT(automaton.matches("fofoo"));
+    CPPUNIT_ASSERT(automaton.matches("123456789"));
+    CPPUNIT_ASSERT(automaton.matches("_fo_") == false);
+    CPPUNIT_ASSERT(automaton.matches("12346789") == false);
+}
+
+void CAhoCorasickAutomatonTest::testOverlappingPatterns() {
+    // Check that matches are found via failure links, i.e. when the
+    // matching pattern is a proper suffix of the current state.
+
+    CAhoCorasickAutomaton automaton;
+    CPPUNIT_ASSERT(automaton.build(TStrVec(), {"abcdx"}, {"cde"}, {"bcdy", "cd"}));
+
+    CPPUNIT_ASSERT(automaton.matches("abcd"));
+    CPPUNIT_ASSERT(automaton.matches("zbcdy"));
+    CPPUNIT_ASSERT(automaton.matches("abcde"));
+    CPPUNIT_ASSERT(automaton.matches("abce") == false);
+
+    CPPUNIT_ASSERT(automaton.build({"aab"}, {"aaab"}, {"ab"}, {"abab"}));
+
+    CPPUNIT_ASSERT(automaton.matches("aab"));
+    CPPUNIT_ASSERT(automaton.matches("aaaab"));
+    CPPUNIT_ASSERT(automaton.matches("aababa"));
+    CPPUNIT_ASSERT(automaton.matches("aabaa") == false);
+    CPPUNIT_ASSERT(automaton.matches("aa") == false);
+}
+
+void CAhoCorasickAutomatonTest::testNonAsciiCharacters() {
+    std::string withNull("a");
+    withNull += '\0';
+    withNull += "b";
+
+    CAhoCorasickAutomaton automaton;
+    CPPUNIT_ASSERT(automaton.build(TStrVec(), {"\xc3\xa9t\xc3\xa9"}, TStrVec(), {withNull}));
+
+    CPPUNIT_ASSERT(automaton.matches("\xc3\xa9t\xc3\xa9_"));
+    CPPUNIT_ASSERT(automaton.matches("_" + withNull + "_"));
+    CPPUNIT_ASSERT(automaton.matches("_\xc3\xa9t\xc3\xa9") == false);
+    CPPUNIT_ASSERT(automaton.matches("ab") == false);
+}
+
+void CAhoCorasickAutomatonTest::testRandom() {
+    test::CRandomNumbers rng;
+
+    for (std::size_t t = 0; t < 20; ++t) {
+        TStrVec patterns[4];
+        for (std::size_t i = 0; i < 4; ++i) {
+            rng.generateWords(1 + t % 4, 10 * (t + 1), patterns[i]);
+        }
+
+        CAhoCorasickAutomaton automaton;
+        CPPUNIT_ASSERT(automaton.build(patterns[0], patterns[1], patterns[2], patterns[3]));
+
+        TStrVec keys;
+        rng.generateWords(20, 1000, keys);
+        TStrVec shortKeys;
+        rng.generateWords(1 + t % 4, 1000, shortKeys);
+        keys.insert(keys.end(), shortKeys.begin(), shortKeys.end());
+
+        for (const auto& key : keys) {
+            CPPUNIT_ASSERT_EQUAL(bruteForceMatches(patterns[0], patterns[1],
+                                                   patterns[2], patterns[3], key),
+                                 automaton.matches(key));
+        }
+    }
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_CAhoCorasickAutomatonTest_h
+#define INCLUDED_CAhoCorasickAutomatonTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CAhoCorasickAutomatonTest : public CppUnit::TestFixture {
+public:
+    void testEmpty();
+    void testFullPatterns();
+    void testPrefixPatterns();
+    void testSuffixPatterns();
+    void testContainsPatterns();
+    void testOverlappingPatterns();
+    void testNonAsciiCharacters();
+    void testRandom();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CAhoCorasickAutomatonTest_h
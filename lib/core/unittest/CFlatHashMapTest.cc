@@ -0,0 +1,265 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include "CFlatHashMapTest.h"
+
+#include <core/CFlatHashMap.h>
+#include <core/CLogger.h>
+#include <core/CMemory.h>
+#include <core/CStopWatch.h>
+
+#include <test/CRandomNumbers.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stdint.h>
+
+using namespace ml;
+
+namespace {
+using TSizeVec = std::vector<std::size_t>;
+using TStrVec = std::vector<std::string>;
+using TSizeSizePr = std::pair<std::size_t, std::size_t>;
+using TSizeSizePrUInt64FlatMap = core::CFlatHashMap<TSizeSizePr, uint64_t>;
+using TSizeSizePrUInt64UMap = boost::unordered_map<TSizeSizePr, uint64_t>;
+using TSizeSizePrUInt64Map = std::map<TSizeSizePr, uint64_t>;
+using TStrSizeFlatMap = core::CFlatHashMap<std::string, std::size_t>;
+
+//! Check \p map contains exactly the entries of \p expected.
+template<typename MAP>
+bool equal(const TSizeSizePrUInt64Map& expected, const MAP& map) {
+    if (map.size() != expected.size()) {
+        return false;
+    }
+    std::size_t n{0};
+    for (const auto& entry : map) {
+        auto i = expected.find(entry.first);
+        if (i == expected.end() || i->second != entry.second) {
+            return false;
+        }
+        ++n;
+    }
+    return n == expected.size();
+}
+}
+
+void CFlatHashMapTest::testRandom() {
+    // Apply a random sequence of inserts, updates and erases and check we
+    // agree with std::map.
+
+    test::CRandomNumbers rng;
+
+    TSizeSizePrUInt64Map expected;
+    TSizeSizePrUInt64FlatMap map;
+
+    TSizeVec operations;
+    TSizeVec keys;
+    for (std::size_t round = 0u; round < 20; ++round) {
+        rng.generateUniformSamples(0, 4, 2000, operations);
+        rng.generateUniformSamples(0, 50 * (round + 1), 4000, keys);
+        for (std::size_t i = 0u; i < operations.size(); ++i) {
+            TSizeSizePr key{keys[2 * i], keys[2 * i + 1] % 7};
+            switch (operations[i]) {
+            case 0:
+            case 1:
+                expected[key] += i;
+                map[key] += i;
+                break;
+            case 2: {
+                bool inserted{expected.emplace(key, i).second};
+                auto result = map.emplace(key, i);
+                CPPUNIT_ASSERT_EQUAL(inserted, result.second);
+                CPPUNIT_ASSERT_EQUAL(expected[key], result.first->second);
+                break;
+            }
+            case 3:
+                CPPUNIT_ASSERT_EQUAL(expected.erase(key), map.erase(key));
+                break;
+            }
+            CPPUNIT_ASSERT_EQUAL(expected.count(key), map.count(key));
+        }
+        CPPUNIT_ASSERT(equal(expected, map));
+        for (const auto& entry : expected) {
+            auto i = map.find(entry.first);
+            CPPUNIT_ASSERT(i != map.end());
+            CPPUNIT_ASSERT_EQUAL(entry.second, i->second);
+        }
+        CPPUNIT_ASSERT(map.find({1000000, 0}) == map.end());
+        LOG_DEBUG(<< "size = " << map.size() << ", capacity = " << map.capacity());
+        CPPUNIT_ASSERT(8 * map.size() <= 7 * map.capacity());
+    }
+
+    // Check string keys.
+
+    TStrVec words;
+    rng.generateWords(10, 5000, words);
+    TStrSizeFlatMap strings;
+    for (std::size_t i = 0u; i < words.size(); ++i) {
+        strings.emplace(words[i], i);
+    }
+    for (std::size_t i = 0u; i < words.size(); ++i) {
+        CPPUNIT_ASSERT(strings.find(words[i]) != strings.end());
+        CPPUNIT_ASSERT_EQUAL(words[i], strings.find(words[i])->first);
+    }
+}
+
+void CFlatHashMapTest::testEraseWhileIterating() {
+    // Check we visit every entry once when erasing while iterating and
+    // that repeatedly erasing and inserting doesn't grow the map.
+
+    TSizeSizePrUInt64Map expected;
+    TSizeSizePrUInt64FlatMap map;
+    for (std::size_t i = 0u; i < 1000; ++i) {
+        expected[{i, i % 3}] = i;
+        map[{i, i % 3}] = i;
+    }
+
+    std::size_t visited{0};
+    for (auto i = map.begin(); i != map.end(); /**/) {
+        ++visited;
+        if (i->second % 2 == 0) {
+            expected.erase(i->first);
+            i = map.erase(i);
+        } else {
+            ++i;
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1000), visited);
+    CPPUNIT_ASSERT(equal(expected, map));
+
+    std::size_t capacity{map.capacity()};
+    for (std::size_t round = 0u; round < 100; ++round) {
+        for (std::size_t i = 0u; i < 100; ++i) {
+            map[{1000 * (round + 1) + i, 0}] = i;
+        }
+        for (std::size_t i = 0u; i < 100; ++i) {
+            CPPUNIT_ASSERT_EQUAL(std::size_t(1), map.erase({1000 * (round + 1) + i, 0}));
+        }
+    }
+    LOG_DEBUG(<< "capacity = " << capacity << ", after = " << map.capacity());
+    CPPUNIT_ASSERT_EQUAL(capacity, map.capacity());
+    CPPUNIT_ASSERT(equal(expected, map));
+}
+
+void CFlatHashMapTest::testClearRetainsMemory() {
+    TSizeSizePrUInt64FlatMap map(1);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(8), map.capacity());
+
+    for (std::size_t i = 0u; i < 500; ++i) {
+        map[{i, 0}] += 1;
+    }
+    std::size_t capacity{map.capacity()};
+    std::size_t memory{core::CMemory::dynamicSize(map)};
+    LOG_DEBUG(<< "capacity = " << capacity << ", memory = " << memory);
+    CPPUNIT_ASSERT(capacity >= 500);
+    CPPUNIT_ASSERT(memory >= capacity * (sizeof(TSizeSizePr) + sizeof(uint64_t) + 1));
+
+    for (std::size_t bucket = 0u; bucket < 10; ++bucket) {
+        map.clear();
+        CPPUNIT_ASSERT(map.empty());
+        CPPUNIT_ASSERT(map.begin() == map.end());
+        CPPUNIT_ASSERT_EQUAL(capacity, map.capacity());
+        for (std::size_t i = 0u; i < 500; ++i) {
+            map[{bucket, i}] += 1;
+        }
+        CPPUNIT_ASSERT_EQUAL(std::size_t(500), map.size());
+        CPPUNIT_ASSERT_EQUAL(capacity, map.capacity());
+    }
+    CPPUNIT_ASSERT_EQUAL(memory, core::CMemory::dynamicSize(map));
+}
+
+void CFlatHashMapTest::testCopyAndMove() {
+    TSizeSizePrUInt64FlatMap map;
+    for (std::size_t i = 0u; i < 100; ++i) {
+        map[{i, i}] = i;
+    }
+
+    TSizeSizePrUInt64FlatMap copy{map};
+    CPPUNIT_ASSERT(copy == map);
+    copy[{0, 0}] = 1;
+    CPPUNIT_ASSERT(copy != map);
+
+    TSizeSizePrUInt64FlatMap moved{std::move(copy)};
+    CPPUNIT_ASSERT(copy.empty());
+    CPPUNIT_ASSERT(copy.begin() == copy.end());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(100), moved.size());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), moved[TSizeSizePr(0, 0)]);
+
+    // Moved from maps are empty and usable.
+    copy[{1, 1}] = 1;
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), copy.size());
+
+    moved = std::move(map);
+    CPPUNIT_ASSERT(map.empty());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), moved[TSizeSizePr(0, 0)]);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(100), moved.size());
+}
+
+void CFlatHashMapTest::testPerformance() {
+    // Compare with boost::unordered_map for the access pattern of the
+    // bucket counts: many increments of a few thousand keys per bucket
+    // followed by starting a new bucket.
+
+    test::CRandomNumbers rng;
+
+    std::size_t buckets{200};
+    std::size_t arrivals{50000};
+
+    TSizeVec people;
+    TSizeVec attributes;
+    rng.generateUniformSamples(0, 500, arrivals, people);
+    rng.generateUniformSamples(0, 10, arrivals, attributes);
+
+    uint64_t total{0};
+    core::CStopWatch watch{true};
+    {
+        TSizeSizePrUInt64UMap counts(1);
+        for (std::size_t bucket = 0u; bucket < buckets; ++bucket) {
+            for (std::size_t i = 0u; i < arrivals; ++i) {
+                counts[{people[i], (attributes[i] + bucket) % 20}] += 1;
+            }
+            total += counts.size();
+            counts = TSizeSizePrUInt64UMap(1);
+        }
+    }
+    uint64_t unorderedTime{watch.lap()};
+    {
+        TSizeSizePrUInt64FlatMap counts(1);
+        for (std::size_t bucket = 0u; bucket < buckets; ++bucket) {
+            for (std::size_t i = 0u; i < arrivals; ++i) {
+                counts[{people[i], (attributes[i] + bucket) % 20}] += 1;
+            }
+            total -= counts.size();
+            counts.clear();
+        }
+    }
+    uint64_t flatTime{watch.stop() - unorderedTime};
+
+    LOG_DEBUG(<< "unordered = " << unorderedTime << "ms, flat = " << flatTime << "ms");
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), total);
+}
+
+CppUnit::Test* CFlatHashMapTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CFlatHashMapTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CFlatHashMapTest>(
+        "CFlatHashMapTest::testRandom", &CFlatHashMapTest::testRandom));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CFlatHashMapTest>(
+        "CFlatHashMapTest::testEraseWhileIterating", &CFlatHashMapTest::testEraseWhileIterating));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CFlatHashMapTest>(
+        "CFlatHashMapTest::testClearRetainsMemory", &CFlatHashMapTest::testClearRetainsMemory));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CFlatHashMapTest>(
+        "CFlatHashMapTest::testCopyAndMove", &CFlatHashMapTest::testCopyAndMove));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CFlatHashMapTest>(
+        "CFlatHashMapTest::testPerformance", &CFlatHashMapTest::testPerformance));
+
+    return suiteOfTests;
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_CFlatHashMapTest_h
+#define INCLUDED_CFlatHashMapTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CFlatHashMapTest : public CppUnit::TestFixture {
+public:
+    void testRandom();
+    void testEraseWhileIterating();
+    void testClearRetainsMemory();
+    void testCopyAndMove();
+    void testPerformance();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CFlatHashMapTest_h
@@ -19,6 +19,9 @@
 #include <boost/ref.hpp>
 #include <boost/unordered_set.hpp>
 
+#include <algorithm>
+#include <set>
+
 using namespace ml;
 using namespace core;
 
@@ -331,6 +334,140 @@ void CHashingTest::testMurmurHash() {
     CPPUNIT_ASSERT(maxCollisions < 7);
 }
 
+void CHashingTest::testWyHash() {
+    // Check the hash values are stable. These must be the same on all
+    // platforms.
+    {
+        std::string key("This is the voice of the Mysterons!");
+        uint64_t seed = 0xdead4321;
+        uint64_t result = CHashing::wyHash64(key.c_str(), static_cast<int>(key.size()), seed);
+        CPPUNIT_ASSERT_EQUAL(uint64_t(9316247494344374490ull), result);
+    }
+    {
+        std::string key("Earthmen, we are peaceful beings and you have tried to destroy us, but you cannot succeed. You and your people "
+                        "will pay for this act of aggression.");
+        uint64_t seed = 0x1324fedc9876abdeULL;
+        uint64_t result = CHashing::wyHash64(key.c_str(), static_cast<int>(key.size()), seed);
+        CPPUNIT_ASSERT_EQUAL(uint64_t(8913770237479670617ull), result);
+    }
+
+    using TStrVec = std::vector<std::string>;
+    using TUInt64Set = std::set<uint64_t>;
+
+    // Check every key length, which exercises each of the code paths
+    // for reading the tail of the key, and that the hash doesn't depend
+    // on the alignment of the key.
+    {
+        std::string text("Your message has been analysed and it has been decided to allow "
+                         "one member of Spectrum to meet our representative.");
+        std::string buffer(text.size() + 8, ' ');
+        TUInt64Set prefixHashes;
+        TUInt64Set seedHashes;
+        for (std::size_t length = 0u; length <= text.size(); ++length) {
+            uint64_t hash = CHashing::wyHash64(text.data(), static_cast<int>(length), 0);
+            prefixHashes.insert(hash);
+            seedHashes.insert(CHashing::wyHash64(text.data(), static_cast<int>(length), 1));
+            for (std::size_t offset = 1u; offset < 8; ++offset) {
+                std::copy(text.begin(), text.begin() + length, buffer.begin() + offset);
+                CPPUNIT_ASSERT_EQUAL(hash, CHashing::wyHash64(&buffer[offset],
+                                                              static_cast<int>(length), 0));
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(text.size() + 1, prefixHashes.size());
+        CPPUNIT_ASSERT_EQUAL(text.size() + 1, seedHashes.size());
+        for (auto hash : seedHashes) {
+            CPPUNIT_ASSERT(prefixHashes.count(hash) == 0);
+        }
+    }
+
+    // Check the number of collisions for typical field value lengths.
+    test::CRandomNumbers rng;
+    CHashing::CWyHashString hasher;
+    for (std::size_t stringSize : {4, 12, 32, 100}) {
+        const std::size_t numberStrings = 500000u;
+        TStrVec testStrings;
+        rng.generateWords(stringSize, numberStrings, testStrings);
+        std::sort(testStrings.begin(), testStrings.end());
+        testStrings.erase(std::unique(testStrings.begin(), testStrings.end()),
+                          testStrings.end());
+
+        TUInt64Set uniqueHashes;
+        std::size_t numberBuckets = 3000017;
+        std::vector<std::size_t> buckets(numberBuckets, 0);
+        for (const auto& testString : testStrings) {
+            std::size_t hash = hasher(testString);
+            uniqueHashes.insert(hash);
+            ++buckets[hash % numberBuckets];
+        }
+        std::size_t maxCollisions = *std::max_element(buckets.begin(), buckets.end());
+
+        LOG_DEBUG(<< "length = " << stringSize << ", # strings = " << testStrings.size()
+                  << ", # unique hashes = " << uniqueHashes.size()
+                  << ", maximum number of collisions = " << maxCollisions);
+        CPPUNIT_ASSERT_EQUAL(testStrings.size(), uniqueHashes.size());
+        CPPUNIT_ASSERT(maxCollisions < 8);
+    }
+}
+
+void CHashingTest::testStringHashPerformance() {
+    // Compare the throughput of the string hashes for typical field value
+    // lengths.
+
+    using TStrVec = std::vector<std::string>;
+
+    const std::size_t numberStrings = 10000u;
+    const std::size_t numberRepeats = 500u;
+
+    test::CRandomNumbers rng;
+    core::CStopWatch stopWatch;
+
+    for (std::size_t stringSize : {4, 8, 16, 32, 64, 128, 256}) {
+        TStrVec testStrings;
+        rng.generateWords(stringSize, numberStrings, testStrings);
+
+        uint64_t total = 0;
+
+        stopWatch.reset(true);
+        for (std::size_t i = 0u; i < numberRepeats; ++i) {
+            for (const auto& testString : testStrings) {
+                total += boost::hash<std::string>()(testString);
+            }
+        }
+        uint64_t boostTime = stopWatch.stop();
+
+        stopWatch.reset(true);
+        for (std::size_t i = 0u; i < numberRepeats; ++i) {
+            for (const auto& testString : testStrings) {
+                total += CHashing::murmurHash64(
+                    testString.data(), static_cast<int>(testString.size()), 0);
+            }
+        }
+        uint64_t murmurTime = stopWatch.stop();
+
+        stopWatch.reset(true);
+        for (std::size_t i = 0u; i < numberRepeats; ++i) {
+            for (const auto& testString : testStrings) {
+                total += CHashing::safeMurmurHash64(
+                    testString.data(), static_cast<int>(testString.size()), 0);
+            }
+        }
+        uint64_t safeMurmurTime = stopWatch.stop();
+
+        stopWatch.reset(true);
+        for (std::size_t i = 0u; i < numberRepeats; ++i) {
+            for (const auto& testString : testStrings) {
+                total += CHashing::wyHash64(testString.data(),
+                                            static_cast<int>(testString.size()), 0);
+            }
+        }
+        uint64_t wyTime = stopWatch.stop();
+
+        LOG_DEBUG(<< "length = " << stringSize << ": boost = " << boostTime
+                  << "ms, murmur = " << murmurTime << "ms, safe murmur = " << safeMurmurTime
+                  << "ms, wyhash = " << wyTime << "ms (" << total << ")");
+    }
+}
+
 void CHashingTest::testHashCombine() {
     // Check we get about the same number of collisions using hashCombine
     // verses full hash of string.
@@ -449,6 +586,10 @@ CppUnit::Test* CHashingTest::suite() {
         "CHashingTest::testUniversalHash", &CHashingTest::testUniversalHash));
     suiteOfTests->addTest(new CppUnit::TestCaller<CHashingTest>(
         "CHashingTest::testMurmurHash", &CHashingTest::testMurmurHash));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CHashingTest>(
+        "CHashingTest::testWyHash", &CHashingTest::testWyHash));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CHashingTest>(
+        "CHashingTest::testStringHashPerformance", &CHashingTest::testStringHashPerformance));
     suiteOfTests->addTest(new CppUnit::TestCaller<CHashingTest>(
         "CHashingTest::testHashCombine", &CHashingTest::testHashCombine));
     suiteOfTests->addTest(new CppUnit::TestCaller<CHashingTest>(
@@ -13,6 +13,8 @@ class CHashingTest : public CppUnit::TestFixture {
 public:
     void testUniversalHash();
     void testMurmurHash();
+    void testWyHash();
+    void testStringHashPerformance();
     void testHashCombine();
     void testConstructors();
 
@@ -0,0 +1,85 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include "CMemoryMappedFileTest.h"
+
+#include <core/CLogger.h>
+#include <core/CMemoryMappedFile.h>
+#include <core/COsFileFuncs.h>
+
+#include <test/CTestTmpDir.h>
+
+#include <string>
+
+CppUnit::Test* CMemoryMappedFileTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CMemoryMappedFileTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CMemoryMappedFileTest>(
+        "CMemoryMappedFileTest::testOpenAndClose", &CMemoryMappedFileTest::testOpenAndClose));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CMemoryMappedFileTest>(
+        "CMemoryMappedFileTest::testResize", &CMemoryMappedFileTest::testResize));
+
+    return suiteOfTests;
+}
+
+void CMemoryMappedFileTest::testOpenAndClose() {
+    std::string fileName{ml::test::CTestTmpDir::tmpDir() + "/mappedfiletest1"};
+
+    ml::core::CMemoryMappedFile file;
+    CPPUNIT_ASSERT(file.isOpen() == false);
+    CPPUNIT_ASSERT(file.open(fileName, 1000));
+    CPPUNIT_ASSERT(file.isOpen());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1000), file.size());
+    CPPUNIT_ASSERT_EQUAL(0, ml::core::COsFileFuncs::access(
+                                fileName.c_str(), ml::core::COsFileFuncs::EXISTS));
+
+    // The file must not already exist.
+    ml::core::CMemoryMappedFile other;
+    CPPUNIT_ASSERT(other.open(fileName, 1000) == false);
+    CPPUNIT_ASSERT(other.isOpen() == false);
+
+    file.close();
+    CPPUNIT_ASSERT(file.isOpen() == false);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), file.size());
+    CPPUNIT_ASSERT_EQUAL(-1, ml::core::COsFileFuncs::access(
+                                 fileName.c_str(), ml::core::COsFileFuncs::EXISTS));
+
+    // The file is deleted on destruction.
+    {
+        ml::core::CMemoryMappedFile scoped;
+        CPPUNIT_ASSERT(scoped.open(fileName, 1000));
+    }
+    CPPUNIT_ASSERT_EQUAL(-1, ml::core::COsFileFuncs::access(
+                                 fileName.c_str(), ml::core::COsFileFuncs::EXISTS));
+}
+
+void CMemoryMappedFileTest::testResize() {
+    std::string fileName{ml::test::CTestTmpDir::tmpDir() + "/mappedfiletest2"};
+
+    ml::core::CMemoryMappedFile file;
+    CPPUNIT_ASSERT(file.resize(100) == false);
+    CPPUNIT_ASSERT(file.open(fileName, 4096));
+
+    for (std::size_t i = 0u; i < file.size(); ++i) {
+        file.data()[i] = static_cast<char>(i % 127);
+    }
+
+    // Shrinking is a no-op.
+    CPPUNIT_ASSERT(file.resize(100));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4096), file.size());
+
+    CPPUNIT_ASSERT(file.resize(1000000));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1000000), file.size());
+
+    // Check the contents are preserved and the new space is zeroed.
+    for (std::size_t i = 0u; i < 4096; ++i) {
+        CPPUNIT_ASSERT_EQUAL(static_cast<char>(i % 127), file.data()[i]);
+    }
+    for (std::size_t i = 4096; i < file.size(); i += 997) {
+        CPPUNIT_ASSERT_EQUAL(char(0), file.data()[i]);
+    }
+    file.data()[file.size() - 1] = 'x';
+    CPPUNIT_ASSERT_EQUAL('x', file.data()[file.size() - 1]);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include "CParallelTest.h"
+
+#include <core/CLogger.h>
+#include <core/CParallel.h>
+#include <core/CStaticThreadPool.h>
+
+#include <cmath>
+#include <future>
+#include <vector>
+
+using namespace ml;
+
+void CParallelTest::testForEach() {
+    // Check that every element is visited exactly once whatever the
+    // number of threads, with and without the default thread pool.
+
+    using TDoubleVec = std::vector<double>;
+    using TSizeVec = std::vector<std::size_t>;
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), core::CParallel::defaultThreads());
+
+    for (std::size_t pool : {0, 3}) {
+        core::CStaticThreadPool::startDefault(pool);
+        LOG_DEBUG(<< "default threads = " << core::CParallel::defaultThreads());
+        CPPUNIT_ASSERT_EQUAL(pool + 1, core::CParallel::defaultThreads());
+
+        for (std::size_t threads : {1, 2, 3, 8}) {
+            for (std::size_t n : {0, 1, 5, 1000}) {
+                TSizeVec visits(n, 0);
+                TDoubleVec values(n);
+                for (std::size_t i = 0u; i < n; ++i) {
+                    values[i] = static_cast<double>(i);
+                }
+
+                core::CParallel::forEach(threads, values.begin(), values.end(),
+                                         [&visits](double& value) {
+                                             ++visits[static_cast<std::size_t>(value)];
+                                             value = std::sqrt(value);
+                                         });
+
+                for (std::size_t i = 0u; i < n; ++i) {
+                    CPPUNIT_ASSERT_EQUAL(std::size_t(1), visits[i]);
+                    CPPUNIT_ASSERT_EQUAL(std::sqrt(static_cast<double>(i)), values[i]);
+                }
+            }
+        }
+    }
+    core::CStaticThreadPool::stopDefault();
+}
+
+void CParallelTest::testForEachWithBusyPool() {
+    // Check that forEach doesn't wait for tasks queued on the default
+    // pool ahead of its workers.
+
+    using TSizeVec = std::vector<std::size_t>;
+
+    core::CStaticThreadPool::startDefault(1);
+
+    std::promise<void> release;
+    std::shared_future<void> released{release.get_future().share()};
+    core::CStaticThreadPool::async([released]() { released.wait(); });
+
+    TSizeVec visits(100, 0);
+    core::CParallel::forEach(4, visits.begin(), visits.end(),
+                             [](std::size_t& visit) { ++visit; });
+    for (auto visit : visits) {
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1), visit);
+    }
+
+    release.set_value();
+    core::CStaticThreadPool::stopDefault();
+}
+
+CppUnit::Test* CParallelTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CParallelTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CParallelTest>(
+        "CParallelTest::testForEach", &CParallelTest::testForEach));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CParallelTest>(
+        "CParallelTest::testForEachWithBusyPool", &CParallelTest::testForEachWithBusyPool));
+
+    return suiteOfTests;
+}
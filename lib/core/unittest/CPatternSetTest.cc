@@ -5,12 +5,67 @@
  */
 #include "CPatternSetTest.h"
 
+#include <core/CFlatPrefixTree.h>
 #include <core/CLogger.h>
 #include <core/CPatternSet.h>
+#include <core/CStopWatch.h>
+
+#include <test/CRandomNumbers.h>
+
+#include <algorithm>
 
 using namespace ml;
 using namespace core;
 
+namespace {
+using TStrVec = std::vector<std::string>;
+
+//! The original implementation of the pattern set which checks contains
+//! patterns by matching the start of every suffix of the key.
+class CPrefixTreePatternSet {
+public:
+    bool build(TStrVec fullPatterns,
+               TStrVec prefixPatterns,
+               TStrVec suffixPatterns,
+               TStrVec containsPatterns) {
+        for (auto& suffix : suffixPatterns) {
+            std::reverse(suffix.begin(), suffix.end());
+        }
+        return m_FullMatchPatterns.build(sortAndPruneDuplicates(fullPatterns)) &&
+               m_PrefixPatterns.build(sortAndPruneDuplicates(prefixPatterns)) &&
+               m_SuffixPatterns.build(sortAndPruneDuplicates(suffixPatterns)) &&
+               m_ContainsPatterns.build(sortAndPruneDuplicates(containsPatterns));
+    }
+
+    bool contains(const std::string& key) const {
+        if (m_PrefixPatterns.matchesStart(key) ||
+            m_SuffixPatterns.matchesStart(key.rbegin(), key.rend()) ||
+            m_FullMatchPatterns.matchesFully(key)) {
+            return true;
+        }
+        for (auto i = key.begin(); i != key.end(); ++i) {
+            if (m_ContainsPatterns.matchesStart(i, key.end())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static TStrVec& sortAndPruneDuplicates(TStrVec& keys) {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return keys;
+    }
+
+private:
+    CFlatPrefixTree m_FullMatchPatterns;
+    CFlatPrefixTree m_PrefixPatterns;
+    CFlatPrefixTree m_SuffixPatterns;
+    CFlatPrefixTree m_ContainsPatterns;
+};
+}
+
 CppUnit::Test* CPatternSetTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CPatternSetTest");
 
@@ -43,6 +98,8 @@ CppUnit::Test* CPatternSetTest::suite() {
         &CPatternSetTest::testContains_GivenMixedKeys));
     suiteOfTests->addTest(new CppUnit::TestCaller<CPatternSetTest>(
         "CPatternSetTest::testClear", &CPatternSetTest::testClear));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CPatternSetTest>(
+        "CPatternSetTest::testPerformance", &CPatternSetTest::testPerformance));
 
     return suiteOfTests;
 }
@@ -156,3 +213,74 @@ void CPatternSetTest::testClear() {
 
     CPPUNIT_ASSERT(set.contains("foo") == false);
 }
+
+void CPatternSetTest::testPerformance() {
+    // Compare against the prefix tree implementation for a large filter
+    // list and long keys.
+
+    test::CRandomNumbers rng;
+
+    TStrVec fullPatterns;
+    TStrVec prefixPatterns;
+    TStrVec suffixPatterns;
+    TStrVec containsPatterns;
+    rng.generateWords(8, 1000, fullPatterns);
+    rng.generateWords(6, 1000, prefixPatterns);
+    rng.generateWords(6, 1000, suffixPatterns);
+    rng.generateWords(5, 2000, containsPatterns);
+
+    std::string json("[");
+    for (const auto& pattern : fullPatterns) {
+        json += "\"" + pattern + "\",";
+    }
+    for (const auto& pattern : prefixPatterns) {
+        json += "\"" + pattern + "*\",";
+    }
+    for (const auto& pattern : suffixPatterns) {
+        json += "\"*" + pattern + "\",";
+    }
+    for (const auto& pattern : containsPatterns) {
+        json += "\"*" + pattern + "*\",";
+    }
+    json.back() = ']';
+
+    CStopWatch watch;
+
+    watch.start();
+    CPatternSet set;
+    CPPUNIT_ASSERT(set.initFromJson(json));
+    LOG_DEBUG(<< "Built pattern set with " << fullPatterns.size() + prefixPatterns.size() +
+                                                  suffixPatterns.size() + containsPatterns.size()
+              << " items in " << watch.stop() << " ms using " << set.memoryUsage() << " bytes");
+
+    CPrefixTreePatternSet expected;
+    CPPUNIT_ASSERT(expected.build(fullPatterns, prefixPatterns, suffixPatterns, containsPatterns));
+
+    for (auto length : {20, 200, 2000}) {
+        TStrVec keys;
+        rng.generateWords(length, 2000000 / length, keys);
+        keys.insert(keys.end(), fullPatterns.begin(), fullPatterns.begin() + 100);
+
+        std::vector<bool> expectedContains;
+        expectedContains.reserve(keys.size());
+        watch.reset(true);
+        for (const auto& key : keys) {
+            expectedContains.push_back(expected.contains(key));
+        }
+        uint64_t expectedTime = watch.stop();
+
+        std::vector<bool> contains;
+        contains.reserve(keys.size());
+        watch.reset(true);
+        for (const auto& key : keys) {
+            contains.push_back(set.contains(key));
+        }
+        uint64_t time = watch.stop();
+
+        LOG_DEBUG(<< "key length = " << length << ", # matches = "
+                  << std::count(contains.begin(), contains.end(), true) << "/"
+                  << keys.size() << ", prefix trees = " << expectedTime
+                  << " ms, automaton = " << time << " ms");
+        CPPUNIT_ASSERT(contains == expectedContains);
+    }
+}
@@ -20,6 +20,7 @@ public:
     void testContains_GivenContainsKeys();
     void testContains_GivenMixedKeys();
     void testClear();
+    void testPerformance();
 
     static CppUnit::Test* suite();
 };
@@ -6,7 +6,29 @@
 #include "CRegexFilterTest.h"
 
 #include <core/CLogger.h>
+#include <core/CRegex.h>
 #include <core/CRegexFilter.h>
+#include <core/CStopWatch.h>
+
+#include <test/CRandomNumbers.h>
+
+#include <boost/lexical_cast.hpp>
+
+namespace {
+using TStrVec = std::vector<std::string>;
+
+//! Apply each regex in turn until it doesn't match.
+std::string applySequentially(const std::vector<ml::core::CRegex>& regexes, std::string target) {
+    for (const auto& regex : regexes) {
+        std::size_t position = 0;
+        std::size_t length = 0;
+        while (regex.search(target, position, length)) {
+            target.erase(position, length);
+        }
+    }
+    return target;
+}
+}
 
 CppUnit::Test* CRegexFilterTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CRegexFilterTest");
@@ -26,6 +48,28 @@ CppUnit::Test* CRegexFilterTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CRegexFilterTest>(
         "CRegexFilterTest::testApply_GivenMultipleRegex",
         &CRegexFilterTest::testApply_GivenMultipleRegex));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CRegexFilterTest>(
+        "CRegexFilterTest::testApply_GivenAnchoredRegex",
+        &CRegexFilterTest::testApply_GivenAnchoredRegex));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CRegexFilterTest>(
+        "CRegexFilterTest::testApply_GivenEmptyMatch",
+        &CRegexFilterTest::testApply_GivenEmptyMatch));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CRegexFilterTest>(
+        "CRegexFilterTest::testApply_GivenEmptyMatchBeforeAssertion",
+        &CRegexFilterTest::testApply_GivenEmptyMatchBeforeAssertion));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CRegexFilterTest>(
+        "CRegexFilterTest::testApply_GivenOverlappingMatches",
+        &CRegexFilterTest::testApply_GivenOverlappingMatches));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CRegexFilterTest>(
+        "CRegexFilterTest::testApply_GivenLiteralCreatedByDeletion",
+        &CRegexFilterTest::testApply_GivenLiteralCreatedByDeletion));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CRegexFilterTest>(
+        "CRegexFilterTest::testApply_GivenAssertionEscapes",
+        &CRegexFilterTest::testApply_GivenAssertionEscapes));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CRegexFilterTest>(
+        "CRegexFilterTest::testRequiredLiteral", &CRegexFilterTest::testRequiredLiteral));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CRegexFilterTest>(
+        "CRegexFilterTest::testPerformance", &CRegexFilterTest::testPerformance));
 
     return suiteOfTests;
 }
@@ -77,4 +121,222 @@ void CRegexFilterTest::testApply_GivenMultipleRegex() {
     CPPUNIT_ASSERT(filter.configure(regexVector));
 
     CPPUNIT_ASSERT_EQUAL(std::string("a"), filter.apply(std::string("foo bar fooooobar a")));
+
+    std::string result;
+    filter.apply(std::string("bar foo a"), result);
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), result);
+}
+
+void CRegexFilterTest::testApply_GivenAnchoredRegex() {
+    // Anchored regexes are applied repeatedly to the start of the
+    // filtered string.
+    std::vector<std::string> regexVector;
+    regexVector.push_back(std::string("^\\[[^]]*\\]"));
+    regexVector.push_back(std::string("[0-9]+"));
+
+    ml::core::CRegexFilter filter;
+    CPPUNIT_ASSERT(filter.configure(regexVector));
+    CPPUNIT_ASSERT_EQUAL(std::string(" msg "), filter.apply(std::string("[a][b] msg 123")));
+}
+
+void CRegexFilterTest::testApply_GivenEmptyMatch() {
+    std::vector<std::string> regexVector;
+    regexVector.push_back(std::string("x*"));
+    regexVector.push_back(std::string("y?"));
+
+    ml::core::CRegexFilter filter;
+    CPPUNIT_ASSERT(filter.configure(regexVector));
+    CPPUNIT_ASSERT_EQUAL(std::string("abc"), filter.apply(std::string("axxbyc")));
+}
+
+void CRegexFilterTest::testApply_GivenEmptyMatchBeforeAssertion() {
+    // Skipping past an empty match mustn't make the next character look
+    // like the start of the string or a word.
+    {
+        std::vector<std::string> regexVector{"^a*"};
+        ml::core::CRegexFilter filter;
+        CPPUNIT_ASSERT(filter.configure(regexVector));
+        CPPUNIT_ASSERT_EQUAL(std::string("xaa"), filter.apply(std::string("xaa")));
+        CPPUNIT_ASSERT_EQUAL(std::string("x"), filter.apply(std::string("aax")));
+    }
+    {
+        std::vector<std::string> regexVector{"\\ba*"};
+        ml::core::CRegexFilter filter;
+        CPPUNIT_ASSERT(filter.configure(regexVector));
+        CPPUNIT_ASSERT_EQUAL(std::string("xaa"), filter.apply(std::string("xaa")));
+        CPPUNIT_ASSERT_EQUAL(std::string("x "), filter.apply(std::string("x aa")));
+    }
+}
+
+void CRegexFilterTest::testApply_GivenOverlappingMatches() {
+    // The earlier regex's match starts inside the later one's so is
+    // deleted first.
+    std::vector<std::string> regexVector;
+    regexVector.push_back(std::string("[0-9]+\\.[0-9]+\\.[0-9]+\\.[0-9]+"));
+    regexVector.push_back(std::string("0x[0-9a-f]+"));
+
+    ml::core::CRegexFilter filter;
+    CPPUNIT_ASSERT(filter.configure(regexVector));
+    CPPUNIT_ASSERT_EQUAL(std::string("key 0x at  "),
+                         filter.apply(std::string("key 0x10.0.0.3 at 0xff 10.0.0.4")));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("key x3 at "),
+                         filter.apply(std::string("key 10.0.0.0x3 at 0xff")));
+}
+
+void CRegexFilterTest::testApply_GivenLiteralCreatedByDeletion() {
+    // The input doesn't contain "0x" until "y" is deleted.
+    std::vector<std::string> regexVector;
+    regexVector.push_back(std::string("y"));
+    regexVector.push_back(std::string("0x[0-9]+"));
+
+    ml::core::CRegexFilter filter;
+    CPPUNIT_ASSERT(filter.configure(regexVector));
+    CPPUNIT_ASSERT_EQUAL(std::string("a  b"), filter.apply(std::string("a 0yx12 b")));
+}
+
+void CRegexFilterTest::testApply_GivenAssertionEscapes() {
+    // Escaped word and buffer boundaries are assertions, not literals.
+    std::vector<std::string> regexVector;
+    regexVector.push_back(std::string("\\<foo"));
+    regexVector.push_back(std::string("bar\\>"));
+    regexVector.push_back(std::string("\\`x"));
+    regexVector.push_back(std::string("y\\'"));
+
+    ml::core::CRegexFilter filter;
+    CPPUNIT_ASSERT(filter.configure(regexVector));
+    CPPUNIT_ASSERT_EQUAL(std::string(" a  barb . bar"),
+                         filter.apply(std::string("x a foo barb bar. bary")));
+}
+
+void CRegexFilterTest::testRequiredLiteral() {
+    using TStrStrPr = std::pair<std::string, std::string>;
+
+    std::vector<TStrStrPr> expected{
+        {"foo", "foo"},
+        {"\\[statement:.*?\\]", "[statement:"},
+        {"[0-9]{4}-[0-9]{2}-[0-9]{2}", "-"},
+        {"0x[0-9a-fA-F]+", "0x"},
+        {"ab+cd", "bcd"},
+        {"ab*cd", "cd"},
+        {"abc?d", "ab"},
+        {"a{0,2}bc{2}d", "bc"},
+        {"[abc]+def", "def"},
+        {"[]x]yz", "yz"},
+        {"[[:alpha:]]+ab", "ab"},
+        {"(foo|bar)ba", "ba"},
+        {"(?:a(b)c)de", "de"},
+        {"\\d+\\.\\d+", "."},
+        {"^abc$", "abc"},
+        {"foo|bar", ""},
+        {"(?i)foo", ""},
+        {"(?<=a)foo", ""},
+        {"\\<foo", "foo"},
+        {"foo\\>", "foo"},
+        {"\\`foo\\'", "foo"},
+        {"a\\bfoo", "foo"},
+        {"\\x41bc", ""},
+        {"\\Qa.b\\E", ""},
+        {"[0-9]+", ""},
+        {".*", ""},
+        {"", ""}};
+
+    for (const auto& regex : expected) {
+        LOG_DEBUG(<< "'" << regex.first << "' -> '"
+                  << ml::core::CRegexFilter::requiredLiteral(regex.first) << "'");
+        CPPUNIT_ASSERT_EQUAL(regex.second,
+                             ml::core::CRegexFilter::requiredLiteral(regex.first));
+    }
+}
+
+void CRegexFilterTest::testPerformance() {
+    // Compare the filter with searching with every regex in turn for
+    // typical log lines and filter lists.
+
+    TStrVec regexes{"\\[statement:.*?\\]",
+                    "[0-9]{4}-[0-9]{2}-[0-9]{2}",
+                    "[0-9]{2}:[0-9]{2}:[0-9]{2}(,[0-9]+)?",
+                    "(?:[0-9]{1,3}\\.){3}[0-9]{1,3}",
+                    "[0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12}",
+                    "pid=[0-9]+",
+                    "user=\\w+",
+                    "SQL: .*",
+                    "0x[0-9a-fA-F]+",
+                    "took [0-9]+ms"};
+    for (std::size_t i = regexes.size(); i < 50; ++i) {
+        regexes.push_back("field" + boost::lexical_cast<std::string>(i) + "=[^ ]+");
+    }
+
+    TStrVec templates{
+        "%s %s INFO [main] Connection from %s user=%s pid=%s accepted",
+        "%s %s ERROR [statement: select * from orders where id = %s] failed for session %s",
+        "%s %s WARN request %s to host %s took %sms field12=abc field40=%s",
+        "%s %s DEBUG cache miss for key 0x%s SQL: update t set x = %s",
+        "%s %s INFO Processed %s records from shard %s in partition %s"};
+
+    ml::test::CRandomNumbers rng;
+    TStrVec lines;
+    for (std::size_t i = 0; i < 20000; ++i) {
+        TStrVec values;
+        rng.generateWords(6, 5, values);
+        std::string line;
+        const std::string& format = templates[i % templates.size()];
+        std::size_t argument = 0;
+        for (std::size_t j = 0; j < format.length(); ++j) {
+            if (format.compare(j, 2, "%s") == 0) {
+                switch (argument++) {
+                case 0:
+                    line += "2018-05-18";
+                    break;
+                case 1:
+                    line += "10:34:12,123";
+                    break;
+                case 2:
+                    line += "10.0.0." + boost::lexical_cast<std::string>(i % 256);
+                    break;
+                default:
+                    line += values[argument % values.size()];
+                    break;
+                }
+                ++j;
+            } else {
+                line += format[j];
+            }
+        }
+        lines.push_back(line);
+    }
+
+    for (std::size_t numberRegexes : {10, 50}) {
+        TStrVec regexVector(regexes.begin(), regexes.begin() + numberRegexes);
+
+        ml::core::CRegexFilter filter;
+        CPPUNIT_ASSERT(filter.configure(regexVector));
+
+        std::vector<ml::core::CRegex> sequential(numberRegexes);
+        for (std::size_t i = 0; i < numberRegexes; ++i) {
+            CPPUNIT_ASSERT(sequential[i].init(regexVector[i]));
+        }
+
+        ml::core::CStopWatch watch(true);
+        TStrVec expected;
+        expected.reserve(lines.size());
+        for (const auto& line : lines) {
+            expected.push_back(applySequentially(sequential, line));
+        }
+        uint64_t sequentialTime = watch.stop();
+
+        watch.reset(true);
+        std::string result;
+        std::size_t numberDifferent = 0;
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            filter.apply(lines[i], result);
+            numberDifferent += result != expected[i] ? 1 : 0;
+        }
+        uint64_t filterTime = watch.stop();
+
+        LOG_DEBUG(<< "# regexes = " << numberRegexes << ", sequential = "
+                  << sequentialTime << " ms, filter = " << filterTime << " ms");
+        LOG_DEBUG(<< "e.g. '" << lines[1] << "' -> '" << expected[1] << "'");
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), numberDifferent);
+    }
 }
@@ -15,6 +15,14 @@ public:
     void testApply_GivenSingleMatchAllRegex();
     void testApply_GivenSingleRegex();
     void testApply_GivenMultipleRegex();
+    void testApply_GivenAnchoredRegex();
+    void testApply_GivenEmptyMatch();
+    void testApply_GivenEmptyMatchBeforeAssertion();
+    void testApply_GivenOverlappingMatches();
+    void testApply_GivenLiteralCreatedByDeletion();
+    void testApply_GivenAssertionEscapes();
+    void testRequiredLiteral();
+    void testPerformance();
 
     static CppUnit::Test* suite();
 };
@@ -0,0 +1,106 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include "CStaticThreadPoolTest.h"
+
+#include <core/CLogger.h>
+#include <core/CStaticThreadPool.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace ml;
+
+void CStaticThreadPoolTest::testSchedule() {
+    // Check that every scheduled task runs, including those which are
+    // still queued when the pool is destroyed.
+
+    for (std::size_t threads : {1, 2, 4}) {
+        std::atomic<std::size_t> count{0};
+        std::vector<std::atomic<std::size_t>> visits(1000);
+        for (auto& visit : visits) {
+            visit.store(0);
+        }
+        {
+            core::CStaticThreadPool pool{threads};
+            CPPUNIT_ASSERT_EQUAL(threads, pool.numberThreads());
+            for (std::size_t i = 0u; i < visits.size(); ++i) {
+                pool.schedule([&count, &visits, i]() {
+                    ++visits[i];
+                    ++count;
+                });
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(visits.size(), count.load());
+        for (const auto& visit : visits) {
+            CPPUNIT_ASSERT_EQUAL(std::size_t(1), visit.load());
+        }
+    }
+}
+
+void CStaticThreadPoolTest::testAsync() {
+    using TDoubleSFutureVec = std::vector<std::shared_future<double>>;
+
+    auto f = [](std::size_t i) {
+        return [i]() { return std::sqrt(static_cast<double>(i)); };
+    };
+
+    LOG_DEBUG(<< "Default pool off");
+    {
+        CPPUNIT_ASSERT(!core::CStaticThreadPool::defaultRunning());
+
+        // Tasks should run immediately on the calling thread.
+        std::thread::id caller{std::this_thread::get_id()};
+        std::thread::id runner;
+        auto result = core::CStaticThreadPool::async([&runner]() {
+            runner = std::this_thread::get_id();
+            return 1.0;
+        });
+        CPPUNIT_ASSERT(result.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        CPPUNIT_ASSERT_EQUAL(1.0, result.get());
+        CPPUNIT_ASSERT(caller == runner);
+    }
+
+    LOG_DEBUG(<< "Default pool on");
+    {
+        core::CStaticThreadPool::startDefault(2);
+        CPPUNIT_ASSERT(core::CStaticThreadPool::defaultRunning());
+
+        TDoubleSFutureVec results;
+        for (std::size_t i = 0u; i < 100; ++i) {
+            results.push_back(core::CStaticThreadPool::async(f(i)));
+        }
+        for (std::size_t i = 0u; i < results.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL(std::sqrt(static_cast<double>(i)), results[i].get());
+        }
+
+        // Stopping should run anything outstanding.
+        for (std::size_t i = 0u; i < 100; ++i) {
+            results[i] = core::CStaticThreadPool::async(f(i));
+        }
+        core::CStaticThreadPool::stopDefault();
+        CPPUNIT_ASSERT(!core::CStaticThreadPool::defaultRunning());
+        for (std::size_t i = 0u; i < results.size(); ++i) {
+            CPPUNIT_ASSERT(results[i].wait_for(std::chrono::seconds(0)) ==
+                           std::future_status::ready);
+            CPPUNIT_ASSERT_EQUAL(std::sqrt(static_cast<double>(i)), results[i].get());
+        }
+    }
+}
+
+CppUnit::Test* CStaticThreadPoolTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CStaticThreadPoolTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CStaticThreadPoolTest>(
+        "CStaticThreadPoolTest::testSchedule", &CStaticThreadPoolTest::testSchedule));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CStaticThreadPoolTest>(
+        "CStaticThreadPoolTest::testAsync", &CStaticThreadPoolTest::testAsync));
+
+    return suiteOfTests;
+}
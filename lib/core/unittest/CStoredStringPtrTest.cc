@@ -22,6 +22,8 @@ CppUnit::Test* CStoredStringPtrTest::suite() {
         "CStoredStringPtrTest::testMemoryUsage", &CStoredStringPtrTest::testMemoryUsage));
     suiteOfTests->addTest(new CppUnit::TestCaller<CStoredStringPtrTest>(
         "CStoredStringPtrTest::testHash", &CStoredStringPtrTest::testHash));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CStoredStringPtrTest>(
+        "CStoredStringPtrTest::testWeakPtr", &CStoredStringPtrTest::testWeakPtr));
 
     return suiteOfTests;
 }
@@ -124,3 +126,18 @@ void CStoredStringPtrTest::testHash() {
 
     CPPUNIT_ASSERT_EQUAL(std::size_t(1), s.count(key));
 }
+
+void CStoredStringPtrTest::testWeakPtr() {
+    CPPUNIT_ASSERT(ml::core::CStoredStringPtr::CWeakPtr().expired());
+
+    ml::core::CStoredStringPtr::CWeakPtr weak;
+    {
+        ml::core::CStoredStringPtr ptr = ml::core::CStoredStringPtr::makeStoredString("value");
+        weak = ml::core::CStoredStringPtr::CWeakPtr(ptr);
+        CPPUNIT_ASSERT(weak.expired() == false);
+
+        // The weak reference mustn't keep the string alive.
+        CPPUNIT_ASSERT(ptr.isUnique());
+    }
+    CPPUNIT_ASSERT(weak.expired());
+}
@@ -13,6 +13,7 @@ public:
     void testPointerSemantics();
     void testMemoryUsage();
     void testHash();
+    void testWeakPtr();
 
     static CppUnit::Test* suite();
 };
@@ -6,9 +6,14 @@
 #include "CWordDictionaryTest.h"
 
 #include <core/CLogger.h>
+#include <core/CResourceLocator.h>
+#include <core/CStopWatch.h>
 #include <core/CTimeUtils.h>
 #include <core/CWordDictionary.h>
 
+#include <algorithm>
+#include <fstream>
+
 CppUnit::Test* CWordDictionaryTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CWordDictionaryTest");
 
@@ -16,6 +21,8 @@ CppUnit::Test* CWordDictionaryTest::suite() {
         "CWordDictionaryTest::testLookups", &CWordDictionaryTest::testLookups));
     suiteOfTests->addTest(new CppUnit::TestCaller<CWordDictionaryTest>(
         "CWordDictionaryTest::testPartOfSpeech", &CWordDictionaryTest::testPartOfSpeech));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CWordDictionaryTest>(
+        "CWordDictionaryTest::testAllWords", &CWordDictionaryTest::testAllWords));
     suiteOfTests->addTest(new CppUnit::TestCaller<CWordDictionaryTest>(
         "CWordDictionaryTest::testWeightingFunctors", &CWordDictionaryTest::testWeightingFunctors));
     suiteOfTests->addTest(new CppUnit::TestCaller<CWordDictionaryTest>(
@@ -65,6 +72,36 @@ void CWordDictionaryTest::testPartOfSpeech() {
                          dict.partOfSpeech("a"));
 }
 
+void CWordDictionaryTest::testAllWords() {
+    // Check every word in the dictionary file is found, whatever its case,
+    // and that strings which differ from a word in the last character
+    // aren't.
+
+    const ml::core::CWordDictionary& dict = ml::core::CWordDictionary::instance();
+
+    std::ifstream ifs(ml::core::CResourceLocator::resourceDir() + "/ml-en.dict");
+    CPPUNIT_ASSERT(ifs.is_open());
+
+    std::size_t numberWords(0);
+    std::size_t numberMisspellingsFound(0);
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::string word(line.substr(0, line.find('@')));
+        std::string upper(word);
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        CPPUNIT_ASSERT(dict.isInDictionary(word));
+        CPPUNIT_ASSERT(dict.isInDictionary(upper));
+        word.back() = '0';
+        numberMisspellingsFound += dict.isInDictionary(word) ? 1 : 0;
+        ++numberWords;
+    }
+    LOG_DEBUG(<< "# words = " << numberWords
+              << ", # misspellings found = " << numberMisspellingsFound);
+
+    CPPUNIT_ASSERT(numberWords > 70000);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), numberMisspellingsFound);
+}
+
 void CWordDictionaryTest::testWeightingFunctors() {
     {
         ml::core::CWordDictionary::TWeightAll2 weighter;
@@ -108,6 +145,7 @@ void CWordDictionaryTest::testPerformance() {
     ml::core_t::TTime start(ml::core::CTimeUtils::now());
     LOG_INFO(<< "Starting word dictionary throughput test at "
              << ml::core::CTimeUtils::toTimeString(start));
+    ml::core::CStopWatch stopWatch(true);
 
     static const size_t TEST_SIZE(100000);
     for (size_t count = 0; count < TEST_SIZE; ++count) {
@@ -125,9 +163,11 @@ void CWordDictionaryTest::testPerformance() {
         dict.isInDictionary("HELLO2");
     }
 
+    uint64_t time(stopWatch.stop());
     ml::core_t::TTime end(ml::core::CTimeUtils::now());
     LOG_INFO(<< "Finished word dictionary throughput test at "
              << ml::core::CTimeUtils::toTimeString(end));
+    LOG_INFO(<< "Word dictionary lookups took " << time << "ms");
 
     LOG_INFO(<< "Word dictionary throughput test took " << (end - start) << " seconds");
 }
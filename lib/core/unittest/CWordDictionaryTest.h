@@ -12,6 +12,7 @@ class CWordDictionaryTest : public CppUnit::TestFixture {
 public:
     void testLookups();
     void testPartOfSpeech();
+    void testAllWords();
     void testWeightingFunctors();
     void testPerformance();
 
@@ -5,6 +5,7 @@
  */
 #include <test/CTestRunner.h>
 
+#include "CAhoCorasickAutomatonTest.h"
 #include "CAllocationStrategyTest.h"
 #include "CBase64FilterTest.h"
 #include "CBlockingMessageQueueTest.h"
@@ -18,6 +19,7 @@
 #include "CDetachedProcessSpawnerTest.h"
 #include "CDualThreadStreamBufTest.h"
 #include "CFileDeleterTest.h"
+#include "CFlatHashMapTest.h"
 #include "CFlatPrefixTreeTest.h"
 #include "CFunctionalTest.h"
 #include "CHashingTest.h"
@@ -29,6 +31,7 @@
 #include "CJsonStateRestoreTraverserTest.h"
 #include "CLoggerTest.h"
 #include "CMapPopulationTest.h"
+#include "CMemoryMappedFileTest.h"
 #include "CMemoryUsageJsonWriterTest.h"
 #include "CMemoryUsageTest.h"
 #include "CMessageBufferTest.h"
@@ -37,6 +40,7 @@
 #include "CMutexTest.h"
 #include "CNamedPipeFactoryTest.h"
 #include "COsFileFuncsTest.h"
+#include "CParallelTest.h"
 #include "CPatternSetTest.h"
 #include "CPersistUtilsTest.h"
 #include "CPolymorphicStackObjectCPtrTest.h"
@@ -57,6 +61,7 @@
 #include "CSmallVectorTest.h"
 #include "CStateCompressorTest.h"
 #include "CStateMachineTest.h"
+#include "CStaticThreadPoolTest.h"
 #include "CStatisticsTest.h"
 #include "CStopWatchTest.h"
 #include "CStoredStringPtrTest.h"
@@ -79,6 +84,7 @@
 int main(int argc, const char** argv) {
     ml::test::CTestRunner runner(argc, argv);
 
+    runner.addTest(CAhoCorasickAutomatonTest::suite());
     runner.addTest(CAllocationStrategyTest::suite());
     runner.addTest(CBase64FilterTest::suite());
     runner.addTest(CBlockingMessageQueueTest::suite());
@@ -92,6 +98,7 @@ int main(int argc, const char** argv) {
     runner.addTest(CDetachedProcessSpawnerTest::suite());
     runner.addTest(CDualThreadStreamBufTest::suite());
     runner.addTest(CFileDeleterTest::suite());
+    runner.addTest(CFlatHashMapTest::suite());
     runner.addTest(CFlatPrefixTreeTest::suite());
     runner.addTest(CFunctionalTest::suite());
     runner.addTest(CHashingTest::suite());
@@ -103,6 +110,7 @@ int main(int argc, const char** argv) {
     runner.addTest(CJsonStateRestoreTraverserTest::suite());
     runner.addTest(CLoggerTest::suite());
     runner.addTest(CMapPopulationTest::suite());
+    runner.addTest(CMemoryMappedFileTest::suite());
     runner.addTest(CMemoryUsageJsonWriterTest::suite());
     runner.addTest(CMemoryUsageTest::suite());
     runner.addTest(CMessageBufferTest::suite());
@@ -111,6 +119,7 @@ int main(int argc, const char** argv) {
     runner.addTest(CMutexTest::suite());
     runner.addTest(CNamedPipeFactoryTest::suite());
     runner.addTest(COsFileFuncsTest::suite());
+    runner.addTest(CParallelTest::suite());
     runner.addTest(CPatternSetTest::suite());
     runner.addTest(CPersistUtilsTest::suite());
     runner.addTest(CPolymorphicStackObjectCPtrTest::suite());
@@ -131,6 +140,7 @@ int main(int argc, const char** argv) {
     runner.addTest(CSmallVectorTest::suite());
     runner.addTest(CStateCompressorTest::suite());
     runner.addTest(CStateMachineTest::suite());
+    runner.addTest(CStaticThreadPoolTest::suite());
     runner.addTest(CStatisticsTest::suite());
     runner.addTest(CStopWatchTest::suite());
     runner.addTest(CStoredStringPtrTest::suite());
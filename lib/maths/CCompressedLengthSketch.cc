@@ -0,0 +1,105 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include <maths/CCompressedLengthSketch.h>
+
+#include <core/CMemory.h>
+
+#include <maths/CChecksum.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ml {
+namespace maths {
+namespace {
+//! The number of bits per literal in excess of the alphabet entropy.
+const double LITERAL_OVERHEAD_BITS{0.75};
+//! The number of bits per byte which is part of a back reference.
+const double MATCH_BITS{1.0};
+//! The number of bits per string boundary.
+const double STRING_BITS{4.0};
+//! The zlib header, trailer and block overhead in bytes.
+const double OVERHEAD_BYTES{14.0};
+//! The maximum number of distinct windows credited per set bit which
+//! stops the estimate diverging as the sketch saturates.
+const double MAXIMUM_INCREMENT{16.0};
+//! Multiplier used to spread the window hash.
+const uint64_t GOLDEN_RATIO{0x9e3779b97f4a7c15ULL};
+}
+
+const std::size_t CCompressedLengthSketch::DEFAULT_SIZE{4096};
+
+CCompressedLengthSketch::CCompressedLengthSketch(std::size_t size)
+    : m_Windows((std::max(size, std::size_t(64)) + 63) / 64, 0), m_Occupied(0),
+      m_Literals(0.0), m_Bytes(0), m_Strings(0) {
+}
+
+std::size_t CCompressedLengthSketch::sizeFor(std::size_t bytes) {
+    // Linear counting is accurate while at most half the bits are set
+    // and there are at most as many distinct windows as bytes.
+    std::size_t size{64};
+    while (size < 2 * bytes && size < DEFAULT_SIZE) {
+        size *= 2;
+    }
+    return size;
+}
+
+std::size_t CCompressedLengthSketch::size() const {
+    return 64 * m_Windows.size();
+}
+
+std::size_t CCompressedLengthSketch::bytes() const {
+    return m_Bytes;
+}
+
+void CCompressedLengthSketch::add(const std::string& value) {
+    uint64_t size{64 * m_Windows.size()};
+    double b{static_cast<double>(size)};
+    uint32_t window{0};
+    for (auto c : value) {
+        uint8_t byte{static_cast<uint8_t>(c)};
+        m_Alphabet.set(byte);
+        window = (window << 8) | byte;
+        uint64_t bit{((window * GOLDEN_RATIO) >> 40) % size};
+        uint64_t& word{m_Windows[bit >> 6]};
+        uint64_t mask{uint64_t(1) << (bit & 63)};
+        if ((word & mask) == 0) {
+            word |= mask;
+            m_Literals += std::min(b / (b - static_cast<double>(m_Occupied)),
+                                   MAXIMUM_INCREMENT);
+            ++m_Occupied;
+        }
+    }
+    m_Bytes += value.size();
+    ++m_Strings;
+}
+
+double CCompressedLengthSketch::length() const {
+    if (m_Strings == 0) {
+        return 0.0;
+    }
+    std::size_t alphabet{m_Alphabet.count()};
+    double bytes{static_cast<double>(m_Bytes)};
+    double literals{std::min(m_Literals, bytes)};
+    double bits{literals * (std::log2(static_cast<double>(std::max(alphabet, std::size_t(2)))) +
+                            LITERAL_OVERHEAD_BITS) +
+                (bytes - literals) * MATCH_BITS +
+                static_cast<double>(m_Strings) * STRING_BITS};
+    return bits / 8.0 + OVERHEAD_BYTES;
+}
+
+uint64_t CCompressedLengthSketch::checksum(uint64_t seed) const {
+    seed = CChecksum::calculate(seed, m_Windows);
+    seed = CChecksum::calculate(seed, m_Bytes);
+    return CChecksum::calculate(seed, m_Strings);
+}
+
+std::size_t CCompressedLengthSketch::memoryUsage() const {
+    return core::CMemory::dynamicSize(m_Windows);
+}
+}
+}
@@ -20,6 +20,7 @@
 #include <maths/CTools.h>
 
 #include <boost/array.hpp>
+#include <boost/bind.hpp>
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/adapted/boost_array.hpp>
 #include <boost/geometry/geometries/box.hpp>
@@ -102,17 +103,61 @@ const std::string MAXIMUM_COUNT_TAG("d");
 const std::string MOMENTS_TAG("e");
 const std::string MOST_CORRELATED_TAG("f");
 const std::string RNG_TAG("g");
+const std::string SEARCH_TAG("h");
 // Nested tags.
 const std::string CORRELATION_TAG("a");
 const std::string X_TAG("b");
 const std::string Y_TAG("c");
+const std::string SEARCH_PROJECTED_TAG("a");
+const std::string SEARCH_SEEDS_TAG("b");
+const std::string SEARCH_NEXT_TAG("c");
+const std::string SEARCH_NEIGHBOURS_TAG("d");
+const std::string SEARCH_MAXIMUM_COUNT_TAG("e");
+const std::string SEARCH_SIZE_TAG("f");
+const std::string SEARCH_MOST_CORRELATED_TAG("g");
 
 const double MINIMUM_FREQUENCY = 0.25;
 
 } // unnamed::
 
-CKMostCorrelated::CKMostCorrelated(std::size_t k, double decayRate, bool initialize)
-    : m_K(k), m_DecayRate(decayRate), m_MaximumCount(0.0) {
+//! \brief An r-tree of the projected variables.
+class CKMostCorrelated::CPointIndex : public bgi::rtree<TPointSizePr, bgi::quadratic<16>> {
+public:
+    using TRTree = bgi::rtree<TPointSizePr, bgi::quadratic<16>>;
+
+public:
+    CPointIndex(const TSizeVectorPackedBitVectorPrUMap& projected, const TSizeVec& variables)
+        : TRTree(points(projected, variables)) {}
+
+    //! Get the approximate memory used by this object.
+    //!
+    //! \note The leaves store copies of the points and the nodes'
+    //! bounding boxes add a comparable amount again.
+    std::size_t memoryUsage() const {
+        return sizeof(TRTree) + 2 * this->size() * sizeof(TPointSizePr);
+    }
+
+private:
+    static TPointSizePrVec points(const TSizeVectorPackedBitVectorPrUMap& projected,
+                                  const TSizeVec& variables) {
+        TPointSizePrVec result;
+        result.reserve(variables.size());
+        for (auto X : variables) {
+            auto x = projected.find(X);
+            if (x != projected.end()) {
+                result.emplace_back(x->second.first.to<double>().toBoostArray(), X);
+            }
+        }
+        LOG_TRACE(<< "# points = " << result.size());
+        return result;
+    }
+};
+
+CKMostCorrelated::CKMostCorrelated(std::size_t k,
+                                   double decayRate,
+                                   bool initialize,
+                                   bool incremental)
+    : m_K(k), m_DecayRate(decayRate), m_Incremental(incremental), m_MaximumCount(0.0) {
     if (initialize) {
         this->nextProjection();
     }
@@ -124,6 +169,7 @@ bool CKMostCorrelated::acceptRestoreTraverser(core::CStateRestoreTraverser& trav
     m_Projected.clear();
     m_Moments.clear();
     m_MostCorrelated.clear();
+    m_Search.clear();
 
     do {
         const std::string& name = traverser.name();
@@ -138,6 +184,8 @@ bool CKMostCorrelated::acceptRestoreTraverser(core::CStateRestoreTraverser& trav
         RESTORE(MOMENTS_TAG, core::CPersistUtils::restore(MOMENTS_TAG, m_Moments, traverser))
         RESTORE(MOST_CORRELATED_TAG,
                 core::CPersistUtils::restore(MOST_CORRELATED_TAG, m_MostCorrelated, traverser))
+        RESTORE(SEARCH_TAG, traverser.traverseSubLevel(boost::bind(
+                                &SSearch::acceptRestoreTraverser, &m_Search, _1)))
     } while (traverser.next());
 
     return true;
@@ -151,6 +199,10 @@ void CKMostCorrelated::acceptPersistInserter(core::CStatePersistInserter& insert
     inserter.insertValue(MAXIMUM_COUNT_TAG, m_MaximumCount);
     core::CPersistUtils::persist(MOMENTS_TAG, m_Moments, inserter);
     core::CPersistUtils::persist(MOST_CORRELATED_TAG, m_MostCorrelated, inserter);
+    if (m_Search.active()) {
+        inserter.insertLevel(SEARCH_TAG, boost::bind(&SSearch::acceptPersistInserter,
+                                                     &m_Search, _1));
+    }
 }
 
 void CKMostCorrelated::mostCorrelated(TSizeSizePrVec& result) const {
@@ -218,6 +270,7 @@ void CKMostCorrelated::removeVariables(const TSizeVec& remove) {
         if (remove[i] < m_Moments.size()) {
             m_Moments[remove[i]] = TMeanVarAccumulator();
             m_Projected.erase(remove[i]);
+            m_Search.s_Projected.erase(remove[i]);
             m_MostCorrelated.erase(std::remove_if(m_MostCorrelated.begin(),
                                                   m_MostCorrelated.end(),
                                                   CMatches(remove[i])),
@@ -277,6 +330,12 @@ void CKMostCorrelated::capture() {
     if (m_Projections.empty()) {
         LOG_TRACE(<< "# projections = " << m_Projected.size());
 
+        // Add the pairs found by searching the last projection. We do
+        // this before updating so they include the current projection.
+        if (m_Incremental) {
+            this->finishSearch();
+        }
+
         // For existing indices in the "most correlated" collection
         // compute the updated statistics.
         for (std::size_t i = 0u; i < m_MostCorrelated.size(); ++i) {
@@ -298,54 +357,30 @@ void CKMostCorrelated::capture() {
         }
         LOG_TRACE(<< "# projections = " << m_Projected.size());
 
-        // Find the "most correlated" collection for the current
-        // projections.
-        TCorrelationVec add;
-        this->mostCorrelated(add);
-
-        std::size_t N = m_MostCorrelated.size();
-        std::size_t n = add.size();
-        std::size_t desired = 2 * m_K;
-        std::size_t added = N < desired ? std::min(desired - N, n) : 0;
-        LOG_TRACE(<< "N = " << N << ", n = " << n << ", desired = " << desired
-                  << ", added = " << added);
-
-        if (added > 0) {
-            m_MostCorrelated.insert(m_MostCorrelated.end(), add.end() - added, add.end());
-        }
-        if (n > added) {
-            // When deciding which values to replace from the set [m_K, N) we
-            // do so at random with probability proportional to 1 - absolute
-            // correlation.
-
-            LOG_TRACE(<< "add = " << core::CContainerPrinter::print(add));
-
-            std::size_t vunerable = std::max(m_K, N - 3 * n);
-
-            TDoubleVec p;
-            p.reserve(std::min(N - m_K, 3 * n));
-            double Z = 0.0;
-            for (std::size_t i = vunerable; i < N; ++i) {
-                double oneMinusCorrelation = 1.0 - m_MostCorrelated[i].absCorrelation();
-                p.push_back(oneMinusCorrelation);
-                Z += oneMinusCorrelation;
-            }
-            if (Z > 0.0) {
-                for (std::size_t i = 0u; i < p.size(); ++i) {
-                    p[i] /= Z;
-                }
-                LOG_TRACE(<< "p = " << core::CContainerPrinter::print(p));
-
-                TSizeVec replace;
-                CSampling::categoricalSampleWithoutReplacement(m_Rng, p, n - added, replace);
-
-                for (std::size_t i = 1u; i <= n - added; ++i) {
-                    m_MostCorrelated[vunerable + replace[i - 1]] = add[n - added - i];
-                }
-            }
+        if (m_Incremental && m_MostCorrelated.size() >= 2 * m_K) {
+            // Search the current projections while capturing the next.
+            // Until the collection is full we search immediately so we
+            // find correlations as quickly as the batch search.
+            m_Search.s_Projected.swap(m_Projected);
+            this->startSearch(m_Search.s_Projected, true, m_Search);
+        } else {
+            // Find the "most correlated" collection for the current
+            // projections.
+            TCorrelationVec add;
+            this->mostCorrelated(add);
+            this->addMostCorrelated(add);
         }
 
         this->nextProjection();
+
+    } else if (m_Incremental && m_Search.active()) {
+        // Perform the search steps in proportion to the number of values
+        // of the current projection captured so far.
+        std::size_t captured{PROJECTION_DIMENSION - m_Projections.size()};
+        this->continueSearch(m_Search.s_Projected,
+                             (captured * m_Search.steps() + PROJECTION_DIMENSION - 1) /
+                                 PROJECTION_DIMENSION,
+                             m_Search);
     }
 }
 
@@ -357,7 +392,8 @@ uint64_t CKMostCorrelated::checksum(uint64_t seed) const {
     seed = CChecksum::calculate(seed, m_Projected);
     seed = CChecksum::calculate(seed, m_MaximumCount);
     seed = CChecksum::calculate(seed, m_Moments);
-    return CChecksum::calculate(seed, m_MostCorrelated);
+    seed = CChecksum::calculate(seed, m_MostCorrelated);
+    return CChecksum::calculate(seed, m_Search);
 }
 
 void CKMostCorrelated::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
@@ -367,6 +403,7 @@ void CKMostCorrelated::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem)
     core::CMemoryDebug::dynamicSize("m_Projected", m_Projected, mem);
     core::CMemoryDebug::dynamicSize("m_Moments", m_Moments, mem);
     core::CMemoryDebug::dynamicSize("m_MostCorrelated", m_MostCorrelated, mem);
+    m_Search.debugMemoryUsage(mem->addChild());
 }
 
 std::size_t CKMostCorrelated::memoryUsage() const {
@@ -375,116 +412,208 @@ std::size_t CKMostCorrelated::memoryUsage() const {
     mem += core::CMemory::dynamicSize(m_Projected);
     mem += core::CMemory::dynamicSize(m_Moments);
     mem += core::CMemory::dynamicSize(m_MostCorrelated);
+    mem += m_Search.memoryUsage();
     return mem;
 }
 
 void CKMostCorrelated::mostCorrelated(TCorrelationVec& result) const {
+    result.clear();
+
+    SSearch search;
+    this->startSearch(m_Projected, false, search);
+    this->continueSearch(m_Projected, search.steps(), search);
+
+    search.s_MostCorrelated.sort();
+    result.assign(search.s_MostCorrelated.begin(), search.s_MostCorrelated.end());
+    LOG_TRACE(<< "most correlated " << core::CContainerPrinter::print(result));
+}
+
+void CKMostCorrelated::startSearch(const TSizeVectorPackedBitVectorPrUMap& projected,
+                                   bool sorted,
+                                   SSearch& search) const {
     using TMaxDoubleAccumulator =
         CBasicStatistics::COrderStatisticsStack<double, 2, std::greater<double>>;
-    using TMaxCorrelationAccumulator = CBasicStatistics::COrderStatisticsHeap<SCorrelation>;
-    using TPointRTree = bgi::rtree<TPointSizePr, bgi::quadratic<16>>;
 
-    result.clear();
+    search.s_Variables.clear();
+    search.s_Seeds.clear();
+    search.s_Next = 0;
+    search.s_Index.reset();
 
     std::size_t N = m_MostCorrelated.size();
-    std::size_t V = m_Projected.size();
+    std::size_t V = projected.size();
     std::size_t desired = 2 * m_K;
     LOG_TRACE(<< "N = " << N << ", V = " << V << ", desired = " << desired);
-    if (V == 1) {
+    if (V <= 1) {
+        search.clear();
         return;
     }
 
-    TSizeSizePrUSet lookup;
-    for (std::size_t i = 0u; i < m_MostCorrelated.size(); ++i) {
-        std::size_t X = m_MostCorrelated[i].s_X;
-        std::size_t Y = m_MostCorrelated[i].s_Y;
-        lookup.insert(std::make_pair(std::min(X, Y), std::max(X, Y)));
-    }
-
     std::size_t replace = std::max(
         static_cast<std::size_t>(REPLACE_FRACTION * static_cast<double>(desired) + 0.5),
         std::max(desired - N, std::size_t(1)));
     LOG_TRACE(<< "replace = " << replace);
 
-    TMaxCorrelationAccumulator mostCorrelated(replace);
+    search.s_Size = replace;
+    search.s_MostCorrelated = TMaxCorrelationAccumulator(replace);
+    search.s_Variables.reserve(V);
+    for (const auto& x : projected) {
+        search.s_Variables.push_back(x.first);
+    }
+    if (sorted) {
+        // The seeds are positions in s_Variables so its order must be
+        // reproducible after restoring the search.
+        std::sort(search.s_Variables.begin(), search.s_Variables.end());
+    }
 
     if (10 * replace > V * (V - 1)) {
         LOG_TRACE(<< "Exhaustive search");
 
-        for (TSizeVectorPackedBitVectorPrUMapCItr x = m_Projected.begin();
-             x != m_Projected.end(); ++x) {
-            std::size_t X = x->first;
-            TSizeVectorPackedBitVectorPrUMapCItr y = x;
-            while (++y != m_Projected.end()) {
-                std::size_t Y = y->first;
-                if (lookup.count(std::make_pair(std::min(X, Y), std::max(X, Y))) == 0) {
-                    SCorrelation cxy(X, x->second.first, x->second.second, Y,
-                                     y->second.first, y->second.second);
-                    mostCorrelated.add(cxy);
+        TSizeSizePrUSet lookup;
+        for (const auto& correlation : m_MostCorrelated) {
+            lookup.emplace(correlation.s_X, correlation.s_Y);
+        }
+
+        for (std::size_t i = 0u; i < V; ++i) {
+            std::size_t X = search.s_Variables[i];
+            const TVectorPackedBitVectorPr& px = projected.at(X);
+            for (std::size_t j = i + 1; j < V; ++j) {
+                std::size_t Y = search.s_Variables[j];
+                if (lookup.count(std::make_pair(X, Y)) == 0) {
+                    const TVectorPackedBitVectorPr& py = projected.at(Y);
+                    search.s_MostCorrelated.add(
+                        SCorrelation(X, px.first, px.second, Y, py.first, py.second));
                 }
             }
         }
+        search.s_Next = search.steps();
+        return;
+    }
+
+    LOG_TRACE(<< "Nearest neighbour search");
+
+    // 1) Build an r-tree,
+    // 2) Lookup up V / replace nearest neighbours of each point
+    //    and its negative to initialise search,
+    // 3) Create a predicate with separation corresponding to the
+    //    smallest correlation,
+    // 4) Search for neighbours of each point and its negative for
+    //    points in range updating the predicate in the loop with
+    //    the new least correlated variable.
+    //
+    // Steps 2) and 4) are performed by continueSearch.
+
+    // Bound the correlation based on the sparsity of the metric.
+    TMaxDoubleAccumulator fmax;
+    double dimension = 0.0;
+    for (const auto& x : projected) {
+        const CPackedBitVector& ix = x.second.second;
+        dimension = static_cast<double>(ix.dimension());
+        fmax.add(ix.manhattan() / dimension);
+    }
+    fmax.sort();
+    if (fmax[1] <= MINIMUM_FREQUENCY) {
+        search.clear();
+        return;
+    }
+    search.s_MaximumCount = fmax[1] * dimension;
+
+    search.s_Neighbours = replace / V + 1;
+    LOG_TRACE(<< "k = " << search.s_Neighbours);
+
+    // The nearest neighbour search is very slow compared with
+    // the search over the smallest correlation box predicate
+    // so we use a small number of seed variables if V is large
+    // compared to the number to replace.
+    if (2 * replace < V) {
+        CSampling::uniformSample(m_Rng, 0, V, 2 * replace, search.s_Seeds);
+        std::sort(search.s_Seeds.begin(), search.s_Seeds.end());
+        search.s_Seeds.erase(std::unique(search.s_Seeds.begin(), search.s_Seeds.end()),
+                             search.s_Seeds.end());
     } else {
-        LOG_TRACE(<< "Nearest neighbour search");
-
-        // 1) Build an r-tree,
-        // 2) Lookup up V / replace nearest neighbours of each point
-        //    and its negative to initialise search,
-        // 3) Create a predicate with separation corresponding to the
-        //    smallest correlation,
-        // 4) Search for neighbours of each point and its negative for
-        //    points in range updating the predicate in the loop with
-        //    the new least correlated variable.
-
-        // Bound the correlation based on the sparsity of the metric.
-        TMaxDoubleAccumulator fmax;
-        double dimension = 0.0;
-        for (TSizeVectorPackedBitVectorPrUMapCItr i = m_Projected.begin();
-             i != m_Projected.end(); ++i) {
-            const CPackedBitVector& ix = i->second.second;
-            dimension = static_cast<double>(ix.dimension());
-            fmax.add(ix.manhattan() / dimension);
-        }
-        fmax.sort();
-        if (fmax[1] <= MINIMUM_FREQUENCY) {
-            return;
-        }
-        double amax = fmax[1] * dimension;
+        search.s_Seeds.reserve(V);
+        search.s_Seeds.assign(boost::counting_iterator<std::size_t>(0),
+                              boost::counting_iterator<std::size_t>(V));
+    }
 
-        TPointSizePrVec points;
-        points.reserve(m_Projected.size());
-        for (TSizeVectorPackedBitVectorPrUMapCItr i = m_Projected.begin();
-             i != m_Projected.end(); ++i) {
-            points.emplace_back(i->second.first.to<double>().toBoostArray(), i->first);
-        }
-        LOG_TRACE(<< "# points = " << points.size());
-
-        unsigned int k = static_cast<unsigned int>(replace / V + 1);
-        LOG_TRACE(<< "k = " << k);
-
-        // The nearest neighbour search is very slow compared with
-        // the search over the smallest correlation box predicate
-        // so we use a small number of seed variables if V is large
-        // compared to the number to replace.
-        TSizeVec seeds;
-        if (2 * replace < V) {
-            CSampling::uniformSample(m_Rng, 0, V, 2 * replace, seeds);
-            std::sort(seeds.begin(), seeds.end());
-            seeds.erase(std::unique(seeds.begin(), seeds.end()), seeds.end());
-        } else {
-            seeds.reserve(V);
-            seeds.assign(boost::counting_iterator<std::size_t>(0),
-                         boost::counting_iterator<std::size_t>(V));
+    try {
+        search.s_Index = std::make_shared<const CPointIndex>(projected, search.s_Variables);
+    } catch (const std::exception& e) {
+        LOG_ERROR(<< "Failed to compute most correlated " << e.what());
+        search.clear();
+    }
+}
+
+void CKMostCorrelated::continueSearch(const TSizeVectorPackedBitVectorPrUMap& projected,
+                                      std::size_t end,
+                                      SSearch& search) const {
+    end = std::min(end, search.steps());
+    if (search.s_Next >= end) {
+        return;
+    }
+
+    TMaxCorrelationAccumulator& mostCorrelated = search.s_MostCorrelated;
+
+    TSizeSizePrUSet lookup;
+    for (const auto& correlation : m_MostCorrelated) {
+        lookup.emplace(correlation.s_X, correlation.s_Y);
+    }
+    for (const auto& correlation : mostCorrelated) {
+        lookup.emplace(correlation.s_X, correlation.s_Y);
+    }
+
+    // When the incremental search is off we keep the batch search's check
+    // for a full accumulator, which compares with the desired collection
+    // size rather than the accumulator's capacity, so the correlations we
+    // keep don't change. The incremental search frees the lookup entry of
+    // each correlation it evicts so that pair can be found again.
+    std::size_t full{m_Incremental ? search.s_Size : 2 * m_K};
+
+    auto add = [&](std::size_t X, const TVectorPackedBitVectorPr& px,
+                   const TPointSizePrVec& nearest) {
+        for (std::size_t j = 0u; j < nearest.size(); ++j) {
+            std::size_t Y = nearest[j].second;
+            auto py = projected.find(Y);
+            if (py == projected.end()) {
+                continue;
+            }
+            std::size_t n = mostCorrelated.count();
+            std::size_t S = n == full ? mostCorrelated.biggest().s_X : 0;
+            std::size_t T = n == full ? mostCorrelated.biggest().s_Y : 0;
+            SCorrelation cxy(X, px.first, px.second, Y, py->second.first,
+                             py->second.second);
+            if (lookup.count(std::make_pair(cxy.s_X, cxy.s_Y)) > 0) {
+                continue;
+            }
+            if (mostCorrelated.add(cxy)) {
+                if (n == full) {
+                    lookup.erase(std::make_pair(S, T));
+                }
+                lookup.emplace(cxy.s_X, cxy.s_Y);
+            }
         }
+    };
 
-        try {
-            TPointRTree rtree(points);
-            TPointSizePrVec nearest;
-            for (std::size_t i = 0u; i < seeds.size(); ++i) {
-                std::size_t X = points[seeds[i]].second;
-                const TVectorPackedBitVectorPr& px = m_Projected.at(X);
+    try {
+        if (search.s_Index == nullptr) {
+            search.s_Index = std::make_shared<const CPointIndex>(projected, search.s_Variables);
+        }
+        const CPointIndex& rtree = *search.s_Index;
+        unsigned int k = static_cast<unsigned int>(search.s_Neighbours);
+
+        TPointSizePrVec nearest;
+        for (/**/; search.s_Next < end; ++search.s_Next) {
+            bool seed = search.s_Next < search.s_Seeds.size();
+            std::size_t X = search.s_Variables[seed ? search.s_Seeds[search.s_Next]
+                                                    : search.s_Next -
+                                                          search.s_Seeds.size()];
+            auto x = projected.find(X);
+            if (x == projected.end()) {
+                continue;
+            }
+            const TVectorPackedBitVectorPr& px = x->second;
 
-                nearest.clear();
+            nearest.clear();
+            if (seed) {
                 bgi::query(rtree,
                            bgi::satisfies(CNotEqual(X)) &&
                                bgi::satisfies(CPairNotIn(lookup, X)) &&
@@ -495,38 +624,12 @@ void CKMostCorrelated::mostCorrelated(TCorrelationVec& result) const {
                                bgi::satisfies(CPairNotIn(lookup, X)) &&
                                bgi::nearest((-px.first.to<double>()).toBoostArray(), k),
                            std::back_inserter(nearest));
-
-                for (std::size_t j = 0u; j < nearest.size(); ++j) {
-                    std::size_t n = mostCorrelated.count();
-                    std::size_t S = n == desired ? mostCorrelated.biggest().s_X : 0;
-                    std::size_t T = n == desired ? mostCorrelated.biggest().s_Y : 0;
-                    std::size_t Y = nearest[j].second;
-                    const TVectorPackedBitVectorPr& py = m_Projected.at(Y);
-                    SCorrelation cxy(X, px.first, px.second, Y, py.first, py.second);
-                    if (lookup.count(std::make_pair(cxy.s_X, cxy.s_Y)) > 0) {
-                        continue;
-                    }
-                    if (mostCorrelated.add(cxy)) {
-                        if (n == desired) {
-                            lookup.erase(std::make_pair(S, T));
-                        }
-                        lookup.insert(std::make_pair(cxy.s_X, cxy.s_Y));
-                    }
-                }
-            }
-            LOG_TRACE(<< "# seeds = " << mostCorrelated.count());
-            LOG_TRACE(<< "seed most correlated = " << mostCorrelated);
-
-            for (std::size_t i = 0u; i < points.size(); ++i) {
+            } else if (mostCorrelated.count() > 0) {
                 const SCorrelation& biggest = mostCorrelated.biggest();
-                double threshold = biggest.distance(amax);
+                double threshold = biggest.distance(search.s_MaximumCount);
                 LOG_TRACE(<< "threshold = " << threshold);
 
-                std::size_t X = points[i].second;
-                const TVectorPackedBitVectorPr& px = m_Projected.at(X);
-
                 TVector width(std::sqrt(threshold));
-                nearest.clear();
                 {
                     bgm::box<TPoint> box((px.first - width).to<double>().toBoostArray(),
                                          (px.first + width).to<double>().toBoostArray());
@@ -548,34 +651,80 @@ void CKMostCorrelated::mostCorrelated(TCorrelationVec& result) const {
                                std::back_inserter(nearest));
                 }
                 LOG_TRACE(<< "# candidates = " << nearest.size());
-
-                for (std::size_t j = 0u; j < nearest.size(); ++j) {
-                    std::size_t n = mostCorrelated.count();
-                    std::size_t S = n == desired ? mostCorrelated.biggest().s_X : 0;
-                    std::size_t T = n == desired ? mostCorrelated.biggest().s_Y : 0;
-                    std::size_t Y = nearest[j].second;
-                    const TVectorPackedBitVectorPr& py = m_Projected.at(Y);
-                    SCorrelation cxy(X, px.first, px.second, Y, py.first, py.second);
-                    if (lookup.count(std::make_pair(cxy.s_X, cxy.s_Y)) > 0) {
-                        continue;
-                    }
-                    if (mostCorrelated.add(cxy)) {
-                        if (n == desired) {
-                            lookup.erase(std::make_pair(S, T));
-                        }
-                        lookup.insert(std::make_pair(cxy.s_X, cxy.s_Y));
-                    }
-                }
             }
-        } catch (const std::exception& e) {
-            LOG_ERROR(<< "Failed to compute most correlated " << e.what());
-            return;
+
+            add(X, px, nearest);
         }
+    } catch (const std::exception& e) {
+        LOG_ERROR(<< "Failed to compute most correlated " << e.what());
+        search.s_Next = search.steps();
     }
+}
 
-    mostCorrelated.sort();
-    result.assign(mostCorrelated.begin(), mostCorrelated.end());
-    LOG_TRACE(<< "most correlated " << core::CContainerPrinter::print(result));
+void CKMostCorrelated::finishSearch() {
+    if (m_Search.active() == false) {
+        return;
+    }
+
+    this->continueSearch(m_Search.s_Projected, m_Search.steps(), m_Search);
+
+    // Variables may have been removed since the search started.
+    TCorrelationVec add;
+    m_Search.s_MostCorrelated.sort();
+    add.reserve(m_Search.s_MostCorrelated.count());
+    for (const auto& correlation : m_Search.s_MostCorrelated) {
+        if (m_Search.s_Projected.count(correlation.s_X) > 0 &&
+            m_Search.s_Projected.count(correlation.s_Y) > 0) {
+            add.push_back(correlation);
+        }
+    }
+    m_Search.clear();
+
+    this->addMostCorrelated(add);
+}
+
+void CKMostCorrelated::addMostCorrelated(const TCorrelationVec& add) {
+    std::size_t N = m_MostCorrelated.size();
+    std::size_t n = add.size();
+    std::size_t desired = 2 * m_K;
+    std::size_t added = N < desired ? std::min(desired - N, n) : 0;
+    LOG_TRACE(<< "N = " << N << ", n = " << n << ", desired = " << desired
+              << ", added = " << added);
+
+    if (added > 0) {
+        m_MostCorrelated.insert(m_MostCorrelated.end(), add.end() - added, add.end());
+    }
+    if (n > added) {
+        // When deciding which values to replace from the set [m_K, N) we
+        // do so at random with probability proportional to 1 - absolute
+        // correlation.
+
+        LOG_TRACE(<< "add = " << core::CContainerPrinter::print(add));
+
+        std::size_t vunerable = std::max(m_K, N - 3 * n);
+
+        TDoubleVec p;
+        p.reserve(std::min(N - m_K, 3 * n));
+        double Z = 0.0;
+        for (std::size_t i = vunerable; i < N; ++i) {
+            double oneMinusCorrelation = 1.0 - m_MostCorrelated[i].absCorrelation();
+            p.push_back(oneMinusCorrelation);
+            Z += oneMinusCorrelation;
+        }
+        if (Z > 0.0) {
+            for (std::size_t i = 0u; i < p.size(); ++i) {
+                p[i] /= Z;
+            }
+            LOG_TRACE(<< "p = " << core::CContainerPrinter::print(p));
+
+            TSizeVec replace;
+            CSampling::categoricalSampleWithoutReplacement(m_Rng, p, n - added, replace);
+
+            for (std::size_t i = 1u; i <= n - added; ++i) {
+                m_MostCorrelated[vunerable + replace[i - 1]] = add[n - added - i];
+            }
+        }
+    }
 }
 
 void CKMostCorrelated::nextProjection() {
@@ -766,6 +915,104 @@ std::string CKMostCorrelated::SCorrelation::print() const {
            core::CStringUtils::typeToString(s_Y);
 }
 
+CKMostCorrelated::SSearch::SSearch()
+    : s_Next(0), s_Neighbours(0), s_MaximumCount(0.0), s_Size(0), s_MostCorrelated(1) {
+}
+
+bool CKMostCorrelated::SSearch::acceptRestoreTraverser(core::CStateRestoreTraverser& traverser) {
+    TCorrelationVec mostCorrelated;
+    do {
+        const std::string& name = traverser.name();
+        RESTORE(SEARCH_PROJECTED_TAG,
+                core::CPersistUtils::restore(SEARCH_PROJECTED_TAG, s_Projected, traverser))
+        RESTORE(SEARCH_SEEDS_TAG,
+                core::CPersistUtils::restore(SEARCH_SEEDS_TAG, s_Seeds, traverser))
+        RESTORE_BUILT_IN(SEARCH_NEXT_TAG, s_Next)
+        RESTORE_BUILT_IN(SEARCH_NEIGHBOURS_TAG, s_Neighbours)
+        RESTORE_BUILT_IN(SEARCH_MAXIMUM_COUNT_TAG, s_MaximumCount)
+        RESTORE_BUILT_IN(SEARCH_SIZE_TAG, s_Size)
+        RESTORE(SEARCH_MOST_CORRELATED_TAG,
+                core::CPersistUtils::restore(SEARCH_MOST_CORRELATED_TAG, mostCorrelated, traverser))
+    } while (traverser.next());
+
+    s_Variables.clear();
+    s_Variables.reserve(s_Projected.size());
+    for (const auto& x : s_Projected) {
+        s_Variables.push_back(x.first);
+    }
+    std::sort(s_Variables.begin(), s_Variables.end());
+    s_MostCorrelated = TMaxCorrelationAccumulator(std::max(s_Size, std::size_t(1)));
+    for (const auto& correlation : mostCorrelated) {
+        s_MostCorrelated.add(correlation);
+    }
+
+    return true;
+}
+
+void CKMostCorrelated::SSearch::acceptPersistInserter(core::CStatePersistInserter& inserter) const {
+    // The order of the accumulated pairs depends on the order in which
+    // they were added so we persist them sorted.
+    TCorrelationVec mostCorrelated(s_MostCorrelated.begin(), s_MostCorrelated.end());
+    std::sort(mostCorrelated.begin(), mostCorrelated.end());
+    core::CPersistUtils::persist(SEARCH_PROJECTED_TAG, s_Projected, inserter);
+    core::CPersistUtils::persist(SEARCH_SEEDS_TAG, s_Seeds, inserter);
+    inserter.insertValue(SEARCH_NEXT_TAG, s_Next);
+    inserter.insertValue(SEARCH_NEIGHBOURS_TAG, s_Neighbours);
+    inserter.insertValue(SEARCH_MAXIMUM_COUNT_TAG, s_MaximumCount);
+    inserter.insertValue(SEARCH_SIZE_TAG, s_Size);
+    core::CPersistUtils::persist(SEARCH_MOST_CORRELATED_TAG, mostCorrelated, inserter);
+}
+
+bool CKMostCorrelated::SSearch::active() const {
+    return s_Variables.size() > 0;
+}
+
+std::size_t CKMostCorrelated::SSearch::steps() const {
+    return s_Seeds.size() + s_Variables.size();
+}
+
+void CKMostCorrelated::SSearch::clear() {
+    s_Projected.clear();
+    s_Variables.clear();
+    s_Seeds.clear();
+    s_Next = 0;
+    s_Neighbours = 0;
+    s_MaximumCount = 0.0;
+    s_Size = 0;
+    s_MostCorrelated.clear();
+    s_Index.reset();
+}
+
+uint64_t CKMostCorrelated::SSearch::checksum(uint64_t seed) const {
+    TCorrelationVec mostCorrelated(s_MostCorrelated.begin(), s_MostCorrelated.end());
+    std::sort(mostCorrelated.begin(), mostCorrelated.end());
+    seed = CChecksum::calculate(seed, s_Projected);
+    seed = CChecksum::calculate(seed, s_Seeds);
+    seed = CChecksum::calculate(seed, s_Next);
+    seed = CChecksum::calculate(seed, s_Neighbours);
+    seed = CChecksum::calculate(seed, s_MaximumCount);
+    seed = CChecksum::calculate(seed, s_Size);
+    return CChecksum::calculate(seed, mostCorrelated);
+}
+
+void CKMostCorrelated::SSearch::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    mem->setName("SSearch");
+    core::CMemoryDebug::dynamicSize("s_Projected", s_Projected, mem);
+    core::CMemoryDebug::dynamicSize("s_Variables", s_Variables, mem);
+    core::CMemoryDebug::dynamicSize("s_Seeds", s_Seeds, mem);
+    mem->addItem("s_MostCorrelated", s_MostCorrelated.count() * sizeof(SCorrelation));
+    mem->addItem("s_Index", s_Index != nullptr ? s_Index->memoryUsage() : 0);
+}
+
+std::size_t CKMostCorrelated::SSearch::memoryUsage() const {
+    std::size_t mem = core::CMemory::dynamicSize(s_Projected);
+    mem += core::CMemory::dynamicSize(s_Variables);
+    mem += core::CMemory::dynamicSize(s_Seeds);
+    mem += s_MostCorrelated.count() * sizeof(SCorrelation);
+    mem += s_Index != nullptr ? s_Index->memoryUsage() : 0;
+    return mem;
+}
+
 CKMostCorrelated::CMatches::CMatches(std::size_t x) : m_X(x) {
 }
 
@@ -10,12 +10,104 @@
 
 #include <boost/math/distributions/normal.hpp>
 
+#include <cmath>
+#include <limits>
+
 namespace ml {
 namespace maths {
 namespace linear_algebra_tools_detail {
 
 namespace {
 
+//! The multiple of the SVD's rank threshold which the ratio of the smallest
+//! to the largest eigenvalue must exceed for us to use the closed form.
+const double SMALL_MATRIX_CONDITION_MARGIN{100.0};
+
+//! \brief Closed form kernels for 2x2 and 3x3 positive definite matrices.
+//!
+//! DESCRIPTION:\n
+//! Factorizing the small matrices which arise for lat_long and correlated
+//! pairs of time series directly avoids setting up a Jacobi SVD. This is
+//! only used when it is certain the SVD would find the matrix has full
+//! rank: the smallest eigenvalue is at least det / trace^(d-1) and the
+//! largest at most the trace so we require the determinant to be safely
+//! greater than the SVD's rank threshold times trace^d. Otherwise callers
+//! fall back to the SVD so that the handling of matrices which are singular
+//! to working precision is unchanged.
+class CSmallCholesky {
+public:
+    //! Try to factorize the \p d x \p d matrix \p m.
+    //!
+    //! \return True if \p m is safely positive definite.
+    template<typename MATRIX>
+    bool factorize(std::size_t d, const MATRIX& m) {
+        if (d != 2 && d != 3) {
+            return false;
+        }
+        m_D = d;
+        double trace{0.0};
+        for (std::size_t i = 0u; i < d; ++i) {
+            trace += m(i, i);
+        }
+        if (!(trace > 0.0)) {
+            return false;
+        }
+        double det{1.0};
+        for (std::size_t j = 0u; j < d; ++j) {
+            double pivot{m(j, j)};
+            for (std::size_t k = 0u; k < j; ++k) {
+                pivot -= m_L[j][k] * m_L[j][k];
+            }
+            if (!(pivot > 0.0)) {
+                return false;
+            }
+            m_L[j][j] = std::sqrt(pivot);
+            det *= pivot;
+            for (std::size_t i = j + 1; i < d; ++i) {
+                double lij{m(i, j)};
+                for (std::size_t k = 0u; k < j; ++k) {
+                    lij -= m_L[i][k] * m_L[j][k];
+                }
+                m_L[i][j] = lij / m_L[j][j];
+            }
+        }
+        double threshold{static_cast<double>(d) * std::numeric_limits<double>::epsilon()};
+        if (!(det > SMALL_MATRIX_CONDITION_MARGIN * threshold * std::pow(trace, d))) {
+            return false;
+        }
+        m_LogDeterminant = std::log(det);
+        return true;
+    }
+
+    //! Get the log of the determinant.
+    double logDeterminant() const { return m_LogDeterminant; }
+
+    //! Compute \f$x^tM^{-1}x\f$ for the factorized matrix M.
+    template<typename VECTOR>
+    double inverseQuadraticProduct(const VECTOR& x) const {
+        // Solve L z = x so x^t M^{-1} x = z^t z.
+        double z[3];
+        double result{0.0};
+        for (std::size_t i = 0u; i < m_D; ++i) {
+            double zi{x(i)};
+            for (std::size_t k = 0u; k < i; ++k) {
+                zi -= m_L[i][k] * z[k];
+            }
+            z[i] = zi / m_L[i][i];
+            result += z[i] * z[i];
+        }
+        return result;
+    }
+
+private:
+    //! The dimension.
+    std::size_t m_D = 0;
+    //! The lower triangular Cholesky factor.
+    double m_L[3][3];
+    //! The log of the determinant of the factorized matrix.
+    double m_LogDeterminant = 0.0;
+};
+
 //! \brief Shared implementation of the inverse quadratic product.
 template<typename EIGENMATRIX, typename EIGENVECTOR>
 class CInverseQuadraticProduct {
@@ -33,6 +125,12 @@ public:
 
         result = core::constants::LOG_MAX_DOUBLE + 1.0;
 
+        CSmallCholesky cholesky;
+        if (cholesky.factorize(d, covariance_)) {
+            result = cholesky.inverseQuadraticProduct(residual);
+            return maths_t::E_FpNoErrors;
+        }
+
         switch (d) {
         case 1:
             if (covariance_(0, 0) == 0.0) {
@@ -79,6 +177,14 @@ public:
                                                       bool ignoreSingularSubspace) {
         result = core::constants::LOG_MIN_DOUBLE - 1.0;
 
+        CSmallCholesky cholesky;
+        if (cholesky.factorize(d, covariance_)) {
+            result = -0.5 * (cholesky.inverseQuadraticProduct(residual) +
+                             static_cast<double>(d) * core::constants::LOG_TWO_PI +
+                             cholesky.logDeterminant());
+            return maths_t::E_FpNoErrors;
+        }
+
         switch (d) {
         case 1:
             if (covariance_(0, 0) == 0.0) {
@@ -199,6 +305,12 @@ public:
     compute(std::size_t d, const MATRIX& m_, double& result, bool ignoreSingularSubspace) {
         result = core::constants::LOG_MIN_DOUBLE - 1.0;
 
+        CSmallCholesky cholesky;
+        if (cholesky.factorize(d, m_)) {
+            result = cholesky.logDeterminant();
+            return maths_t::E_FpNoErrors;
+        }
+
         switch (d) {
         case 1:
             if (m_(0, 0) == 0.0) {
@@ -76,7 +76,10 @@ CModelParams::CModelParams(core_t::TTime bucketLength,
       m_MinimumSeasonalVarianceScale(minimumSeasonalVarianceScale),
       m_MinimumTimeToDetectChange(std::max(minimumTimeToDetectChange, 6 * bucketLength)),
       m_MaximumTimeToTestForChange(std::max(maximumTimeToTestForChange, 12 * bucketLength)),
-      m_ProbabilityBucketEmpty(0.0) {
+      m_ProbabilityBucketEmpty(0.0),
+      m_MaximumNumberActiveChangeDetectors(std::numeric_limits<std::size_t>::max()),
+      m_ChangeDetectorToken(
+          std::make_shared<TChangeDetectorTokenPtr>(std::make_shared<const bool>(true))) {
 }
 
 core_t::TTime CModelParams::bucketLength() const {
@@ -119,6 +122,24 @@ double CModelParams::probabilityBucketEmpty() const {
     return m_ProbabilityBucketEmpty;
 }
 
+void CModelParams::maximumNumberActiveChangeDetectors(std::size_t number) {
+    m_MaximumNumberActiveChangeDetectors = number;
+}
+
+std::size_t CModelParams::maximumNumberActiveChangeDetectors() const {
+    return m_MaximumNumberActiveChangeDetectors;
+}
+
+std::size_t CModelParams::numberActiveChangeDetectors() const {
+    return static_cast<std::size_t>(m_ChangeDetectorToken->use_count() - 1);
+}
+
+CModelParams::TChangeDetectorTokenPtr CModelParams::changeDetectorToken(bool force) const {
+    return force || this->numberActiveChangeDetectors() < m_MaximumNumberActiveChangeDetectors
+               ? *m_ChangeDetectorToken
+               : TChangeDetectorTokenPtr{};
+}
+
 CModelAddSamplesParams::CModelAddSamplesParams()
     : m_Type(maths_t::E_MixedData), m_IsNonNegative(false),
       m_PropagationInterval(1.0), m_TrendWeights(nullptr), m_PriorWeights(nullptr) {
@@ -215,6 +236,11 @@ CModelProbabilityParams& CModelProbabilityParams::addBucketEmpty(const TBool2Vec
     return *this;
 }
 
+CModelProbabilityParams& CModelProbabilityParams::bucketEmpty(const TBool2Vec1Vec& empty) {
+    m_BucketEmpty = empty;
+    return *this;
+}
+
 const CModelProbabilityParams::TBool2Vec1Vec& CModelProbabilityParams::bucketEmpty() const {
     return m_BucketEmpty;
 }
@@ -254,6 +254,101 @@ const std::string DECAY_RATE_TAG("h");
 const std::string EMPTY_STRING;
 }
 
+//! \brief The expected category probabilities sorted into increasing
+//! order together with the probabilities of less likely categories.
+//!
+//! DESCRIPTION:\n
+//! Computing this is O(k log(k)) for k categories and it only changes
+//! when the concentrations change so we cache it. This means that the
+//! probability calculations are a binary search in the typical case
+//! that they're computed for many samples between updates.
+class CMultinomialConjugate::CLessLikelyCategories {
+public:
+    CLessLikelyCategories(const TDoubleVec& concentrations, double totalConcentration)
+        : m_Pu(0.0), m_Pl(0.0) {
+        m_Probabilities.reserve(concentrations.size());
+        double r = 1.0 / static_cast<double>(concentrations.size());
+        for (std::size_t i = 0u; i < concentrations.size(); ++i) {
+            double p = concentrations[i] / totalConcentration;
+            m_Probabilities.emplace_back(p, p, i);
+            m_Pu += r - p;
+        }
+        std::sort(m_Probabilities.begin(), m_Probabilities.end());
+        LOG_TRACE(<< "p = " << core::CContainerPrinter::print(m_Probabilities));
+
+        // Get the index of largest probability less than or equal to P(U).
+        std::size_t l = m_Probabilities.size();
+        if (m_Pu > 0.0) {
+            l = std::lower_bound(m_Probabilities.begin(), m_Probabilities.end(),
+                                 TDoubleDoubleSizeTr(m_Pu, m_Pu, 0)) -
+                m_Probabilities.begin();
+        }
+
+        // Compute probabilities of less likely categories.
+        double pCumulative = 0.0;
+        for (std::size_t i = 0u, j = 0u; i < m_Probabilities.size(); /**/) {
+            // Find the probability equal range [i, j).
+            double p = m_Probabilities[i].get<1>();
+            pCumulative += p;
+            while (++j < m_Probabilities.size() && m_Probabilities[j].get<1>() == p) {
+                pCumulative += p;
+            }
+
+            // Update the equal range probabilities [i, j).
+            for (/**/; i < j; ++i) {
+                m_Probabilities[i].get<1>() = pCumulative;
+            }
+        }
+
+        if (l < m_Probabilities.size()) {
+            m_Pl = m_Probabilities[l].get<1>();
+        }
+
+        m_Positions.resize(m_Probabilities.size());
+        for (std::size_t i = 0u; i < m_Probabilities.size(); ++i) {
+            m_Positions[m_Probabilities[i].get<2>()] = i;
+        }
+    }
+
+    //! Get the triples (E[p(i)], P(i), i) sorted by E[p(i)] where P(i)
+    //! is the probability of a less likely category.
+    const TDoubleDoubleSizeTrVec& probabilities() const {
+        return m_Probabilities;
+    }
+
+    //! Get the position of the category \p i in probabilities().
+    std::size_t position(std::size_t i) const { return m_Positions[i]; }
+
+    //! Get the probability of the categories we haven't counted.
+    double pU() const { return m_Pu; }
+
+    //! Get the probability of less likely categories for the smallest
+    //! probability greater than or equal to P(U).
+    double pl() const { return m_Pl; }
+
+    //! Debug the memory used by this object.
+    void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
+        mem->setName("CLessLikelyCategories");
+        core::CMemoryDebug::dynamicSize("m_Probabilities", m_Probabilities, mem);
+        core::CMemoryDebug::dynamicSize("m_Positions", m_Positions, mem);
+    }
+
+    //! Get the memory used by this object.
+    std::size_t memoryUsage() const {
+        return core::CMemory::dynamicSize(m_Probabilities) +
+               core::CMemory::dynamicSize(m_Positions);
+    }
+
+private:
+    using TSizeVec = std::vector<std::size_t>;
+
+private:
+    TDoubleDoubleSizeTrVec m_Probabilities;
+    TSizeVec m_Positions;
+    double m_Pu;
+    double m_Pl;
+};
+
 CMultinomialConjugate::CMultinomialConjugate()
     : m_NumberAvailableCategories(0), m_TotalConcentration(0.0) {
 }
@@ -314,6 +409,7 @@ bool CMultinomialConjugate::acceptRestoreTraverser(core::CStateRestoreTraverser&
                                this->numberSamples(numberSamples))
     } while (traverser.next());
 
+    m_LessLikelyCategories.reset();
     this->shrink();
 
     return true;
@@ -325,6 +421,7 @@ void CMultinomialConjugate::swap(CMultinomialConjugate& other) {
     m_Categories.swap(other.m_Categories);
     m_Concentrations.swap(other.m_Concentrations);
     std::swap(m_TotalConcentration, other.m_TotalConcentration);
+    m_LessLikelyCategories.swap(other.m_LessLikelyCategories);
 }
 
 CMultinomialConjugate CMultinomialConjugate::nonInformativePrior(std::size_t maximumNumberOfCategories,
@@ -372,6 +469,7 @@ void CMultinomialConjugate::addSamples(const TDouble1Vec& samples,
     }
 
     this->CPrior::addSamples(samples, weights);
+    m_LessLikelyCategories.reset();
 
     // If x = {x(i)} denotes the sample vector, then x are multinomially
     // distributed with probabilities {p(i)}. Let n(i) denote the counts
@@ -473,6 +571,9 @@ void CMultinomialConjugate::propagateForwardsByTime(double time) {
     }
 
     m_TotalConcentration *= factor;
+    if (factor != 1.0) {
+        m_LessLikelyCategories.reset();
+    }
 
     this->numberSamples(this->numberSamples() * factor);
 
@@ -954,132 +1055,95 @@ bool CMultinomialConjugate::probabilityOfLessLikelySamples(maths_t::EProbability
         // sharp.
 
         using TSizeVec = std::vector<std::size_t>;
+        using TSizeDoublePr = std::pair<std::size_t, double>;
+        using TSizeDoublePrVec = std::vector<TSizeDoublePr>;
 
         tail = maths_t::E_MixedOrNeitherTail;
 
-        TDoubleDoubleSizeTrVec pCategories;
-        pCategories.reserve(m_Categories.size());
-        double pU = 0.0;
+        const CLessLikelyCategories& lessLikelyCategories = this->lessLikelyCategories();
+        const TDoubleDoubleSizeTrVec& pCategories = lessLikelyCategories.probabilities();
+        double pU = lessLikelyCategories.pU();
+        double pl = lessLikelyCategories.pl();
         double pmin = 1.0 / m_TotalConcentration;
 
-        {
-            double r = 1.0 / static_cast<double>(m_Concentrations.size());
-            for (std::size_t i = 0u; i < m_Concentrations.size(); ++i) {
-                double p = m_Concentrations[i] / m_TotalConcentration;
-                pCategories.emplace_back(p, p, i);
-                pU += r - p;
-            }
-        }
-        std::sort(pCategories.begin(), pCategories.end());
-        LOG_TRACE(<< "p = " << core::CContainerPrinter::print(pCategories));
-
-        double pl = 0.0;
-        {
-            // Get the index of largest probability less than or equal to P(U).
-            std::size_t l = pCategories.size();
-            if (pU > 0.0) {
-                l = std::lower_bound(pCategories.begin(), pCategories.end(),
-                                     TDoubleDoubleSizeTr(pU, pU, 0)) -
-                    pCategories.begin();
-            }
-
-            // Compute probabilities of less likely categories.
-            double pCumulative = 0.0;
-            for (std::size_t i = 0u, j = 0u; i < pCategories.size(); /**/) {
-                // Find the probability equal range [i, j).
-                double p = pCategories[i].get<1>();
-                pCumulative += p;
-                while (++j < pCategories.size() && pCategories[j].get<1>() == p) {
-                    pCumulative += p;
-                }
-
-                // Update the equal range probabilities [i, j).
-                for (/**/; i < j; ++i) {
-                    pCategories[i].get<1>() = pCumulative;
-                }
-            }
-
-            if (l < pCategories.size()) {
-                pl = pCategories[l].get<1>();
-            }
-        }
+        // The probabilities of less likely categories averaged over the
+        // marginal prior for the sample categories keyed by position in
+        // pCategories. These override the values in pCategories.
+        TSizeDoublePrVec pAveraged;
+        auto probability = [&pCategories, &pAveraged](std::size_t position) {
+            auto i = std::lower_bound(pAveraged.begin(), pAveraged.end(),
+                                      position, COrderings::SFirstLess());
+            return i != pAveraged.end() && i->first == position
+                       ? i->second
+                       : pCategories[position].get<1>();
+        };
 
         std::size_t nSamples = detail::numberPriorSamples(m_TotalConcentration);
         LOG_TRACE(<< "n = " << nSamples);
         if (nSamples > 1) {
-            // Extract the indices of the categories we want.
-            TSizeVec categoryIndices;
-            categoryIndices.reserve(samples.size());
+            // Extract the positions of the categories we want.
+            TSizeVec positions;
+            positions.reserve(samples.size());
             for (std::size_t i = 0u; i < samples.size(); ++i) {
                 std::size_t index = std::lower_bound(m_Categories.begin(),
                                                      m_Categories.end(), samples[i]) -
                                     m_Categories.begin();
                 if (index < m_Categories.size() && m_Categories[index] == samples[i]) {
-                    categoryIndices.push_back(index);
+                    positions.push_back(lessLikelyCategories.position(index));
                 }
             }
-            std::sort(categoryIndices.begin(), categoryIndices.end());
+            std::sort(positions.begin(), positions.end());
+            positions.erase(std::unique(positions.begin(), positions.end()),
+                            positions.end());
+            pAveraged.reserve(positions.size());
 
-            for (std::size_t i = 0u; i < pCategories.size(); ++i) {
+            for (auto i : positions) {
                 // For all categories that we actually want compute the
                 // average probability over a set of independent samples
                 // from the marginal prior for this category, which by the
                 // law of large numbers converges to E[ P(p) ] w.r.t. to
                 // marginal for p. The constants a and b are a(i) and
-                // Sum_j( a(j) ) - a(i), respectively.
+                // Sum_j( a(j) ) - a(i), respectively. Note that we visit
+                // categories in order of increasing probability and the
+                // interpolation uses any averages we've already computed.
 
                 std::size_t j = pCategories[i].get<2>();
-                if (std::binary_search(categoryIndices.begin(), categoryIndices.end(), j)) {
-                    TDouble7Vec marginalSamples;
-                    double a = m_Concentrations[j];
-                    double b = m_TotalConcentration - m_Concentrations[j];
-                    detail::generateBetaSamples(a, b, nSamples, marginalSamples);
-                    LOG_TRACE(<< "E[p] = " << pCategories[i].get<0>()
-                              << ", mean = " << CBasicStatistics::mean(marginalSamples)
-                              << ", samples = " << marginalSamples);
-
-                    TMeanAccumulator pAcc;
-                    for (std::size_t k = 0u; k < marginalSamples.size(); ++k) {
-                        TDoubleDoubleSizeTr x(1.05 * marginalSamples[k], 0.0, 0);
-                        ptrdiff_t r = std::min(
+                TDouble7Vec marginalSamples;
+                double a = m_Concentrations[j];
+                double b = m_TotalConcentration - m_Concentrations[j];
+                detail::generateBetaSamples(a, b, nSamples, marginalSamples);
+                LOG_TRACE(<< "E[p] = " << pCategories[i].get<0>()
+                          << ", mean = " << CBasicStatistics::mean(marginalSamples)
+                          << ", samples = " << marginalSamples);
+
+                TMeanAccumulator pAcc;
+                for (std::size_t k = 0u; k < marginalSamples.size(); ++k) {
+                    TDoubleDoubleSizeTr x(1.05 * marginalSamples[k], 0.0, 0);
+                    std::size_t r = std::min(
+                        static_cast<std::size_t>(
                             std::upper_bound(pCategories.begin(), pCategories.end(), x) -
-                                pCategories.begin(),
-                            static_cast<ptrdiff_t>(pCategories.size()) - 1);
-
-                        double fl = r > 0 ? pCategories[r - 1].get<0>() : 0.0;
-                        double fr = pCategories[r].get<0>();
-                        double pl_ = r > 0 ? pCategories[r - 1].get<1>() : 0.0;
-                        double pr_ = pCategories[r].get<1>();
-                        double alpha = std::min(
-                            (fr - fl == 0.0) ? 0.0 : (x.get<0>() - fl) / (fr - fl), 1.0);
-                        double px = (1.0 - alpha) * pl_ + alpha * pr_;
-                        LOG_TRACE(<< "E[p(l)] = " << fl << ", P(l) = " << pl_
-                                  << ", E[p(r)] = " << fr << ", P(r) = " << pr_
-                                  << ", alpha = " << alpha << ", p = " << px);
-
-                        pAcc.add(px);
-                    }
-                    pCategories[i].get<1>() = CBasicStatistics::mean(pAcc);
-                }
-            }
-        }
+                            pCategories.begin()),
+                        pCategories.size() - 1);
 
-        LOG_TRACE(<< "pCategories = " << core::CContainerPrinter::print(pCategories));
-        LOG_TRACE(<< "P(U) = " << pU << ", P(l) = " << pl);
+                    double fl = r > 0 ? pCategories[r - 1].get<0>() : 0.0;
+                    double fr = pCategories[r].get<0>();
+                    double pl_ = r > 0 ? probability(r - 1) : 0.0;
+                    double pr_ = probability(r);
+                    double alpha = std::min(
+                        (fr - fl == 0.0) ? 0.0 : (x.get<0>() - fl) / (fr - fl), 1.0);
+                    double px = (1.0 - alpha) * pl_ + alpha * pr_;
+                    LOG_TRACE(<< "E[p(l)] = " << fl << ", P(l) = " << pl_
+                              << ", E[p(r)] = " << fr << ", P(r) = " << pr_
+                              << ", alpha = " << alpha << ", p = " << px);
 
-        // We can use radix sort to reorder the probabilities in O(n).
-        // To understand the following loop note that on each iteration
-        // at least one extra probability is in its correct position
-        // so it will necessarily terminate in at most n iterations.
-        for (std::size_t i = 0; i < pCategories.size(); /**/) {
-            if (i == pCategories[i].get<2>()) {
-                ++i;
-            } else {
-                std::swap(pCategories[i], pCategories[pCategories[i].get<2>()]);
+                    pAcc.add(px);
+                }
+                pAveraged.emplace_back(i, CBasicStatistics::mean(pAcc));
             }
         }
 
-        LOG_TRACE(<< "pCategories = " << core::CContainerPrinter::print(pCategories));
+        LOG_TRACE(<< "pAveraged = " << core::CContainerPrinter::print(pAveraged));
+        LOG_TRACE(<< "P(U) = " << pU << ", P(l) = " << pl);
 
         if (samples.size() == 1) {
             // No special aggregation is required if there is a single sample.
@@ -1088,7 +1152,7 @@ bool CMultinomialConjugate::probabilityOfLessLikelySamples(maths_t::EProbability
                                 m_Categories.begin();
 
             if (index < m_Categories.size() && m_Categories[index] == samples[0]) {
-                double p = pCategories[index].get<1>();
+                double p = probability(lessLikelyCategories.position(index));
                 lowerBound = p + (p >= pU ? pU : 0.0);
                 upperBound = p + pU;
             } else {
@@ -1123,8 +1187,8 @@ bool CMultinomialConjugate::probabilityOfLessLikelySamples(maths_t::EProbability
                                                  m_Categories.end(), category) -
                                 m_Categories.begin();
 
-            double p = pCategories[index].get<1>();
             if (index < m_Categories.size() && m_Categories[index] == category) {
+                double p = probability(lessLikelyCategories.position(index));
                 jointLowerBound.add(p + (p >= pU ? pU : 0.0), count);
                 jointUpperBound.add(p + pU, count);
             } else {
@@ -1243,11 +1307,13 @@ void CMultinomialConjugate::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr
     mem->setName("CMultinomialConjugate");
     core::CMemoryDebug::dynamicSize("m_Categories", m_Categories, mem);
     core::CMemoryDebug::dynamicSize("m_Concentrations", m_Concentrations, mem);
+    core::CMemoryDebug::dynamicSize("m_LessLikelyCategories", m_LessLikelyCategories, mem);
 }
 
 std::size_t CMultinomialConjugate::memoryUsage() const {
     std::size_t mem = core::CMemory::dynamicSize(m_Categories);
     mem += core::CMemory::dynamicSize(m_Concentrations);
+    mem += core::CMemory::dynamicSize(m_LessLikelyCategories);
     return mem;
 }
 
@@ -1291,6 +1357,7 @@ void CMultinomialConjugate::removeCategories(TDoubleVec categoriesToRemove) {
     m_Concentrations.erase(m_Concentrations.begin() + end, m_Concentrations.end());
     m_TotalConcentration =
         std::accumulate(m_Concentrations.begin(), m_Concentrations.end(), 0.0);
+    m_LessLikelyCategories.reset();
     LOG_TRACE(<< "categories     = " << core::CContainerPrinter::print(m_Categories));
     LOG_TRACE(<< "concentrations = " << core::CContainerPrinter::print(m_Concentrations));
 
@@ -1370,54 +1437,11 @@ void CMultinomialConjugate::probabilitiesOfLessLikelyCategories(maths_t::EProbab
     } break;
 
     case maths_t::E_TwoSided: {
-        TDoubleDoubleSizeTrVec pCategories;
-        pCategories.reserve(m_Categories.size());
-        double pU = 0.0;
-
-        {
-            double r = 1.0 / static_cast<double>(m_Concentrations.size());
-            for (std::size_t i = 0u; i < m_Concentrations.size(); ++i) {
-                double p = m_Concentrations[i] / m_TotalConcentration;
-                pCategories.emplace_back(p, p, i);
-                pU += r - p;
-            }
-        }
-        std::sort(pCategories.begin(), pCategories.end());
+        const CLessLikelyCategories& lessLikelyCategories = this->lessLikelyCategories();
+        const TDoubleDoubleSizeTrVec& pCategories = lessLikelyCategories.probabilities();
+        double pU = lessLikelyCategories.pU();
         LOG_TRACE(<< "pCategories = " << core::CContainerPrinter::print(pCategories));
-
-        // Get the index of largest probability less than or equal to P(U).
-        double pl = 0.0;
-        {
-            std::size_t l = pCategories.size();
-            if (pU > 0.0) {
-                l = std::lower_bound(pCategories.begin(), pCategories.end(),
-                                     TDoubleDoubleSizeTr(pU, pU, 0)) -
-                    pCategories.begin();
-            }
-
-            // Compute probabilities of less likely categories.
-            double pCumulative = 0.0;
-            for (std::size_t i = 0u, j = 0u; i < pCategories.size(); /**/) {
-                // Find the probability equal range [i, j).
-                double p = pCategories[i].get<1>();
-                pCumulative += p;
-                while (++j < pCategories.size() && pCategories[j].get<1>() == p) {
-                    pCumulative += p;
-                }
-
-                // Update the equal range probabilities [i, j).
-                for (/**/; i < j; ++i) {
-                    pCategories[i].get<1>() = pCumulative;
-                }
-            }
-
-            if (l < pCategories.size()) {
-                pl = pCategories[l].get<1>();
-            }
-        }
-
-        LOG_TRACE(<< "pCategories = " << core::CContainerPrinter::print(pCategories));
-        LOG_TRACE(<< "P(U) = " << pU << ", P(l) = " << pl);
+        LOG_TRACE(<< "P(U) = " << pU << ", P(l) = " << lessLikelyCategories.pl());
 
         lowerBounds.resize(pCategories.size(), 0.0);
         upperBounds.resize(pCategories.size(), 0.0);
@@ -1546,6 +1570,15 @@ bool CMultinomialConjugate::equalTolerance(const CMultinomialConjugate& rhs,
            equal(m_TotalConcentration, rhs.m_TotalConcentration);
 }
 
+const CMultinomialConjugate::CLessLikelyCategories&
+CMultinomialConjugate::lessLikelyCategories() const {
+    if (m_LessLikelyCategories == nullptr) {
+        m_LessLikelyCategories = std::make_shared<const CLessLikelyCategories>(
+            m_Concentrations, m_TotalConcentration);
+    }
+    return *m_LessLikelyCategories;
+}
+
 void CMultinomialConjugate::shrink() {
     // Note that the vectors are only ever shrunk once.
 
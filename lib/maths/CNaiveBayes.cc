@@ -273,6 +273,102 @@ double CNaiveBayes::classProbability(std::size_t label, const TDouble1VecVec& x)
     return i == p.end() ? 0.0 : i->first;
 }
 
+void CNaiveBayes::classProbability(std::size_t label,
+                                   const TDoubleVecVec& x,
+                                   TDoubleVec& result) const {
+    result.clear();
+
+    std::size_t n{0};
+    for (const auto& xi : x) {
+        n = std::max(n, xi.size());
+    }
+    if (n == 0) {
+        return;
+    }
+    for (const auto& xi : x) {
+        if (xi.size() > 0 && xi.size() != n) {
+            LOG_ERROR("Inconsistent numbers of points: " << core::CContainerPrinter::print(x));
+            return;
+        }
+    }
+    auto first = m_ClassConditionalDensities.begin();
+    if (first != m_ClassConditionalDensities.end() &&
+        first->second.conditionalDensities().size() > 0 &&
+        first->second.conditionalDensities().size() != x.size()) {
+        LOG_ERROR("Unexpected feature vectors: " << core::CContainerPrinter::print(x));
+        return;
+    }
+    if (m_ClassConditionalDensities.empty()) {
+        LOG_ERROR("Trying to compute class probabilities without supplying training data");
+        return;
+    }
+
+    using TMaxAccumulator = CBasicStatistics::SMax<double>::TAccumulator;
+
+    // The arithmetic mirrors classProbabilities so the results are identical.
+
+    std::size_t m{m_ClassConditionalDensities.size()};
+    std::size_t k{m};
+    TDoubleVec logP;
+    logP.reserve(m * n);
+    for (const auto& class_ : m_ClassConditionalDensities) {
+        if (class_.first == label) {
+            k = logP.size() / n;
+        }
+        logP.resize(logP.size() + n, CTools::fastLog(class_.second.count()));
+    }
+    if (k == m) {
+        result.assign(n, 0.0);
+        return;
+    }
+
+    TDoubleVec logMaximumLikelihoods(m);
+    TDoubleVec logLikelihoods(m);
+    TDouble1Vec xij(1);
+    for (std::size_t i = 0u; i < x.size(); ++i) {
+        if (x[i].empty()) {
+            continue;
+        }
+        std::size_t c{0};
+        for (const auto& class_ : m_ClassConditionalDensities) {
+            logMaximumLikelihoods[c++] = class_.second.conditionalDensities()[i]->logMaximumValue();
+        }
+        for (std::size_t j = 0u; j < n; ++j) {
+            xij[0] = x[i][j];
+            TMaxAccumulator maxLogLikelihood;
+            c = 0;
+            for (const auto& class_ : m_ClassConditionalDensities) {
+                logLikelihoods[c] = class_.second.conditionalDensities()[i]->logValue(xij);
+                maxLogLikelihood.add(logLikelihoods[c] - logMaximumLikelihoods[c]);
+                ++c;
+            }
+            double weight{1.0};
+            if (m_MinMaxLogLikelihoodToUseFeature) {
+                weight = CTools::logisticFunction(
+                    (maxLogLikelihood[0] - *m_MinMaxLogLikelihoodToUseFeature) /
+                        std::fabs(*m_MinMaxLogLikelihoodToUseFeature),
+                    0.1);
+            }
+            for (c = 0; c < m; ++c) {
+                logP[c * n + j] += weight * logLikelihoods[c];
+            }
+        }
+    }
+
+    result.resize(n);
+    for (std::size_t j = 0u; j < n; ++j) {
+        double scale{logP[j]};
+        for (std::size_t c = 1u; c < m; ++c) {
+            scale = std::max(scale, logP[c * n + j]);
+        }
+        double Z{0.0};
+        for (std::size_t c = 0u; c < m; ++c) {
+            Z += std::exp(logP[c * n + j] - scale);
+        }
+        result[j] = std::exp(logP[k * n + j] - scale) / Z;
+    }
+}
+
 CNaiveBayes::TDoubleSizePrVec CNaiveBayes::classProbabilities(const TDouble1VecVec& x) const {
     if (!this->validate(x)) {
         return {};
@@ -282,7 +378,6 @@ CNaiveBayes::TDoubleSizePrVec CNaiveBayes::classProbabilities(const TDouble1VecV
         return {};
     }
 
-    using TDoubleVec = std::vector<double>;
     using TMaxAccumulator = CBasicStatistics::SMax<double>::TAccumulator;
 
     TDoubleSizePrVec p;
@@ -572,18 +572,17 @@ bool CNaturalBreaksClassifier::naturalBreaksImpl(const std::vector<TUPLE>& categ
 
     double pp = static_cast<double>(p);
 
-    using TDoubleVecVec = std::vector<TDoubleVec>;
-    using TSizeVecVec = std::vector<TSizeVec>;
-
     std::size_t N = categories.size();
 
-    TSizeVecVec B(N, TSizeVec(n, 0));
-    TDoubleVecVec D(N, TDoubleVec(n, 0.0));
+    // The N x n matrices are stored row major in flat vectors to
+    // avoid allocating each row separately.
+    TSizeVec B(N * n, 0);
+    TDoubleVec D(N * n, 0.0);
     {
         TTuple t;
         for (std::size_t i = 0u; i < N; ++i) {
             t += categories[i];
-            D[i][0] = CBasicStatistics::count(t) < pp ? INF : objective(target, t);
+            D[i * n] = CBasicStatistics::count(t) < pp ? INF : objective(target, t);
         }
     }
 
@@ -597,21 +596,21 @@ bool CNaturalBreaksClassifier::naturalBreaksImpl(const std::vector<TUPLE>& categ
             TTuple t;
             for (std::size_t j = i; j >= m; --j) {
                 t += categories[j];
-                double c = (D[j - 1][m - 1] == INF || CBasicStatistics::count(t) < pp)
+                double c = (D[(j - 1) * n + m - 1] == INF || CBasicStatistics::count(t) < pp)
                                ? INF
-                               : D[j - 1][m - 1] + objective(target, t);
+                               : D[(j - 1) * n + m - 1] + objective(target, t);
                 if (c <= d) {
                     b = j;
                     d = c;
                 }
             }
 
-            B[i][m] = b;
-            D[i][m] = d;
+            B[i * n + m] = b;
+            D[i * n + m] = d;
         }
     }
 
-    if (D[N - 1][n - 1] == INF) {
+    if (D[N * n - 1] == INF) {
         return false;
     }
 
@@ -626,9 +625,9 @@ bool CNaturalBreaksClassifier::naturalBreaksImpl(const std::vector<TUPLE>& categ
 
     result.resize(n, 0);
     result[n - 1] = N;
-    result[n - 2] = B[N - 1][n - 1];
+    result[n - 2] = B[N * n - 1];
     for (std::size_t i = 3u; i <= n; ++i) {
-        result[n - i] = B[result[n - i + 1] - 1][n - i + 1];
+        result[n - i] = B[(result[n - i + 1] - 1) * n + n - i + 1];
     }
 
     LOG_TRACE(<< "result = " << core::CContainerPrinter::print(result));
@@ -1341,6 +1341,72 @@ std::string CNormalMeanPrecConjugate::debug() const {
     return result.str();
 }
 
+CNormalMeanPrecConjugate::CPointLogMarginalLikelihood::CPointLogMarginalLikelihood(
+    const CNormalMeanPrecConjugate& prior)
+    : m_Integer(prior.isInteger()), m_NonInformative(prior.isNonInformative()),
+      m_Mean(prior.m_GaussianMean), m_Precision(prior.m_GaussianPrecision),
+      m_ImpliedPrecision(prior.m_GaussianPrecision + 1.0),
+      m_ImpliedShape(prior.m_GammaShape + 0.5), m_Rate(prior.m_GammaRate),
+      m_Constant(0.0), m_ErrorStatus(maths_t::E_FpNoErrors) {
+
+    if (m_NonInformative) {
+        return;
+    }
+
+    // This must match detail::CLogMarginalLikelihood for a single
+    // sample with unit weight exactly.
+
+    static const double LOG_2_PI{std::log(boost::math::double_constants::two_pi)};
+
+    double shape{prior.m_GammaShape};
+    m_Constant = 0.5 * (std::log(m_Precision) - std::log(m_ImpliedPrecision)) -
+                 0.5 * LOG_2_PI + std::lgamma(m_ImpliedShape) -
+                 std::lgamma(shape) + shape * std::log(m_Rate);
+    if (std::isnan(m_Constant)) {
+        LOG_ERROR(<< "Error calculating marginal likelihood, floating point nan");
+        m_ErrorStatus = maths_t::E_FpFailed;
+    } else if (std::isinf(m_Constant)) {
+        LOG_ERROR(<< "Error calculating marginal likelihood, floating point overflow");
+        m_ErrorStatus = maths_t::E_FpOverflowed;
+    }
+}
+
+maths_t::EFloatingPointErrorStatus
+CNormalMeanPrecConjugate::CPointLogMarginalLikelihood::operator()(double x, double& result) const {
+    result = 0.0;
+
+    if (m_NonInformative) {
+        // See jointLogMarginalLikelihood.
+        result = boost::numeric::bounds<double>::lowest();
+        return maths_t::E_FpOverflowed;
+    }
+
+    if (m_Integer) {
+        auto logMarginalLikelihood = [x, this](double offset, double& result_) {
+            return this->logMarginalLikelihood(x + offset, result_);
+        };
+        CIntegration::logGaussLegendre<CIntegration::OrderThree>(
+            logMarginalLikelihood, 0.0, 1.0, result);
+    } else {
+        this->logMarginalLikelihood(x + 0.0, result);
+    }
+
+    return static_cast<maths_t::EFloatingPointErrorStatus>(
+        m_ErrorStatus | CMathsFuncs::fpStatus(result));
+}
+
+bool CNormalMeanPrecConjugate::CPointLogMarginalLikelihood::logMarginalLikelihood(
+    double x,
+    double& result) const {
+    if (m_ErrorStatus & maths_t::E_FpFailed) {
+        return false;
+    }
+    double impliedRate = m_Rate + 0.5 * (m_Precision * (x - m_Mean) * (x - m_Mean) /
+                                         m_ImpliedPrecision);
+    result = m_Constant - m_ImpliedShape * std::log(impliedRate);
+    return true;
+}
+
 const double CNormalMeanPrecConjugate::NON_INFORMATIVE_MEAN = 0.0;
 const double CNormalMeanPrecConjugate::NON_INFORMATIVE_PRECISION = 0.0;
 const double CNormalMeanPrecConjugate::NON_INFORMATIVE_SHAPE = 1.0;
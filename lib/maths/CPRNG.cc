@@ -31,6 +31,32 @@ inline void discard(uint64_t n, PRNG& rng) {
 uint64_t rotl(const uint64_t x, int k) {
     return (x << k) | (x >> (64 - k));
 }
+
+//! Step the xoroshiro128+ generator with state (\p x0, \p x1).
+inline uint64_t xoroshiro128PlusNext(uint64_t& x0, uint64_t& x1) {
+    uint64_t result = x0 + x1;
+    x1 ^= x0;
+    x0 = rotl(x0, 55) ^ x1 ^ (x1 << 14);
+    x1 = rotl(x1, 36);
+    return result;
+}
+
+//! Jump the xoroshiro128+ generator with state (\p x0, \p x1) forward
+//! by \f$2^{64}\f$ steps.
+void xoroshiro128PlusJump(const uint64_t (&jump)[2], uint64_t& x0, uint64_t& x1) {
+    uint64_t x[2] = {0};
+    for (std::size_t i = 0; i < 2; ++i) {
+        for (unsigned int b = 0; b < 64; ++b) {
+            if (jump[i] & 1ULL << b) {
+                x[0] ^= x0;
+                x[1] ^= x1;
+            }
+            xoroshiro128PlusNext(x0, x1);
+        }
+    }
+    x0 = x[0];
+    x1 = x[1];
+}
 }
 }
 
@@ -115,13 +141,7 @@ uint64_t CPRNG::CXorOShiro128Plus::max() {
 }
 
 uint64_t CPRNG::CXorOShiro128Plus::operator()() {
-    uint64_t x0 = m_X[0];
-    uint64_t x1 = m_X[1];
-    uint64_t result = x0 + x1;
-    x1 ^= x0;
-    m_X[0] = detail::rotl(x0, 55) ^ x1 ^ (x1 << 14);
-    m_X[1] = detail::rotl(x1, 36);
-    return result;
+    return detail::xoroshiro128PlusNext(m_X[0], m_X[1]);
 }
 
 void CPRNG::CXorOShiro128Plus::discard(uint64_t n) {
@@ -129,19 +149,7 @@ void CPRNG::CXorOShiro128Plus::discard(uint64_t n) {
 }
 
 void CPRNG::CXorOShiro128Plus::jump() {
-    uint64_t x[2] = {0};
-    for (std::size_t i = 0; i < 2; ++i) {
-        for (unsigned int b = 0; b < 64; ++b) {
-            if (JUMP[i] & 1ULL << b) {
-                x[0] ^= m_X[0];
-                x[1] ^= m_X[1];
-            }
-            this->operator()();
-        }
-    }
-
-    m_X[0] = x[0];
-    m_X[1] = x[1];
+    detail::xoroshiro128PlusJump(JUMP, m_X[0], m_X[1]);
 }
 
 std::string CPRNG::CXorOShiro128Plus::toString() const {
@@ -156,6 +164,115 @@ bool CPRNG::CXorOShiro128Plus::fromString(const std::string& state) {
 
 const uint64_t CPRNG::CXorOShiro128Plus::JUMP[] = {0xbeac0467eba5facb, 0xd86b048b86aa9922};
 
+const std::size_t CPRNG::CXorOShiro128PlusX4::NUMBER_STREAMS;
+
+CPRNG::CXorOShiro128PlusX4::CXorOShiro128PlusX4() {
+    this->seed();
+}
+
+CPRNG::CXorOShiro128PlusX4::CXorOShiro128PlusX4(uint64_t seed) {
+    this->seed(seed);
+}
+
+bool CPRNG::CXorOShiro128PlusX4::operator==(const CXorOShiro128PlusX4& other) const {
+    return m_Next == other.m_Next &&
+           std::equal(&m_X0[0], &m_X0[NUMBER_STREAMS], &other.m_X0[0]) &&
+           std::equal(&m_X1[0], &m_X1[NUMBER_STREAMS], &other.m_X1[0]) &&
+           std::equal(&m_Buffer[m_Next], &m_Buffer[NUMBER_STREAMS],
+                      &other.m_Buffer[m_Next]);
+}
+
+void CPRNG::CXorOShiro128PlusX4::seed() {
+    this->seed(0);
+}
+
+void CPRNG::CXorOShiro128PlusX4::seed(uint64_t seed) {
+    uint64_t x[2];
+    CSplitMix64 seeds(seed);
+    seeds.generate(&x[0], &x[2]);
+    for (std::size_t i = 0; i < NUMBER_STREAMS; ++i) {
+        m_X0[i] = x[0];
+        m_X1[i] = x[1];
+        detail::xoroshiro128PlusJump(CXorOShiro128Plus::JUMP, x[0], x[1]);
+    }
+    std::fill_n(m_Buffer, NUMBER_STREAMS, 0);
+    m_Next = NUMBER_STREAMS;
+}
+
+uint64_t CPRNG::CXorOShiro128PlusX4::min() {
+    return 0;
+}
+
+uint64_t CPRNG::CXorOShiro128PlusX4::max() {
+    return boost::numeric::bounds<uint64_t>::highest();
+}
+
+uint64_t CPRNG::CXorOShiro128PlusX4::operator()() {
+    if (m_Next == NUMBER_STREAMS) {
+        this->step(m_Buffer);
+        m_Next = 0;
+    }
+    return m_Buffer[m_Next++];
+}
+
+void CPRNG::CXorOShiro128PlusX4::generate(uint64_t* begin, uint64_t* end) {
+    // Use up any buffered values first so the sequence is the same
+    // however it's generated.
+    for (/**/; begin != end && m_Next < NUMBER_STREAMS; ++begin) {
+        *begin = m_Buffer[m_Next++];
+    }
+    for (/**/; end - begin >= static_cast<std::ptrdiff_t>(NUMBER_STREAMS);
+         begin += NUMBER_STREAMS) {
+        this->step(begin);
+    }
+    for (/**/; begin != end; ++begin) {
+        *begin = this->operator()();
+    }
+}
+
+void CPRNG::CXorOShiro128PlusX4::discard(uint64_t n) {
+    for (/**/; n > 0 && m_Next < NUMBER_STREAMS; --n) {
+        ++m_Next;
+    }
+    uint64_t ignore[NUMBER_STREAMS];
+    for (/**/; n >= NUMBER_STREAMS; n -= NUMBER_STREAMS) {
+        this->step(ignore);
+    }
+    detail::discard(n, *this);
+}
+
+std::string CPRNG::CXorOShiro128PlusX4::toString() const {
+    uint64_t state[3 * NUMBER_STREAMS + 1];
+    std::copy_n(m_X0, NUMBER_STREAMS, &state[0]);
+    std::copy_n(m_X1, NUMBER_STREAMS, &state[NUMBER_STREAMS]);
+    std::copy_n(m_Buffer, NUMBER_STREAMS, &state[2 * NUMBER_STREAMS]);
+    state[3 * NUMBER_STREAMS] = m_Next;
+    const uint64_t* begin = &state[0];
+    const uint64_t* end = &state[3 * NUMBER_STREAMS + 1];
+    return core::CPersistUtils::toString(begin, end);
+}
+
+bool CPRNG::CXorOShiro128PlusX4::fromString(const std::string& state) {
+    uint64_t state_[3 * NUMBER_STREAMS + 1];
+    if (!core::CPersistUtils::fromString(state, &state_[0],
+                                         &state_[3 * NUMBER_STREAMS + 1]) ||
+        state_[3 * NUMBER_STREAMS] > NUMBER_STREAMS) {
+        return false;
+    }
+    std::copy_n(&state_[0], NUMBER_STREAMS, m_X0);
+    std::copy_n(&state_[NUMBER_STREAMS], NUMBER_STREAMS, m_X1);
+    std::copy_n(&state_[2 * NUMBER_STREAMS], NUMBER_STREAMS, m_Buffer);
+    m_Next = state_[3 * NUMBER_STREAMS];
+    return true;
+}
+
+void CPRNG::CXorOShiro128PlusX4::step(uint64_t* result) {
+    // The lanes are independent so the compiler can vectorise this.
+    for (std::size_t i = 0; i < NUMBER_STREAMS; ++i) {
+        result[i] = detail::xoroshiro128PlusNext(m_X0[i], m_X1[i]);
+    }
+}
+
 CPRNG::CXorShift1024Mult::CXorShift1024Mult() : m_P(0) {
     this->seed();
 }
@@ -16,6 +16,7 @@
 
 #include <maths/CBasicStatistics.h>
 #include <maths/CBasicStatisticsPersist.h>
+#include <maths/CChecksum.h>
 #include <maths/CRegression.h>
 #include <maths/CRegressionDetail.h>
 #include <maths/CSeasonalTime.h>
@@ -605,6 +606,14 @@ core_t::TTime CPeriodicityHypothesisTestsConfig::startOfWeek() const {
     return m_StartOfWeek;
 }
 
+uint64_t CPeriodicityHypothesisTestsConfig::checksum(uint64_t seed) const {
+    seed = CChecksum::calculate(seed, m_TestForDiurnal);
+    seed = CChecksum::calculate(seed, m_HasDaily);
+    seed = CChecksum::calculate(seed, m_HasWeekend);
+    seed = CChecksum::calculate(seed, m_HasWeekly);
+    return CChecksum::calculate(seed, m_StartOfWeek);
+}
+
 CPeriodicityHypothesisTests::CPeriodicityHypothesisTests()
     : m_BucketLength(0), m_WindowLength(0), m_Period(0) {
 }
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <numeric>
 #include <set>
 #include <sstream>
@@ -95,6 +96,7 @@ void doNormalSample(RNG& rng, double mean, double variance, std::size_t n, TDoub
         return;
     } else if (variance == 0.0) {
         result.resize(n, mean);
+        return;
     }
 
     result.reserve(n);
@@ -104,6 +106,122 @@ void doNormalSample(RNG& rng, double mean, double variance, std::size_t n, TDoub
     }
 }
 
+//! Convert the 52 most significant bits of \p x to a double in [0, 1).
+inline double toUnitInterval(uint64_t x) {
+    // This sets the mantissa of a double in [1, 2) and is cheaper than
+    // converting an integer to floating point.
+    x = (x >> 12) | 0x3FF0000000000000ULL;
+    double result;
+    std::memcpy(&result, &x, sizeof(result));
+    return result - 1.0;
+}
+
+//! \brief Reads random bits from a generator in blocks.
+//!
+//! \note Any values left in the last block are discarded when this
+//! is destroyed.
+class CBlockRandomBits {
+public:
+    static const std::size_t BLOCK_SIZE = 256;
+
+public:
+    explicit CBlockRandomBits(CPRNG::CXorOShiro128PlusX4& rng)
+        : m_Rng{rng}, m_Next{BLOCK_SIZE} {}
+
+    uint64_t operator()() {
+        if (m_Next == BLOCK_SIZE) {
+            m_Rng.generate(&m_Block[0], &m_Block[BLOCK_SIZE]);
+            m_Next = 0;
+        }
+        return m_Block[m_Next++];
+    }
+
+private:
+    CPRNG::CXorOShiro128PlusX4& m_Rng;
+    uint64_t m_Block[BLOCK_SIZE];
+    std::size_t m_Next;
+};
+
+//! \brief A 128 layer ziggurat for sampling the standard normal.
+//!
+//! DESCRIPTION:\n
+//! See Marsaglia and Tsang, The Ziggurat Method for Generating Random
+//! Variables, Journal of Statistical Software, 2000, with the changes
+//! suggested by Doornik, An Improved Ziggurat Method to Generate Normal
+//! Random Samples, 2005: the layer is chosen with bits which are not
+//! used for the uniform sample and the tables are doubles.
+class CZigguratNormal {
+public:
+    static const CZigguratNormal& instance() {
+        static const CZigguratNormal ziggurat;
+        return ziggurat;
+    }
+
+    double operator()(CBlockRandomBits& bits) const {
+        for (;;) {
+            uint64_t r{bits()};
+            double u{2.0 * toUnitInterval(r) - 1.0};
+            std::size_t i{(r >> 4) & 0x7F};
+            if (std::fabs(u) < m_Ratio[i]) {
+                return u * m_X[i];
+            }
+            if (i == 0) {
+                return this->tail(bits, u < 0.0);
+            }
+            double x{u * m_X[i]};
+            double f0{std::exp(-0.5 * (m_X[i] * m_X[i] - x * x))};
+            double f1{std::exp(-0.5 * (m_X[i + 1] * m_X[i + 1] - x * x))};
+            if (f1 + toUnitInterval(bits()) * (f0 - f1) < 1.0) {
+                return x;
+            }
+        }
+    }
+
+private:
+    static const std::size_t N = 128;
+    //! The start of the tail.
+    static constexpr double R = 3.442619855899;
+    //! The area of each layer.
+    static constexpr double V = 9.91256303526217e-3;
+
+private:
+    CZigguratNormal() {
+        double f{std::exp(-0.5 * R * R)};
+        m_X[0] = V / f;
+        m_X[1] = R;
+        m_X[N] = 0.0;
+        for (std::size_t i = 2; i < N; ++i) {
+            m_X[i] = std::sqrt(-2.0 * std::log(V / m_X[i - 1] + f));
+            f = std::exp(-0.5 * m_X[i] * m_X[i]);
+        }
+        for (std::size_t i = 0; i < N; ++i) {
+            m_Ratio[i] = m_X[i + 1] / m_X[i];
+        }
+    }
+
+    //! Sample from the tail beyond R using Marsaglia's method.
+    double tail(CBlockRandomBits& bits, bool negative) const {
+        double x;
+        double y;
+        do {
+            x = std::log(1.0 - toUnitInterval(bits())) / R;
+            y = std::log(1.0 - toUnitInterval(bits()));
+        } while (-2.0 * y < x * x);
+        return negative ? x - R : R - x;
+    }
+
+private:
+    //! The layers' right hand edges.
+    double m_X[N + 1];
+    //! The ratios of adjacent layers' widths.
+    double m_Ratio[N];
+};
+
+const std::size_t CBlockRandomBits::BLOCK_SIZE;
+const std::size_t CZigguratNormal::N;
+constexpr double CZigguratNormal::R;
+constexpr double CZigguratNormal::V;
+
 //! Implementation of chi^2 sampling.
 template<typename RNG>
 void doChiSquaredSample(RNG& rng, double f, std::size_t n, TDoubleVec& result) {
@@ -463,6 +581,23 @@ UNIFORM_SAMPLE(std::ptrdiff_t)
 UNIFORM_SAMPLE(double)
 #undef UNIFORM_SAMPLE
 
+void CSampling::uniformSample(CPRNG::CXorOShiro128PlusX4& rng,
+                              double a,
+                              double b,
+                              std::size_t n,
+                              TDoubleVec& result) {
+    result.resize(n);
+    uint64_t block[CBlockRandomBits::BLOCK_SIZE];
+    for (std::size_t i = 0; i < n; i += CBlockRandomBits::BLOCK_SIZE) {
+        std::size_t m{std::min(n - i, CBlockRandomBits::BLOCK_SIZE)};
+        rng.generate(&block[0], &block[m]);
+        for (std::size_t j = 0; j < m; ++j) {
+            double x{a + (b - a) * toUnitInterval(block[j])};
+            result[i + j] = x < b ? x : a;
+        }
+    }
+}
+
 double CSampling::normalSample(double mean, double variance) {
     core::CScopedFastLock scopedLock(ms_Lock);
     return doNormalSample(ms_Rng, mean, variance);
@@ -497,6 +632,29 @@ void CSampling::normalSample(CPRNG::CXorShift1024Mult& rng,
     doNormalSample(rng, mean, variance, n, result);
 }
 
+void CSampling::normalSample(CPRNG::CXorOShiro128PlusX4& rng,
+                             double mean,
+                             double variance,
+                             std::size_t n,
+                             TDoubleVec& result) {
+    result.clear();
+    if (variance < 0.0) {
+        LOG_ERROR(<< "Invalid variance " << variance);
+        return;
+    } else if (variance == 0.0) {
+        result.resize(n, mean);
+        return;
+    }
+
+    result.resize(n);
+    double sd{std::sqrt(variance)};
+    CBlockRandomBits bits{rng};
+    const CZigguratNormal& normal{CZigguratNormal::instance()};
+    for (auto& sample : result) {
+        sample = mean + sd * normal(bits);
+    }
+}
+
 void CSampling::chiSquaredSample(double f, std::size_t n, TDoubleVec& result) {
     core::CScopedFastLock scopedLock(ms_Lock);
     doChiSquaredSample(ms_Rng, f, n, result);
@@ -90,8 +90,8 @@ CUnivariateTimeSeriesChangeDetector::CUnivariateTimeSeriesChangeDetector(
     core_t::TTime maximumTimeToDetect,
     double minimumDeltaBicToDetect)
     : m_MinimumTimeToDetect{minimumTimeToDetect}, m_MaximumTimeToDetect{maximumTimeToDetect},
-      m_MinimumDeltaBicToDetect{minimumDeltaBicToDetect}, m_SampleCount{0}, m_DecisionFunction{0.0},
-      m_ChangeModels{
+      m_MinimumDeltaBicToDetect{minimumDeltaBicToDetect}, m_SampleCount{0},
+      m_DecisionFunction{0.0}, m_TrendModel{trendModel}, m_ChangeModels{
           std::make_shared<CUnivariateNoChangeModel>(trendModel, residualModel),
           std::make_shared<CUnivariateLevelShiftModel>(trendModel, residualModel),
           std::make_shared<CUnivariateTimeShiftModel>(trendModel, residualModel, -core::constants::HOUR),
@@ -236,17 +236,31 @@ void CUnivariateTimeSeriesChangeDetector::addSamples(const TTimeDoublePr1Vec& sa
 
     ++m_SampleCount;
 
+    SBaseline baseline;
+    baseline.s_Predictions.reserve(samples.size());
+    baseline.s_Residuals.reserve(samples.size());
+    for (const auto& sample : samples) {
+        core_t::TTime time{sample.first};
+        double value{sample.second};
+        baseline.s_Predictions.push_back(
+            CBasicStatistics::mean(m_TrendModel->value(time, 0.0)));
+        baseline.s_Residuals.push_back(m_TrendModel->detrend(time, value, 0.0));
+    }
+
     for (auto& model : m_ChangeModels) {
-        model->addSamples(m_SampleCount, samples, weights);
+        model->addSamples(m_SampleCount, samples, baseline, weights);
     }
 }
 
 void CUnivariateTimeSeriesChangeDetector::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    // See CUnivariateChangeModel::debugMemoryUsage for the trend model.
+    core::CMemoryDebug::dynamicSize("m_TrendModel", m_TrendModel, mem);
     core::CMemoryDebug::dynamicSize("m_ChangeModels", m_ChangeModels, mem);
 }
 
 std::size_t CUnivariateTimeSeriesChangeDetector::memoryUsage() const {
-    return core::CMemory::dynamicSize(m_ChangeModels);
+    return core::CMemory::dynamicSize(m_TrendModel) +
+           core::CMemory::dynamicSize(m_ChangeModels);
 }
 
 uint64_t CUnivariateTimeSeriesChangeDetector::checksum(uint64_t seed) const {
@@ -385,24 +399,17 @@ TOptionalChangeDescription CUnivariateNoChangeModel::change() const {
 }
 
 void CUnivariateNoChangeModel::addSamples(const std::size_t count,
-                                          const TTimeDoublePr1Vec& samples_,
+                                          const TTimeDoublePr1Vec& /*samples*/,
+                                          const SBaseline& baseline,
                                           TDoubleWeightsAry1Vec weights) {
     // See, for example, CUnivariateLevelShiftModel::addSamples
     // for an explanation of the delay updating the log-likelihood.
 
     if (count >= COUNT_TO_INITIALIZE) {
-        TDouble1Vec samples;
-        samples.reserve(samples_.size());
-        for (std::size_t i = 0u; i < samples_.size(); ++i) {
-            core_t::TTime time{samples_[i].first};
-            double value{samples_[i].second};
-            double sample{this->trendModel().detrend(time, value, 0.0)};
-            samples.push_back(sample);
-        }
         for (auto& weight : weights) {
             maths_t::setWinsorisationWeight(1.0, weight);
         }
-        this->updateLogLikelihood(samples, weights);
+        this->updateLogLikelihood(baseline.s_Residuals, weights);
     }
 }
 
@@ -460,9 +467,8 @@ TOptionalChangeDescription CUnivariateLevelShiftModel::change() const {
 
 void CUnivariateLevelShiftModel::addSamples(const std::size_t count,
                                             const TTimeDoublePr1Vec& samples_,
+                                            const SBaseline& baseline,
                                             TDoubleWeightsAry1Vec weights) {
-    const CTimeSeriesDecompositionInterface& trendModel{this->trendModel()};
-
     // We delay updating the log-likelihood because early on the
     // level can change giving us a better apparent fit to the
     // data than a fixed step. Five updates was found to be the
@@ -476,10 +482,8 @@ void CUnivariateLevelShiftModel::addSamples(const std::size_t count,
         samples.reserve(samples_.size());
         double shift{CBasicStatistics::mean(m_Shift)};
         for (std::size_t i = 0u; i < samples_.size(); ++i) {
-            core_t::TTime time{samples_[i].first};
-            double value{samples_[i].second};
             double seasonalScale{maths_t::seasonalVarianceScale(weights[i])};
-            double sample{trendModel.detrend(time, value, 0.0) - shift};
+            double sample{baseline.s_Residuals[i] - shift};
             double weight{winsorisation::tailWeight(
                 residualModel, WINSORISATION_DERATE, seasonalScale, sample)};
             samples.push_back(sample);
@@ -498,10 +502,7 @@ void CUnivariateLevelShiftModel::addSamples(const std::size_t count,
     }
 
     for (std::size_t i = 0u; i < samples_.size(); ++i) {
-        core_t::TTime time{samples_[i].first};
-        double value{samples_[i].second};
-        double shift{trendModel.detrend(time, value, 0.0) - m_ResidualModelMode};
-        m_Shift.add(shift);
+        m_Shift.add(baseline.s_Residuals[i] - m_ResidualModelMode);
     }
 }
 
@@ -562,9 +563,8 @@ CUnivariateLinearScaleModel::change() const {
 
 void CUnivariateLinearScaleModel::addSamples(const std::size_t count,
                                              const TTimeDoublePr1Vec& samples_,
+                                             const SBaseline& baseline,
                                              TDoubleWeightsAry1Vec weights) {
-    const CTimeSeriesDecompositionInterface& trendModel{this->trendModel()};
-
     // We delay updating the log-likelihood because early on the
     // scale can change giving us a better apparent fit to the
     // data than a fixed scale. Five updates was found to be the
@@ -572,9 +572,8 @@ void CUnivariateLinearScaleModel::addSamples(const std::size_t count,
     // there is no change in the data.
 
     for (std::size_t i = 0u; i < samples_.size(); ++i) {
-        core_t::TTime time{samples_[i].first};
         double value{samples_[i].second - m_ResidualModelMode};
-        double prediction{CBasicStatistics::mean(trendModel.value(time, 0.0))};
+        double prediction{baseline.s_Predictions[i]};
         double scale{std::fabs(value) / std::fabs(prediction)};
         m_Scale.add(value * prediction < 0.0
                         ? MINIMUM_SCALE
@@ -589,11 +588,9 @@ void CUnivariateLinearScaleModel::addSamples(const std::size_t count,
         samples.reserve(samples_.size());
         double scale{CBasicStatistics::mean(m_Scale)};
         for (std::size_t i = 0u; i < samples_.size(); ++i) {
-            core_t::TTime time{samples_[i].first};
             double value{samples_[i].second};
             double seasonalScale{maths_t::seasonalVarianceScale(weights[i])};
-            double prediction{CBasicStatistics::mean(trendModel.value(time, 0.0))};
-            double sample{value - scale * prediction};
+            double sample{value - scale * baseline.s_Predictions[i]};
             double weight{winsorisation::tailWeight(
                 residualModel, WINSORISATION_DERATE, seasonalScale, sample)};
             samples.push_back(sample);
@@ -663,9 +660,13 @@ TOptionalChangeDescription CUnivariateTimeShiftModel::change() const {
 
 void CUnivariateTimeShiftModel::addSamples(const std::size_t count,
                                            const TTimeDoublePr1Vec& samples_,
+                                           const SBaseline& /*baseline*/,
                                            TDoubleWeightsAry1Vec weights) {
     // See, for example, CUnivariateLevelShiftModel::addSamples
     // for an explanation of the delay updating the log-likelihood.
+    //
+    // This is the only model which can't use the baseline because it
+    // needs the trend model's predictions at the shifted times.
 
     if (count >= COUNT_TO_INITIALIZE) {
         CPrior& residualModel{this->residualModel()};
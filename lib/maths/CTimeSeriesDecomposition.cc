@@ -10,6 +10,7 @@
 #include <core/CLogger.h>
 #include <core/CStatePersistInserter.h>
 #include <core/CStateRestoreTraverser.h>
+#include <core/CStatistics.h>
 #include <core/Constants.h>
 #include <core/RestoreMacros.h>
 
@@ -27,6 +28,7 @@
 
 #include <boost/bind.hpp>
 #include <boost/container/flat_map.hpp>
+#include <boost/make_unique.hpp>
 #include <boost/math/distributions/normal.hpp>
 #include <boost/numeric/conversion/bounds.hpp>
 #include <boost/random/normal_distribution.hpp>
@@ -94,7 +96,7 @@ CTimeSeriesDecomposition::CTimeSeriesDecomposition(double decayRate,
                                                    std::size_t seasonalComponentSize)
     : m_TimeShift{0}, m_LastValueTime{0}, m_LastPropagationTime{0},
       m_PeriodicityTest{decayRate, bucketLength}, m_CalendarCyclicTest{decayRate, bucketLength},
-      m_Components{decayRate, bucketLength, seasonalComponentSize} {
+      m_Components{decayRate, bucketLength, seasonalComponentSize}, m_UpdatingComponents{false} {
     this->initializeMediator();
 }
 
@@ -103,7 +105,8 @@ CTimeSeriesDecomposition::CTimeSeriesDecomposition(const STimeSeriesDecompositio
     : m_TimeShift{0}, m_LastValueTime{0}, m_LastPropagationTime{0},
       m_PeriodicityTest{params.s_DecayRate, params.s_MinimumBucketLength},
       m_CalendarCyclicTest{params.s_DecayRate, params.s_MinimumBucketLength},
-      m_Components{params.s_DecayRate, params.s_MinimumBucketLength, params.s_ComponentSize} {
+      m_Components{params.s_DecayRate, params.s_MinimumBucketLength, params.s_ComponentSize},
+      m_UpdatingComponents{false} {
     traverser.traverseSubLevel(
         boost::bind(&CTimeSeriesDecomposition::acceptRestoreTraverser, this,
                     boost::cref(params.s_ChangeModelParams), _1));
@@ -115,8 +118,8 @@ CTimeSeriesDecomposition::CTimeSeriesDecomposition(const CTimeSeriesDecompositio
     : m_TimeShift{other.m_TimeShift}, m_LastValueTime{other.m_LastValueTime},
       m_LastPropagationTime{other.m_LastPropagationTime},
       m_PeriodicityTest{other.m_PeriodicityTest, isForForecast},
-      m_CalendarCyclicTest{other.m_CalendarCyclicTest, isForForecast}, m_Components{
-                                                                           other.m_Components} {
+      m_CalendarCyclicTest{other.m_CalendarCyclicTest, isForForecast},
+      m_Components{other.m_Components}, m_UpdatingComponents{false} {
     this->initializeMediator();
 }
 
@@ -165,6 +168,8 @@ void CTimeSeriesDecomposition::swap(CTimeSeriesDecomposition& other) {
     m_PeriodicityTest.swap(other.m_PeriodicityTest);
     m_CalendarCyclicTest.swap(other.m_CalendarCyclicTest);
     m_Components.swap(other.m_Components);
+    this->clearPredictions();
+    other.clearPredictions();
 }
 
 CTimeSeriesDecomposition& CTimeSeriesDecomposition::
@@ -197,6 +202,7 @@ CTimeSeriesDecomposition* CTimeSeriesDecomposition::clone(bool isForForecast) co
 
 void CTimeSeriesDecomposition::dataType(maths_t::EDataType dataType) {
     m_Components.dataType(dataType);
+    this->clearPredictions();
 }
 
 void CTimeSeriesDecomposition::decayRate(double decayRate) {
@@ -237,9 +243,15 @@ bool CTimeSeriesDecomposition::addPoint(core_t::TTime time,
                       },
                       m_Components.periodicityTestConfig()};
 
+    // The predictor is used while the components are being updated
+    // so predictions must not be memoized until they are finished.
+    m_UpdatingComponents = true;
+    this->clearPredictions();
     m_Components.handle(message);
     m_PeriodicityTest.handle(message);
     m_CalendarCyclicTest.handle(message);
+    m_UpdatingComponents = false;
+    this->clearPredictions();
 
     return result.changed();
 }
@@ -267,6 +279,7 @@ bool CTimeSeriesDecomposition::applyChange(core_t::TTime time,
         m_TimeShift += static_cast<core_t::TTime>(change.s_Value[0]);
         break;
     }
+    this->clearPredictions();
 
     return result;
 }
@@ -276,6 +289,7 @@ void CTimeSeriesDecomposition::propagateForwardsTo(core_t::TTime time) {
         m_PeriodicityTest.propagateForwards(m_LastPropagationTime, time);
         m_CalendarCyclicTest.propagateForwards(m_LastPropagationTime, time);
         m_Components.propagateForwards(m_LastPropagationTime, time);
+        this->clearPredictions();
     }
     m_LastPropagationTime = std::max(m_LastPropagationTime, time);
 }
@@ -292,27 +306,30 @@ TDoubleDoublePr CTimeSeriesDecomposition::value(core_t::TTime time,
 
     time += m_TimeShift;
 
-    if (components & E_TrendForced) {
-        baseline += vector2x1(m_Components.trend().value(time, confidence));
-    } else if (components & E_Trend) {
-        if (m_Components.usingTrendForPrediction()) {
-            baseline += vector2x1(m_Components.trend().value(time, confidence));
+    // Note that the predictions may be overwritten by the smoothing
+    // so must not be used after it.
+    SPredictions& predictions{this->predictions(time, confidence)};
+
+    if ((components & E_TrendForced) ||
+        ((components & E_Trend) && m_Components.usingTrendForPrediction())) {
+        if (!predictions.s_HasTrend) {
+            predictions.s_Trend = m_Components.trend().value(time, confidence);
+            predictions.s_HasTrend = true;
         }
+        baseline += vector2x1(predictions.s_Trend);
     }
 
     if (components & E_Seasonal) {
-        for (const auto& component : m_Components.seasonal()) {
-            if (this->selected(time, components, component)) {
-                baseline += vector2x1(component.value(time, confidence));
+        for (const auto& prediction : predictions.s_Seasonal) {
+            if (this->matches(components, *prediction.first)) {
+                baseline += vector2x1(prediction.second);
             }
         }
     }
 
     if (components & E_Calendar) {
-        for (const auto& component : m_Components.calendar()) {
-            if (component.initialized() && component.feature().inWindow(time)) {
-                baseline += vector2x1(component.value(time, confidence));
-            }
+        for (const auto& prediction : predictions.s_Calendar) {
+            baseline += vector2x1(prediction);
         }
     }
 
@@ -341,6 +358,9 @@ void CTimeSeriesDecomposition::forecast(core_t::TTime startTime,
         return;
     }
 
+    // The components are interpolated as we go.
+    this->clearPredictions();
+
     auto seasonal = [this, confidence](core_t::TTime time) {
         TVector2x1 prediction(0.0);
         for (const auto& component : m_Components.seasonal()) {
@@ -380,6 +400,7 @@ void CTimeSeriesDecomposition::forecast(core_t::TTime startTime,
 
     m_Components.trend().forecast(startTime, endTime, step, confidence,
                                   forecastSeasonal, writer);
+    this->clearPredictions();
 }
 
 double CTimeSeriesDecomposition::detrend(core_t::TTime time,
@@ -468,13 +489,15 @@ void CTimeSeriesDecomposition::debugMemoryUsage(core::CMemoryUsage::TMemoryUsage
     core::CMemoryDebug::dynamicSize("m_PeriodicityTest", m_PeriodicityTest, mem);
     core::CMemoryDebug::dynamicSize("m_CalendarCyclicTest", m_CalendarCyclicTest, mem);
     core::CMemoryDebug::dynamicSize("m_Components", m_Components, mem);
+    core::CMemoryDebug::dynamicSize("m_PredictionCache", m_PredictionCache, mem);
 }
 
 std::size_t CTimeSeriesDecomposition::memoryUsage() const {
     return core::CMemory::dynamicSize(m_Mediator) +
            core::CMemory::dynamicSize(m_PeriodicityTest) +
            core::CMemory::dynamicSize(m_CalendarCyclicTest) +
-           core::CMemory::dynamicSize(m_Components);
+           core::CMemory::dynamicSize(m_Components) +
+           core::CMemory::dynamicSize(m_PredictionCache);
 }
 
 std::size_t CTimeSeriesDecomposition::staticSize() const {
@@ -496,6 +519,50 @@ void CTimeSeriesDecomposition::initializeMediator() {
     m_Mediator->registerHandler(m_Components);
 }
 
+CTimeSeriesDecomposition::SPredictions&
+CTimeSeriesDecomposition::predictions(core_t::TTime time, double confidence) const {
+    if (m_PredictionCache == nullptr) {
+        m_PredictionCache = boost::make_unique<CPredictionCache>();
+    }
+
+    if (m_UpdatingComponents) {
+        m_PredictionCache->clear();
+    } else if (SPredictions* result = m_PredictionCache->find(time, confidence)) {
+        core::CStatistics::stat(stat_t::E_NumberPredictionCacheHits).increment();
+        return *result;
+    } else {
+        core::CStatistics::stat(stat_t::E_NumberPredictionCacheMisses).increment();
+    }
+
+    // Compute every component's prediction in one pass: the callers
+    // select the subset they need.
+
+    SPredictions& result{m_PredictionCache->next()};
+    result.s_Time = time;
+    result.s_Confidence = confidence;
+    result.s_HasTrend = false;
+    result.s_Seasonal.clear();
+    for (const auto& component : m_Components.seasonal()) {
+        if (component.initialized() && component.time().inWindow(time)) {
+            result.s_Seasonal.emplace_back(&component, component.value(time, confidence));
+        }
+    }
+    result.s_Calendar.clear();
+    for (const auto& component : m_Components.calendar()) {
+        if (component.initialized() && component.feature().inWindow(time)) {
+            result.s_Calendar.push_back(component.value(time, confidence));
+        }
+    }
+
+    return result;
+}
+
+void CTimeSeriesDecomposition::clearPredictions() {
+    if (m_PredictionCache != nullptr) {
+        m_PredictionCache->clear();
+    }
+}
+
 template<typename F>
 TDoubleDoublePr
 CTimeSeriesDecomposition::smooth(const F& f, core_t::TTime time, int components) const {
@@ -537,13 +604,6 @@ CTimeSeriesDecomposition::smooth(const F& f, core_t::TTime time, int components)
     return {0.0, 0.0};
 }
 
-bool CTimeSeriesDecomposition::selected(core_t::TTime time,
-                                        int components,
-                                        const CSeasonalComponent& component) const {
-    return component.initialized() && this->matches(components, component) &&
-           component.time().inWindow(time);
-}
-
 bool CTimeSeriesDecomposition::matches(int components, const CSeasonalComponent& component) const {
     int seasonal{components & E_Seasonal};
     if (seasonal == E_Seasonal) {
@@ -559,6 +619,47 @@ core_t::TTime CTimeSeriesDecomposition::lastValueTime() const {
     return m_LastValueTime;
 }
 
+std::size_t CTimeSeriesDecomposition::SPredictions::memoryUsage() const {
+    return core::CMemory::dynamicSize(s_Seasonal) + core::CMemory::dynamicSize(s_Calendar);
+}
+
+void CTimeSeriesDecomposition::CPredictionCache::clear() {
+    for (auto& predictions : m_Predictions) {
+        predictions.s_Confidence = -1.0;
+    }
+    m_Next = 0;
+}
+
+CTimeSeriesDecomposition::SPredictions*
+CTimeSeriesDecomposition::CPredictionCache::find(core_t::TTime time, double confidence) {
+    for (auto& predictions : m_Predictions) {
+        if (predictions.s_Time == time && predictions.s_Confidence == confidence) {
+            return &predictions;
+        }
+    }
+    return nullptr;
+}
+
+CTimeSeriesDecomposition::SPredictions& CTimeSeriesDecomposition::CPredictionCache::next() {
+    SPredictions& result{m_Predictions[m_Next]};
+    m_Next = (m_Next + 1) % SIZE;
+    return result;
+}
+
+void CTimeSeriesDecomposition::CPredictionCache::debugMemoryUsage(
+    core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    mem->setName("CPredictionCache");
+    mem->addItem("m_Predictions", this->memoryUsage());
+}
+
+std::size_t CTimeSeriesDecomposition::CPredictionCache::memoryUsage() const {
+    std::size_t result{0};
+    for (const auto& predictions : m_Predictions) {
+        result += predictions.memoryUsage();
+    }
+    return result;
+}
+
 const core_t::TTime CTimeSeriesDecomposition::SMOOTHING_INTERVAL{7200};
 }
 }
@@ -12,6 +12,8 @@
 #include <core/CPersistUtils.h>
 #include <core/CStatePersistInserter.h>
 #include <core/CStateRestoreTraverser.h>
+#include <core/CStaticThreadPool.h>
+#include <core/CStatistics.h>
 #include <core/CTimezone.h>
 #include <core/Constants.h>
 #include <core/RestoreMacros.h>
@@ -45,6 +47,7 @@
 #include <boost/range.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <numeric>
 #include <string>
@@ -217,6 +220,23 @@ void stepwisePropagateForwards(core_t::TTime step,
     }
 }
 
+//! Test \p values for periodic components recording the number of tests
+//! and the time they take. This is called from the background threads.
+CPeriodicityHypothesisTestsResult
+timedTestForPeriods(const CPeriodicityHypothesisTestsConfig& config,
+                    core_t::TTime start,
+                    core_t::TTime bucketLength,
+                    const TFloatMeanAccumulatorVec& values) {
+    using TClock = std::chrono::steady_clock;
+    TClock::time_point begin{TClock::now()};
+    CPeriodicityHypothesisTestsResult result{testForPeriods(config, start, bucketLength, values)};
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(TClock::now() - begin);
+    core::CStatistics::stat(stat_t::E_NumberPeriodicityTests).increment();
+    core::CStatistics::stat(stat_t::E_PeriodicityTestTime)
+        .increment(static_cast<uint64_t>(elapsed.count()));
+    return result;
+}
+
 // Periodicity Test State Machine
 
 // States
@@ -278,8 +298,23 @@ const std::string VERSION_6_4_TAG("6.4");
 const std::string PERIODICITY_TEST_MACHINE_6_3_TAG{"a"};
 const std::string SHORT_WINDOW_6_3_TAG{"b"};
 const std::string LONG_WINDOW_6_3_TAG{"c"};
+// Version 6.4
+const std::string PENDING_TEST_6_4_TAG{"d"};
 // Old versions can't be restored.
 
+// Pending Periodicity Test Tags
+// Version 6.4
+const std::string TEST_6_4_TAG{"a"};
+const std::string TEST_FOR_DIURNAL_6_4_TAG{"b"};
+const std::string HAS_DAILY_6_4_TAG{"c"};
+const std::string HAS_WEEKEND_6_4_TAG{"d"};
+const std::string HAS_WEEKLY_6_4_TAG{"e"};
+const std::string START_OF_WEEK_6_4_TAG{"f"};
+const std::string START_6_4_TAG{"g"};
+const std::string BUCKET_LENGTH_6_4_TAG{"h"};
+const std::string VALUES_6_4_TAG{"i"};
+const std::string WINDOW_6_4_TAG{"j"};
+
 // Calendar Cyclic Test Tags
 // Version 6.3
 const std::string CALENDAR_TEST_MACHINE_6_3_TAG{"a"};
@@ -483,6 +518,9 @@ CTimeSeriesDecompositionDetail::CPeriodicityTest::CPeriodicityTest(const CPeriod
             m_Windows[i] = boost::make_unique<CExpandingWindow>(*other.m_Windows[i]);
         }
     }
+    if (!isForForecast) {
+        m_PendingTests = other.m_PendingTests;
+    }
 }
 
 bool CTimeSeriesDecompositionDetail::CPeriodicityTest::acceptRestoreTraverser(
@@ -504,6 +542,9 @@ bool CTimeSeriesDecompositionDetail::CPeriodicityTest::acceptRestoreTraverser(
                 traverser.traverseSubLevel(boost::bind(&CExpandingWindow::acceptRestoreTraverser,
                                                        m_Windows[E_Long].get(), _1)),
             /**/)
+        RESTORE(PENDING_TEST_6_4_TAG,
+                traverser.traverseSubLevel(boost::bind(
+                    &CPeriodicityTest::restorePendingTest, this, _1)))
     } while (traverser.next());
     return true;
 }
@@ -523,6 +564,11 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::acceptPersistInserter(
                              boost::bind(&CExpandingWindow::acceptPersistInserter,
                                          m_Windows[E_Long].get(), _1));
     }
+    for (const auto& test : m_PendingTests) {
+        inserter.insertLevel(PENDING_TEST_6_4_TAG,
+                             boost::bind(&CPeriodicityTest::persistPendingTest,
+                                         this, boost::cref(*test), _1));
+    }
 }
 
 void CTimeSeriesDecompositionDetail::CPeriodicityTest::swap(CPeriodicityTest& other) {
@@ -531,6 +577,7 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::swap(CPeriodicityTest& ot
     std::swap(m_BucketLength, other.m_BucketLength);
     m_Windows[E_Short].swap(other.m_Windows[E_Short]);
     m_Windows[E_Long].swap(other.m_Windows[E_Long]);
+    m_PendingTests.swap(other.m_PendingTests);
 }
 
 void CTimeSeriesDecompositionDetail::CPeriodicityTest::handle(const SAddValue& message) {
@@ -539,6 +586,7 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::handle(const SAddValue& m
     const maths_t::TDoubleWeightsAry& weights{message.s_Weights};
     double weight{maths_t::countForUpdate(weights)};
 
+    this->applyPendingTests(message);
     this->test(message);
 
     switch (m_Machine.state()) {
@@ -582,8 +630,25 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::test(const SAddValue& mes
                 TFloatMeanAccumulatorVec values(window->valuesMinusPrediction(predictor));
                 core_t::TTime start{CIntegerTools::floor(window->startTime(), m_BucketLength)};
                 core_t::TTime bucketLength{window->bucketLength()};
+
+                // If there is a background pool we test a snapshot of the
+                // window there and apply the result when the next value is
+                // added. The window carries on being updated in the meantime.
+                if (core::CStaticThreadPool::defaultRunning()) {
+                    auto test = std::make_shared<SPendingTest>();
+                    test->s_Test = i;
+                    test->s_Config = config;
+                    test->s_Start = start;
+                    test->s_BucketLength = bucketLength;
+                    test->s_Values = std::move(values);
+                    test->s_Window = std::make_shared<const CExpandingWindow>(*window);
+                    this->submit(test);
+                    m_PendingTests.push_back(std::move(test));
+                    continue;
+                }
+
                 CPeriodicityHypothesisTestsResult result{
-                    testForPeriods(config, start, bucketLength, values)};
+                    timedTestForPeriods(config, start, bucketLength, values)};
                 if (result.periodic()) {
                     this->mediator()->forward(SDetectedSeasonal{
                         time, lastTime, result, *window, predictor});
@@ -630,17 +695,23 @@ uint64_t CTimeSeriesDecompositionDetail::CPeriodicityTest::checksum(uint64_t see
     seed = CChecksum::calculate(seed, m_Machine);
     seed = CChecksum::calculate(seed, m_DecayRate);
     seed = CChecksum::calculate(seed, m_BucketLength);
-    return CChecksum::calculate(seed, m_Windows);
+    seed = CChecksum::calculate(seed, m_Windows);
+    for (const auto& test : m_PendingTests) {
+        seed = test->checksum(seed);
+    }
+    return seed;
 }
 
 void CTimeSeriesDecompositionDetail::CPeriodicityTest::debugMemoryUsage(
     core::CMemoryUsage::TMemoryUsagePtr mem) const {
     mem->setName("CPeriodicityTest");
     core::CMemoryDebug::dynamicSize("m_Windows", m_Windows, mem);
+    core::CMemoryDebug::dynamicSize("m_PendingTests", m_PendingTests, mem);
 }
 
 std::size_t CTimeSeriesDecompositionDetail::CPeriodicityTest::memoryUsage() const {
     std::size_t usage{core::CMemory::dynamicSize(m_Windows)};
+    usage += core::CMemory::dynamicSize(m_PendingTests);
     if (m_Machine.state() == PT_INITIAL) {
         usage += this->extraMemoryOnInitialization();
     }
@@ -707,6 +778,7 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::apply(std::size_t symbol,
         case PT_NOT_TESTING:
             m_Windows[0].reset();
             m_Windows[1].reset();
+            m_PendingTests.clear();
             break;
         default:
             LOG_ERROR(<< "Test in a bad state: " << state);
@@ -716,6 +788,108 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::apply(std::size_t symbol,
     }
 }
 
+void CTimeSeriesDecompositionDetail::CPeriodicityTest::applyPendingTests(const SAddValue& message) {
+    if (m_PendingTests.empty()) {
+        return;
+    }
+
+    // We always wait for and apply every test at the next value so the
+    // results don't depend on how quickly the background threads ran.
+
+    TPendingTestPtrVec tests;
+    tests.swap(m_PendingTests);
+    for (const auto& test : tests) {
+        const CPeriodicityHypothesisTestsResult& result{test->s_Result.get()};
+        if (result.periodic()) {
+            this->mediator()->forward(SDetectedSeasonal{message.s_Time, message.s_LastTime,
+                                                        result, *test->s_Window,
+                                                        message.s_Predictor});
+        }
+    }
+}
+
+void CTimeSeriesDecompositionDetail::CPeriodicityTest::submit(const TPendingTestPtr& test) const {
+    // The task only holds a weak reference because the test owns the
+    // future and so, indirectly, the task. If the test is discarded
+    // before the task runs there is nothing to do.
+    std::weak_ptr<const SPendingTest> weak{test};
+    test->s_Result = core::CStaticThreadPool::async([weak]() {
+        auto test_ = weak.lock();
+        if (test_ == nullptr) {
+            return CPeriodicityHypothesisTestsResult{};
+        }
+        return timedTestForPeriods(test_->s_Config, test_->s_Start,
+                                   test_->s_BucketLength, test_->s_Values);
+    });
+}
+
+bool CTimeSeriesDecompositionDetail::CPeriodicityTest::restorePendingTest(
+    core::CStateRestoreTraverser& traverser) {
+    auto test = std::make_shared<SPendingTest>();
+    int type{E_Short};
+    bool testForDiurnal{true};
+    bool hasDaily{false};
+    bool hasWeekend{false};
+    bool hasWeekly{false};
+    core_t::TTime startOfWeek{0};
+    TExpandingWindowPtr window;
+    do {
+        const std::string& name{traverser.name()};
+        RESTORE_BUILT_IN(TEST_6_4_TAG, type)
+        RESTORE_BUILT_IN(TEST_FOR_DIURNAL_6_4_TAG, testForDiurnal)
+        RESTORE_BUILT_IN(HAS_DAILY_6_4_TAG, hasDaily)
+        RESTORE_BUILT_IN(HAS_WEEKEND_6_4_TAG, hasWeekend)
+        RESTORE_BUILT_IN(HAS_WEEKLY_6_4_TAG, hasWeekly)
+        RESTORE_BUILT_IN(START_OF_WEEK_6_4_TAG, startOfWeek)
+        RESTORE_BUILT_IN(START_6_4_TAG, test->s_Start)
+        RESTORE_BUILT_IN(BUCKET_LENGTH_6_4_TAG, test->s_BucketLength)
+        RESTORE(VALUES_6_4_TAG,
+                core::CPersistUtils::restore(VALUES_6_4_TAG, test->s_Values, traverser))
+        RESTORE_SETUP_TEARDOWN(
+            WINDOW_6_4_TAG, window.reset(this->newWindow(static_cast<ETest>(type))),
+            window && traverser.traverseSubLevel(boost::bind(
+                          &CExpandingWindow::acceptRestoreTraverser, window.get(), _1)),
+            /**/)
+    } while (traverser.next());
+
+    if (window == nullptr) {
+        LOG_ERROR(<< "Failed to restore window for pending periodicity test");
+        return false;
+    }
+
+    test->s_Test = static_cast<ETest>(type);
+    if (!testForDiurnal) {
+        test->s_Config.disableDiurnal();
+    }
+    test->s_Config.hasDaily(hasDaily);
+    test->s_Config.hasWeekend(hasWeekend);
+    test->s_Config.hasWeekly(hasWeekly);
+    test->s_Config.startOfWeek(startOfWeek);
+    test->s_Window = std::move(window);
+
+    // The result isn't persisted so we simply run the test again.
+    this->submit(test);
+    m_PendingTests.push_back(std::move(test));
+
+    return true;
+}
+
+void CTimeSeriesDecompositionDetail::CPeriodicityTest::persistPendingTest(
+    const SPendingTest& test,
+    core::CStatePersistInserter& inserter) const {
+    inserter.insertValue(TEST_6_4_TAG, static_cast<int>(test.s_Test));
+    inserter.insertValue(TEST_FOR_DIURNAL_6_4_TAG, test.s_Config.testForDiurnal());
+    inserter.insertValue(HAS_DAILY_6_4_TAG, test.s_Config.hasDaily());
+    inserter.insertValue(HAS_WEEKEND_6_4_TAG, test.s_Config.hasWeekend());
+    inserter.insertValue(HAS_WEEKLY_6_4_TAG, test.s_Config.hasWeekly());
+    inserter.insertValue(START_OF_WEEK_6_4_TAG, test.s_Config.startOfWeek());
+    inserter.insertValue(START_6_4_TAG, test.s_Start);
+    inserter.insertValue(BUCKET_LENGTH_6_4_TAG, test.s_BucketLength);
+    core::CPersistUtils::persist(VALUES_6_4_TAG, test.s_Values, inserter);
+    inserter.insertLevel(WINDOW_6_4_TAG, boost::bind(&CExpandingWindow::acceptPersistInserter,
+                                                     test.s_Window.get(), _1));
+}
+
 bool CTimeSeriesDecompositionDetail::CPeriodicityTest::shouldTest(ETest test,
                                                                   core_t::TTime time) const {
     // We need to test more frequently than we compress because it
@@ -763,6 +937,26 @@ CTimeSeriesDecompositionDetail::CPeriodicityTest::newWindow(ETest test, bool def
     return nullptr;
 }
 
+uint64_t CTimeSeriesDecompositionDetail::CPeriodicityTest::SPendingTest::checksum(uint64_t seed) const {
+    seed = CChecksum::calculate(seed, s_Test);
+    seed = CChecksum::calculate(seed, s_Config);
+    seed = CChecksum::calculate(seed, s_Start);
+    seed = CChecksum::calculate(seed, s_BucketLength);
+    seed = CChecksum::calculate(seed, s_Values);
+    return CChecksum::calculate(seed, s_Window);
+}
+
+void CTimeSeriesDecompositionDetail::CPeriodicityTest::SPendingTest::debugMemoryUsage(
+    core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    mem->setName("SPendingTest");
+    core::CMemoryDebug::dynamicSize("s_Values", s_Values, mem);
+    core::CMemoryDebug::dynamicSize("s_Window", s_Window, mem);
+}
+
+std::size_t CTimeSeriesDecompositionDetail::CPeriodicityTest::SPendingTest::memoryUsage() const {
+    return core::CMemory::dynamicSize(s_Values) + core::CMemory::dynamicSize(s_Window);
+}
+
 const TTimeVec CTimeSeriesDecompositionDetail::CPeriodicityTest::SHORT_BUCKET_LENGTHS{
     1, 5, 10, 30, 60, 300, 600, 1800, 3600};
 const TTimeVec CTimeSeriesDecompositionDetail::CPeriodicityTest::LONG_BUCKET_LENGTHS{
@@ -634,7 +634,11 @@ CUnivariateTimeSeriesModel* CUnivariateTimeSeriesModel::clone(std::size_t id) co
 }
 
 CUnivariateTimeSeriesModel* CUnivariateTimeSeriesModel::cloneForPersistence() const {
-    return new CUnivariateTimeSeriesModel{*this, m_Id};
+    CUnivariateTimeSeriesModel* result{new CUnivariateTimeSeriesModel{*this, m_Id}};
+    // The copy is never updated so it mustn't count towards the active
+    // change detectors. The token is reacquired when the state is restored.
+    result->m_ChangeDetectorToken.reset();
+    return result;
 }
 
 CUnivariateTimeSeriesModel* CUnivariateTimeSeriesModel::cloneForForecast() const {
@@ -1004,10 +1008,12 @@ bool CUnivariateTimeSeriesModel::probability(const CModelProbabilityParams& para
             this->params().probabilityBucketEmpty(), (pl + pu) / 2.0);
 
         if (m_AnomalyModel != nullptr) {
-            TDouble2Vec residual{
-                (sample[0] - m_ResidualModel->nearestMarginalLikelihoodMean(sample[0])) /
-                std::max(std::sqrt(this->seasonalWeight(0.0, time)[0]), 1.0)};
-            m_AnomalyModel->updateAnomaly(params, time, residual, probability);
+            if (params.updateAnomalyModel()) {
+                TDouble2Vec residual{
+                    (sample[0] - m_ResidualModel->nearestMarginalLikelihoodMean(sample[0])) /
+                    std::max(std::sqrt(this->seasonalWeight(0.0, time)[0]), 1.0)};
+                m_AnomalyModel->updateAnomaly(params, time, residual, probability);
+            }
             m_AnomalyModel->probability(params, time, probability);
             m_AnomalyModel->sampleAnomaly(params, time);
         }
@@ -1035,8 +1041,8 @@ bool CUnivariateTimeSeriesModel::probability(const CModelProbabilityParams& para
         TDouble10Vec2Vec pli, pui;
         TTail10Vec ti;
         core_t::TTime mostAnomalousTime{0};
-        double mostAnomalousSample{0.0};
-        TPriorPtr mostAnomalousCorrelationModel;
+        TDouble10Vec mostAnomalousSample;
+        std::size_t mostAnomalousIndex{0};
 
         for (std::size_t i = 0u; i < variables.size(); ++i) {
             if (!value[i].empty() || (!params.mostAnomalousCorrelate() ||
@@ -1081,19 +1087,8 @@ bool CUnivariateTimeSeriesModel::probability(const CModelProbabilityParams& para
                     mostAnomalousCorrelate.assign(1, i);
                     conditional = ((pli[1][0] + pui[1][0]) < (pli[0][0] + pui[0][0]));
                     mostAnomalousTime = time_[0][variables[i][0]];
-                    mostAnomalousSample = sample[0][variables[i][0]];
-                    mostAnomalousCorrelationModel =
-                        conditional
-                            ? correlationModels[i]
-                                  .first
-                                  ->univariate({variables[i][1]}, NOTHING_TO_CONDITION)
-                                  .first
-                            : correlationModels[i]
-                                  .first
-                                  ->univariate(
-                                      NOTHING_TO_MARGINALIZE,
-                                      {{variables[i][1], sample[0][variables[i][1]]}})
-                                  .first;
+                    mostAnomalousSample = sample[0];
+                    mostAnomalousIndex = i;
                 }
             } else {
                 aggregator.add(1.0, neff);
@@ -1102,11 +1097,27 @@ bool CUnivariateTimeSeriesModel::probability(const CModelProbabilityParams& para
         aggregator.calculate(probability);
 
         if (m_AnomalyModel != nullptr) {
-            TDouble2Vec residual{
-                (mostAnomalousSample - mostAnomalousCorrelationModel->nearestMarginalLikelihoodMean(
-                                           mostAnomalousSample)) /
-                std::max(std::sqrt(this->seasonalWeight(0.0, mostAnomalousTime)[0]), 1.0)};
-            m_AnomalyModel->updateAnomaly(params, mostAnomalousTime, residual, probability);
+            // The residual needs the marginal, or conditional, distribution of
+            // the most anomalous correlate which is expensive to compute so we
+            // only do this if it will be used to update the anomaly model.
+            if (params.updateAnomalyModel() && !mostAnomalousCorrelate.empty()) {
+                const TSize2Vec& variables_ = variables[mostAnomalousIndex];
+                double x{mostAnomalousSample[variables_[0]]};
+                TPriorPtr mostAnomalousCorrelationModel{
+                    conditional
+                        ? correlationModels[mostAnomalousIndex]
+                              .first->univariate({variables_[1]}, NOTHING_TO_CONDITION)
+                              .first
+                        : correlationModels[mostAnomalousIndex]
+                              .first
+                              ->univariate(NOTHING_TO_MARGINALIZE,
+                                           {{variables_[1], mostAnomalousSample[variables_[1]]}})
+                              .first};
+                TDouble2Vec residual{
+                    (x - mostAnomalousCorrelationModel->nearestMarginalLikelihoodMean(x)) /
+                    std::max(std::sqrt(this->seasonalWeight(0.0, mostAnomalousTime)[0]), 1.0)};
+                m_AnomalyModel->updateAnomaly(params, mostAnomalousTime, residual, probability);
+            }
             m_AnomalyModel->probability(params, mostAnomalousTime, probability);
             m_AnomalyModel->sampleAnomaly(params, mostAnomalousTime);
         }
@@ -1204,7 +1215,7 @@ bool CUnivariateTimeSeriesModel::acceptRestoreTraverser(const SModelRestoreParam
                 traverser.traverseSubLevel(boost::bind(
                     &CUnivariateTimeSeriesChangeDetector::acceptRestoreTraverser,
                     m_ChangeDetector.get(), boost::cref(params), _1)),
-                /**/)
+                m_ChangeDetectorToken = this->params().changeDetectorToken(true))
             RESTORE(SLIDING_WINDOW_6_3_TAG,
                     core::CPersistUtils::restore(SLIDING_WINDOW_6_3_TAG,
                                                  m_SlidingWindow, traverser))
@@ -1332,6 +1343,8 @@ CUnivariateTimeSeriesModel::CUnivariateTimeSeriesModel(const CUnivariateTimeSeri
           !isForForecast && other.m_ChangeDetector != nullptr
               ? boost::make_unique<CUnivariateTimeSeriesChangeDetector>(*other.m_ChangeDetector)
               : nullptr),
+      m_ChangeDetectorToken(m_ChangeDetector != nullptr ? other.m_ChangeDetectorToken
+                                                        : CModelParams::TChangeDetectorTokenPtr{}),
       m_SlidingWindow(!isForForecast ? other.m_SlidingWindow : TTimeDoublePrCBuf{}),
       m_Correlations(nullptr) {
     if (!isForForecast && other.m_Controllers != nullptr) {
@@ -1354,7 +1367,10 @@ CUnivariateTimeSeriesModel::testAndApplyChange(const CModelAddSamplesParams& par
         if (minimumTimeToDetect < maximumTimeToTest &&
             winsorisation::pValueFromWeight(weight) <= CHANGE_P_VALUE) {
             m_CurrentChangeInterval += this->params().bucketLength();
-            if (this->params().testForChange(m_CurrentChangeInterval)) {
+            // If too many models are already testing for change we keep
+            // trying until one finishes.
+            if (this->params().testForChange(m_CurrentChangeInterval) &&
+                (m_ChangeDetectorToken = this->params().changeDetectorToken()) != nullptr) {
                 LOG_TRACE(<< "Starting to test for change at " << time);
                 m_ChangeDetector = boost::make_unique<CUnivariateTimeSeriesChangeDetector>(
                     m_TrendModel, m_ResidualModel, minimumTimeToDetect, maximumTimeToTest);
@@ -1370,9 +1386,11 @@ CUnivariateTimeSeriesModel::testAndApplyChange(const CModelAddSamplesParams& par
         m_ChangeDetector->addSamples({{time, values[median].second[0]}}, {weights});
         if (m_ChangeDetector->stopTesting()) {
             m_ChangeDetector.reset();
+            m_ChangeDetectorToken.reset();
         } else if (auto change = m_ChangeDetector->change()) {
             LOG_DEBUG(<< "Detected " << change->print() << " at " << time);
             m_ChangeDetector.reset();
+            m_ChangeDetectorToken.reset();
             return this->applyChange(*change);
         }
     }
@@ -1483,6 +1501,7 @@ void CUnivariateTimeSeriesModel::reinitializeStateGivenNewComponent() {
         m_AnomalyModel->reset();
     }
     m_ChangeDetector.reset();
+    m_ChangeDetectorToken.reset();
 }
 
 bool CUnivariateTimeSeriesModel::correlationModels(TSize1Vec& correlated,
@@ -1500,7 +1519,7 @@ bool CUnivariateTimeSeriesModel::correlationModels(TSize1Vec& correlated,
 CTimeSeriesCorrelations::CTimeSeriesCorrelations(double minimumSignificantCorrelation,
                                                  double decayRate)
     : m_MinimumSignificantCorrelation(minimumSignificantCorrelation),
-      m_Correlations(MAXIMUM_CORRELATIONS, decayRate) {
+      m_Correlations(MAXIMUM_CORRELATIONS, decayRate, true, true) {
 }
 
 CTimeSeriesCorrelations::CTimeSeriesCorrelations(const CTimeSeriesCorrelations& other,
@@ -2358,13 +2377,15 @@ bool CMultivariateTimeSeriesModel::probability(const CModelProbabilityParams& pa
     probability = (std::sqrt(pl[0] * pl[1]) + std::sqrt(pu[0] * pu[1])) / 2.0;
 
     if (m_AnomalyModel != nullptr) {
-        TDouble2Vec residual(dimension);
-        TDouble10Vec nearest(m_ResidualModel->nearestMarginalLikelihoodMean(sample[0]));
-        TDouble2Vec scale(this->seasonalWeight(0.0, time));
-        for (std::size_t i = 0u; i < dimension; ++i) {
-            residual[i] = (sample[0][i] - nearest[i]) / std::max(std::sqrt(scale[i]), 1.0);
+        if (params.updateAnomalyModel()) {
+            TDouble2Vec residual(dimension);
+            TDouble10Vec nearest(m_ResidualModel->nearestMarginalLikelihoodMean(sample[0]));
+            TDouble2Vec scale(this->seasonalWeight(0.0, time));
+            for (std::size_t i = 0u; i < dimension; ++i) {
+                residual[i] = (sample[0][i] - nearest[i]) / std::max(std::sqrt(scale[i]), 1.0);
+            }
+            m_AnomalyModel->updateAnomaly(params, time, residual, probability);
         }
-        m_AnomalyModel->updateAnomaly(params, time, residual, probability);
         m_AnomalyModel->probability(params, time, probability);
         m_AnomalyModel->sampleAnomaly(params, time);
     }
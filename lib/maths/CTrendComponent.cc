@@ -23,6 +23,7 @@
 #include <boost/math/distributions/normal.hpp>
 #include <boost/range.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <exception>
 #include <numeric>
@@ -590,37 +591,62 @@ CTrendComponent::CForecastLevel::forecast(core_t::TTime time, double prediction,
     TDouble3Vec result{0.0, 0.0, 0.0};
 
     if (m_Probability.initialized()) {
-        CSampling::uniformSample(0.0, 1.0, m_Levels.size(), m_Uniform01);
-        bool reorder{false};
-        for (std::size_t i = 0u; i < m_Levels.size(); ++i) {
-            double dt{static_cast<double>(time - m_TimesOfLastChange[i])};
-            double x = m_Levels[i] + prediction;
-            double p{m_Probability.classProbability(LEVEL_CHANGE_LABEL, {{dt}, {x}})};
-            m_ProbabilitiesOfChange[i] = std::max(m_ProbabilitiesOfChange[i], p);
+        std::size_t n{m_Levels.size()};
+
+        // Evaluate the probabilities of change for all roll outs at once
+        // and draw all the steps in one go.
+
+        CSampling::uniformSample(0.0, 1.0, n, m_Uniform01);
+        m_Features.resize(2);
+        m_Features[0].resize(n);
+        m_Features[1].resize(n);
+        for (std::size_t i = 0u; i < n; ++i) {
+            m_Features[0][i] = static_cast<double>(time - m_TimesOfLastChange[i]);
+            m_Features[1][i] = m_Levels[i] + prediction;
+        }
+        m_Probability.classProbability(LEVEL_CHANGE_LABEL, m_Features, m_Probabilities);
+        m_Probabilities.resize(n, 0.0);
+
+        m_Changes.clear();
+        for (std::size_t i = 0u; i < n; ++i) {
+            m_ProbabilitiesOfChange[i] =
+                std::max(m_ProbabilitiesOfChange[i], m_Probabilities[i]);
             if (m_Uniform01[i] < m_ProbabilitiesOfChange[i]) {
-                double stepMean{m_Magnitude.marginalLikelihoodMean()};
-                double stepVariance{m_Magnitude.marginalLikelihoodVariance()};
-                m_Levels[i] += CSampling::normalSample(m_Rng, stepMean, stepVariance);
+                m_Changes.push_back(i);
+            }
+        }
+        if (m_Changes.size() > 0) {
+            double stepMean{m_Magnitude.marginalLikelihoodMean()};
+            double stepVariance{m_Magnitude.marginalLikelihoodVariance()};
+            CSampling::normalSample(m_Rng, stepMean, stepVariance, m_Changes.size(), m_Steps);
+            m_Steps.resize(m_Changes.size(), stepMean);
+            for (std::size_t j = 0u; j < m_Changes.size(); ++j) {
+                std::size_t i{m_Changes[j]};
+                m_Levels[i] += m_Steps[j];
                 m_TimesOfLastChange[i] = time;
                 m_ProbabilitiesOfChange[i] = 0.0;
-                reorder = true;
             }
         }
-        if (reorder) {
-            COrderings::simultaneousSort(m_Levels, m_TimesOfLastChange, m_ProbabilitiesOfChange);
-        }
 
-        double rollouts{static_cast<double>(m_Levels.size())};
-        std::size_t lower{std::min(
-            static_cast<std::size_t>((100.0 - confidence) / 200.0 * rollouts + 0.5),
-            m_Levels.size())};
-        std::size_t upper{std::min(
-            static_cast<std::size_t>((100.0 + confidence) / 200.0 * rollouts + 0.5),
-            m_Levels.size() - 1)};
+        // We only need the order statistics for the interval end points
+        // and the median so select them rather than sorting.
 
-        result[0] = m_Levels[lower];
+        double rollouts{static_cast<double>(n)};
+        std::size_t lower{std::min(
+            static_cast<std::size_t>((100.0 - confidence) / 200.0 * rollouts + 0.5), n - 1)};
+        std::size_t upper{std::max(
+            std::min(static_cast<std::size_t>((100.0 + confidence) / 200.0 * rollouts + 0.5),
+                     n - 1),
+            lower)};
+
+        m_Quantiles.assign(m_Levels.begin(), m_Levels.end());
+        std::nth_element(m_Quantiles.begin(), m_Quantiles.begin() + lower,
+                         m_Quantiles.end());
+        result[0] = m_Quantiles[lower];
+        std::nth_element(m_Quantiles.begin() + lower,
+                         m_Quantiles.begin() + upper, m_Quantiles.end());
+        result[2] = m_Quantiles[upper];
         result[1] = CBasicStatistics::median(m_Levels);
-        result[2] = m_Levels[upper];
     }
 
     return result;
@@ -53,6 +53,7 @@ using TTupleVec = CNaturalBreaksClassifier::TTupleVec;
 namespace detail {
 
 using TMeanVarAccumulator = CBasicStatistics::SSampleMeanVar<double>::TAccumulator;
+using TPointLogMarginalLikelihood = CNormalMeanPrecConjugate::CPointLogMarginalLikelihood;
 
 //! \brief Orders two clusters by their centres.
 struct SClusterCentreLess {
@@ -73,17 +74,18 @@ double min(double x, double y, double z) {
     return std::min(std::min(x, y), z);
 }
 
-//! Get the log of the likelihood that \p point is from the \p normal.
-maths_t::EFloatingPointErrorStatus logLikelihoodFromCluster(double point,
-                                                            const CNormalMeanPrecConjugate& normal,
-                                                            double probability,
-                                                            double& result) {
+//! Get the log of the likelihood that \p point is from the normal
+//! whose log likelihood is \p logLikelihood.
+maths_t::EFloatingPointErrorStatus
+logLikelihoodFromCluster(double point,
+                         const TPointLogMarginalLikelihood& logLikelihood,
+                         double probability,
+                         double& result) {
     result = core::constants::LOG_MIN_DOUBLE - 1.0;
 
     double likelihood;
 
-    maths_t::EFloatingPointErrorStatus status = normal.jointLogMarginalLikelihood(
-        {point}, maths_t::CUnitWeights::SINGLE_UNIT, likelihood);
+    maths_t::EFloatingPointErrorStatus status = logLikelihood(point, likelihood);
     if (status & maths_t::E_FpFailed) {
         LOG_ERROR(<< "Unable to compute likelihood for: " << point);
         return status;
@@ -498,7 +500,6 @@ bool splitSearch(double minimumCount,
 
     TSizeSizePr node(0, categories.size());
     TTupleVec nodeCategories;
-    nodeCategories.reserve(categories.size());
     TSizeVec candidate;
     candidate.reserve(2);
 
@@ -514,18 +515,23 @@ bool splitSearch(double minimumCount,
         LOG_TRACE(<< "node = " << core::CContainerPrinter::print(node));
         LOG_TRACE(<< "categories = " << core::CContainerPrinter::print(categories));
 
-        nodeCategories.assign(categories.begin() + node.first,
-                              categories.begin() + node.second);
+        // We only need to copy the categories if the node isn't the root.
+        bool root{node.first == 0 && node.second == categories.size()};
+        if (!root) {
+            nodeCategories.assign(categories.begin() + node.first,
+                                  categories.begin() + node.second);
+        }
 
-        CNaturalBreaksClassifier::naturalBreaks(
-            nodeCategories, 2, 0, CNaturalBreaksClassifier::E_TargetDeviation, candidate);
+        CNaturalBreaksClassifier::naturalBreaks(root ? categories : nodeCategories, 2, 0,
+                                                CNaturalBreaksClassifier::E_TargetDeviation,
+                                                candidate);
         LOG_TRACE(<< "candidate = " << core::CContainerPrinter::print(candidate));
 
         if (candidate.size() != 2) {
             LOG_ERROR(<< "Expected 2-split: " << core::CContainerPrinter::print(candidate));
             break;
         }
-        if (candidate[0] == 0 || candidate[0] == nodeCategories.size()) {
+        if (candidate[0] == 0 || candidate[0] == node.second - node.first) {
             // This can happen if all the points are co-located,
             // in which case we can't split this node anyway.
             break;
@@ -562,8 +568,11 @@ bool splitSearch(double minimumCount,
         } else if (satisfiesDistance) {
             LOG_TRACE(<< "Checking full split");
 
-            BICGain(dataType, distributions, smallest, categories, 0,
-                    candidate[0], categories.size(), distance, nl, nr);
+            // At the root we've already computed the full split gain.
+            if (!root) {
+                BICGain(dataType, distributions, smallest, categories, 0,
+                        candidate[0], categories.size(), distance, nl, nr);
+            }
 
             LOG_TRACE(<< "max(BIC(1) - BIC(2), 0) = " << distance
                       << " (to split " << minimumDistance << ")");
@@ -874,6 +883,8 @@ void CXMeansOnline1d::add(const double& point, TSizeDoublePr2Vec& clusters, doub
 
     clusters.clear();
 
+    CSplitMergeParameters parameters{*this};
+
     auto rightCluster = std::lower_bound(m_Clusters.begin(), m_Clusters.end(),
                                          point, detail::SClusterCentreLess());
 
@@ -882,12 +893,12 @@ void CXMeansOnline1d::add(const double& point, TSizeDoublePr2Vec& clusters, doub
         LOG_TRACE(<< "Adding " << point << " to " << rightCluster->centre());
         rightCluster->add(point, count);
         clusters.emplace_back(rightCluster->index(), count);
-        if (this->maybeSplit(rightCluster)) {
+        if (this->maybeSplit(rightCluster, parameters)) {
             this->cluster(point, clusters, count);
         } else if (rightCluster != m_Clusters.begin()) {
             auto leftCluster = rightCluster;
             --leftCluster;
-            if (this->maybeMerge(leftCluster, rightCluster)) {
+            if (this->maybeMerge(leftCluster, rightCluster, parameters)) {
                 this->cluster(point, clusters, count);
             }
         }
@@ -895,12 +906,12 @@ void CXMeansOnline1d::add(const double& point, TSizeDoublePr2Vec& clusters, doub
         LOG_TRACE(<< "Adding " << point << " to " << rightCluster->centre());
         rightCluster->add(point, count);
         clusters.emplace_back(rightCluster->index(), count);
-        if (this->maybeSplit(rightCluster)) {
+        if (this->maybeSplit(rightCluster, parameters)) {
             this->cluster(point, clusters, count);
         } else {
             auto leftCluster = rightCluster;
             ++rightCluster;
-            if (this->maybeMerge(leftCluster, rightCluster)) {
+            if (this->maybeMerge(leftCluster, rightCluster, parameters)) {
                 this->cluster(point, clusters, count);
             }
         }
@@ -924,14 +935,16 @@ void CXMeansOnline1d::add(const double& point, TSizeDoublePr2Vec& clusters, doub
             LOG_TRACE(<< "Adding " << point << " to " << rightCluster->centre());
             rightCluster->add(point, count);
             clusters.emplace_back(rightCluster->index(), count);
-            if (this->maybeSplit(rightCluster) || this->maybeMerge(leftCluster, rightCluster)) {
+            if (this->maybeSplit(rightCluster, parameters) ||
+                this->maybeMerge(leftCluster, rightCluster, parameters)) {
                 this->cluster(point, clusters, count);
             }
         } else if (pRight < HARD_ASSIGNMENT_THRESHOLD * pLeft) {
             LOG_TRACE(<< "Adding " << point << " to " << leftCluster->centre());
             leftCluster->add(point, count);
             clusters.emplace_back(leftCluster->index(), count);
-            if (this->maybeSplit(leftCluster) || this->maybeMerge(leftCluster, rightCluster)) {
+            if (this->maybeSplit(leftCluster, parameters) ||
+                this->maybeMerge(leftCluster, rightCluster, parameters)) {
                 this->cluster(point, clusters, count);
             }
         } else {
@@ -946,8 +959,9 @@ void CXMeansOnline1d::add(const double& point, TSizeDoublePr2Vec& clusters, doub
             rightCluster->add(point, countRight);
             clusters.emplace_back(leftCluster->index(), countLeft);
             clusters.emplace_back(rightCluster->index(), countRight);
-            if (this->maybeSplit(leftCluster) || this->maybeSplit(rightCluster) ||
-                this->maybeMerge(leftCluster, rightCluster)) {
+            if (this->maybeSplit(leftCluster, parameters) ||
+                this->maybeSplit(rightCluster, parameters) ||
+                this->maybeMerge(leftCluster, rightCluster, parameters)) {
                 this->cluster(point, clusters, count);
             }
         }
@@ -1148,14 +1162,13 @@ double CXMeansOnline1d::minimumSplitCount() const {
     return result;
 }
 
-bool CXMeansOnline1d::maybeSplit(TClusterVecItr cluster) {
-    if (cluster == m_Clusters.end()) {
+bool CXMeansOnline1d::maybeSplit(TClusterVecItr cluster, CSplitMergeParameters& parameters) {
+    if (cluster == m_Clusters.end() || cluster->buffering()) {
         return false;
     }
-    TDoubleDoublePr interval = this->winsorisationInterval();
-    if (TOptionalClusterClusterPr split =
-            cluster->split(m_AvailableDistributions, this->minimumSplitCount(),
-                           m_Smallest[0], interval, m_ClusterIndexGenerator)) {
+    if (TOptionalClusterClusterPr split = cluster->split(
+            m_AvailableDistributions, parameters.minimumSplitCount(), m_Smallest[0],
+            parameters.winsorisationInterval(), m_ClusterIndexGenerator)) {
         LOG_TRACE(<< "Splitting cluster " << cluster->index() << " at "
                   << cluster->centre());
         std::size_t index = cluster->index();
@@ -1167,12 +1180,15 @@ bool CXMeansOnline1d::maybeSplit(TClusterVecItr cluster) {
     return false;
 }
 
-bool CXMeansOnline1d::maybeMerge(TClusterVecItr cluster1, TClusterVecItr cluster2) {
-    if (cluster1 == m_Clusters.end() || cluster2 == m_Clusters.end()) {
+bool CXMeansOnline1d::maybeMerge(TClusterVecItr cluster1,
+                                 TClusterVecItr cluster2,
+                                 CSplitMergeParameters& parameters) {
+    if (cluster1 == m_Clusters.end() || cluster2 == m_Clusters.end() ||
+        cluster1->buffering()) {
         return false;
     }
-    TDoubleDoublePr interval = this->winsorisationInterval();
-    if (cluster1->shouldMerge(*cluster2, m_AvailableDistributions, m_Smallest[0], interval)) {
+    if (cluster1->shouldMerge(*cluster2, m_AvailableDistributions, m_Smallest[0],
+                              parameters.winsorisationInterval())) {
         LOG_TRACE(<< "Merging cluster " << cluster1->index() << " at "
                   << cluster1->centre() << " and cluster " << cluster2->index()
                   << " at " << cluster2->centre());
@@ -1262,6 +1278,27 @@ TDoubleDoublePr CXMeansOnline1d::winsorisationInterval() const {
     return result;
 }
 
+//////////// CSplitMergeParameters Implementation ////////////
+
+CXMeansOnline1d::CSplitMergeParameters::CSplitMergeParameters(const CXMeansOnline1d& clusterer)
+    : m_Clusterer(&clusterer) {
+}
+
+const CXMeansOnline1d::TDoubleDoublePr&
+CXMeansOnline1d::CSplitMergeParameters::winsorisationInterval() {
+    if (!m_WinsorisationInterval) {
+        m_WinsorisationInterval.reset(m_Clusterer->winsorisationInterval());
+    }
+    return *m_WinsorisationInterval;
+}
+
+double CXMeansOnline1d::CSplitMergeParameters::minimumSplitCount() {
+    if (!m_MinimumSplitCount) {
+        m_MinimumSplitCount.reset(m_Clusterer->minimumSplitCount());
+    }
+    return *m_MinimumSplitCount;
+}
+
 //////////// CCluster Implementation ////////////
 
 CXMeansOnline1d::CCluster::CCluster(const CXMeansOnline1d& clusterer)
@@ -1287,6 +1324,7 @@ bool CXMeansOnline1d::CCluster::acceptRestoreTraverser(const SDistributionRestor
                                    &CNaturalBreaksClassifier::acceptRestoreTraverser,
                                    &m_Structure, boost::cref(params), _1)))
     } while (traverser.next());
+    m_LogLikelihood.reset();
 
     return true;
 }
@@ -1301,11 +1339,13 @@ void CXMeansOnline1d::CCluster::acceptPersistInserter(core::CStatePersistInserte
 
 void CXMeansOnline1d::CCluster::dataType(maths_t::EDataType dataType) {
     m_Prior.dataType(dataType);
+    m_LogLikelihood.reset();
 }
 
 void CXMeansOnline1d::CCluster::add(double point, double count) {
     m_Prior.addSamples({point}, {maths_t::countWeight(count)});
     m_Structure.add(point, count);
+    m_LogLikelihood.reset();
 }
 
 void CXMeansOnline1d::CCluster::decayRate(double decayRate) {
@@ -1316,6 +1356,7 @@ void CXMeansOnline1d::CCluster::decayRate(double decayRate) {
 void CXMeansOnline1d::CCluster::propagateForwardsByTime(double time) {
     m_Prior.propagateForwardsByTime(time);
     m_Structure.propagateForwardsByTime(time);
+    m_LogLikelihood.reset();
 }
 
 std::size_t CXMeansOnline1d::CCluster::index() const {
@@ -1350,14 +1391,21 @@ double CXMeansOnline1d::CCluster::weight(maths_t::EClusterWeightCalc calc) const
 
 double CXMeansOnline1d::CCluster::logLikelihoodFromCluster(maths_t::EClusterWeightCalc calc,
                                                            double point) const {
+    if (!m_LogLikelihood) {
+        m_LogLikelihood.reset(CNormalMeanPrecConjugate::CPointLogMarginalLikelihood{m_Prior});
+    }
     double result;
-    if (detail::logLikelihoodFromCluster(point, m_Prior, this->weight(calc), result) &
+    if (detail::logLikelihoodFromCluster(point, *m_LogLikelihood, this->weight(calc), result) &
         maths_t::E_FpFailed) {
         LOG_ERROR(<< "Unable to compute likelihood for: " << m_Index);
     }
     return result;
 }
 
+bool CXMeansOnline1d::CCluster::buffering() const {
+    return m_Structure.buffering();
+}
+
 void CXMeansOnline1d::CCluster::sample(std::size_t numberSamples,
                                        double smallest,
                                        double largest,
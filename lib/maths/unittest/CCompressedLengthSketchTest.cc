@@ -0,0 +1,299 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include "CCompressedLengthSketchTest.h"
+
+#include <core/CContainerPrinter.h>
+#include <core/CLogger.h>
+#include <core/CStopWatch.h>
+#include <core/CStringUtils.h>
+#include <core/CompressUtils.h>
+
+#include <maths/CBasicStatistics.h>
+#include <maths/CCompressedLengthSketch.h>
+
+#include <test/CRandomNumbers.h>
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace ml;
+
+namespace {
+using TDoubleVec = std::vector<double>;
+using TSizeVec = std::vector<std::size_t>;
+using TStrVec = std::vector<std::string>;
+using TStrSet = std::set<std::string>;
+using TMeanAccumulator = maths::CBasicStatistics::SSampleMean<double>::TAccumulator;
+
+const std::string HEX_DIGITS("0123456789abcdef");
+const TStrVec VOCABULARY{"user", "login", "service", "error", "order", "payment",
+                         "api",  "auth",  "db",      "cache", "node",  "prod",
+                         "eu",   "us",    "west",    "east"};
+const TStrVec ENVIRONMENTS{"prod", "dev", "qa"};
+
+//! Generate \p n distinct strings of type \p type.
+void generate(test::CRandomNumbers& rng, std::size_t type, std::size_t n, TStrSet& result) {
+    result.clear();
+    TSizeVec indices;
+    TStrVec words;
+    while (result.size() < n) {
+        std::string value;
+        switch (type) {
+        case 0: {
+            // Random identifiers, as seen in DNS tunnelling.
+            rng.generateUniformSamples(8, 33, 1, indices);
+            rng.generateWords(indices[0], 1, words);
+            value = words[0];
+            break;
+        }
+        case 1: {
+            // Hexadecimal ids.
+            rng.generateUniformSamples(0, HEX_DIGITS.size(), 32, indices);
+            for (auto i : indices) {
+                value += HEX_DIGITS[i];
+            }
+            break;
+        }
+        case 2: {
+            // Phrases built from a small vocabulary.
+            rng.generateUniformSamples(2, 5, 1, indices);
+            rng.generateUniformSamples(0, VOCABULARY.size(), indices[0], indices);
+            for (auto i : indices) {
+                value += (value.empty() ? "" : "-") + VOCABULARY[i];
+            }
+            break;
+        }
+        case 3: {
+            // Host names with a common structure.
+            rng.generateUniformSamples(0, 10000, 1, indices);
+            std::string id{core::CStringUtils::typeToString(indices[0])};
+            rng.generateUniformSamples(0, ENVIRONMENTS.size(), 1, indices);
+            value = "host-" + std::string(4 - std::min(id.size(), std::size_t(4)), '0') +
+                    id + "." + ENVIRONMENTS[indices[0]] + ".example.com";
+            break;
+        }
+        }
+        result.insert(value);
+    }
+}
+
+std::size_t deflateLength(core::CDeflator& compressor, const TStrSet& values) {
+    for (const auto& value : values) {
+        compressor.addString(value);
+    }
+    std::size_t length{0};
+    compressor.length(true, length);
+    return length;
+}
+}
+
+void CCompressedLengthSketchTest::testOrderInvariance() {
+    // The estimate should only depend on the set of strings added.
+
+    test::CRandomNumbers rng;
+
+    TStrVec words;
+    rng.generateWords(20, 2000, words);
+
+    TSizeVec sizes{64, 512, 4096};
+    for (auto size : sizes) {
+        maths::CCompressedLengthSketch forwards{size};
+        maths::CCompressedLengthSketch backwards{size};
+        for (std::size_t i = 0u; i < words.size(); ++i) {
+            forwards.add(words[i]);
+            backwards.add(words[words.size() - i - 1]);
+        }
+        LOG_DEBUG(<< "size = " << size << ", length = " << forwards.length());
+        CPPUNIT_ASSERT_EQUAL(forwards.length(), backwards.length());
+        CPPUNIT_ASSERT_EQUAL(forwards.checksum(), backwards.checksum());
+    }
+
+    maths::CCompressedLengthSketch empty;
+    CPPUNIT_ASSERT_EQUAL(0.0, empty.length());
+}
+
+void CCompressedLengthSketchTest::testAccuracy() {
+    // Compare with the deflate length of the sorted strings which is what
+    // the info_content functions compute.
+
+    test::CRandomNumbers rng;
+
+    std::string types[]{"identifiers", "hex", "phrases", "hosts"};
+    TSizeVec numbers{1, 2, 5, 10, 20, 50, 100, 200, 500};
+
+    core::CDeflator compressor(true);
+    TMeanAccumulator meanError;
+    TStrSet values;
+    for (std::size_t type = 0u; type < 4; ++type) {
+        TMeanAccumulator meanTypeError;
+        for (auto n : numbers) {
+            for (std::size_t trial = 0u; trial < 5; ++trial) {
+                generate(rng, type, n, values);
+
+                maths::CCompressedLengthSketch sketch;
+                for (const auto& value : values) {
+                    sketch.add(value);
+                }
+                double estimate{sketch.length()};
+                double actual{static_cast<double>(deflateLength(compressor, values))};
+                if (trial == 0) {
+                    LOG_DEBUG(<< types[type] << ": n = " << n << ", deflate = " << actual
+                              << ", sketch = " << estimate);
+                }
+
+                double error{std::fabs(std::log(estimate / actual))};
+                CPPUNIT_ASSERT(error < 0.6);
+                meanTypeError.add(error);
+                meanError.add(error);
+            }
+        }
+        LOG_DEBUG(<< types[type] << ": mean log error = "
+                  << maths::CBasicStatistics::mean(meanTypeError));
+        CPPUNIT_ASSERT(maths::CBasicStatistics::mean(meanTypeError) < 0.3);
+    }
+    LOG_DEBUG(<< "mean log error = " << maths::CBasicStatistics::mean(meanError));
+    CPPUNIT_ASSERT(maths::CBasicStatistics::mean(meanError) < 0.15);
+
+    // The estimate should increase with the information in the strings.
+
+    TDoubleVec lengths;
+    for (std::size_t type = 0u; type < 4; ++type) {
+        generate(rng, type, 100, values);
+        maths::CCompressedLengthSketch sketch;
+        for (const auto& value : values) {
+            sketch.add(value);
+        }
+        lengths.push_back(sketch.length());
+    }
+    LOG_DEBUG(<< "lengths = " << core::CContainerPrinter::print(lengths));
+    CPPUNIT_ASSERT(lengths[0] > lengths[2]);
+    CPPUNIT_ASSERT(lengths[1] > lengths[2]);
+}
+
+void CCompressedLengthSketchTest::testSaturation() {
+    // Check the estimate remains finite and increasing when many more
+    // distinct windows are added than there are bits in the sketch.
+
+    test::CRandomNumbers rng;
+
+    TStrVec words;
+    rng.generateWords(32, 5000, words);
+
+    maths::CCompressedLengthSketch sketch{256};
+    double last{0.0};
+    for (std::size_t i = 0u; i < words.size(); ++i) {
+        sketch.add(words[i]);
+        double length{sketch.length()};
+        CPPUNIT_ASSERT(std::isfinite(length));
+        CPPUNIT_ASSERT(length > last);
+        last = length;
+    }
+    LOG_DEBUG(<< "length = " << last);
+    CPPUNIT_ASSERT(last < 32.0 * 5000.0);
+}
+
+void CCompressedLengthSketchTest::testSizeFor() {
+    // Check a sketch sized for the total length of its strings is much
+    // smaller for a few short strings and gives nearly the same estimate
+    // as one with the default size.
+
+    test::CRandomNumbers rng;
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(64), maths::CCompressedLengthSketch::sizeFor(0));
+    CPPUNIT_ASSERT_EQUAL(maths::CCompressedLengthSketch::DEFAULT_SIZE,
+                         maths::CCompressedLengthSketch::sizeFor(100000));
+
+    TStrVec words;
+    for (std::size_t n : {1, 2, 5, 10, 20, 50, 100, 200}) {
+        for (std::size_t length : {5, 12, 24}) {
+            rng.generateWords(length, n, words);
+            std::size_t bytes{n * length};
+
+            maths::CCompressedLengthSketch sized{maths::CCompressedLengthSketch::sizeFor(bytes)};
+            maths::CCompressedLengthSketch full;
+            for (const auto& word : words) {
+                sized.add(word);
+                full.add(word);
+            }
+            CPPUNIT_ASSERT_EQUAL(bytes, sized.bytes());
+            CPPUNIT_ASSERT(sized.size() >= std::min(2 * bytes, full.size()));
+            CPPUNIT_ASSERT(sized.memoryUsage() <= full.memoryUsage());
+
+            double error{std::fabs(std::log(sized.length() / full.length()))};
+            if (error > 0.02) {
+                LOG_DEBUG(<< "n = " << n << ", length = " << length << ", size = "
+                          << sized.size() << ", error = " << error);
+            }
+            CPPUNIT_ASSERT(error < 0.1);
+        }
+    }
+}
+
+void CCompressedLengthSketchTest::testPerformance() {
+    // Compare the cost of maintaining the sketch for each arrival with
+    // compressing the sorted values once per bucket.
+
+    test::CRandomNumbers rng;
+
+    std::size_t buckets{200};
+    std::size_t arrivals{200};
+
+    TStrVec words;
+    rng.generateWords(24, buckets * arrivals, words);
+
+    core::CStopWatch sketchWatch;
+    core::CStopWatch deflateWatch;
+    uint64_t sketchTime{0};
+    uint64_t deflateTime{0};
+    double totalSketch{0.0};
+    double totalDeflate{0.0};
+
+    core::CDeflator compressor(true);
+    for (std::size_t bucket = 0u; bucket < buckets; ++bucket) {
+        auto begin = words.begin() + bucket * arrivals;
+        auto end = begin + arrivals;
+
+        sketchWatch.start();
+        maths::CCompressedLengthSketch sketch;
+        std::for_each(begin, end, [&sketch](const std::string& word) {
+            sketch.add(word);
+        });
+        totalSketch += sketch.length();
+        sketchTime = sketchWatch.stop();
+
+        deflateWatch.start();
+        TStrSet values(begin, end);
+        totalDeflate += static_cast<double>(deflateLength(compressor, values));
+        deflateTime = deflateWatch.stop();
+    }
+
+    LOG_DEBUG(<< "sketch = " << sketchTime << "ms, deflate = " << deflateTime << "ms");
+    LOG_DEBUG(<< "total sketch = " << totalSketch << ", total deflate = " << totalDeflate);
+}
+
+CppUnit::Test* CCompressedLengthSketchTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CCompressedLengthSketchTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CCompressedLengthSketchTest>(
+        "CCompressedLengthSketchTest::testOrderInvariance",
+        &CCompressedLengthSketchTest::testOrderInvariance));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CCompressedLengthSketchTest>(
+        "CCompressedLengthSketchTest::testAccuracy", &CCompressedLengthSketchTest::testAccuracy));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CCompressedLengthSketchTest>(
+        "CCompressedLengthSketchTest::testSaturation",
+        &CCompressedLengthSketchTest::testSaturation));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CCompressedLengthSketchTest>(
+        "CCompressedLengthSketchTest::testSizeFor", &CCompressedLengthSketchTest::testSizeFor));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CCompressedLengthSketchTest>(
+        "CCompressedLengthSketchTest::testPerformance",
+        &CCompressedLengthSketchTest::testPerformance));
+
+    return suiteOfTests;
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_CCompressedLengthSketchTest_h
+#define INCLUDED_CCompressedLengthSketchTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CCompressedLengthSketchTest : public CppUnit::TestFixture {
+public:
+    void testOrderInvariance();
+    void testAccuracy();
+    void testSaturation();
+    void testSizeFor();
+    void testPerformance();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CCompressedLengthSketchTest_h
@@ -46,8 +46,8 @@ public:
     using maths::CKMostCorrelated::mostCorrelated;
 
 public:
-    CKMostCorrelatedForTest(std::size_t size, double decayRate)
-        : maths::CKMostCorrelated(size, decayRate) {}
+    CKMostCorrelatedForTest(std::size_t size, double decayRate, bool incremental = false)
+        : maths::CKMostCorrelated(size, decayRate, true, incremental) {}
 
     void mostCorrelated(TCorrelationVec& result) const {
         this->maths::CKMostCorrelated::mostCorrelated(result);
@@ -779,7 +779,7 @@ void CKMostCorrelatedTest::testPersistence() {
     test::CRandomNumbers rng;
 
     TDoubleVec samples;
-    rng.generateUniformSamples(0.0, 10.0, 4000, samples);
+    rng.generateUniformSamples(0.0, 10.0, 4050, samples);
 
     for (std::size_t i = 0u; i < samples.size(); i += 10) {
         for (std::size_t j = 0u; j < 10; j += 2) {
@@ -788,42 +788,114 @@ void CKMostCorrelatedTest::testPersistence() {
         }
     }
 
-    maths::CKMostCorrelated origMostCorrelated(10, 0.001);
-    origMostCorrelated.addVariables(10);
+    for (auto incremental : {false, true}) {
+        LOG_DEBUG(<< "incremental = " << incremental);
 
-    for (std::size_t i = 0u; i < samples.size(); i += 10) {
-        for (std::size_t j = 0u; j < 10; ++j) {
-            origMostCorrelated.add(j, samples[i + j]);
+        // In incremental mode we persist part way through a search.
+        std::size_t n{incremental ? samples.size() : 4000};
+
+        maths::CKMostCorrelated origMostCorrelated(10, 0.001, true, incremental);
+        origMostCorrelated.addVariables(10);
+
+        for (std::size_t i = 0u; i < n; i += 10) {
+            for (std::size_t j = 0u; j < 10; ++j) {
+                origMostCorrelated.add(j, samples[i + j]);
+            }
+            origMostCorrelated.capture();
         }
-        origMostCorrelated.capture();
-    }
 
-    std::string origXml;
-    {
+        std::string origXml;
+        {
+            core::CRapidXmlStatePersistInserter inserter("root");
+            origMostCorrelated.acceptPersistInserter(inserter);
+            inserter.toXml(origXml);
+        }
+        LOG_DEBUG(<< "original k-most correlated XML = " << origXml);
+
+        // Restore the XML into a new sketch.
+        core::CRapidXmlParser parser;
+        CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(origXml));
+        core::CRapidXmlStateRestoreTraverser traverser(parser);
+        maths::CKMostCorrelated restoredMostCorrelated(10, 0.001, true, incremental);
+        CPPUNIT_ASSERT(traverser.traverseSubLevel(boost::bind(
+            &maths::CKMostCorrelated::acceptRestoreTraverser, &restoredMostCorrelated, _1)));
+
+        LOG_DEBUG(<< "orig checksum = " << origMostCorrelated.checksum()
+                  << ", new checksum = " << restoredMostCorrelated.checksum());
+        CPPUNIT_ASSERT_EQUAL(origMostCorrelated.checksum(),
+                             restoredMostCorrelated.checksum());
+
+        std::string newXml;
         core::CRapidXmlStatePersistInserter inserter("root");
-        origMostCorrelated.acceptPersistInserter(inserter);
-        inserter.toXml(origXml);
+        restoredMostCorrelated.acceptPersistInserter(inserter);
+        inserter.toXml(newXml);
+
+        CPPUNIT_ASSERT_EQUAL(origXml, newXml);
     }
-    LOG_DEBUG(<< "original k-most correlated XML = " << origXml);
+}
 
-    // Restore the XML into a new sketch.
-    core::CRapidXmlParser parser;
-    CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(origXml));
-    core::CRapidXmlStateRestoreTraverser traverser(parser);
-    maths::CKMostCorrelated restoredMostCorrelated(10, 0.001);
-    CPPUNIT_ASSERT(traverser.traverseSubLevel(boost::bind(
-        &maths::CKMostCorrelated::acceptRestoreTraverser, &restoredMostCorrelated, _1)));
+void CKMostCorrelatedTest::testIncremental() {
+    // Compare the cost per capture and the recall of the correlated pairs
+    // for incremental and batch searches.
 
-    LOG_DEBUG(<< "orig checksum = " << origMostCorrelated.checksum()
-              << ", new checksum = " << restoredMostCorrelated.checksum());
-    CPPUNIT_ASSERT_EQUAL(origMostCorrelated.checksum(), restoredMostCorrelated.checksum());
+    using TSizeSizePrVec = CKMostCorrelatedForTest::TSizeSizePrVec;
+
+    maths::CSampling::seed();
+
+    test::CRandomNumbers rng;
 
-    std::string newXml;
-    core::CRapidXmlStatePersistInserter inserter("root");
-    restoredMostCorrelated.acceptPersistInserter(inserter);
-    inserter.toXml(newXml);
+    std::size_t n{2000};
+    std::size_t buckets{200};
 
-    CPPUNIT_ASSERT_EQUAL(origXml, newXml);
+    TDoubleVec samples;
+    rng.generateNormalSamples(0.0, 1.0, n * buckets, samples);
+    TDoubleVec noise;
+    rng.generateNormalSamples(0.0, 0.2, n * buckets, noise);
+
+    // Variables (2i, 2i + 1) are correlated.
+    for (std::size_t i = 0u; i < samples.size(); i += 2) {
+        samples[i + 1] = (i % 4 == 0 ? 1.0 : -1.0) * samples[i] + noise[i];
+    }
+
+    double recall[2];
+
+    for (auto incremental : {false, true}) {
+        CKMostCorrelatedForTest mostCorrelated(n / 2, 0.0, incremental);
+        mostCorrelated.addVariables(n);
+
+        core::CStopWatch watch;
+        uint64_t maxTime{0};
+        uint64_t total{0};
+        for (std::size_t i = 0u; i < buckets; ++i) {
+            for (std::size_t j = 0u; j < n; ++j) {
+                mostCorrelated.add(j, samples[i * n + j]);
+            }
+            watch.reset(true);
+            mostCorrelated.capture();
+            uint64_t time{watch.stop()};
+            // The incremental search isn't used until the collection is
+            // full, which happens after the first search.
+            if (i >= 40) {
+                maxTime = std::max(maxTime, time);
+            }
+            total += time;
+        }
+
+        TSizeSizePrVec correlatedPairs;
+        mostCorrelated.mostCorrelated(correlatedPairs);
+        double found{0.0};
+        for (const auto& pair : correlatedPairs) {
+            if (pair.first % 2 == 0 && pair.second == pair.first + 1) {
+                found += 1.0;
+            }
+        }
+
+        recall[incremental] = found / static_cast<double>(n / 2);
+        LOG_DEBUG(<< "incremental = " << incremental << ", recall = " << recall[incremental]
+                  << ", max capture time = " << maxTime << "ms, total time = " << total << "ms");
+    }
+
+    CPPUNIT_ASSERT(recall[1] > 0.95 * recall[0]);
 }
 
 CppUnit::Test* CKMostCorrelatedTest::suite() {
@@ -850,6 +922,8 @@ CppUnit::Test* CKMostCorrelatedTest::suite() {
         "CKMostCorrelatedTest::testScale", &CKMostCorrelatedTest::testScale));
     suiteOfTests->addTest(new CppUnit::TestCaller<CKMostCorrelatedTest>(
         "CKMostCorrelatedTest::testPersistence", &CKMostCorrelatedTest::testPersistence));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CKMostCorrelatedTest>(
+        "CKMostCorrelatedTest::testIncremental", &CKMostCorrelatedTest::testIncremental));
 
     return suiteOfTests;
 }
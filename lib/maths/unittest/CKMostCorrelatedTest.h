@@ -21,6 +21,7 @@ public:
     void testMissingData();
     void testPersistence();
     void testScale();
+    void testIncremental();
 
     static CppUnit::Test* suite();
 };
@@ -7,14 +7,20 @@
 #include "CLinearAlgebraTest.h"
 
 #include <core/CLogger.h>
+#include <core/Constants.h>
 
 #include <maths/CLinearAlgebra.h>
 #include <maths/CLinearAlgebraEigen.h>
 #include <maths/CLinearAlgebraPersist.h>
 #include <maths/CLinearAlgebraTools.h>
 
+#include <test/CRandomNumbers.h>
+
 #include <boost/range.hpp>
 
+#include <cmath>
+#include <limits>
+
 #include <vector>
 
 using namespace ml;
@@ -991,6 +997,85 @@ std::string print(const MATRIX& m) {
 }
 }
 
+void CLinearAlgebraTest::testSmallMatrixClosedForms() {
+    // Check the closed form calculations used for 2x2 and 3x3 positive
+    // definite matrices agree with the SVD, including for matrices which
+    // are close to singular and fall back to the SVD.
+
+    using TDenseMatrix = maths::CDenseMatrix<double>;
+    using TDenseVector = maths::CDenseVector<double>;
+
+    test::CRandomNumbers rng;
+
+    auto check = [](std::size_t d, const maths::CSymmetricMatrix<double>& m,
+                    const maths::CVector<double>& x) {
+        Eigen::JacobiSVD<TDenseMatrix> svd(maths::toDenseMatrix(m),
+                                           Eigen::ComputeFullU | Eigen::ComputeFullV);
+        std::size_t rank{static_cast<std::size_t>(svd.rank())};
+        if (rank < d) {
+            return;
+        }
+        double expectedLogDeterminant{0.0};
+        for (std::size_t i = 0u; i < d; ++i) {
+            expectedLogDeterminant += std::log(svd.singularValues()(i));
+        }
+        TDenseVector y{svd.solve(maths::toDenseVector(x))};
+        double expectedQuadratic{0.0};
+        for (std::size_t i = 0u; i < d; ++i) {
+            expectedQuadratic += x(i) * y(i);
+        }
+        double expectedLikelihood{
+            -0.5 * (expectedQuadratic + static_cast<double>(d) * core::constants::LOG_TWO_PI +
+                    expectedLogDeterminant)};
+
+        double logDeterminant;
+        double quadratic;
+        double likelihood;
+        CPPUNIT_ASSERT_EQUAL(maths_t::E_FpNoErrors,
+                             maths::logDeterminant(m, logDeterminant));
+        CPPUNIT_ASSERT_EQUAL(maths_t::E_FpNoErrors,
+                             maths::inverseQuadraticForm(m, x, quadratic));
+        CPPUNIT_ASSERT_EQUAL(maths_t::E_FpNoErrors,
+                             maths::gaussianLogLikelihood(m, x, likelihood));
+        // The error in solving the system grows with the condition number.
+        double condition{svd.singularValues()(0) / svd.singularValues()(d - 1)};
+        double tolerance{std::max(1e-8, 100.0 * condition *
+                                            std::numeric_limits<double>::epsilon())};
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedLogDeterminant, logDeterminant,
+                                     tolerance * std::max(std::fabs(expectedLogDeterminant), 1.0));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedQuadratic, quadratic,
+                                     tolerance * std::max(expectedQuadratic, 1.0));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedLikelihood, likelihood,
+                                     tolerance * std::max(std::fabs(expectedLikelihood), 1.0));
+    };
+
+    TDoubleVec components;
+    TDoubleVec ridge;
+    for (std::size_t d = 2; d <= 3; ++d) {
+        for (std::size_t t = 0u; t < 500; ++t) {
+            // Generate A A^t + r I for random A and a ridge r whose scale
+            // varies from well conditioned to singular to working precision.
+            rng.generateUniformSamples(-5.0, 5.0, d * d + d, components);
+            rng.generateUniformSamples(-18.0, 1.0, 1, ridge);
+            maths::CSymmetricMatrix<double> m(d);
+            for (std::size_t i = 0u; i < d; ++i) {
+                for (std::size_t j = 0u; j <= i; ++j) {
+                    double mij{i == j ? std::pow(10.0, ridge[0]) : 0.0};
+                    for (std::size_t k = 0u; k + 1 < d; ++k) {
+                        mij += components[i * d + k] * components[j * d + k];
+                    }
+                    m(i, j) = mij;
+                }
+            }
+            maths::CVector<double> x(d);
+            for (std::size_t i = 0u; i < d; ++i) {
+                x(i) = components[d * d + i];
+            }
+            check(d, m, x);
+        }
+    }
+}
+
 void CLinearAlgebraTest::testProjected() {
     using TSizeVec = std::vector<std::size_t>;
 
@@ -1119,6 +1204,9 @@ CppUnit::Test* CLinearAlgebraTest::suite() {
         "CLinearAlgebraTest::testSampleGaussian", &CLinearAlgebraTest::testSampleGaussian));
     suiteOfTests->addTest(new CppUnit::TestCaller<CLinearAlgebraTest>(
         "CLinearAlgebraTest::testLogDeterminant", &CLinearAlgebraTest::testLogDeterminant));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CLinearAlgebraTest>(
+        "CLinearAlgebraTest::testSmallMatrixClosedForms",
+        &CLinearAlgebraTest::testSmallMatrixClosedForms));
     suiteOfTests->addTest(new CppUnit::TestCaller<CLinearAlgebraTest>(
         "CLinearAlgebraTest::testProjected", &CLinearAlgebraTest::testProjected));
     suiteOfTests->addTest(new CppUnit::TestCaller<CLinearAlgebraTest>(
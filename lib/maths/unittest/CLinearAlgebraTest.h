@@ -20,6 +20,7 @@ public:
     void testGaussianLogLikelihood();
     void testSampleGaussian();
     void testLogDeterminant();
+    void testSmallMatrixClosedForms();
     void testProjected();
     void testPersist();
 
@@ -10,6 +10,7 @@
 #include <core/CJsonStatePersistInserter.h>
 #include <core/CJsonStateRestoreTraverser.h>
 #include <core/CLogger.h>
+#include <core/CStopWatch.h>
 #include <core/CRapidXmlParser.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
@@ -25,6 +26,7 @@
 
 #include <boost/range.hpp>
 
+#include <cmath>
 #include <numeric>
 #include <sstream>
 #include <utility>
@@ -927,6 +929,106 @@ void CMultinomialConjugateTest::testConcentration() {
     }
 }
 
+void CMultinomialConjugateTest::testCachedProbabilities() {
+    // Test that we get identical probabilities when the sorted category
+    // probabilities are cached between updates and when they are computed
+    // from scratch. We use more categories than the prior can hold so
+    // the probabilities of uncounted categories are also tested.
+
+    test::CRandomNumbers rng;
+
+    TDoubleVec categories;
+    TDoubleVec probabilities;
+    for (std::size_t i = 0u; i < 2000; ++i) {
+        categories.push_back(static_cast<double>(i));
+        probabilities.push_back(std::pow(static_cast<double>(i + 1), -1.2));
+    }
+    double Z = std::accumulate(probabilities.begin(), probabilities.end(), 0.0);
+    for (auto& p : probabilities) {
+        p /= Z;
+    }
+
+    CMultinomialConjugate filter(CMultinomialConjugate::nonInformativePrior(1500, 0.01));
+    CMultinomialConjugate reference(filter);
+
+    maths_t::EProbabilityCalculation calculations[] = {
+        maths_t::E_TwoSided, maths_t::E_OneSidedBelow, maths_t::E_OneSidedAbove};
+
+    double checksum = 0.0;
+    for (std::size_t t = 0u; t < 20; ++t) {
+        TDoubleVec samples;
+        rng.generateMultinomialSamples(categories, probabilities, 500, samples);
+        TDouble1Vec samples_(samples.begin(), samples.end());
+        maths_t::TDoubleWeightsAry1Vec weights(samples_.size(), maths_t::CUnitWeights::UNIT);
+        filter.addSamples(samples_, weights);
+        reference.addSamples(samples_, weights);
+        if (t % 2 == 1) {
+            filter.propagateForwardsByTime(1.0);
+            reference.propagateForwardsByTime(1.0);
+        }
+
+        TDoubleVec queries;
+        rng.generateMultinomialSamples(categories, probabilities, 100, queries);
+        for (std::size_t i = 0u; i < queries.size(); ++i) {
+            TDouble1Vec sample;
+            if (i % 5 == 4) {
+                sample.assign(queries.begin() + i - 4, queries.begin() + i + 1);
+                sample.push_back(2500.0);
+            } else {
+                sample.assign(1, queries[i]);
+            }
+            maths_t::TDoubleWeightsAry1Vec weights(sample.size(),
+                                                   maths_t::CUnitWeights::UNIT);
+
+            for (auto calculation : calculations) {
+                // Copies of the reference don't have cached probabilities.
+                CMultinomialConjugate uncached(reference);
+
+                double lb1, ub1, lb2, ub2;
+                maths_t::ETail tail1, tail2;
+                CPPUNIT_ASSERT(filter.probabilityOfLessLikelySamples(
+                    calculation, sample, weights, lb1, ub1, tail1));
+                CPPUNIT_ASSERT(uncached.probabilityOfLessLikelySamples(
+                    calculation, sample, weights, lb2, ub2, tail2));
+                CPPUNIT_ASSERT_EQUAL(lb2, lb1);
+                CPPUNIT_ASSERT_EQUAL(ub2, ub1);
+                CPPUNIT_ASSERT_EQUAL(tail2, tail1);
+                checksum += lb1 + ub1;
+            }
+        }
+
+        CMultinomialConjugate uncached(reference);
+        TDoubleVec lbs1, ubs1, lbs2, ubs2;
+        filter.probabilitiesOfLessLikelyCategories(maths_t::E_TwoSided, lbs1, ubs1);
+        uncached.probabilitiesOfLessLikelyCategories(maths_t::E_TwoSided, lbs2, ubs2);
+        CPPUNIT_ASSERT(lbs1 == lbs2);
+        CPPUNIT_ASSERT(ubs1 == ubs2);
+    }
+    LOG_DEBUG(<< "checksum = " << checksum);
+    CPPUNIT_ASSERT_EQUAL(reference.checksum(), filter.checksum());
+
+    // Compare the cost of repeated queries with and without the cache.
+    TDoubleVec queries;
+    rng.generateMultinomialSamples(categories, probabilities, 2000, queries);
+    double lb, ub;
+    maths_t::ETail tail;
+    core::CStopWatch watch{true};
+    for (auto query : queries) {
+        filter.probabilityOfLessLikelySamples(maths_t::E_TwoSided, {query},
+                                              maths_t::CUnitWeights::SINGLE_UNIT,
+                                              lb, ub, tail);
+    }
+    uint64_t cached{watch.lap()};
+    for (auto query : queries) {
+        CMultinomialConjugate uncached(reference);
+        uncached.probabilityOfLessLikelySamples(maths_t::E_TwoSided, {query},
+                                                maths_t::CUnitWeights::SINGLE_UNIT,
+                                                lb, ub, tail);
+    }
+    uint64_t uncached{watch.lap() - cached};
+    LOG_DEBUG(<< "cached = " << cached << "ms, uncached = " << uncached << "ms");
+}
+
 CppUnit::Test* CMultinomialConjugateTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CMultinomialConjugateTest");
 
@@ -960,6 +1062,9 @@ CppUnit::Test* CMultinomialConjugateTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CMultinomialConjugateTest>(
         "CMultinomialConjugateTest::testConcentration",
         &CMultinomialConjugateTest::testConcentration));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CMultinomialConjugateTest>(
+        "CMultinomialConjugateTest::testCachedProbabilities",
+        &CMultinomialConjugateTest::testCachedProbabilities));
 
     return suiteOfTests;
 }
@@ -22,6 +22,7 @@ public:
     void testPersist();
     void testOverflow();
     void testConcentration();
+    void testCachedProbabilities();
 
     static CppUnit::Test* suite();
 };
@@ -10,6 +10,7 @@
 #include <core/CRapidXmlParser.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
+#include <core/CStopWatch.h>
 
 #include <maths/CIntegration.h>
 #include <maths/CMultivariateNormalConjugate.h>
@@ -1063,6 +1064,57 @@ void CMultivariateNormalConjugateTest::dataGenerator() {
     f.close();
 }
 
+void CMultivariateNormalConjugateTest::testLatLongPerformance() {
+    // Time computing likelihoods and probabilities for the bivariate
+    // priors used for lat_long.
+
+    const double mean[]{51.5, -0.1};
+    const double covariance[]{0.04, 0.01, 0.09};
+
+    test::CRandomNumbers rng;
+
+    TDouble10Vec1Vec samples;
+    gaussianSamples(rng, 5000, mean, covariance, samples);
+
+    maths::CMultivariateNormalConjugate<2> filter(
+        maths::CMultivariateNormalConjugate<2>::nonInformativePrior(maths_t::E_ContinuousData));
+    filter.addSamples(TDouble10Vec1Vec(samples.begin(), samples.begin() + 100),
+                      maths_t::TDouble10VecWeightsAry1Vec(
+                          100, maths_t::CUnitWeights::unit<TDouble10Vec>(2)));
+
+    core::CStopWatch watch{true};
+    double totalLogLikelihood{0.0};
+    for (std::size_t t = 0u; t < 10; ++t) {
+        for (const auto& sample : samples) {
+            double logLikelihood;
+            filter.jointLogMarginalLikelihood(
+                {sample}, maths_t::CUnitWeights::singleUnit<TDouble10Vec>(2), logLikelihood);
+            totalLogLikelihood += logLikelihood;
+        }
+    }
+    std::uint64_t likelihoodTime{watch.stop()};
+
+    watch.reset(true);
+    double totalProbability{0.0};
+    for (const auto& sample : samples) {
+        double lb, ub;
+        maths::CMultivariatePrior::TTail10Vec tail;
+        filter.probabilityOfLessLikelySamples(
+            maths_t::E_TwoSided, {sample},
+            maths_t::CUnitWeights::singleUnit<TDouble10Vec>(2), lb, ub, tail);
+        totalProbability += (lb + ub) / 2.0;
+    }
+    std::uint64_t probabilityTime{watch.stop()};
+
+    double n{static_cast<double>(samples.size())};
+    LOG_DEBUG(<< "likelihood time = " << likelihoodTime
+              << "ms, probability time = " << probabilityTime << "ms");
+    LOG_DEBUG(<< "mean log likelihood = " << totalLogLikelihood / 10.0 / n);
+    LOG_DEBUG(<< "mean probability = " << totalProbability / n);
+    CPPUNIT_ASSERT(totalProbability / n > 0.4);
+    CPPUNIT_ASSERT(totalProbability / n < 0.6);
+}
+
 CppUnit::Test* CMultivariateNormalConjugateTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CMultivariateNormalConjugateTest");
 
@@ -1099,6 +1151,9 @@ CppUnit::Test* CMultivariateNormalConjugateTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CMultivariateNormalConjugateTest>(
         "CMultivariateNormalConjugateTest::testPersist",
         &CMultivariateNormalConjugateTest::testPersist));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CMultivariateNormalConjugateTest>(
+        "CMultivariateNormalConjugateTest::testLatLongPerformance",
+        &CMultivariateNormalConjugateTest::testLatLongPerformance));
     //suiteOfTests->addTest( new CppUnit::TestCaller<CMultivariateNormalConjugateTest>(
     //                               "CMultivariateNormalConjugateTest::calibrationExperiment",
     //                               &CMultivariateNormalConjugateTest::calibrationExperiment) );
@@ -22,6 +22,7 @@ public:
     void testIntegerData();
     void testLowVariationData();
     void testPersist();
+    void testLatLongPerformance();
     void calibrationExperiment();
     void dataGenerator();
 
@@ -26,6 +26,7 @@
 using namespace ml;
 
 using TDoubleVec = std::vector<double>;
+using TDoubleVecVec = std::vector<TDoubleVec>;
 using TDouble1Vec = core::CSmallVector<double, 1>;
 using TDouble1VecVec = std::vector<TDouble1Vec>;
 using TDoubleSizePr = std::pair<double, std::size_t>;
@@ -230,6 +231,58 @@ void CNaiveBayesTest::testPropagationByTime() {
     }
 }
 
+void CNaiveBayesTest::testBatchClassProbability() {
+    // Check that the probabilities computed for a batch of points
+    // match computing them one at a time, including when features
+    // are missing.
+
+    test::CRandomNumbers rng;
+
+    TDoubleVec trainingData[4];
+    rng.generateNormalSamples(0.0, 12.0, 100, trainingData[0]);
+    rng.generateNormalSamples(10.0, 16.0, 100, trainingData[1]);
+    rng.generateNormalSamples(3.0, 14.0, 200, trainingData[2]);
+    rng.generateNormalSamples(-5.0, 24.0, 200, trainingData[3]);
+
+    maths::CNormalMeanPrecConjugate normal{maths::CNormalMeanPrecConjugate::nonInformativePrior(
+        maths_t::E_ContinuousData)};
+    maths::CNaiveBayes nb[]{
+        maths::CNaiveBayes{maths::CNaiveBayesFeatureDensityFromPrior(normal)},
+        maths::CNaiveBayes{maths::CNaiveBayesFeatureDensityFromPrior(normal), 0.0, -25.0}};
+    for (auto& nb_ : nb) {
+        for (std::size_t i = 0u; i < 100; ++i) {
+            nb_.addTrainingDataPoint(1, {{trainingData[0][i]}, {trainingData[1][i]}});
+        }
+        for (std::size_t i = 0u; i < 200; ++i) {
+            nb_.addTrainingDataPoint(2, {{trainingData[2][i]}, {trainingData[3][i]}});
+        }
+    }
+
+    TDoubleVecVec x(2);
+    rng.generateUniformSamples(-20.0, 20.0, 500, x[0]);
+    rng.generateUniformSamples(-30.0, 30.0, 500, x[1]);
+
+    TDoubleVec probabilities;
+    for (const auto& nb_ : nb) {
+        for (std::size_t label : {1, 2, 3}) {
+            nb_.classProbability(label, x, probabilities);
+            CPPUNIT_ASSERT_EQUAL(x[0].size(), probabilities.size());
+            for (std::size_t j = 0u; j < probabilities.size(); ++j) {
+                double expected{nb_.classProbability(label, {{x[0][j]}, {x[1][j]}})};
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, probabilities[j], 1e-12);
+            }
+
+            TDoubleVecVec missing{x[0], TDoubleVec{}};
+            nb_.classProbability(label, missing, probabilities);
+            CPPUNIT_ASSERT_EQUAL(x[0].size(), probabilities.size());
+            for (std::size_t j = 0u; j < probabilities.size(); ++j) {
+                double expected{nb_.classProbability(label, {{x[0][j]}, {}})};
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, probabilities[j], 1e-12);
+            }
+        }
+    }
+}
+
 void CNaiveBayesTest::testMemoryUsage() {
     // Check invariants.
 
@@ -327,6 +380,9 @@ CppUnit::Test* CNaiveBayesTest::suite() {
         "CNaiveBayesTest::testClassification", &CNaiveBayesTest::testClassification));
     suiteOfTests->addTest(new CppUnit::TestCaller<CNaiveBayesTest>(
         "CNaiveBayesTest::testPropagationByTime", &CNaiveBayesTest::testPropagationByTime));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CNaiveBayesTest>(
+        "CNaiveBayesTest::testBatchClassProbability",
+        &CNaiveBayesTest::testBatchClassProbability));
     suiteOfTests->addTest(new CppUnit::TestCaller<CNaiveBayesTest>(
         "CNaiveBayesTest::testMemoryUsage", &CNaiveBayesTest::testMemoryUsage));
     suiteOfTests->addTest(new CppUnit::TestCaller<CNaiveBayesTest>(
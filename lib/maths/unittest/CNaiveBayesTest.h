@@ -13,6 +13,7 @@ class CNaiveBayesTest : public CppUnit::TestFixture {
 public:
     void testClassification();
     void testPropagationByTime();
+    void testBatchClassProbability();
     void testMemoryUsage();
     void testPersist();
 
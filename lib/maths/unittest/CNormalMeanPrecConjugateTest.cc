@@ -1547,6 +1547,47 @@ void CNormalMeanPrecConjugateTest::testCountVarianceScale() {
     }
 }
 
+void CNormalMeanPrecConjugateTest::testPointLogMarginalLikelihood() {
+    // Check that the cached point log likelihood is identical to the
+    // joint log likelihood of a single sample with unit weight.
+
+    test::CRandomNumbers rng;
+
+    TDoubleVec samples;
+    rng.generateNormalSamples(20.0, 9.0, 100, samples);
+    TDoubleVec points;
+    rng.generateUniformSamples(-10.0, 50.0, 50, points);
+
+    maths_t::EDataType dataTypes[] = {maths_t::E_ContinuousData, maths_t::E_IntegerData};
+    for (std::size_t t = 0u; t < boost::size(dataTypes); ++t) {
+        LOG_DEBUG(<< "data type = " << dataTypes[t]);
+
+        CNormalMeanPrecConjugate filter(makePrior(dataTypes[t], 0.01));
+
+        for (std::size_t i = 0u; i < samples.size(); ++i) {
+            filter.addSamples({dataTypes[t] == maths_t::E_IntegerData
+                                   ? std::floor(samples[i])
+                                   : samples[i]});
+            filter.propagateForwardsByTime(1.0);
+            if (i % 10 != 0) {
+                continue;
+            }
+
+            maths::CNormalMeanPrecConjugate::CPointLogMarginalLikelihood logLikelihood(filter);
+            for (auto x : points) {
+                double expected;
+                maths_t::EFloatingPointErrorStatus expectedStatus =
+                    filter.jointLogMarginalLikelihood(
+                        {x}, maths_t::CUnitWeights::SINGLE_UNIT, expected);
+                double actual;
+                maths_t::EFloatingPointErrorStatus actualStatus = logLikelihood(x, actual);
+                CPPUNIT_ASSERT_EQUAL(expectedStatus, actualStatus);
+                CPPUNIT_ASSERT_EQUAL(expected, actual);
+            }
+        }
+    }
+}
+
 CppUnit::Test* CNormalMeanPrecConjugateTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CNormalMeanPrecConjugateTest");
 
@@ -1599,6 +1640,9 @@ CppUnit::Test* CNormalMeanPrecConjugateTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CNormalMeanPrecConjugateTest>(
         "CNormalMeanPrecConjugateTest::testCountVarianceScale",
         &CNormalMeanPrecConjugateTest::testCountVarianceScale));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CNormalMeanPrecConjugateTest>(
+        "CNormalMeanPrecConjugateTest::testPointLogMarginalLikelihood",
+        &CNormalMeanPrecConjugateTest::testPointLogMarginalLikelihood));
 
     return suiteOfTests;
 }
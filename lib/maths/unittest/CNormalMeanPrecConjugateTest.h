@@ -28,6 +28,7 @@ public:
     void testPersist();
     void testSeasonalVarianceScale();
     void testCountVarianceScale();
+    void testPointLogMarginalLikelihood();
 
     static CppUnit::Test* suite();
 };
@@ -8,6 +8,7 @@
 
 #include <core/CContainerPrinter.h>
 #include <core/CLogger.h>
+#include <core/CStopWatch.h>
 
 #include <maths/CPRNG.h>
 #include <maths/CStatisticalTests.h>
@@ -17,8 +18,12 @@
 #include <boost/random/normal_distribution.hpp>
 #include <boost/random/uniform_01.hpp>
 
+#include <vector>
+
 using namespace ml;
 
+using TUInt64Vec = std::vector<uint64_t>;
+
 void CPRNGTest::testSplitMix64() {
     maths::CPRNG::CSplitMix64 rng1;
 
@@ -369,6 +374,113 @@ void CPRNGTest::testXorShift1024Mult() {
     }
 }
 
+void CPRNGTest::testXorOShiro128PlusX4() {
+    maths::CPRNG::CXorOShiro128PlusX4 rng1(7);
+
+    boost::uniform_01<> u01;
+
+    // Test the streams are xoroshiro128+ generators which are jumps
+    // of one another.
+    {
+        maths::CPRNG::CXorOShiro128Plus streams[4];
+        streams[0].seed(7);
+        for (std::size_t i = 1u; i < 4; ++i) {
+            streams[i] = streams[i - 1];
+            streams[i].jump();
+        }
+        maths::CPRNG::CXorOShiro128PlusX4 rng2(rng1);
+        for (std::size_t t = 0u; t < 1000; ++t) {
+            CPPUNIT_ASSERT_EQUAL(streams[t % 4](), rng2());
+        }
+    }
+
+    // Test generate is consistent with operator() whatever the
+    // position in the current block.
+    for (std::size_t offset = 0u; offset < 5; ++offset) {
+        maths::CPRNG::CXorOShiro128PlusX4 rng2(rng1);
+        maths::CPRNG::CXorOShiro128PlusX4 rng3(rng1);
+        for (std::size_t i = 0u; i < offset; ++i) {
+            CPPUNIT_ASSERT_EQUAL(rng2(), rng3());
+        }
+        uint64_t samples1[51] = {0u};
+        rng2.generate(&samples1[0], &samples1[51]);
+        uint64_t samples2[51] = {0u};
+        for (std::size_t i = 0u; i < 51; ++i) {
+            samples2[i] = rng3();
+        }
+        CPPUNIT_ASSERT(std::equal(&samples1[0], &samples1[51], &samples2[0]));
+        CPPUNIT_ASSERT(rng2 == rng3);
+    }
+
+    // Test distribution.
+    {
+        boost::random::mt19937_64 mt;
+        maths::CBasicStatistics::SSampleMean<double>::TAccumulator m1;
+        maths::CBasicStatistics::SSampleMean<double>::TAccumulator m2;
+        uint64_t samples[5000];
+        for (std::size_t t = 0u; t < 50; ++t) {
+            maths::CStatisticalTests::CCramerVonMises cvm1(50);
+            maths::CStatisticalTests::CCramerVonMises cvm2(50);
+            rng1.generate(&samples[0], &samples[5000]);
+            for (std::size_t i = 0u; i < 5000; ++i) {
+                cvm1.addF(static_cast<double>(samples[i] >> 11) / 9007199254740992.0);
+                cvm2.addF(u01(mt));
+            }
+            m1.add(cvm1.pValue());
+            m2.add(cvm2.pValue());
+        }
+        LOG_DEBUG(<< "m1 = " << maths::CBasicStatistics::mean(m1));
+        LOG_DEBUG(<< "m2 = " << maths::CBasicStatistics::mean(m2));
+        CPPUNIT_ASSERT(maths::CBasicStatistics::mean(m1) >
+                       0.95 * maths::CBasicStatistics::mean(m2));
+    }
+
+    // Test discard.
+    for (std::size_t n = 0u; n < 10; ++n) {
+        maths::CPRNG::CXorOShiro128PlusX4 rng2(rng1);
+        maths::CPRNG::CXorOShiro128PlusX4 rng3(rng1);
+        rng2.discard(n);
+        for (std::size_t i = 0u; i < n; ++i) {
+            rng3();
+        }
+        for (std::size_t t = 0u; t < 50; ++t) {
+            CPPUNIT_ASSERT_EQUAL(rng2(), rng3());
+        }
+    }
+
+    // Test serialization.
+    rng1();
+    std::string state = rng1.toString();
+    LOG_DEBUG(<< "state = " << state);
+    maths::CPRNG::CXorOShiro128PlusX4 rng4;
+    CPPUNIT_ASSERT(rng4.fromString(state));
+    CPPUNIT_ASSERT(rng1 == rng4);
+    for (std::size_t t = 0u; t < 500; ++t) {
+        CPPUNIT_ASSERT_EQUAL(rng1(), rng4());
+    }
+
+    // Compare the speed of bulk generation with xoroshiro128+.
+    {
+        maths::CPRNG::CXorOShiro128Plus rng5;
+        TUInt64Vec samples(1000);
+        uint64_t checksum{0};
+        core::CStopWatch watch{true};
+        for (std::size_t t = 0u; t < 10000; ++t) {
+            rng5.generate(samples.begin(), samples.end());
+            checksum ^= samples[t % 1000];
+        }
+        uint64_t single{watch.lap()};
+        for (std::size_t t = 0u; t < 10000; ++t) {
+            rng1.generate(&samples[0], &samples[0] + samples.size());
+            checksum ^= samples[t % 1000];
+        }
+        uint64_t interleaved{watch.lap() - single};
+        LOG_DEBUG(<< "checksum = " << checksum);
+        LOG_DEBUG(<< "xoroshiro128+ " << single
+                  << "ms, xoroshiro128+ x4 " << interleaved << "ms");
+    }
+}
+
 CppUnit::Test* CPRNGTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CPRNGTest");
 
@@ -378,6 +490,8 @@ CppUnit::Test* CPRNGTest::suite() {
         "CPRNGTest::testXorOShiro128Plus", &CPRNGTest::testXorOShiro128Plus));
     suiteOfTests->addTest(new CppUnit::TestCaller<CPRNGTest>(
         "CPRNGTest::testXorShift1024Mult", &CPRNGTest::testXorShift1024Mult));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CPRNGTest>(
+        "CPRNGTest::testXorOShiro128PlusX4", &CPRNGTest::testXorOShiro128PlusX4));
 
     return suiteOfTests;
 }
@@ -14,6 +14,7 @@ public:
     void testSplitMix64();
     void testXorOShiro128Plus();
     void testXorShift1024Mult();
+    void testXorOShiro128PlusX4();
 
     static CppUnit::Test* suite();
 };
@@ -20,6 +20,7 @@
 
 #include <boost/math/constants/constants.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -749,6 +750,32 @@ void CPeriodicityHypothesisTestsTest::testTestForPeriods() {
     CPPUNIT_ASSERT(TP[2] / (TP[2] + FN[2]) > 0.99);
 }
 
+void CPeriodicityHypothesisTestsTest::testConfigChecksum() {
+    // Check that configurations which differ in any setting have
+    // different checksums.
+
+    using TUInt64Vec = std::vector<uint64_t>;
+
+    TUInt64Vec checksums;
+    maths::CPeriodicityHypothesisTestsConfig config;
+    checksums.push_back(config.checksum());
+    CPPUNIT_ASSERT_EQUAL(checksums[0], maths::CPeriodicityHypothesisTestsConfig().checksum());
+
+    config.hasDaily(true);
+    checksums.push_back(config.checksum());
+    config.hasWeekend(true);
+    checksums.push_back(config.checksum());
+    config.hasWeekly(true);
+    checksums.push_back(config.checksum());
+    config.startOfWeek(core::constants::DAY);
+    checksums.push_back(config.checksum());
+    config.disableDiurnal();
+    checksums.push_back(config.checksum());
+
+    std::sort(checksums.begin(), checksums.end());
+    CPPUNIT_ASSERT(std::unique(checksums.begin(), checksums.end()) == checksums.end());
+}
+
 CppUnit::Test* CPeriodicityHypothesisTestsTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CPeriodicityHypothesisTestsTest");
 
@@ -770,6 +797,9 @@ CppUnit::Test* CPeriodicityHypothesisTestsTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CPeriodicityHypothesisTestsTest>(
         "CPeriodicityHypothesisTestsTest::testTestForPeriods",
         &CPeriodicityHypothesisTestsTest::testTestForPeriods));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CPeriodicityHypothesisTestsTest>(
+        "CPeriodicityHypothesisTestsTest::testConfigChecksum",
+        &CPeriodicityHypothesisTestsTest::testConfigChecksum));
 
     return suiteOfTests;
 }
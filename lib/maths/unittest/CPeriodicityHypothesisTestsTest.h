@@ -17,6 +17,7 @@ public:
     void testWithSparseData();
     void testWithOutliers();
     void testTestForPeriods();
+    void testConfigChecksum();
 
     static CppUnit::Test* suite();
 };
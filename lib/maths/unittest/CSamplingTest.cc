@@ -8,12 +8,18 @@
 
 #include <core/CContainerPrinter.h>
 #include <core/CLogger.h>
+#include <core/CStopWatch.h>
 
 #include <maths/CBasicStatistics.h>
+#include <maths/CPRNG.h>
 #include <maths/CSampling.h>
+#include <maths/CStatisticalTests.h>
 
+#include <boost/math/distributions/normal.hpp>
+#include <boost/math/distributions/uniform.hpp>
 #include <boost/range.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 
@@ -213,6 +219,123 @@ void CSamplingTest::testMultivariateNormalSample() {
     }
 }
 
+void CSamplingTest::testBulkSample() {
+    // Test the bulk samplers which use interleaved xoroshiro128+ streams
+    // are reproducible and sample the right distributions.
+
+    using TMeanVarAccumulator = maths::CBasicStatistics::SSampleMeanVar<double>::TAccumulator;
+    using TMeanAccumulator = maths::CBasicStatistics::SSampleMean<double>::TAccumulator;
+
+    maths::CPRNG::CXorOShiro128PlusX4 rng1(1);
+    maths::CPRNG::CXorOShiro128Plus rng2(1);
+
+    {
+        TDoubleVec samples1;
+        TDoubleVec samples2;
+        maths::CPRNG::CXorOShiro128PlusX4 rng3(rng1);
+        maths::CSampling::uniformSample(rng1, 2.0, 5.0, 1001, samples1);
+        maths::CSampling::uniformSample(rng3, 2.0, 5.0, 1001, samples2);
+        CPPUNIT_ASSERT(samples1 == samples2);
+        maths::CSampling::normalSample(rng1, 3.0, 4.0, 1001, samples1);
+        maths::CSampling::normalSample(rng3, 3.0, 4.0, 1001, samples2);
+        CPPUNIT_ASSERT(samples1 == samples2);
+        CPPUNIT_ASSERT(rng1 == rng3);
+    }
+
+    LOG_DEBUG(<< "*** uniform ***");
+    {
+        boost::math::uniform_distribution<> uniform(2.0, 5.0);
+        TMeanVarAccumulator moments;
+        TMeanAccumulator p1;
+        TMeanAccumulator p2;
+        TDoubleVec samples1;
+        TDoubleVec samples2;
+        for (std::size_t t = 0u; t < 50; ++t) {
+            maths::CSampling::uniformSample(rng1, 2.0, 5.0, 5000, samples1);
+            maths::CSampling::uniformSample(rng2, 2.0, 5.0, 5000, samples2);
+            maths::CStatisticalTests::CCramerVonMises cvm1(50);
+            maths::CStatisticalTests::CCramerVonMises cvm2(50);
+            for (std::size_t i = 0u; i < samples1.size(); ++i) {
+                CPPUNIT_ASSERT(samples1[i] >= 2.0 && samples1[i] < 5.0);
+                moments.add(samples1[i]);
+                cvm1.addF(boost::math::cdf(uniform, samples1[i]));
+                cvm2.addF(boost::math::cdf(uniform, samples2[i]));
+            }
+            p1.add(cvm1.pValue());
+            p2.add(cvm2.pValue());
+        }
+        LOG_DEBUG(<< "moments = " << moments);
+        LOG_DEBUG(<< "p1 = " << maths::CBasicStatistics::mean(p1)
+                  << ", p2 = " << maths::CBasicStatistics::mean(p2));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(3.5, maths::CBasicStatistics::mean(moments), 0.01);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.75, maths::CBasicStatistics::variance(moments), 0.01);
+        CPPUNIT_ASSERT(maths::CBasicStatistics::mean(p1) >
+                       0.95 * maths::CBasicStatistics::mean(p2));
+    }
+
+    LOG_DEBUG(<< "*** normal ***");
+    {
+        boost::math::normal_distribution<> normal(3.0, 2.0);
+        TMeanVarAccumulator moments;
+        TMeanAccumulator p1;
+        TMeanAccumulator p2;
+        TDoubleVec samples1;
+        TDoubleVec samples2;
+        for (std::size_t t = 0u; t < 50; ++t) {
+            maths::CSampling::normalSample(rng1, 3.0, 4.0, 5000, samples1);
+            maths::CSampling::normalSample(rng2, 3.0, 4.0, 5000, samples2);
+            maths::CStatisticalTests::CCramerVonMises cvm1(50);
+            maths::CStatisticalTests::CCramerVonMises cvm2(50);
+            for (std::size_t i = 0u; i < samples1.size(); ++i) {
+                moments.add(samples1[i]);
+                cvm1.addF(boost::math::cdf(normal, samples1[i]));
+                cvm2.addF(boost::math::cdf(normal, samples2[i]));
+            }
+            p1.add(cvm1.pValue());
+            p2.add(cvm2.pValue());
+        }
+        LOG_DEBUG(<< "moments = " << moments);
+        LOG_DEBUG(<< "p1 = " << maths::CBasicStatistics::mean(p1)
+                  << ", p2 = " << maths::CBasicStatistics::mean(p2));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, maths::CBasicStatistics::mean(moments), 0.02);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, maths::CBasicStatistics::variance(moments), 0.05);
+        CPPUNIT_ASSERT(maths::CBasicStatistics::mean(p1) >
+                       0.95 * maths::CBasicStatistics::mean(p2));
+
+        // Check we sample the tails beyond the ziggurat's base layer
+        // with the correct frequency.
+        TDoubleVec samples;
+        maths::CSampling::normalSample(rng1, 0.0, 1.0, 2000000, samples);
+        double tail = static_cast<double>(std::count_if(
+            samples.begin(), samples.end(),
+            [](double x) { return std::fabs(x) > 3.5; }));
+        double expectedTail = 2.0 * 2000000.0 *
+                              boost::math::cdf(boost::math::normal_distribution<>(), -3.5);
+        LOG_DEBUG(<< "tail = " << tail << ", expected = " << expectedTail);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedTail, tail, 0.1 * expectedTail);
+    }
+
+    LOG_DEBUG(<< "*** timing ***");
+    {
+        TDoubleVec samples;
+        double checksum = 0.0;
+        core::CStopWatch watch{true};
+        for (std::size_t t = 0u; t < 200; ++t) {
+            maths::CSampling::normalSample(rng2, 0.0, 1.0, 10000, samples);
+            checksum += samples[t];
+        }
+        uint64_t single = watch.lap();
+        for (std::size_t t = 0u; t < 200; ++t) {
+            maths::CSampling::normalSample(rng1, 0.0, 1.0, 10000, samples);
+            checksum += samples[t];
+        }
+        uint64_t bulk = watch.lap() - single;
+        LOG_DEBUG(<< "checksum = " << checksum);
+        LOG_DEBUG(<< "normal: xoroshiro128+ " << single
+                  << "ms, xoroshiro128+ x4 " << bulk << "ms");
+    }
+}
+
 CppUnit::Test* CSamplingTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CSamplingTest");
 
@@ -221,6 +344,8 @@ CppUnit::Test* CSamplingTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CSamplingTest>(
         "CSamplingTest::testMultivariateNormalSample",
         &CSamplingTest::testMultivariateNormalSample));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CSamplingTest>(
+        "CSamplingTest::testBulkSample", &CSamplingTest::testBulkSample));
 
     return suiteOfTests;
 }
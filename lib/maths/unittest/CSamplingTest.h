@@ -13,6 +13,7 @@ class CSamplingTest : public CppUnit::TestFixture {
 public:
     void testMultinomialSample();
     void testMultivariateNormalSample();
+    void testBulkSample();
 
     static CppUnit::Test* suite();
 };
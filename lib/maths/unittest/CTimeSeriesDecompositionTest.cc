@@ -11,6 +11,9 @@
 #include <core/CRapidXmlParser.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
+#include <core/CStaticThreadPool.h>
+#include <core/CStatistics.h>
+#include <core/CStopWatch.h>
 #include <core/CTimezone.h>
 #include <core/Constants.h>
 
@@ -19,6 +22,7 @@
 #include <maths/CNormalMeanPrecConjugate.h>
 #include <maths/CRestoreParams.h>
 #include <maths/CSeasonalTime.h>
+#include <maths/CTimeSeriesChangeDetector.h>
 #include <maths/CTimeSeriesDecomposition.h>
 #include <maths/Constants.h>
 
@@ -28,6 +32,7 @@
 #include <boost/math/constants/constants.hpp>
 
 #include <fstream>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -1955,6 +1960,230 @@ void CTimeSeriesDecompositionTest::testComponentLifecycle() {
     }
 }
 
+void CTimeSeriesDecompositionTest::testBackgroundPeriodicityTests() {
+    // Check that running the periodicity tests in the background finds
+    // the same components one value later and that pending tests are
+    // persisted and rerun on restore.
+
+    const double decayRate = 0.01;
+    const core_t::TTime bucketLength = HALF_HOUR;
+
+    TTimeVec times;
+    TDoubleVec trend;
+    for (core_t::TTime time = 0; time <= 3 * WEEK; time += HALF_HOUR) {
+        double daily = 15.0 + 10.0 * std::sin(boost::math::double_constants::two_pi *
+                                              static_cast<double>(time) /
+                                              static_cast<double>(DAY));
+        times.push_back(time);
+        trend.push_back(daily);
+    }
+
+    test::CRandomNumbers rng;
+    TDoubleVec noise;
+    rng.generateNormalSamples(0.0, 4.0, times.size(), noise);
+
+    auto persist = [](const maths::CTimeSeriesDecomposition& decomposition) {
+        std::string xml;
+        core::CRapidXmlStatePersistInserter inserter("root");
+        decomposition.acceptPersistInserter(inserter);
+        inserter.toXml(xml);
+        return xml;
+    };
+    auto restore = [&](const std::string& xml) {
+        core::CRapidXmlParser parser;
+        CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(xml));
+        core::CRapidXmlStateRestoreTraverser traverser(parser);
+        maths::STimeSeriesDecompositionRestoreParams params{
+            decayRate, bucketLength,
+            maths::SDistributionRestoreParams{maths_t::E_ContinuousData, decayRate}};
+        return std::make_shared<maths::CTimeSeriesDecomposition>(params, traverser);
+    };
+
+    maths::CTimeSeriesDecomposition foreground(decayRate, bucketLength);
+    maths::CTimeSeriesDecomposition background(decayRate, bucketLength);
+    std::shared_ptr<maths::CTimeSeriesDecomposition> restored;
+
+    uint64_t tests{core::CStatistics::stat(stat_t::E_NumberPeriodicityTests).value()};
+    std::size_t foregroundDetected{times.size()};
+    std::size_t backgroundDetected{times.size()};
+    std::size_t restoredDetected{times.size()};
+    std::size_t maxXmlSize{0};
+    std::size_t restoredAt{0};
+
+    for (std::size_t i = 0u; i < times.size(); ++i) {
+        foreground.addPoint(times[i], trend[i] + noise[i]);
+        if (foregroundDetected == times.size() && foreground.seasonalComponents().size() > 0) {
+            foregroundDetected = i;
+        }
+    }
+
+    core::CStaticThreadPool::startDefault(2);
+
+    for (std::size_t i = 0u; i < times.size(); ++i) {
+        background.addPoint(times[i], trend[i] + noise[i]);
+        if (backgroundDetected == times.size() &&
+            background.seasonalComponents().size() > 0) {
+            backgroundDetected = i;
+        }
+        if (restored != nullptr) {
+            restored->addPoint(times[i], trend[i] + noise[i]);
+            if (restoredDetected == times.size() &&
+                restored->seasonalComponents().size() > 0) {
+                restoredDetected = i;
+            }
+        }
+
+        // The first test is scheduled after three days. Pending tests
+        // make the state noticeably larger.
+        if (times[i] > 3 * DAY - 2 * HOUR && times[i] < 3 * DAY + 2 * HOUR) {
+            std::string xml{persist(background)};
+            auto copy = restore(xml);
+            CPPUNIT_ASSERT_EQUAL(xml, persist(*copy));
+            if (xml.size() > maxXmlSize) {
+                maxXmlSize = xml.size();
+                restored = copy;
+                restoredAt = i;
+            }
+        }
+    }
+
+    core::CStaticThreadPool::stopDefault();
+
+    LOG_DEBUG(<< "detected in foreground = " << foregroundDetected
+              << ", in background = " << backgroundDetected);
+    LOG_DEBUG(<< "restored at " << restoredAt);
+    LOG_DEBUG(<< "tests = "
+              << core::CStatistics::stat(stat_t::E_NumberPeriodicityTests).value() - tests);
+    LOG_DEBUG(<< "time = "
+              << core::CStatistics::stat(stat_t::E_PeriodicityTestTime).value() << "us");
+
+    CPPUNIT_ASSERT(foregroundDetected < times.size());
+    CPPUNIT_ASSERT_EQUAL(foregroundDetected + 1, backgroundDetected);
+    CPPUNIT_ASSERT(restoredAt < backgroundDetected);
+    CPPUNIT_ASSERT_EQUAL(backgroundDetected, restoredDetected);
+    CPPUNIT_ASSERT(core::CStatistics::stat(stat_t::E_NumberPeriodicityTests).value() > tests);
+
+    TMeanAccumulator foregroundError;
+    TMeanAccumulator backgroundError;
+    for (std::size_t i = times.size() - 336; i < times.size(); ++i) {
+        foregroundError.add(std::fabs(mean(foreground.value(times[i], 0.0)) - trend[i]));
+        backgroundError.add(std::fabs(mean(background.value(times[i], 0.0)) - trend[i]));
+    }
+    LOG_DEBUG(<< "error in foreground = " << maths::CBasicStatistics::mean(foregroundError)
+              << ", in background = " << maths::CBasicStatistics::mean(backgroundError));
+    CPPUNIT_ASSERT(maths::CBasicStatistics::mean(backgroundError) <
+                   1.1 * maths::CBasicStatistics::mean(foregroundError));
+}
+
+void CTimeSeriesDecompositionTest::testPredictionCache() {
+    // Check that memoized predictions are identical to recomputing them,
+    // that they are invalidated by updates and time shifts and measure
+    // the speed up for repeated queries.
+
+    const core_t::TTime bucketLength = HALF_HOUR;
+
+    TTimeVec times;
+    TDoubleVec trend;
+    for (core_t::TTime time = 0; time <= 6 * WEEK; time += HALF_HOUR) {
+        double daily = 15.0 + 10.0 * std::sin(boost::math::double_constants::two_pi *
+                                              static_cast<double>(time) /
+                                              static_cast<double>(DAY));
+        double weekly = 5.0 * std::cos(boost::math::double_constants::two_pi *
+                                       static_cast<double>(time) /
+                                       static_cast<double>(WEEK));
+        times.push_back(time);
+        trend.push_back(daily + weekly + 0.0001 * static_cast<double>(time) / HOUR);
+    }
+
+    test::CRandomNumbers rng;
+    TDoubleVec noise;
+    rng.generateNormalSamples(0.0, 1.0, times.size(), noise);
+
+    maths::CTimeSeriesDecomposition decomposition(0.01, bucketLength);
+    for (std::size_t i = 0u; i < times.size(); ++i) {
+        decomposition.addPoint(times[i], trend[i] + noise[i]);
+    }
+    LOG_DEBUG(<< "# components = " << decomposition.seasonalComponents().size());
+    CPPUNIT_ASSERT(decomposition.seasonalComponents().size() > 0);
+
+    int masks[]{maths::CTimeSeriesDecompositionInterface::E_All,
+                maths::CTimeSeriesDecompositionInterface::E_Seasonal,
+                maths::CTimeSeriesDecompositionInterface::E_Diurnal,
+                maths::CTimeSeriesDecompositionInterface::E_NonDiurnal,
+                maths::CTimeSeriesDecompositionInterface::E_Trend,
+                maths::CTimeSeriesDecompositionInterface::E_TrendForced,
+                maths::CTimeSeriesDecompositionInterface::E_Calendar};
+    double confidences[]{0.0, 50.0, 95.0};
+
+    auto checkAgainstFresh = [&](core_t::TTime time) {
+        // A copy starts with no memoized predictions.
+        maths::CTimeSeriesDecomposition fresh(decomposition);
+        for (auto confidence : confidences) {
+            for (auto mask : masks) {
+                for (auto smooth : {true, false}) {
+                    TDoubleDoublePr expected{fresh.value(time, confidence, mask, smooth)};
+                    for (std::size_t i = 0u; i < 2; ++i) {
+                        TDoubleDoublePr actual{
+                            decomposition.value(time, confidence, mask, smooth)};
+                        CPPUNIT_ASSERT_EQUAL(expected.first, actual.first);
+                        CPPUNIT_ASSERT_EQUAL(expected.second, actual.second);
+                    }
+                }
+            }
+        }
+    };
+
+    uint64_t hits{core::CStatistics::stat(stat_t::E_NumberPredictionCacheHits).value()};
+    uint64_t misses{core::CStatistics::stat(stat_t::E_NumberPredictionCacheMisses).value()};
+
+    core_t::TTime end{times.back()};
+    for (core_t::TTime time = end; time < end + DAY; time += 3 * HOUR) {
+        checkAgainstFresh(time);
+        decomposition.addPoint(time + HALF_HOUR, 20.0);
+        checkAgainstFresh(time);
+        maths::SChangeDescription shift{maths::SChangeDescription::E_TimeShift,
+                                        static_cast<double>(HOUR), nullptr};
+        decomposition.applyChange(time, 20.0, shift);
+        checkAgainstFresh(time);
+    }
+
+    uint64_t newHits{core::CStatistics::stat(stat_t::E_NumberPredictionCacheHits).value()};
+    uint64_t newMisses{core::CStatistics::stat(stat_t::E_NumberPredictionCacheMisses).value()};
+    LOG_DEBUG(<< "hits = " << newHits - hits << ", misses = " << newMisses - misses);
+    CPPUNIT_ASSERT(newHits > hits);
+
+    // Typical usage queries several combinations of components at the
+    // same time and confidence in each bucket.
+
+    maths::CTimeSeriesDecomposition uncached(decomposition);
+    core::CStopWatch cachedWatch;
+    core::CStopWatch uncachedWatch;
+    uint64_t cachedTime{0};
+    uint64_t uncachedTime{0};
+    double cachedTotal{0.0};
+    double uncachedTotal{0.0};
+    core_t::TTime start{end + 2 * DAY};
+    for (core_t::TTime time = start; time < start + WEEK; time += bucketLength) {
+        cachedWatch.start();
+        for (auto mask : masks) {
+            cachedTotal += mean(decomposition.value(time, 95.0, mask));
+        }
+        cachedTime = cachedWatch.stop();
+        uncachedWatch.start();
+        for (auto mask : masks) {
+            // Cycling through more times than are memoized defeats it.
+            for (core_t::TTime lag = 4 * DAY; lag > 0; lag -= DAY) {
+                uncached.value(time - lag, 95.0, mask);
+            }
+            uncachedTotal += mean(uncached.value(time, 95.0, mask));
+        }
+        uncachedTime = uncachedWatch.stop();
+    }
+    LOG_DEBUG(<< "cached time = " << cachedTime << "ms, uncached time = " << uncachedTime
+              << "ms (five times as many queries)");
+    CPPUNIT_ASSERT_EQUAL(uncachedTotal, cachedTotal);
+}
+
 void CTimeSeriesDecompositionTest::testSwap() {
     const double decayRate = 0.01;
     const core_t::TTime bucketLength = HALF_HOUR;
@@ -2262,6 +2491,12 @@ CppUnit::Test* CTimeSeriesDecompositionTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesDecompositionTest>(
         "CTimeSeriesDecompositionTest::testComponentLifecycle",
         &CTimeSeriesDecompositionTest::testComponentLifecycle));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesDecompositionTest>(
+        "CTimeSeriesDecompositionTest::testBackgroundPeriodicityTests",
+        &CTimeSeriesDecompositionTest::testBackgroundPeriodicityTests));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesDecompositionTest>(
+        "CTimeSeriesDecompositionTest::testPredictionCache",
+        &CTimeSeriesDecompositionTest::testPredictionCache));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesDecompositionTest>(
         "CTimeSeriesDecompositionTest::testSwap", &CTimeSeriesDecompositionTest::testSwap));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesDecompositionTest>(
@@ -30,6 +30,8 @@ public:
     void testCalendar();
     void testConditionOfTrend();
     void testComponentLifecycle();
+    void testBackgroundPeriodicityTests();
+    void testPredictionCache();
     void testSwap();
     void testPersist();
     void testUpgrade();
@@ -10,6 +10,7 @@
 #include <core/CRapidXmlParser.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
+#include <core/CStopWatch.h>
 
 #include <maths/CDecayRateController.h>
 #include <maths/CLogNormalMeanPrecConjugate.h>
@@ -2294,6 +2295,101 @@ void CTimeSeriesModelTest::testDaylightSaving() {
     }
 }
 
+void CTimeSeriesModelTest::testActiveChangeDetectorLimit() {
+    // Check that a level shift in many time series at once only tests
+    // for change in the maximum permitted number at any one time and
+    // measure the memory and time this saves.
+
+    using TModelPtr = std::unique_ptr<maths::CUnivariateTimeSeriesModel>;
+    using TModelPtrVec = std::vector<TModelPtr>;
+
+    const core_t::TTime bucketLength{600};
+    const std::size_t numberSeries{20};
+    const std::size_t maximumActive{4};
+
+    test::CRandomNumbers rng;
+    TDoubleVecVec noise(numberSeries);
+    for (auto& noise_ : noise) {
+        rng.generateNormalSamples(0.0, 4.0, 1600, noise_);
+    }
+
+    TDouble2VecWeightsAryVec weight{maths_t::CUnitWeights::unit<TDouble2Vec>(1)};
+
+    std::size_t maxActive[2]{0, 0};
+    bool persistenceChecked{false};
+    std::size_t maxMemory[2]{0, 0};
+    uint64_t elapsed[2]{0, 0};
+    double error[2]{0.0, 0.0};
+
+    for (std::size_t limited : {0, 1}) {
+        maths::CModelParams params{modelParams(bucketLength)};
+        if (limited == 1) {
+            params.maximumNumberActiveChangeDetectors(maximumActive);
+        }
+        maths::CTimeSeriesDecomposition trend{24.0 * DECAY_RATE, bucketLength};
+        maths::CUnivariateTimeSeriesModel prototype{params, 0, trend,
+                                                    univariateNormal(DECAY_RATE / 3.0)};
+        TModelPtrVec models;
+        for (std::size_t i = 0u; i < numberSeries; ++i) {
+            models.emplace_back(prototype.clone(i));
+        }
+
+        core::CStopWatch watch;
+        core_t::TTime time{0};
+        for (std::size_t j = 0u; j < noise[0].size(); ++j, time += bucketLength) {
+            // All time series shift level at the same time.
+            double level{j < 1000 ? 20.0 : 50.0};
+            if (j >= 1000) {
+                watch.start();
+            }
+            for (std::size_t i = 0u; i < numberSeries; ++i) {
+                double value{level + noise[i][j]};
+                maths_t::setWinsorisationWeight(
+                    models[i]->winsorisationWeight(0.0, time, {value}), weight[0]);
+                models[i]->addSamples(addSampleParams(1.0, weight),
+                                      {core::make_triple(time, TDouble2Vec{value}, TAG)});
+            }
+            if (j >= 1000) {
+                elapsed[limited] = watch.stop();
+                std::size_t memory{0};
+                for (const auto& model : models) {
+                    memory += model->memoryUsage();
+                }
+                maxMemory[limited] = std::max(maxMemory[limited], memory);
+            }
+            std::size_t active{params.numberActiveChangeDetectors()};
+            if (active > 0 && persistenceChecked == false) {
+                // Copies made for persistence aren't testing for change.
+                TModelPtrVec copies;
+                for (const auto& model : models) {
+                    copies.emplace_back(model->cloneForPersistence());
+                }
+                CPPUNIT_ASSERT_EQUAL(active, params.numberActiveChangeDetectors());
+                persistenceChecked = true;
+            }
+            maxActive[limited] = std::max(maxActive[limited], active);
+        }
+
+        for (const auto& model : models) {
+            error[limited] += std::fabs(model->predict(time)[0] - 50.0) /
+                              static_cast<double>(numberSeries);
+        }
+        models.clear();
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), params.numberActiveChangeDetectors());
+    }
+
+    LOG_DEBUG(<< "unlimited: max active = " << maxActive[0] << ", max memory = "
+              << maxMemory[0] << ", time = " << elapsed[0] << "ms, error = " << error[0]);
+    LOG_DEBUG(<< "limited:   max active = " << maxActive[1] << ", max memory = "
+              << maxMemory[1] << ", time = " << elapsed[1] << "ms, error = " << error[1]);
+
+    CPPUNIT_ASSERT(persistenceChecked);
+    CPPUNIT_ASSERT(maxActive[0] > maximumActive);
+    CPPUNIT_ASSERT_EQUAL(maximumActive, maxActive[1]);
+    CPPUNIT_ASSERT(maxMemory[1] < maxMemory[0]);
+    CPPUNIT_ASSERT(error[1] < 1.0);
+}
+
 CppUnit::Test* CTimeSeriesModelTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CTimeSeriesModelTest");
 
@@ -2332,6 +2428,9 @@ CppUnit::Test* CTimeSeriesModelTest::suite() {
         "CTimeSeriesModelTest::testLinearScaling", &CTimeSeriesModelTest::testLinearScaling));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesModelTest>(
         "CTimeSeriesModelTest::testDaylightSaving", &CTimeSeriesModelTest::testDaylightSaving));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesModelTest>(
+        "CTimeSeriesModelTest::testActiveChangeDetectorLimit",
+        &CTimeSeriesModelTest::testActiveChangeDetectorLimit));
 
     return suiteOfTests;
 }
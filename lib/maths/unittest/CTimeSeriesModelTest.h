@@ -27,6 +27,7 @@ public:
     void testStepChangeDiscontinuities();
     void testLinearScaling();
     void testDaylightSaving();
+    void testActiveChangeDetectorLimit();
 
     static CppUnit::Test* suite();
 };
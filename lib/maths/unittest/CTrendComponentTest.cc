@@ -6,9 +6,11 @@
 
 #include "CTrendComponentTest.h"
 
+#include <core/CContainerPrinter.h>
 #include <core/CLogger.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
+#include <core/CStopWatch.h>
 #include <core/CoreTypes.h>
 
 #include <maths/CBasicStatistics.h>
@@ -371,6 +373,63 @@ void CTrendComponentTest::testForecast() {
     }
 }
 
+void CTrendComponentTest::testForecastLevelShifts() {
+    // Check the roll outs of level shifts produce sensible forecast
+    // intervals for a series with regular steps.
+
+    test::CRandomNumbers rng;
+
+    core_t::TTime bucketLength{600};
+
+    maths::CTrendComponent component{0.012};
+
+    TDoubleVec knots;
+    TDoubleVec steps;
+    TDoubleVec noise;
+    double level{0.0};
+    core_t::TTime time{0};
+    for (std::size_t i = 0u; i < 20; ++i) {
+        rng.generateUniformSamples(200.0, 400.0, 1, knots);
+        rng.generateUniformSamples(5.0, 15.0, 1, steps);
+        core_t::TTime knot{time + bucketLength * static_cast<core_t::TTime>(knots[0])};
+        for (/**/; time < knot; time += bucketLength) {
+            rng.generateNormalSamples(0.0, 1.0, 1, noise);
+            component.add(time, level + noise[0]);
+            component.dontShiftLevel(time, level);
+            component.propagateForwardsByTime(bucketLength);
+        }
+        level += steps[0];
+        component.shiftLevel(time, level, steps[0]);
+    }
+
+    component.shiftOrigin(time);
+
+    TDouble3VecVec forecast;
+    core::CStopWatch watch{true};
+    component.forecast(time, time + 2000 * bucketLength, bucketLength, 90.0,
+                       [](core_t::TTime) { return TDouble3Vec(3, 0.0); },
+                       [&forecast](core_t::TTime, const TDouble3Vec& value) {
+                           forecast.push_back(value);
+                       });
+    LOG_DEBUG(<< "forecast time = " << watch.stop() << "ms");
+
+    LOG_DEBUG(<< "level = " << level);
+    LOG_DEBUG(<< "initial = " << core::CContainerPrinter::print(forecast.front()));
+    LOG_DEBUG(<< "final = " << core::CContainerPrinter::print(forecast.back()));
+
+    for (const auto& errorbar : forecast) {
+        CPPUNIT_ASSERT(errorbar[0] <= errorbar[1]);
+        CPPUNIT_ASSERT(errorbar[1] <= errorbar[2]);
+    }
+
+    // We expect roughly one step of 10 every 300 buckets.
+    double expectedShift{2000.0 / 300.0 * 10.0};
+    CPPUNIT_ASSERT(forecast.back()[1] - level > 0.5 * expectedShift);
+    CPPUNIT_ASSERT(forecast.back()[1] - level < 1.5 * expectedShift);
+    CPPUNIT_ASSERT(forecast.back()[2] - forecast.back()[0] >
+                   5.0 * (forecast.front()[2] - forecast.front()[0]));
+}
+
 void CTrendComponentTest::testPersist() {
     // Check that serialization is idempotent.
 
@@ -429,6 +488,9 @@ CppUnit::Test* CTrendComponentTest::suite() {
         "CTrendComponentTest::testDecayRate", &CTrendComponentTest::testDecayRate));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTrendComponentTest>(
         "CTrendComponentTest::testForecast", &CTrendComponentTest::testForecast));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTrendComponentTest>(
+        "CTrendComponentTest::testForecastLevelShifts",
+        &CTrendComponentTest::testForecastLevelShifts));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTrendComponentTest>(
         "CTrendComponentTest::testPersist", &CTrendComponentTest::testPersist));
 
@@ -14,6 +14,7 @@ public:
     void testValueAndVariance();
     void testDecayRate();
     void testForecast();
+    void testForecastLevelShifts();
     void testPersist();
 
     static CppUnit::Test* suite();
@@ -833,6 +833,71 @@ void CXMeansOnline1dTest::testPruneEmptyCluster() {
     CPPUNIT_ASSERT_EQUAL(std::size_t(2), clusterer.clusters().size());
 }
 
+void CXMeansOnline1dTest::testLogLikelihoodFromCluster() {
+    // Check that the cluster log likelihoods, which are cached between
+    // updates, match computing them directly from the cluster priors.
+
+    test::CRandomNumbers rng;
+
+    TDoubleVec mode1;
+    rng.generateNormalSamples(7.0, 1.0, 300, mode1);
+    TDoubleVec mode2;
+    rng.generateNormalSamples(25.0, 4.0, 300, mode2);
+    TDoubleVec samples(mode1);
+    samples.insert(samples.end(), mode2.begin(), mode2.end());
+    rng.random_shuffle(samples.begin(), samples.end());
+
+    TDoubleVec points;
+    rng.generateUniformSamples(0.0, 40.0, 20, points);
+
+    auto checkLogLikelihoods = [&points](const maths::CXMeansOnline1d& clusterer) {
+        for (const auto& cluster : clusterer.clusters()) {
+            for (auto x : points) {
+                double expected;
+                cluster.prior().jointLogMarginalLikelihood(
+                    {x}, maths_t::CUnitWeights::SINGLE_UNIT, expected);
+                expected += std::log(cluster.weight(maths_t::E_ClustersFractionWeight));
+                CPPUNIT_ASSERT_EQUAL(
+                    expected, cluster.logLikelihoodFromCluster(
+                                  maths_t::E_ClustersFractionWeight, x));
+            }
+        }
+    };
+
+    maths_t::EDataType dataTypes[] = {maths_t::E_ContinuousData, maths_t::E_IntegerData};
+    for (std::size_t t = 0u; t < boost::size(dataTypes); ++t) {
+        maths::CXMeansOnline1d clusterer(dataTypes[t], maths::CAvailableModeDistributions::ALL,
+                                         maths_t::E_ClustersFractionWeight, 0.001);
+
+        maths::CXMeansOnline1d::TSizeDoublePr2Vec dummy;
+        for (std::size_t i = 0u; i < samples.size(); ++i) {
+            double x = dataTypes[t] == maths_t::E_IntegerData ? std::floor(samples[i])
+                                                              : samples[i];
+            clusterer.add(x, dummy);
+            checkLogLikelihoods(clusterer);
+            clusterer.propagateForwardsByTime(1.0);
+            checkLogLikelihoods(clusterer);
+        }
+        CPPUNIT_ASSERT_EQUAL(std::size_t(2), clusterer.numberClusters());
+
+        std::string origXml;
+        {
+            core::CRapidXmlStatePersistInserter inserter("root");
+            clusterer.acceptPersistInserter(inserter);
+            inserter.toXml(origXml);
+        }
+        maths::SDistributionRestoreParams params(
+            dataTypes[t], 0.001, maths::MINIMUM_CLUSTER_SPLIT_FRACTION,
+            maths::MINIMUM_CLUSTER_SPLIT_COUNT, maths::MINIMUM_CATEGORY_COUNT);
+        core::CRapidXmlParser parser;
+        CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(origXml));
+        core::CRapidXmlStateRestoreTraverser traverser(parser);
+        maths::CXMeansOnline1d restoredClusterer(params, traverser);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(2), restoredClusterer.numberClusters());
+        checkLogLikelihoods(restoredClusterer);
+    }
+}
+
 CppUnit::Test* CXMeansOnline1dTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CXMeansOnline1dTest");
 
@@ -860,6 +925,9 @@ CppUnit::Test* CXMeansOnline1dTest::suite() {
         "CXMeansOnline1dTest::testPersist", &CXMeansOnline1dTest::testPersist));
     suiteOfTests->addTest(new CppUnit::TestCaller<CXMeansOnline1dTest>(
         "CXMeansOnline1dTest::testPruneEmptyCluster", &CXMeansOnline1dTest::testPruneEmptyCluster));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CXMeansOnline1dTest>(
+        "CXMeansOnline1dTest::testLogLikelihoodFromCluster",
+        &CXMeansOnline1dTest::testLogLikelihoodFromCluster));
 
     return suiteOfTests;
 }
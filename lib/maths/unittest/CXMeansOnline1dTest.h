@@ -22,6 +22,7 @@ public:
     void testLargeHistory();
     void testPersist();
     void testPruneEmptyCluster();
+    void testLogLikelihoodFromCluster();
 
     static CppUnit::Test* suite();
 };
@@ -17,6 +17,7 @@
 #include "CCategoricalToolsTest.h"
 #include "CChecksumTest.h"
 #include "CClustererTest.h"
+#include "CCompressedLengthSketchTest.h"
 #include "CCountMinSketchTest.h"
 #include "CDecayRateControllerTest.h"
 #include "CEntropySketchTest.h"
@@ -96,6 +97,7 @@ int main(int argc, const char** argv) {
     runner.addTest(CCalendarComponentAdaptiveBucketingTest::suite());
     runner.addTest(CChecksumTest::suite());
     runner.addTest(CClustererTest::suite());
+    runner.addTest(CCompressedLengthSketchTest::suite());
     runner.addTest(CCountMinSketchTest::suite());
     runner.addTest(CDecayRateControllerTest::suite());
     runner.addTest(CEqualWithToleranceTest::suite());
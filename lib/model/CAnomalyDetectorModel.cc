@@ -8,10 +8,13 @@
 
 #include <core/CAllocationStrategy.h>
 #include <core/CFunctional.h>
+#include <core/CJsonStatePersistInserter.h>
+#include <core/CJsonStateRestoreTraverser.h>
 #include <core/CLogger.h>
 #include <core/CStatePersistInserter.h>
 #include <core/CStateRestoreTraverser.h>
 #include <core/CStatistics.h>
+#include <core/CompressUtils.h>
 #include <core/RestoreMacros.h>
 
 #include <maths/CChecksum.h>
@@ -33,6 +36,8 @@
 #include <boost/bind.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <sstream>
 
 namespace ml {
 namespace model {
@@ -285,6 +290,18 @@ void CAnomalyDetectorModel::prune() {
     this->prune(this->defaultPruneWindow());
 }
 
+void CAnomalyDetectorModel::prunePeopleAndAttributes(const TSizeVec& /*people*/,
+                                                     const TSizeVec& /*attributes*/) {
+}
+
+core_t::TTime CAnomalyDetectorModel::personLastBucketTime(std::size_t /*pid*/) const {
+    return TIME_UNSET;
+}
+
+core_t::TTime CAnomalyDetectorModel::attributeLastBucketTime(std::size_t /*cid*/) const {
+    return TIME_UNSET;
+}
+
 uint64_t CAnomalyDetectorModel::checksum(bool /*includeCurrentBucketStats*/) const {
     using TStrCRefUInt64Map = std::map<TStrCRef, uint64_t, maths::COrderings::SLess>;
     uint64_t seed{m_DataGatherer->checksum()};
@@ -503,20 +520,157 @@ bool CAnomalyDetectorModel::SFeatureModels::acceptRestoreTraverser(const SModelP
 }
 
 void CAnomalyDetectorModel::SFeatureModels::acceptPersistInserter(core::CStatePersistInserter& inserter) const {
-    for (const auto& model : s_Models) {
+    for (std::size_t pid = 0u; pid < s_Models.size(); ++pid) {
+        if (this->isHibernating(pid)) {
+            TMathsModelUPtr model{this->restoreHibernating(pid)};
+            inserter.insertLevel(MODEL_TAG, boost::bind<void>(maths::CModelStateSerialiser(),
+                                                              boost::cref(*model), _1));
+        } else {
+            inserter.insertLevel(MODEL_TAG, boost::bind<void>(maths::CModelStateSerialiser(),
+                                                              boost::cref(*s_Models[pid]), _1));
+        }
+    }
+}
+
+bool CAnomalyDetectorModel::SFeatureModels::isHibernating(std::size_t pid) const {
+    return (pid < s_HibernatingModels.size() && s_HibernatingModels[pid].size() > 0) ||
+           (pid < s_SpilledModels.size() && s_SpilledModels[pid] != nullptr);
+}
+
+bool CAnomalyDetectorModel::SFeatureModels::hibernate(const SModelParams& params,
+                                                      std::size_t pid) {
+    if (pid >= s_Models.size() || s_Models[pid] == nullptr) {
+        return false;
+    }
+
+    if (s_RestoreParams == nullptr) {
+        maths_t::EDataType dataType{s_NewModel->dataType()};
+        s_RestoreParams = std::make_shared<maths::SModelRestoreParams>(
+            s_NewModel->params(), params.decompositionRestoreParams(dataType),
+            params.distributionRestoreParams(dataType));
+    }
+
+    std::ostringstream state;
+    {
+        core::CJsonStatePersistInserter inserter(state);
         inserter.insertLevel(MODEL_TAG, boost::bind<void>(maths::CModelStateSerialiser(),
-                                                          boost::cref(*model), _1));
+                                                          boost::cref(*s_Models[pid]), _1));
+    }
+
+    // We favour speed over compression ratio since a model is compressed
+    // every time it starts hibernating.
+    core::CDeflator deflator(false, Z_BEST_SPEED);
+    TByteVec compressed;
+    if (!deflator.addString(state.str()) || !deflator.finishAndTakeData(compressed)) {
+        LOG_ERROR(<< "Failed to compress model state for " << pid);
+        return false;
+    }
+
+    if (params.s_ModelSpillStore != nullptr) {
+        s_SpillStore = params.s_ModelSpillStore;
+        if (s_SpilledModels.size() <= pid) {
+            s_SpilledModels.resize(s_Models.size());
+        }
+        s_SpilledModels[pid] = std::make_shared<CModelSpillStore::CHandle>(
+            s_SpillStore->add(std::move(compressed)));
+    } else {
+        if (s_HibernatingModels.size() <= pid) {
+            core::CAllocationStrategy::resize(s_HibernatingModels, s_Models.size());
+        }
+        s_HibernatingModels[pid] = std::move(compressed);
+    }
+    s_Models[pid].reset();
+    core::CStatistics::stat(stat_t::E_NumberModelHibernations).increment();
+
+    return true;
+}
+
+bool CAnomalyDetectorModel::SFeatureModels::wake(std::size_t pid) {
+    if (this->isHibernating(pid) == false) {
+        return true;
+    }
+
+    using TClock = std::chrono::steady_clock;
+    TClock::time_point begin{TClock::now()};
+    s_Models[pid] = this->restoreHibernating(pid);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(TClock::now() - begin);
+    this->clearHibernating(pid);
+
+    core::CStatistics::stat(stat_t::E_NumberModelWakes).increment();
+    core::CStatistics::stat(stat_t::E_ModelWakeTime).increment(static_cast<uint64_t>(elapsed.count()));
+
+    return true;
+}
+
+void CAnomalyDetectorModel::SFeatureModels::clearHibernating(std::size_t pid) {
+    if (pid < s_HibernatingModels.size()) {
+        TByteVec empty;
+        s_HibernatingModels[pid].swap(empty);
+    }
+    if (pid < s_SpilledModels.size()) {
+        s_SpilledModels[pid].reset();
+    }
+}
+
+std::size_t CAnomalyDetectorModel::SFeatureModels::numberHibernating() const {
+    return std::count_if(s_HibernatingModels.begin(), s_HibernatingModels.end(),
+                         [](const TByteVec& state) { return state.size() > 0; }) +
+           std::count_if(s_SpilledModels.begin(), s_SpilledModels.end(),
+                         [](const TSpillHandlePtr& handle) {
+                             return handle != nullptr;
+                         });
+}
+
+CAnomalyDetectorModel::SFeatureModels::TByteVec
+CAnomalyDetectorModel::SFeatureModels::hibernatingState(std::size_t pid) const {
+    TByteVec result;
+    if (pid < s_HibernatingModels.size() && s_HibernatingModels[pid].size() > 0) {
+        result = s_HibernatingModels[pid];
+    } else if (pid < s_SpilledModels.size() && s_SpilledModels[pid] != nullptr &&
+               s_SpilledModels[pid]->read(result) == false) {
+        result.clear();
     }
+    return result;
+}
+
+CAnomalyDetectorModel::TMathsModelUPtr
+CAnomalyDetectorModel::SFeatureModels::restoreHibernating(std::size_t pid) const {
+    TMathsModelUPtr result;
+
+    core::CInflator inflator(false);
+    TByteVec state;
+    if (inflator.addVector(this->hibernatingState(pid)) && inflator.finishAndTakeData(state)) {
+        std::istringstream stream{std::string(state.begin(), state.end())};
+        core::CJsonStateRestoreTraverser traverser(stream);
+        if (traverser.name() != MODEL_TAG ||
+            traverser.traverseSubLevel(boost::bind<bool>(
+                maths::CModelStateSerialiser(), boost::cref(*s_RestoreParams),
+                boost::ref(result), _1)) == false) {
+            result.reset();
+        }
+    }
+
+    if (result == nullptr) {
+        // This should never happen, but we need a model for every person.
+        LOG_ERROR(<< "Failed to restore hibernating model for " << pid);
+        result.reset(s_NewModel->clone(pid));
+    }
+
+    return result;
 }
 
 void CAnomalyDetectorModel::SFeatureModels::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
     mem->setName("SFeatureModels");
     core::CMemoryDebug::dynamicSize("s_NewModel", s_NewModel, mem);
     core::CMemoryDebug::dynamicSize("s_Models", s_Models, mem);
+    core::CMemoryDebug::dynamicSize("s_HibernatingModels", s_HibernatingModels, mem);
+    core::CMemoryDebug::dynamicSize("s_SpilledModels", s_SpilledModels, mem);
 }
 
 std::size_t CAnomalyDetectorModel::SFeatureModels::memoryUsage() const {
-    return core::CMemory::dynamicSize(s_NewModel) + core::CMemory::dynamicSize(s_Models);
+    return core::CMemory::dynamicSize(s_NewModel) + core::CMemory::dynamicSize(s_Models) +
+           core::CMemory::dynamicSize(s_HibernatingModels) +
+           core::CMemory::dynamicSize(s_SpilledModels);
 }
 
 CAnomalyDetectorModel::SFeatureCorrelateModels::SFeatureCorrelateModels(
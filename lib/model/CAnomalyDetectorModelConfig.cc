@@ -73,6 +73,9 @@ const core_t::TTime
     CAnomalyDetectorModelConfig::DEFAULT_MINIMUM_TIME_TO_DETECT_CHANGE(12 * core::constants::HOUR);
 const core_t::TTime
     CAnomalyDetectorModelConfig::DEFAULT_MAXIMUM_TIME_TO_TEST_FOR_CHANGE(core::constants::DAY);
+const std::size_t CAnomalyDetectorModelConfig::DEFAULT_MAXIMUM_NUMBER_ACTIVE_CHANGE_DETECTORS(1000);
+const std::size_t CAnomalyDetectorModelConfig::DEFAULT_MODEL_HIBERNATION_AGE(0);
+const std::size_t CAnomalyDetectorModelConfig::DEFAULT_SPILLED_MODEL_HIBERNATION_AGE(24);
 const double CAnomalyDetectorModelConfig::DEFAULT_MAXIMUM_UPDATES_PER_BUCKET(1.0);
 const double CAnomalyDetectorModelConfig::DEFAULT_INFLUENCE_CUTOFF(0.5);
 const double CAnomalyDetectorModelConfig::DEFAULT_PRUNE_WINDOW_SCALE_MINIMUM(0.25);
@@ -167,7 +170,8 @@ double CAnomalyDetectorModelConfig::trendDecayRate(double modelDecayRate,
 CAnomalyDetectorModelConfig::CAnomalyDetectorModelConfig()
     : m_BucketLength(STANDARD_BUCKET_LENGTH),
       m_BucketResultsDelay(DEFAULT_BUCKET_RESULTS_DELAY),
-      m_MultivariateByFields(false), m_ModelPlotBoundsPercentile(-1.0),
+      m_MultivariateByFields(false), m_InfoContentEstimator(model_t::E_InfoContentDeflate),
+      m_ModelPlotBoundsPercentile(-1.0),
       m_MaximumAnomalousProbability(DEFAULT_MAXIMUM_ANOMALOUS_PROBABILITY),
       m_NoisePercentile(DEFAULT_NOISE_PERCENTILE),
       m_NoiseMultiplier(DEFAULT_NOISE_MULTIPLIER),
@@ -228,6 +232,10 @@ void CAnomalyDetectorModelConfig::multivariateByFields(bool enabled) {
     m_MultivariateByFields = enabled;
 }
 
+void CAnomalyDetectorModelConfig::infoContentEstimator(model_t::EInfoContentEstimator estimator) {
+    m_InfoContentEstimator = estimator;
+}
+
 void CAnomalyDetectorModelConfig::factories(const TFactoryTypeFactoryPtrMap& factories) {
     m_Factories = factories;
 }
@@ -647,6 +655,7 @@ CAnomalyDetectorModelConfig::factory(int identifier,
     result->features(features);
     result->bucketResultsDelay(m_BucketResultsDelay);
     result->multivariateByFields(m_MultivariateByFields);
+    result->infoContentEstimator(m_InfoContentEstimator);
     TIntDetectionRuleVecUMapCItr rulesItr = m_DetectionRules.get().find(identifier);
     if (rulesItr != m_DetectionRules.get().end()) {
         result->detectionRules(TDetectionRuleVecCRef(rulesItr->second));
@@ -690,6 +699,10 @@ bool CAnomalyDetectorModelConfig::multivariateByFields() const {
     return m_MultivariateByFields;
 }
 
+model_t::EInfoContentEstimator CAnomalyDetectorModelConfig::infoContentEstimator() const {
+    return m_InfoContentEstimator;
+}
+
 void CAnomalyDetectorModelConfig::modelPlotBoundsPercentile(double percentile) {
     if (percentile < 0.0 || percentile >= 100.0) {
         LOG_ERROR(<< "Bad confidence interval");
@@ -748,6 +761,15 @@ void CAnomalyDetectorModelConfig::scheduledEvents(TStrDetectionRulePrVecCRef sch
     m_ScheduledEvents = scheduledEvents;
 }
 
+void CAnomalyDetectorModelConfig::modelSpillStore(const TModelSpillStorePtr& store) {
+    for (auto& factory : m_Factories) {
+        factory.second->modelSpillStore(store);
+        if (factory.second->modelParams().s_ModelHibernationAge == 0) {
+            factory.second->modelHibernationAge(DEFAULT_SPILLED_MODEL_HIBERNATION_AGE);
+        }
+    }
+}
+
 core_t::TTime CAnomalyDetectorModelConfig::samplingAgeCutoff() const {
     return m_Factories.begin()->second->modelParams().s_SamplingAgeCutoff;
 }
@@ -761,7 +783,10 @@ const std::string INDIVIDUAL_MODE_FRACTION_PROPERTY("individualmodefraction");
 const std::string POPULATION_MODE_FRACTION_PROPERTY("populationmodefraction");
 const std::string PEERS_MODE_FRACTION_PROPERTY("peersmodefraction");
 const std::string COMPONENT_SIZE_PROPERTY("componentsize");
+const std::string MODEL_HIBERNATION_AGE_PROPERTY("modelhibernationage");
+const std::string MAXIMUM_ACTIVE_CHANGE_DETECTORS_PROPERTY("maximumactivechangedetectors");
 const std::string SAMPLE_COUNT_FACTOR_PROPERTY("samplecountfactor");
+const std::string INFO_CONTENT_ESTIMATOR_PROPERTY("infocontentestimator");
 const std::string PRUNE_WINDOW_SCALE_MINIMUM("prunewindowscaleminimum");
 const std::string PRUNE_WINDOW_SCALE_MAXIMUM("prunewindowscalemaximum");
 const std::string AGGREGATION_STYLE_PARAMS("aggregationstyleparams");
@@ -883,6 +908,26 @@ bool CAnomalyDetectorModelConfig::processStanza(const boost::property_tree::ptre
             for (auto& factory : m_Factories) {
                 factory.second->componentSize(componentSize);
             }
+        } else if (propName == MODEL_HIBERNATION_AGE_PROPERTY) {
+            int age;
+            if (core::CStringUtils::stringToType(propValue, age) == false || age < 0) {
+                LOG_ERROR(<< "Invalid value for property " << propName << " : " << propValue);
+                result = false;
+                continue;
+            }
+            for (auto& factory : m_Factories) {
+                factory.second->modelHibernationAge(age);
+            }
+        } else if (propName == MAXIMUM_ACTIVE_CHANGE_DETECTORS_PROPERTY) {
+            int number;
+            if (core::CStringUtils::stringToType(propValue, number) == false || number < 0) {
+                LOG_ERROR(<< "Invalid value for property " << propName << " : " << propValue);
+                result = false;
+                continue;
+            }
+            for (auto& factory : m_Factories) {
+                factory.second->maximumNumberActiveChangeDetectors(number);
+            }
         } else if (propName == SAMPLE_COUNT_FACTOR_PROPERTY) {
             int factor;
             if (core::CStringUtils::stringToType(propValue, factor) == false || factor < 0) {
@@ -893,6 +938,16 @@ bool CAnomalyDetectorModelConfig::processStanza(const boost::property_tree::ptre
             for (auto& factory : m_Factories) {
                 factory.second->sampleCountFactor(factor);
             }
+        } else if (propName == INFO_CONTENT_ESTIMATOR_PROPERTY) {
+            if (propValue == "deflate") {
+                this->infoContentEstimator(model_t::E_InfoContentDeflate);
+            } else if (propValue == "sketch") {
+                this->infoContentEstimator(model_t::E_InfoContentSketch);
+            } else {
+                LOG_ERROR(<< "Invalid value for property " << propName << " : " << propValue);
+                result = false;
+                continue;
+            }
         } else if (propName == PRUNE_WINDOW_SCALE_MINIMUM) {
             double factor;
             if (core::CStringUtils::stringToType(propValue, factor) == false) {
@@ -286,11 +286,7 @@ bool CBucketGatherer::addEventData(CEventData& data) {
                     CStringStore::influencers().get(*influence);
                 canonicalInfluences[i] = inf;
                 if (count > 0) {
-                    influencerCounts[i]
-                        .emplace(boost::unordered::piecewise_construct,
-                                 boost::make_tuple(pidCid, inf),
-                                 boost::make_tuple(uint64_t(0)))
-                        .first->second += count;
+                    influencerCounts[i][{pidCid, inf}] += count;
                 }
             }
         }
@@ -321,9 +317,17 @@ void CBucketGatherer::hiddenTimeNow(core_t::TTime time, bool skipUpdates) {
         // the latency window, thus we push a new count bucket only
         // after startNewBucket has been called.
         this->startNewBucket(newBucketStart, skipUpdates);
-        m_PersonAttributeCounts.push(TSizeSizePrUInt64UMap(1), newBucketStart);
+        // The counts are recycled so their memory is reused by each
+        // bucket rather than being freed and reallocated.
+        m_PersonAttributeCounts.pushRecycled(
+            newBucketStart, [](TSizeSizePrUInt64UMap& counts) { counts.clear(); });
         m_PersonAttributeExplicitNulls.push(TSizeSizePrUSet(1), newBucketStart);
-        m_InfluencerCounts.push(TSizeSizePrStoredStringPtrPrUInt64UMapVec(), newBucketStart);
+        m_InfluencerCounts.pushRecycled(
+            newBucketStart, [](TSizeSizePrStoredStringPtrPrUInt64UMapVec& counts) {
+                for (auto& influencerCounts : counts) {
+                    influencerCounts.clear();
+                }
+            });
         for (auto bucketLength : m_DataGatherer.params().s_MultipleBucketLengths) {
             if (newBucketStart % bucketLength == 0) {
                 m_MultiBucketPersonAttributeCounts[bucketLength].clear();
@@ -499,6 +503,42 @@ bool CBucketGatherer::validateSampleTimes(core_t::TTime& startTime, core_t::TTim
     return false;
 }
 
+bool CBucketGatherer::featureData(core_t::TTime /*time*/,
+                                  core_t::TTime /*bucketLength*/,
+                                  TFeatureSizeEventRateFeatureDataPrVecPrVec& result) const {
+    LOG_ERROR(<< "Individual event rate feature data not available from "
+              << this->persistenceTag() << " gatherer");
+    result.clear();
+    return false;
+}
+
+bool CBucketGatherer::featureData(core_t::TTime /*time*/,
+                                  core_t::TTime /*bucketLength*/,
+                                  TFeatureSizeSizePrEventRateFeatureDataPrVecPrVec& result) const {
+    LOG_ERROR(<< "Population event rate feature data not available from "
+              << this->persistenceTag() << " gatherer");
+    result.clear();
+    return false;
+}
+
+bool CBucketGatherer::featureData(core_t::TTime /*time*/,
+                                  core_t::TTime /*bucketLength*/,
+                                  TFeatureSizeMetricFeatureDataPrVecPrVec& result) const {
+    LOG_ERROR(<< "Individual metric feature data not available from "
+              << this->persistenceTag() << " gatherer");
+    result.clear();
+    return false;
+}
+
+bool CBucketGatherer::featureData(core_t::TTime /*time*/,
+                                  core_t::TTime /*bucketLength*/,
+                                  TFeatureSizeSizePrMetricFeatureDataPrVecPrVec& result) const {
+    LOG_ERROR(<< "Population metric feature data not available from "
+              << this->persistenceTag() << " gatherer");
+    result.clear();
+    return false;
+}
+
 const CDataGatherer& CBucketGatherer::dataGatherer() const {
     return m_DataGatherer;
 }
@@ -31,7 +31,6 @@
 #include <boost/unordered_set.hpp>
 
 #include <algorithm>
-#include <atomic>
 #include <limits>
 #include <map>
 #include <string>
@@ -47,16 +46,16 @@ using TStrUInt64Map = std::map<std::string, uint64_t>;
 using TSizeSizePr = std::pair<std::size_t, std::size_t>;
 using TSizeSizePrVec = std::vector<TSizeSizePr>;
 using TUInt64Vec = std::vector<uint64_t>;
-using TSizeUSet = boost::unordered_set<std::size_t>;
+using TSizeUSet = CEventRateBucketGatherer::TSizeUSet;
 using TSizeUSetCItr = TSizeUSet::const_iterator;
-using TSizeUSetVec = std::vector<TSizeUSet>;
-using TMeanAccumulator = maths::CBasicStatistics::SSampleMean<double>::TAccumulator;
-using TSizeSizePrMeanAccumulatorUMap = boost::unordered_map<TSizeSizePr, TMeanAccumulator>;
+using TSizeUSetVec = CEventRateBucketGatherer::TSizeUSetVec;
+using TMeanAccumulator = CEventRateBucketGatherer::TMeanAccumulator;
+using TSizeSizePrMeanAccumulatorUMap = CEventRateBucketGatherer::TSizeSizePrMeanAccumulatorUMap;
 using TSizeSizePrUInt64Map = std::map<TSizeSizePr, uint64_t>;
-using TSizeSizePrMeanAccumulatorUMapQueue = CBucketQueue<TSizeSizePrMeanAccumulatorUMap>;
-using TCategoryAnyMap = CEventRateBucketGatherer::TCategoryAnyMap;
-using TSizeSizePrStrDataUMap = boost::unordered_map<TSizeSizePr, CUniqueStringFeatureData>;
-using TSizeSizePrStrDataUMapQueue = CBucketQueue<TSizeSizePrStrDataUMap>;
+using TSizeSizePrMeanAccumulatorUMapQueue = CEventRateBucketGatherer::TSizeSizePrMeanAccumulatorUMapQueue;
+using TCategoryData = CEventRateBucketGatherer::SCategoryData;
+using TSizeSizePrStrDataUMap = CEventRateBucketGatherer::TSizeSizePrStrDataUMap;
+using TSizeSizePrStrDataUMapQueue = CEventRateBucketGatherer::TSizeSizePrStrDataUMapQueue;
 using TStoredStringPtrVec = CBucketGatherer::TStoredStringPtrVec;
 
 // We use short field names to reduce the state size
@@ -171,42 +170,24 @@ void persistAttributePeopleData(const TSizeUSetVec& data,
 }
 
 //! Serialize \p featureData.
-void persistFeatureData(const TCategoryAnyMap& featureData,
+void persistFeatureData(const TCategoryData& featureData,
                         core::CStatePersistInserter& inserter) {
-    for (const auto& data_ : featureData) {
-        model_t::EEventRateCategory category = data_.first;
-        const boost::any& data = data_.second;
-        try {
-            switch (category) {
-            case model_t::E_DiurnalTimes:
-                inserter.insertLevel(
-                    TIMES_OF_DAY_TAG,
-                    boost::bind<void>(
-                        TSizeSizePrMeanAccumulatorUMapQueue::CSerializer<STimesBucketSerializer>(),
-                        boost::cref(boost::any_cast<const TSizeSizePrMeanAccumulatorUMapQueue&>(data)),
-                        _1));
-                break;
-            case model_t::E_MeanArrivalTimes:
-                // TODO
-                break;
-            case model_t::E_AttributePeople:
-                inserter.insertLevel(
-                    ATTRIBUTE_PEOPLE_TAG,
-                    boost::bind(&persistAttributePeopleData,
-                                boost::cref(boost::any_cast<const TSizeUSetVec&>(data)), _1));
-                break;
-            case model_t::E_UniqueValues:
-                inserter.insertLevel(
-                    UNIQUE_VALUES_TAG,
-                    boost::bind<void>(
-                        TSizeSizePrStrDataUMapQueue::CSerializer<SStrDataBucketSerializer>(),
-                        boost::cref(boost::any_cast<const TSizeSizePrStrDataUMapQueue&>(data)),
-                        _1));
-                break;
-            }
-        } catch (const std::exception& e) {
-            LOG_ERROR(<< "Failed to serialize data for " << category << ": " << e.what());
-        }
+    if (featureData.s_AttributePeople) {
+        inserter.insertLevel(ATTRIBUTE_PEOPLE_TAG,
+                             boost::bind(&persistAttributePeopleData,
+                                         boost::cref(*featureData.s_AttributePeople), _1));
+    }
+    if (featureData.s_UniqueValues) {
+        inserter.insertLevel(
+            UNIQUE_VALUES_TAG,
+            boost::bind<void>(TSizeSizePrStrDataUMapQueue::CSerializer<SStrDataBucketSerializer>(),
+                              boost::cref(*featureData.s_UniqueValues), _1));
+    }
+    if (featureData.s_DiurnalTimes) {
+        inserter.insertLevel(
+            TIMES_OF_DAY_TAG,
+            boost::bind<void>(TSizeSizePrMeanAccumulatorUMapQueue::CSerializer<STimesBucketSerializer>(),
+                              boost::cref(*featureData.s_DiurnalTimes), _1));
     }
 }
 
@@ -246,49 +227,38 @@ bool restoreAttributePeopleData(core::CStateRestoreTraverser& traverser, TSizeUS
 
 //! Extract \p featureData from a state document.
 bool restoreFeatureData(core::CStateRestoreTraverser& traverser,
-                        TCategoryAnyMap& featureData,
+                        TCategoryData& featureData,
                         std::size_t latencyBuckets,
                         core_t::TTime bucketLength,
                         core_t::TTime currentBucketStartTime) {
     const std::string& name = traverser.name();
     if (name == ATTRIBUTE_PEOPLE_TAG) {
-        TSizeUSetVec* data{boost::unsafe_any_cast<TSizeUSetVec>(
-            &featureData.emplace(model_t::E_AttributePeople, TSizeUSetVec())
-                 .first->second)};
+        if (!featureData.s_AttributePeople) {
+            featureData.s_AttributePeople = TSizeUSetVec();
+        }
         if (traverser.traverseSubLevel(boost::bind(&restoreAttributePeopleData, _1,
-                                                   boost::ref(*data))) == false) {
+                                                   boost::ref(*featureData.s_AttributePeople))) == false) {
             LOG_ERROR(<< "Invalid attribute/people mapping in " << traverser.value());
             return false;
         }
     } else if (name == UNIQUE_VALUES_TAG) {
-        if (featureData.count(model_t::E_UniqueValues) != 0) {
-            featureData.erase(model_t::E_UniqueValues);
-        }
-        TSizeSizePrStrDataUMapQueue* data{boost::unsafe_any_cast<TSizeSizePrStrDataUMapQueue>(
-            &featureData
-                 .emplace(model_t::E_UniqueValues,
-                          TSizeSizePrStrDataUMapQueue(latencyBuckets, bucketLength, currentBucketStartTime,
-                                                      TSizeSizePrStrDataUMap(1)))
-                 .first->second)};
+        featureData.s_UniqueValues = TSizeSizePrStrDataUMapQueue(
+            latencyBuckets, bucketLength, currentBucketStartTime, TSizeSizePrStrDataUMap(1));
         if (traverser.traverseSubLevel(boost::bind<bool>(
                 TSizeSizePrStrDataUMapQueue::CSerializer<SStrDataBucketSerializer>(
                     TSizeSizePrStrDataUMap(1)),
-                boost::ref(*data), _1)) == false) {
+                boost::ref(*featureData.s_UniqueValues), _1)) == false) {
             LOG_ERROR(<< "Invalid unique value mapping in " << traverser.value());
             return false;
         }
     } else if (name == TIMES_OF_DAY_TAG) {
-        if (featureData.count(model_t::E_DiurnalTimes) == 0) {
-            featureData.erase(model_t::E_DiurnalTimes);
-        }
-        TSizeSizePrMeanAccumulatorUMapQueue* data{boost::unsafe_any_cast<TSizeSizePrMeanAccumulatorUMapQueue>(
-            &featureData
-                 .emplace(model_t::E_DiurnalTimes,
-                          TSizeSizePrMeanAccumulatorUMapQueue(latencyBuckets, bucketLength, currentBucketStartTime))
-                 .first->second)};
+        if (!featureData.s_DiurnalTimes) {
+            featureData.s_DiurnalTimes = TSizeSizePrMeanAccumulatorUMapQueue(
+                latencyBuckets, bucketLength, currentBucketStartTime);
+        }
         if (traverser.traverseSubLevel(boost::bind<bool>(
                 TSizeSizePrMeanAccumulatorUMapQueue::CSerializer<STimesBucketSerializer>(),
-                boost::ref(*data), _1)) == false) {
+                boost::ref(*featureData.s_DiurnalTimes), _1)) == false) {
             LOG_ERROR(<< "Invalid times mapping in " << traverser.value());
             return false;
         }
@@ -306,52 +276,18 @@ const std::string& overField(bool population, const TStrVec& fieldNames) {
     return population ? fieldNames[0] : EMPTY_STRING;
 }
 
-template<typename ITR, typename T>
-struct SMaybeConst {};
-template<typename T>
-struct SMaybeConst<TCategoryAnyMap::iterator, T> {
-    using TRef = T&;
-};
-template<typename T>
-struct SMaybeConst<TCategoryAnyMap::const_iterator, T> {
-    using TRef = const T&;
-};
-
-//! Apply a function \p f to all the data held in [\p begin, \p end).
-template<typename ITR, typename F>
-void apply(ITR begin, ITR end, const F& f) {
-    for (ITR itr = begin; itr != end; ++itr) {
-        model_t::EEventRateCategory category = itr->first;
-        try {
-            switch (category) {
-            case model_t::E_DiurnalTimes: {
-                f(boost::any_cast<typename SMaybeConst<ITR, TSizeSizePrMeanAccumulatorUMapQueue>::TRef>(
-                    itr->second));
-                break;
-            }
-            case model_t::E_MeanArrivalTimes: {
-                // TODO
-                break;
-            }
-            case model_t::E_AttributePeople: {
-                f(boost::any_cast<typename SMaybeConst<ITR, TSizeUSetVec>::TRef>(itr->second));
-                break;
-            }
-            case model_t::E_UniqueValues:
-                f(boost::any_cast<typename SMaybeConst<ITR, TSizeSizePrStrDataUMapQueue>::TRef>(
-                    itr->second));
-                break;
-            }
-        } catch (const std::exception& e) {
-            LOG_ERROR(<< "Apply failed for " << category << ": " << e.what());
-        }
-    }
-}
-
 //! Apply a function \p f to all the data held in \p featureData.
 template<typename T, typename F>
 void apply(T& featureData, const F& f) {
-    apply(featureData.begin(), featureData.end(), f);
+    if (featureData.s_AttributePeople) {
+        f(*featureData.s_AttributePeople);
+    }
+    if (featureData.s_UniqueValues) {
+        f(*featureData.s_UniqueValues);
+    }
+    if (featureData.s_DiurnalTimes) {
+        f(*featureData.s_DiurnalTimes);
+    }
 }
 
 //! \brief Removes people from the feature data.
@@ -544,6 +480,9 @@ struct SResize {
 
 //! \brief Updates the feature data with some aggregated records.
 struct SAddValue {
+    explicit SAddValue(bool sketchInfoContent)
+        : s_SketchInfoContent(sketchInfoContent) {}
+
     void operator()(TSizeUSetVec& attributePeople,
                     std::size_t pid,
                     std::size_t cid,
@@ -570,7 +509,7 @@ struct SAddValue {
             personAttributeUniqueCounts.push(TSizeSizePrStrDataUMap(1), time);
         }
         TSizeSizePrStrDataUMap& counts = personAttributeUniqueCounts.get(time);
-        counts[{pid, cid}].insert(*uniqueString, influences);
+        counts[{pid, cid}].insert(*uniqueString, influences, s_SketchInfoContent);
     }
     void operator()(TSizeSizePrMeanAccumulatorUMapQueue& arrivalTimes,
                     std::size_t pid,
@@ -589,6 +528,9 @@ struct SAddValue {
             times[{pid, cid}].add(values[i][0]);
         }
     }
+
+    //! True if the unique strings' compressed length sketches are needed.
+    bool s_SketchInfoContent;
 };
 
 //! \brief Updates the feature data for the start of a new bucket.
@@ -700,22 +642,41 @@ bool restoreInfluencerUniqueStrings(core::CStateRestoreTraverser& traverser,
     return true;
 }
 
-//! Register the callbacks for computing the size of feature data gatherers
-//! with \p visitor.
-template<typename VISITOR>
-void registerMemoryCallbacks(VISITOR& visitor) {
-    visitor.template registerCallback<TSizeUSetVec>();
-    visitor.template registerCallback<TSizeSizePrStrDataUMapQueue>();
-    visitor.template registerCallback<TSizeSizePrMeanAccumulatorUMapQueue>();
+//! Get a sketch of the unique strings \p strings sized for their total
+//! length.
+CUniqueStringFeatureData::TSketch
+sketchOf(const CUniqueStringFeatureData::TWordStringUMap& strings) {
+    std::size_t bytes{0};
+    for (const auto& string : strings) {
+        bytes += string.second.size();
+    }
+    CUniqueStringFeatureData::TSketch result{CUniqueStringFeatureData::TSketch::sizeFor(bytes)};
+    for (const auto& string : strings) {
+        result.add(string.second);
+    }
+    return result;
 }
 
-//! Register the callbacks for computing the size of feature data gatherers.
-void registerMemoryCallbacks() {
-    static std::atomic_flag once = ATOMIC_FLAG_INIT;
-    if (once.test_and_set() == false) {
-        registerMemoryCallbacks(core::CMemory::anyVisitor());
-        registerMemoryCallbacks(core::CMemoryDebug::anyVisitor());
+//! Get a sketch of the unique strings \p words sized for their total
+//! length.
+CUniqueStringFeatureData::TSketch
+sketchOf(const CUniqueStringFeatureData::TWordSet& words,
+         const CUniqueStringFeatureData::TWordStringUMap& strings) {
+    std::size_t bytes{0};
+    for (const auto& word : words) {
+        bytes += strings.at(word).size();
     }
+    CUniqueStringFeatureData::TSketch result{CUniqueStringFeatureData::TSketch::sizeFor(bytes)};
+    for (const auto& word : words) {
+        result.add(strings.at(word));
+    }
+    return result;
+}
+
+//! Check if \p sketch needs more bits to add \p value.
+bool tooSmall(const CUniqueStringFeatureData::TSketch& sketch, const std::string& value) {
+    return CUniqueStringFeatureData::TSketch::sizeFor(sketch.bytes() + value.size()) >
+           sketch.size();
 }
 
 } // unnamed::
@@ -728,7 +689,8 @@ CEventRateBucketGatherer::CEventRateBucketGatherer(CDataGatherer& dataGatherer,
                                                    const TStrVec& influenceFieldNames,
                                                    core_t::TTime startTime)
     : CBucketGatherer(dataGatherer, startTime), m_BeginInfluencingFields(0),
-      m_BeginValueField(0), m_BeginSummaryFields(0) {
+      m_BeginValueField(0), m_BeginSummaryFields(0), m_SketchInfoContent(false),
+      m_SortedBucketCountsValid(false) {
     this->initializeFieldNames(personFieldName, attributeFieldName, valueFieldName,
                                summaryCountFieldName, influenceFieldNames);
     this->initializeFeatureData();
@@ -742,7 +704,8 @@ CEventRateBucketGatherer::CEventRateBucketGatherer(CDataGatherer& dataGatherer,
                                                    const TStrVec& influenceFieldNames,
                                                    core::CStateRestoreTraverser& traverser)
     : CBucketGatherer(dataGatherer, 0), m_BeginInfluencingFields(0),
-      m_BeginValueField(0), m_BeginSummaryFields(0) {
+      m_BeginValueField(0), m_BeginSummaryFields(0), m_SketchInfoContent(false),
+      m_SortedBucketCountsValid(false) {
     this->initializeFieldNames(personFieldName, attributeFieldName, valueFieldName,
                                summaryCountFieldName, influenceFieldNames);
     traverser.traverseSubLevel(
@@ -755,7 +718,8 @@ CEventRateBucketGatherer::CEventRateBucketGatherer(bool isForPersistence,
       m_BeginInfluencingFields(other.m_BeginInfluencingFields),
       m_BeginValueField(other.m_BeginValueField),
       m_BeginSummaryFields(other.m_BeginSummaryFields),
-      m_FeatureData(other.m_FeatureData) {
+      m_FeatureData(other.m_FeatureData), m_SketchInfoContent(other.m_SketchInfoContent),
+      m_SortedBucketCountsValid(false) {
     if (!isForPersistence) {
         LOG_ABORT(<< "This constructor only creates clones for persistence");
     }
@@ -1000,18 +964,18 @@ uint64_t CEventRateBucketGatherer::checksum() const {
 }
 
 void CEventRateBucketGatherer::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
-    registerMemoryCallbacks();
     mem->setName("CPopulationEventRateDataGatherer");
     CBucketGatherer::debugMemoryUsage(mem->addChild());
     core::CMemoryDebug::dynamicSize("m_FieldNames", m_FieldNames, mem);
     core::CMemoryDebug::dynamicSize("m_FeatureData", m_FeatureData, mem);
+    core::CMemoryDebug::dynamicSize("m_SortedBucketCounts", m_SortedBucketCounts, mem);
 }
 
 std::size_t CEventRateBucketGatherer::memoryUsage() const {
-    registerMemoryCallbacks();
     std::size_t mem = CBucketGatherer::memoryUsage();
     mem += core::CMemory::dynamicSize(m_FieldNames);
     mem += core::CMemory::dynamicSize(m_FeatureData);
+    mem += core::CMemory::dynamicSize(m_SortedBucketCounts);
     return mem;
 }
 
@@ -1021,7 +985,7 @@ std::size_t CEventRateBucketGatherer::staticSize() const {
 
 void CEventRateBucketGatherer::clear() {
     this->CBucketGatherer::clear();
-    m_FeatureData.clear();
+    m_FeatureData = SCategoryData();
     this->initializeFeatureData();
 }
 
@@ -1038,261 +1002,254 @@ void CEventRateBucketGatherer::sample(core_t::TTime time) {
     this->CBucketGatherer::sample(time);
 }
 
-void CEventRateBucketGatherer::featureData(core_t::TTime time,
+bool CEventRateBucketGatherer::featureData(core_t::TTime time,
                                            core_t::TTime /*bucketLength*/,
-                                           TFeatureAnyPrVec& result) const {
-    result.clear();
-
+                                           TFeatureSizeEventRateFeatureDataPrVecPrVec& result) const {
     if (!this->dataAvailable(time) ||
         time >= this->currentBucketStartTime() + this->bucketLength()) {
         LOG_DEBUG(<< "No data available at " << time
                   << ", current bucket = " << this->printCurrentBucket());
-        return;
+        result.clear();
+        return true;
     }
 
-    for (std::size_t i = 0u, n = m_DataGatherer.numberFeatures(); i < n; ++i) {
+    m_SortedBucketCountsValid = false;
+
+    bool succeeded = true;
+    std::size_t n = 0u;
+    for (std::size_t i = 0u, m = m_DataGatherer.numberFeatures(); i < m; ++i) {
         const model_t::EFeature feature = m_DataGatherer.feature(i);
 
         switch (feature) {
         case model_t::E_IndividualCountByBucketAndPerson:
-            this->personCounts(feature, time, result);
+        case model_t::E_IndividualLowCountsByBucketAndPerson:
+        case model_t::E_IndividualHighCountsByBucketAndPerson:
+            this->personCounts(time, nextFeatureData(feature, n, result));
             break;
         case model_t::E_IndividualNonZeroCountByBucketAndPerson:
         case model_t::E_IndividualTotalBucketCountByPerson:
-            this->nonZeroPersonCounts(feature, time, result);
+        case model_t::E_IndividualLowNonZeroCountByBucketAndPerson:
+        case model_t::E_IndividualHighNonZeroCountByBucketAndPerson:
+            this->nonZeroPersonCounts(time, nextFeatureData(feature, n, result));
             break;
         case model_t::E_IndividualIndicatorOfBucketPerson:
-            this->personIndicator(feature, time, result);
-            break;
-        case model_t::E_IndividualLowCountsByBucketAndPerson:
-        case model_t::E_IndividualHighCountsByBucketAndPerson:
-            this->personCounts(feature, time, result);
+            this->personIndicator(time, nextFeatureData(feature, n, result));
             break;
         case model_t::E_IndividualArrivalTimesByPerson:
         case model_t::E_IndividualLongArrivalTimesByPerson:
         case model_t::E_IndividualShortArrivalTimesByPerson:
-            this->personArrivalTimes(feature, time, result);
-            break;
-        case model_t::E_IndividualLowNonZeroCountByBucketAndPerson:
-        case model_t::E_IndividualHighNonZeroCountByBucketAndPerson:
-            this->nonZeroPersonCounts(feature, time, result);
+            // TODO
+            nextFeatureData(feature, n, result);
             break;
         case model_t::E_IndividualUniqueCountByBucketAndPerson:
         case model_t::E_IndividualLowUniqueCountByBucketAndPerson:
         case model_t::E_IndividualHighUniqueCountByBucketAndPerson:
-            this->bucketUniqueValuesPerPerson(feature, time, result);
+            this->bucketUniqueValuesPerPerson(time, nextFeatureData(feature, n, result));
             break;
         case model_t::E_IndividualInfoContentByBucketAndPerson:
         case model_t::E_IndividualHighInfoContentByBucketAndPerson:
         case model_t::E_IndividualLowInfoContentByBucketAndPerson:
-            this->bucketCompressedLengthPerPerson(feature, time, result);
+            this->bucketCompressedLengthPerPerson(time, nextFeatureData(feature, n, result));
             break;
         case model_t::E_IndividualTimeOfDayByBucketAndPerson:
         case model_t::E_IndividualTimeOfWeekByBucketAndPerson:
-            this->bucketMeanTimesPerPerson(feature, time, result);
+            this->bucketMeanTimesPerPerson(time, nextFeatureData(feature, n, result));
             break;
 
         CASE_INDIVIDUAL_METRIC:
+        CASE_POPULATION_METRIC:
+        CASE_PEERS_METRIC:
             LOG_ERROR(<< "Unexpected feature = " << model_t::print(feature));
             break;
 
-        case model_t::E_PopulationAttributeTotalCountByPerson:
-        case model_t::E_PopulationCountByBucketPersonAndAttribute:
-            this->nonZeroAttributeCounts(feature, time, result);
+        CASE_POPULATION_COUNT:
+        CASE_PEERS_COUNT:
+            LOG_ERROR(<< "Bad type for feature = " << model_t::print(feature));
+            succeeded = false;
             break;
-        case model_t::E_PopulationIndicatorOfBucketPersonAndAttribute:
-            this->attributeIndicator(feature, time, result);
-            break;
-        case model_t::E_PopulationUniquePersonCountByAttribute:
-            this->peoplePerAttribute(feature, result);
-            break;
-        case model_t::E_PopulationUniqueCountByBucketPersonAndAttribute:
-        case model_t::E_PopulationLowUniqueCountByBucketPersonAndAttribute:
-        case model_t::E_PopulationHighUniqueCountByBucketPersonAndAttribute:
-            this->bucketUniqueValuesPerPersonAttribute(feature, time, result);
-            break;
-        case model_t::E_PopulationLowCountsByBucketPersonAndAttribute:
-        case model_t::E_PopulationHighCountsByBucketPersonAndAttribute:
-            this->nonZeroAttributeCounts(feature, time, result);
-            break;
-        case model_t::E_PopulationInfoContentByBucketPersonAndAttribute:
-        case model_t::E_PopulationLowInfoContentByBucketPersonAndAttribute:
-        case model_t::E_PopulationHighInfoContentByBucketPersonAndAttribute:
-            this->bucketCompressedLengthPerPersonAttribute(feature, time, result);
-            break;
-        case model_t::E_PopulationTimeOfDayByBucketPersonAndAttribute:
-        case model_t::E_PopulationTimeOfWeekByBucketPersonAndAttribute:
-            this->bucketMeanTimesPerPersonAttribute(feature, time, result);
+        }
+    }
+    result.resize(n);
+
+    return succeeded;
+}
+
+bool CEventRateBucketGatherer::featureData(core_t::TTime time,
+                                           core_t::TTime /*bucketLength*/,
+                                           TFeatureSizeSizePrEventRateFeatureDataPrVecPrVec& result) const {
+    if (!this->dataAvailable(time) ||
+        time >= this->currentBucketStartTime() + this->bucketLength()) {
+        LOG_DEBUG(<< "No data available at " << time
+                  << ", current bucket = " << this->printCurrentBucket());
+        result.clear();
+        return true;
+    }
+
+    m_SortedBucketCountsValid = false;
+
+    bool succeeded = true;
+    std::size_t n = 0u;
+    for (std::size_t i = 0u, m = m_DataGatherer.numberFeatures(); i < m; ++i) {
+        const model_t::EFeature feature = m_DataGatherer.feature(i);
+
+        switch (feature) {
+        CASE_INDIVIDUAL_COUNT:
+            LOG_ERROR(<< "Bad type for feature = " << model_t::print(feature));
+            succeeded = false;
             break;
 
+        CASE_INDIVIDUAL_METRIC:
         CASE_POPULATION_METRIC:
+        CASE_PEERS_METRIC:
             LOG_ERROR(<< "Unexpected feature = " << model_t::print(feature));
             break;
 
+        case model_t::E_PopulationAttributeTotalCountByPerson:
+        case model_t::E_PopulationCountByBucketPersonAndAttribute:
+        case model_t::E_PopulationLowCountsByBucketPersonAndAttribute:
+        case model_t::E_PopulationHighCountsByBucketPersonAndAttribute:
         case model_t::E_PeersAttributeTotalCountByPerson:
         case model_t::E_PeersCountByBucketPersonAndAttribute:
-            this->nonZeroAttributeCounts(feature, time, result);
+        case model_t::E_PeersLowCountsByBucketPersonAndAttribute:
+        case model_t::E_PeersHighCountsByBucketPersonAndAttribute:
+            this->nonZeroAttributeCounts(time, nextFeatureData(feature, n, result));
+            break;
+        case model_t::E_PopulationIndicatorOfBucketPersonAndAttribute:
+            this->attributeIndicator(time, nextFeatureData(feature, n, result));
+            break;
+        case model_t::E_PopulationUniquePersonCountByAttribute:
+            this->peoplePerAttribute(nextFeatureData(feature, n, result));
             break;
+        case model_t::E_PopulationUniqueCountByBucketPersonAndAttribute:
+        case model_t::E_PopulationLowUniqueCountByBucketPersonAndAttribute:
+        case model_t::E_PopulationHighUniqueCountByBucketPersonAndAttribute:
         case model_t::E_PeersUniqueCountByBucketPersonAndAttribute:
         case model_t::E_PeersLowUniqueCountByBucketPersonAndAttribute:
         case model_t::E_PeersHighUniqueCountByBucketPersonAndAttribute:
-            this->bucketUniqueValuesPerPersonAttribute(feature, time, result);
-            break;
-        case model_t::E_PeersLowCountsByBucketPersonAndAttribute:
-        case model_t::E_PeersHighCountsByBucketPersonAndAttribute:
-            this->nonZeroAttributeCounts(feature, time, result);
+            this->bucketUniqueValuesPerPersonAttribute(time, nextFeatureData(feature, n, result));
             break;
+        case model_t::E_PopulationInfoContentByBucketPersonAndAttribute:
+        case model_t::E_PopulationLowInfoContentByBucketPersonAndAttribute:
+        case model_t::E_PopulationHighInfoContentByBucketPersonAndAttribute:
         case model_t::E_PeersInfoContentByBucketPersonAndAttribute:
         case model_t::E_PeersLowInfoContentByBucketPersonAndAttribute:
         case model_t::E_PeersHighInfoContentByBucketPersonAndAttribute:
-            this->bucketCompressedLengthPerPersonAttribute(feature, time, result);
+            this->bucketCompressedLengthPerPersonAttribute(
+                time, nextFeatureData(feature, n, result));
             break;
+        case model_t::E_PopulationTimeOfDayByBucketPersonAndAttribute:
+        case model_t::E_PopulationTimeOfWeekByBucketPersonAndAttribute:
         case model_t::E_PeersTimeOfDayByBucketPersonAndAttribute:
         case model_t::E_PeersTimeOfWeekByBucketPersonAndAttribute:
-            this->bucketMeanTimesPerPersonAttribute(feature, time, result);
-            break;
-
-        CASE_PEERS_METRIC:
-            LOG_ERROR(<< "Unexpected feature = " << model_t::print(feature));
+            this->bucketMeanTimesPerPersonAttribute(time, nextFeatureData(feature, n, result));
             break;
         }
     }
+    result.resize(n);
+
+    return succeeded;
+}
+
+const CEventRateBucketGatherer::TSizeSizePrUInt64PrVec&
+CEventRateBucketGatherer::sortedBucketCounts(core_t::TTime time) const {
+    if (m_SortedBucketCountsValid == false) {
+        const TSizeSizePrUInt64UMap& counts = this->bucketCounts(time);
+        m_SortedBucketCounts.assign(counts.begin(), counts.end());
+        std::sort(m_SortedBucketCounts.begin(), m_SortedBucketCounts.end(),
+                  maths::COrderings::SFirstLess());
+        m_SortedBucketCountsValid = true;
+    }
+    return m_SortedBucketCounts;
 }
 
-void CEventRateBucketGatherer::personCounts(model_t::EFeature feature,
-                                            core_t::TTime time,
-                                            TFeatureAnyPrVec& result_) const {
+void CEventRateBucketGatherer::personCounts(core_t::TTime time,
+                                            TSizeFeatureDataPrVec& result) const {
     if (m_DataGatherer.isPopulation()) {
         LOG_ERROR(<< "Function does not support population analysis.");
         return;
     }
 
-    result_.emplace_back(feature, TSizeFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeFeatureDataPrVec>(&result_.back().second);
     result.reserve(m_DataGatherer.numberActivePeople());
 
+    // The counts are sorted by person so we can merge them in one pass.
+    const TSizeSizePrUInt64PrVec& counts = this->sortedBucketCounts(time);
+    auto count = counts.begin();
     for (std::size_t pid = 0u, n = m_DataGatherer.numberPeople(); pid < n; ++pid) {
         if (!m_DataGatherer.isPersonActive(pid) ||
             this->hasExplicitNullsOnly(time, pid, model_t::INDIVIDUAL_ANALYSIS_ATTRIBUTE_ID)) {
             continue;
         }
-        result.emplace_back(pid, 0);
-    }
-
-    for (const auto& count_ : this->bucketCounts(time)) {
-        uint64_t& count = std::lower_bound(result.begin(), result.end(),
-                                           CDataGatherer::extractPersonId(count_),
-                                           maths::COrderings::SFirstLess())
-                              ->second.s_Count;
-        count += CDataGatherer::extractData(count_);
+        uint64_t total = 0;
+        for (/**/; count != counts.end() && CDataGatherer::extractPersonId(*count) < pid; ++count) {
+        }
+        for (/**/; count != counts.end() && CDataGatherer::extractPersonId(*count) == pid; ++count) {
+            total += CDataGatherer::extractData(*count);
+        }
+        result.emplace_back(pid, total);
     }
 
     this->addInfluencerCounts(time, result);
 }
 
-void CEventRateBucketGatherer::nonZeroPersonCounts(model_t::EFeature feature,
-                                                   core_t::TTime time,
-                                                   TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeFeatureDataPrVec>(&result_.back().second);
-
-    const TSizeSizePrUInt64UMap& personAttributeCounts = this->bucketCounts(time);
-    result.reserve(personAttributeCounts.size());
-    for (const auto& count : personAttributeCounts) {
+void CEventRateBucketGatherer::nonZeroPersonCounts(core_t::TTime time,
+                                                   TSizeFeatureDataPrVec& result) const {
+    const TSizeSizePrUInt64PrVec& counts = this->sortedBucketCounts(time);
+    result.reserve(counts.size());
+    for (const auto& count : counts) {
         result.emplace_back(CDataGatherer::extractPersonId(count),
                             CDataGatherer::extractData(count));
     }
-    std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
 
     this->addInfluencerCounts(time, result);
 }
 
-void CEventRateBucketGatherer::personIndicator(model_t::EFeature feature,
-                                               core_t::TTime time,
-                                               TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeFeatureDataPrVec>(&result_.back().second);
-
-    const TSizeSizePrUInt64UMap& personAttributeCounts = this->bucketCounts(time);
-    result.reserve(personAttributeCounts.size());
-    for (const auto& count : personAttributeCounts) {
+void CEventRateBucketGatherer::personIndicator(core_t::TTime time,
+                                               TSizeFeatureDataPrVec& result) const {
+    const TSizeSizePrUInt64PrVec& counts = this->sortedBucketCounts(time);
+    result.reserve(counts.size());
+    for (const auto& count : counts) {
         result.emplace_back(CDataGatherer::extractPersonId(count), 1);
     }
-    std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
 
     this->addInfluencerCounts(time, result);
 }
 
-void CEventRateBucketGatherer::personArrivalTimes(model_t::EFeature feature,
-                                                  core_t::TTime /*time*/,
-                                                  TFeatureAnyPrVec& result_) const {
-    // TODO
-    result_.emplace_back(feature, TSizeFeatureDataPrVec());
-}
-
-void CEventRateBucketGatherer::nonZeroAttributeCounts(model_t::EFeature feature,
-                                                      core_t::TTime time,
-                                                      TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeSizePrFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeSizePrFeatureDataPrVec>(&result_.back().second);
-
-    const TSizeSizePrUInt64UMap& personAttributeCounts = this->bucketCounts(time);
-    result.reserve(personAttributeCounts.size());
-    for (const auto& count : personAttributeCounts) {
+void CEventRateBucketGatherer::nonZeroAttributeCounts(core_t::TTime time,
+                                                      TSizeSizePrFeatureDataPrVec& result) const {
+    const TSizeSizePrUInt64PrVec& counts = this->sortedBucketCounts(time);
+    result.reserve(counts.size());
+    for (const auto& count : counts) {
         if (CDataGatherer::extractData(count) > 0) {
             result.emplace_back(count.first, CDataGatherer::extractData(count));
         }
     }
-    std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
 
     this->addInfluencerCounts(time, result);
 }
 
-void CEventRateBucketGatherer::peoplePerAttribute(model_t::EFeature feature,
-                                                  TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeSizePrFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeSizePrFeatureDataPrVec>(&result_.back().second);
-
-    auto i = m_FeatureData.find(model_t::E_AttributePeople);
-    if (i == m_FeatureData.end()) {
+void CEventRateBucketGatherer::peoplePerAttribute(TSizeSizePrFeatureDataPrVec& result) const {
+    if (!m_FeatureData.s_AttributePeople) {
         return;
     }
 
-    try {
-        const TSizeUSetVec& attributePeople = boost::any_cast<const TSizeUSetVec&>(i->second);
-        result.reserve(attributePeople.size());
-        for (std::size_t cid = 0u; cid < attributePeople.size(); ++cid) {
-            if (m_DataGatherer.isAttributeActive(cid)) {
-                result.emplace_back(TSizeSizePr(0, cid), attributePeople[cid].size());
-            }
+    const TSizeUSetVec& attributePeople = *m_FeatureData.s_AttributePeople;
+    result.reserve(attributePeople.size());
+    for (std::size_t cid = 0u; cid < attributePeople.size(); ++cid) {
+        if (m_DataGatherer.isAttributeActive(cid)) {
+            result.emplace_back(TSizeSizePr(0, cid), attributePeople[cid].size());
         }
-    } catch (const std::exception& e) {
-        LOG_ERROR(<< "Failed to extract "
-                  << model_t::print(model_t::E_PopulationUniquePersonCountByAttribute)
-                  << ": " << e.what());
     }
 }
 
-void CEventRateBucketGatherer::attributeIndicator(model_t::EFeature feature,
-                                                  core_t::TTime time,
-                                                  TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeSizePrFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeSizePrFeatureDataPrVec>(&result_.back().second);
-
-    const TSizeSizePrUInt64UMap& counts = this->bucketCounts(time);
+void CEventRateBucketGatherer::attributeIndicator(core_t::TTime time,
+                                                  TSizeSizePrFeatureDataPrVec& result) const {
+    const TSizeSizePrUInt64PrVec& counts = this->sortedBucketCounts(time);
     result.reserve(counts.size());
     for (const auto& count : counts) {
         if (CDataGatherer::extractData(count) > 0) {
             result.emplace_back(count.first, 1);
         }
     }
-    std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
 
     this->addInfluencerCounts(time, result);
     for (std::size_t i = 0u; i < result.size(); ++i) {
@@ -1305,206 +1262,129 @@ void CEventRateBucketGatherer::attributeIndicator(model_t::EFeature feature,
     }
 }
 
-void CEventRateBucketGatherer::bucketUniqueValuesPerPerson(model_t::EFeature feature,
-                                                           core_t::TTime time,
-                                                           TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeFeatureDataPrVec>(&result_.back().second);
-
-    auto i = m_FeatureData.find(model_t::E_UniqueValues);
-    if (i == m_FeatureData.end()) {
+void CEventRateBucketGatherer::bucketUniqueValuesPerPerson(core_t::TTime time,
+                                                           TSizeFeatureDataPrVec& result) const {
+    if (!m_FeatureData.s_UniqueValues) {
         return;
     }
 
-    try {
-        const auto& personAttributeUniqueValues =
-            boost::any_cast<const TSizeSizePrStrDataUMapQueue&>(i->second).get(time);
-        result.reserve(personAttributeUniqueValues.size());
-        for (const auto& uniques : personAttributeUniqueValues) {
-            result.emplace_back(CDataGatherer::extractPersonId(uniques), 0);
-            CDataGatherer::extractData(uniques).populateDistinctCountFeatureData(
-                result.back().second);
-        }
-        std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
-    } catch (const std::exception& e) {
-        LOG_ERROR(<< "Failed to extract "
-                  << model_t::print(model_t::E_IndividualUniqueCountByBucketAndPerson)
-                  << ": " << e.what());
+    const auto& personAttributeUniqueValues = m_FeatureData.s_UniqueValues->get(time);
+    result.reserve(personAttributeUniqueValues.size());
+    for (const auto& uniques : personAttributeUniqueValues) {
+        result.emplace_back(CDataGatherer::extractPersonId(uniques), 0);
+        CDataGatherer::extractData(uniques).populateDistinctCountFeatureData(
+            result.back().second);
     }
+    std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
 }
 
-void CEventRateBucketGatherer::bucketUniqueValuesPerPersonAttribute(model_t::EFeature feature,
-                                                                    core_t::TTime time,
-                                                                    TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeSizePrFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeSizePrFeatureDataPrVec>(&result_.back().second);
-
-    auto i = m_FeatureData.find(model_t::E_UniqueValues);
-    if (i == m_FeatureData.end()) {
+void CEventRateBucketGatherer::bucketUniqueValuesPerPersonAttribute(
+    core_t::TTime time,
+    TSizeSizePrFeatureDataPrVec& result) const {
+    if (!m_FeatureData.s_UniqueValues) {
         return;
     }
 
-    try {
-        const auto& personAttributeUniqueValues =
-            boost::any_cast<const TSizeSizePrStrDataUMapQueue&>(i->second).get(time);
-        result.reserve(personAttributeUniqueValues.size());
-        for (const auto& uniques : personAttributeUniqueValues) {
-            result.emplace_back(uniques.first, 0);
-            CDataGatherer::extractData(uniques).populateDistinctCountFeatureData(
-                result.back().second);
-        }
-        std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
-    } catch (const std::exception& e) {
-        LOG_ERROR(<< "Failed to extract "
-                  << model_t::print(model_t::E_PopulationUniqueCountByBucketPersonAndAttribute)
-                  << ": " << e.what());
+    const auto& personAttributeUniqueValues = m_FeatureData.s_UniqueValues->get(time);
+    result.reserve(personAttributeUniqueValues.size());
+    for (const auto& uniques : personAttributeUniqueValues) {
+        result.emplace_back(uniques.first, 0);
+        CDataGatherer::extractData(uniques).populateDistinctCountFeatureData(
+            result.back().second);
     }
+    std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
 }
 
-void CEventRateBucketGatherer::bucketCompressedLengthPerPerson(model_t::EFeature feature,
-                                                               core_t::TTime time,
-                                                               TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeFeatureDataPrVec>(&result_.back().second);
-
-    auto i = m_FeatureData.find(model_t::E_UniqueValues);
-    if (i == m_FeatureData.end()) {
+void CEventRateBucketGatherer::bucketCompressedLengthPerPerson(core_t::TTime time,
+                                                               TSizeFeatureDataPrVec& result) const {
+    if (!m_FeatureData.s_UniqueValues) {
         return;
     }
 
-    try {
-        const auto& personAttributeUniqueValues =
-            boost::any_cast<const TSizeSizePrStrDataUMapQueue&>(i->second).get(time);
-        result.reserve(personAttributeUniqueValues.size());
-        for (const auto& uniques : personAttributeUniqueValues) {
-            result.emplace_back(CDataGatherer::extractPersonId(uniques), 0);
-            CDataGatherer::extractData(uniques).populateInfoContentFeatureData(
-                result.back().second);
-        }
-        std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
-    } catch (const std::exception& e) {
-        LOG_ERROR(<< "Failed to extract "
-                  << model_t::print(model_t::E_IndividualInfoContentByBucketAndPerson)
-                  << ": " << e.what());
+    const auto& personAttributeUniqueValues = m_FeatureData.s_UniqueValues->get(time);
+    result.reserve(personAttributeUniqueValues.size());
+    for (const auto& uniques : personAttributeUniqueValues) {
+        result.emplace_back(CDataGatherer::extractPersonId(uniques), 0);
+        CDataGatherer::extractData(uniques).populateInfoContentFeatureData(
+            result.back().second, m_DataGatherer.params().s_InfoContentEstimator);
     }
+    std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
 }
 
 void CEventRateBucketGatherer::bucketCompressedLengthPerPersonAttribute(
-    model_t::EFeature feature,
     core_t::TTime time,
-    TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeSizePrFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeSizePrFeatureDataPrVec>(&result_.back().second);
-
-    auto i = m_FeatureData.find(model_t::E_UniqueValues);
-    if (i == m_FeatureData.end()) {
+    TSizeSizePrFeatureDataPrVec& result) const {
+    if (!m_FeatureData.s_UniqueValues) {
         return;
     }
 
-    try {
-        const auto& personAttributeUniqueValues =
-            boost::any_cast<const TSizeSizePrStrDataUMapQueue&>(i->second).get(time);
-        result.reserve(personAttributeUniqueValues.size());
-        for (const auto& uniques : personAttributeUniqueValues) {
-            result.emplace_back(uniques.first, 0);
-            CDataGatherer::extractData(uniques).populateInfoContentFeatureData(
-                result.back().second);
-        }
-        std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
-    } catch (const std::exception& e) {
-        LOG_ERROR(<< "Failed to extract "
-                  << model_t::print(model_t::E_PopulationInfoContentByBucketPersonAndAttribute)
-                  << ": " << e.what());
+    const auto& personAttributeUniqueValues = m_FeatureData.s_UniqueValues->get(time);
+    result.reserve(personAttributeUniqueValues.size());
+    for (const auto& uniques : personAttributeUniqueValues) {
+        result.emplace_back(uniques.first, 0);
+        CDataGatherer::extractData(uniques).populateInfoContentFeatureData(
+            result.back().second, m_DataGatherer.params().s_InfoContentEstimator);
     }
+    std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
 }
 
-void CEventRateBucketGatherer::bucketMeanTimesPerPerson(model_t::EFeature feature,
-                                                        core_t::TTime time,
-                                                        TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeFeatureDataPrVec>(&result_.back().second);
-
-    auto i = m_FeatureData.find(model_t::E_DiurnalTimes);
-    if (i == m_FeatureData.end()) {
+void CEventRateBucketGatherer::bucketMeanTimesPerPerson(core_t::TTime time,
+                                                        TSizeFeatureDataPrVec& result) const {
+    if (!m_FeatureData.s_DiurnalTimes) {
         return;
     }
 
-    try {
-        const auto& arrivalTimes =
-            boost::any_cast<const TSizeSizePrMeanAccumulatorUMapQueue&>(i->second)
-                .get(time);
-        result.reserve(arrivalTimes.size());
-        for (const auto& time_ : arrivalTimes) {
-            result.emplace_back(CDataGatherer::extractPersonId(time_),
-                                static_cast<uint64_t>(maths::CBasicStatistics::mean(
-                                    CDataGatherer::extractData(time_))));
-        }
-        std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
-
-        // We don't bother to gather the influencer bucket means
-        // so the best we can do is use the person and attribute
-        // bucket mean.
-        this->addInfluencerCounts(time, result);
-        for (std::size_t j = 0u; j < result.size(); ++j) {
-            SEventRateFeatureData& data = result[j].second;
-            for (std::size_t k = 0u; k < data.s_InfluenceValues.size(); ++k) {
-                for (std::size_t l = 0u; l < data.s_InfluenceValues[k].size(); ++l) {
-                    data.s_InfluenceValues[k][l].second.first =
-                        TDouble1Vec{static_cast<double>(data.s_Count)};
-                }
+    const auto& arrivalTimes = m_FeatureData.s_DiurnalTimes->get(time);
+    result.reserve(arrivalTimes.size());
+    for (const auto& time_ : arrivalTimes) {
+        result.emplace_back(CDataGatherer::extractPersonId(time_),
+                            static_cast<uint64_t>(maths::CBasicStatistics::mean(
+                                CDataGatherer::extractData(time_))));
+    }
+    std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
+
+    // We don't bother to gather the influencer bucket means
+    // so the best we can do is use the person and attribute
+    // bucket mean.
+    this->addInfluencerCounts(time, result);
+    for (std::size_t j = 0u; j < result.size(); ++j) {
+        SEventRateFeatureData& data = result[j].second;
+        for (std::size_t k = 0u; k < data.s_InfluenceValues.size(); ++k) {
+            for (std::size_t l = 0u; l < data.s_InfluenceValues[k].size(); ++l) {
+                data.s_InfluenceValues[k][l].second.first =
+                    TDouble1Vec{static_cast<double>(data.s_Count)};
             }
         }
-    } catch (const std::exception& e) {
-        LOG_ERROR(<< "Failed to extract "
-                  << model_t::print(model_t::E_DiurnalTimes) << ": " << e.what());
     }
 }
 
-void CEventRateBucketGatherer::bucketMeanTimesPerPersonAttribute(model_t::EFeature feature,
-                                                                 core_t::TTime time,
-                                                                 TFeatureAnyPrVec& result_) const {
-    result_.emplace_back(feature, TSizeSizePrFeatureDataPrVec());
-    auto& result =
-        *boost::unsafe_any_cast<TSizeSizePrFeatureDataPrVec>(&result_.back().second);
-
-    auto i = m_FeatureData.find(model_t::E_DiurnalTimes);
-    if (i == m_FeatureData.end()) {
+void CEventRateBucketGatherer::bucketMeanTimesPerPersonAttribute(core_t::TTime time,
+                                                                 TSizeSizePrFeatureDataPrVec& result) const {
+    if (!m_FeatureData.s_DiurnalTimes) {
         return;
     }
 
-    try {
-        const auto& arrivalTimes =
-            boost::any_cast<const TSizeSizePrMeanAccumulatorUMapQueue&>(i->second)
-                .get(time);
-        result.reserve(arrivalTimes.size());
-        for (const auto& time_ : arrivalTimes) {
-            result.emplace_back(time_.first,
-                                static_cast<uint64_t>(maths::CBasicStatistics::mean(
-                                    CDataGatherer::extractData(time_))));
-        }
-        std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
-
-        // We don't bother to gather the influencer bucket means
-        // so the best we can do is use the person and attribute
-        // bucket mean.
-        this->addInfluencerCounts(time, result);
-        for (std::size_t j = 0u; j < result.size(); ++j) {
-            SEventRateFeatureData& data = result[j].second;
-            for (std::size_t k = 0u; k < data.s_InfluenceValues.size(); ++k) {
-                for (std::size_t l = 0u; l < data.s_InfluenceValues[k].size(); ++l) {
-                    data.s_InfluenceValues[k][l].second.first =
-                        TDouble1Vec{static_cast<double>(data.s_Count)};
-                }
+    const auto& arrivalTimes = m_FeatureData.s_DiurnalTimes->get(time);
+    result.reserve(arrivalTimes.size());
+    for (const auto& time_ : arrivalTimes) {
+        result.emplace_back(time_.first,
+                            static_cast<uint64_t>(maths::CBasicStatistics::mean(
+                                CDataGatherer::extractData(time_))));
+    }
+    std::sort(result.begin(), result.end(), maths::COrderings::SFirstLess());
+
+    // We don't bother to gather the influencer bucket means
+    // so the best we can do is use the person and attribute
+    // bucket mean.
+    this->addInfluencerCounts(time, result);
+    for (std::size_t j = 0u; j < result.size(); ++j) {
+        SEventRateFeatureData& data = result[j].second;
+        for (std::size_t k = 0u; k < data.s_InfluenceValues.size(); ++k) {
+            for (std::size_t l = 0u; l < data.s_InfluenceValues[k].size(); ++l) {
+                data.s_InfluenceValues[k][l].second.first =
+                    TDouble1Vec{static_cast<double>(data.s_Count)};
             }
         }
-    } catch (const std::exception& e) {
-        LOG_ERROR(<< "Failed to extract "
-                  << model_t::print(model_t::E_DiurnalTimes) << ": " << e.what());
     }
 }
 
@@ -1522,7 +1402,8 @@ void CEventRateBucketGatherer::addValue(std::size_t pid,
     // Check that we are correctly sized - a person/attribute might have been added
     this->resize(pid, cid);
     apply(m_FeatureData,
-          boost::bind<void>(SAddValue(), _1, pid, cid, time, count, boost::cref(values),
+          boost::bind<void>(SAddValue(m_SketchInfoContent), _1, pid, cid, time,
+                            count, boost::cref(values),
                             boost::cref(stringValue), boost::cref(influences)));
 }
 
@@ -1563,6 +1444,7 @@ void CEventRateBucketGatherer::initializeFieldNames(const std::string& personFie
 }
 
 void CEventRateBucketGatherer::initializeFeatureData() {
+    m_SketchInfoContent = false;
     for (std::size_t i = 0u, n = m_DataGatherer.numberFeatures(); i < n; ++i) {
         switch (m_DataGatherer.feature(i)) {
         case model_t::E_IndividualCountByBucketAndPerson:
@@ -1580,7 +1462,7 @@ void CEventRateBucketGatherer::initializeFeatureData() {
             break;
         case model_t::E_IndividualTimeOfDayByBucketAndPerson:
         case model_t::E_IndividualTimeOfWeekByBucketAndPerson:
-            m_FeatureData[model_t::E_DiurnalTimes] = TSizeSizePrMeanAccumulatorUMapQueue(
+            m_FeatureData.s_DiurnalTimes = TSizeSizePrMeanAccumulatorUMapQueue(
                 m_DataGatherer.params().s_LatencyBuckets, this->bucketLength(),
                 this->currentBucketStartTime());
             break;
@@ -1592,10 +1474,16 @@ void CEventRateBucketGatherer::initializeFeatureData() {
         case model_t::E_IndividualUniqueCountByBucketAndPerson:
         case model_t::E_IndividualLowUniqueCountByBucketAndPerson:
         case model_t::E_IndividualHighUniqueCountByBucketAndPerson:
+            m_FeatureData.s_UniqueValues = TSizeSizePrStrDataUMapQueue(
+                m_DataGatherer.params().s_LatencyBuckets, this->bucketLength(),
+                this->currentBucketStartTime(), TSizeSizePrStrDataUMap(1));
+            break;
         case model_t::E_IndividualInfoContentByBucketAndPerson:
         case model_t::E_IndividualHighInfoContentByBucketAndPerson:
         case model_t::E_IndividualLowInfoContentByBucketAndPerson:
-            m_FeatureData[model_t::E_UniqueValues] = TSizeSizePrStrDataUMapQueue(
+            m_SketchInfoContent = m_DataGatherer.params().s_InfoContentEstimator ==
+                                  model_t::E_InfoContentSketch;
+            m_FeatureData.s_UniqueValues = TSizeSizePrStrDataUMapQueue(
                 m_DataGatherer.params().s_LatencyBuckets, this->bucketLength(),
                 this->currentBucketStartTime(), TSizeSizePrStrDataUMap(1));
             break;
@@ -1608,21 +1496,27 @@ void CEventRateBucketGatherer::initializeFeatureData() {
             // We always gather person attribute counts.
             break;
         case model_t::E_PopulationUniquePersonCountByAttribute:
-            m_FeatureData[model_t::E_AttributePeople] = TSizeUSetVec();
+            m_FeatureData.s_AttributePeople = TSizeUSetVec();
             break;
         case model_t::E_PopulationUniqueCountByBucketPersonAndAttribute:
         case model_t::E_PopulationLowUniqueCountByBucketPersonAndAttribute:
         case model_t::E_PopulationHighUniqueCountByBucketPersonAndAttribute:
+            m_FeatureData.s_UniqueValues = TSizeSizePrStrDataUMapQueue(
+                m_DataGatherer.params().s_LatencyBuckets, this->bucketLength(),
+                this->currentBucketStartTime(), TSizeSizePrStrDataUMap(1));
+            break;
         case model_t::E_PopulationInfoContentByBucketPersonAndAttribute:
         case model_t::E_PopulationLowInfoContentByBucketPersonAndAttribute:
         case model_t::E_PopulationHighInfoContentByBucketPersonAndAttribute:
-            m_FeatureData[model_t::E_UniqueValues] = TSizeSizePrStrDataUMapQueue(
+            m_SketchInfoContent = m_DataGatherer.params().s_InfoContentEstimator ==
+                                  model_t::E_InfoContentSketch;
+            m_FeatureData.s_UniqueValues = TSizeSizePrStrDataUMapQueue(
                 m_DataGatherer.params().s_LatencyBuckets, this->bucketLength(),
                 this->currentBucketStartTime(), TSizeSizePrStrDataUMap(1));
             break;
         case model_t::E_PopulationTimeOfDayByBucketPersonAndAttribute:
         case model_t::E_PopulationTimeOfWeekByBucketPersonAndAttribute:
-            m_FeatureData[model_t::E_DiurnalTimes] = TSizeSizePrMeanAccumulatorUMapQueue(
+            m_FeatureData.s_DiurnalTimes = TSizeSizePrMeanAccumulatorUMapQueue(
                 m_DataGatherer.params().s_LatencyBuckets, this->bucketLength(),
                 this->currentBucketStartTime());
             break;
@@ -1636,16 +1530,22 @@ void CEventRateBucketGatherer::initializeFeatureData() {
         case model_t::E_PeersUniqueCountByBucketPersonAndAttribute:
         case model_t::E_PeersLowUniqueCountByBucketPersonAndAttribute:
         case model_t::E_PeersHighUniqueCountByBucketPersonAndAttribute:
+            m_FeatureData.s_UniqueValues = TSizeSizePrStrDataUMapQueue(
+                m_DataGatherer.params().s_LatencyBuckets, this->bucketLength(),
+                this->currentBucketStartTime(), TSizeSizePrStrDataUMap(1));
+            break;
         case model_t::E_PeersInfoContentByBucketPersonAndAttribute:
         case model_t::E_PeersLowInfoContentByBucketPersonAndAttribute:
         case model_t::E_PeersHighInfoContentByBucketPersonAndAttribute:
-            m_FeatureData[model_t::E_UniqueValues] = TSizeSizePrStrDataUMapQueue(
+            m_SketchInfoContent = m_DataGatherer.params().s_InfoContentEstimator ==
+                                  model_t::E_InfoContentSketch;
+            m_FeatureData.s_UniqueValues = TSizeSizePrStrDataUMapQueue(
                 m_DataGatherer.params().s_LatencyBuckets, this->bucketLength(),
                 this->currentBucketStartTime(), TSizeSizePrStrDataUMap(1));
             break;
         case model_t::E_PeersTimeOfDayByBucketPersonAndAttribute:
         case model_t::E_PeersTimeOfWeekByBucketPersonAndAttribute:
-            m_FeatureData[model_t::E_DiurnalTimes] = TSizeSizePrMeanAccumulatorUMapQueue(
+            m_FeatureData.s_DiurnalTimes = TSizeSizePrMeanAccumulatorUMapQueue(
                 m_DataGatherer.params().s_LatencyBuckets, this->bucketLength(),
                 this->currentBucketStartTime());
             break;
@@ -1721,19 +1621,62 @@ void CEventRateBucketGatherer::addInfluencerCounts(core_t::TTime time,
     }
 }
 
+void CEventRateBucketGatherer::SCategoryData::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    mem->setName("SCategoryData");
+    core::CMemoryDebug::dynamicSize("s_AttributePeople", s_AttributePeople, mem);
+    core::CMemoryDebug::dynamicSize("s_UniqueValues", s_UniqueValues, mem);
+    core::CMemoryDebug::dynamicSize("s_DiurnalTimes", s_DiurnalTimes, mem);
+}
+
+std::size_t CEventRateBucketGatherer::SCategoryData::memoryUsage() const {
+    std::size_t mem = core::CMemory::dynamicSize(s_AttributePeople);
+    mem += core::CMemory::dynamicSize(s_UniqueValues);
+    mem += core::CMemory::dynamicSize(s_DiurnalTimes);
+    return mem;
+}
+
 ////// CUniqueStringFeatureData //////
 
 void CUniqueStringFeatureData::insert(const std::string& value,
-                                      const TStoredStringPtrVec& influences) {
+                                      const TStoredStringPtrVec& influences,
+                                      bool sketch) {
     TWord valueHash = m_Dictionary1.word(value);
-    m_UniqueStrings.emplace(valueHash, value);
+    bool added = m_UniqueStrings.emplace(valueHash, value).second;
+    if (sketch) {
+        // The sketch will be missing if we've just restored, in which
+        // case we recreate it from the unique strings. The sketches are
+        // sized for the total length of their strings, so they are small
+        // for the many series and influencer values with few distinct
+        // strings, and are recreated from the strings when that grows.
+        if (!m_Sketch || (added && tooSmall(*m_Sketch, value))) {
+            m_Sketch = sketchOf(m_UniqueStrings);
+        } else if (added) {
+            m_Sketch->add(value);
+        }
+    }
+
     if (influences.size() > m_InfluencerUniqueStrings.size()) {
         m_InfluencerUniqueStrings.resize(influences.size());
     }
+    if (sketch && m_InfluencerUniqueStrings.size() > m_InfluencerSketches.size()) {
+        m_InfluencerSketches.resize(m_InfluencerUniqueStrings.size());
+    }
     for (std::size_t i = 0; i < influences.size(); ++i) {
         // The influence strings are optional.
         if (influences[i]) {
-            m_InfluencerUniqueStrings[i][influences[i]].insert(valueHash);
+            TWordSet& words = m_InfluencerUniqueStrings[i][influences[i]];
+            added = words.insert(valueHash).second;
+            if (sketch) {
+                auto entry = m_InfluencerSketches[i].find(influences[i]);
+                if (entry == m_InfluencerSketches[i].end()) {
+                    m_InfluencerSketches[i].emplace(influences[i],
+                                                    sketchOf(words, m_UniqueStrings));
+                } else if (added && tooSmall(entry->second, value)) {
+                    entry->second = sketchOf(words, m_UniqueStrings);
+                } else if (added) {
+                    entry->second.add(value);
+                }
+            }
         }
     }
 }
@@ -1754,10 +1697,17 @@ void CUniqueStringFeatureData::populateDistinctCountFeatureData(SEventRateFeatur
     }
 }
 
-void CUniqueStringFeatureData::populateInfoContentFeatureData(SEventRateFeatureData& featureData) const {
+void CUniqueStringFeatureData::populateInfoContentFeatureData(SEventRateFeatureData& featureData,
+                                                              model_t::EInfoContentEstimator estimator) const {
     using TStrCRefVec = std::vector<TStrCRef>;
 
     featureData.s_InfluenceValues.clear();
+
+    if (estimator == model_t::E_InfoContentSketch) {
+        this->populateSketchInfoContentFeatureData(featureData);
+        return;
+    }
+
     core::CDeflator compressor(true);
 
     try {
@@ -1810,6 +1760,38 @@ void CUniqueStringFeatureData::populateInfoContentFeatureData(SEventRateFeatureD
     }
 }
 
+void CUniqueStringFeatureData::populateSketchInfoContentFeatureData(SEventRateFeatureData& featureData) const {
+    auto length = [](const TSketch& sketch) {
+        return static_cast<uint64_t>(sketch.length() + 0.5);
+    };
+
+    // The sketches are only missing if nothing has been added since they
+    // were restored, in which case we compute them on the fly. The result
+    // is the same since the sketch only depends on the strings it holds.
+
+    featureData.s_Count = m_Sketch ? length(*m_Sketch) : length(sketchOf(m_UniqueStrings));
+
+    static const TStoredStringPtrSketchUMap NO_SKETCHES;
+
+    featureData.s_InfluenceValues.resize(m_InfluencerUniqueStrings.size());
+    for (std::size_t i = 0u; i < m_InfluencerUniqueStrings.size(); ++i) {
+        const TStoredStringPtrSketchUMap& sketches =
+            i < m_InfluencerSketches.size() ? m_InfluencerSketches[i] : NO_SKETCHES;
+        TStrCRefDouble1VecDoublePrPrVec& data = featureData.s_InfluenceValues[i];
+        data.reserve(m_InfluencerUniqueStrings[i].size());
+        for (const auto& influence : m_InfluencerUniqueStrings[i]) {
+            auto sketch = sketches.find(influence.first);
+            uint64_t influenceLength =
+                sketch != sketches.end()
+                    ? length(sketch->second)
+                    : length(sketchOf(influence.second, m_UniqueStrings));
+            data.emplace_back(TStrCRef(*influence.first),
+                              TDouble1VecDoublePr(
+                                  TDouble1Vec{static_cast<double>(influenceLength)}, 1.0));
+        }
+    }
+}
+
 void CUniqueStringFeatureData::acceptPersistInserter(core::CStatePersistInserter& inserter) const {
     inserter.insertLevel(
         UNIQUE_STRINGS_TAG,
@@ -1849,12 +1831,16 @@ void CUniqueStringFeatureData::debugMemoryUsage(core::CMemoryUsage::TMemoryUsage
     core::CMemoryDebug::dynamicSize("s_NoInfluenceUniqueStrings", m_UniqueStrings, mem);
     core::CMemoryDebug::dynamicSize("s_InfluenceUniqueStrings",
                                     m_InfluencerUniqueStrings, mem);
+    core::CMemoryDebug::dynamicSize("m_Sketch", m_Sketch, mem);
+    core::CMemoryDebug::dynamicSize("m_InfluencerSketches", m_InfluencerSketches, mem);
 }
 
 std::size_t CUniqueStringFeatureData::memoryUsage() const {
     std::size_t mem = sizeof(*this);
     mem += core::CMemory::dynamicSize(m_UniqueStrings);
     mem += core::CMemory::dynamicSize(m_InfluencerUniqueStrings);
+    mem += core::CMemory::dynamicSize(m_Sketch);
+    mem += core::CMemory::dynamicSize(m_InfluencerSketches);
     return mem;
 }
 
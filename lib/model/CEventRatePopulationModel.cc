@@ -484,19 +484,23 @@ void CEventRatePopulationModel::sample(core_t::TTime startTime,
 }
 
 void CEventRatePopulationModel::prune(std::size_t maximumAge) {
-    CDataGatherer& gatherer = this->dataGatherer();
-
     TSizeVec peopleToRemove;
     TSizeVec attributesToRemove;
     this->peopleAndAttributesToRemove(m_CurrentBucketStats.s_StartTime, maximumAge,
                                       peopleToRemove, attributesToRemove);
+    std::sort(peopleToRemove.begin(), peopleToRemove.end());
+    std::sort(attributesToRemove.begin(), attributesToRemove.end());
+    this->prunePeopleAndAttributes(peopleToRemove, attributesToRemove);
+}
 
+void CEventRatePopulationModel::prunePeopleAndAttributes(const TSizeVec& peopleToRemove,
+                                                         const TSizeVec& attributesToRemove) {
     if (peopleToRemove.empty() && attributesToRemove.empty()) {
         return;
     }
 
-    std::sort(peopleToRemove.begin(), peopleToRemove.end());
-    std::sort(attributesToRemove.begin(), attributesToRemove.end());
+    CDataGatherer& gatherer = this->dataGatherer();
+
     LOG_DEBUG(<< "Removing people {" << this->printPeople(peopleToRemove, 20) << '}');
     LOG_DEBUG(<< "Removing attributes {"
               << this->printAttributes(attributesToRemove, 20) << '}');
@@ -326,6 +326,18 @@ SNode::SNode(const SResultSpec& simpleSearch, SAnnotatedProbability& annotatedPr
     s_AnnotatedProbability.swap(annotatedProbability);
 }
 
+void SNode::clear() {
+    TNodeCPtrVec children;
+    children.swap(s_Children);
+    children.clear();
+    SAnnotatedProbability::TStoredStringPtrStoredStringPtrPrDoublePrVec influences;
+    influences.swap(s_AnnotatedProbability.s_Influences);
+    influences.clear();
+    *this = SNode();
+    s_Children.swap(children);
+    s_AnnotatedProbability.s_Influences.swap(influences);
+}
+
 double SNode::probability() const {
     return s_AnnotatedProbability.s_Probability;
 }
@@ -488,6 +500,76 @@ void swap(SNode& node1, SNode& node2) {
     node1.swap(node2);
 }
 
+CNodeStore::CNodeStore() : m_Size(0) {
+}
+
+CNodeStore::iterator CNodeStore::begin() {
+    return m_Nodes.begin();
+}
+
+CNodeStore::iterator CNodeStore::end() {
+    return m_Nodes.begin() + m_Size;
+}
+
+CNodeStore::const_iterator CNodeStore::begin() const {
+    return m_Nodes.begin();
+}
+
+CNodeStore::const_iterator CNodeStore::end() const {
+    return m_Nodes.begin() + m_Size;
+}
+
+CNodeStore::const_reverse_iterator CNodeStore::rbegin() const {
+    return const_reverse_iterator(this->end());
+}
+
+CNodeStore::const_reverse_iterator CNodeStore::rend() const {
+    return const_reverse_iterator(this->begin());
+}
+
+bool CNodeStore::empty() const {
+    return m_Size == 0;
+}
+
+std::size_t CNodeStore::size() const {
+    return m_Size;
+}
+
+std::size_t CNodeStore::capacity() const {
+    return m_Nodes.size();
+}
+
+SNode& CNodeStore::operator[](std::size_t i) {
+    return m_Nodes[i];
+}
+
+const SNode& CNodeStore::front() const {
+    return m_Nodes.front();
+}
+
+const SNode& CNodeStore::back() const {
+    return m_Nodes[m_Size - 1];
+}
+
+SNode& CNodeStore::add() {
+    // Removed nodes have already been reset.
+    if (m_Size == m_Nodes.size()) {
+        m_Nodes.emplace_back();
+    }
+    return m_Nodes[m_Size++];
+}
+
+void CNodeStore::erase(iterator first) {
+    for (auto i = first; i != this->end(); ++i) {
+        i->clear();
+    }
+    m_Size = static_cast<std::size_t>(first - m_Nodes.begin());
+}
+
+void CNodeStore::clear() {
+    this->erase(this->begin());
+}
+
 } // hierarchical_results_detail::
 
 using namespace hierarchical_results_detail;
@@ -558,8 +640,7 @@ void CHierarchicalResults::addInfluencer(const std::string& name) {
 void CHierarchicalResults::buildHierarchy() {
     using TNodePtrVec = std::vector<SNode*>;
 
-    m_Nodes.erase(std::remove_if(m_Nodes.begin(), m_Nodes.end(), isAggregate),
-                  m_Nodes.end());
+    m_Nodes.erase(std::remove_if(m_Nodes.begin(), m_Nodes.end(), isAggregate));
 
     // To make life easier for downstream code, bring a simple count node
     // to the front of the deque (if there is one).
@@ -648,9 +729,9 @@ void CHierarchicalResults::createPivots() {
     }
 
     for (auto& pivot : m_PivotNodes) {
-        TNode& root = this->newPivotRoot(pivot.second.s_Spec.s_PersonFieldName);
-        root.s_Children.push_back(&pivot.second);
-        pivot.second.s_Parent = &root;
+        TNode& root = this->newPivotRoot(pivot.second->s_Spec.s_PersonFieldName);
+        root.s_Children.push_back(pivot.second);
+        pivot.second->s_Parent = &root;
     }
 }
 
@@ -672,7 +753,7 @@ const CHierarchicalResults::TNode*
 CHierarchicalResults::influencer(const TStoredStringPtr& influencerName,
                                  const TStoredStringPtr& influencerValue) const {
     auto i = m_PivotNodes.find({influencerName, influencerValue});
-    return i != m_PivotNodes.end() ? &i->second : nullptr;
+    return i != m_PivotNodes.end() ? i->second : nullptr;
 }
 
 void CHierarchicalResults::bottomUpBreadthFirst(CHierarchicalResultsVisitor& visitor) const {
@@ -695,19 +776,19 @@ void CHierarchicalResults::postorderDepthFirst(CHierarchicalResultsVisitor& visi
 
 void CHierarchicalResults::pivotsBottomUpBreadthFirst(CHierarchicalResultsVisitor& visitor) const {
     for (const auto& pivot : m_PivotNodes) {
-        visitor.visit(*this, pivot.second, /*pivot =*/true);
+        visitor.visit(*this, *pivot.second, /*pivot =*/true);
     }
     for (const auto& root : m_PivotRootNodes) {
-        visitor.visit(*this, root.second, /*pivot =*/true);
+        visitor.visit(*this, *root.second, /*pivot =*/true);
     }
 }
 
 void CHierarchicalResults::pivotsTopDownBreadthFirst(CHierarchicalResultsVisitor& visitor) const {
     for (const auto& root : m_PivotRootNodes) {
-        visitor.visit(*this, root.second, /*pivot =*/true);
+        visitor.visit(*this, *root.second, /*pivot =*/true);
     }
     for (const auto& pivot : m_PivotNodes) {
-        visitor.visit(*this, pivot.second, /*pivot =*/true);
+        visitor.visit(*this, *pivot.second, /*pivot =*/true);
     }
 }
 
@@ -729,17 +810,25 @@ void CHierarchicalResults::setInterim() {
     m_ResultType.set(model_t::CResultType::E_Interim);
 }
 
+void CHierarchicalResults::clear() {
+    m_Nodes.clear();
+    m_PivotNodes.clear();
+    m_PivotRootNodes.clear();
+    m_PivotNodeStore.clear();
+    m_ResultType = model_t::CResultType(model_t::CResultType::E_Final);
+}
+
 model_t::CResultType CHierarchicalResults::resultType() const {
     return m_ResultType;
 }
 
 void CHierarchicalResults::acceptPersistInserter(core::CStatePersistInserter& inserter) const {
-    using TStoredStringPtrNodeMapCItr = TStoredStringPtrNodeMap::const_iterator;
-    using TStoredStringPtrNodeMapCItrVec = std::vector<TStoredStringPtrNodeMapCItr>;
-    using TStoredStringPtrStoredStringPtrPrNodeMapCItr =
-        TStoredStringPtrStoredStringPtrPrNodeMap::const_iterator;
-    using TStoredStringPtrStoredStringPtrPrNodeMapCItrVec =
-        std::vector<TStoredStringPtrStoredStringPtrPrNodeMapCItr>;
+    using TStoredStringPtrNodePtrMapCItr = TStoredStringPtrNodePtrMap::const_iterator;
+    using TStoredStringPtrNodePtrMapCItrVec = std::vector<TStoredStringPtrNodePtrMapCItr>;
+    using TStoredStringPtrStoredStringPtrPrNodePtrMapCItr =
+        TStoredStringPtrStoredStringPtrPrNodePtrMap::const_iterator;
+    using TStoredStringPtrStoredStringPtrPrNodePtrMapCItrVec =
+        std::vector<TStoredStringPtrStoredStringPtrPrNodePtrMapCItr>;
 
     TNodePtrSizeUMap nodePointers;
 
@@ -750,7 +839,7 @@ void CHierarchicalResults::acceptPersistInserter(core::CStatePersistInserter& in
     }
 
     // Sort the keys by *value* order to ensure consistent persist state.
-    TStoredStringPtrStoredStringPtrPrNodeMapCItrVec pivotIterators;
+    TStoredStringPtrStoredStringPtrPrNodePtrMapCItrVec pivotIterators;
     pivotIterators.reserve(m_PivotNodes.size());
     for (auto i = m_PivotNodes.begin(); i != m_PivotNodes.end(); ++i) {
         pivotIterators.push_back(i);
@@ -762,12 +851,12 @@ void CHierarchicalResults::acceptPersistInserter(core::CStatePersistInserter& in
         core::CPersistUtils::persist(PIVOT_VALUE_TAG, *i->first.second, inserter);
         inserter.insertLevel(PIVOT_NODES_1_TAG,
                              boost::bind(&SNode::acceptPersistInserter1,
-                                         boost::cref(i->second), _1,
+                                         boost::cref(*i->second), _1,
                                          boost::ref(nodePointers)));
     }
 
     // Sort the keys by *value* order to ensure consistent persist state.
-    TStoredStringPtrNodeMapCItrVec pivotRootIterators;
+    TStoredStringPtrNodePtrMapCItrVec pivotRootIterators;
     pivotRootIterators.reserve(m_PivotRootNodes.size());
     for (auto i = m_PivotRootNodes.begin(); i != m_PivotRootNodes.end(); ++i) {
         pivotRootIterators.push_back(i);
@@ -778,7 +867,7 @@ void CHierarchicalResults::acceptPersistInserter(core::CStatePersistInserter& in
         core::CPersistUtils::persist(PIVOT_NAME_TAG, *i->first, inserter);
         inserter.insertLevel(PIVOT_ROOT_NODES_1_TAG,
                              boost::bind(&SNode::acceptPersistInserter1,
-                                         boost::cref(i->second), _1,
+                                         boost::cref(*i->second), _1,
                                          boost::ref(nodePointers)));
     }
 
@@ -793,7 +882,7 @@ void CHierarchicalResults::acceptPersistInserter(core::CStatePersistInserter& in
         core::CPersistUtils::persist(PIVOT_VALUE_TAG, *i->first.second, inserter);
         inserter.insertLevel(PIVOT_NODES_2_TAG,
                              boost::bind(&SNode::acceptPersistInserter2,
-                                         boost::cref(i->second), _1,
+                                         boost::cref(*i->second), _1,
                                          boost::cref(nodePointers)));
     }
 
@@ -801,7 +890,7 @@ void CHierarchicalResults::acceptPersistInserter(core::CStatePersistInserter& in
         core::CPersistUtils::persist(PIVOT_NAME_TAG, *i->first, inserter);
         inserter.insertLevel(PIVOT_ROOT_NODES_2_TAG,
                              boost::bind(&SNode::acceptPersistInserter2,
-                                         boost::cref(i->second), _1,
+                                         boost::cref(*i->second), _1,
                                          boost::cref(nodePointers)));
     }
 }
@@ -815,14 +904,15 @@ bool CHierarchicalResults::acceptRestoreTraverser(core::CStateRestoreTraverser&
     do {
         const std::string& name = traverser.name();
         RESTORE_SETUP_TEARDOWN(
-            NODES_1_TAG, m_Nodes.push_back(SNode()),
+            NODES_1_TAG, this->newNode(),
             traverser.traverseSubLevel(boost::bind(&SNode::acceptRestoreTraverser1,
-                                                   boost::ref(m_Nodes.back()),
+                                                   boost::ref(m_Nodes[m_Nodes.size() - 1]),
                                                    _1, boost::ref(nodePointers))),
             /**/)
         if (name == NODES_2_TAG) {
-            if (nodesFullyRestored > m_Nodes.size()) {
+            if (nodesFullyRestored >= m_Nodes.size()) {
                 LOG_ERROR(<< "Invalid restore index for node: " << nodesFullyRestored);
+                return false;
             }
             if (traverser.traverseSubLevel(boost::bind(
                     &SNode::acceptRestoreTraverser2, boost::ref(m_Nodes[nodesFullyRestored]),
@@ -844,7 +934,7 @@ bool CHierarchicalResults::acceptRestoreTraverser(core::CStateRestoreTraverser&
                 LOG_ERROR(<< "Invalid influencers for node");
                 return false;
             }
-            SNode& node = m_PivotNodes[TStoredStringPtrStoredStringPtrPr(influencerName, influencerValue)];
+            SNode& node = this->newPivot({influencerName, influencerValue});
             if (traverser.traverseSubLevel(
                     boost::bind(&SNode::acceptRestoreTraverser1, boost::ref(node),
                                 _1, boost::ref(nodePointers))) == false) {
@@ -859,7 +949,7 @@ bool CHierarchicalResults::acceptRestoreTraverser(core::CStateRestoreTraverser&
                 LOG_ERROR(<< "Invalid influencers for node");
                 return false;
             }
-            SNode& node = m_PivotNodes[TStoredStringPtrStoredStringPtrPr(influencerName, influencerValue)];
+            SNode& node = this->newPivot({influencerName, influencerValue});
             if (traverser.traverseSubLevel(
                     boost::bind(&SNode::acceptRestoreTraverser2, boost::ref(node),
                                 _1, boost::cref(nodePointers))) == false) {
@@ -875,7 +965,7 @@ bool CHierarchicalResults::acceptRestoreTraverser(core::CStateRestoreTraverser&
                 LOG_ERROR(<< "Invalid influencer for node");
                 return false;
             }
-            SNode& node = m_PivotRootNodes[influencerName];
+            SNode& node = this->newPivotRoot(influencerName);
             if (traverser.traverseSubLevel(
                     boost::bind(&SNode::acceptRestoreTraverser1, boost::ref(node),
                                 _1, boost::ref(nodePointers))) == false) {
@@ -890,7 +980,7 @@ bool CHierarchicalResults::acceptRestoreTraverser(core::CStateRestoreTraverser&
                 LOG_ERROR(<< "Invalid influencer for node");
                 return false;
             }
-            SNode& node = m_PivotRootNodes[influencerName];
+            SNode& node = this->newPivotRoot(influencerName);
             if (traverser.traverseSubLevel(
                     boost::bind(&SNode::acceptRestoreTraverser2, boost::ref(node),
                                 _1, boost::cref(nodePointers))) == false) {
@@ -913,30 +1003,39 @@ std::string CHierarchicalResults::print() const {
 }
 
 CHierarchicalResults::TNode& CHierarchicalResults::newNode() {
-    m_Nodes.push_back(TNode());
-    return m_Nodes.back();
+    return m_Nodes.add();
 }
 
 CHierarchicalResults::TNode&
 CHierarchicalResults::newLeaf(const TResultSpec& simpleSearch,
                               SAnnotatedProbability& annotatedProbability) {
-    m_Nodes.emplace_back(simpleSearch, annotatedProbability);
-    return m_Nodes.back();
+    TNode& result = m_Nodes.add();
+    result.s_Spec = simpleSearch;
+    result.s_Detector = simpleSearch.s_Detector;
+    result.s_SmallestChildProbability = annotatedProbability.s_Probability;
+    result.s_AnnotatedProbability.swap(annotatedProbability);
+    return result;
 }
 
 CHierarchicalResults::TNode&
 CHierarchicalResults::newPivot(TStoredStringPtrStoredStringPtrPr key) {
-    TNode& result = m_PivotNodes[key];
-    result.s_Spec.s_PersonFieldName = key.first;
-    result.s_Spec.s_PersonFieldValue = key.second;
-    return result;
+    TNodePtr& result = m_PivotNodes[key];
+    if (result == nullptr) {
+        result = &m_PivotNodeStore.add();
+    }
+    result->s_Spec.s_PersonFieldName = key.first;
+    result->s_Spec.s_PersonFieldValue = key.second;
+    return *result;
 }
 
 CHierarchicalResults::TNode& CHierarchicalResults::newPivotRoot(const TStoredStringPtr& key) {
-    TNode& result = m_PivotRootNodes[key];
-    result.s_Spec.s_PersonFieldName = key;
-    result.s_Spec.s_PersonFieldValue = UNSET_STRING;
-    return result;
+    TNodePtr& result = m_PivotRootNodes[key];
+    if (result == nullptr) {
+        result = &m_PivotNodeStore.add();
+    }
+    result->s_Spec.s_PersonFieldName = key;
+    result->s_Spec.s_PersonFieldValue = UNSET_STRING;
+    return *result;
 }
 
 void CHierarchicalResults::postorderDepthFirst(const TNode* node,
@@ -115,8 +115,16 @@ CIndividualModel::CIndividualModel(bool isForPersistence, const CIndividualModel
         m_FeatureModels.emplace_back(feature.s_Feature, feature.s_NewModel);
         m_FeatureModels.back().s_Models.reserve(feature.s_Models.size());
         for (const auto& model : feature.s_Models) {
-            m_FeatureModels.back().s_Models.emplace_back(model->cloneForPersistence());
+            m_FeatureModels.back().s_Models.emplace_back(
+                model != nullptr ? model->cloneForPersistence() : nullptr);
         }
+        // The clone is persisted in the background. It shares the handles
+        // of any spilled state, which keep the state in the store until it
+        // has been persisted, and reads it through the store.
+        m_FeatureModels.back().s_HibernatingModels = feature.s_HibernatingModels;
+        m_FeatureModels.back().s_RestoreParams = feature.s_RestoreParams;
+        m_FeatureModels.back().s_SpillStore = feature.s_SpillStore;
+        m_FeatureModels.back().s_SpilledModels = feature.s_SpilledModels;
     }
 
     m_FeatureCorrelatesModels.reserve(other.m_FeatureCorrelatesModels.size());
@@ -169,6 +177,12 @@ void CIndividualModel::sampleBucketStatistics(core_t::TTime startTime,
         TSizeUInt64PrVec& personCounts = this->currentBucketPersonCounts();
         gatherer.personNonZeroCounts(time, personCounts);
         this->applyFilter(model_t::E_XF_By, false, this->personFilter(), personCounts);
+        // We compute interim results for these people.
+        for (const auto& count : personCounts) {
+            for (auto& feature : m_FeatureModels) {
+                feature.wake(count.first);
+            }
+        }
     }
 }
 
@@ -205,8 +219,59 @@ void CIndividualModel::sample(core_t::TTime startTime,
                 m_FirstBucketTimes[pid] = time;
             }
             m_LastBucketTimes[pid] = time;
+            resourceMonitor.seen(*this, CResourceMonitor::E_Person, pid, time);
         }
         this->applyFilter(model_t::E_XF_By, true, this->personFilter(), personCounts);
+        this->hibernateInactiveModels(time);
+    }
+}
+
+void CIndividualModel::hibernateInactiveModels(core_t::TTime time) {
+    std::size_t age = this->params().s_ModelHibernationAge;
+    if (age == 0) {
+        return;
+    }
+
+    const CDataGatherer& gatherer = this->dataGatherer();
+    core_t::TTime bucketLength = gatherer.bucketLength();
+
+    // Checking every person costs O(people x features) so we only sweep
+    // every quarter of the hibernation age. Models are therefore hibernated
+    // at most 25% later than the configured age. The sweep buckets are
+    // derived from the time so they don't need to be persisted.
+    core_t::TTime interval = static_cast<core_t::TTime>(std::max(age / 4, std::size_t(1)));
+    if ((time / bucketLength) % interval != 0) {
+        return;
+    }
+
+    // Models which are updated every bucket or which are correlated with
+    // other models are never inactive.
+    TFeatureModelsPtrVec features;
+    for (auto& feature : m_FeatureModels) {
+        if (model_t::countsEmptyBuckets(feature.s_Feature) == false &&
+            std::none_of(m_FeatureCorrelatesModels.begin(),
+                         m_FeatureCorrelatesModels.end(),
+                         [&feature](const SFeatureCorrelateModels& correlates) {
+                             return correlates.s_Feature == feature.s_Feature;
+                         })) {
+            features.push_back(&feature);
+        }
+    }
+    if (features.empty()) {
+        return;
+    }
+
+    core_t::TTime cutoff = time - static_cast<core_t::TTime>(age) * bucketLength;
+    for (std::size_t pid = 0u; pid < m_LastBucketTimes.size(); ++pid) {
+        if (gatherer.isPersonActive(pid) &&
+            !CAnomalyDetectorModel::isTimeUnset(m_LastBucketTimes[pid]) &&
+            m_LastBucketTimes[pid] <= cutoff) {
+            for (auto feature : features) {
+                if (pid < feature->s_Models.size() && feature->s_Models[pid] != nullptr) {
+                    feature->hibernate(this->params(), pid);
+                }
+            }
+        }
     }
 }
 
@@ -233,16 +298,27 @@ void CIndividualModel::prune(std::size_t maximumAge) {
         }
     }
 
-    if (peopleToRemove.empty()) {
+    std::sort(peopleToRemove.begin(), peopleToRemove.end());
+    this->prunePeopleAndAttributes(peopleToRemove, TSizeVec());
+}
+
+void CIndividualModel::prunePeopleAndAttributes(const TSizeVec& people,
+                                                const TSizeVec& /*attributes*/) {
+    if (people.empty()) {
         return;
     }
 
-    std::sort(peopleToRemove.begin(), peopleToRemove.end());
-    LOG_DEBUG(<< "Removing people {" << this->printPeople(peopleToRemove, 20) << '}');
+    LOG_DEBUG(<< "Removing people {" << this->printPeople(people, 20) << '}');
 
     // We clear large state objects from removed people's model
     // and reinitialize it when they are recycled.
-    this->clearPrunedResources(peopleToRemove, TSizeVec());
+    this->clearPrunedResources(people, TSizeVec());
+}
+
+core_t::TTime CIndividualModel::personLastBucketTime(std::size_t pid) const {
+    return pid < m_LastBucketTimes.size() && this->dataGatherer().isPersonActive(pid)
+               ? m_LastBucketTimes[pid]
+               : CAnomalyDetectorModel::TIME_UNSET;
 }
 
 bool CIndividualModel::computeTotalProbability(const std::string& /*person*/,
@@ -263,7 +339,14 @@ uint64_t CIndividualModel::checksum(bool includeCurrentBucketStats) const {
     hashActive(gatherer, m_FirstBucketTimes, hashes1);
     hashActive(gatherer, m_LastBucketTimes, hashes1);
     for (const auto& feature : m_FeatureModels) {
-        hashActive(gatherer, feature.s_Models, hashes1);
+        for (std::size_t pid = 0u; pid < feature.s_Models.size(); ++pid) {
+            if (gatherer.isPersonActive(pid)) {
+                uint64_t& hash = hashes1[boost::cref(gatherer.personName(pid))];
+                hash = feature.isHibernating(pid)
+                           ? maths::CChecksum::calculate(hash, feature.restoreHibernating(pid))
+                           : maths::CChecksum::calculate(hash, feature.s_Models[pid]);
+            }
+        }
     }
 
     TStrCRefStrCRefPrUInt64Map hashes2;
@@ -471,6 +554,7 @@ void CIndividualModel::updateRecycledModels() {
             m_FirstBucketTimes[pid] = CAnomalyDetectorModel::TIME_UNSET;
             m_LastBucketTimes[pid] = CAnomalyDetectorModel::TIME_UNSET;
             for (auto& feature : m_FeatureModels) {
+                feature.clearHibernating(pid);
                 feature.s_Models[pid].reset(feature.s_NewModel->clone(pid));
                 for (const auto& correlates : m_FeatureCorrelatesModels) {
                     if (feature.s_Feature == correlates.s_Feature) {
@@ -504,6 +588,7 @@ void CIndividualModel::clearPrunedResources(const TSizeVec& people,
     for (auto pid : people) {
         for (auto& feature : m_FeatureModels) {
             if (pid < feature.s_Models.size()) {
+                feature.clearHibernating(pid);
                 feature.s_Models[pid].reset(this->tinyModel());
             }
         }
@@ -538,7 +623,31 @@ double CIndividualModel::probabilityBucketEmpty(model_t::EFeature feature,
 }
 
 const maths::CModel* CIndividualModel::model(model_t::EFeature feature, std::size_t pid) const {
-    return const_cast<CIndividualModel*>(this)->model(feature, pid);
+    auto i = std::find_if(m_FeatureModels.begin(), m_FeatureModels.end(),
+                          [feature](const SFeatureModels& model) {
+                              return model.s_Feature == feature;
+                          });
+    if (i == m_FeatureModels.end() || pid >= i->s_Models.size()) {
+        return nullptr;
+    }
+    return i->s_Models[pid].get();
+}
+
+const maths::CModel* CIndividualModel::model(model_t::EFeature feature,
+                                             std::size_t pid,
+                                             TMathsModelUPtr& restored) const {
+    auto i = std::find_if(m_FeatureModels.begin(), m_FeatureModels.end(),
+                          [feature](const SFeatureModels& model) {
+                              return model.s_Feature == feature;
+                          });
+    if (i == m_FeatureModels.end() || pid >= i->s_Models.size()) {
+        return nullptr;
+    }
+    if (i->isHibernating(pid)) {
+        restored = i->restoreHibernating(pid);
+        return restored.get();
+    }
+    return i->s_Models[pid].get();
 }
 
 maths::CModel* CIndividualModel::model(model_t::EFeature feature, std::size_t pid) {
@@ -546,9 +655,11 @@ maths::CModel* CIndividualModel::model(model_t::EFeature feature, std::size_t pi
                           [feature](const SFeatureModels& model) {
                               return model.s_Feature == feature;
                           });
-    return i != m_FeatureModels.end() && pid < i->s_Models.size()
-               ? i->s_Models[pid].get()
-               : nullptr;
+    if (i == m_FeatureModels.end() || pid >= i->s_Models.size()) {
+        return nullptr;
+    }
+    i->wake(pid);
+    return i->s_Models[pid].get();
 }
 
 void CIndividualModel::sampleCorrelateModels() {
@@ -624,8 +735,9 @@ void CIndividualModel::doSkipSampling(core_t::TTime startTime, core_t::TTime end
     }
 
     for (auto& feature : m_FeatureModels) {
-        for (auto& model : feature.s_Models) {
-            model->skipTime(gap);
+        for (std::size_t pid = 0u; pid < feature.s_Models.size(); ++pid) {
+            feature.wake(pid);
+            feature.s_Models[pid]->skipTime(gap);
         }
     }
 }
@@ -699,29 +699,15 @@ public:
 //! Extracts feature data from a collection of gatherers.
 struct SExtractFeatureData {
 public:
-    using TFeatureAnyPr = std::pair<model_t::EFeature, boost::any>;
-    using TFeatureAnyPrVec = std::vector<TFeatureAnyPr>;
-
-public:
-    template<typename T>
+    template<typename T, typename U>
     void operator()(const TCategorySizePr& /*category*/,
                     const TSizeSizeTUMapUMap<T>& data,
                     const CMetricBucketGatherer& gatherer,
                     model_t::EFeature feature,
                     core_t::TTime time,
                     core_t::TTime bucketLength,
-                    TFeatureAnyPrVec& result) const {
-        if (gatherer.dataGatherer().isPopulation()) {
-            result.emplace_back(feature, TSizeSizePrFeatureDataPrVec());
-            this->featureData(data, gatherer, time, bucketLength, this->isSum(feature),
-                              *boost::unsafe_any_cast<TSizeSizePrFeatureDataPrVec>(
-                                  &result.back().second));
-        } else {
-            result.emplace_back(feature, TSizeFeatureDataPrVec());
-            this->featureData(
-                data, gatherer, time, bucketLength, this->isSum(feature),
-                *boost::unsafe_any_cast<TSizeFeatureDataPrVec>(&result.back().second));
-        }
+                    U& result) const {
+        this->featureData(data, gatherer, time, bucketLength, this->isSum(feature), result);
     }
 
 private:
@@ -1361,18 +1347,41 @@ void CMetricBucketGatherer::sample(core_t::TTime time) {
     this->CBucketGatherer::sample(time);
 }
 
-void CMetricBucketGatherer::featureData(core_t::TTime time,
+bool CMetricBucketGatherer::featureData(core_t::TTime time,
                                         core_t::TTime bucketLength,
-                                        TFeatureAnyPrVec& result) const {
-    result.clear();
+                                        TFeatureSizeMetricFeatureDataPrVecPrVec& result) const {
+    if (m_DataGatherer.isPopulation()) {
+        LOG_ERROR(<< "Individual feature data requested from population gatherer");
+        result.clear();
+        return false;
+    }
+    return this->featureDataImpl(time, bucketLength, result);
+}
 
+bool CMetricBucketGatherer::featureData(core_t::TTime time,
+                                        core_t::TTime bucketLength,
+                                        TFeatureSizeSizePrMetricFeatureDataPrVecPrVec& result) const {
+    if (m_DataGatherer.isPopulation() == false) {
+        LOG_ERROR(<< "Population feature data requested from individual gatherer");
+        result.clear();
+        return false;
+    }
+    return this->featureDataImpl(time, bucketLength, result);
+}
+
+template<typename T>
+bool CMetricBucketGatherer::featureDataImpl(core_t::TTime time,
+                                            core_t::TTime bucketLength,
+                                            std::vector<std::pair<model_t::EFeature, T>>& result) const {
     if (!this->dataAvailable(time) ||
         time >= this->currentBucketStartTime() + this->bucketLength()) {
         LOG_DEBUG(<< "No data available at " << time);
-        return;
+        result.clear();
+        return true;
     }
 
-    for (std::size_t i = 0u, n = m_DataGatherer.numberFeatures(); i < n; ++i) {
+    std::size_t n = 0u;
+    for (std::size_t i = 0u, m = m_DataGatherer.numberFeatures(); i < m; ++i) {
         model_t::EFeature feature = m_DataGatherer.feature(i);
         model_t::EMetricCategory category;
         if (model_t::metricCategory(feature, category)) {
@@ -1383,8 +1392,8 @@ void CMetricBucketGatherer::featureData(core_t::TTime time,
                 ++end;
                 apply(begin, end,
                       boost::bind<void>(SExtractFeatureData(), _1, _2,
-                                        boost::cref(*this), feature, time,
-                                        bucketLength, boost::ref(result)));
+                                        boost::cref(*this), feature, time, bucketLength,
+                                        boost::ref(nextFeatureData(feature, n, result))));
             } else {
                 LOG_ERROR(<< "No data for category " << model_t::print(category));
             }
@@ -1392,6 +1401,9 @@ void CMetricBucketGatherer::featureData(core_t::TTime time,
             LOG_ERROR(<< "Unexpected feature " << model_t::print(feature));
         }
     }
+    result.resize(n);
+
+    return true;
 }
 
 void CMetricBucketGatherer::resize(std::size_t pid, std::size_t cid) {
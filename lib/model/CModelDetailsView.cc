@@ -17,6 +17,9 @@
 #include <model/CMetricModel.h>
 #include <model/CMetricPopulationModel.h>
 
+#include <algorithm>
+#include <numeric>
+
 namespace ml {
 namespace model {
 namespace {
@@ -45,23 +48,19 @@ void CModelDetailsView::modelPlot(core_t::TTime time,
                                   double boundsPercentile,
                                   const TStrSet& terms,
                                   CModelPlotData& modelPlotData) const {
+    // Resolve the terms to by field identifiers once for all features so we
+    // only visit the by fields which will be plotted.
+    TSizeVec ids;
+    TBoolVec selected;
+    this->byFieldIds(terms, ids, selected);
+
     for (auto feature : this->features()) {
         if (!model_t::isConstant(feature) && !model_t::isCategorical(feature)) {
-            if (terms.empty() || !this->hasByField()) {
-                for (std::size_t byFieldId = 0; byFieldId < this->maxByFieldId(); ++byFieldId) {
-                    this->modelPlotForByFieldId(time, boundsPercentile, feature,
-                                                byFieldId, modelPlotData);
-                }
-            } else {
-                for (const auto& term : terms) {
-                    std::size_t byFieldId(0);
-                    if (this->byFieldId(term, byFieldId)) {
-                        this->modelPlotForByFieldId(time, boundsPercentile, feature,
-                                                    byFieldId, modelPlotData);
-                    }
-                }
+            for (auto byFieldId : ids) {
+                this->modelPlotForByFieldId(time, boundsPercentile, feature,
+                                            byFieldId, modelPlotData);
             }
-            this->addCurrentBucketValues(time, feature, terms, modelPlotData);
+            this->addCurrentBucketValues(time, feature, selected, modelPlotData);
         }
     }
 }
@@ -108,9 +107,38 @@ void CModelDetailsView::modelPlotForByFieldId(core_t::TTime time,
     }
 }
 
+void CModelDetailsView::byFieldIds(const TStrSet& terms, TSizeVec& ids, TBoolVec& selected) const {
+    std::size_t n{this->maxByFieldId()};
+    ids.clear();
+    if (terms.empty() || !this->hasByField()) {
+        ids.resize(n);
+        std::iota(ids.begin(), ids.end(), 0);
+        selected.assign(n, true);
+        return;
+    }
+    selected.assign(n, false);
+    auto select = [&](const std::string& term) {
+        std::size_t byFieldId(0);
+        if (this->byFieldId(term, byFieldId) && byFieldId < n && !selected[byFieldId]) {
+            ids.push_back(byFieldId);
+            selected[byFieldId] = true;
+        }
+    };
+    for (const auto& term : terms) {
+        select(term);
+    }
+    std::sort(ids.begin(), ids.end());
+    // The current bucket values are also added for a missing by field,
+    // but its model isn't plotted.
+    std::size_t missing(0);
+    if (this->byFieldId(EMPTY_STRING, missing) && missing < n) {
+        selected[missing] = true;
+    }
+}
+
 void CModelDetailsView::addCurrentBucketValues(core_t::TTime time,
                                                model_t::EFeature feature,
-                                               const TStrSet& terms,
+                                               const TBoolVec& selected,
                                                CModelPlotData& modelPlotData) const {
     const CDataGatherer& gatherer = this->base().dataGatherer();
     if (!gatherer.dataAvailable(time)) {
@@ -120,8 +148,9 @@ void CModelDetailsView::addCurrentBucketValues(core_t::TTime time,
     bool isPopulation{gatherer.isPopulation()};
 
     auto addCurrentBucketValue = [&](std::size_t pid, std::size_t cid) {
-        const std::string& byFieldValue{this->byFieldValue(pid, cid)};
-        if (this->contains(terms, byFieldValue)) {
+        std::size_t byFieldId{isPopulation ? cid : pid};
+        if (byFieldId < selected.size() && selected[byFieldId]) {
+            const std::string& byFieldValue{this->byFieldValue(pid, cid)};
             TDouble1Vec value(this->base().currentBucketValue(feature, pid, cid, time));
             if (!value.empty()) {
                 const std::string& overFieldValue{
@@ -132,15 +161,19 @@ void CModelDetailsView::addCurrentBucketValues(core_t::TTime time,
     };
 
     if (model_t::countsEmptyBuckets(feature)) {
-        for (std::size_t pid = 0u; pid < gatherer.numberPeople(); ++pid) {
-            if (gatherer.isPersonActive(pid)) {
-                if (isPopulation) {
-                    for (std::size_t cid = 0u; cid < gatherer.numberAttributes(); ++cid) {
-                        if (gatherer.isAttributeActive(cid)) {
+        if (isPopulation) {
+            for (std::size_t pid = 0u; pid < gatherer.numberPeople(); ++pid) {
+                if (gatherer.isPersonActive(pid)) {
+                    for (std::size_t cid = 0u; cid < selected.size(); ++cid) {
+                        if (selected[cid] && gatherer.isAttributeActive(cid)) {
                             addCurrentBucketValue(pid, cid);
                         }
                     }
-                } else {
+                }
+            }
+        } else {
+            for (std::size_t pid = 0u; pid < selected.size(); ++pid) {
+                if (selected[pid] && gatherer.isPersonActive(pid)) {
                     addCurrentBucketValue(pid, model_t::INDIVIDUAL_ANALYSIS_ATTRIBUTE_ID);
                 }
             }
@@ -154,10 +187,6 @@ void CModelDetailsView::addCurrentBucketValues(core_t::TTime time,
     }
 }
 
-bool CModelDetailsView::contains(const TStrSet& terms, const std::string& key) {
-    return terms.empty() || key.empty() || terms.find(key) != terms.end();
-}
-
 bool CModelDetailsView::hasByField() const {
     const std::string& byField = this->base().isPopulation()
                                      ? this->base().dataGatherer().attributeFieldName()
@@ -201,7 +230,7 @@ CEventRateModelDetailsView::CEventRateModelDetailsView(const CEventRateModel& mo
 
 const maths::CModel* CEventRateModelDetailsView::model(model_t::EFeature feature,
                                                        std::size_t byFieldId) const {
-    return m_Model->model(feature, byFieldId);
+    return m_Model->model(feature, byFieldId, m_Restored);
 }
 
 const CAnomalyDetectorModel& CEventRateModelDetailsView::base() const {
@@ -243,7 +272,7 @@ CMetricModelDetailsView::CMetricModelDetailsView(const CMetricModel& model)
 
 const maths::CModel* CMetricModelDetailsView::model(model_t::EFeature feature,
                                                     std::size_t byFieldId) const {
-    return m_Model->model(feature, byFieldId);
+    return m_Model->model(feature, byFieldId, m_Restored);
 }
 
 const CAnomalyDetectorModel& CMetricModelDetailsView::base() const {
@@ -79,6 +79,7 @@ CModelFactory::defaultFeatureModel(model_t::EFeature feature,
                                minimumSeasonalVarianceScale,
                                m_ModelParams.s_MinimumTimeToDetectChange,
                                m_ModelParams.s_MaximumTimeToTestForChange};
+    params.maximumNumberActiveChangeDetectors(m_ModelParams.s_MaximumNumberActiveChangeDetectors);
 
     std::size_t dimension{model_t::dimension(feature)};
 
@@ -208,6 +209,10 @@ void CModelFactory::excludeFrequent(model_t::EExcludeFrequent excludeFrequent) {
     m_ModelParams.s_ExcludeFrequent = excludeFrequent;
 }
 
+void CModelFactory::infoContentEstimator(model_t::EInfoContentEstimator estimator) {
+    m_ModelParams.s_InfoContentEstimator = estimator;
+}
+
 void CModelFactory::detectionRules(TDetectionRuleVecCRef detectionRules) {
     m_ModelParams.s_DetectionRules = detectionRules;
 }
@@ -260,6 +265,18 @@ void CModelFactory::componentSize(std::size_t componentSize) {
     m_ModelParams.s_ComponentSize = componentSize;
 }
 
+void CModelFactory::modelHibernationAge(std::size_t age) {
+    m_ModelParams.s_ModelHibernationAge = age;
+}
+
+void CModelFactory::maximumNumberActiveChangeDetectors(std::size_t number) {
+    m_ModelParams.s_MaximumNumberActiveChangeDetectors = number;
+}
+
+void CModelFactory::modelSpillStore(const SModelParams::TModelSpillStorePtr& store) {
+    m_ModelParams.s_ModelSpillStore = store;
+}
+
 double CModelFactory::minimumModeFraction() const {
     return m_ModelParams.s_MinimumModeFraction;
 }
@@ -37,7 +37,11 @@ SModelParams::SModelParams(core_t::TTime bucketLength)
       s_ComponentSize(CAnomalyDetectorModelConfig::DEFAULT_COMPONENT_SIZE),
       s_MinimumTimeToDetectChange(CAnomalyDetectorModelConfig::DEFAULT_MINIMUM_TIME_TO_DETECT_CHANGE),
       s_MaximumTimeToTestForChange(CAnomalyDetectorModelConfig::DEFAULT_MAXIMUM_TIME_TO_TEST_FOR_CHANGE),
-      s_ExcludeFrequent(model_t::E_XF_None), s_ExcludePersonFrequency(0.1),
+      s_MaximumNumberActiveChangeDetectors(
+          CAnomalyDetectorModelConfig::DEFAULT_MAXIMUM_NUMBER_ACTIVE_CHANGE_DETECTORS),
+      s_ModelHibernationAge(CAnomalyDetectorModelConfig::DEFAULT_MODEL_HIBERNATION_AGE),
+      s_ExcludeFrequent(model_t::E_XF_None),
+      s_InfoContentEstimator(model_t::E_InfoContentDeflate), s_ExcludePersonFrequency(0.1),
       s_ExcludeAttributeFrequency(0.1),
       s_MaximumUpdatesPerBucket(CAnomalyDetectorModelConfig::DEFAULT_MAXIMUM_UPDATES_PER_BUCKET),
       s_InfluenceCutoff(CAnomalyDetectorModelConfig::DEFAULT_INFLUENCE_CUTOFF),
@@ -93,7 +97,10 @@ uint64_t SModelParams::checksum(uint64_t seed) const {
     seed = maths::CChecksum::calculate(seed, s_ComponentSize);
     seed = maths::CChecksum::calculate(seed, s_MinimumTimeToDetectChange);
     seed = maths::CChecksum::calculate(seed, s_MaximumTimeToTestForChange);
+    seed = maths::CChecksum::calculate(seed, s_MaximumNumberActiveChangeDetectors);
+    seed = maths::CChecksum::calculate(seed, s_ModelHibernationAge);
     seed = maths::CChecksum::calculate(seed, s_ExcludeFrequent);
+    seed = maths::CChecksum::calculate(seed, s_InfoContentEstimator);
     seed = maths::CChecksum::calculate(seed, s_ExcludePersonFrequency);
     seed = maths::CChecksum::calculate(seed, s_ExcludeAttributeFrequency);
     seed = maths::CChecksum::calculate(seed, s_MaximumUpdatesPerBucket);
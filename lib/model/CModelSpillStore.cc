@@ -0,0 +1,247 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include <model/CModelSpillStore.h>
+
+#include <core/CLogger.h>
+#include <core/CMemory.h>
+#include <core/CProcess.h>
+#include <core/CScopedFastLock.h>
+#include <core/CStatistics.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sstream>
+
+namespace ml {
+namespace model {
+namespace {
+//! Used to give each store's scratch file a unique name.
+std::atomic<std::size_t> storeCounter{0};
+}
+
+const std::size_t CModelSpillStore::SLAB_SIZE(256);
+const std::size_t CModelSpillStore::INITIAL_NUMBER_SLABS(4096);
+const double CModelSpillStore::DEFAULT_RESIDENT_MEMORY_FRACTION(0.1);
+
+CModelSpillStore::CHandle::CHandle(CModelSpillStore& store, std::size_t key)
+    : m_Store(&store), m_Key(key) {
+}
+
+CModelSpillStore::CHandle::~CHandle() {
+    this->reset();
+}
+
+CModelSpillStore::CHandle::CHandle(CHandle&& other)
+    : m_Store(other.m_Store), m_Key(other.m_Key) {
+    other.m_Store = nullptr;
+}
+
+CModelSpillStore::CHandle& CModelSpillStore::CHandle::operator=(CHandle&& other) {
+    if (this != &other) {
+        this->reset();
+        m_Store = other.m_Store;
+        m_Key = other.m_Key;
+        other.m_Store = nullptr;
+    }
+    return *this;
+}
+
+bool CModelSpillStore::CHandle::valid() const {
+    return m_Store != nullptr;
+}
+
+bool CModelSpillStore::CHandle::read(TByteVec& result) const {
+    return m_Store != nullptr && m_Store->read(m_Key, result);
+}
+
+void CModelSpillStore::CHandle::reset() {
+    if (m_Store != nullptr) {
+        m_Store->remove(m_Key);
+        m_Store = nullptr;
+    }
+}
+
+std::size_t CModelSpillStore::CHandle::memoryUsage() const {
+    return m_Store != nullptr ? m_Store->residentMemoryUsage(m_Key) : 0;
+}
+
+CModelSpillStore::CModelSpillStore(const std::string& directory, std::size_t residentMemoryLimit)
+    : m_ResidentMemoryLimit(residentMemoryLimit), m_ResidentMemory(0), m_NextKey(0) {
+    std::ostringstream fileName;
+    fileName << directory << "/ml-model-spill-" << core::CProcess::instance().id()
+             << '-' << storeCounter++;
+    if (m_File.open(fileName.str(), INITIAL_NUMBER_SLABS * SLAB_SIZE)) {
+        m_FreeSlabs.emplace(0, INITIAL_NUMBER_SLABS);
+        LOG_DEBUG(<< "Spilling model state to " << fileName.str());
+    } else {
+        LOG_ERROR(<< "Failed to create " << fileName.str()
+                  << ": hibernating model state will be kept in memory");
+    }
+}
+
+bool CModelSpillStore::isOpen() const {
+    core::CScopedFastLock lock(m_Mutex);
+    return m_File.isOpen();
+}
+
+CModelSpillStore::CHandle CModelSpillStore::add(TByteVec state) {
+    core::CScopedFastLock lock(m_Mutex);
+    std::size_t key{m_NextKey++};
+    SState& entry = m_States[key];
+    entry.s_Length = state.size();
+    entry.s_State = std::move(state);
+    entry.s_Resident = m_Resident.insert(m_Resident.end(), key);
+    m_ResidentMemory += core::CMemory::dynamicSize(entry.s_State);
+    this->pageOut();
+    return CHandle{*this, key};
+}
+
+void CModelSpillStore::residentMemoryLimit(std::size_t limit) {
+    core::CScopedFastLock lock(m_Mutex);
+    m_ResidentMemoryLimit = limit;
+    this->pageOut();
+}
+
+std::size_t CModelSpillStore::numberResident() const {
+    core::CScopedFastLock lock(m_Mutex);
+    return m_Resident.size();
+}
+
+std::size_t CModelSpillStore::numberPagedOut() const {
+    core::CScopedFastLock lock(m_Mutex);
+    return m_States.size() - m_Resident.size();
+}
+
+std::size_t CModelSpillStore::numberSlabs() const {
+    core::CScopedFastLock lock(m_Mutex);
+    return m_File.size() / SLAB_SIZE;
+}
+
+void CModelSpillStore::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    core::CScopedFastLock lock(m_Mutex);
+    mem->setName("CModelSpillStore");
+    core::CMemoryDebug::dynamicSize("m_States", m_States, mem);
+    core::CMemoryDebug::dynamicSize("m_Resident", m_Resident, mem);
+    core::CMemoryDebug::dynamicSize("m_FreeSlabs", m_FreeSlabs, mem);
+}
+
+std::size_t CModelSpillStore::memoryUsage() const {
+    core::CScopedFastLock lock(m_Mutex);
+    std::size_t mem = core::CMemory::dynamicSize(m_States);
+    mem += core::CMemory::dynamicSize(m_Resident);
+    mem += core::CMemory::dynamicSize(m_FreeSlabs);
+    return mem;
+}
+
+bool CModelSpillStore::read(std::size_t key, TByteVec& result) const {
+    core::CScopedFastLock lock(m_Mutex);
+    auto entry = m_States.find(key);
+    if (entry == m_States.end()) {
+        LOG_ERROR(<< "Missing state " << key);
+        return false;
+    }
+    const SState& state = entry->second;
+    if (state.s_PagedOut) {
+        const char* begin{m_File.data() + state.s_Slab * SLAB_SIZE};
+        result.assign(begin, begin + state.s_Length);
+        core::CStatistics::stat(stat_t::E_NumberModelPageIns).increment();
+    } else {
+        result = state.s_State;
+    }
+    return true;
+}
+
+void CModelSpillStore::remove(std::size_t key) {
+    core::CScopedFastLock lock(m_Mutex);
+    auto entry = m_States.find(key);
+    if (entry == m_States.end()) {
+        return;
+    }
+    SState& state = entry->second;
+    if (state.s_PagedOut) {
+        this->free(state.s_Slab, slabs(state.s_Length));
+    } else {
+        m_ResidentMemory -= core::CMemory::dynamicSize(state.s_State);
+        m_Resident.erase(state.s_Resident);
+    }
+    m_States.erase(entry);
+}
+
+std::size_t CModelSpillStore::residentMemoryUsage(std::size_t key) const {
+    core::CScopedFastLock lock(m_Mutex);
+    auto entry = m_States.find(key);
+    return entry != m_States.end() ? core::CMemory::dynamicSize(entry->second.s_State) : 0;
+}
+
+void CModelSpillStore::pageOut() {
+    if (m_File.isOpen() == false) {
+        return;
+    }
+    while (m_ResidentMemory > m_ResidentMemoryLimit && m_Resident.size() > 0) {
+        std::size_t key{m_Resident.front()};
+        SState& state = m_States[key];
+        std::size_t slab;
+        if (this->allocate(slabs(state.s_Length), slab) == false) {
+            return;
+        }
+        std::memcpy(m_File.data() + slab * SLAB_SIZE, state.s_State.data(), state.s_Length);
+        m_ResidentMemory -= core::CMemory::dynamicSize(state.s_State);
+        TByteVec empty;
+        state.s_State.swap(empty);
+        state.s_Slab = slab;
+        state.s_PagedOut = true;
+        m_Resident.pop_front();
+        core::CStatistics::stat(stat_t::E_NumberModelPageOuts).increment();
+    }
+}
+
+bool CModelSpillStore::allocate(std::size_t n, std::size_t& slab) {
+    auto run = std::find_if(m_FreeSlabs.begin(), m_FreeSlabs.end(),
+                            [n](const std::pair<const std::size_t, std::size_t>& run_) {
+                                return run_.second >= n;
+                            });
+    if (run == m_FreeSlabs.end()) {
+        std::size_t numberSlabs{m_File.size() / SLAB_SIZE};
+        std::size_t newNumberSlabs{2 * numberSlabs + n};
+        if (m_File.resize(newNumberSlabs * SLAB_SIZE) == false) {
+            return false;
+        }
+        this->free(numberSlabs, newNumberSlabs - numberSlabs);
+        return this->allocate(n, slab);
+    }
+
+    slab = run->first;
+    std::size_t remainder{run->second - n};
+    m_FreeSlabs.erase(run);
+    if (remainder > 0) {
+        m_FreeSlabs.emplace(slab + n, remainder);
+    }
+    return true;
+}
+
+void CModelSpillStore::free(std::size_t slab, std::size_t n) {
+    auto next = m_FreeSlabs.lower_bound(slab);
+    if (next != m_FreeSlabs.end() && slab + n == next->first) {
+        n += next->second;
+        next = m_FreeSlabs.erase(next);
+    }
+    if (next != m_FreeSlabs.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == slab) {
+            previous->second += n;
+            return;
+        }
+    }
+    m_FreeSlabs.emplace_hint(next, slab, n);
+}
+
+std::size_t CModelSpillStore::slabs(std::size_t length) {
+    return std::max((length + SLAB_SIZE - 1) / SLAB_SIZE, std::size_t(1));
+}
+}
+}
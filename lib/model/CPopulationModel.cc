@@ -187,11 +187,17 @@ void CPopulationModel::sample(core_t::TTime startTime,
     for (const auto& count : counts) {
         std::size_t pid = CDataGatherer::extractPersonId(count);
         std::size_t cid = CDataGatherer::extractAttributeId(count);
-        m_PersonLastBucketTimes[pid] = startTime;
+        if (m_PersonLastBucketTimes[pid] != startTime) {
+            m_PersonLastBucketTimes[pid] = startTime;
+            resourceMonitor.seen(*this, CResourceMonitor::E_Person, pid, startTime);
+        }
         if (CAnomalyDetectorModel::isTimeUnset(m_AttributeFirstBucketTimes[cid])) {
             m_AttributeFirstBucketTimes[cid] = startTime;
         }
-        m_AttributeLastBucketTimes[cid] = startTime;
+        if (m_AttributeLastBucketTimes[cid] != startTime) {
+            m_AttributeLastBucketTimes[cid] = startTime;
+            resourceMonitor.seen(*this, CResourceMonitor::E_Attribute, cid, startTime);
+        }
         m_DistinctPersonCounts[cid].add(static_cast<int32_t>(pid));
         if (cid < m_PersonAttributeBucketCounts.size()) {
             m_PersonAttributeBucketCounts[cid].add(static_cast<int32_t>(pid), 1.0);
@@ -508,6 +514,18 @@ const CPopulationModel::TTimeVec& CPopulationModel::attributeLastBucketTimes() c
     return m_AttributeLastBucketTimes;
 }
 
+core_t::TTime CPopulationModel::personLastBucketTime(std::size_t pid) const {
+    return pid < m_PersonLastBucketTimes.size() && this->dataGatherer().isPersonActive(pid)
+               ? m_PersonLastBucketTimes[pid]
+               : CAnomalyDetectorModel::TIME_UNSET;
+}
+
+core_t::TTime CPopulationModel::attributeLastBucketTime(std::size_t cid) const {
+    return cid < m_AttributeLastBucketTimes.size() && this->dataGatherer().isAttributeActive(cid)
+               ? m_AttributeLastBucketTimes[cid]
+               : CAnomalyDetectorModel::TIME_UNSET;
+}
+
 void CPopulationModel::peopleAndAttributesToRemove(core_t::TTime time,
                                                    std::size_t maximumAge,
                                                    TSizeVec& peopleToRemove,
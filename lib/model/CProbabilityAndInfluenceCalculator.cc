@@ -7,6 +7,7 @@
 #include <model/CProbabilityAndInfluenceCalculator.h>
 
 #include <core/CLogger.h>
+#include <core/CStatistics.h>
 
 #include <maths/CBasicStatistics.h>
 #include <maths/CModel.h>
@@ -19,6 +20,10 @@
 #include <model/CAnnotatedProbabilityBuilder.h>
 #include <model/CStringStore.h>
 
+#include <boost/unordered_map.hpp>
+
+#include <vector>
+
 namespace ml {
 namespace model {
 namespace {
@@ -48,6 +53,7 @@ using TTail2Vec = core::CSmallVector<maths_t::ETail, 2>;
 using TProbabilityCalculation2Vec = core::CSmallVector<maths_t::EProbabilityCalculation, 2>;
 using TSizeDoublePr = std::pair<std::size_t, double>;
 using TSizeDoublePr1Vec = core::CSmallVector<TSizeDoublePr, 1>;
+using TDoubleVec = std::vector<double>;
 
 //! Get the canonical influence string pointer.
 core::CStoredStringPtr canonical(const std::string& influence) {
@@ -291,6 +297,65 @@ public:
     }
 };
 
+//! \brief Caches the probabilities of counterfactual feature values.
+//!
+//! DESCRIPTION:\n
+//! For a given feature the probability of the value with an influencer's
+//! records removed depends only on the influenced value, its weights and
+//! the bucket empty flags. Influencer fields with many values typically
+//! have lots of values which contribute identical statistics to the bucket,
+//! for example a single record, so this memoizes the adjusted probability
+//! keyed by exactly these quantities.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! Keys are compared exactly so this only helps when counterfactual values
+//! repeat exactly. It doesn't help for continuous metric values, where
+//! nearby but distinct values all miss, and the hit and miss counts are
+//! reported in CStatistics so this can be checked. It never changes the
+//! probabilities computed.
+class CCounterfactualProbabilityCache {
+public:
+    //! Lookup the probability of \p value for \p params.
+    bool lookup(const TDouble2Vec1Vec& value,
+                const maths::CModelProbabilityParams& params,
+                double& probability) {
+        m_Key.clear();
+        for (const auto& value_ : value) {
+            m_Key.insert(m_Key.end(), value_.begin(), value_.end());
+        }
+        for (const auto& weights : params.weights()) {
+            for (const auto& weight : weights) {
+                m_Key.insert(m_Key.end(), weight.begin(), weight.end());
+            }
+        }
+        for (const auto& empty : params.bucketEmpty()) {
+            for (bool empty_ : empty) {
+                m_Key.push_back(empty_ ? 1.0 : 0.0);
+            }
+        }
+        auto i = m_Probabilities.find(m_Key);
+        if (i == m_Probabilities.end()) {
+            core::CStatistics::stat(stat_t::E_NumberInfluenceProbabilityCacheMisses).increment();
+            return false;
+        }
+        core::CStatistics::stat(stat_t::E_NumberInfluenceProbabilityCacheHits).increment();
+        probability = i->second;
+        return true;
+    }
+
+    //! Add the probability of the last value looked up.
+    void add(double probability) { m_Probabilities.emplace(m_Key, probability); }
+
+private:
+    using TDoubleVecDoubleUMap = boost::unordered_map<TDoubleVec, double>;
+
+private:
+    //! The key of the last value looked up.
+    TDoubleVec m_Key;
+    //! The probabilities computed so far.
+    TDoubleVecDoubleUMap m_Probabilities;
+};
+
 //! Sets all influences to one.
 //!
 //! \param[in] influencerName The name of the influencer field.
@@ -367,22 +432,27 @@ void doComputeInfluences(model_t::EFeature feature,
 
     double logp = maths::CTools::fastLog(probability);
     maths_t::TDouble2VecWeightsAry1Vec weights(params.weights());
+    maths::CModelProbabilityParams::TBool2Vec1Vec bucketEmpty(params.bucketEmpty());
+    CCounterfactualProbabilityCache cache;
     for (auto i = influencerValues.begin(); i != influencerValues.end(); ++i) {
-        params.weights(weights).updateAnomalyModel(false);
+        params.weights(weights).bucketEmpty(bucketEmpty).updateAnomalyModel(false);
 
         computeInfluencedValue(value, count, i->second.first, i->second.second,
                                params, influencedValue[0]);
 
         double pi;
-        bool conditional;
-        if (!model.probability(params, time, influencedValue, pi, tail,
-                               conditional, mostAnomalousCorrelate)) {
-            LOG_ERROR(<< "Failed to compute P(" << influencedValue[0]
-                      << " | influencer = " << core::CContainerPrinter::print(*i) << ")");
-            continue;
+        if (!cache.lookup(influencedValue, params, pi)) {
+            bool conditional;
+            if (!model.probability(params, time, influencedValue, pi, tail,
+                                   conditional, mostAnomalousCorrelate)) {
+                LOG_ERROR(<< "Failed to compute P(" << influencedValue[0] << " | influencer = "
+                          << core::CContainerPrinter::print(*i) << ")");
+                continue;
+            }
+            pi = maths::CTools::truncate(pi, maths::CTools::smallestProbability(), 1.0);
+            pi = model_t::adjustProbability(feature, elapsedTime, pi);
+            cache.add(pi);
         }
-        pi = maths::CTools::truncate(pi, maths::CTools::smallestProbability(), 1.0);
-        pi = model_t::adjustProbability(feature, elapsedTime, pi);
 
         double influence = computeInfluence(logp, maths::CTools::fastLog(pi));
 
@@ -460,23 +530,30 @@ void doComputeCorrelateInfluences(model_t::EFeature feature,
 
     double logp = std::log(probability);
     maths_t::TDouble2VecWeightsAry1Vec weights(params.weights());
+    maths::CModelProbabilityParams::TBool2Vec1Vec bucketEmpty(params.bucketEmpty());
+    TTime2Vec1Vec times{time};
+    CCounterfactualProbabilityCache cache;
     for (const auto& influence_ : influencerValues) {
-        params.weights(weights).updateAnomalyModel(false);
+        params.weights(weights).bucketEmpty(bucketEmpty).updateAnomalyModel(false);
 
         computeInfluencedValue(value, count, influence_.second.first,
                                influence_.second.second, params, influencedValue[0]);
 
         double pi;
-        bool conditional;
-        if (!model.probability(params, TTime2Vec1Vec{time}, influencedValue, pi,
-                               tail, conditional, mostAnomalousCorrelate)) {
-            LOG_ERROR(<< "Failed to compute P("
-                      << core::CContainerPrinter::print(influencedValue) << " | influencer = "
-                      << core::CContainerPrinter::print(influence_) << ")");
-            continue;
+        if (!cache.lookup(influencedValue, params, pi)) {
+            bool conditional;
+            if (!model.probability(params, times, influencedValue, pi, tail,
+                                   conditional, mostAnomalousCorrelate)) {
+                LOG_ERROR(<< "Failed to compute P("
+                          << core::CContainerPrinter::print(influencedValue)
+                          << " | influencer = " << core::CContainerPrinter::print(influence_)
+                          << ")");
+                continue;
+            }
+            pi = maths::CTools::truncate(pi, maths::CTools::smallestProbability(), 1.0);
+            pi = model_t::adjustProbability(feature, elapsedTime, pi);
+            cache.add(pi);
         }
-        pi = maths::CTools::truncate(pi, maths::CTools::smallestProbability(), 1.0);
-        pi = model_t::adjustProbability(feature, elapsedTime, pi);
 
         double influence = computeInfluence(logp, std::log(pi));
 
@@ -6,15 +6,21 @@
 
 #include <model/CResourceMonitor.h>
 
+#include <core/CMemory.h>
 #include <core/CStatistics.h>
 #include <core/Constants.h>
 
 #include <model/CAnomalyDetector.h>
+#include <model/CAnomalyDetectorModel.h>
 #include <model/CDataGatherer.h>
 #include <model/CStringStore.h>
 
+#include <boost/unordered_set.hpp>
+
 #include <algorithm>
 #include <limits>
+#include <tuple>
+#include <vector>
 
 namespace ml {
 
@@ -24,6 +30,7 @@ namespace model {
 const core_t::TTime CResourceMonitor::MINIMUM_PRUNE_FREQUENCY(60 * 60);
 const std::size_t CResourceMonitor::DEFAULT_MEMORY_LIMIT_MB(4096);
 const double CResourceMonitor::DEFAULT_BYTE_LIMIT_MARGIN(0.7);
+const std::size_t CResourceMonitor::MINIMUM_LAST_SEEN_TO_COMPACT(1024);
 
 CResourceMonitor::CResourceMonitor(double byteLimitMargin)
     : m_AllowAllocations(true), m_ByteLimitMargin{byteLimitMargin},
@@ -31,9 +38,8 @@ CResourceMonitor::CResourceMonitor(double byteLimitMargin)
       m_ExtraMemory(0), m_PreviousTotal(this->totalMemory()), m_Peak(m_PreviousTotal),
       m_LastAllocationFailureReport(0), m_MemoryStatus(model_t::E_MemoryStatusOk),
       m_HasPruningStarted(false), m_PruneThreshold(0), m_LastPruneTime(0),
-      m_PruneWindow(std::numeric_limits<std::size_t>::max()),
-      m_PruneWindowMaximum(std::numeric_limits<std::size_t>::max()),
-      m_PruneWindowMinimum(std::numeric_limits<std::size_t>::max()), m_NoLimit(false) {
+      m_NumberLastSeen(0), m_NumberLastSeenAfterCompaction(0),
+      m_LastSeenMemory(core::CMemory::dynamicSize(m_LastSeen)), m_NoLimit(false) {
     this->updateMemoryLimitsAndPruneThreshold(DEFAULT_MEMORY_LIMIT_MB);
 }
 
@@ -44,6 +50,7 @@ void CResourceMonitor::memoryUsageReporter(const TMemoryUsageReporterFunc& repor
 void CResourceMonitor::registerComponent(CAnomalyDetector& detector) {
     LOG_TRACE(<< "Registering component: " << &detector);
     m_Detectors.emplace(&detector, std::size_t(0));
+    this->indexLastSeen(detector);
 }
 
 void CResourceMonitor::unRegisterComponent(CAnomalyDetector& detector) {
@@ -54,6 +61,7 @@ void CResourceMonitor::unRegisterComponent(CAnomalyDetector& detector) {
     }
 
     LOG_TRACE(<< "Unregistering component: " << &detector);
+    this->forgetLastSeen(detector.model().get());
     m_Detectors.erase(itr);
 }
 
@@ -126,14 +134,12 @@ void CResourceMonitor::updateAllowAllocations() {
 }
 
 bool CResourceMonitor::pruneIfRequired(core_t::TTime endTime) {
-    // The basic idea here is that as the memory usage goes up, we
-    // prune models to bring it down again. If usage declines, we
-    // relax the pruning window to let it go back up again.
+    // The basic idea here is that when the memory usage goes above the
+    // threshold we prune the people and attributes, across all models,
+    // which have gone longest without data until it is below it again.
 
     std::size_t total{this->totalMemory()};
-    bool aboveThreshold = total > m_PruneThreshold;
-
-    if (m_HasPruningStarted == false && !aboveThreshold) {
+    if (total <= m_PruneThreshold) {
         LOG_TRACE(<< "No pruning required. " << total << " / " << m_PruneThreshold);
         return false;
     }
@@ -148,53 +154,237 @@ bool CResourceMonitor::pruneIfRequired(core_t::TTime endTime) {
     }
 
     if (m_HasPruningStarted == false) {
-        // The longest we'll consider keeping priors for is 1M buckets.
-        CAnomalyDetector* detector = m_Detectors.begin()->first;
-        if (detector == nullptr) {
-            return false;
-        }
-        m_PruneWindowMaximum = detector->model()->defaultPruneWindow();
-        m_PruneWindow = m_PruneWindowMaximum;
-        m_PruneWindowMinimum = detector->model()->minimumPruneWindow();
         m_HasPruningStarted = true;
         this->acceptPruningResult();
-        LOG_DEBUG(<< "Pruning started. Window (buckets): " << m_PruneWindow);
+        LOG_DEBUG(<< "Pruning started");
+    }
+
+    // Aim a little below the threshold so we don't prune every bucket.
+    std::size_t pruned{this->pruneLeastRecentlySeen(endTime, (m_PruneThreshold * 49) / 50)};
+    this->updateAllowAllocations();
+
+    LOG_INFO(<< "Pruned " << pruned << " least recently seen people and attributes. Usage "
+             << total << " -> " << this->totalMemory() << " bytes, threshold "
+             << m_PruneThreshold << " bytes");
+
+    m_LastPruneTime = endTime;
+    return true;
+}
+
+void CResourceMonitor::seen(const CAnomalyDetectorModel& model,
+                            EEntity entity,
+                            std::size_t id,
+                            core_t::TTime time) {
+    if (m_NoLimit) {
+        return;
+    }
+    auto index = m_LastSeenModelIndices.find(&model);
+    if (index == m_LastSeenModelIndices.end()) {
+        return;
     }
 
-    if (aboveThreshold) {
-        // Do a prune and see how much we got back
-        // These are the expensive operations
-        std::size_t usageAfter = 0;
-        for (auto& detector : m_Detectors) {
-            const auto& model = detector.first->model();
-            model->prune(m_PruneWindow);
-            detector.second = core::CMemory::dynamicSize(detector.first);
-            usageAfter += detector.second;
+    SLastSeenKey key{time, index->second, entity};
+    auto group = m_LastSeen.lower_bound(key);
+    if (group == m_LastSeen.end() || key < group->first) {
+        group = m_LastSeen.emplace_hint(group, key, TUInt32Vec());
+    } else {
+        m_LastSeenMemory -= lastSeenMemory(group->second);
+    }
+    TUInt32Vec& ids = group->second;
+    ids.push_back(static_cast<uint32_t>(id));
+    m_LastSeenMemory += lastSeenMemory(ids);
+    ++m_NumberLastSeen;
+
+    // The index is accounted as model memory so keep the proportion of
+    // stale entries small.
+    if (m_NumberLastSeen > std::max(m_NumberLastSeenAfterCompaction +
+                                        m_NumberLastSeenAfterCompaction / 4,
+                                    MINIMUM_LAST_SEEN_TO_COMPACT)) {
+        this->compactLastSeen();
+    }
+}
+
+void CResourceMonitor::indexLastSeen(CAnomalyDetector& detector) {
+    const auto& model = detector.model();
+    if (model == nullptr) {
+        return;
+    }
+    this->forgetLastSeen(model.get());
+    m_LastSeenModelIndices.emplace(model.get(), m_LastSeenModels.size());
+    m_LastSeenModels.push_back(model.get());
+
+    const CDataGatherer& gatherer = model->dataGatherer();
+    for (std::size_t pid = 0u; pid < gatherer.numberPeople(); ++pid) {
+        core_t::TTime time{model->personLastBucketTime(pid)};
+        if (CAnomalyDetectorModel::isTimeUnset(time) == false) {
+            this->seen(*model, E_Person, pid, time);
+        }
+    }
+    for (std::size_t cid = 0u; cid < gatherer.numberAttributes(); ++cid) {
+        core_t::TTime time{model->attributeLastBucketTime(cid)};
+        if (CAnomalyDetectorModel::isTimeUnset(time) == false) {
+            this->seen(*model, E_Attribute, cid, time);
         }
-        m_CurrentAnomalyDetectorMemory = usageAfter;
-        total = this->totalMemory();
-        this->updateAllowAllocations();
     }
+}
 
-    LOG_TRACE(<< "Pruning models. Usage: " << total
-              << ". Current window: " << m_PruneWindow << " buckets");
+void CResourceMonitor::forgetLastSeen(TModelCPtr model) {
+    // The model's entries are now stale and will be removed lazily.
+    auto index = m_LastSeenModelIndices.find(model);
+    if (index != m_LastSeenModelIndices.end()) {
+        m_LastSeenModels[index->second] = nullptr;
+        m_LastSeenModelIndices.erase(index);
+    }
+}
 
-    if (total < m_PruneThreshold) {
-        // Expand the window
-        const auto& model = m_Detectors.begin()->first->model();
-        m_PruneWindow = std::min(m_PruneWindow + std::size_t((endTime - m_LastPruneTime) /
-                                                             model->bucketLength()),
-                                 m_PruneWindowMaximum);
-        LOG_TRACE(<< "Expanding window, to " << m_PruneWindow);
-    } else {
-        // Shrink the window
-        m_PruneWindow = std::max(static_cast<std::size_t>(m_PruneWindow * 99 / 100),
-                                 m_PruneWindowMinimum);
-        LOG_TRACE(<< "Shrinking window, to " << m_PruneWindow);
+bool CResourceMonitor::SLastSeenKey::operator<(const SLastSeenKey& rhs) const {
+    return std::tie(s_Time, s_Model, s_Entity) < std::tie(rhs.s_Time, rhs.s_Model, rhs.s_Entity);
+}
+
+bool CResourceMonitor::isLastSeen(const SLastSeenKey& key, uint32_t id) const {
+    TModelCPtr model{m_LastSeenModels[key.s_Model]};
+    if (model == nullptr) {
+        return false;
     }
+    return key.s_Time == (key.s_Entity == E_Person ? model->personLastBucketTime(id)
+                                                   : model->attributeLastBucketTime(id));
+}
 
-    m_LastPruneTime = endTime;
-    return aboveThreshold;
+void CResourceMonitor::compactLastSeen() {
+    m_NumberLastSeen = 0;
+    for (auto group = m_LastSeen.begin(); group != m_LastSeen.end(); /**/) {
+        const SLastSeenKey& key = group->first;
+        TUInt32Vec& ids = group->second;
+        ids.erase(std::remove_if(ids.begin(), ids.end(),
+                                 [this, &key](uint32_t id) {
+                                     return this->isLastSeen(key, id) == false;
+                                 }),
+                  ids.end());
+        if (ids.empty()) {
+            group = m_LastSeen.erase(group);
+        } else {
+            ids.shrink_to_fit();
+            m_NumberLastSeen += ids.size();
+            ++group;
+        }
+    }
+    m_NumberLastSeenAfterCompaction = m_NumberLastSeen;
+    this->refreshLastSeenMemory();
+}
+
+void CResourceMonitor::refreshLastSeenMemory() {
+    m_LastSeenMemory = core::CMemory::dynamicSize(m_LastSeen);
+}
+
+std::size_t CResourceMonitor::lastSeenMemory(const TUInt32Vec& ids) {
+    // This matches the memory CMemory::dynamicSize reports for a map node.
+    return sizeof(SLastSeenKey) + sizeof(TUInt32Vec) + 4 * sizeof(std::size_t) +
+           core::CMemory::dynamicSize(ids);
+}
+
+std::size_t CResourceMonitor::pruneLeastRecentlySeen(core_t::TTime endTime, std::size_t target) {
+    using TSizeVec = std::vector<std::size_t>;
+    using TSizeVecSizeVecPr = std::pair<TSizeVec, TSizeVec>;
+    using TModelCPtrSizeVecSizeVecPrUMap = boost::unordered_map<TModelCPtr, TSizeVecSizeVecPr>;
+
+    auto minimumAge = [](TModelCPtr model) {
+        return static_cast<core_t::TTime>(model->minimumPruneWindow()) * model->bucketLength();
+    };
+
+    boost::unordered_map<TModelCPtr, CAnomalyDetector*> detectors;
+    core_t::TTime minimumAgeAllModels{std::numeric_limits<core_t::TTime>::max()};
+    for (const auto& detector : m_Detectors) {
+        TModelCPtr model{detector.first->model().get()};
+        detectors.emplace(model, detector.first);
+        if (model != nullptr) {
+            minimumAgeAllModels = std::min(minimumAgeAllModels, minimumAge(model));
+        }
+    }
+
+    // The usage we track for a detector can be out of date, for example its
+    // data gatherer releases memory after the detector has been sampled, so
+    // we measure each detector we reach before we decide what to prune.
+    boost::unordered_set<TModelCPtr> measured;
+
+    std::size_t result{0};
+
+    for (std::size_t total = this->totalMemory(); total > target;
+         total = this->totalMemory()) {
+
+        // We don't know exactly how much memory each person and attribute
+        // uses without recomputing the memory usage of their models, which
+        // is expensive, so we estimate it from the average and check the
+        // actual usage once we've pruned enough.
+        std::size_t average{m_CurrentAnomalyDetectorMemory /
+                            std::max(m_NumberLastSeen, std::size_t(1))};
+
+        TModelCPtrSizeVecSizeVecPrUMap toPrune;
+        std::size_t estimate{0};
+
+        auto group = m_LastSeen.begin();
+        while (total > target + estimate && group != m_LastSeen.end()) {
+            const SLastSeenKey& key = group->first;
+            TUInt32Vec& ids = group->second;
+            if (ids.empty()) {
+                m_LastSeenMemory -= lastSeenMemory(ids);
+                group = m_LastSeen.erase(group);
+                continue;
+            }
+
+            TModelCPtr model{m_LastSeenModels[key.s_Model]};
+            if (measured.insert(model).second) {
+                auto detector = detectors.find(model);
+                if (detector != detectors.end()) {
+                    this->memUsage(detector->second);
+                    total = this->totalMemory();
+                    continue;
+                }
+            }
+            if (endTime - key.s_Time <= minimumAgeAllModels) {
+                // Everything else is too recent to prune from any model.
+                break;
+            }
+            if (model != nullptr && endTime - key.s_Time <= minimumAge(model)) {
+                // Other models may have shorter prune windows.
+                ++group;
+                continue;
+            }
+            uint32_t oldest{ids.back()};
+            ids.pop_back();
+            --m_NumberLastSeen;
+
+            if (this->isLastSeen(key, oldest)) {
+                auto& modelToPrune = toPrune[model];
+                (key.s_Entity == E_Person ? modelToPrune.first : modelToPrune.second)
+                    .push_back(oldest);
+                estimate += average;
+            }
+        }
+
+        if (toPrune.empty()) {
+            break;
+        }
+
+        for (auto& model : toPrune) {
+            auto detector = detectors.find(model.first);
+            if (detector == detectors.end()) {
+                LOG_ERROR(<< "Inconsistency - model has not been registered: " << model.first);
+                continue;
+            }
+            TSizeVec& people = model.second.first;
+            TSizeVec& attributes = model.second.second;
+            std::sort(people.begin(), people.end());
+            people.erase(std::unique(people.begin(), people.end()), people.end());
+            std::sort(attributes.begin(), attributes.end());
+            attributes.erase(std::unique(attributes.begin(), attributes.end()),
+                             attributes.end());
+            detector->second->model()->prunePeopleAndAttributes(people, attributes);
+            result += people.size() + attributes.size();
+            this->memUsage(detector->second);
+        }
+    }
+
+    return result;
 }
 
 bool CResourceMonitor::areAllocationsAllowed() const {
@@ -325,7 +515,7 @@ std::size_t CResourceMonitor::lowLimit() const {
 }
 
 std::size_t CResourceMonitor::totalMemory() const {
-    return m_CurrentAnomalyDetectorMemory + m_ExtraMemory +
+    return m_CurrentAnomalyDetectorMemory + m_ExtraMemory + m_LastSeenMemory +
            CStringStore::names().memoryUsage() +
            CStringStore::influencers().memoryUsage();
 }
@@ -14,6 +14,8 @@
 
 #include <boost/bind.hpp>
 
+#include <limits>
+
 namespace ml {
 namespace model {
 
@@ -22,11 +24,17 @@ namespace {
 //! \brief Helper class to hash a std::string.
 struct SStrHash {
     std::size_t operator()(const std::string& key) const {
-        boost::hash<std::string> hasher;
+        core::CHashing::CWyHashString hasher;
         return hasher(key);
     }
 } STR_HASH;
 
+//! \brief Helper class to supply a hash which has already been computed.
+struct SPrecomputedHash {
+    std::size_t operator()(const std::string& /*key*/) const { return s_Hash; }
+    std::size_t s_Hash;
+};
+
 //! \brief Helper class to compare a std::string and a CStoredStringPtr.
 struct SStrStoredStringPtrEqual {
     bool operator()(const std::string& lhs, const core::CStoredStringPtr& rhs) const {
@@ -34,6 +42,26 @@ struct SStrStoredStringPtrEqual {
     }
 } STR_EQUAL;
 
+//! Free the buckets of \p strings if it is empty.
+//!
+//! This means that the sets of empty shards never have any memory allocated,
+//! which is relied on by setMemoryUsage.
+template<typename SET>
+void releaseIfEmpty(SET& strings) {
+    if (strings.empty()) {
+        SET empty;
+        empty.swap(strings);
+    }
+}
+
+//! Get the memory used by \p strings excluding the strings themselves.
+template<typename SET>
+std::size_t setMemoryUsage(const SET& strings) {
+    // A default constructed set doesn't allocate its buckets until the first
+    // insertion, but bucket_count() is still non-zero, so don't count these.
+    return strings.empty() ? 0 : core::CMemory::dynamicSize(strings);
+}
+
 // To ensure the singletons are constructed before multiple threads may
 // require them call instance() during the static initialisation phase
 // of the program.  Of course, the instance may already be constructed
@@ -63,89 +91,58 @@ const core::CStoredStringPtr& CStringStore::getEmpty() const {
 
 core::CStoredStringPtr CStringStore::get(const std::string& value) {
     // This section is expected to be performed frequently.
-    //
-    // We ensure either:
-    //   1) Some threads may perform an insert and no thread will perform
-    //      a find until no threads can still perform an insert.
-    //   2) Some threads may perform a find and no thread will perform
-    //      an insert until no thread can still perform a find.
-    //
-    // We "leak" strings if there is contention between reading and writing,
-    // which is expected to be rare because inserts are expected to be rare.
 
     if (value.empty()) {
         return m_EmptyString;
     }
 
-    core::CStoredStringPtr result;
-
-    m_Reading.fetch_add(1, std::memory_order_release);
-    if (m_Writing.load(std::memory_order_consume) == 0) {
-        auto i = m_Strings.find(value, STR_HASH, STR_EQUAL);
-        if (i != m_Strings.end()) {
-            result = *i;
-            m_Reading.fetch_sub(1, std::memory_order_release);
-        } else {
-            m_Writing.fetch_add(1, std::memory_order_acq_rel);
-            // NB: fetch_sub() returns the OLD value, and we know we added 1 in
-            // this thread, hence the test for 1 rather than 0
-            if (m_Reading.fetch_sub(1, std::memory_order_release) == 1) {
-                // This section is expected to occur infrequently so inserts
-                // are synchronized with a mutex.
-                core::CScopedFastLock lock(m_Mutex);
-                auto ret = m_Strings.insert(core::CStoredStringPtr::makeStoredString(value));
-                result = *ret.first;
-                if (ret.second) {
-                    m_StoredStringsMemUse += result.actualMemoryUsage();
-                }
-                m_Writing.fetch_sub(1, std::memory_order_release);
-            } else {
-                m_Writing.fetch_sub(1, std::memory_order_relaxed);
-                // This is leaked in the sense that it will never be shared and
-                // won't count towards our reported memory usage.  But it is not
-                // leaked in the traditional sense of the word, as its memory
-                // will be freed when the single user is finished with it.
-                result = core::CStoredStringPtr::makeStoredString(value);
-            }
-        }
-    } else {
-        m_Reading.fetch_sub(1, std::memory_order_relaxed);
-        // This is leaked in the sense that it will never be shared and won't
-        // count towards our reported memory usage.  But it is not leaked
-        // in the traditional sense of the word, as its memory will be freed
-        // when the single user is finished with it.
-        result = core::CStoredStringPtr::makeStoredString(value);
-    }
+    std::size_t hash = STR_HASH(value);
+    SShard& shard = this->shard(hash);
 
+    core::CScopedFastLock lock(shard.s_Mutex);
+    auto i = shard.s_Strings.find(value, SPrecomputedHash{hash}, STR_EQUAL);
+    if (i != shard.s_Strings.end()) {
+        return *i;
+    }
+    core::CStoredStringPtr result = core::CStoredStringPtr::makeStoredString(value);
+    shard.s_Strings.insert(result);
+    shard.s_StoredStringsMemUse += result.actualMemoryUsage();
     return result;
 }
 
 void CStringStore::remove(const std::string& value) {
-    core::CScopedFastLock lock(m_Mutex);
-    m_Removed.push_back(value);
+    SShard& shard = this->shard(STR_HASH(value));
+    core::CScopedFastLock lock(shard.s_Mutex);
+    shard.s_Removed.push_back(value);
 }
 
 void CStringStore::pruneRemovedNotThreadSafe() {
-    core::CScopedFastLock lock(m_Mutex);
-    for (const auto& removed : m_Removed) {
-        auto i = m_Strings.find(removed, STR_HASH, STR_EQUAL);
-        if (i != m_Strings.end() && i->isUnique()) {
-            m_StoredStringsMemUse -= i->actualMemoryUsage();
-            m_Strings.erase(i);
+    for (auto& shard : m_Shards) {
+        core::CScopedFastLock lock(shard.s_Mutex);
+        for (const auto& removed : shard.s_Removed) {
+            auto i = shard.s_Strings.find(removed, STR_HASH, STR_EQUAL);
+            if (i != shard.s_Strings.end() && i->isUnique()) {
+                shard.s_StoredStringsMemUse -= i->actualMemoryUsage();
+                shard.s_Strings.erase(i);
+            }
         }
+        shard.s_Removed.clear();
+        releaseIfEmpty(shard.s_Strings);
     }
-    m_Removed.clear();
 }
 
 void CStringStore::pruneNotThreadSafe() {
-    core::CScopedFastLock lock(m_Mutex);
-    for (auto i = m_Strings.begin(); i != m_Strings.end(); /**/) {
-        if (i->isUnique()) {
-            m_StoredStringsMemUse -= i->actualMemoryUsage();
-            i = m_Strings.erase(i);
-        } else {
-            ++i;
+    for (auto& shard : m_Shards) {
+        core::CScopedFastLock lock(shard.s_Mutex);
+        for (auto i = shard.s_Strings.begin(); i != shard.s_Strings.end(); /**/) {
+            if (i->isUnique()) {
+                shard.s_StoredStringsMemUse -= i->actualMemoryUsage();
+                i = shard.s_Strings.erase(i);
+            } else {
+                ++i;
+            }
         }
+        releaseIfEmpty(shard.s_Strings);
     }
 }
 
@@ -155,43 +152,69 @@ void CStringStore::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) con
                      : (this == &CStringStore::influencers() ? "influencers StringStore"
                                                              : "unknown StringStore"));
     mem->addItem("empty string ptr", m_EmptyString.actualMemoryUsage());
-    core::CScopedFastLock lock(m_Mutex);
-    core::CMemoryDebug::dynamicSize("stored strings", m_Strings, mem);
-    core::CMemoryDebug::dynamicSize("removed strings", m_Removed, mem);
-    mem->addItem("stored string ptr memory", m_StoredStringsMemUse);
+    std::size_t storedStringsMemUse = 0;
+    std::size_t removedStringsMemUse = 0;
+    std::size_t storedStringPtrsMemUse = 0;
+    for (const auto& shard : m_Shards) {
+        core::CScopedFastLock lock(shard.s_Mutex);
+        storedStringsMemUse += setMemoryUsage(shard.s_Strings);
+        removedStringsMemUse += core::CMemory::dynamicSize(shard.s_Removed);
+        storedStringPtrsMemUse += shard.s_StoredStringsMemUse;
+    }
+    mem->addItem("stored strings", storedStringsMemUse);
+    mem->addItem("removed strings", removedStringsMemUse);
+    mem->addItem("stored string ptr memory", storedStringPtrsMemUse);
 }
 
 std::size_t CStringStore::memoryUsage() const {
     std::size_t mem = m_EmptyString.actualMemoryUsage();
-    core::CScopedFastLock lock(m_Mutex);
-    // The assumption here is that the existence of
-    // core::CStoredStringPtr::dynamicSizeAlwaysZero() combined with dead code
-    // elimination will make calculating the size of m_Strings boil down to a
-    // couple of simple multiplications and additions
-    mem += core::CMemory::dynamicSize(m_Strings);
-    // This one could be more expensive, but the assumption is that there won't
-    // be many memory usage calculations while m_Removed is populated
-    mem += core::CMemory::dynamicSize(m_Removed);
-    // This adds back the size that was excluded from
-    // core::CMemory::dynamicSize(m_Strings)
-    mem += m_StoredStringsMemUse;
+    for (const auto& shard : m_Shards) {
+        core::CScopedFastLock lock(shard.s_Mutex);
+        // The assumption here is that the existence of
+        // core::CStoredStringPtr::dynamicSizeAlwaysZero() combined with dead
+        // code elimination will make calculating the size of the strings
+        // boil down to a couple of simple multiplications and additions
+        mem += setMemoryUsage(shard.s_Strings);
+        // This one could be more expensive, but the assumption is that there
+        // won't be many memory usage calculations while strings are waiting
+        // to be removed
+        mem += core::CMemory::dynamicSize(shard.s_Removed);
+        // This adds back the size that was excluded from the dynamic size of
+        // the strings
+        mem += shard.s_StoredStringsMemUse;
+    }
     return mem;
 }
 
 CStringStore::CStringStore()
-    : m_Reading(0), m_Writing(0),
-      m_EmptyString(core::CStoredStringPtr::makeStoredString(std::string())),
-      m_StoredStringsMemUse(0) {
+    : m_EmptyString(core::CStoredStringPtr::makeStoredString(std::string())) {
+}
+
+CStringStore::SShard& CStringStore::shard(std::size_t hash) {
+    // Use the most significant bits of the hash since the least significant
+    // bits select the bucket in each shard's set.
+    return m_Shards[hash >> (std::numeric_limits<std::size_t>::digits - SHARD_BITS)];
+}
+
+std::size_t CStringStore::size() const {
+    std::size_t result = 0;
+    for (const auto& shard : m_Shards) {
+        core::CScopedFastLock lock(shard.s_Mutex);
+        result += shard.s_Strings.size();
+    }
+    return result;
 }
 
 void CStringStore::clearEverythingTestOnly() {
     // For tests that assert on memory usage it's important that these
     // containers get returned to the state of a default constructed container
-    TStoredStringPtrUSet emptySet;
-    emptySet.swap(m_Strings);
-    TStrVec emptyVec;
-    emptyVec.swap(m_Removed);
-    m_StoredStringsMemUse = 0;
+    for (auto& shard : m_Shards) {
+        TStoredStringPtrUSet emptySet;
+        emptySet.swap(shard.s_Strings);
+        TStrVec emptyVec;
+        emptyVec.swap(shard.s_Removed);
+        shard.s_StoredStringsMemUse = 0;
+    }
 }
 
 } // model
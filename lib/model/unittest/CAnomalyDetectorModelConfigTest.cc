@@ -76,6 +76,16 @@ void CAnomalyDetectorModelConfigTest::testNormal() {
                              config.factory(1, POPULATION_COUNT)->componentSize());
         CPPUNIT_ASSERT_EQUAL(std::size_t(10),
                              config.factory(1, POPULATION_METRIC)->componentSize());
+        CPPUNIT_ASSERT_EQUAL(
+            std::size_t(48), config.factory(1, INDIVIDUAL_COUNT)->modelParams().s_ModelHibernationAge);
+        CPPUNIT_ASSERT_EQUAL(
+            std::size_t(48), config.factory(1, INDIVIDUAL_METRIC)->modelParams().s_ModelHibernationAge);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(500), config.factory(1, INDIVIDUAL_COUNT)
+                                                   ->modelParams()
+                                                   .s_MaximumNumberActiveChangeDetectors);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(500), config.factory(1, POPULATION_METRIC)
+                                                   ->modelParams()
+                                                   .s_MaximumNumberActiveChangeDetectors);
         CPPUNIT_ASSERT_EQUAL(std::size_t(20),
                              config.factory(1, INDIVIDUAL_COUNT)->modelParams().s_SampleCountFactor);
         CPPUNIT_ASSERT_EQUAL(std::size_t(20),
@@ -84,6 +94,10 @@ void CAnomalyDetectorModelConfigTest::testNormal() {
                              config.factory(1, POPULATION_COUNT)->modelParams().s_SampleCountFactor);
         CPPUNIT_ASSERT_EQUAL(std::size_t(20),
                              config.factory(1, POPULATION_METRIC)->modelParams().s_SampleCountFactor);
+        CPPUNIT_ASSERT_EQUAL(model_t::E_InfoContentSketch, config.infoContentEstimator());
+        CPPUNIT_ASSERT_EQUAL(
+            model_t::E_InfoContentSketch,
+            config.factory(1, INDIVIDUAL_COUNT)->modelParams().s_InfoContentEstimator);
         TDoubleVec params;
         for (std::size_t i = 0u; i < model_t::NUMBER_AGGREGATION_STYLES; ++i) {
             for (std::size_t j = 0u; j < model_t::NUMBER_AGGREGATION_PARAMS; ++j) {
@@ -227,6 +241,13 @@ void CAnomalyDetectorModelConfigTest::testErrors() {
         CPPUNIT_ASSERT_EQUAL(
             config2.factory(1, POPULATION_METRIC)->modelParams().s_SampleCountFactor,
             config1.factory(1, POPULATION_METRIC)->modelParams().s_SampleCountFactor);
+        CPPUNIT_ASSERT_EQUAL(config2.factory(1, INDIVIDUAL_COUNT)
+                                 ->modelParams()
+                                 .s_MaximumNumberActiveChangeDetectors,
+                             config1.factory(1, INDIVIDUAL_COUNT)
+                                 ->modelParams()
+                                 .s_MaximumNumberActiveChangeDetectors);
+        CPPUNIT_ASSERT_EQUAL(config2.infoContentEstimator(), config1.infoContentEstimator());
         for (std::size_t i = 0u; i < model_t::NUMBER_AGGREGATION_STYLES; ++i) {
             for (std::size_t j = 0u; j < model_t::NUMBER_AGGREGATION_PARAMS; ++j) {
                 CPPUNIT_ASSERT_EQUAL(config2.aggregationStyleParam(
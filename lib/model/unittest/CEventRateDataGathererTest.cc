@@ -13,7 +13,10 @@
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
 #include <core/CRegex.h>
+#include <core/CStopWatch.h>
+#include <core/CStringUtils.h>
 
+#include <maths/CBasicStatistics.h>
 #include <maths/COrderings.h>
 
 #include <model/CDataGatherer.h>
@@ -25,8 +28,11 @@
 #include <model/CStringStore.h>
 #include <model/ModelTypes.h>
 
+#include <test/CRandomNumbers.h>
+
 #include <boost/range.hpp>
 
+#include <cmath>
 #include <utility>
 #include <vector>
 
@@ -2327,6 +2333,218 @@ void CEventRateDataGathererTest::testDiurnalFeatures() {
     }
 }
 
+void CEventRateDataGathererTest::testFeatureDataPerformance() {
+    // Time extracting the feature data at the end of each bucket for a
+    // high cardinality count job with several features. The feature data
+    // collection is reused between buckets as the models do.
+
+    const core_t::TTime bucketLength(600);
+    const core_t::TTime startTime(0);
+    const std::size_t numberPeople(20000);
+    const std::size_t numberBuckets(20);
+    const std::size_t repeats(10);
+
+    SModelParams params(bucketLength);
+    TFeatureVec features{model_t::E_IndividualCountByBucketAndPerson,
+                         model_t::E_IndividualNonZeroCountByBucketAndPerson,
+                         model_t::E_IndividualIndicatorOfBucketPerson};
+    CDataGatherer gatherer(model_t::E_EventRate, model_t::E_None, params,
+                           EMPTY_STRING, EMPTY_STRING, EMPTY_STRING, EMPTY_STRING,
+                           EMPTY_STRING, {}, key, features, startTime, 0);
+
+    TStrVec people;
+    people.reserve(numberPeople);
+    for (std::size_t i = 0u; i < numberPeople; ++i) {
+        people.push_back("p" + core::CStringUtils::typeToString(i));
+        addPerson(gatherer, m_ResourceMonitor, people.back());
+    }
+
+    uint64_t elapsed{0};
+    TFeatureSizeFeatureDataPrVecPrVec featureData;
+    for (std::size_t bucket = 0u; bucket < numberBuckets; ++bucket) {
+        core_t::TTime time{startTime + static_cast<core_t::TTime>(bucket) * bucketLength};
+        for (std::size_t i = 0u; i < numberPeople; i += 1 + (bucket % 3)) {
+            addArrival(gatherer, m_ResourceMonitor, time + 1, people[i]);
+        }
+
+        core::CStopWatch stopWatch(true);
+        for (std::size_t i = 0u; i < repeats; ++i) {
+            CPPUNIT_ASSERT(gatherer.featureData(time, bucketLength, featureData));
+        }
+        elapsed += stopWatch.stop();
+
+        CPPUNIT_ASSERT_EQUAL(features.size(), featureData.size());
+        std::size_t expectedNonZero{(numberPeople + bucket % 3) / (1 + bucket % 3)};
+        CPPUNIT_ASSERT_EQUAL(numberPeople, featureData[0].second.size());
+        CPPUNIT_ASSERT_EQUAL(expectedNonZero, featureData[1].second.size());
+        CPPUNIT_ASSERT_EQUAL(expectedNonZero, featureData[2].second.size());
+        for (std::size_t i = 0u; i < expectedNonZero; ++i) {
+            std::size_t pid{i * (1 + bucket % 3)};
+            CPPUNIT_ASSERT_EQUAL(pid, featureData[1].second[i].first);
+            CPPUNIT_ASSERT_EQUAL(uint64_t(1), featureData[1].second[i].second.s_Count);
+            CPPUNIT_ASSERT_EQUAL(uint64_t(1), featureData[0].second[pid].second.s_Count);
+        }
+
+        gatherer.timeNow(time + bucketLength);
+    }
+
+    LOG_DEBUG(<< "Mean time to extract features for " << numberPeople << " people = "
+              << static_cast<double>(elapsed) / static_cast<double>(numberBuckets * repeats)
+              << "ms");
+}
+
+void CEventRateDataGathererTest::testStreamingInfoContent() {
+    // Check the streaming info_content estimator agrees with deflate, gives
+    // the same result when its sketches are recreated after restore and
+    // compare the cost of the two estimators.
+
+    using TStoredStringPtrVec = std::vector<core::CStoredStringPtr>;
+    using TMeanAccumulator = maths::CBasicStatistics::SSampleMean<double>::TAccumulator;
+
+    test::CRandomNumbers rng;
+
+    {
+        // Sketches maintained on insert match sketches computed on demand.
+        TStrVec values;
+        rng.generateWords(16, 200, values);
+
+        CUniqueStringFeatureData streaming;
+        CUniqueStringFeatureData onDemand;
+        TStoredStringPtrVec influencers(1);
+        for (std::size_t i = 0u; i < values.size(); ++i) {
+            influencers[0] = CStringStore::influencers().get("inf" +
+                                                             core::CStringUtils::typeToString(i % 3));
+            streaming.insert(values[i], influencers, true);
+            streaming.insert(values[i / 2], influencers, true);
+            onDemand.insert(values[i], influencers);
+            onDemand.insert(values[i / 2], influencers);
+        }
+
+        SEventRateFeatureData streamingData(0);
+        SEventRateFeatureData onDemandData(0);
+        SEventRateFeatureData deflateData(0);
+        streaming.populateInfoContentFeatureData(streamingData, model_t::E_InfoContentSketch);
+        onDemand.populateInfoContentFeatureData(onDemandData, model_t::E_InfoContentSketch);
+        onDemand.populateInfoContentFeatureData(deflateData, model_t::E_InfoContentDeflate);
+        for (auto data : {&streamingData, &onDemandData, &deflateData}) {
+            std::sort(data->s_InfluenceValues[0].begin(), data->s_InfluenceValues[0].end(),
+                      maths::COrderings::SFirstLess());
+        }
+        LOG_DEBUG(<< "streaming = " << streamingData.print());
+        LOG_DEBUG(<< "deflate   = " << deflateData.print());
+
+        CPPUNIT_ASSERT_EQUAL(onDemandData.print(), streamingData.print());
+        CPPUNIT_ASSERT(std::fabs(std::log(static_cast<double>(streamingData.s_Count) /
+                                          static_cast<double>(deflateData.s_Count))) < 0.2);
+        for (std::size_t i = 0u; i < 3; ++i) {
+            double estimate{streamingData.s_InfluenceValues[0][i].second.first[0]};
+            double actual{deflateData.s_InfluenceValues[0][i].second.first[0]};
+            CPPUNIT_ASSERT(std::fabs(std::log(estimate / actual)) < 0.2);
+        }
+    }
+
+    const core_t::TTime bucketLength(600);
+    const core_t::TTime startTime(0);
+    const std::size_t numberPeople(20);
+    const std::size_t numberBuckets(20);
+    const std::size_t arrivalsPerBucket(2000);
+
+    SModelParams deflateParams(bucketLength);
+    SModelParams sketchParams(bucketLength);
+    sketchParams.s_InfoContentEstimator = model_t::E_InfoContentSketch;
+    TFeatureVec features{model_t::E_IndividualInfoContentByBucketAndPerson};
+    CDataGatherer deflate(model_t::E_EventRate, model_t::E_None, deflateParams,
+                          EMPTY_STRING, EMPTY_STRING, "P", EMPTY_STRING, "V",
+                          {"INF"}, key, features, startTime, 0);
+    CDataGatherer sketch(model_t::E_EventRate, model_t::E_None, sketchParams,
+                         EMPTY_STRING, EMPTY_STRING, "P", EMPTY_STRING, "V",
+                         {"INF"}, key, features, startTime, 0);
+
+    TStrVec people;
+    for (std::size_t i = 0u; i < numberPeople; ++i) {
+        people.push_back("p" + core::CStringUtils::typeToString(i));
+        addPerson(deflate, m_ResourceMonitor, people.back(), "v", 1);
+        addPerson(sketch, m_ResourceMonitor, people.back(), "v", 1);
+    }
+    TStrVec influencers{"inf1", "inf2", "inf3", "inf4"};
+
+    uint64_t deflateTime{0};
+    uint64_t sketchTime{0};
+    TMeanAccumulator error;
+    TFeatureSizeFeatureDataPrVecPrVec deflateData;
+    TFeatureSizeFeatureDataPrVecPrVec sketchData;
+    TSizeVec indices;
+    TStrVec values;
+    for (std::size_t bucket = 0u; bucket < numberBuckets; ++bucket) {
+        core_t::TTime time{startTime + static_cast<core_t::TTime>(bucket) * bucketLength};
+
+        rng.generateUniformSamples(0, numberPeople, arrivalsPerBucket, indices);
+        rng.generateWords(12, arrivalsPerBucket, values);
+        for (std::size_t i = arrivalsPerBucket; i > 0; --i) {
+            // Repeat some values so not every arrival is distinct.
+            values[i - 1] = values[(i - 1) / 2];
+        }
+
+        core::CStopWatch deflateWatch(true);
+        for (std::size_t i = 0u; i < arrivalsPerBucket; ++i) {
+            addArrival(deflate, m_ResourceMonitor, time + 1, people[indices[i]],
+                       values[i], influencers[i % influencers.size()]);
+        }
+        CPPUNIT_ASSERT(deflate.featureData(time, bucketLength, deflateData));
+        deflateTime += deflateWatch.stop();
+
+        core::CStopWatch sketchWatch(true);
+        for (std::size_t i = 0u; i < arrivalsPerBucket; ++i) {
+            addArrival(sketch, m_ResourceMonitor, time + 1, people[indices[i]],
+                       values[i], influencers[i % influencers.size()]);
+        }
+        CPPUNIT_ASSERT(sketch.featureData(time, bucketLength, sketchData));
+        sketchTime += sketchWatch.stop();
+
+        CPPUNIT_ASSERT_EQUAL(deflateData[0].second.size(), sketchData[0].second.size());
+        for (std::size_t i = 0u; i < deflateData[0].second.size(); ++i) {
+            double actual{static_cast<double>(deflateData[0].second[i].second.s_Count)};
+            double estimate{static_cast<double>(sketchData[0].second[i].second.s_Count)};
+            error.add(std::fabs(std::log(estimate / actual)));
+        }
+
+        if (bucket == numberBuckets / 2) {
+            // The sketches are recreated after restore and should give the
+            // same values.
+            std::string origXml;
+            {
+                core::CRapidXmlStatePersistInserter inserter("root");
+                sketch.acceptPersistInserter(inserter);
+                inserter.toXml(origXml);
+            }
+            core::CRapidXmlParser parser;
+            CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(origXml));
+            core::CRapidXmlStateRestoreTraverser traverser(parser);
+            CDataGatherer restored(model_t::E_EventRate, model_t::E_None, sketchParams,
+                                   EMPTY_STRING, EMPTY_STRING, "P", EMPTY_STRING, "V",
+                                   {"INF"}, key, traverser);
+            TFeatureSizeFeatureDataPrVecPrVec restoredData;
+            CPPUNIT_ASSERT(restored.featureData(time, bucketLength, restoredData));
+            for (auto data : {&sketchData, &restoredData}) {
+                for (auto& person : (*data)[0].second) {
+                    std::sort(person.second.s_InfluenceValues[0].begin(),
+                              person.second.s_InfluenceValues[0].end(),
+                              maths::COrderings::SFirstLess());
+                }
+            }
+            CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(sketchData),
+                                 core::CContainerPrinter::print(restoredData));
+        }
+
+        deflate.timeNow(time + bucketLength);
+        sketch.timeNow(time + bucketLength);
+    }
+
+    LOG_DEBUG(<< "mean log error = " << maths::CBasicStatistics::mean(error));
+    LOG_DEBUG(<< "deflate time = " << deflateTime << "ms, sketch time = " << sketchTime << "ms");
+    CPPUNIT_ASSERT(maths::CBasicStatistics::mean(error) < 0.15);
+}
+
 CppUnit::Test* CEventRateDataGathererTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CEventRateDataGathererTest");
 
@@ -2372,5 +2590,11 @@ CppUnit::Test* CEventRateDataGathererTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CEventRateDataGathererTest>(
         "CEventRateDataGathererTest::testDiurnalFeatures",
         &CEventRateDataGathererTest::testDiurnalFeatures));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CEventRateDataGathererTest>(
+        "CEventRateDataGathererTest::testFeatureDataPerformance",
+        &CEventRateDataGathererTest::testFeatureDataPerformance));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CEventRateDataGathererTest>(
+        "CEventRateDataGathererTest::testStreamingInfoContent",
+        &CEventRateDataGathererTest::testStreamingInfoContent));
     return suiteOfTests;
 }
@@ -27,6 +27,8 @@ public:
     void testDistinctStrings();
     void testLatencyPersist();
     void testDiurnalFeatures();
+    void testFeatureDataPerformance();
+    void testStreamingInfoContent();
 
     static CppUnit::Test* suite();
 
@@ -7,10 +7,14 @@
 #include "CEventRateModelTest.h"
 
 #include <core/CContainerPrinter.h>
+#include <core/CParallel.h>
 #include <core/CRapidXmlParser.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
 #include <core/CSmallVector.h>
+#include <core/CStaticThreadPool.h>
+#include <core/CStatistics.h>
+#include <core/CStringUtils.h>
 #include <core/Constants.h>
 #include <core/CoreTypes.h>
 
@@ -33,11 +37,13 @@
 #include <model/CEventRatePopulationModelFactory.h>
 #include <model/CInterimBucketCorrector.h>
 #include <model/CModelDetailsView.h>
+#include <model/CModelSpillStore.h>
 #include <model/CPartitioningFields.h>
 #include <model/CResourceMonitor.h>
 #include <model/CRuleCondition.h>
 
 #include <test/CRandomNumbers.h>
+#include <test/CTestTmpDir.h>
 
 #include <boost/bind.hpp>
 #include <boost/foreach.hpp>
@@ -59,6 +65,7 @@ using TDoubleVecVec = std::vector<TDoubleVec>;
 using TDoubleDoublePr = std::pair<double, double>;
 using TDoubleDoublePrVec = std::vector<TDoubleDoublePr>;
 using TUInt64Vec = std::vector<uint64_t>;
+using TUIntVec = std::vector<unsigned int>;
 using TTimeVec = std::vector<core_t::TTime>;
 using TSizeVec = std::vector<std::size_t>;
 using TSizeVecVec = std::vector<TSizeVec>;
@@ -2116,6 +2123,276 @@ void CEventRateModelTest::testSkipSampling() {
     CPPUNIT_ASSERT_EQUAL(std::size_t(1), gathererWithGap->numberActivePeople());
 }
 
+void CEventRateModelTest::testHibernation() {
+    // Check that hibernating the models of inactive people doesn't
+    // materially affect the results, reduces memory and is transparent
+    // to persistence. Also check that paging hibernating state out to
+    // a spill store doesn't affect the results at all.
+
+    core_t::TTime startTime(0);
+    core_t::TTime bucketLength(100);
+    std::size_t numberPeople(10);
+    std::size_t numberBuckets(300);
+
+    test::CRandomNumbers rng;
+
+    SModelParams params(bucketLength);
+    model_t::TFeatureVec features{model_t::E_IndividualNonZeroCountByBucketAndPerson};
+    CModelFactory::TDataGathererPtr gathererAwake;
+    CModelFactory::TModelPtr modelAwake_;
+    this->makeModel(params, features, startTime, numberPeople, gathererAwake, modelAwake_);
+    CEventRateModel* modelAwake = dynamic_cast<CEventRateModel*>(modelAwake_.get());
+
+    // The models reference their factory's parameters so keep the
+    // factories alive.
+    TEventRateModelFactoryPtr factoryAwake{m_Factory};
+    m_Factory.reset();
+    params.s_ModelHibernationAge = 5;
+    CModelFactory::TDataGathererPtr gathererHibernating;
+    CModelFactory::TModelPtr modelHibernating_;
+    this->makeModel(params, features, startTime, numberPeople, gathererHibernating,
+                    modelHibernating_);
+    CEventRateModel* modelHibernating =
+        dynamic_cast<CEventRateModel*>(modelHibernating_.get());
+
+    TEventRateModelFactoryPtr factoryHibernating{m_Factory};
+    m_Factory.reset();
+    params.s_ModelSpillStore =
+        std::make_shared<CModelSpillStore>(test::CTestTmpDir::tmpDir(), 0);
+    CPPUNIT_ASSERT(params.s_ModelSpillStore->isOpen());
+    CModelFactory::TDataGathererPtr gathererSpilling;
+    CModelFactory::TModelPtr modelSpilling_;
+    this->makeModel(params, features, startTime, numberPeople, gathererSpilling, modelSpilling_);
+    CEventRateModel* modelSpilling = dynamic_cast<CEventRateModel*>(modelSpilling_.get());
+    uint64_t pageOuts{core::CStatistics::stat(stat_t::E_NumberModelPageOuts).value()};
+
+    uint64_t hibernations{core::CStatistics::stat(stat_t::E_NumberModelHibernations).value()};
+    uint64_t wakes{core::CStatistics::stat(stat_t::E_NumberModelWakes).value()};
+
+    // Person i has data every 2i+1 buckets so all but the first three
+    // people are regularly inactive for longer than the hibernation age.
+    TUIntVec counts;
+    for (std::size_t bucket = 0u; bucket < numberBuckets; ++bucket) {
+        core_t::TTime time{startTime + static_cast<core_t::TTime>(bucket) * bucketLength};
+        rng.generatePoissonSamples(10.0, numberPeople, counts);
+
+        TSizeVec people;
+        for (std::size_t pid = 0u; pid < numberPeople; ++pid) {
+            if (bucket % (2 * pid + 1) == 0) {
+                std::string person{"p" + core::CStringUtils::typeToString(pid + 1)};
+                for (unsigned int i = 0u; i < counts[pid] + 1; ++i) {
+                    addArrival(*gathererAwake, m_ResourceMonitor, time, person);
+                    addArrival(*gathererHibernating, m_ResourceMonitor, time, person);
+                    addArrival(*gathererSpilling, m_ResourceMonitor, time, person);
+                }
+                people.push_back(pid);
+            }
+        }
+        modelAwake->sample(time, time + bucketLength, m_ResourceMonitor);
+        modelHibernating->sample(time, time + bucketLength, m_ResourceMonitor);
+        modelSpilling->sample(time, time + bucketLength, m_ResourceMonitor);
+
+        for (auto pid : people) {
+            SAnnotatedProbability pAwake;
+            SAnnotatedProbability pHibernating;
+            SAnnotatedProbability pSpilling;
+            CPartitioningFields partitioningFields(EMPTY_STRING, EMPTY_STRING);
+            CPPUNIT_ASSERT(modelAwake->computeProbability(
+                pid, time, time + bucketLength, partitioningFields, 1, pAwake));
+            CPPUNIT_ASSERT(modelHibernating->computeProbability(
+                pid, time, time + bucketLength, partitioningFields, 1, pHibernating));
+            CPPUNIT_ASSERT(modelSpilling->computeProbability(
+                pid, time, time + bucketLength, partitioningFields, 1, pSpilling));
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(pAwake.s_Probability, pHibernating.s_Probability,
+                                         1e-4 * pAwake.s_Probability);
+            CPPUNIT_ASSERT_EQUAL(pHibernating.s_Probability, pSpilling.s_Probability);
+        }
+    }
+
+    hibernations = core::CStatistics::stat(stat_t::E_NumberModelHibernations).value() - hibernations;
+    wakes = core::CStatistics::stat(stat_t::E_NumberModelWakes).value() - wakes;
+    LOG_DEBUG(<< "hibernations = " << hibernations << ", wakes = " << wakes);
+    CPPUNIT_ASSERT(hibernations > 0);
+    CPPUNIT_ASSERT(wakes > 0);
+    CPPUNIT_ASSERT(wakes <= hibernations);
+    pageOuts = core::CStatistics::stat(stat_t::E_NumberModelPageOuts).value() - pageOuts;
+    LOG_DEBUG(<< "page outs = " << pageOuts);
+    CPPUNIT_ASSERT(pageOuts > 0);
+
+    LOG_DEBUG(<< "memory awake = " << modelAwake->computeMemoryUsage());
+    LOG_DEBUG(<< "memory hibernating = " << modelHibernating->computeMemoryUsage());
+    CPPUNIT_ASSERT(modelHibernating->computeMemoryUsage() < modelAwake->computeMemoryUsage());
+
+    // Test persistence. (We check for idempotency.)
+
+    std::string origXml;
+    {
+        core::CRapidXmlStatePersistInserter inserter("root");
+        modelHibernating->acceptPersistInserter(inserter);
+        inserter.toXml(origXml);
+    }
+
+    core::CRapidXmlParser parser;
+    CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(origXml));
+    core::CRapidXmlStateRestoreTraverser traverser(parser);
+    CModelFactory::TModelPtr restoredModel(m_Factory->makeModel(gathererHibernating, traverser));
+
+    std::string newXml;
+    {
+        core::CRapidXmlStatePersistInserter inserter("root");
+        restoredModel->acceptPersistInserter(inserter);
+        inserter.toXml(newXml);
+    }
+
+    LOG_DEBUG(<< "original checksum = " << modelHibernating->checksum(false));
+    LOG_DEBUG(<< "restored checksum = " << restoredModel->checksum(false));
+    CPPUNIT_ASSERT_EQUAL(modelHibernating->checksum(false), restoredModel->checksum(false));
+    CPPUNIT_ASSERT_EQUAL(origXml, newXml);
+
+    // The spilled state should be identical to the in memory state.
+    LOG_DEBUG(<< "spilling checksum = " << modelSpilling->checksum(false));
+    CPPUNIT_ASSERT_EQUAL(modelHibernating->checksum(false), modelSpilling->checksum(false));
+
+    // Check we can compute interim results for people whose models are
+    // hibernating.
+    core_t::TTime time{startTime + static_cast<core_t::TTime>(numberBuckets) * bucketLength};
+    for (std::size_t pid = 0u; pid < numberPeople; ++pid) {
+        std::string person{"p" + core::CStringUtils::typeToString(pid + 1)};
+        addArrival(*gathererAwake, m_ResourceMonitor, time, person);
+        addArrival(*gathererHibernating, m_ResourceMonitor, time, person);
+    }
+    modelAwake->sampleBucketStatistics(time, time + bucketLength, m_ResourceMonitor);
+    modelHibernating->sampleBucketStatistics(time, time + bucketLength, m_ResourceMonitor);
+    for (std::size_t pid = 0u; pid < numberPeople; ++pid) {
+        SAnnotatedProbability pAwake;
+        SAnnotatedProbability pHibernating;
+        CPartitioningFields partitioningFields(EMPTY_STRING, EMPTY_STRING);
+        CPPUNIT_ASSERT(modelAwake->computeProbability(
+            pid, time, time + bucketLength, partitioningFields, 1, pAwake));
+        CPPUNIT_ASSERT(modelHibernating->computeProbability(
+            pid, time, time + bucketLength, partitioningFields, 1, pHibernating));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(pAwake.s_Probability, pHibernating.s_Probability,
+                                     1e-4 * pAwake.s_Probability);
+    }
+}
+
+void CEventRateModelTest::testSharedModelSpillStore() {
+    // Check that the models of two detectors which share a spill store can
+    // be read concurrently, as happens when they are plotted, without waking
+    // them, that they are identical to ones which hibernated in memory and
+    // that persistence reads the spilled state through the store.
+
+    using TModelPtrVec = std::vector<CModelFactory::TModelPtr>;
+    using TDataGathererPtrVec = std::vector<CModelFactory::TDataGathererPtr>;
+
+    core_t::TTime startTime(0);
+    core_t::TTime bucketLength(100);
+    std::size_t numberPeople(40);
+    std::size_t numberBuckets(100);
+
+    test::CRandomNumbers rng;
+
+    SModelParams params(bucketLength);
+    params.s_ModelHibernationAge = 5;
+    model_t::TFeatureVec features{model_t::E_IndividualNonZeroCountByBucketAndPerson};
+
+    // Detectors 0 and 1 hibernate in memory and detectors 2 and 3, which
+    // get the same data, share a spill store which pages out everything.
+    // Half the people stop having data near the end so they're hibernating
+    // when the models are woken.
+    TDataGathererPtrVec gatherers(4);
+    TModelPtrVec models(4);
+    this->makeModel(params, features, startTime, numberPeople, gatherers[0], models[0]);
+    this->makeModel(params, features, startTime, numberPeople, gatherers[1], models[1]);
+    TEventRateModelFactoryPtr factoryHibernating{m_Factory};
+    m_Factory.reset();
+    auto store = std::make_shared<CModelSpillStore>(test::CTestTmpDir::tmpDir(), 0);
+    CPPUNIT_ASSERT(store->isOpen());
+    params.s_ModelSpillStore = store;
+    this->makeModel(params, features, startTime, numberPeople, gatherers[2], models[2]);
+    this->makeModel(params, features, startTime, numberPeople, gatherers[3], models[3]);
+
+    TUIntVec counts;
+    for (std::size_t bucket = 0u; bucket < numberBuckets; ++bucket) {
+        core_t::TTime time{startTime + static_cast<core_t::TTime>(bucket) * bucketLength};
+        for (std::size_t detector = 0u; detector < 2; ++detector) {
+            rng.generatePoissonSamples(10.0, numberPeople, counts);
+            for (std::size_t pid = 0u; pid < numberPeople; ++pid) {
+                if (bucket % (pid % 7 + detector + 1) == 0 &&
+                    (pid % 2 == 0 || bucket + 10 < numberBuckets)) {
+                    std::string person{"p" + core::CStringUtils::typeToString(pid + 1)};
+                    for (unsigned int i = 0u; i < counts[pid] + 1; ++i) {
+                        addArrival(*gatherers[detector], m_ResourceMonitor, time, person);
+                        addArrival(*gatherers[detector + 2], m_ResourceMonitor, time, person);
+                    }
+                }
+            }
+        }
+        for (auto& model : models) {
+            model->sample(time, time + bucketLength, m_ResourceMonitor);
+        }
+    }
+
+    CPPUNIT_ASSERT(store->numberPagedOut() > 0);
+
+    std::size_t numberStored{store->numberResident() + store->numberPagedOut()};
+    uint64_t wakes{core::CStatistics::stat(stat_t::E_NumberModelWakes).value()};
+
+    auto checksums = [&](std::size_t detector) {
+        TUInt64Vec result;
+        CAnomalyDetectorModel::CModelDetailsViewPtr view{models[detector]->details()};
+        for (std::size_t pid = 0u; pid < numberPeople; ++pid) {
+            result.push_back(view->model(features[0], pid)->checksum());
+        }
+        return result;
+    };
+
+    std::vector<TUInt64Vec> spilledChecksums(4);
+    core::CStaticThreadPool::startDefault(1);
+    TSizeVec detectors{2, 3};
+    core::CParallel::forEach(2, detectors.begin(), detectors.end(), [&](std::size_t detector) {
+        spilledChecksums[detector] = checksums(detector);
+    });
+    core::CStaticThreadPool::stopDefault();
+
+    // Reading the models, as plotting does, mustn't wake them.
+    wakes = core::CStatistics::stat(stat_t::E_NumberModelWakes).value() - wakes;
+    LOG_DEBUG(<< "wakes = " << wakes);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), wakes);
+    CPPUNIT_ASSERT_EQUAL(numberStored, store->numberResident() + store->numberPagedOut());
+
+    for (std::size_t detector = 0u; detector < 2; ++detector) {
+        CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(checksums(detector)),
+                             core::CContainerPrinter::print(spilledChecksums[detector + 2]));
+        LOG_DEBUG(<< "checksum = " << models[detector]->checksum(false) << " shared checksum = "
+                  << models[detector + 2]->checksum(false));
+        CPPUNIT_ASSERT_EQUAL(models[detector]->checksum(false),
+                             models[detector + 2]->checksum(false));
+    }
+
+    // A copy made for persistence keeps the spilled state in the store
+    // until it has been persisted even if the original is deleted.
+    CModelFactory::TModelPtr clone{models[2]->cloneForPersistence()};
+    models[2].reset();
+    CPPUNIT_ASSERT_EQUAL(numberStored, store->numberResident() + store->numberPagedOut());
+
+    std::string xml;
+    {
+        core::CRapidXmlStatePersistInserter inserter("root");
+        clone->acceptPersistInserter(inserter);
+        inserter.toXml(xml);
+    }
+    core::CRapidXmlParser parser;
+    CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(xml));
+    core::CRapidXmlStateRestoreTraverser traverser(parser);
+    CModelFactory::TModelPtr restored(m_Factory->makeModel(gatherers[2], traverser));
+    LOG_DEBUG(<< "restored checksum = " << restored->checksum(false));
+    CPPUNIT_ASSERT_EQUAL(models[0]->checksum(false), restored->checksum(false));
+
+    clone.reset();
+    CPPUNIT_ASSERT(store->numberResident() + store->numberPagedOut() < numberStored);
+}
+
 void CEventRateModelTest::testExplicitNulls() {
     core_t::TTime startTime(100);
     std::size_t bucketLength(100);
@@ -2882,6 +3159,11 @@ CppUnit::Test* CEventRateModelTest::suite() {
         &CEventRateModelTest::testOnlineRareWithInfluence));
     suiteOfTests->addTest(new CppUnit::TestCaller<CEventRateModelTest>(
         "CEventRateModelTest::testSkipSampling", &CEventRateModelTest::testSkipSampling));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CEventRateModelTest>(
+        "CEventRateModelTest::testHibernation", &CEventRateModelTest::testHibernation));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CEventRateModelTest>(
+        "CEventRateModelTest::testSharedModelSpillStore",
+        &CEventRateModelTest::testSharedModelSpillStore));
     suiteOfTests->addTest(new CppUnit::TestCaller<CEventRateModelTest>(
         "CEventRateModelTest::testExplicitNulls", &CEventRateModelTest::testExplicitNulls));
     suiteOfTests->addTest(new CppUnit::TestCaller<CEventRateModelTest>(
@@ -40,6 +40,8 @@ public:
     void testDistinctCountProbabilityCalculationWithInfluence();
     void testOnlineRareWithInfluence();
     void testSkipSampling();
+    void testHibernation();
+    void testSharedModelSpillStore();
     void testExplicitNulls();
     void testInterimCorrections();
     void testInterimCorrectionsWithCorrelations();
@@ -11,6 +11,8 @@
 #include <core/CRapidXmlParser.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
+#include <core/CStopWatch.h>
+#include <core/CStringUtils.h>
 #include <core/CompressUtils.h>
 
 #include <model/CDataGatherer.h>
@@ -899,6 +901,63 @@ void CEventRatePopulationDataGathererTest::testPersistence() {
     }
 }
 
+void CEventRatePopulationDataGathererTest::testPerformance() {
+    // Time adding arrivals and starting new buckets for a population with
+    // many (person, attribute) pairs per bucket.
+
+    const core_t::TTime startTime = 1367280000;
+    const core_t::TTime bucketLength = 600;
+    const std::size_t numberBuckets = 100u;
+    const std::size_t numberArrivals = 20000u;
+
+    test::CRandomNumbers rng;
+
+    TStrVec people;
+    TStrVec attributes;
+    for (std::size_t i = 0u; i < 1000; ++i) {
+        people.push_back("p" + core::CStringUtils::typeToString(i));
+    }
+    for (std::size_t i = 0u; i < 20; ++i) {
+        attributes.push_back("a" + core::CStringUtils::typeToString(i));
+    }
+    TSizeVec personIndices;
+    TSizeVec attributeIndices;
+    rng.generateUniformSamples(0, people.size(), numberArrivals, personIndices);
+    rng.generateUniformSamples(0, attributes.size(), numberArrivals, attributeIndices);
+
+    CDataGatherer::TFeatureVec features{model_t::E_PopulationCountByBucketPersonAndAttribute};
+    SModelParams params(bucketLength);
+    CDataGatherer gatherer(model_t::E_PopulationEventRate, model_t::E_None, params,
+                           EMPTY_STRING, EMPTY_STRING, EMPTY_STRING, EMPTY_STRING,
+                           EMPTY_STRING, {}, searchKey, features, startTime, 0);
+
+    core::CStopWatch arrivalsWatch;
+    core::CStopWatch rolloverWatch;
+    uint64_t arrivalsTime{0};
+    uint64_t rolloverTime{0};
+    std::size_t pairs{0};
+
+    core_t::TTime time = startTime;
+    for (std::size_t i = 0u; i < numberBuckets; ++i, time += bucketLength) {
+        arrivalsWatch.start();
+        for (std::size_t j = 0u; j < numberArrivals; ++j) {
+            addArrival(time + static_cast<core_t::TTime>(j % bucketLength),
+                       people[personIndices[j]], attributes[(attributeIndices[j] + i) % 20],
+                       gatherer, m_ResourceMonitor);
+        }
+        arrivalsTime = arrivalsWatch.stop();
+        pairs += gatherer.bucketCounts(time).size();
+
+        rolloverWatch.start();
+        gatherer.timeNow(time + bucketLength);
+        rolloverTime = rolloverWatch.stop();
+    }
+
+    LOG_DEBUG(<< "arrivals = " << arrivalsTime << "ms, rollover = " << rolloverTime
+              << "ms, mean pairs per bucket = " << pairs / numberBuckets);
+    CPPUNIT_ASSERT(pairs > numberBuckets * people.size());
+}
+
 CppUnit::Test* CEventRatePopulationDataGathererTest::suite() {
     CppUnit::TestSuite* suiteOfTests =
         new CppUnit::TestSuite("CEventRatePopulationDataGathererTest");
@@ -924,6 +983,9 @@ CppUnit::Test* CEventRatePopulationDataGathererTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CEventRatePopulationDataGathererTest>(
         "CEventRatePopulationDataGathererTest::testPersistence",
         &CEventRatePopulationDataGathererTest::testPersistence));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CEventRatePopulationDataGathererTest>(
+        "CEventRatePopulationDataGathererTest::testPerformance",
+        &CEventRatePopulationDataGathererTest::testPerformance));
 
     return suiteOfTests;
 }
@@ -20,6 +20,7 @@ public:
     void testRemovePeople();
     void testRemoveAttributes();
     void testPersistence();
+    void testPerformance();
 
     static CppUnit::Test* suite();
 
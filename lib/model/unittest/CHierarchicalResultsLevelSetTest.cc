@@ -19,6 +19,12 @@ CppUnit::Test* CHierarchicalResultsLevelSetTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CHierarchicalResultsLevelSetTest>(
         "CHierarchicalResultsLevelSetTest::testElementsWithPerPartitionNormalisation",
         &CHierarchicalResultsLevelSetTest::testElementsWithPerPartitionNormalisation));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CHierarchicalResultsLevelSetTest>(
+        "CHierarchicalResultsLevelSetTest::testElementsWithManyPartitions",
+        &CHierarchicalResultsLevelSetTest::testElementsWithManyPartitions));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CHierarchicalResultsLevelSetTest>(
+        "CHierarchicalResultsLevelSetTest::testStringsAreNotPinned",
+        &CHierarchicalResultsLevelSetTest::testStringsAreNotPinned));
 
     return suiteOfTests;
 }
@@ -59,7 +65,11 @@ public:
                        bool /*pivot*/) {}
 
     // make public
+    using ml::model::CHierarchicalResultsLevelSet<TestNode>::age;
     using ml::model::CHierarchicalResultsLevelSet<TestNode>::elements;
+    using ml::model::CHierarchicalResultsLevelSet<TestNode>::leafSet;
+    using ml::model::CHierarchicalResultsLevelSet<TestNode>::partitionSet;
+    using ml::model::CHierarchicalResultsLevelSet<TestNode>::personSet;
 };
 
 void print(const TestNode* node) {
@@ -134,3 +144,112 @@ void CHierarchicalResultsLevelSetTest::testElementsWithPerPartitionNormalisation
         CPPUNIT_ASSERT_EQUAL(std::string("pBv1"), result[0]->s_Name);
     }
 }
+
+void CHierarchicalResultsLevelSetTest::testElementsWithManyPartitions() {
+    // Check that the elements are correct when the same nodes are visited
+    // repeatedly and when new partitions are interleaved with existing ones.
+
+    using TNode = CConcreteHierarchicalResultsLevelSet::TNode;
+    using TNodeVec = std::vector<TNode>;
+    using TStrVec = std::vector<std::string>;
+
+    ml::core::CStoredStringPtr PARTITION = ml::model::CStringStore::names().get("p");
+    ml::core::CStoredStringPtr PERSON = ml::model::CStringStore::names().get("person");
+    ml::core::CStoredStringPtr FUNCTION = ml::model::CStringStore::names().get("mean");
+    ml::core::CStoredStringPtr VALUE = ml::model::CStringStore::names().get("value");
+
+    std::size_t numberPartitions{2000};
+
+    TestNode root("root");
+    ml::model::SAnnotatedProbability emptyAnnotatedProb;
+    ml::model::hierarchical_results_detail::SResultSpec unsetSpec;
+    TNode parent(unsetSpec, emptyAnnotatedProb);
+
+    TNodeVec nodes;
+    TStrVec values;
+    nodes.reserve(numberPartitions);
+    values.reserve(numberPartitions);
+    for (std::size_t i = 0; i < numberPartitions; ++i) {
+        values.push_back("v" + std::to_string(i));
+        ml::model::hierarchical_results_detail::SResultSpec spec;
+        spec.s_PartitionFieldName = PARTITION;
+        spec.s_PartitionFieldValue = ml::model::CStringStore::names().get(values.back());
+        spec.s_PersonFieldName = PERSON;
+        spec.s_FunctionName = FUNCTION;
+        spec.s_ValueFieldName = VALUE;
+        nodes.emplace_back(spec, emptyAnnotatedProb);
+        nodes.back().s_Parent = &parent;
+    }
+
+    auto check = [&](CConcreteHierarchicalResultsLevelSet& levelSet, std::size_t i) {
+        std::vector<TestNode*> result;
+        levelSet.elements(nodes[i], false, CTestNodeFactory(), result, true);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(3), result.size());
+        std::string key{"p" + values[i]};
+        CPPUNIT_ASSERT_EQUAL(key + " person mean value", result[0]->s_Name);
+        CPPUNIT_ASSERT_EQUAL(key + " person", result[1]->s_Name);
+        CPPUNIT_ASSERT_EQUAL(key, result[2]->s_Name);
+    };
+
+    CConcreteHierarchicalResultsLevelSet levelSet(root);
+
+    // Add every other partition then interleave the rest.
+    for (std::size_t i = 0; i < numberPartitions; i += 2) {
+        check(levelSet, i);
+    }
+    for (std::size_t i = 0; i < numberPartitions; ++i) {
+        check(levelSet, i);
+    }
+    CPPUNIT_ASSERT_EQUAL(numberPartitions, levelSet.leafSet().size());
+    CPPUNIT_ASSERT_EQUAL(numberPartitions, levelSet.personSet().size());
+    CPPUNIT_ASSERT_EQUAL(numberPartitions, levelSet.partitionSet().size());
+
+    for (std::size_t i = 0; i < numberPartitions; ++i) {
+        check(levelSet, i);
+    }
+    CPPUNIT_ASSERT_EQUAL(numberPartitions, levelSet.leafSet().size());
+}
+
+void CHierarchicalResultsLevelSetTest::testStringsAreNotPinned() {
+    // Check that the cached positions don't stop the string store pruning
+    // the partition values and that the elements are still correct when
+    // the strings are replaced by new ones, which may reuse their addresses.
+
+    using TNode = CConcreteHierarchicalResultsLevelSet::TNode;
+
+    ml::core::CStoredStringPtr PARTITION = ml::model::CStringStore::names().get("p");
+
+    TestNode root("root");
+    ml::model::SAnnotatedProbability emptyAnnotatedProb;
+    ml::model::hierarchical_results_detail::SResultSpec unsetSpec;
+    TNode parent(unsetSpec, emptyAnnotatedProb);
+    TNode child(unsetSpec, emptyAnnotatedProb);
+
+    CConcreteHierarchicalResultsLevelSet levelSet(root);
+    std::vector<TestNode*> result;
+
+    for (std::size_t i = 0; i < 20; ++i) {
+        std::string value{"pruned" + std::to_string(i)};
+        ml::core::CStoredStringPtr::CWeakPtr weak;
+        {
+            ml::model::hierarchical_results_detail::SResultSpec spec;
+            spec.s_PartitionFieldName = PARTITION;
+            spec.s_PartitionFieldValue = ml::model::CStringStore::names().get(value);
+            weak = ml::core::CStoredStringPtr::CWeakPtr(spec.s_PartitionFieldValue);
+            TNode node(spec, emptyAnnotatedProb);
+            node.s_Parent = &parent;
+            node.s_Children.push_back(&child);
+
+            levelSet.elements(node, false, CTestNodeFactory(), result, true);
+            CPPUNIT_ASSERT_EQUAL(std::size_t(1), result.size());
+            CPPUNIT_ASSERT_EQUAL("p" + value, result[0]->s_Name);
+        }
+
+        ml::model::CStringStore::names().remove(value);
+        ml::model::CStringStore::names().pruneRemovedNotThreadSafe();
+        CPPUNIT_ASSERT(weak.expired());
+
+        levelSet.age([](TestNode&) {});
+    }
+    CPPUNIT_ASSERT_EQUAL(std::size_t(20), levelSet.partitionSet().size());
+}
@@ -11,6 +11,8 @@
 class CHierarchicalResultsLevelSetTest : public CppUnit::TestFixture {
 public:
     void testElementsWithPerPartitionNormalisation();
+    void testElementsWithManyPartitions();
+    void testStringsAreNotPinned();
 
     static CppUnit::Test* suite();
 };
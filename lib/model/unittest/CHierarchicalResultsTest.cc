@@ -11,6 +11,7 @@
 #include <core/CRapidXmlParser.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
+#include <core/CStringUtils.h>
 
 #include <maths/CStatisticalTests.h>
 #include <maths/CTools.h>
@@ -1956,6 +1957,84 @@ void CHierarchicalResultsTest::testShouldWritePartition() {
         limits, results, *extract.partitionNodes()[1], false));
 }
 
+void CHierarchicalResultsTest::testClear() {
+    // Check that clearing and rebuilding the results gives the same results
+    // as building them from scratch and reuses the nodes.
+
+    model::CAnomalyDetectorModelConfig modelConfig =
+        model::CAnomalyDetectorModelConfig::defaultConfig();
+    static const std::string FUNC("max");
+    static const ml::model::function_t::EFunction function(ml::model::function_t::E_IndividualMetricMax);
+
+    core::CStoredStringPtr I(model::CStringStore::influencers().get("I"));
+    TStrVec partitions;
+    TStrVec people;
+    std::vector<core::CStoredStringPtr> influencers;
+    for (std::size_t i = 0; i < 200; ++i) {
+        partitions.push_back("pn" + core::CStringUtils::typeToString(i));
+    }
+    for (std::size_t i = 0; i < 5; ++i) {
+        people.push_back("p" + core::CStringUtils::typeToString(i));
+        influencers.push_back(model::CStringStore::influencers().get(
+            "i" + core::CStringUtils::typeToString(i)));
+    }
+
+    auto build = [&](model::CHierarchicalResults& results) {
+        for (std::size_t i = 0; i < partitions.size(); ++i) {
+            for (std::size_t j = 0; j < people.size(); ++j) {
+                model::SAnnotatedProbability annotatedProbability(
+                    0.001 * static_cast<double>(1 + (i * people.size() + j) % 100));
+                annotatedProbability.s_Influences.push_back(TStoredStringPtrStoredStringPtrPrDoublePr(
+                    TStoredStringPtrStoredStringPtrPr(I, influencers[j]), 1.0));
+                results.addModelResult(1, false, FUNC, function, PNF1, partitions[i],
+                                       PF1, people[j], EMPTY_STRING, annotatedProbability);
+            }
+        }
+        model::CHierarchicalResultsAggregator aggregator(modelConfig);
+        results.buildHierarchy();
+        results.bottomUpBreadthFirst(aggregator);
+        results.createPivots();
+        results.pivotsBottomUpBreadthFirst(aggregator);
+    };
+    auto print = [](const model::CHierarchicalResults& results) {
+        CPrinter printer;
+        results.postorderDepthFirst(printer);
+        results.pivotsBottomUpBreadthFirst(printer);
+        return printer.result();
+    };
+
+    model::CHierarchicalResults expected;
+    build(expected);
+
+    model::CHierarchicalResults results;
+    build(results);
+    std::size_t numberNodes{results.m_Nodes.capacity()};
+    std::size_t numberPivotNodes{results.m_PivotNodeStore.capacity()};
+    const model::CHierarchicalResults::TNode* root{results.root()};
+    LOG_DEBUG(<< "# nodes = " << numberNodes << ", # pivot nodes = " << numberPivotNodes);
+
+    results.clear();
+    CPPUNIT_ASSERT(results.empty());
+    CPPUNIT_ASSERT(results.root() == nullptr);
+    CPPUNIT_ASSERT(results.influencer(I, influencers[0]) == nullptr);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), results.resultCount());
+
+    build(results);
+    CPPUNIT_ASSERT_EQUAL(numberNodes, results.m_Nodes.capacity());
+    CPPUNIT_ASSERT_EQUAL(numberPivotNodes, results.m_PivotNodeStore.capacity());
+    CPPUNIT_ASSERT_EQUAL(root, results.root());
+    CPPUNIT_ASSERT_EQUAL(print(expected), print(results));
+
+    // Repeatedly clearing and rebuilding shouldn't need any more nodes.
+    for (std::size_t i = 0; i < 5; ++i) {
+        results.clear();
+        build(results);
+    }
+    CPPUNIT_ASSERT_EQUAL(numberNodes, results.m_Nodes.capacity());
+    CPPUNIT_ASSERT_EQUAL(numberPivotNodes, results.m_PivotNodeStore.capacity());
+    CPPUNIT_ASSERT_EQUAL(print(expected), print(results));
+}
+
 CppUnit::Test* CHierarchicalResultsTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CHierarchicalResultsTest");
 
@@ -1989,6 +2068,8 @@ CppUnit::Test* CHierarchicalResultsTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CHierarchicalResultsTest>(
         "CHierarchicalResultsTest::testShouldWritePartition",
         &CHierarchicalResultsTest::testShouldWritePartition));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CHierarchicalResultsTest>(
+        "CHierarchicalResultsTest::testClear", &CHierarchicalResultsTest::testClear));
 
     return suiteOfTests;
 }
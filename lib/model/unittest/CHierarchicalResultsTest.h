@@ -23,6 +23,7 @@ public:
     void testNormalizer();
     void testDetectorEqualizing();
     void testShouldWritePartition();
+    void testClear();
 
     static CppUnit::Test* suite();
 };
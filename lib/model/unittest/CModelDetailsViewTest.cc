@@ -130,6 +130,35 @@ void CModelDetailsViewTest::testModelPlot() {
             }
         }
     }
+
+    LOG_DEBUG(<< "Individual sum with terms");
+    {
+        features.assign(1, model_t::E_IndividualSumByBucketAndPerson);
+        setupTest();
+
+        TDoubleVec values{2.0, 3.0, 0.0, 5.0};
+        std::size_t pid{0};
+        for (auto value : values) {
+            model->mockAddBucketValue(model_t::E_IndividualSumByBucketAndPerson,
+                                      pid++, 0, 0, {value});
+        }
+
+        model::CModelPlotData plotData;
+        model->details()->modelPlot(0, 90.0, {"p12", "p22", "p31"}, plotData);
+        CPPUNIT_ASSERT(plotData.begin() != plotData.end());
+        for (const auto& featureByFieldData : plotData) {
+            CPPUNIT_ASSERT_EQUAL(std::size_t(2), featureByFieldData.second.size());
+            for (const auto& byFieldData : featureByFieldData.second) {
+                CPPUNIT_ASSERT(byFieldData.first == "p12" || byFieldData.first == "p22");
+                CPPUNIT_ASSERT(gatherer->personId(byFieldData.first, pid));
+                CPPUNIT_ASSERT_EQUAL(std::size_t(1),
+                                     byFieldData.second.s_ValuesPerOverField.size());
+                for (const auto& currentBucketValue : byFieldData.second.s_ValuesPerOverField) {
+                    CPPUNIT_ASSERT_EQUAL(values[pid], currentBucketValue.second);
+                }
+            }
+        }
+    }
 }
 
 CppUnit::Test* CModelDetailsViewTest::suite() {
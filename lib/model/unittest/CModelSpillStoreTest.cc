@@ -0,0 +1,193 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include "CModelSpillStoreTest.h"
+
+#include <core/CLogger.h>
+#include <core/CStatistics.h>
+
+#include <model/CModelSpillStore.h>
+
+#include <test/CRandomNumbers.h>
+#include <test/CTestTmpDir.h>
+
+#include <vector>
+
+using namespace ml;
+using namespace model;
+
+namespace {
+using TByteVec = CModelSpillStore::TByteVec;
+using TByteVecVec = std::vector<TByteVec>;
+using TSizeVec = std::vector<std::size_t>;
+using THandleVec = std::vector<CModelSpillStore::CHandle>;
+
+TByteVecVec randomStates(test::CRandomNumbers& rng, std::size_t n) {
+    TSizeVec lengths;
+    rng.generateUniformSamples(1, 5 * CModelSpillStore::SLAB_SIZE, n, lengths);
+    TByteVecVec result(n);
+    for (std::size_t i = 0u; i < n; ++i) {
+        TSizeVec bytes;
+        rng.generateUniformSamples(0, 256, lengths[i], bytes);
+        result[i].assign(bytes.begin(), bytes.end());
+    }
+    return result;
+}
+}
+
+void CModelSpillStoreTest::testPageOutAndIn() {
+    // Check that the least recently added states are paged out and
+    // that states are read back correctly whether or not they are
+    // resident.
+
+    test::CRandomNumbers rng;
+
+    TByteVecVec states{randomStates(rng, 100)};
+
+    CModelSpillStore store{test::CTestTmpDir::tmpDir(), 10 * CModelSpillStore::SLAB_SIZE};
+    CPPUNIT_ASSERT(store.isOpen());
+
+    uint64_t pageOuts{core::CStatistics::stat(stat_t::E_NumberModelPageOuts).value()};
+    uint64_t pageIns{core::CStatistics::stat(stat_t::E_NumberModelPageIns).value()};
+
+    THandleVec handles;
+    for (const auto& state : states) {
+        handles.push_back(store.add(state));
+    }
+
+    LOG_DEBUG(<< "resident = " << store.numberResident()
+              << ", paged out = " << store.numberPagedOut());
+    CPPUNIT_ASSERT_EQUAL(states.size(), store.numberResident() + store.numberPagedOut());
+    CPPUNIT_ASSERT(store.numberPagedOut() > 0);
+    CPPUNIT_ASSERT(store.numberResident() > 0);
+    CPPUNIT_ASSERT(store.numberResident() < 10);
+    CPPUNIT_ASSERT_EQUAL(
+        static_cast<uint64_t>(store.numberPagedOut()),
+        core::CStatistics::stat(stat_t::E_NumberModelPageOuts).value() - pageOuts);
+
+    // The most recent states are resident.
+    CPPUNIT_ASSERT(handles.front().memoryUsage() == 0);
+    CPPUNIT_ASSERT(handles.back().memoryUsage() >= states.back().size());
+
+    for (std::size_t i = 0u; i < states.size(); ++i) {
+        TByteVec state;
+        CPPUNIT_ASSERT(handles[i].read(state));
+        CPPUNIT_ASSERT(states[i] == state);
+    }
+    CPPUNIT_ASSERT_EQUAL(
+        static_cast<uint64_t>(store.numberPagedOut()),
+        core::CStatistics::stat(stat_t::E_NumberModelPageIns).value() - pageIns);
+
+    // Reducing the limit pages out everything.
+    store.residentMemoryLimit(0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), store.numberResident());
+    for (std::size_t i = 0u; i < states.size(); ++i) {
+        TByteVec state;
+        CPPUNIT_ASSERT(handles[i].read(state));
+        CPPUNIT_ASSERT(states[i] == state);
+    }
+}
+
+void CModelSpillStoreTest::testSlabReuse() {
+    // Check that freed slabs are merged and reused and that the file
+    // grows when it's full.
+
+    test::CRandomNumbers rng;
+
+    CModelSpillStore store{test::CTestTmpDir::tmpDir(), 0};
+    CPPUNIT_ASSERT(store.isOpen());
+    std::size_t numberSlabs{store.numberSlabs()};
+
+    for (std::size_t i = 0u; i < 5; ++i) {
+        TByteVecVec states{randomStates(rng, 200)};
+        THandleVec handles;
+        for (const auto& state : states) {
+            handles.push_back(store.add(state));
+        }
+        CPPUNIT_ASSERT_EQUAL(states.size(), store.numberPagedOut());
+
+        // Free every other state then add them back.
+        for (std::size_t j = 0u; j < handles.size(); j += 2) {
+            handles[j].reset();
+        }
+        CPPUNIT_ASSERT_EQUAL(states.size() / 2, store.numberPagedOut());
+        for (std::size_t j = 0u; j < handles.size(); j += 2) {
+            handles[j] = store.add(states[j]);
+        }
+
+        for (std::size_t j = 0u; j < states.size(); ++j) {
+            TByteVec state;
+            CPPUNIT_ASSERT(handles[j].read(state));
+            CPPUNIT_ASSERT(states[j] == state);
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), store.numberPagedOut());
+    LOG_DEBUG(<< "number slabs = " << store.numberSlabs());
+    CPPUNIT_ASSERT_EQUAL(numberSlabs, store.numberSlabs());
+
+    // All the free slabs should have been merged so a state which fills
+    // the file fits without growing it. The next state forces it to grow.
+    THandleVec handles;
+    TByteVec large(numberSlabs * CModelSpillStore::SLAB_SIZE, 'a');
+    handles.push_back(store.add(large));
+    CPPUNIT_ASSERT_EQUAL(numberSlabs, store.numberSlabs());
+    handles.push_back(store.add(TByteVec{'b'}));
+    CPPUNIT_ASSERT(store.numberSlabs() > numberSlabs);
+    TByteVec state;
+    CPPUNIT_ASSERT(handles[0].read(state));
+    CPPUNIT_ASSERT(large == state);
+    CPPUNIT_ASSERT(handles[1].read(state));
+    CPPUNIT_ASSERT(TByteVec{'b'} == state);
+}
+
+void CModelSpillStoreTest::testHandles() {
+    // Check that states are owned by their handles.
+
+    CModelSpillStore store{test::CTestTmpDir::tmpDir(), 1000000};
+    CPPUNIT_ASSERT(store.isOpen());
+
+    TByteVec state{'a', 'b', 'c'};
+
+    CModelSpillStore::CHandle handle{store.add(state)};
+    CPPUNIT_ASSERT(handle.valid());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), store.numberResident());
+
+    CModelSpillStore::CHandle moved{std::move(handle)};
+    CPPUNIT_ASSERT(handle.valid() == false);
+    CPPUNIT_ASSERT(moved.valid());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), handle.memoryUsage());
+    CPPUNIT_ASSERT(moved.memoryUsage() >= state.size());
+
+    TByteVec read;
+    CPPUNIT_ASSERT(handle.read(read) == false);
+    CPPUNIT_ASSERT(moved.read(read));
+    CPPUNIT_ASSERT(state == read);
+
+    {
+        CModelSpillStore::CHandle scoped{store.add(state)};
+        CPPUNIT_ASSERT_EQUAL(std::size_t(2), store.numberResident());
+    }
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), store.numberResident());
+
+    moved = store.add(state);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), store.numberResident());
+    moved.reset();
+    CPPUNIT_ASSERT(moved.valid() == false);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), store.numberResident());
+}
+
+CppUnit::Test* CModelSpillStoreTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CModelSpillStoreTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CModelSpillStoreTest>(
+        "CModelSpillStoreTest::testPageOutAndIn", &CModelSpillStoreTest::testPageOutAndIn));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CModelSpillStoreTest>(
+        "CModelSpillStoreTest::testSlabReuse", &CModelSpillStoreTest::testSlabReuse));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CModelSpillStoreTest>(
+        "CModelSpillStoreTest::testHandles", &CModelSpillStoreTest::testHandles));
+
+    return suiteOfTests;
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_CModelSpillStoreTest_h
+#define INCLUDED_CModelSpillStoreTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CModelSpillStoreTest : public CppUnit::TestFixture {
+public:
+    void testPageOutAndIn();
+    void testSlabReuse();
+    void testHandles();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CModelSpillStoreTest_h
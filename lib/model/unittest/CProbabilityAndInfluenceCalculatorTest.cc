@@ -7,6 +7,7 @@
 #include "CProbabilityAndInfluenceCalculatorTest.h"
 
 #include <core/CLogger.h>
+#include <core/CStatistics.h>
 #include <core/Constants.h>
 
 #include <maths/CMultivariateNormalConjugate.h>
@@ -23,6 +24,7 @@
 
 #include <boost/range.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -1600,6 +1602,103 @@ void CProbabilityAndInfluenceCalculatorTest::testProbabilityAndInfluenceCalculat
     }
 }
 
+void CProbabilityAndInfluenceCalculatorTest::testCounterfactualProbabilityCache() {
+    // Test that the probabilities of identical counterfactual values
+    // are computed once and that caching doesn't change the influences.
+
+    test::CRandomNumbers rng;
+
+    model::CLogProbabilityComplementInfluenceCalculator calculator;
+
+    core_t::TTime bucketLength{600};
+
+    maths::CTimeSeriesDecomposition trend{0.0, bucketLength};
+    maths::CMultivariateNormalConjugate<2> prior{
+        maths::CMultivariateNormalConjugate<2>::nonInformativePrior(maths_t::E_ContinuousData, 0.0)};
+    maths::CMultivariateTimeSeriesModel model{params(bucketLength), trend, prior};
+
+    TDoubleVec mean(2, 10.0);
+    TDoubleVecVec covariances(2, TDoubleVec(2));
+    covariances[0][0] = covariances[1][1] = 5.0;
+    covariances[0][1] = covariances[1][0] = 4.0;
+    TDoubleVecVec samples;
+    rng.generateMultivariateNormalSamples(mean, covariances, 50, samples);
+    core_t::TTime now{addSamples(bucketLength, samples, model)};
+
+    TDouble2Vec value{30.0, 30.0};
+    double p;
+    TTail2Vec tail;
+    computeProbability(now, maths_t::E_TwoSided, value, model, p, tail);
+
+    auto computeLatLongInfluences = [&](const TStrCRefDouble1VecDoublePrPrVec& influencerValues,
+                                        TStoredStringPtrStoredStringPtrPrDoublePrVec& result) {
+        model::CPartitioningFields partitioningFields(EMPTY_STRING, EMPTY_STRING);
+        model::CProbabilityAndInfluenceCalculator::SParams params_(partitioningFields);
+        params_.s_Feature = model_t::E_IndividualMeanLatLongByPerson;
+        params_.s_Model = &model;
+        params_.s_Time = TTime2Vec1Vec{TTime2Vec{now}};
+        params_.s_Value = TDouble2Vec1Vec{value};
+        params_.s_Count = 0.0;
+        for (const auto& influence : influencerValues) {
+            params_.s_Count += influence.second.second;
+        }
+        params_.s_ComputeProbabilityParams.addWeights(
+            maths_t::CUnitWeights::unit<TDouble2Vec>(2));
+        params_.s_Probability = p;
+        params_.s_Tail = tail;
+        params_.s_InfluencerName = model::CStringStore::influencers().get(I);
+        params_.s_InfluencerValues = influencerValues;
+        params_.s_Cutoff = 0.5;
+        params_.s_IncludeCutoff = true;
+        calculator.computeInfluences(params_);
+        result.swap(params_.s_Influences);
+    };
+
+    // Fifteen influencer values each contributing the same statistics.
+    std::vector<std::string> names;
+    for (std::size_t i = 0u; i < 15; ++i) {
+        names.push_back("i" + std::to_string(i + 1));
+    }
+    TStrCRefDouble1VecDoublePrPrVec influencerValues;
+    for (const auto& name : names) {
+        influencerValues.emplace_back(TStrCRef(name), make_pair(2.0, 2.0, 1.0));
+    }
+
+    uint64_t hits{core::CStatistics::stat(stat_t::E_NumberInfluenceProbabilityCacheHits).value()};
+    uint64_t misses{
+        core::CStatistics::stat(stat_t::E_NumberInfluenceProbabilityCacheMisses).value()};
+
+    TStoredStringPtrStoredStringPtrPrDoublePrVec influences;
+    computeLatLongInfluences(influencerValues, influences);
+
+    hits = core::CStatistics::stat(stat_t::E_NumberInfluenceProbabilityCacheHits).value() - hits;
+    misses = core::CStatistics::stat(stat_t::E_NumberInfluenceProbabilityCacheMisses).value() -
+             misses;
+    LOG_DEBUG(<< "influences = " << core::CContainerPrinter::print(influences));
+    LOG_DEBUG(<< "hits = " << hits << ", misses = " << misses);
+
+    CPPUNIT_ASSERT_EQUAL(names.size(), influences.size());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), misses);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(names.size() - 1), hits);
+    for (const auto& influence : influences) {
+        CPPUNIT_ASSERT_EQUAL(influences[0].second, influence.second);
+    }
+
+    // Check against the influence computed without any cache hits.
+    TStrCRefDouble1VecDoublePrPrVec referenceValues{
+        {TStrCRef(i1), make_pair(2.0, 2.0, 1.0)},
+        {TStrCRef(i2), make_pair(28.0, 28.0, 14.0)}};
+    TStoredStringPtrStoredStringPtrPrDoublePrVec reference;
+    computeLatLongInfluences(referenceValues, reference);
+    LOG_DEBUG(<< "reference = " << core::CContainerPrinter::print(reference));
+
+    auto influence = std::find_if(reference.begin(), reference.end(), [](const auto& r) {
+        return *r.first.second == i1;
+    });
+    CPPUNIT_ASSERT(influence != reference.end());
+    CPPUNIT_ASSERT_EQUAL(influence->second, influences[0].second);
+}
+
 CppUnit::Test* CProbabilityAndInfluenceCalculatorTest::suite() {
     CppUnit::TestSuite* suiteOfTests =
         new CppUnit::TestSuite("CProbabilityAndInfluenceCalculatorTest");
@@ -1622,6 +1721,9 @@ CppUnit::Test* CProbabilityAndInfluenceCalculatorTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CProbabilityAndInfluenceCalculatorTest>(
         "CProbabilityAndInfluenceCalculatorTest::testProbabilityAndInfluenceCalculator",
         &CProbabilityAndInfluenceCalculatorTest::testProbabilityAndInfluenceCalculator));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CProbabilityAndInfluenceCalculatorTest>(
+        "CProbabilityAndInfluenceCalculatorTest::testCounterfactualProbabilityCache",
+        &CProbabilityAndInfluenceCalculatorTest::testCounterfactualProbabilityCache));
 
     return suiteOfTests;
 }
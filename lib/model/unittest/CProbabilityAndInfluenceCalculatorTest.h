@@ -17,6 +17,7 @@ public:
     void testLogProbabilityInfluenceCalculator();
     void testIndicatorInfluenceCalculator();
     void testProbabilityAndInfluenceCalculator();
+    void testCounterfactualProbabilityCache();
 
     static CppUnit::Test* suite();
 };
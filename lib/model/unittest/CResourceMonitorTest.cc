@@ -5,8 +5,12 @@
  */
 #include "CResourceMonitorTest.h"
 
+#include <core/CMemory.h>
+#include <core/CStringUtils.h>
+
 #include <model/CAnomalyDetector.h>
 #include <model/CAnomalyDetectorModelConfig.h>
+#include <model/CDataGatherer.h>
 #include <model/CHierarchicalResults.h>
 #include <model/CLimits.h>
 #include <model/CMetricModelFactory.h>
@@ -25,6 +29,9 @@ CppUnit::Test* CResourceMonitorTest::suite() {
         "CResourceMonitorTest::testMonitor", &CResourceMonitorTest::testMonitor));
     suiteOfTests->addTest(new CppUnit::TestCaller<CResourceMonitorTest>(
         "CResourceMonitorTest::testPruning", &CResourceMonitorTest::testPruning));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CResourceMonitorTest>(
+        "CResourceMonitorTest::testPruningMultipleDetectors",
+        &CResourceMonitorTest::testPruningMultipleDetectors));
     suiteOfTests->addTest(new CppUnit::TestCaller<CResourceMonitorTest>(
         "CResourceMonitorTest::testExtraMemory", &CResourceMonitorTest::testExtraMemory));
     return suiteOfTests;
@@ -332,38 +339,152 @@ void CResourceMonitorTest::testPruning() {
     // Add enough data to saturate the pruner
     this->addTestData(bucket, BUCKET_LENGTH, 1100, 3, startOffset, detector, monitor);
 
-    LOG_DEBUG(<< "Window is now: " << monitor.m_PruneWindow);
     CPPUNIT_ASSERT_EQUAL(true, monitor.m_HasPruningStarted);
-    CPPUNIT_ASSERT(monitor.m_PruneWindow < std::size_t(1000));
     CPPUNIT_ASSERT_EQUAL(model_t::E_MemoryStatusSoftLimit, monitor.m_MemoryStatus);
     CPPUNIT_ASSERT_EQUAL(true, monitor.m_AllowAllocations);
 
+    // Check that the least recently seen people were pruned: the people
+    // who remain should be the pervasive person and the people added most
+    // recently. (People added in the same bucket are equally recent so we
+    // allow some slack at the boundary.)
+    const CDataGatherer& gatherer = detector.model()->dataGatherer();
+    std::size_t numberActivePeople{gatherer.numberActivePeople()};
+    LOG_DEBUG(<< "Active people " << numberActivePeople << " of " << startOffset);
+    CPPUNIT_ASSERT(numberActivePeople < startOffset - 10);
+    auto isActive = [&gatherer](const std::string& person) {
+        std::size_t pid;
+        return gatherer.personId(person, pid) && gatherer.isPersonActive(pid);
+    };
+    auto name = [](std::size_t i) {
+        return "person" + core::CStringUtils::typeToString(i);
+    };
+    CPPUNIT_ASSERT(isActive("IShouldNotBeRemoved"));
+    std::size_t boundary{startOffset + 1 - numberActivePeople};
+    for (std::size_t i = 10; i + 3 < boundary; ++i) {
+        CPPUNIT_ASSERT(isActive(name(i)) == false);
+    }
+    for (std::size_t i = boundary + 3; i < startOffset; ++i) {
+        CPPUNIT_ASSERT(isActive(name(i)));
+    }
+
+    // The index should contain every active person except those added
+    // in the last bucket, which haven't been sampled yet, and the stale
+    // entries shouldn't be allowed to accumulate.
+    auto numberIndexed = [&monitor]() {
+        std::size_t result{0};
+        for (const auto& group : monitor.m_LastSeen) {
+            for (auto id : group.second) {
+                result += monitor.isLastSeen(group.first, id) ? 1 : 0;
+            }
+        }
+        return result;
+    };
+    std::size_t indexed{numberIndexed()};
+    CPPUNIT_ASSERT(indexed <= numberActivePeople);
+    CPPUNIT_ASSERT(indexed + 3 >= numberActivePeople);
+    CPPUNIT_ASSERT(monitor.m_NumberLastSeen <
+                   2 * numberActivePeople + CResourceMonitor::MINIMUM_LAST_SEEN_TO_COMPACT);
+
     LOG_DEBUG(<< "Allowing pruner to relax");
-    // Add no new people and see that the window relaxes away from the minimum window
+    // Add no new people and check we stay below the threshold
     this->addTestData(bucket, BUCKET_LENGTH, 100, 0, startOffset, detector, monitor);
-    LOG_DEBUG(<< "Window is now: " << monitor.m_PruneWindow);
-    std::size_t level = monitor.m_PruneWindow;
     CPPUNIT_ASSERT_EQUAL(model_t::E_MemoryStatusSoftLimit, monitor.m_MemoryStatus);
     CPPUNIT_ASSERT_EQUAL(true, monitor.m_AllowAllocations);
     CPPUNIT_ASSERT(monitor.totalMemory() < monitor.m_PruneThreshold);
+    CPPUNIT_ASSERT_EQUAL(numberActivePeople, gatherer.numberActivePeople());
 
-    LOG_DEBUG(<< "Testing fine-grained control");
-    // Check that the window keeps growing now
-    this->addTestData(bucket, BUCKET_LENGTH, 50, 0, startOffset, detector, monitor);
-    CPPUNIT_ASSERT(monitor.m_PruneWindow > level);
-    level = monitor.m_PruneWindow;
-    this->addTestData(bucket, BUCKET_LENGTH, 50, 0, startOffset, detector, monitor);
-    CPPUNIT_ASSERT(monitor.m_PruneWindow > level);
-    level = monitor.m_PruneWindow;
-
-    // Check that adding a bunch of new data shrinks the window again
+    // Check that adding a bunch of new data prunes again
     this->addTestData(bucket, BUCKET_LENGTH, 200, 10, startOffset, detector, monitor);
-    CPPUNIT_ASSERT(monitor.m_PruneWindow < level);
-    level = monitor.m_PruneWindow;
+    CPPUNIT_ASSERT(isActive(name(boundary + 3)) == false);
+    CPPUNIT_ASSERT(isActive(name(startOffset - 1)));
+    CPPUNIT_ASSERT(isActive("IShouldNotBeRemoved"));
+    indexed = numberIndexed();
+    CPPUNIT_ASSERT(indexed <= gatherer.numberActivePeople());
+    CPPUNIT_ASSERT(indexed + 10 >= gatherer.numberActivePeople());
+
+    // Unregistering should invalidate the model's entries and registering
+    // should index it again.
+    monitor.unRegisterComponent(detector);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), numberIndexed());
+    CPPUNIT_ASSERT(monitor.m_LastSeenModelIndices.empty());
+    monitor.registerComponent(detector);
+    CPPUNIT_ASSERT(numberIndexed() >= indexed);
+    CPPUNIT_ASSERT(numberIndexed() <= gatherer.numberActivePeople());
+}
+
+void CResourceMonitorTest::testPruningMultipleDetectors() {
+    // Check that people are pruned from a detector whose prune window has
+    // passed even if the least recently seen people belong to a detector
+    // whose prune window hasn't.
+
+    const std::string EMPTY_STRING;
+    const core_t::TTime FIRST_TIME(358556400);
+    const core_t::TTime BUCKET_LENGTH(3600);
+
+    CAnomalyDetectorModelConfig modelConfig =
+        CAnomalyDetectorModelConfig::defaultConfig(BUCKET_LENGTH);
+    CAnomalyDetectorModelConfig slowModelConfig =
+        CAnomalyDetectorModelConfig::defaultConfig(BUCKET_LENGTH);
+    // This gives a minimum prune window of 25000 buckets.
+    slowModelConfig.decayRate(0.00001);
+    CLimits limits(1.0);
+
+    CSearchKey key(1, // identifier
+                   function_t::E_IndividualMetric, false, model_t::E_XF_None,
+                   "value", "colour");
+    CSearchKey slowKey(2, // identifier
+                       function_t::E_IndividualMetric, false,
+                       model_t::E_XF_None, "value", "shape");
+
+    CResourceMonitor& monitor = limits.resourceMonitor();
+    monitor.memoryLimit(140);
+
+    // The slow detector is registered first so its entries come first in
+    // the index for each time.
+    CAnomalyDetector slowDetector(2, // identifier
+                                  limits, slowModelConfig, EMPTY_STRING,
+                                  FIRST_TIME, slowModelConfig.factory(slowKey));
+    CAnomalyDetector detector(1, // identifier
+                              limits, modelConfig, EMPTY_STRING, FIRST_TIME,
+                              modelConfig.factory(key));
+
+    // The slow detector only has data in the first couple of buckets so
+    // it has the least recently seen people.
+    core_t::TTime slowBucket = FIRST_TIME;
+    std::size_t slowStartOffset = 10;
+    this->addTestData(slowBucket, BUCKET_LENGTH, 2, 5, slowStartOffset, slowDetector, monitor);
+
+    core_t::TTime bucket = FIRST_TIME;
+    std::size_t startOffset = 10;
+    this->addTestData(bucket, BUCKET_LENGTH, 1100, 3, startOffset, detector, monitor);
+
+    CPPUNIT_ASSERT_EQUAL(true, monitor.m_HasPruningStarted);
+    CPPUNIT_ASSERT_EQUAL(true, monitor.m_AllowAllocations);
+
+    auto name = [](std::size_t i) {
+        return "person" + core::CStringUtils::typeToString(i);
+    };
+
+    const CDataGatherer& slowGatherer = slowDetector.model()->dataGatherer();
+    for (std::size_t i = 10; i < slowStartOffset; ++i) {
+        std::size_t pid;
+        CPPUNIT_ASSERT(slowGatherer.personId(name(i), pid));
+        CPPUNIT_ASSERT(slowGatherer.isPersonActive(pid));
+    }
 
-    // And finally that it grows again
-    this->addTestData(bucket, BUCKET_LENGTH, 700, 0, startOffset, detector, monitor);
-    CPPUNIT_ASSERT(monitor.m_PruneWindow > level);
+    const CDataGatherer& gatherer = detector.model()->dataGatherer();
+    std::size_t numberActivePeople{gatherer.numberActivePeople()};
+    LOG_DEBUG(<< "Active people " << numberActivePeople << " of " << startOffset);
+    CPPUNIT_ASSERT(numberActivePeople < startOffset - 10);
+    std::size_t pid;
+    CPPUNIT_ASSERT(gatherer.personId(name(10), pid) == false ||
+                   gatherer.isPersonActive(pid) == false);
+    CPPUNIT_ASSERT(gatherer.personId(name(startOffset - 1), pid));
+    CPPUNIT_ASSERT(gatherer.isPersonActive(pid));
+
+    // The memory of the index is maintained incrementally.
+    CPPUNIT_ASSERT_EQUAL(core::CMemory::dynamicSize(monitor.m_LastSeen),
+                         monitor.m_LastSeenMemory);
 }
 
 void CResourceMonitorTest::testExtraMemory() {
@@ -22,6 +22,7 @@ public:
 
     void testMonitor();
     void testPruning();
+    void testPruningMultipleDetectors();
     void testExtraMemory();
 
     static CppUnit::Test* suite();
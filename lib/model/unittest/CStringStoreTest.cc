@@ -8,6 +8,8 @@
 
 #include <core/CContainerPrinter.h>
 #include <core/CLogger.h>
+#include <core/CStopWatch.h>
+#include <core/CStringUtils.h>
 #include <core/CThread.h>
 
 #include <model/CStringStore.h>
@@ -80,6 +82,31 @@ private:
     TStrCPtrUSet m_UniquePtrs;
     TCppUnitExceptionP m_LastException;
 };
+
+class CLookupThread : public core::CThread {
+public:
+    CLookupThread(std::size_t offset, std::size_t numberLookups, const TStrVec& strings)
+        : m_Offset(offset), m_NumberLookups(numberLookups), m_Strings(strings),
+          m_Length(0) {}
+
+    std::size_t length() const { return m_Length; }
+
+private:
+    virtual void run() {
+        std::size_t n = m_Strings.size();
+        for (std::size_t i = 0; i < m_NumberLookups; ++i) {
+            m_Length += CStringStore::names().get(m_Strings[(m_Offset + i) % n])->length();
+        }
+    }
+
+    virtual void shutdown() {}
+
+private:
+    std::size_t m_Offset;
+    std::size_t m_NumberLookups;
+    const TStrVec& m_Strings;
+    std::size_t m_Length;
+};
 }
 
 void CStringStoreTest::setUp() {
@@ -121,11 +148,11 @@ void CStringStoreTest::testStringStore() {
         CPPUNIT_ASSERT_EQUAL(pG.get(), pG2.get());
         CPPUNIT_ASSERT_EQUAL(*pG, *pG2);
 
-        CPPUNIT_ASSERT_EQUAL(std::size_t(1), CStringStore::names().m_Strings.size());
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1), CStringStore::names().size());
     }
-    CPPUNIT_ASSERT_EQUAL(std::size_t(1), CStringStore::names().m_Strings.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), CStringStore::names().size());
     CStringStore::names().pruneNotThreadSafe();
-    CPPUNIT_ASSERT_EQUAL(std::size_t(0), CStringStore::names().m_Strings.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), CStringStore::names().size());
 
     {
         LOG_DEBUG(<< "Testing multi-threaded");
@@ -143,11 +170,11 @@ void CStringStoreTest::testStringStore() {
             CPPUNIT_ASSERT(threads[i]->waitForFinish());
         }
 
-        CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().m_Strings.size());
+        CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().size());
         CStringStore::names().pruneNotThreadSafe();
-        CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().m_Strings.size());
+        CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
-                             CStringStore::influencers().m_Strings.size());
+                             CStringStore::influencers().size());
 
         for (std::size_t i = 0; i < threads.size(); ++i) {
             // CppUnit won't automatically catch the exceptions thrown by
@@ -158,11 +185,11 @@ void CStringStoreTest::testStringStore() {
             threads[i]->clearPtrs();
         }
 
-        CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().m_Strings.size());
+        CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().size());
         CStringStore::names().pruneNotThreadSafe();
-        CPPUNIT_ASSERT_EQUAL(std::size_t(0), CStringStore::names().m_Strings.size());
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), CStringStore::names().size());
         threads.clear();
-        CPPUNIT_ASSERT_EQUAL(std::size_t(0), CStringStore::names().m_Strings.size());
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), CStringStore::names().size());
     }
     {
         LOG_DEBUG(<< "Testing multi-threaded string duplication rate");
@@ -196,7 +223,7 @@ void CStringStoreTest::testStringStore() {
             threads[i]->uniques(uniques);
         }
         LOG_DEBUG(<< "unique counts = " << uniques.size());
-        CPPUNIT_ASSERT(uniques.size() < 20000);
+        CPPUNIT_ASSERT_EQUAL(lotsOfStrings.size(), uniques.size());
 
         // Tidy up
         for (std::size_t i = 0; i < threads.size(); ++i) {
@@ -206,6 +233,91 @@ void CStringStoreTest::testStringStore() {
     }
 }
 
+void CStringStoreTest::testRemove() {
+    TStrVec strings;
+    for (std::size_t i = 0u; i < 1000; ++i) {
+        strings.push_back("string " + core::CStringUtils::typeToString(i));
+    }
+
+    std::size_t origMemUse = CStringStore::names().memoryUsage();
+
+    TStoredStringPtrVec kept;
+    for (std::size_t i = 0u; i < strings.size(); ++i) {
+        core::CStoredStringPtr ptr = CStringStore::names().get(strings[i]);
+        if (i % 10 == 0) {
+            kept.push_back(ptr);
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().size());
+    std::size_t allMemUse = CStringStore::names().memoryUsage();
+
+    // Only strings which have been removed and aren't referenced elsewhere
+    // should be pruned.
+    for (std::size_t i = 0u; i < strings.size() / 2; ++i) {
+        CStringStore::names().remove(strings[i]);
+    }
+    CPPUNIT_ASSERT(CStringStore::names().memoryUsage() > allMemUse);
+    CStringStore::names().pruneRemovedNotThreadSafe();
+    CPPUNIT_ASSERT_EQUAL(strings.size() / 2 + 50, CStringStore::names().size());
+    std::size_t prunedMemUse = CStringStore::names().memoryUsage();
+    LOG_DEBUG(<< "memory usage original = " << origMemUse << ", all = " << allMemUse
+              << ", pruned = " << prunedMemUse);
+    CPPUNIT_ASSERT(prunedMemUse < allMemUse);
+
+    for (std::size_t i = 0u; i < strings.size(); ++i) {
+        core::CStoredStringPtr ptr = CStringStore::names().get(strings[i]);
+        CPPUNIT_ASSERT_EQUAL(strings[i], *ptr);
+        if (i % 10 == 0) {
+            CPPUNIT_ASSERT_EQUAL(kept[i / 10].get(), ptr.get());
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().size());
+
+    kept.clear();
+    CStringStore::names().pruneNotThreadSafe();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), CStringStore::names().size());
+}
+
+void CStringStoreTest::testContentionPerformance() {
+    // Check the throughput of lookups as the number of threads looking up
+    // strings concurrently increases. The total number of lookups is fixed.
+
+    TStrVec strings;
+    for (std::size_t i = 0u; i < 10000; ++i) {
+        strings.push_back("person " + core::CStringUtils::typeToString(i));
+    }
+
+    const std::size_t numberLookups = 4000000;
+
+    using TThreadPtr = std::shared_ptr<CLookupThread>;
+    using TThreadVec = std::vector<TThreadPtr>;
+
+    for (std::size_t numberThreads : {1, 2, 4, 8}) {
+        TThreadVec threads;
+        for (std::size_t i = 0; i < numberThreads; ++i) {
+            threads.emplace_back(new CLookupThread(
+                i * strings.size() / numberThreads, numberLookups / numberThreads, strings));
+        }
+
+        core::CStopWatch stopWatch(true);
+        for (const auto& thread : threads) {
+            CPPUNIT_ASSERT(thread->start());
+        }
+        std::size_t length = 0;
+        for (const auto& thread : threads) {
+            CPPUNIT_ASSERT(thread->waitForFinish());
+            length += thread->length();
+        }
+        uint64_t elapsed = stopWatch.stop();
+
+        LOG_DEBUG(<< numberThreads << " threads: " << elapsed << "ms");
+        CPPUNIT_ASSERT(length > 0);
+        CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().size());
+    }
+
+    CStringStore::names().pruneNotThreadSafe();
+}
+
 void CStringStoreTest::testMemUsage() {
     std::string shortStr("short");
     std::string longStr("much much longer than the short string");
@@ -250,6 +362,11 @@ CppUnit::Test* CStringStoreTest::suite() {
         "CStringStoreTest::testStringStore", &CStringStoreTest::testStringStore));
     suiteOfTests->addTest(new CppUnit::TestCaller<CStringStoreTest>(
         "CStringStoreTest::testMemUsage", &CStringStoreTest::testMemUsage));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CStringStoreTest>(
+        "CStringStoreTest::testRemove", &CStringStoreTest::testRemove));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CStringStoreTest>(
+        "CStringStoreTest::testContentionPerformance",
+        &CStringStoreTest::testContentionPerformance));
 
     return suiteOfTests;
 }
@@ -15,6 +15,8 @@ public:
 
     void testStringStore();
     void testMemUsage();
+    void testRemove();
+    void testContentionPerformance();
 
     static CppUnit::Test* suite();
 };
@@ -33,6 +33,7 @@
 #include "CMetricPopulationModelTest.h"
 #include "CModelDetailsViewTest.h"
 #include "CModelMemoryTest.h"
+#include "CModelSpillStoreTest.h"
 #include "CModelToolsTest.h"
 #include "CModelTypesTest.h"
 #include "CProbabilityAndInfluenceCalculatorTest.h"
@@ -73,6 +74,7 @@ int main(int argc, const char** argv) {
     runner.addTest(CMetricPopulationModelTest::suite());
     runner.addTest(CModelDetailsViewTest::suite());
     runner.addTest(CModelMemoryTest::suite());
+    runner.addTest(CModelSpillStoreTest::suite());
     runner.addTest(CModelToolsTest::suite());
     runner.addTest(CModelTypesTest::suite());
     runner.addTest(CProbabilityAndInfluenceCalculatorTest::suite());